@@ -42,4 +42,8 @@ ifeq (${TRUSTED_BOARD_BOOT},1)
 BL1_SOURCES		+=	bl1/bl1_fwu.c
 endif
 
+ifeq (${XLAT_EARLY_MMU},1)
+BL1_SOURCES		+=	lib/aarch64/xlat_early.S
+endif
+
 BL1_LINKERFILE		:=	bl1/bl1.ld.S
@@ -51,6 +51,11 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 			unsigned int block_size,
 			unsigned int image_size,
 			unsigned int flags);
+static int bl1_fwu_image_copy_list(unsigned int image_id,
+			uintptr_t list_addr,
+			unsigned int num_blocks,
+			unsigned int image_size,
+			unsigned int flags);
 static int bl1_fwu_image_auth(unsigned int image_id,
 			uintptr_t image_addr,
 			unsigned int image_size,
@@ -65,6 +70,10 @@ static int bl1_fwu_sec_image_done(void **handle,
 			unsigned int flags);
 __dead2 static void bl1_fwu_done(void *client_cookie, void *reserved);
 
+#if FWU_AUTH_BLOCK_SIZE && !AUTH_STREAM_HASH
+#error "FWU_AUTH_BLOCK_SIZE requires AUTH_STREAM_HASH"
+#endif
+
 /*
  * This keeps track of last executed secure image id.
  */
@@ -99,6 +108,10 @@ register_t bl1_fwu_smc_handler(unsigned int smc_fid,
 	case FWU_SMC_SEC_IMAGE_DONE:
 		SMC_RET1(handle, bl1_fwu_sec_image_done(&handle, flags));
 
+	case FWU_SMC_IMAGE_COPY_LIST:
+		SMC_RET1(handle, bl1_fwu_image_copy_list(x1, x2, x3, x4,
+							 flags));
+
 	case FWU_SMC_UPDATE_DONE:
 		bl1_fwu_done((void *)x1, NULL);
 		/* We should never return from bl1_fwu_done() */
@@ -122,6 +135,7 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 {
 	uintptr_t base_addr;
 	meminfo_t *mem_layout;
+	int result;
 
 	/* Get the image descriptor. */
 	image_desc_t *image_desc = bl1_plat_get_image_desc(image_id);
@@ -174,9 +188,18 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 
 		/* Copy image for given block size. */
 		base_addr += image_desc->copied_size;
+		result = bl1_plat_fwu_copy(base_addr, image_src, block_size);
+		if (result != 0) {
+			WARN("BL1-FWU: Copy of image block failed (%d)\n",
+				result);
+			return result;
+		}
 		image_desc->copied_size += block_size;
-		memcpy((void *)base_addr, (const void *)image_src, block_size);
-		flush_dcache_range(base_addr, block_size);
+
+#if AUTH_STREAM_HASH
+		/* Add the block to the hash started by the first block. */
+		auth_mod_stream_hash_update((void *)base_addr, block_size);
+#endif
 
 		/* Update the state if last block. */
 		if (image_desc->copied_size ==
@@ -222,8 +245,24 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 		image_desc->image_info.image_size = image_size;
 
 		/* Copy image for given size. */
-		memcpy((void *)base_addr, (const void *)image_src, block_size);
-		flush_dcache_range(base_addr, block_size);
+		result = bl1_plat_fwu_copy(base_addr, image_src, block_size);
+		if (result != 0) {
+			WARN("BL1-FWU: Copy of image block failed (%d)\n",
+				result);
+			return result;
+		}
+
+#if AUTH_STREAM_HASH
+		/*
+		 * Hash the secure copy of the image block by block, so that
+		 * FWU_SMC_IMAGE_AUTH only has to match the digest instead of
+		 * reading the whole image back in a single SMC. The hash is
+		 * dropped by the auth module, and the image hashed as usual,
+		 * if anything else is copied or hashed in between.
+		 */
+		auth_mod_stream_hash_start(image_id);
+		auth_mod_stream_hash_update((void *)base_addr, block_size);
+#endif
 
 		/* Update the state. */
 		if (block_size == image_size) {
@@ -240,6 +279,106 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 	return 0;
 }
 
+/*******************************************************************************
+ * This function copies a secure image from a list of normal world blocks in a
+ * single SMC, as if FWU_SMC_IMAGE_COPY was called for each block in turn.
+ ******************************************************************************/
+static int bl1_fwu_image_copy_list(unsigned int image_id,
+			uintptr_t list_addr,
+			unsigned int num_blocks,
+			unsigned int image_size,
+			unsigned int flags)
+{
+	fwu_copy_block_t block;
+	image_desc_t *image_desc;
+	unsigned int index;
+	int result;
+
+	/* Only Normal world is allowed to copy a Secure image. */
+	if (GET_SECURITY_STATE(flags) == SECURE) {
+		WARN("BL1-FWU: Copy not allowed from Secure-world\n");
+		return -EPERM;
+	}
+
+	if ((!list_addr) || (!num_blocks) ||
+	    (num_blocks > FWU_COPY_LIST_MAX_BLOCKS)) {
+		WARN("BL1-FWU: Copy not allowed due to invalid block list\n");
+		return -ENOMEM;
+	}
+
+	/* Make sure the whole list is mapped. */
+	if (bl1_plat_mem_check(list_addr, num_blocks * sizeof(block), flags)) {
+		WARN("BL1-FWU: Copy block list not mapped\n");
+		return -ENOMEM;
+	}
+
+	for (index = 0; index < num_blocks; index++) {
+		/*
+		 * Take a copy of the entry, as the normal world could change
+		 * the list while it is being used.
+		 */
+		memcpy(&block, (const void *)(list_addr +
+			index * sizeof(block)), sizeof(block));
+
+		if ((block.addr > UINTPTR_MAX) || (block.size > UINT32_MAX)) {
+			WARN("BL1-FWU: Copy block %u out of range\n", index);
+			return -ENOMEM;
+		}
+
+		result = bl1_fwu_image_copy(image_id, (uintptr_t)block.addr,
+					    (unsigned int)block.size,
+					    image_size, flags);
+		if (result != 0)
+			return result;
+
+		/* Stop once the image is complete, like a clipped block. */
+		image_desc = bl1_plat_get_image_desc(image_id);
+		if ((image_desc->state == IMAGE_STATE_COPIED) &&
+		    (index + 1 < num_blocks)) {
+			WARN("BL1-FWU: Image copied, ignoring %u block(s)\n",
+				num_blocks - index - 1);
+			break;
+		}
+	}
+
+	return 0;
+}
+
+#if FWU_AUTH_BLOCK_SIZE
+/*******************************************************************************
+ * This function hashes the next FWU_AUTH_BLOCK_SIZE bytes at most of an image
+ * being authenticated. The progress is the length of the incremental hash kept
+ * by the auth module, which drops it if anything else is copied or hashed in
+ * between. It returns 1 if the image must be hashed further by another SMC, or
+ * 0 if it can now be authenticated, either because it has been hashed in full
+ * or because it cannot be hashed incrementally (e.g. a certificate).
+ ******************************************************************************/
+static int bl1_fwu_image_auth_block(unsigned int image_id,
+			uintptr_t base_addr,
+			unsigned int total_size)
+{
+	size_t done, block_size;
+
+	done = auth_mod_stream_hash_len(image_id, (void *)base_addr);
+	if (done > total_size)
+		done = 0;
+	if (done == 0)
+		auth_mod_stream_hash_start(image_id);
+
+	block_size = total_size - done;
+	if (block_size > FWU_AUTH_BLOCK_SIZE)
+		block_size = FWU_AUTH_BLOCK_SIZE;
+
+	auth_mod_stream_hash_update((void *)(base_addr + done), block_size);
+	if (done + block_size == total_size)
+		return 0;
+
+	/* Only ask to be called again if the hash did make progress. */
+	return auth_mod_stream_hash_len(image_id, (void *)base_addr) ==
+		done + block_size;
+}
+#endif
+
 /*******************************************************************************
  * This function is responsible for authenticating Normal/Secure images.
  ******************************************************************************/
@@ -296,6 +435,9 @@ static int bl1_fwu_image_auth(unsigned int image_id,
 		/*
 		 * Image is in RESET state.
 		 * Check the parameters and authenticate the source image in place.
+		 * Non-secure images are never copied: they are verified where
+		 * the normal world will execute them from, which BL1 maps
+		 * read-only, so no secure memory is needed for them.
 		 */
 		if (bl1_plat_mem_check(image_src, image_size,	\
 					image_desc->ep_info.h.attr)) {
@@ -310,6 +452,18 @@ static int bl1_fwu_image_auth(unsigned int image_id,
 		image_desc->image_info.image_size = total_size;
 	}
 
+#if FWU_AUTH_BLOCK_SIZE
+	/*
+	 * Bound the time spent in this SMC by hashing large images over
+	 * several calls, in which the image stays in its current state.
+	 */
+	if (bl1_fwu_image_auth_block(image_id, base_addr, total_size)) {
+		VERBOSE("BL1-FWU: Authentication of image_id:%d in progress\n",
+			image_id);
+		return FWU_AUTH_IN_PROGRESS;
+	}
+#endif
+
 	/*
 	 * Authenticate the image.
 	 */
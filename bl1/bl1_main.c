@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -35,6 +35,7 @@
 #include <bl1.h>
 #include <bl_common.h>
 #include <debug.h>
+#include <load_stats.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <smcc_helpers.h>
@@ -164,6 +165,10 @@ void bl1_load_bl2(void)
 	entry_point_info_t *ep_info;
 	meminfo_t *bl1_tzram_layout;
 	meminfo_t *bl2_tzram_layout;
+#if TRUSTED_BOARD_BOOT && AUTH_HANDOFF
+	void *auth_handoff;
+	size_t auth_handoff_size;
+#endif
 	int err;
 
 	/* Get the image descriptor */
@@ -204,6 +209,33 @@ void bl1_load_bl2(void)
 	bl1_init_bl2_mem_layout(bl1_tzram_layout, bl2_tzram_layout);
 
 	ep_info->args.arg1 = (unsigned long)bl2_tzram_layout;
+
+#if TRUSTED_BOARD_BOOT && AUTH_HANDOFF
+	/*
+	 * Hand over the certificate data authenticated by BL1 right after the
+	 * memory layout, so BL2 does not verify the same certificates again.
+	 * BL2 imports it before it loads anything into its free memory.
+	 */
+	auth_handoff = bl2_tzram_layout + 1;
+	auth_handoff_size = auth_mod_handoff_export(auth_handoff,
+			bl1_tzram_layout->free_size - sizeof(meminfo_t));
+	if (auth_handoff_size != 0) {
+		flush_dcache_range((unsigned long)auth_handoff,
+				   auth_handoff_size);
+		ep_info->args.arg2 = (unsigned long)auth_handoff;
+	}
+#endif
+
+#if TRUSTED_BOARD_BOOT && MEASURED_BOOT
+	/* The event log stays in BL1 memory, which BL2 does not overwrite */
+	ep_info->args.arg3 = (unsigned long)event_log_export();
+#endif
+
+	load_stats_print();
+#if MEASURE_STACK_USAGE
+	NOTICE("BL1: Stack usage: %u of %u bytes\n", plat_get_stack_usage(0),
+	       PLATFORM_STACK_SIZE);
+#endif
 	NOTICE("BL1: Booting BL2\n");
 	VERBOSE("BL1: BL2 memory layout address = 0x%llx\n",
 		(unsigned long long) bl2_tzram_layout);
@@ -217,6 +249,10 @@ void bl1_load_bl2(void)
 void bl1_print_bl31_ep_info(const entry_point_info_t *bl31_ep_info)
 {
 	NOTICE("BL1: Booting BL31\n");
+#if MEASURE_STACK_USAGE
+	NOTICE("BL1: Stack usage: %u of %u bytes\n", plat_get_stack_usage(0),
+	       PLATFORM_STACK_SIZE);
+#endif
 	print_entry_point_info(bl31_ep_info);
 }
 
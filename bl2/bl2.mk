@@ -35,3 +35,22 @@ BL2_SOURCES		+=	bl2/bl2_main.c				\
 				lib/locks/exclusive/spinlock.S
 
 BL2_LINKERFILE		:=	bl2/bl2.ld.S
+
+ifeq (${XLAT_EARLY_MMU},1)
+BL2_SOURCES		+=	lib/aarch64/xlat_early.S
+endif
+
+ifeq (${BL2_PARALLEL_LOAD},1)
+BL2_SOURCES		+=	bl2/bl2_parallel.c			\
+				plat/common/plat_bl2_common.c
+endif
+
+ifeq (${FAST_WARM_REBOOT},1)
+BL2_SOURCES		+=	common/warm_reboot.c
+# The mbed TLS crypto module already includes the SHA-256 implementation when
+# AUTH_SHA256_CE is set
+ifneq (${TRUSTED_BOARD_BOOT}${AUTH_SHA256_CE},11)
+    BL2_SOURCES		+=	drivers/auth/sha256_ce/sha256_ce.c	\
+    				drivers/auth/sha256_ce/sha256_ce_helpers.S
+endif
+endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -36,9 +36,11 @@
 #include <bl_common.h>
 #include <debug.h>
 #include <errno.h>
+#include <load_stats.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <stdint.h>
+#include <warm_reboot.h>
 #include "bl2_private.h"
 
 /*
@@ -153,11 +155,16 @@ static int load_bl32(bl31_params_t *bl2_to_bl31_params)
 	 * completely different memory.
 	 */
 	bl2_plat_get_bl32_meminfo(&bl32_mem_info);
-	e = load_auth_image(&bl32_mem_info,
-			    BL32_IMAGE_ID,
-			    BL32_BASE,
-			    bl2_to_bl31_params->bl32_image_info,
-			    bl2_to_bl31_params->bl32_ep_info);
+	e = warm_reboot_reuse(BL32_IMAGE_ID,
+			      bl2_to_bl31_params->bl32_image_info,
+			      bl2_to_bl31_params->bl32_ep_info);
+	if (e != 0) {
+		e = load_auth_image(&bl32_mem_info,
+				    BL32_IMAGE_ID,
+				    BL32_BASE,
+				    bl2_to_bl31_params->bl32_image_info,
+				    bl2_to_bl31_params->bl32_ep_info);
+	}
 
 	if (e == 0) {
 		bl2_plat_set_bl32_ep_info(
@@ -187,11 +194,16 @@ static int load_bl33(bl31_params_t *bl2_to_bl31_params)
 	bl2_plat_get_bl33_meminfo(&bl33_mem_info);
 
 	/* Load the BL33 image in non-secure memory provided by the platform */
-	e = load_auth_image(&bl33_mem_info,
-			    BL33_IMAGE_ID,
-			    plat_get_ns_image_entrypoint(),
-			    bl2_to_bl31_params->bl33_image_info,
-			    bl2_to_bl31_params->bl33_ep_info);
+	e = warm_reboot_reuse(BL33_IMAGE_ID,
+			      bl2_to_bl31_params->bl33_image_info,
+			      bl2_to_bl31_params->bl33_ep_info);
+	if (e != 0) {
+		e = load_auth_image(&bl33_mem_info,
+				    BL33_IMAGE_ID,
+				    plat_get_ns_image_entrypoint(),
+				    bl2_to_bl31_params->bl33_image_info,
+				    bl2_to_bl31_params->bl33_ep_info);
+	}
 
 	if (e == 0) {
 		bl2_plat_set_bl33_ep_info(bl2_to_bl31_params->bl33_image_info,
@@ -202,18 +214,103 @@ static int load_bl33(bl31_params_t *bl2_to_bl31_params)
 }
 #endif /* BL33_BASE */
 
+#if BL2_IMAGE_PREFETCH
+/*******************************************************************************
+ * Tell the loader which image BL2 loads next, so that it can be read while the
+ * current image is being authenticated.
+ ******************************************************************************/
+#ifdef BL32_BASE
+static void set_next_bl32(void)
+{
+	meminfo_t bl32_mem_info;
+
+	bl2_plat_get_bl32_meminfo(&bl32_mem_info);
+	load_image_set_next(&bl32_mem_info, BL32_IMAGE_ID, BL32_BASE);
+}
+#endif
+
+#ifndef BL33_BASE
+static void set_next_bl33(void)
+{
+	meminfo_t bl33_mem_info;
+
+	bl2_plat_get_bl33_meminfo(&bl33_mem_info);
+	load_image_set_next(&bl33_mem_info, BL33_IMAGE_ID,
+			    plat_get_ns_image_entrypoint());
+}
+#endif
+#endif /* BL2_IMAGE_PREFETCH */
+
+#if FAST_WARM_REBOOT
+/*******************************************************************************
+ * Find out whether BL32 and BL33 are still resident in memory since the last
+ * warm reboot, before any image is loaded. This runs on the primary CPU, as it
+ * hashes the images with the SHA-256 instructions.
+ ******************************************************************************/
+static void check_resident_images(void)
+{
+	meminfo_t mem_info;
+
+	warm_reboot_init();
+#ifdef BL32_BASE
+	bl2_plat_get_bl32_meminfo(&mem_info);
+	warm_reboot_check(BL32_IMAGE_ID, &mem_info, BL32_BASE);
+#endif
+#ifndef BL33_BASE
+	bl2_plat_get_bl33_meminfo(&mem_info);
+	warm_reboot_check(BL33_IMAGE_ID, &mem_info,
+			  plat_get_ns_image_entrypoint());
+#endif
+}
+#endif /* FAST_WARM_REBOOT */
+
 #endif /* EL3_PAYLOAD_BASE */
 
+#if TRUSTED_BOARD_BOOT && AUTH_BATCH_CERTS && !defined(EL3_PAYLOAD_BASE)
+/*******************************************************************************
+ * Verify the certificates of all the images BL2 is going to load before any of
+ * them is loaded. They are loaded at the BL31 base address in the BL2 memory
+ * layout, which nothing uses yet.
+ ******************************************************************************/
+static void load_auth_bl2_certs(void)
+{
+	static const unsigned int image_ids[] = {
+#ifdef SCP_BL2_BASE
+		SCP_BL2_IMAGE_ID,
+#endif
+		BL31_IMAGE_ID,
+#ifdef BL32_BASE
+		BL32_IMAGE_ID,
+#endif
+#ifndef BL33_BASE
+		BL33_IMAGE_ID,
+#endif
+	};
+
+	INFO("BL2: Verifying certificates\n");
+	load_auth_certs(bl2_plat_sec_mem_layout(), image_ids,
+			ARRAY_SIZE(image_ids), BL31_BASE);
+}
+#endif /* TRUSTED_BOARD_BOOT && AUTH_BATCH_CERTS && !EL3_PAYLOAD_BASE */
+
 /*******************************************************************************
  * The only thing to do in BL2 is to load further images and pass control to
  * BL31. The memory occupied by BL2 will be reclaimed by BL3x stages. BL2 runs
- * entirely in S-EL1.
+ * entirely in S-EL1. 'bl1_auth_handoff' is the authentication data handed over
+ * by BL1 when TRUSTED_BOARD_BOOT=1 and AUTH_HANDOFF=1, 'bl1_event_log' the
+ * event log of BL1 when TRUSTED_BOARD_BOOT=1 and MEASURED_BOOT=1.
  ******************************************************************************/
-void bl2_main(void)
+void bl2_main(void *bl1_auth_handoff, const void *bl1_event_log)
 {
 	bl31_params_t *bl2_to_bl31_params;
 	entry_point_info_t *bl31_ep_info;
 	int e;
+#if BL2_PARALLEL_LOAD && !defined(EL3_PAYLOAD_BASE)
+	unsigned int bl32_job;
+#ifndef BL33_BASE
+	unsigned int bl33_job;
+#endif
+#endif
 
 	NOTICE("BL2: %s\n", version_string);
 	NOTICE("BL2: %s\n", build_message);
@@ -224,6 +321,15 @@ void bl2_main(void)
 #if TRUSTED_BOARD_BOOT
 	/* Initialize authentication module */
 	auth_mod_init();
+#if AUTH_HANDOFF
+	auth_mod_handoff_import(bl1_auth_handoff);
+#endif
+#if MEASURED_BOOT
+	event_log_import(bl1_event_log);
+#endif
+#if AUTH_BATCH_CERTS && !defined(EL3_PAYLOAD_BASE)
+	load_auth_bl2_certs();
+#endif
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/*
@@ -261,13 +367,46 @@ void bl2_main(void)
 	bl31_ep_info->args.arg0 = (unsigned long) bl2_to_bl31_params;
 	bl2_plat_set_bl31_ep_info(NULL, bl31_ep_info);
 #else
+#if FAST_WARM_REBOOT
+	check_resident_images();
+#endif
+
+#if BL2_PARALLEL_LOAD
+	/*
+	 * BL32 and BL33 are loaded in memory of their own, so they can be
+	 * loaded by helper CPUs while the primary CPU loads BL31 (which consumes
+	 * the memory layout of BL2).
+	 */
+	bl32_job = bl2_parallel_add_job(load_bl32, bl2_to_bl31_params);
+#ifndef BL33_BASE
+	bl33_job = bl2_parallel_add_job(load_bl33, bl2_to_bl31_params);
+#endif
+	bl2_parallel_start();
+#endif /* BL2_PARALLEL_LOAD */
+
+#if BL2_IMAGE_PREFETCH
+#ifdef BL32_BASE
+	set_next_bl32();
+#elif !defined(BL33_BASE)
+	set_next_bl33();
+#endif
+#endif
 	e = load_bl31(bl2_to_bl31_params, bl31_ep_info);
 	if (e) {
 		ERROR("Failed to load BL31 (%i)\n", e);
 		plat_error_handler(e);
 	}
 
+#if BL2_PARALLEL_LOAD
+	/* Wait for the images loaded by the helper CPUs */
+	bl2_parallel_join();
+	e = bl2_parallel_job_result(bl32_job);
+#else
+#if BL2_IMAGE_PREFETCH && defined(BL32_BASE) && !defined(BL33_BASE)
+	set_next_bl33();
+#endif
 	e = load_bl32(bl2_to_bl31_params);
+#endif
 	if (e) {
 		if (e == -EAUTH) {
 			ERROR("Failed to authenticate BL32\n");
@@ -276,6 +415,11 @@ void bl2_main(void)
 			WARN("Failed to load BL32 (%i)\n", e);
 		}
 	}
+#if FAST_WARM_REBOOT && defined(BL32_BASE)
+	if (e == 0)
+		warm_reboot_record(BL32_IMAGE_ID,
+				   bl2_to_bl31_params->bl32_image_info);
+#endif
 
 #ifdef BL33_BASE
 	/*
@@ -285,16 +429,40 @@ void bl2_main(void)
 	INFO("BL2: Populating the entrypoint info for the preloaded BL33\n");
 	bl2_to_bl31_params->bl33_ep_info->pc = BL33_BASE;
 	bl2_plat_set_bl33_ep_info(NULL, bl2_to_bl31_params->bl33_ep_info);
+#else
+#if BL2_PARALLEL_LOAD
+	e = bl2_parallel_job_result(bl33_job);
 #else
 	e = load_bl33(bl2_to_bl31_params);
+#endif
 	if (e) {
 		ERROR("Failed to load BL33 (%i)\n", e);
 		plat_error_handler(e);
 	}
+#if FAST_WARM_REBOOT
+	warm_reboot_record(BL33_IMAGE_ID, bl2_to_bl31_params->bl33_image_info);
+#endif
 #endif /* BL33_BASE */
 
+#if FAST_WARM_REBOOT
+	warm_reboot_seal();
+#endif
+
 #endif /* EL3_PAYLOAD_BASE */
 
+	load_stats_print();
+#if LOAD_IMAGE_STATS
+	bl2_to_bl31_params->load_stats = load_stats_export();
+#endif
+#if TRUSTED_BOARD_BOOT && MEASURED_BOOT
+	bl2_to_bl31_params->event_log = event_log_export();
+#endif
+
+#if MEASURE_STACK_USAGE
+	NOTICE("BL2: Stack usage: %u of %u bytes\n", plat_get_stack_usage(0),
+	       PLATFORM_STACK_SIZE);
+#endif
+
 	/* Flush the params to be passed to memory */
 	bl2_plat_flush_bl31_params();
 
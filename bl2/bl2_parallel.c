@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <atomic.h>
+#include <bl_common.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <xlat_tables.h>
+#include "bl2_private.h"
+
+/* Maximum number of images that can be handed over to the helper CPUs */
+#define BL2_MAX_LOAD_JOBS	4
+
+/* Load job states */
+#define JOB_PENDING		0
+#define JOB_RUNNING		1
+#define JOB_DONE		2
+
+typedef struct load_job {
+	bl2_load_fn_t load;
+	bl31_params_t *params;
+	volatile uint32_t state;
+	volatile int rc;
+} load_job_t;
+
+static load_job_t load_jobs[BL2_MAX_LOAD_JOBS];
+static unsigned int job_count;
+static unsigned int helper_count;
+static volatile uint32_t jobs_done;
+static volatile uint32_t helpers_exited;
+
+/*******************************************************************************
+ * Queue an image load to be run by the next available CPU. Must be called by
+ * the primary CPU before bl2_parallel_start(). Returns the job identifier.
+ ******************************************************************************/
+unsigned int bl2_parallel_add_job(bl2_load_fn_t load, bl31_params_t *params)
+{
+	load_job_t *job;
+
+	assert(load != NULL);
+	assert(job_count < BL2_MAX_LOAD_JOBS);
+
+	job = &load_jobs[job_count];
+	job->load = load;
+	job->params = params;
+	job->state = JOB_PENDING;
+	job->rc = 0;
+
+	return job_count++;
+}
+
+/*******************************************************************************
+ * Claim and run the pending jobs until there are none left.
+ ******************************************************************************/
+static void run_jobs(void)
+{
+	load_job_t *job;
+	unsigned int i;
+
+	for (i = 0; i < job_count; i++) {
+		job = &load_jobs[i];
+
+		/* Claim the job unless another CPU already has */
+		if (atomic_cmpxchg_32(&job->state, JOB_PENDING, JOB_RUNNING)
+							!= JOB_PENDING)
+			continue;
+
+		job->rc = job->load(job->params);
+
+		/*
+		 * The atomic increment orders the result of the job before the
+		 * update of the count of the jobs done.
+		 */
+		job->state = JOB_DONE;
+		atomic_fetch_add_32(&jobs_done, 1);
+
+		/* Wake up the primary CPU if it is waiting for this job */
+		dsbish();
+		sev();
+	}
+}
+
+/*******************************************************************************
+ * Release the helper CPUs so that they start running the queued jobs.
+ ******************************************************************************/
+void bl2_parallel_start(void)
+{
+	helper_count = bl2_plat_release_helper_cpus(
+				(uintptr_t)bl2_helper_entrypoint);
+	assert(helper_count < PLATFORM_CORE_COUNT);
+
+	INFO("BL2: Loading %u image(s) with %u helper CPU(s)\n",
+	     job_count, helper_count);
+}
+
+/*******************************************************************************
+ * Help with the remaining jobs and wait until all of them are done and all the
+ * helper CPUs have stopped using BL2 memory.
+ ******************************************************************************/
+void bl2_parallel_join(void)
+{
+	run_jobs();
+
+	while ((jobs_done != job_count) || (helpers_exited != helper_count))
+		wfe();
+}
+
+/*******************************************************************************
+ * Return the result of a job once bl2_parallel_join() has returned.
+ ******************************************************************************/
+int bl2_parallel_job_result(unsigned int job_id)
+{
+	assert(job_id < job_count);
+	assert(load_jobs[job_id].state == JOB_DONE);
+
+	return load_jobs[job_id].rc;
+}
+
+/*******************************************************************************
+ * C entrypoint of the helper CPUs, called from bl2_helper_entrypoint() with
+ * the MMU off. The translation tables have already been set up by the primary
+ * CPU in bl2_plat_arch_setup().
+ ******************************************************************************/
+void bl2_helper_main(unsigned int helper_idx)
+{
+	enable_mmu_el1(0);
+
+	VERBOSE("BL2: Helper CPU %u running\n", helper_idx);
+
+	run_jobs();
+
+	atomic_fetch_add_32(&helpers_exited, 1);
+	dsbish();
+	sev();
+
+	bl2_plat_park_helper_cpu();
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -36,4 +36,18 @@
  *****************************************/
 void bl2_arch_setup(void);
 
+#if BL2_PARALLEL_LOAD
+struct bl31_params;
+
+typedef int (*bl2_load_fn_t)(struct bl31_params *params);
+
+unsigned int bl2_parallel_add_job(bl2_load_fn_t load,
+				  struct bl31_params *params);
+void bl2_parallel_start(void);
+void bl2_parallel_join(void);
+int bl2_parallel_job_result(unsigned int job_id);
+void bl2_helper_entrypoint(void);
+void bl2_helper_main(unsigned int helper_idx) __dead2;
+#endif
+
 #endif /* __BL2_PRIVATE_H__ */
@@ -29,6 +29,7 @@
 #
 
 BL2U_SOURCES		+=	bl2u/bl2u_main.c			\
+				bl2u/bl2u_flash.c			\
 				bl2u/aarch64/bl2u_entrypoint.S		\
 				common/aarch64/early_exceptions.S
 
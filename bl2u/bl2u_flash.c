@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <assert.h>
+#include <bl2u_flash.h>
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+/*
+ * Wait for the erase of the block at 'addr' to complete
+ */
+static int wait_erase(const bl2u_flash_ops_t *ops, uintptr_t addr)
+{
+	int ret;
+
+	do {
+		ret = ops->erase_poll(addr);
+	} while (ret == -EBUSY);
+
+	return ret;
+}
+
+/*
+ * Write 'size' bytes from 'src' to the flash at 'dst', which must be aligned
+ * on an erase block. The blocks go through a three stage pipeline: while block
+ * N is programmed, block N+1 is being erased in the background and block N-1
+ * is verified, so that the erase time is mostly hidden behind the other two.
+ * The end of the last block, past 'size', is left erased.
+ *
+ * If 'report_blocks' is not zero, the number of bytes verified so far is
+ * reported to the normal world FWU client every 'report_blocks' blocks, by
+ * yielding with FWU_SMC_IMAGE_RESUME. The client must resume BL2U with the
+ * same SMC to carry on, and must not access the flash in between.
+ *
+ * Return 0 on success, or the negative error code of the failed operation.
+ */
+int bl2u_flash_write(const bl2u_flash_ops_t *ops, uintptr_t dst,
+		     const void *src, size_t size,
+		     unsigned int report_blocks)
+{
+	size_t block_size, num_blocks, done, len;
+	uintptr_t data = (uintptr_t)src;
+	uintptr_t erasing = dst;
+	int erase_pending = 0;
+	unsigned int i = 0;
+	int ret;
+
+	assert(ops != NULL);
+	assert((ops->block_size != 0) && (ops->erase_start != NULL) &&
+	       (ops->erase_poll != NULL) && (ops->program != NULL));
+
+	block_size = ops->block_size;
+	if ((dst % block_size) != 0) {
+		ERROR("BL2U: Flash write not aligned on a block\n");
+		return -EINVAL;
+	}
+
+	num_blocks = (size + block_size - 1) / block_size;
+	if (num_blocks == 0)
+		return 0;
+
+	ret = ops->erase_start(dst);
+	if (ret != 0)
+		goto error;
+	erase_pending = 1;
+
+	for (i = 0; i <= num_blocks; i++) {
+		if (i < num_blocks) {
+			/* Block N must be erased before it is programmed */
+			ret = wait_erase(ops, erasing);
+			erase_pending = 0;
+			if (ret != 0)
+				goto error;
+
+			if (i + 1 < num_blocks) {
+				erasing = dst + (i + 1) * block_size;
+				ret = ops->erase_start(erasing);
+				if (ret != 0)
+					goto error;
+				erase_pending = 1;
+			}
+
+			len = size - i * block_size;
+			if (len > block_size)
+				len = block_size;
+			ret = ops->program(dst + i * block_size,
+					   (const void *)(data + i * block_size),
+					   len);
+			if (ret != 0)
+				goto error;
+		}
+
+		if (i == 0)
+			continue;
+
+		/* Verify block N-1 while block N+1 is still being erased */
+		len = size - (i - 1) * block_size;
+		if (len > block_size)
+			len = block_size;
+		if (ops->verify != NULL) {
+			ret = ops->verify(dst + (i - 1) * block_size,
+					  (const void *)(data +
+						(i - 1) * block_size), len);
+		} else {
+			ret = memcmp((const void *)(dst + (i - 1) * block_size),
+				     (const void *)(data + (i - 1) * block_size),
+				     len) ? -EIO : 0;
+		}
+		if (ret != 0)
+			goto error;
+
+		done = (i - 1) * block_size + len;
+		VERBOSE("BL2U: %lu/%lu bytes written to flash\n",
+			(unsigned long)done, (unsigned long)size);
+
+		if ((report_blocks != 0) && ((i % report_blocks) == 0) &&
+		    (i < num_blocks))
+			(void)bl2u_fwu_resume(done);
+	}
+
+	return 0;
+
+error:
+	ERROR("BL2U: Flash write at block %u failed (%i)\n", i, ret);
+	/* Do not leave an erase running in the background */
+	if (erase_pending)
+		(void)wait_erase(ops, erasing);
+	return ret;
+}
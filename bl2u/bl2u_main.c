@@ -63,6 +63,11 @@ void bl2u_main(void)
 	/* Perform platform setup in BL2U after loading SCP_BL2U */
 	bl2u_platform_setup();
 
+#if MEASURE_STACK_USAGE
+	NOTICE("BL2U: Stack usage: %u of %u bytes\n", plat_get_stack_usage(0),
+	       PLATFORM_STACK_SIZE);
+#endif
+
 	/*
 	 * Indicate that BL2U is done and resume back to
 	 * normal world via an SMC to BL1.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -36,6 +36,24 @@
 #include <cpu_data.h>
 #include <platform.h>
 
+/*
+ * Frequency of the system counter. It does not change at runtime, so it is
+ * retrieved from the platform only once instead of on every warm boot.
+ */
+static uint64_t bl31_syscnt_freq;
+
+/*******************************************************************************
+ * This function returns the frequency of the system counter to program into
+ * the CNTFRQ_EL0 register. It must be called with the data cache enabled.
+ ******************************************************************************/
+uint64_t bl31_get_syscnt_freq(void)
+{
+	if (!bl31_syscnt_freq)
+		bl31_syscnt_freq = plat_get_syscnt_freq();
+
+	return bl31_syscnt_freq;
+}
+
 /*******************************************************************************
  * This duplicates what the primary cpu did after a cold boot in BL1. The same
  * needs to be done when a cpu is hotplugged in. This function could also over-
@@ -44,7 +62,7 @@
 void bl31_arch_setup(void)
 {
 	/* Program the counter frequency */
-	write_cntfrq_el0(plat_get_syscnt_freq());
+	write_cntfrq_el0(bl31_get_syscnt_freq());
 
 	/* Initialize the cpu_ops pointer. */
 	init_cpu_ops();
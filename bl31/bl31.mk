@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
 #
 # Redistribution and use in source and binary forms, with or without
 # modification, are permitted provided that the following conditions are met:
@@ -37,6 +37,7 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				bl31/aarch64/cpu_data.S				\
 				bl31/aarch64/runtime_exceptions.S		\
 				bl31/aarch64/crash_reporting.S			\
+				bl31/bl31_boot_tasks.c				\
 				bl31/bl31_context_mgmt.c			\
 				common/aarch64/context.S			\
 				common/context_mgmt.c				\
@@ -59,6 +60,76 @@ else
 BL31_SOURCES		+=	lib/locks/bakery/bakery_lock_normal.c
 endif
 
+ifeq (${HW_ASSISTED_COHERENCY},1)
+BL31_SOURCES		+=	lib/locks/exclusive/ticket_lock.S
+endif
+
+ifeq (${EL3_TIMER_SERVICE},1)
+BL31_SOURCES		+=	bl31/el3_timer.c
+endif
+
+ifeq (${SMC_LATENCY_STATS},1)
+BL31_SOURCES		+=	bl31/smc_stats.c
+endif
+
+ifeq (${SPD_TRACE},1)
+BL31_SOURCES		+=	bl31/spd_trace.c
+endif
+
+ifeq (${EL3_TELEMETRY},1)
+BL31_SOURCES		+=	bl31/el3_telemetry.c
+endif
+
+ifeq (${CONSOLE_BUFFERED},1)
+BL31_SOURCES		+=	bl31/console_buffer.c
+endif
+
+ifeq (${DEFERRED_LOG},1)
+BL31_SOURCES		+=	common/log_record.c
+endif
+
+ifeq (${EL3_HANG_DETECT},1)
+BL31_SOURCES		+=	bl31/hang_detect.c
+endif
+
+ifeq (${ENABLE_PSCI_STAT},1)
+BL31_SOURCES		+=	services/std_svc/psci/psci_stat.c
+endif
+
+ifeq (${ENABLE_PSCI_TRACE},1)
+BL31_SOURCES		+=	services/std_svc/psci/psci_trace.c
+endif
+
+ifeq (${PSCI_STATE_LATENCY},1)
+BL31_SOURCES		+=	services/std_svc/psci/psci_latency.c
+endif
+
+ifeq (${PSCI_STATE_EXPORT},1)
+BL31_SOURCES		+=	services/std_svc/psci/psci_export.c
+endif
+
+ifeq (${PSCI_PARK_SECONDARIES},1)
+BL31_SOURCES		+=	services/std_svc/psci/psci_park.c
+endif
+
+ifeq (${PSCI_SYS_SUSPEND_OPS},1)
+BL31_SOURCES		+=	services/std_svc/psci/psci_sys_suspend.c
+endif
+
+ifeq (${REPORT_ERRATA},1)
+BL31_SOURCES		+=	lib/cpus/errata_report.c
+endif
+
+ifeq (${RESET_TO_BL31_VERIFY},1)
+BL31_SOURCES		+=	bl31/bl31_image_verify.c			\
+				drivers/auth/sha256_ce/sha256_ce.c		\
+				drivers/auth/sha256_ce/sha256_ce_helpers.S
+endif
+
+ifeq (${FAST_WARM_REBOOT},1)
+BL31_SOURCES		+=	common/warm_reboot.c
+endif
+
 BL31_LINKERFILE		:=	bl31/bl31.ld.S
 
 # Flag used to indicate if Crash reporting via console should be included
@@ -69,3 +140,10 @@ endif
 
 $(eval $(call assert_boolean,CRASH_REPORTING))
 $(eval $(call add_define,CRASH_REPORTING))
+
+ifeq (${CRASH_DUMP},1)
+    ifneq (${CRASH_REPORTING},1)
+        $(error "CRASH_DUMP requires CRASH_REPORTING=1")
+    endif
+BL31_SOURCES		+=	bl31/crash_dump.c
+endif
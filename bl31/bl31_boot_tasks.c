@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <assert.h>
+#include <bl_common.h>
+#include <bl31.h>
+#include <debug.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * This function runs the platform setup steps in 'tasks' on the calling cpu.
+ * Each step is started once all the steps it depends on have completed, in
+ * the order of the array among the steps which are ready. A step which has
+ * started but not completed yet, e.g. because it waits for a device, does not
+ * hold back the steps which do not depend on it: they are started meanwhile
+ * and its completion is checked again after each pass over the array. The
+ * function returns once all the steps have completed.
+ ******************************************************************************/
+void __init bl31_run_boot_tasks(const bl31_boot_task_t *tasks,
+				unsigned int num_tasks)
+{
+	uint32_t all, started = 0, done = 0, progress;
+	unsigned int i;
+
+	assert(num_tasks <= BL31_BOOT_TASKS_MAX);
+	all = (uint32_t)((1ULL << num_tasks) - 1);
+
+	while (done != all) {
+		progress = 0;
+
+		for (i = 0; i < num_tasks; i++) {
+			if (done & (1U << i))
+				continue;
+
+			if (!(started & (1U << i))) {
+				assert((tasks[i].deps & ~all) == 0);
+				if (tasks[i].deps & ~done)
+					continue;
+
+				VERBOSE("BL31: Starting %s\n", tasks[i].name);
+				tasks[i].start();
+				started |= 1U << i;
+				progress = 1;
+			}
+
+			if (!tasks[i].is_done || tasks[i].is_done()) {
+				done |= 1U << i;
+				progress = 1;
+			}
+		}
+
+		/* Only steps waiting for their device can be left running */
+		if (!progress && !(started & ~done)) {
+			ERROR("BL31: Circular boot task dependencies\n");
+			panic();
+		}
+	}
+}
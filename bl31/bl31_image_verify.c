@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <assert.h>
+#include <bl31.h>
+#include <debug.h>
+#include <platform.h>
+#include <sha256_ce.h>
+#include <string.h>
+
+/*******************************************************************************
+ * When BL31 is the reset vector, BL32 and BL33 are preloaded in memory and no
+ * earlier stage has authenticated them. This function checks the SHA-256 of
+ * each image in the digest table of the platform before BL31 runs any of them,
+ * and panics on a mismatch. The images must be mapped by BL31 at this point.
+ * The digests are calculated with the Cryptographic Extension, which the CPU
+ * must implement: there is no software fallback in BL31.
+ ******************************************************************************/
+void bl31_verify_images(void)
+{
+	const bl31_image_digest_t *images;
+	unsigned char digest[SHA256_CE_DIGEST_SIZE];
+	unsigned int num, i;
+
+	images = bl31_plat_get_image_digests(&num);
+	assert((images != NULL) || (num == 0));
+
+	if (!sha256_ce_supported()) {
+		ERROR("BL31: Cannot verify the images without the SHA-256"
+		      " instructions\n");
+		panic();
+	}
+
+	for (i = 0; i < num; i++) {
+		sha256_ce((const unsigned char *)images[i].base,
+			  images[i].size, digest);
+		if (memcmp(digest, images[i].sha256, sizeof(digest)) != 0) {
+			ERROR("BL31: Image at 0x%lx failed verification\n",
+			      images[i].base);
+			panic();
+		}
+		VERBOSE("BL31: Image at 0x%lx verified (%u bytes)\n",
+			images[i].base, images[i].size);
+	}
+}
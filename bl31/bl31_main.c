@@ -33,11 +33,15 @@
 #include <assert.h>
 #include <bl_common.h>
 #include <bl31.h>
+#include <console_buffer.h>
 #include <context_mgmt.h>
+#include <cpu_data.h>
 #include <debug.h>
+#include <errata_report.h>
 #include <platform.h>
 #include <runtime_svc.h>
 #include <string.h>
+#include <xlat_tables.h>
 
 /*******************************************************************************
  * This function pointer is used to initialise the BL32 image. It's initialized
@@ -53,10 +57,34 @@ static int32_t (*bl32_init)(void);
  ******************************************************************************/
 static uint32_t next_image_type = NON_SECURE;
 
+#if BL31_RECLAIM_INIT
+/*******************************************************************************
+ * Remap the pages of the init code and data of BL31 as read-write memory and
+ * hand them over to the platform. None of the __init functions can run after
+ * this.
+ ******************************************************************************/
+static void bl31_reclaim_init_mem(void)
+{
+	uintptr_t base = (uintptr_t)&__INIT_START__;
+	size_t size = (uintptr_t)&__INIT_END__ - base;
+
+	if (mmap_remap_region(base, size, MT_MEMORY | MT_RW | MT_SECURE)) {
+		ERROR("BL31: Failed to remap the init memory\n");
+		panic();
+	}
+
+	memset((void *)base, 0, size);
+	flush_dcache_range(base, size);
+
+	INFO("BL31: Reclaimed %u bytes of init memory\n", (unsigned int)size);
+	bl31_plat_init_mem_reclaimed(base, size);
+}
+#endif
+
 /*******************************************************************************
  * Simple function to initialise all BL31 helper libraries.
  ******************************************************************************/
-void bl31_lib_init(void)
+void __init bl31_lib_init(void)
 {
 	cm_init();
 }
@@ -77,9 +105,21 @@ void bl31_main(void)
 	/* Perform remaining generic architectural setup from EL3 */
 	bl31_arch_setup();
 
+	/* Per-cpu variables can be used from now on */
+	init_percpu_vars();
+
 	/* Perform platform setup in BL31 */
 	bl31_platform_setup();
 
+#if REPORT_ERRATA
+	errata_report_record();
+#endif
+
+#if RESET_TO_BL31_VERIFY
+	/* Check the preloaded images before any of them is run */
+	bl31_verify_images();
+#endif
+
 	/* Initialise helper libraries */
 	bl31_lib_init();
 
@@ -110,6 +150,16 @@ void bl31_main(void)
 	 */
 	bl31_prepare_next_image_entry();
 
+#if BL31_RECLAIM_INIT
+	/* The cold boot is over, release the memory of the init code */
+	bl31_reclaim_init_mem();
+#endif
+
+#if CONSOLE_BUFFERED
+	/* The platform may switch the console to another UART below */
+	console_buffer_flush();
+#endif
+
 	/*
 	 * Perform any platform specific runtime setup prior to cold boot exit
 	 * from BL31
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <cassert.h>
+#include <console.h>
+#include <console_buffer.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <spinlock.h>
+
+#define CONSOLE_BUF_MASK	(CONSOLE_BUF_SIZE - 1)
+
+CASSERT((CONSOLE_BUF_SIZE & CONSOLE_BUF_MASK) == 0,
+	assert_console_buf_size_not_power_of_two);
+
+typedef struct console_buf {
+	/* Position of the next character to be written */
+	volatile unsigned int head;
+	/* Position following the last complete line, up to which it drains */
+	volatile unsigned int committed;
+	/* Position of the next character to be sent to the UART */
+	volatile unsigned int tail;
+	/* Number of characters lost because the ring was full */
+	unsigned int dropped;
+	char data[CONSOLE_BUF_SIZE];
+} __aligned(CACHE_WRITEBACK_GRANULE) console_buf_t;
+
+static console_buf_t console_bufs[PLATFORM_CORE_COUNT];
+
+/* Lock held by the CPU draining the rings to the UART */
+static spinlock_t console_buf_lock;
+
+/*
+ * CPU whose ring is drained first, protected by 'console_buf_lock'. It is the
+ * one whose line was interrupted by a full FIFO, so that lines from different
+ * CPUs are never mixed on the UART.
+ */
+static unsigned int console_buf_next_cpu;
+
+/*******************************************************************************
+ * Send the complete lines of 'buf' to the UART, as long as its transmit FIFO
+ * has room. Returns 0 if some are left, 1 otherwise. Called with the drain
+ * lock held.
+ ******************************************************************************/
+static int console_buf_drain_one(console_buf_t *buf)
+{
+	unsigned int tail = buf->tail;
+	unsigned int committed = buf->committed;
+	int rc = 1;
+
+	/* Read the characters only after the line they belong to is complete */
+	dmbish();
+
+	while (tail != committed) {
+		if (console_putc_nowait(buf->data[tail & CONSOLE_BUF_MASK]) < 0) {
+			rc = 0;
+			break;
+		}
+		tail++;
+	}
+
+	/* Let the owner overwrite the characters only once they are sent */
+	dmbish();
+	buf->tail = tail;
+
+	return rc;
+}
+
+/*******************************************************************************
+ * Drain the rings of all the CPUs until the transmit FIFO is full. This
+ * returns at once if another CPU is already draining them; the lines it misses
+ * are sent by the next drain.
+ ******************************************************************************/
+void console_buffer_drain(void)
+{
+	unsigned int i, cpu;
+
+	if (!spin_trylock(&console_buf_lock))
+		return;
+
+	cpu = console_buf_next_cpu;
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (!console_buf_drain_one(&console_bufs[cpu])) {
+			console_buf_next_cpu = cpu;
+			break;
+		}
+		cpu = (cpu + 1) % PLATFORM_CORE_COUNT;
+	}
+
+	spin_unlock(&console_buf_lock);
+}
+
+/*******************************************************************************
+ * Send all the complete lines held by the rings to the UART, waiting for room
+ * in its transmit FIFO. It is meant for the points where the output must not
+ * be delayed, e.g. before the console is switched to another UART or on a
+ * fatal error.
+ ******************************************************************************/
+void console_buffer_flush(void)
+{
+	unsigned int i, cpu;
+
+	if (!(read_sctlr_el3() & SCTLR_C_BIT))
+		return;
+
+	spin_lock(&console_buf_lock);
+
+	cpu = console_buf_next_cpu;
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		while (!console_buf_drain_one(&console_bufs[cpu]))
+			;
+		cpu = (cpu + 1) % PLATFORM_CORE_COUNT;
+	}
+
+	spin_unlock(&console_buf_lock);
+}
+
+/*******************************************************************************
+ * Append 'c' to 'buf', or drop it if the ring is full of undrained characters.
+ ******************************************************************************/
+static void console_buf_store(console_buf_t *buf, char c)
+{
+	unsigned int head = buf->head;
+
+	if (head - buf->tail >= CONSOLE_BUF_SIZE) {
+		buf->dropped++;
+		return;
+	}
+
+	buf->data[head & CONSOLE_BUF_MASK] = c;
+	buf->head = head + 1;
+}
+
+/*******************************************************************************
+ * Print 'c' through the ring of the calling CPU, and drain the rings each time
+ * a line is complete. Until the data cache of this CPU is enabled, the rings
+ * and the drain lock cannot be shared with the other CPUs, so the character
+ * is sent directly to the UART instead.
+ ******************************************************************************/
+int console_buffer_putc(int c)
+{
+	console_buf_t *buf;
+
+	if (!(read_sctlr_el3() & SCTLR_C_BIT))
+		return console_putc(c);
+
+	buf = &console_bufs[plat_my_core_pos()];
+
+	if (c == '\n')
+		console_buf_store(buf, '\r');
+	console_buf_store(buf, c);
+
+	if (c == '\n') {
+		/* Publish the line only once its characters are visible */
+		dmbish();
+		buf->committed = buf->head;
+		console_buffer_drain();
+	}
+
+	return c;
+}
+
+/*******************************************************************************
+ * Copy up to 24 characters from position 'pos' of the ring of 'linear_id' into
+ * 'chars'. Returns the number of characters copied, or CONSOLE_BUF_E_LOST if
+ * they were overwritten, in which case 'pos' is updated to the oldest position
+ * still held.
+ ******************************************************************************/
+static int console_buf_read(unsigned int linear_id, unsigned int *pos,
+			    uint64_t chars[3])
+{
+	console_buf_t *buf = &console_bufs[linear_id];
+	unsigned int head, avail, i;
+
+	head = buf->head;
+	avail = head - *pos;
+	if (avail > CONSOLE_BUF_SIZE) {
+		*pos = head - CONSOLE_BUF_SIZE;
+		return CONSOLE_BUF_E_LOST;
+	}
+
+	if (avail > 3 * sizeof(uint64_t))
+		avail = 3 * sizeof(uint64_t);
+
+	/* Read the characters only after their position is published */
+	dmbish();
+
+	chars[0] = chars[1] = chars[2] = 0;
+	for (i = 0; i < avail; i++) {
+		chars[i / 8] |= (uint64_t)(unsigned char)
+			buf->data[(*pos + i) & CONSOLE_BUF_MASK] << ((i % 8) * 8);
+	}
+
+	/* The owner may have overwritten them while they were copied */
+	dmbish();
+	head = buf->head;
+	if (head - *pos > CONSOLE_BUF_SIZE) {
+		*pos = head - CONSOLE_BUF_SIZE;
+		return CONSOLE_BUF_E_LOST;
+	}
+
+	return avail;
+}
+
+/*******************************************************************************
+ * SiP handler of the CONSOLE_BUF_READ call.
+ ******************************************************************************/
+uint64_t console_buffer_smc_handler(uint32_t smc_fid,
+				    uint64_t x1,
+				    uint64_t x2,
+				    uint64_t x3,
+				    uint64_t x4,
+				    void *cookie,
+				    void *handle,
+				    uint64_t flags)
+{
+	uint64_t chars[3];
+	unsigned int pos;
+	int rc;
+
+	if ((smc_fid != CONSOLE_BUF_READ) || is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	if ((x1 >= PLATFORM_CORE_COUNT) || (x2 > UINT32_MAX))
+		SMC_RET1(handle, CONSOLE_BUF_E_INVALID);
+
+	pos = x2;
+	rc = console_buf_read(x1, &pos, chars);
+	if (rc == CONSOLE_BUF_E_LOST)
+		SMC_RET2(handle, rc, pos);
+
+	SMC_RET4(handle, rc, chars[0], chars[1], chars[2]);
+}
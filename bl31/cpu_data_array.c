@@ -34,3 +34,16 @@
 
 /* The per_cpu_ptr_cache_t space allocation */
 cpu_data_t percpu_data[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * Cache the offset of the per-cpu variables of each cpu in its cpu_data. This
+ * is done by the primary cpu at cold boot, before the data is cleaned to main
+ * memory for the secondary cpus.
+ ******************************************************************************/
+void init_percpu_vars(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		set_cpu_data_by_index(i, percpu_offset, i * PERCPU_SIZE);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -27,25 +27,23 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-#include <arch_helpers.h>
-#include <delay_timer.h>
-#include <mt8173_def.h>
 
-static uint32_t plat_get_timer_value(void)
-{
-	/* Generic delay timer implementation expects the timer to be a down
-	 * counter. We apply bitwise NOT operator to the tick values returned
-	 * by read_cntpct_el0() to simulate the down counter. */
-	return (uint32_t)(~read_cntpct_el0());
-}
+#include <cpu_data.h>
+#include <crash_dump.h>
+#include <stddef.h>
 
-static const timer_ops_t plat_timer_ops = {
-	.get_timer_value	= plat_get_timer_value,
-	.clk_mult		= 1,
-	.clk_div		= SYS_COUNTER_FREQ_IN_MHZ,
+extern cpu_data_t percpu_data[PLATFORM_CORE_COUNT];
+
+static const crash_dump_region_t cpu_data_dump_region = {
+	(uintptr_t) percpu_data,
+	sizeof(cpu_data_t),
+	sizeof(cpu_data_t)
 };
 
-void plat_delay_timer_init(void)
-{
-	timer_init(&plat_timer_ops);
-}
+const crash_dump_region_t *const crash_dump_regions[] = {
+	&cpu_data_dump_region,
+#if ENABLE_PSCI_TRACE
+	&psci_trace_dump_region,
+#endif
+	NULL
+};
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bakery_lock.h>
+#include <bl31.h>
+#include <cassert.h>
+#include <cpu_data.h>
+#include <el3_telemetry.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <psci_trace.h>
+#include <runtime_svc.h>
+#include <smc_stats.h>
+#include <spinlock.h>
+#include <stddef.h>
+#include <xlat_tables.h>
+
+#if SMC_LATENCY_STATS
+CASSERT(EL3_TELEMETRY_HIST_BUCKETS == SMC_STATS_HIST_BUCKETS, \
+	assert_el3_telemetry_hist_buckets_mismatch);
+#endif
+
+/* Snapshot being written, 'pos' counts the bytes needed even beyond 'size' */
+typedef struct el3_telemetry_buf {
+	uint8_t *base;
+	size_t size;
+	size_t pos;
+	unsigned int num_sections;
+	/* Header of the current section, NULL if it does not fit */
+	el3_telemetry_sect_t *sect;
+	size_t rec_size;
+} el3_telemetry_buf_t;
+
+/* Lock serialising the snapshots, and the updates of the translation tables */
+static spinlock_t el3_telemetry_lock;
+
+/*
+ * Reserve 'size' bytes at the end of the snapshot. It returns NULL if they do
+ * not fit in the buffer, in which case the snapshot only measures its size.
+ */
+static void *el3_telemetry_alloc(el3_telemetry_buf_t *buf, size_t size)
+{
+	void *p = NULL;
+
+	if (buf->pos + size <= buf->size)
+		p = buf->base + buf->pos;
+	buf->pos += size;
+
+	return p;
+}
+
+static void el3_telemetry_sect_begin(el3_telemetry_buf_t *buf,
+				     unsigned int type,
+				     size_t rec_size)
+{
+	el3_telemetry_sect_t *sect;
+
+	sect = el3_telemetry_alloc(buf, sizeof(*sect));
+	if (sect) {
+		sect->type = type;
+		sect->num_recs = 0;
+		sect->rec_size = rec_size;
+		sect->reserved = 0;
+	}
+
+	buf->num_sections++;
+	buf->sect = sect;
+	buf->rec_size = rec_size;
+}
+
+/* Reserve a record in the current section, NULL if it does not fit */
+static void *el3_telemetry_rec(el3_telemetry_buf_t *buf)
+{
+	void *rec = el3_telemetry_alloc(buf, buf->rec_size);
+
+	if (buf->sect)
+		buf->sect->num_recs++;
+
+	return rec;
+}
+
+#if SMC_LATENCY_STATS
+static void el3_telemetry_smc_stats(el3_telemetry_buf_t *buf)
+{
+	el3_telemetry_smc_rec_t *rec;
+	smc_stats_slot_t *slot;
+	unsigned int i, j, k;
+
+	el3_telemetry_sect_begin(buf, EL3_TELEMETRY_SECT_SMC_STATS,
+				 sizeof(*rec));
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		for (j = 0; j < SMC_STATS_SLOTS; j++) {
+			rec = el3_telemetry_rec(buf);
+			if (rec == NULL)
+				continue;
+
+			slot = &get_cpu_data_by_index(i, smc_stats.slot[j]);
+			rec->cpu = i;
+			rec->smc_fid = slot->smc_fid;
+			rec->count = slot->count;
+			rec->min = slot->min;
+			rec->max = slot->max;
+			rec->reserved = 0;
+			rec->total = slot->total;
+			for (k = 0; k < EL3_TELEMETRY_HIST_BUCKETS; k++)
+				rec->hist[k] = slot->hist[k];
+		}
+	}
+}
+#endif
+
+#if ENABLE_PSCI_STAT
+static void el3_telemetry_psci_stat(el3_telemetry_buf_t *buf)
+{
+	el3_telemetry_psci_stat_rec_t *rec;
+	unsigned int node, state, pwrlvl;
+	uint64_t residency, count;
+
+	el3_telemetry_sect_begin(buf, EL3_TELEMETRY_SECT_PSCI_STAT,
+				 sizeof(*rec));
+
+	for (node = 0; node < PSCI_NUM_PWR_DOMAINS; node++) {
+		for (state = PSCI_LOCAL_STATE_RUN + 1;
+		     state <= PLAT_MAX_OFF_STATE; state++) {
+			rec = el3_telemetry_rec(buf);
+			if (rec == NULL)
+				continue;
+
+			psci_stat_read(node, state, &pwrlvl, &residency,
+				       &count);
+			rec->node = node;
+			rec->pwrlvl = pwrlvl;
+			rec->local_state = state;
+			rec->reserved = 0;
+			rec->residency = residency;
+			rec->count = count;
+		}
+	}
+}
+#endif
+
+#if ENABLE_LOCK_PROFILING
+static void el3_telemetry_lock_profile(el3_telemetry_buf_t *buf)
+{
+	el3_telemetry_lock_rec_t *rec;
+	lock_profile_t profile;
+	bakery_lock_t *lock;
+	unsigned int i;
+
+	el3_telemetry_sect_begin(buf, EL3_TELEMETRY_SECT_LOCK_PROFILE,
+				 sizeof(*rec));
+
+	for (i = 0; (lock = bakery_lock_read_profile(i, &profile)); i++) {
+		rec = el3_telemetry_rec(buf);
+		if (rec == NULL)
+			continue;
+
+		rec->lock = (uintptr_t)lock;
+		rec->acquire_count = profile.acquire_count;
+		rec->contended_count = profile.contended_count;
+		rec->wait_ticks = profile.wait_ticks;
+		rec->max_wait_ticks = profile.max_wait_ticks;
+	}
+}
+#endif
+
+#if ENABLE_PSCI_TRACE
+static void el3_telemetry_psci_trace(el3_telemetry_buf_t *buf)
+{
+	el3_telemetry_trace_rec_t *rec;
+	psci_trace_entry_t entry;
+	uint64_t seq, next_seq;
+	unsigned int i, j;
+
+	el3_telemetry_sect_begin(buf, EL3_TELEMETRY_SECT_PSCI_TRACE,
+				 sizeof(*rec));
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		/* Any read returns the sequence number of the next event */
+		psci_trace_read(i, 0, &entry, &next_seq);
+		seq = (next_seq > PSCI_TRACE_ENTRIES) ?
+		      next_seq - PSCI_TRACE_ENTRIES : 0;
+
+		for (j = 0; j < PSCI_TRACE_ENTRIES; j++, seq++) {
+			rec = el3_telemetry_rec(buf);
+			if (rec == NULL)
+				continue;
+
+			rec->cpu = i;
+			rec->seq = seq;
+			rec->reserved = 0;
+			if (psci_trace_read(i, seq, &entry, &next_seq)) {
+				rec->event = 0;
+				rec->arg = 0;
+				rec->timestamp = 0;
+			} else {
+				rec->event = entry.event;
+				rec->arg = entry.arg;
+				rec->timestamp = entry.timestamp;
+			}
+		}
+	}
+}
+#endif
+
+/*******************************************************************************
+ * Write the snapshot to 'buf', or only measure its size if it does not fit.
+ ******************************************************************************/
+static void el3_telemetry_fill(el3_telemetry_buf_t *buf)
+{
+	el3_telemetry_hdr_t *hdr;
+
+	hdr = el3_telemetry_alloc(buf, sizeof(*hdr));
+
+#if SMC_LATENCY_STATS
+	el3_telemetry_smc_stats(buf);
+#endif
+#if ENABLE_PSCI_STAT
+	el3_telemetry_psci_stat(buf);
+#endif
+#if ENABLE_LOCK_PROFILING
+	el3_telemetry_lock_profile(buf);
+#endif
+#if ENABLE_PSCI_TRACE
+	el3_telemetry_psci_trace(buf);
+#endif
+
+	if (hdr) {
+		hdr->magic = EL3_TELEMETRY_MAGIC;
+		hdr->version_major = EL3_TELEMETRY_VERSION_MAJOR;
+		hdr->version_minor = EL3_TELEMETRY_VERSION_MINOR;
+		hdr->size = buf->pos;
+		hdr->num_sections = buf->num_sections;
+		hdr->num_cpus = PLATFORM_CORE_COUNT;
+		hdr->reserved = 0;
+		hdr->timestamp = read_cntpct_el0();
+		hdr->cntfrq = bl31_get_syscnt_freq();
+	}
+}
+
+/*******************************************************************************
+ * Take a snapshot into the buffer at 'pa' of 'size' bytes, or only measure it
+ * if 'pa' is 0. The buffer is mapped as Non-secure memory, so the normal world
+ * cannot make EL3 write to secure memory through it, for the duration of the
+ * snapshot only.
+ ******************************************************************************/
+static int el3_telemetry_snapshot(uint64_t pa, uint64_t size,
+				  size_t *snap_size)
+{
+	el3_telemetry_buf_t buf = { 0 };
+	int rc = 0;
+
+	if (pa == 0) {
+		el3_telemetry_fill(&buf);
+		*snap_size = buf.pos;
+		return 0;
+	}
+
+	*snap_size = 0;
+	if ((pa & PAGE_SIZE_MASK) || (size & PAGE_SIZE_MASK) || (size == 0) ||
+	    (pa + size < pa))
+		return EL3_TELEMETRY_E_INVALID;
+
+	spin_lock(&el3_telemetry_lock);
+
+	if (mmap_add_dynamic_region(pa, pa, size, MT_MEMORY | MT_RW | MT_NS)) {
+		rc = EL3_TELEMETRY_E_INVALID;
+	} else {
+		buf.base = (uint8_t *)pa;
+		buf.size = size;
+		el3_telemetry_fill(&buf);
+		*snap_size = buf.pos;
+
+		/* The normal world may read the buffer with its cache off */
+		flush_dcache_range(pa, (buf.pos > size) ? size : buf.pos);
+
+		rc = mmap_remove_dynamic_region(pa, size);
+		assert(rc == 0);
+
+		if (buf.pos > size)
+			rc = EL3_TELEMETRY_E_NO_SPACE;
+	}
+
+	spin_unlock(&el3_telemetry_lock);
+
+	return rc;
+}
+
+/*******************************************************************************
+ * SiP handler of the EL3_TELEMETRY_SNAPSHOT call.
+ ******************************************************************************/
+uint64_t el3_telemetry_smc_handler(uint32_t smc_fid,
+				   uint64_t x1,
+				   uint64_t x2,
+				   uint64_t x3,
+				   uint64_t x4,
+				   void *cookie,
+				   void *handle,
+				   uint64_t flags)
+{
+	size_t snap_size;
+	int rc;
+
+	if ((smc_fid != EL3_TELEMETRY_SNAPSHOT) || is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	rc = el3_telemetry_snapshot(x1, x2, &snap_size);
+	SMC_RET2(handle, rc, snap_size);
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cpu_data.h>
+#include <el3_timer.h>
+#include <interrupt_mgmt.h>
+#include <platform_def.h>
+
+/*
+ * Maximum number of timers which can be armed at the same time on a CPU. A
+ * platform may raise it by defining PLAT_EL3_TIMER_MAX in its platform_def.h.
+ */
+#ifdef PLAT_EL3_TIMER_MAX
+#define EL3_TIMER_MAX		PLAT_EL3_TIMER_MAX
+#else
+#define EL3_TIMER_MAX		8
+#endif
+
+/*******************************************************************************
+ * Per-cpu min-heap of the armed timers, ordered by deadline. The timer with the
+ * earliest deadline is at index 0, and the deadline of the timer at index 'i'
+ * is not earlier than the one of its parent at index (i - 1) / 2. It is only
+ * accessed by its own CPU, with the interrupts masked at EL3.
+ ******************************************************************************/
+typedef struct el3_timer_heap {
+	unsigned int count;
+	el3_timer_t *timers[EL3_TIMER_MAX];
+} el3_timer_heap_t;
+
+static DEFINE_PERCPU(el3_timer_heap_t, el3_timer_heap);
+
+static void heap_set(el3_timer_heap_t *heap, unsigned int i,
+		     el3_timer_t *timer)
+{
+	heap->timers[i] = timer;
+	timer->index = i;
+}
+
+static void heap_sift_up(el3_timer_heap_t *heap, unsigned int i)
+{
+	el3_timer_t *timer = heap->timers[i];
+	unsigned int parent;
+
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (heap->timers[parent]->deadline <= timer->deadline)
+			break;
+
+		heap_set(heap, i, heap->timers[parent]);
+		i = parent;
+	}
+
+	heap_set(heap, i, timer);
+}
+
+static void heap_sift_down(el3_timer_heap_t *heap, unsigned int i)
+{
+	el3_timer_t *timer = heap->timers[i];
+	unsigned int child;
+
+	for (child = 2 * i + 1; child < heap->count; child = 2 * i + 1) {
+		if ((child + 1 < heap->count) &&
+		    (heap->timers[child + 1]->deadline <
+		     heap->timers[child]->deadline))
+			child++;
+
+		if (timer->deadline <= heap->timers[child]->deadline)
+			break;
+
+		heap_set(heap, i, heap->timers[child]);
+		i = child;
+	}
+
+	heap_set(heap, i, timer);
+}
+
+static void heap_remove(el3_timer_heap_t *heap, el3_timer_t *timer)
+{
+	unsigned int i = timer->index;
+	el3_timer_t *last;
+
+	assert(i < heap->count && heap->timers[i] == timer);
+
+	timer->index = EL3_TIMER_IDLE;
+	heap->count--;
+	if (i == heap->count)
+		return;
+
+	/* Move the last timer into the hole and restore the heap order */
+	last = heap->timers[heap->count];
+	heap_set(heap, i, last);
+	heap_sift_up(heap, i);
+	heap_sift_down(heap, last->index);
+}
+
+/*******************************************************************************
+ * This function programs the secure physical timer of the calling CPU with the
+ * earliest deadline of its heap, or disables it if no timer is armed.
+ ******************************************************************************/
+static void el3_timer_program(el3_timer_heap_t *heap)
+{
+	uint32_t ctl = 0;
+
+	if (heap->count) {
+		write_cntps_cval_el1(heap->timers[0]->deadline);
+		set_cntp_ctl_enable(ctl);
+	}
+
+	write_cntps_ctl_el1(ctl);
+}
+
+/*******************************************************************************
+ * Handler of the secure physical timer interrupt. The timers which have expired
+ * are removed from the heap before any handler is called, so that a timer armed
+ * again by its handler with a deadline which has already passed is handled on
+ * the next interrupt rather than in a loop here.
+ ******************************************************************************/
+static uint64_t el3_timer_handler(uint32_t id,
+				  uint32_t flags,
+				  void *handle,
+				  void *cookie)
+{
+	el3_timer_heap_t *heap = this_cpu_ptr(el3_timer_heap);
+	el3_timer_t *expired[EL3_TIMER_MAX];
+	uint64_t now = read_cntpct_el0();
+	unsigned int i, num_expired = 0;
+
+	while (heap->count && (heap->timers[0]->deadline <= now)) {
+		expired[num_expired++] = heap->timers[0];
+		heap_remove(heap, heap->timers[0]);
+	}
+
+	for (i = 0; i < num_expired; i++)
+		expired[i]->handler(expired[i], handle);
+
+	/* This also deasserts the interrupt before it is ended */
+	el3_timer_program(heap);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * This function registers the handler of the secure physical timer interrupt
+ * 'id' at EL3. It is called once by the primary CPU during cold boot, and
+ * returns the error code of register_interrupt_handler().
+ ******************************************************************************/
+int32_t el3_timer_setup(uint32_t id)
+{
+	uint32_t flags = 0;
+
+	/* The timer may have been left running by an earlier boot stage */
+	write_cntps_ctl_el1(0);
+
+	/* Take the interrupt at EL3 from both security states */
+	set_interrupt_rm_flag(flags, SECURE);
+	set_interrupt_rm_flag(flags, NON_SECURE);
+
+	return register_interrupt_handler(id, el3_timer_handler, flags);
+}
+
+/*******************************************************************************
+ * This function arms 'timer' on the calling CPU to expire when the system
+ * counter reaches 'deadline'. A timer which is already armed is moved to the
+ * new deadline. It returns -ENOMEM if EL3_TIMER_MAX timers are already armed on
+ * the CPU.
+ ******************************************************************************/
+int el3_timer_arm(el3_timer_t *timer, uint64_t deadline)
+{
+	el3_timer_heap_t *heap = this_cpu_ptr(el3_timer_heap);
+	unsigned int i;
+
+	assert(timer->handler);
+
+	if (el3_timer_is_armed(timer)) {
+		i = timer->index;
+		timer->deadline = deadline;
+		heap_sift_up(heap, i);
+		heap_sift_down(heap, timer->index);
+	} else {
+		if (heap->count == EL3_TIMER_MAX)
+			return -ENOMEM;
+
+		timer->deadline = deadline;
+		heap_set(heap, heap->count++, timer);
+		heap_sift_up(heap, timer->index);
+	}
+
+	el3_timer_program(heap);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * This function cancels 'timer' if it is armed. It must be called on the CPU
+ * the timer has been armed on.
+ ******************************************************************************/
+void el3_timer_cancel(el3_timer_t *timer)
+{
+	el3_timer_heap_t *heap = this_cpu_ptr(el3_timer_heap);
+
+	if (!el3_timer_is_armed(timer))
+		return;
+
+	heap_remove(heap, timer);
+	el3_timer_program(heap);
+}
+
+/*******************************************************************************
+ * This function programs the secure physical timer again when the calling CPU
+ * powers up, as its state is lost when the CPU is powered down.
+ ******************************************************************************/
+void el3_timer_restore(void)
+{
+	el3_timer_program(this_cpu_ptr(el3_timer_heap));
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <cpu_data.h>
+#include <debug.h>
+#include <hang_detect.h>
+#include <platform_def.h>
+#if ENABLE_PSCI_TRACE
+#include <psci_trace.h>
+#endif
+
+/*
+ * Progress count of each CPU at the previous check, and whether the CPU was
+ * found hung by it. They are only accessed by el3_hang_check() and
+ * el3_hang_report(), which must not be called concurrently.
+ */
+static uint64_t el3_hang_last_count[PLATFORM_CORE_COUNT];
+static uint8_t el3_hang_cpus[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * This function compares the progress record of each CPU with the one seen by
+ * the previous call. It returns the number of CPUs which were executing in EL3
+ * at the previous call and have not recorded any progress point since then.
+ ******************************************************************************/
+unsigned int el3_hang_check(void)
+{
+	const el3_progress_t *progress;
+	unsigned int i, hung = 0;
+	uint64_t count;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		progress = &get_cpu_data_by_index(i, el3_progress);
+		count = progress->count;
+
+		el3_hang_cpus[i] = (count == el3_hang_last_count[i]) &&
+				   (progress->point != EL3_PROGRESS_IDLE);
+		hung += el3_hang_cpus[i];
+
+		el3_hang_last_count[i] = count;
+	}
+
+	return hung;
+}
+
+#if ENABLE_PSCI_TRACE
+/*******************************************************************************
+ * Print the PSCI events still present in the trace ring of the CPU with linear
+ * index 'cpu_idx', oldest first.
+ ******************************************************************************/
+static void el3_hang_print_trace(unsigned int cpu_idx, uint64_t now)
+{
+	psci_trace_entry_t entry;
+	uint64_t seq, next_seq;
+
+	psci_trace_read(cpu_idx, 0, &entry, &next_seq);
+	seq = (next_seq > PSCI_TRACE_ENTRIES) ?
+		next_seq - PSCI_TRACE_ENTRIES : 0;
+
+	for (; seq < next_seq; seq++) {
+		if (psci_trace_read(cpu_idx, seq, &entry, &next_seq))
+			continue;
+
+		tf_printf("    PSCI event %u (0x%x) %lu ticks ago\n",
+			  entry.event, entry.arg, now - entry.timestamp);
+	}
+}
+#endif
+
+/*******************************************************************************
+ * This function prints the progress record of each CPU and, for the CPUs found
+ * hung by the last call to el3_hang_check(), their recent PSCI events. The age
+ * of the records is given in system counter ticks.
+ ******************************************************************************/
+void el3_hang_report(void)
+{
+	const el3_progress_t *progress;
+	uint64_t now = read_cntpct_el0();
+	unsigned int i;
+
+	ERROR("EL3 hang detected, progress of each CPU:\n");
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		progress = &get_cpu_data_by_index(i, el3_progress);
+
+		tf_printf("  CPU %u%s: point %u (0x%x) %lu ticks ago, "
+			  "count %lu\n", i, el3_hang_cpus[i] ? " HUNG" : "",
+			  progress->point, progress->arg,
+			  now - progress->timestamp, progress->count);
+
+#if ENABLE_PSCI_TRACE
+		if (el3_hang_cpus[i])
+			el3_hang_print_trace(i, now);
+#endif
+	}
+}
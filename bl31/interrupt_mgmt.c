@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -32,10 +32,37 @@
 #include <bl_common.h>
 #include <context_mgmt.h>
 #include <errno.h>
+#if GICV3_EL3_INTR_FASTPATH
+#include <gicv3.h>
+#endif
 #include <interrupt_mgmt.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <stdio.h>
 
+/*
+ * Maximum number of EL3 interrupts which can be given a handler of their own
+ * through register_interrupt_handler(). A platform may raise it by defining
+ * PLAT_MAX_INTR_ID_HANDLERS in its platform_def.h.
+ */
+#ifdef PLAT_MAX_INTR_ID_HANDLERS
+#define MAX_INTR_ID_HANDLERS	PLAT_MAX_INTR_ID_HANDLERS
+#else
+#define MAX_INTR_ID_HANDLERS	8
+#endif
+
+/*
+ * EL3 interrupts are acknowledged and ended through the GICv3 system registers
+ * directly when GICV3_EL3_INTR_FASTPATH is set.
+ */
+#if GICV3_EL3_INTR_FASTPATH
+#define el3_intr_acknowledge()		(gicv3_acknowledge_interrupt())
+#define el3_intr_end(id)		gicv3_end_of_interrupt(id)
+#else
+#define el3_intr_acknowledge()		plat_ic_acknowledge_interrupt()
+#define el3_intr_end(id)		plat_ic_end_of_interrupt(id)
+#endif
+
 /*******************************************************************************
  * Local structure and corresponding array to keep track of the state of the
  * registered interrupt handlers for each interrupt type.
@@ -57,15 +84,41 @@
  *                 value of the SCR_EL3.IRQ or FIQ bit for each security state.
  *                 There are two instances of this field corresponding to the
  *                 two security states.
+ *
+ * 'scr_el3_mask[2]'    : SCR_EL3.IRQ or FIQ bit used by this interrupt type in
+ *                        each security state.
+ *
+ * 'scr_el3_default[2]' : Value of that bit with the default routing model,
+ *                        used while the routing model is disabled locally.
+ *
+ * The SCR_EL3 values are worked out when the routing model is set, so that
+ * enabling or disabling it on the local core, which dispatchers do on every
+ * entry into the Secure Payload, only merges them into the cpu context.
  ******************************************************************************/
 typedef struct intr_type_desc {
 	interrupt_type_handler_t handler;
 	uint32_t flags;
 	uint32_t scr_el3[2];
+	uint32_t scr_el3_mask[2];
+	uint32_t scr_el3_default[2];
 } intr_type_desc_t;
 
 static intr_type_desc_t intr_type_descs[MAX_INTR_TYPES];
 
+/*******************************************************************************
+ * Local structure and corresponding array to keep track of the handlers
+ * registered for individual EL3 interrupts. The array is only written during
+ * cold boot by register_interrupt_handler() and is searched linearly by
+ * el3_interrupt_dispatcher() when an EL3 interrupt is taken.
+ ******************************************************************************/
+typedef struct intr_id_desc {
+	uint32_t id;
+	interrupt_type_handler_t handler;
+} intr_id_desc_t;
+
+static intr_id_desc_t intr_id_descs[MAX_INTR_ID_HANDLERS];
+static unsigned int intr_id_desc_count;
+
 /*******************************************************************************
  * This function validates the interrupt type.
  ******************************************************************************/
@@ -129,6 +182,10 @@ static void set_scr_el3_from_rm(uint32_t type,
 	flag = get_interrupt_rm_flag(interrupt_type_flags, security_state);
 	bit_pos = plat_interrupt_type_to_line(type, security_state);
 	intr_type_descs[type].scr_el3[security_state] = flag << bit_pos;
+	intr_type_descs[type].scr_el3_mask[security_state] = 1 << bit_pos;
+	intr_type_descs[type].scr_el3_default[security_state] =
+		get_interrupt_rm_flag(INTR_DEFAULT_RM, security_state) <<
+		bit_pos;
 
 	/* Update scr_el3 only if there is a context available. If not, it
 	 * will be updated later during context initialization which will obtain
@@ -171,14 +228,13 @@ int32_t set_routing_model(uint32_t type, uint32_t flags)
  *****************************************************************************/
 int disable_intr_rm_local(uint32_t type, uint32_t security_state)
 {
-	uint32_t bit_pos, flag;
+	const intr_type_desc_t *desc = &intr_type_descs[type];
 
-	assert(intr_type_descs[type].handler);
+	assert(desc->handler);
 
-	flag = get_interrupt_rm_flag(INTR_DEFAULT_RM, security_state);
-
-	bit_pos = plat_interrupt_type_to_line(type, security_state);
-	cm_write_scr_el3_bit(security_state, bit_pos, flag);
+	cm_write_scr_el3_bits(security_state,
+			      desc->scr_el3_mask[security_state],
+			      desc->scr_el3_default[security_state]);
 
 	return 0;
 }
@@ -189,15 +245,13 @@ int disable_intr_rm_local(uint32_t type, uint32_t security_state)
  *****************************************************************************/
 int enable_intr_rm_local(uint32_t type, uint32_t security_state)
 {
-	uint32_t bit_pos, flag;
+	const intr_type_desc_t *desc = &intr_type_descs[type];
 
-	assert(intr_type_descs[type].handler);
+	assert(desc->handler);
 
-	flag = get_interrupt_rm_flag(intr_type_descs[type].flags,
-				security_state);
-
-	bit_pos = plat_interrupt_type_to_line(type, security_state);
-	cm_write_scr_el3_bit(security_state, bit_pos, flag);
+	cm_write_scr_el3_bits(security_state,
+			      desc->scr_el3_mask[security_state],
+			      desc->scr_el3[security_state]);
 
 	return 0;
 }
@@ -248,3 +302,111 @@ interrupt_type_handler_t get_interrupt_type_handler(uint32_t type)
 	return intr_type_descs[type].handler;
 }
 
+
+/*******************************************************************************
+ * This function is the handler for the EL3 interrupt type once a handler has
+ * been registered for an individual EL3 interrupt. It acknowledges the highest
+ * priority pending interrupt, invokes the handler registered for its id with
+ * the id filled in and then signals the end of the interrupt. An interrupt
+ * without a registered handler (including a spurious one) is simply
+ * acknowledged and completed. It always returns to the interrupted context.
+ ******************************************************************************/
+static uint64_t el3_interrupt_dispatcher(uint32_t id,
+					 uint32_t flags,
+					 void *handle,
+					 void *cookie)
+{
+	unsigned int i;
+
+	id = el3_intr_acknowledge();
+
+	for (i = 0; i < intr_id_desc_count; i++) {
+		if (intr_id_descs[i].id == id) {
+			intr_id_descs[i].handler(id, flags, handle, cookie);
+			break;
+		}
+	}
+
+	el3_intr_end(id);
+
+	return (uint64_t) handle;
+}
+
+/*******************************************************************************
+ * This function registers a handler for the EL3 interrupt with the specified
+ * 'id'. The first registration installs el3_interrupt_dispatcher() as the
+ * handler for the EL3 interrupt type with the routing model specified in
+ * 'flags'. Subsequent registrations must specify the same routing model. It
+ * returns -EALREADY if a handler for this 'id' or a handler for the whole EL3
+ * interrupt type has already been registered and -ENOMEM if there is no room
+ * left for another handler.
+ ******************************************************************************/
+int32_t register_interrupt_handler(uint32_t id,
+				   interrupt_type_handler_t handler,
+				   uint32_t flags)
+{
+	unsigned int i;
+	int32_t rc;
+
+	/* Validate the 'handler' parameter */
+	if (!handler)
+		return -EINVAL;
+
+	/* Check if a handler has already been registered for this 'id' */
+	for (i = 0; i < intr_id_desc_count; i++) {
+		if (intr_id_descs[i].id == id)
+			return -EALREADY;
+	}
+
+	if (intr_id_desc_count == MAX_INTR_ID_HANDLERS)
+		return -ENOMEM;
+
+	if (intr_type_descs[INTR_TYPE_EL3].handler !=
+					el3_interrupt_dispatcher) {
+		rc = register_interrupt_type_handler(INTR_TYPE_EL3,
+						     el3_interrupt_dispatcher,
+						     flags);
+		if (rc)
+			return rc;
+	} else if (flags != intr_type_descs[INTR_TYPE_EL3].flags) {
+		return -EINVAL;
+	}
+
+	intr_id_descs[intr_id_desc_count].id = id;
+	intr_id_descs[intr_id_desc_count].handler = handler;
+	intr_id_desc_count++;
+
+	return 0;
+}
+
+#if EL3_NS_PREEMPT
+/*******************************************************************************
+ * This function lets the interrupts of higher priority than 'pri_mask' preempt
+ * the long-running EL3 work which follows, until el3_preempt_disable(). The
+ * work must poll el3_preempt_pending() at points where it can stop, and then
+ * return SMC_PREEMPTED (along with its progress) to the normal world caller.
+ * The caller takes the interrupt according to the routing model of the
+ * Non-secure state and issues the SMC again to resume the work.
+ *
+ * It must be called while handling an SMC from the normal world, before any
+ * world switch. If the caller has masked IRQs, it would not take a Non-secure
+ * interrupt on return, so the work is not preempted at all. It returns the
+ * priority mask to restore with el3_preempt_disable().
+ ******************************************************************************/
+uint32_t el3_preempt_enable(uint32_t pri_mask)
+{
+	if (read_spsr_el3() & (DAIF_IRQ_BIT << SPSR_DAIF_SHIFT))
+		pri_mask = 0;
+
+	return plat_ic_set_priority_mask(pri_mask);
+}
+
+/*******************************************************************************
+ * This function restores the priority mask returned by el3_preempt_enable()
+ * at the end of the preemptible work, whether it has been preempted or not.
+ ******************************************************************************/
+void el3_preempt_disable(uint32_t prev_pri_mask)
+{
+	plat_ic_set_priority_mask(prev_pri_mask);
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -47,10 +47,62 @@
 uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 static rt_svc_desc_t *rt_svc_descs;
 
+/*******************************************************************************
+ * The 'rt_svc_funcs_table' array is a second-level table of function handlers
+ * exported by services through the 'rt_svc_funcs' linker section. When an SMC
+ * arrives, its function id is first looked up in this table using
+ * 'rt_svc_func_hash()'. If the entry holds the same function id, its handler is
+ * called directly instead of the handler of the owning runtime service.
+ ******************************************************************************/
+#define RT_SVC_FUNCS_START	((uint64_t) (&__RT_SVC_FUNCS_START__))
+#define RT_SVC_FUNCS_END	((uint64_t) (&__RT_SVC_FUNCS_END__))
+rt_svc_func_desc_t rt_svc_funcs_table[MAX_RT_SVC_FUNCS];
+
+/*******************************************************************************
+ * This function fills the 'rt_svc_funcs_table' with the function descriptors
+ * exported by the runtime services. A function is only added if the runtime
+ * service owning its function id has been initialised. A function whose table
+ * entry is already taken is left to the handler of its runtime service.
+ ******************************************************************************/
+static void __init init_rt_svc_funcs(void)
+{
+	rt_svc_func_desc_t *funcs, *entry;
+	uint64_t funcs_num;
+	uint32_t index, fid;
+
+	for (index = 0; index < MAX_RT_SVC_FUNCS; index++) {
+		rt_svc_funcs_table[index].smc_fid = SMC_UNK;
+		rt_svc_funcs_table[index].handle = NULL;
+	}
+
+	funcs_num = RT_SVC_FUNCS_END - RT_SVC_FUNCS_START;
+	funcs_num /= sizeof(rt_svc_func_desc_t);
+	funcs = (rt_svc_func_desc_t *) RT_SVC_FUNCS_START;
+
+	for (index = 0; index < funcs_num; index++) {
+		fid = funcs[index].smc_fid;
+
+		if ((funcs[index].handle == NULL) ||
+		    (rt_svc_descs_indices[get_unique_oen(
+				fid >> FUNCID_OEN_SHIFT,
+				fid >> FUNCID_TYPE_SHIFT)] >= MAX_RT_SVCS))
+			continue;
+
+		entry = &rt_svc_funcs_table[rt_svc_func_hash(fid)];
+		if (entry->handle != NULL) {
+			WARN("SMC function 0x%x not added to the fast path\n",
+			     fid);
+			continue;
+		}
+
+		*entry = funcs[index];
+	}
+}
+
 /*******************************************************************************
  * Simple routine to sanity check a runtime service descriptor before using it
  ******************************************************************************/
-static int32_t validate_rt_svc_desc(rt_svc_desc_t *desc)
+static int32_t __init validate_rt_svc_desc(rt_svc_desc_t *desc)
 {
 	if (desc == NULL)
 		return -EINVAL;
@@ -78,7 +130,7 @@ static int32_t validate_rt_svc_desc(rt_svc_desc_t *desc)
  * The unique oen is used as an index into the 'rt_svc_descs_indices' array.
  * The index of the runtime service descriptor is stored at this index.
  ******************************************************************************/
-void runtime_svc_init(void)
+void __init runtime_svc_init(void)
 {
 	int32_t rc = 0;
 	uint32_t index, start_idx, end_idx;
@@ -140,6 +192,8 @@ void runtime_svc_init(void)
 			rt_svc_descs_indices[start_idx] = index;
 	}
 
+	init_rt_svc_funcs();
+
 	return;
 error:
 	panic();
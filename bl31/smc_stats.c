@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <cpu_data.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <smc_stats.h>
+#include <string.h>
+
+/* The SiP interface returns the histogram buckets in four registers */
+CASSERT(SMC_STATS_HIST_BUCKETS == 8, assert_smc_stats_hist_buckets_mismatch);
+
+/*******************************************************************************
+ * Return the histogram bucket of a sample lasting 'ticks' counter ticks.
+ ******************************************************************************/
+static unsigned int smc_stats_bucket(uint64_t ticks)
+{
+	unsigned int bucket;
+
+	if (ticks == 0)
+		return 0;
+
+	bucket = (63 - __builtin_clzll(ticks)) >> 1;
+	if (bucket >= SMC_STATS_HIST_BUCKETS)
+		bucket = SMC_STATS_HIST_BUCKETS - 1;
+
+	return bucket;
+}
+
+#if SMC_STATS_PMU
+/*******************************************************************************
+ * Program the PMU of this CPU to count cycles with the cycle counter and
+ * 'event' with event counter 0, in EL3 only, and reset and start both counters.
+ ******************************************************************************/
+static void smc_stats_pmu_enable(unsigned int event)
+{
+	smc_stats_t *stats = &get_cpu_data(smc_stats);
+	uint32_t filter, enable;
+
+	/*
+	 * Exclude EL0 and EL1 in both security states and Non-secure EL2, and
+	 * allow counting in Secure state for EL3.
+	 */
+	filter = PMEVTYPER_P_BIT | PMEVTYPER_U_BIT | PMEVTYPER_NSK_BIT |
+		 PMEVTYPER_NSU_BIT | PMEVTYPER_M_BIT;
+	enable = PMCNTENSET_C_BIT | 1;
+
+	write_mdcr_el3(read_mdcr_el3() | MDCR_SPME_BIT);
+
+	write_pmcr_el0(read_pmcr_el0() & ~PMCR_EL0_E_BIT);
+	isb();
+	write_pmcntenclr_el0(0xffffffff);
+	write_pmccfiltr_el0(filter);
+	write_pmevtyper0_el0(filter | event);
+	write_pmcntenset_el0(enable);
+	write_pmcr_el0(read_pmcr_el0() | PMCR_EL0_LC_BIT | PMCR_EL0_C_BIT |
+		       PMCR_EL0_P_BIT | PMCR_EL0_E_BIT);
+	isb();
+
+	/* The SMC being handled started with the counters reset */
+	stats->start_cycles = 0;
+	stats->start_events = 0;
+	stats->pmu_event = event;
+	stats->pmu_active = 1;
+}
+
+/*******************************************************************************
+ * Stop the PMU counters of this CPU and give the PMU back to the normal world.
+ ******************************************************************************/
+static void smc_stats_pmu_disable(void)
+{
+	set_cpu_data(smc_stats.pmu_active, 0);
+
+	write_pmcr_el0(read_pmcr_el0() & ~PMCR_EL0_E_BIT);
+	write_pmcntenclr_el0(0xffffffff);
+	write_mdcr_el3(read_mdcr_el3() & ~MDCR_SPME_BIT);
+	isb();
+}
+#endif
+
+/*******************************************************************************
+ * Called by el3_exit() on the runtime stack. Accounts the time elapsed since
+ * the SMC or EL3 interrupt being handled on this CPU has been dispatched.
+ ******************************************************************************/
+void smc_stats_exit(void)
+{
+	smc_stats_t *stats = &get_cpu_data(smc_stats);
+	smc_stats_slot_t *slot = NULL;
+	uint64_t ticks;
+#if SMC_STATS_PMU
+	uint64_t cycles = 0, events = 0;
+#endif
+	unsigned int i;
+
+	if (stats->start_ts == 0)
+		return;
+
+	ticks = read_cntpct_el0() - stats->start_ts;
+	stats->start_ts = 0;
+
+#if SMC_STATS_PMU
+	if (stats->pmu_active) {
+		cycles = read_pmccntr_el0() - stats->start_cycles;
+		events = (uint32_t)(read_pmevcntr0_el0() - stats->start_events);
+	}
+#endif
+
+	/* Find the slot of this function ID or the first unused slot */
+	for (i = 0; i < SMC_STATS_SLOTS; i++) {
+		if ((stats->slot[i].count == 0) ||
+		    (stats->slot[i].smc_fid == stats->cur_fid)) {
+			slot = &stats->slot[i];
+			break;
+		}
+	}
+
+	if (slot == NULL) {
+		stats->dropped++;
+		return;
+	}
+
+	if (ticks > UINT32_MAX)
+		ticks = UINT32_MAX;
+
+	if (slot->count == 0) {
+		slot->smc_fid = stats->cur_fid;
+		slot->min = ticks;
+		slot->max = ticks;
+	} else if (ticks < slot->min) {
+		slot->min = ticks;
+	} else if (ticks > slot->max) {
+		slot->max = ticks;
+	}
+
+	slot->count++;
+	slot->total += ticks;
+	slot->hist[smc_stats_bucket(ticks)]++;
+#if SMC_STATS_PMU
+	slot->cycles += cycles;
+	slot->events += events;
+#endif
+}
+
+/*******************************************************************************
+ * Forget about the SMC being handled on this CPU. Used when the CPU has been
+ * powered down while handling it, e.g. for PSCI CPU_SUSPEND. The PMU has
+ * lost its programming as well, so it is programmed again if it belongs to EL3.
+ ******************************************************************************/
+void smc_stats_discard(void)
+{
+	set_cpu_data(smc_stats.start_ts, 0);
+
+#if SMC_STATS_PMU
+	if (get_cpu_data(smc_stats.pmu_active))
+		smc_stats_pmu_enable(get_cpu_data(smc_stats.pmu_event));
+#endif
+}
+
+/*******************************************************************************
+ * Handler of the SiP calls giving access to the statistics. See smc_stats.h
+ * for their description.
+ ******************************************************************************/
+uint64_t smc_stats_smc_handler(uint32_t smc_fid,
+			       uint64_t x1,
+			       uint64_t x2,
+			       uint64_t x3,
+			       uint64_t x4,
+			       void *cookie,
+			       void *handle,
+			       uint64_t flags)
+{
+	smc_stats_slot_t *slot;
+	smc_stats_t *stats;
+	unsigned int i;
+
+	if (smc_fid == SMC_STATS_RESET) {
+		for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+			stats = &get_cpu_data_by_index(i, smc_stats);
+			memset(stats->slot, 0, sizeof(stats->slot));
+			stats->dropped = 0;
+		}
+		SMC_RET1(handle, 0);
+	}
+
+#if SMC_STATS_PMU
+	if (smc_fid == SMC_STATS_PMU_START) {
+		if ((x1 > PMEVTYPER_EVTCOUNT_MASK) ||
+		    (((read_pmcr_el0() >> PMCR_EL0_N_SHIFT) &
+		      PMCR_EL0_N_MASK) == 0))
+			SMC_RET1(handle, SMC_STATS_E_INVALID);
+
+		smc_stats_pmu_enable(x1);
+		SMC_RET1(handle, 0);
+	}
+
+	if (smc_fid == SMC_STATS_PMU_STOP) {
+		smc_stats_pmu_disable();
+		SMC_RET1(handle, 0);
+	}
+
+	if ((smc_fid != SMC_STATS_GET) && (smc_fid != SMC_STATS_GET_HIST) &&
+	    (smc_fid != SMC_STATS_GET_PMU))
+		SMC_RET1(handle, SMC_UNK);
+#else
+	if ((smc_fid != SMC_STATS_GET) && (smc_fid != SMC_STATS_GET_HIST))
+		SMC_RET1(handle, SMC_UNK);
+#endif
+
+	if ((x1 >= PLATFORM_CORE_COUNT) || (x2 >= SMC_STATS_SLOTS))
+		SMC_RET1(handle, SMC_STATS_E_INVALID);
+
+	slot = &get_cpu_data_by_index(x1, smc_stats.slot[x2]);
+
+	if (smc_fid == SMC_STATS_GET) {
+		SMC_RET4(handle, slot->count ? slot->smc_fid : 0,
+			 slot->count, slot->total,
+			 ((uint64_t)slot->max << 32) | slot->min);
+	}
+
+#if SMC_STATS_PMU
+	if (smc_fid == SMC_STATS_GET_PMU) {
+		SMC_RET4(handle, slot->count ? slot->smc_fid : 0,
+			 slot->count, slot->cycles, slot->events);
+	}
+#endif
+
+	SMC_RET4(handle,
+		 ((uint64_t)slot->hist[1] << 32) | slot->hist[0],
+		 ((uint64_t)slot->hist[3] << 32) | slot->hist[2],
+		 ((uint64_t)slot->hist[5] << 32) | slot->hist[4],
+		 ((uint64_t)slot->hist[7] << 32) | slot->hist[6]);
+}
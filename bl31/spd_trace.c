@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <spd_trace.h>
+#include <spinlock.h>
+#include <xlat_tables.h>
+
+typedef struct spd_trace_cpu {
+	/* Ring registered by the normal world, mapped flat, NULL if none */
+	spd_trace_ring_t *ring;
+	uint64_t size;
+	/* Details of the current entry into the SP, 'entry_ts' is 0 if none */
+	uint64_t entry_ts;
+	uint32_t fid;
+	unsigned int event;
+} __aligned(CACHE_WRITEBACK_GRANULE) spd_trace_cpu_t;
+
+static spd_trace_cpu_t spd_trace_cpus[PLATFORM_CORE_COUNT];
+
+/* Lock serialising the updates of the translation tables */
+static spinlock_t spd_trace_lock;
+
+/*******************************************************************************
+ * Called by the SPD just before it enters the SP on behalf of the normal world
+ * for 'event'.
+ ******************************************************************************/
+void spd_trace_enter(unsigned int event, uint32_t fid)
+{
+	spd_trace_cpu_t *cpu = &spd_trace_cpus[plat_my_core_pos()];
+
+	if (cpu->ring == NULL)
+		return;
+
+	cpu->event = event;
+	cpu->fid = fid;
+	cpu->entry_ts = read_cntpct_el0();
+}
+
+/*******************************************************************************
+ * Called by the SPD just before it returns to the normal world from the SP. It
+ * writes the record of the current entry into the SP to the ring of this cpu.
+ ******************************************************************************/
+void spd_trace_exit(void)
+{
+	unsigned int linear_id = plat_my_core_pos();
+	spd_trace_cpu_t *cpu = &spd_trace_cpus[linear_id];
+	spd_trace_ring_t *ring = cpu->ring;
+	spd_trace_rec_t *rec;
+	uint64_t seq;
+
+	if ((ring == NULL) || (cpu->entry_ts == 0))
+		return;
+
+	/* The normal world may have changed the header, do not trust it */
+	seq = ring->next_seq;
+	rec = (spd_trace_rec_t *)(ring + 1);
+	rec += seq % ((cpu->size - sizeof(*ring)) / sizeof(*rec));
+
+	rec->seq = SPD_TRACE_SEQ_BUSY;
+	dmbst();
+
+	rec->entry_ts = cpu->entry_ts;
+	rec->exit_ts = read_cntpct_el0();
+	rec->fid = cpu->fid;
+	rec->event = cpu->event;
+	rec->cpu = linear_id;
+	dmbst();
+
+	rec->seq = seq;
+	ring->next_seq = seq + 1;
+
+	cpu->entry_ts = 0;
+}
+
+/*******************************************************************************
+ * Register the ring at 'pa' of 'size' bytes for 'linear_id', replacing the
+ * ring registered previously if any. A 'pa' of 0 only unregisters the latter.
+ * The ring is mapped as Non-secure memory so the normal world cannot make
+ * EL3 write to secure memory through it.
+ ******************************************************************************/
+static int spd_trace_register(unsigned int linear_id, uint64_t pa,
+			      uint64_t size)
+{
+	spd_trace_cpu_t *cpu = &spd_trace_cpus[linear_id];
+	int rc = 0;
+
+	if (pa && ((pa & PAGE_SIZE_MASK) || (size & PAGE_SIZE_MASK) ||
+		   (size == 0) || (pa + size < pa)))
+		return SPD_TRACE_E_INVALID;
+
+	spin_lock(&spd_trace_lock);
+
+	if (cpu->ring) {
+		rc = mmap_remove_dynamic_region((uintptr_t)cpu->ring,
+						cpu->size);
+		assert(rc == 0);
+		cpu->ring = NULL;
+		cpu->size = 0;
+	}
+
+	if (pa) {
+		rc = mmap_add_dynamic_region(pa, pa, size,
+					     MT_MEMORY | MT_RW | MT_NS);
+		if (rc == 0) {
+			cpu->ring = (spd_trace_ring_t *)pa;
+			cpu->size = size;
+			cpu->ring->next_seq = 0;
+			cpu->ring->num_recs = (size - sizeof(*cpu->ring)) /
+					      sizeof(spd_trace_rec_t);
+		}
+	}
+
+	spin_unlock(&spd_trace_lock);
+
+	cpu->entry_ts = 0;
+
+	return rc ? SPD_TRACE_E_INVALID : 0;
+}
+
+/*******************************************************************************
+ * SiP handler of the SPD_TRACE_REGISTER call.
+ ******************************************************************************/
+uint64_t spd_trace_smc_handler(uint32_t smc_fid,
+			       uint64_t x1,
+			       uint64_t x2,
+			       uint64_t x3,
+			       uint64_t x4,
+			       void *cookie,
+			       void *handle,
+			       uint64_t flags)
+{
+	if ((smc_fid != SPD_TRACE_REGISTER) || is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	SMC_RET1(handle, spd_trace_register(plat_my_core_pos(), x1, x2));
+}
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
 #
 # Redistribution and use in source and binary forms, with or without
 # modification, are permitted provided that the following conditions are met:
@@ -49,6 +49,36 @@ TSP_INIT_ASYNC         :=      0
 $(eval $(call assert_boolean,TSP_INIT_ASYNC))
 $(eval $(call add_define,TSP_INIT_ASYNC))
 
+# This flag makes the TSP and the TSPD measure the latency of the S-EL1
+# interrupts they handle and the TSPD expose it through a fast SMC.
+TSP_INTR_LATENCY_BENCH	:=	0
+
+$(eval $(call assert_boolean,TSP_INTR_LATENCY_BENCH))
+$(eval $(call add_define,TSP_INTR_LATENCY_BENCH))
+
+# This flag adds a work stealing scheduler to the TSP, which runs the items
+# queued by a standard SMC on any idle cpu.
+TSP_WORK_STEALING	:=	0
+
+$(eval $(call assert_boolean,TSP_WORK_STEALING))
+$(eval $(call add_define,TSP_WORK_STEALING))
+
+ifeq (${TSP_WORK_STEALING},1)
+BL32_SOURCES		+=	bl32/tsp/tsp_work.c
+endif
+
+# This flag makes the TSP measure the cost of the calls into the secure
+# monitor on each cpu it is initialised on, and on request of the normal
+# world.
+TSP_BENCH		:=	0
+
+$(eval $(call assert_boolean,TSP_BENCH))
+$(eval $(call add_define,TSP_BENCH))
+
+ifeq (${TSP_BENCH},1)
+BL32_SOURCES		+=	bl32/tsp/tsp_bench.c
+endif
+
 # Include the platform-specific TSP Makefile
 # If no platform-specific TSP Makefile exists, it means TSP is not supported
 # on this platform.
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <bl_common.h>
+#include <debug.h>
+#include <platform.h>
+#include <spinlock.h>
+#include <stdint.h>
+#include <tsp.h>
+#include "tsp_private.h"
+
+/* Number of calls of each kind made on each cpu the TSP is initialised on */
+#define TSP_BENCH_REPORT_CALLS	1000
+
+/*******************************************************************************
+ * This function makes 'calls' calls of SMC function ID 'fid' to the secure
+ * monitor and returns the number of system counter ticks they took, or 0 if
+ * 'fid' is not one of the benchmark function IDs.
+ ******************************************************************************/
+uint64_t tsp_bench_run(uint64_t fid, uint64_t calls)
+{
+	uint64_t start, i;
+
+	if (fid != TSP_BENCH_NOP && fid != TSP_BENCH_SWITCH)
+		return 0;
+
+	start = read_cntpct_el0();
+
+	for (i = 0; i < calls; i++)
+		tsp_bench_smc(fid);
+
+	return read_cntpct_el0() - start;
+}
+
+/*******************************************************************************
+ * This function measures the cost of each kind of call into the secure monitor
+ * on this cpu and prints it, in ticks of the system counter and in
+ * nanoseconds.
+ ******************************************************************************/
+void tsp_bench_report(void)
+{
+	static const struct {
+		uint64_t fid;
+		const char *name;
+	} tests[] = {
+		{ TSP_BENCH_NOP, "nop" },
+		{ TSP_BENCH_SWITCH, "world switch" },
+	};
+	uint64_t freq = read_cntfrq_el0();
+	uint64_t ticks;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(tests); i++) {
+		ticks = tsp_bench_run(tests[i].fid, TSP_BENCH_REPORT_CALLS);
+
+		spin_lock(&console_lock);
+		NOTICE("TSP: cpu 0x%lx bench %s: %lu ticks, %lu ns per call\n",
+		       read_mpidr(), tests[i].name,
+		       ticks / TSP_BENCH_REPORT_CALLS,
+		       (ticks * 1000000000 / freq) / TSP_BENCH_REPORT_CALLS);
+		spin_unlock(&console_lock);
+	}
+}
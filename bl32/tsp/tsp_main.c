@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -29,6 +29,7 @@
  */
 
 #include <arch_helpers.h>
+#include <assert.h>
 #include <bl_common.h>
 #include <debug.h>
 #include <platform.h>
@@ -36,6 +37,7 @@
 #include <platform_tsp.h>
 #include <spinlock.h>
 #include <tsp.h>
+#include <xlat_tables.h>
 #include "tsp_private.h"
 
 
@@ -55,6 +57,15 @@ static tsp_args_t tsp_smc_args[PLATFORM_CORE_COUNT];
  ******************************************************************************/
 work_statistics_t tsp_stats[PLATFORM_CORE_COUNT];
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*******************************************************************************
+ * Per cpu address of the mailbox registered by the normal world, which is
+ * mapped flat. The lock serialises the updates of the translation tables.
+ ******************************************************************************/
+static uint64_t tsp_mbox[PLATFORM_CORE_COUNT];
+static spinlock_t tsp_mbox_lock;
+#endif
+
 /*******************************************************************************
  * The BL32 memory footprint starts with an RO sections and ends
  * with the linker symbol __BL32_END__. Use it to find the memory size
@@ -93,6 +104,74 @@ static tsp_args_t *set_smc_args(uint64_t arg0,
 	return pcpu_smc_args;
 }
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*******************************************************************************
+ * This function maps the mailbox at 'pa' for this cpu, replacing the mailbox
+ * registered previously if any. A 'pa' of 0 only unregisters the latter. The
+ * mailbox is mapped as Non-secure memory so the normal world cannot make the
+ * TSP access secure memory through it.
+ ******************************************************************************/
+static uint64_t tsp_mbox_register(uint32_t linear_id, uint64_t pa)
+{
+	int rc = 0;
+
+	spin_lock(&tsp_mbox_lock);
+
+	if (tsp_mbox[linear_id]) {
+		rc = mmap_remove_dynamic_region(tsp_mbox[linear_id],
+						TSP_MBOX_SIZE);
+		assert(rc == 0);
+		tsp_mbox[linear_id] = 0;
+	}
+
+	if (pa) {
+		rc = mmap_add_dynamic_region(pa, pa, TSP_MBOX_SIZE,
+					     MT_MEMORY | MT_RW | MT_NS);
+		if (rc == 0)
+			tsp_mbox[linear_id] = pa;
+	}
+
+	spin_unlock(&tsp_mbox_lock);
+
+	return rc ? TSP_MBOX_ERROR : TSP_MBOX_SUCCESS;
+}
+
+/*******************************************************************************
+ * This function applies the arithmetic operation 'op' in place to the first
+ * 'count' operand pairs of the mailbox of this cpu. The normal world can
+ * change the operands meanwhile, which only affects its own results.
+ ******************************************************************************/
+static uint64_t tsp_mbox_call(uint32_t linear_id, uint64_t op, uint64_t count)
+{
+	uint64_t *pair = (uint64_t *)tsp_mbox[linear_id];
+
+	if (!pair || count > TSP_MBOX_SIZE / (2 * sizeof(uint64_t)))
+		return TSP_MBOX_ERROR;
+
+	if (op != TSP_ADD && op != TSP_SUB && op != TSP_MUL && op != TSP_DIV)
+		return TSP_MBOX_ERROR;
+
+	for (; count; --count, pair += 2) {
+		switch (op) {
+		case TSP_ADD:
+			pair[0] += pair[1];
+			break;
+		case TSP_SUB:
+			pair[0] -= pair[1];
+			break;
+		case TSP_MUL:
+			pair[0] *= pair[1];
+			break;
+		default:
+			pair[0] /= pair[1] ? pair[1] : 1;
+			break;
+		}
+	}
+
+	return TSP_MBOX_SUCCESS;
+}
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
+
 /*******************************************************************************
  * TSP main entry point where it gets the opportunity to initialize its secure
  * state/applications. Once the state is initialized, it must return to the
@@ -128,6 +207,10 @@ uint64_t tsp_main(void)
 	     tsp_stats[linear_id].cpu_on_count);
 	spin_unlock(&console_lock);
 #endif
+
+#if TSP_BENCH
+	tsp_bench_report();
+#endif
 	return (uint64_t) &tsp_vector_table;
 }
 
@@ -158,6 +241,10 @@ tsp_args_t *tsp_cpu_on_main(void)
 		tsp_stats[linear_id].cpu_on_count);
 	spin_unlock(&console_lock);
 #endif
+
+#if TSP_BENCH
+	tsp_bench_report();
+#endif
 	/* Indicate to the SPD that we have completed turned ourselves on */
 	return set_smc_args(TSP_ON_DONE, 0, 0, 0, 0, 0, 0, 0);
 }
@@ -265,6 +352,11 @@ tsp_args_t *tsp_cpu_resume_main(uint64_t max_off_pwrlvl,
 	/* Restore the generic timer context */
 	tsp_generic_timer_restore();
 
+#if TSP_WORK_STEALING
+	/* This cpu has just been idle, help the others with their work */
+	tsp_work_steal(linear_id, TSP_WORK_STEAL_MAX);
+#endif
+
 	/* Update this cpu's statistics */
 	tsp_stats[linear_id].smc_count++;
 	tsp_stats[linear_id].eret_count++;
@@ -379,6 +471,58 @@ tsp_args_t *tsp_smc_handler(uint64_t func,
 		tsp_stats[linear_id].smc_count,
 		tsp_stats[linear_id].eret_count);
 
+	/*
+	 * Mailbox requests find their operands in memory, so they do not need
+	 * to request them from the dispatcher below.
+	 */
+#if PLAT_XLAT_TABLES_DYNAMIC
+	if (TSP_BARE_FID(func) == TSP_MBOX_REGISTER)
+		return set_smc_args(func, tsp_mbox_register(linear_id, arg1),
+				    0, 0, 0, 0, 0, 0);
+
+	if (TSP_BARE_FID(func) == TSP_MBOX_CALL)
+		return set_smc_args(func, tsp_mbox_call(linear_id, arg1, arg2),
+				    0, 0, 0, 0, 0, 0);
+#else
+	if (TSP_BARE_FID(func) == TSP_MBOX_REGISTER ||
+	    TSP_BARE_FID(func) == TSP_MBOX_CALL)
+		return set_smc_args(func, TSP_MBOX_ERROR, 0, 0, 0, 0, 0, 0);
+#endif
+
+#if TSP_WORK_STEALING
+	/*
+	 * Work stealing requests do not have operands to request from the
+	 * dispatcher either.
+	 */
+	if (TSP_BARE_FID(func) == TSP_WORK_PUSH) {
+		results[0] = tsp_work_push(linear_id, arg1, arg2, &results[1]);
+		return set_smc_args(func, 0, results[0], results[1],
+				    0, 0, 0, 0);
+	}
+
+	if (TSP_BARE_FID(func) == TSP_WORK_STEAL)
+		return set_smc_args(func, 0, tsp_work_steal(linear_id, arg1),
+				    0, 0, 0, 0, 0);
+
+	if (TSP_BARE_FID(func) == TSP_WORK_DEPTH)
+		return set_smc_args(func, 0, arg1 < PLATFORM_CORE_COUNT ?
+				    tsp_work_depth(arg1) : 0, 0, 0, 0, 0, 0);
+#endif
+
+#if TSP_BENCH
+	if (TSP_BARE_FID(func) == TSP_BENCH_RUN) {
+		if (arg1 != TSP_BENCH_NOP && arg1 != TSP_BENCH_SWITCH)
+			return set_smc_args(func, TSP_BENCH_ERROR,
+					    0, 0, 0, 0, 0, 0);
+
+		if (arg2 > TSP_BENCH_MAX_CALLS)
+			arg2 = TSP_BENCH_MAX_CALLS;
+
+		return set_smc_args(func, 0, tsp_bench_run(arg1, arg2), arg2,
+				    0, 0, 0, 0);
+	}
+#endif
+
 	/* Render secure services and obtain results here */
 	results[0] = arg1;
 	results[1] = arg2;
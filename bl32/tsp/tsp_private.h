@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -122,6 +122,21 @@ void tsp_generic_timer_restore(void);
 /* S-EL1 interrupt management functions */
 void tsp_update_sync_sel1_intr_stats(uint32_t type, uint64_t elr_el3);
 
+#if TSP_BENCH
+/* Benchmark functions */
+uint64_t tsp_bench_smc(uint64_t fid);
+uint64_t tsp_bench_run(uint64_t fid, uint64_t calls);
+void tsp_bench_report(void);
+#endif
+
+#if TSP_WORK_STEALING
+/* Work stealing scheduler functions */
+uint64_t tsp_work_push(uint32_t linear_id, uint64_t count, uint64_t iterations,
+		       uint64_t *stolen);
+unsigned int tsp_work_steal(uint32_t linear_id, unsigned int max);
+unsigned int tsp_work_depth(uint32_t linear_id);
+#endif
+
 
 /* Data structure to keep track of TSP statistics */
 extern spinlock_t console_lock;
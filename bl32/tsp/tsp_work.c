@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <platform_def.h>
+#include <spinlock.h>
+#include <stdint.h>
+#include <tsp.h>
+#include "tsp_private.h"
+
+/* Number of items a deque can hold, must be a power of 2 */
+#define TSP_WORK_DEQUE_SIZE	64
+
+/*******************************************************************************
+ * Per cpu deque of work items. The owner cpu pushes and pops items at the
+ * bottom while the other cpus steal them from the top, all under the lock.
+ * Each item is the number of busy loop iterations it takes to run it. The
+ * number of items completed by each thief is only written by the latter, so
+ * that the thieves do not have to wait for the lock once they have run them.
+ ******************************************************************************/
+typedef struct tsp_work_deque {
+	spinlock_t lock;
+	unsigned int top;
+	unsigned int bottom;
+	uint64_t items[TSP_WORK_DEQUE_SIZE];
+	volatile unsigned int stolen_done[PLATFORM_CORE_COUNT];
+} __aligned(CACHE_WRITEBACK_GRANULE) tsp_work_deque_t;
+
+static tsp_work_deque_t tsp_work_deques[PLATFORM_CORE_COUNT];
+
+static void tsp_work_run(uint64_t iterations)
+{
+	volatile uint64_t sink = 0;
+
+	while (iterations--)
+		sink += iterations;
+}
+
+static unsigned int tsp_work_stolen_done(tsp_work_deque_t *dq)
+{
+	unsigned int i, done = 0;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		done += dq->stolen_done[i];
+
+	return done;
+}
+
+/*******************************************************************************
+ * This function queues 'count' items of 'iterations' busy loop iterations on
+ * the deque of this cpu and runs them, newest first, until none is left. It
+ * then waits for the items stolen by other cpus to be completed. It returns
+ * the number of items run by this cpu and the number of items stolen in
+ * 'stolen'. It is called from a standard SMC, so it can be preempted at any
+ * time. This might be while holding the lock, which the thieves never wait
+ * for.
+ ******************************************************************************/
+uint64_t tsp_work_push(uint32_t linear_id, uint64_t count, uint64_t iterations,
+		       uint64_t *stolen)
+{
+	tsp_work_deque_t *dq = &tsp_work_deques[linear_id];
+	uint64_t queued = 0, local = 0, item;
+	unsigned int done_start, done;
+
+	done_start = tsp_work_stolen_done(dq);
+
+	for (;;) {
+		spin_lock(&dq->lock);
+
+		/* Refill the deque with the items not queued yet */
+		while (queued < count &&
+		       dq->bottom - dq->top < TSP_WORK_DEQUE_SIZE) {
+			dq->items[dq->bottom++ % TSP_WORK_DEQUE_SIZE] =
+				iterations;
+			queued++;
+		}
+
+		if (dq->bottom != dq->top) {
+			item = dq->items[--dq->bottom % TSP_WORK_DEQUE_SIZE];
+			spin_unlock(&dq->lock);
+
+			tsp_work_run(item);
+			local++;
+			continue;
+		}
+
+		spin_unlock(&dq->lock);
+
+		/* All the items left have been stolen, wait for them */
+		done = tsp_work_stolen_done(dq) - done_start;
+		if (local + done == count)
+			break;
+	}
+
+	*stolen = done;
+	return local;
+}
+
+/*******************************************************************************
+ * This function steals and runs up to 'max' items from the deques of the other
+ * cpus, starting with the next cpu. A deque whose lock is held is skipped, as
+ * its owner might have been preempted while holding it and this cpu cannot be
+ * preempted. It returns the number of items run.
+ ******************************************************************************/
+unsigned int tsp_work_steal(uint32_t linear_id, unsigned int max)
+{
+	tsp_work_deque_t *dq;
+	unsigned int i, n = 0;
+	uint64_t item;
+
+	if (max > TSP_WORK_STEAL_MAX)
+		max = TSP_WORK_STEAL_MAX;
+
+	for (i = 1; i < PLATFORM_CORE_COUNT && n < max; i++) {
+		dq = &tsp_work_deques[(linear_id + i) % PLATFORM_CORE_COUNT];
+
+		while (n < max && spin_trylock(&dq->lock)) {
+			if (dq->top == dq->bottom) {
+				spin_unlock(&dq->lock);
+				break;
+			}
+
+			item = dq->items[dq->top++ % TSP_WORK_DEQUE_SIZE];
+			spin_unlock(&dq->lock);
+
+			tsp_work_run(item);
+			dq->stolen_done[linear_id]++;
+			n++;
+		}
+	}
+
+	return n;
+}
+
+/*******************************************************************************
+ * This function returns the number of items waiting in the deque of the cpu
+ * 'linear_id'. It does not take the lock, so the result is only a snapshot.
+ ******************************************************************************/
+unsigned int tsp_work_depth(uint32_t linear_id)
+{
+	volatile tsp_work_deque_t *dq = &tsp_work_deques[linear_id];
+
+	return dq->bottom - dq->top;
+}
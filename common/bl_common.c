@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -36,7 +36,10 @@
 #include <debug.h>
 #include <errno.h>
 #include <io_storage.h>
+#include <load_stats.h>
+#include <mem_region.h>
 #include <platform.h>
+#include <spinlock.h>
 #include <string.h>
 
 unsigned long page_align(unsigned long value, unsigned dir)
@@ -144,6 +147,153 @@ static void dump_load_info(unsigned long image_load_addr,
 			mem_layout->free_base + mem_layout->free_size);
 }
 
+/*
+ * Called by io_read_chunked() for each chunk of an image as soon as it has
+ * been read: the chunk is flushed so that the next EL can see it and, when
+ * the image is being hashed as it is loaded, added to the hash. With a device
+ * that reads in the background, this overlaps with the transfer of the next
+ * chunk. BL2 also hands the chunk to the platform. 'arg' points to the ID of
+ * the image.
+ */
+static int load_image_chunk(uintptr_t buffer, size_t length, void *arg)
+{
+#if TRUSTED_BOARD_BOOT && AUTH_STREAM_HASH
+	uint64_t start = load_stats_now();
+
+	auth_mod_stream_hash_update((void *)buffer, length);
+	load_stats_add(*(unsigned int *)arg, LOAD_STATS_HASH, start);
+#endif
+#if IMAGE_BL2
+	bl2_plat_image_chunk_loaded(*(unsigned int *)arg, buffer, length);
+#endif
+	flush_dcache_range(buffer, length);
+
+	return 0;
+}
+
+#if IMAGE_BL2 && BL2_IMAGE_PREFETCH
+/* Image BL2 loads after the current one, see load_image_set_next() */
+static struct {
+	meminfo_t mem_layout;
+	unsigned int image_id;
+	uintptr_t image_base;
+	int valid;
+} next_image;
+
+/* Image being read in the background, see load_image_prefetch() */
+static struct {
+	unsigned int image_id;
+	uintptr_t image_base;
+	uintptr_t dev_handle;
+	uintptr_t image_handle;
+	size_t image_size;
+	int in_flight;
+} prefetch;
+
+/*******************************************************************************
+ * Record the next image BL2 is about to load, so that its read can start as
+ * soon as the current image has been read.
+ ******************************************************************************/
+void load_image_set_next(const meminfo_t *mem_layout, unsigned int image_id,
+			 uintptr_t image_base)
+{
+	assert(mem_layout != NULL);
+
+	next_image.mem_layout = *mem_layout;
+	next_image.image_id = image_id;
+	next_image.image_base = image_base;
+	next_image.valid = 1;
+}
+
+/*******************************************************************************
+ * Start reading the image recorded by load_image_set_next() as one transfer in
+ * the background, while the current image is authenticated. Nothing is done if
+ * the device cannot read in the background, or if the parents of the image are
+ * still to be authenticated as they are loaded at the same address.
+ ******************************************************************************/
+static void load_image_prefetch(void)
+{
+#if TRUSTED_BOARD_BOOT
+	unsigned int parent_id;
+#endif
+	uintptr_t image_spec;
+	int io_result;
+
+	if (!next_image.valid || prefetch.in_flight)
+		return;
+	next_image.valid = 0;
+
+#if TRUSTED_BOARD_BOOT
+	if (auth_mod_get_parent_id(next_image.image_id, &parent_id) == 0)
+		return;
+#endif
+
+	if (plat_get_image_source(next_image.image_id, &prefetch.dev_handle,
+				  &image_spec) != 0)
+		return;
+
+	if (io_open(prefetch.dev_handle, image_spec,
+		    &prefetch.image_handle) != 0)
+		return;
+
+	io_result = io_size(prefetch.image_handle, &prefetch.image_size);
+	if ((io_result == 0) && (prefetch.image_size != 0) &&
+	    is_mem_free(next_image.mem_layout.free_base,
+			next_image.mem_layout.free_size,
+			next_image.image_base, prefetch.image_size)) {
+		io_result = io_read_start(prefetch.image_handle,
+					  next_image.image_base,
+					  prefetch.image_size);
+		if (io_result == 0) {
+			VERBOSE("Prefetching image id=%u\n",
+				next_image.image_id);
+			prefetch.image_id = next_image.image_id;
+			prefetch.image_base = next_image.image_base;
+			prefetch.in_flight = 1;
+			return;
+		}
+	}
+
+	io_close(prefetch.image_handle);
+#if !KEEP_IO_DEV_OPEN
+	io_dev_close(prefetch.dev_handle);
+#endif
+}
+
+/*******************************************************************************
+ * Hand the transfer in flight over to load_image() if it is for 'image_id' at
+ * 'image_base'. Otherwise the transfer is completed and dropped, so that the
+ * device can be used again, and 0 is returned.
+ ******************************************************************************/
+static int load_image_claim_prefetch(unsigned int image_id,
+				     uintptr_t image_base,
+				     uintptr_t *dev_handle,
+				     uintptr_t *image_handle,
+				     size_t *image_size)
+{
+	size_t bytes_read;
+
+	if (!prefetch.in_flight)
+		return 0;
+	prefetch.in_flight = 0;
+
+	if ((prefetch.image_id == image_id) &&
+	    (prefetch.image_base == image_base)) {
+		*dev_handle = prefetch.dev_handle;
+		*image_handle = prefetch.image_handle;
+		*image_size = prefetch.image_size;
+		return 1;
+	}
+
+	(void)io_read_wait(prefetch.image_handle, &bytes_read);
+	io_close(prefetch.image_handle);
+#if !KEEP_IO_DEV_OPEN
+	io_dev_close(prefetch.dev_handle);
+#endif
+	return 0;
+}
+#endif /* IMAGE_BL2 && BL2_IMAGE_PREFETCH */
+
 /* Generic function to return the size of an image */
 unsigned long image_size(unsigned int image_id)
 {
@@ -178,11 +328,10 @@ unsigned long image_size(unsigned int image_id)
 	io_result = io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this
-	 * bootloader stage
-	 */
+#if !KEEP_IO_DEV_OPEN
 	io_result = io_dev_close(dev_handle);
 	/* Ignore improbable/unrecoverable error in 'dev_close' */
+#endif
 
 	return image_size;
 }
@@ -207,12 +356,37 @@ int load_image(meminfo_t *mem_layout,
 	uintptr_t image_spec;
 	size_t image_size;
 	size_t bytes_read;
+	uint64_t start, hash_ticks;
 	int io_result;
+#if LOAD_IMAGE_IN_PLACE
+	uintptr_t image_address;
+#endif
+	int in_place = 0;
+	int handed_over = 0;
 
 	assert(mem_layout != NULL);
 	assert(image_data != NULL);
 	assert(image_data->h.version >= VERSION_1);
 
+	image_data->h.attr &= ~IMAGE_ATTR_IN_PLACE;
+
+#if IMAGE_BL2 && BL2_IMAGE_PREFETCH
+	/* The image may already have been read in the background */
+	if (load_image_claim_prefetch(image_id, image_base, &dev_handle,
+				      &image_handle, &image_size)) {
+		INFO("Loading prefetched image id=%u at address %p\n",
+		     image_id, (void *) image_base);
+		start = load_stats_now();
+		io_result = io_read_wait(image_handle, &bytes_read);
+		load_stats_add(image_id, LOAD_STATS_IO, start);
+		load_stats_add_bytes(image_id, bytes_read);
+		if (io_result == 0)
+			io_result = load_image_chunk(image_base, bytes_read,
+						     &image_id);
+		goto read_done;
+	}
+#endif
+
 	/* Obtain a reference to the image by querying the platform layer */
 	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (io_result != 0) {
@@ -240,8 +414,34 @@ int load_image(meminfo_t *mem_layout,
 		goto exit;
 	}
 
-	/* Check that the memory where the image will be loaded is free */
-	if (!is_mem_free(mem_layout->free_base, mem_layout->free_size,
+#if LOAD_IMAGE_IN_PLACE
+	/*
+	 * The image does not need to be read if the device maps it in memory
+	 * at its load address, e.g. because a previous stage has preloaded the
+	 * package in DRAM. BL2 may also hand over the address of the image in
+	 * the device instead of its load address, if the platform allows it.
+	 */
+	if (io_address(image_handle, &image_address) == 0) {
+		if (image_address == image_base) {
+			in_place = 1;
+#if IMAGE_BL2
+		} else if ((entry_point_info != NULL) &&
+			   bl2_plat_image_in_place(image_id, image_address,
+						   image_size)) {
+			image_base = image_address;
+			in_place = 1;
+			handed_over = 1;
+#endif
+		}
+	}
+#endif
+
+	/*
+	 * Check that the memory where the image will be loaded is free. An
+	 * image handed over in the device is not part of the memory layout.
+	 */
+	if (!handed_over &&
+	    !is_mem_free(mem_layout->free_base, mem_layout->free_size,
 			 image_base, image_size)) {
 		WARN("Failed to reserve memory: %p - %p\n", (void *) image_base,
 		     (void *) (image_base + image_size));
@@ -250,9 +450,30 @@ int load_image(meminfo_t *mem_layout,
 		goto exit;
 	}
 
-	/* We have enough space so load the image now */
-	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	if (in_place) {
+		INFO("Using image id=%u in place at address %p\n", image_id,
+		     (void *) image_base);
+		/* The whole image is processed as a single chunk */
+		bytes_read = image_size;
+		io_result = load_image_chunk(image_base, image_size, &image_id);
+	} else {
+		/* We have enough space so load the image now */
+		/* TODO: Consider whether to try to recover/retry a partially successful read */
+		start = load_stats_now();
+		hash_ticks = load_stats_ticks(image_id, LOAD_STATS_HASH);
+		io_result = io_read_chunked(image_handle, image_base,
+					    image_size, &bytes_read,
+					    load_image_chunk, &image_id);
+
+		/* Hashing done while loading is not accounted as IO time */
+		start += load_stats_ticks(image_id, LOAD_STATS_HASH) -
+			 hash_ticks;
+		load_stats_add(image_id, LOAD_STATS_IO, start);
+		load_stats_add_bytes(image_id, bytes_read);
+	}
+#if IMAGE_BL2 && BL2_IMAGE_PREFETCH
+read_done:
+#endif
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
@@ -265,7 +486,9 @@ int load_image(meminfo_t *mem_layout,
 	 * If the caller does not provide an entry point, bypass the memory
 	 * reservation.
 	 */
-	if (entry_point_info != NULL) {
+	if (handed_over) {
+		image_data->h.attr |= IMAGE_ATTR_IN_PLACE;
+	} else if (entry_point_info != NULL) {
 		reserve_mem(&mem_layout->free_base, &mem_layout->free_size,
 				image_base, image_size);
 	} else {
@@ -279,12 +502,6 @@ int load_image(meminfo_t *mem_layout,
 	if (entry_point_info != NULL)
 		entry_point_info->pc = image_base;
 
-	/*
-	 * File has been successfully loaded.
-	 * Flush the image in TZRAM so that the next EL can see it.
-	 */
-	flush_dcache_range(image_base, image_size);
-
 	INFO("Image id=%u loaded: %p - %p\n", image_id, (void *) image_base,
 	     (void *) (image_base + image_size));
 
@@ -292,67 +509,382 @@ exit:
 	io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this bootloader stage */
+	/*
+	 * The device connection is kept open across loads when requested, so
+	 * that the next image from the same device does not pay the cost of
+	 * re-initialising it.
+	 */
+#if !KEEP_IO_DEV_OPEN
 	io_dev_close(dev_handle);
 	/* Ignore improbable/unrecoverable error in 'dev_close' */
+#endif
 
 	return io_result;
 }
 
+#if IMAGE_BL2 && BL2_PARALLEL_LOAD
+/*
+ * With BL2_PARALLEL_LOAD several CPUs may load images at the same time. The IO
+ * layer, the certificate parser and the crypto library heap are not re-entrant
+ * so their use is serialised by this lock.
+ */
+static spinlock_t load_lock;
+#define load_lock_acquire()	spin_lock(&load_lock)
+#define load_lock_release()	spin_unlock(&load_lock)
+#else
+#define load_lock_acquire()
+#define load_lock_release()
+#endif
+
+#if TRUSTED_BOARD_BOOT && MEASURED_BOOT
+/*
+ * Measured boot event log of this BL stage, preceded by the records imported
+ * from the previous stage
+ */
+static event_log_t event_log_buf[EVENT_LOG_SIZE / sizeof(event_log_t)];
+
+#if IMAGE_BL2 && BL2_PARALLEL_LOAD
+/* Images authenticated on different CPUs are recorded one at a time */
+static spinlock_t event_log_lock;
+#define event_log_lock_acquire()	spin_lock(&event_log_lock)
+#define event_log_lock_release()	spin_unlock(&event_log_lock)
+#else
+#define event_log_lock_acquire()
+#define event_log_lock_release()
+#endif
+
+#define EVENT_LOG_DIGEST_SIZE(len)	(((len) + EVENT_LOG_ALIGN - 1) & \
+					 ~(EVENT_LOG_ALIGN - 1))
+
 /*******************************************************************************
- * Generic function to load and authenticate an image. The image is actually
- * loaded by calling the 'load_image()' function. In addition, this function
- * uses recursion to authenticate the parent images up to the root of trust.
+ * Record in the event log the digest of an image that has just been
+ * authenticated. The digest matched by the authentication module is used, so
+ * the image is not hashed again. Images not authenticated by hash, i.e.
+ * certificates, are not recorded.
  ******************************************************************************/
-int load_auth_image(meminfo_t *mem_layout,
-		    unsigned int image_id,
-		    uintptr_t image_base,
-		    image_info_t *image_data,
-		    entry_point_info_t *entry_point_info)
+static void event_log_add(unsigned int image_id)
+{
+	event_log_t *log = event_log_buf;
+	event_log_rec_t *rec;
+	void *digest;
+	unsigned int digest_len;
+	size_t rec_size;
+
+	if (auth_mod_get_img_digest(image_id, &digest, &digest_len) != 0)
+		return;
+
+	rec_size = sizeof(event_log_rec_t) + EVENT_LOG_DIGEST_SIZE(digest_len);
+
+	event_log_lock_acquire();
+
+	if (log->magic != EVENT_LOG_MAGIC) {
+		log->magic = EVENT_LOG_MAGIC;
+		log->size = 0;
+	}
+
+	if (rec_size > sizeof(event_log_buf) - sizeof(event_log_t) -
+	    log->size) {
+		event_log_lock_release();
+		WARN("Event log full, image id=%u not recorded\n", image_id);
+		return;
+	}
+
+	rec = (event_log_rec_t *)((uint8_t *)(log + 1) + log->size);
+	rec->image_id = image_id;
+	rec->digest_len = digest_len;
+	memcpy(rec + 1, digest, digest_len);
+	log->size += rec_size;
+
+	event_log_lock_release();
+}
+
+/*******************************************************************************
+ * Start the event log of this BL stage with the records of the event log
+ * passed by the previous stage, if any. Must be called before any image is
+ * loaded.
+ ******************************************************************************/
+void event_log_import(const event_log_t *log)
+{
+	if ((log == NULL) || (log->magic != EVENT_LOG_MAGIC))
+		return;
+
+	if (log->size > sizeof(event_log_buf) - sizeof(event_log_t)) {
+		WARN("Event log of the previous stage is too large\n");
+		return;
+	}
+
+	memcpy(event_log_buf, log, sizeof(event_log_t) + log->size);
+}
+
+/*******************************************************************************
+ * Return the event log of this BL stage after cleaning it to memory, so that
+ * the next BL stage can read it. Return NULL if no image has been recorded.
+ ******************************************************************************/
+const event_log_t *event_log_export(void)
+{
+	const event_log_t *log = event_log_buf;
+
+	if (log->magic != EVENT_LOG_MAGIC)
+		return NULL;
+
+	flush_dcache_range((uintptr_t)log, sizeof(event_log_t) + log->size);
+
+	return log;
+}
+#endif /* TRUSTED_BOARD_BOOT && MEASURED_BOOT */
+
+#if TRUSTED_BOARD_BOOT
+/*******************************************************************************
+ * Authenticate an image that has been loaded by 'load_image()'. On failure, the
+ * image memory is wiped so that it cannot be used.
+ ******************************************************************************/
+static int authenticate_image(unsigned int image_id, image_info_t *image_data)
 {
 	int rc;
 
+	rc = auth_mod_verify_img(image_id,
+				 (void *)image_data->image_base,
+				 image_data->image_size);
+	if (rc != 0) {
+		/* An image used in place in the device may not be writable */
+		if (!(image_data->h.attr & IMAGE_ATTR_IN_PLACE)) {
+			memset((void *)image_data->image_base, 0x00,
+			       image_data->image_size);
+			flush_dcache_range(image_data->image_base,
+					   image_data->image_size);
+		}
+		return -EAUTH;
+	}
+
+	/* After working with data, invalidate the data cache */
+	inv_dcache_range(image_data->image_base,
+			(size_t)image_data->image_size);
+
+#if MEASURED_BOOT
+	event_log_add(image_id);
+#endif
+
+	return 0;
+}
+#endif /* TRUSTED_BOARD_BOOT */
+
+/*******************************************************************************
+ * Load an image and its parents. The parent images are authenticated by this
+ * function, the requested image is left to the caller.
+ ******************************************************************************/
+static int load_auth_image_internal(meminfo_t *mem_layout,
+				    unsigned int image_id,
+				    uintptr_t image_base,
+				    image_info_t *image_data,
+				    entry_point_info_t *entry_point_info)
+{
 #if TRUSTED_BOARD_BOOT
 	unsigned int parent_id;
+	int rc;
 
 	/* Use recursion to authenticate parent images */
 	rc = auth_mod_get_parent_id(image_id, &parent_id);
 	if (rc == 0) {
-		rc = load_auth_image(mem_layout, parent_id, image_base,
-				     image_data, NULL);
+		rc = load_auth_image_internal(mem_layout, parent_id, image_base,
+					      image_data, NULL);
+		if (rc != 0) {
+			return rc;
+		}
+
+		rc = authenticate_image(parent_id, image_data);
 		if (rc != 0) {
 			return rc;
 		}
 	}
+
+#if AUTH_STREAM_HASH
+	/* Hash the image while it is being loaded, when possible */
+	auth_mod_stream_hash_start(image_id);
+#endif
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/* Load the image */
-	rc = load_image(mem_layout, image_id, image_base, image_data,
-			entry_point_info);
-	if (rc != 0) {
-		return rc;
-	}
+	return load_image(mem_layout, image_id, image_base, image_data,
+			  entry_point_info);
+}
+
+/*******************************************************************************
+ * Generic function to load and authenticate an image. The image is actually
+ * loaded by calling the 'load_image()' function. In addition, this function
+ * uses recursion to authenticate the parent images up to the root of trust.
+ ******************************************************************************/
+int load_auth_image(meminfo_t *mem_layout,
+		    unsigned int image_id,
+		    uintptr_t image_base,
+		    image_info_t *image_data,
+		    entry_point_info_t *entry_point_info)
+{
+	int rc;
+
+	load_lock_acquire();
+
+	rc = load_auth_image_internal(mem_layout, image_id, image_base,
+				      image_data, entry_point_info);
+
+#if IMAGE_BL2 && BL2_IMAGE_PREFETCH
+	/* Read the next image while this one is being authenticated */
+	if (rc == 0)
+		load_image_prefetch();
+#endif
 
 #if TRUSTED_BOARD_BOOT
-	/* Authenticate it */
-	rc = auth_mod_verify_img(image_id,
-				 (void *)image_data->image_base,
-				 image_data->image_size);
+#if !AUTH_STREAM_HASH
+	/*
+	 * The requested image is authenticated against the hash held by its
+	 * (already verified) parent, which only needs the image memory. Other
+	 * CPUs may carry on loading while it is being hashed.
+	 */
+	load_lock_release();
+#endif
+	if (rc == 0) {
+		rc = authenticate_image(image_id, image_data);
+	}
+#if AUTH_STREAM_HASH
+	load_lock_release();
+#endif
+#else
+	load_lock_release();
+#endif /* TRUSTED_BOARD_BOOT */
+
+	return rc;
+}
+
+/*******************************************************************************
+ * Load and authenticate an image which does not need to be at a fixed address,
+ * e.g. an image handed over to another processor. The image is placed in the
+ * free extent of 'pool' where it fits best, at an address aligned on 'align'
+ * bytes (0 if no alignment is needed), which is returned in 'image_data'. The
+ * memory is given back to the pool if the image fails to load. There is no
+ * entry point information as the image cannot be linked to run at an address
+ * chosen at run time.
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+int load_auth_image_alloc(mem_region_pool_t *pool,
+			  unsigned int image_id,
+			  size_t align,
+			  image_info_t *image_data)
+{
+	meminfo_t mem_layout;
+	uint64_t image_base;
+	size_t size;
+	int rc;
+
+	assert(pool != NULL);
+
+	size = image_size(image_id);
+	if (size == 0)
+		return -ENOENT;
+
+	rc = mem_region_alloc(pool, size, align, &image_base);
 	if (rc != 0) {
-		memset((void *)image_data->image_base, 0x00,
-		       image_data->image_size);
-		flush_dcache_range(image_data->image_base,
-				   image_data->image_size);
-		return -EAUTH;
+		WARN("Failed to allocate 0x%lx bytes for image id=%u\n",
+		     (unsigned long) size, image_id);
+		mem_region_print(pool);
+		return rc;
 	}
 
-	/* After working with data, invalidate the data cache */
-	inv_dcache_range(image_data->image_base,
-			(size_t)image_data->image_size);
-#endif /* TRUSTED_BOARD_BOOT */
+	/* The image is loaded in the memory it has been allocated */
+	mem_layout.total_base = image_base;
+	mem_layout.total_size = size;
+	mem_layout.free_base = image_base;
+	mem_layout.free_size = size;
 
-	return 0;
+	rc = load_auth_image(&mem_layout, image_id, image_base, image_data,
+			     NULL);
+	if (rc != 0)
+		mem_region_free(pool, image_base, size);
+
+	return rc;
+}
+
+#if TRUSTED_BOARD_BOOT && AUTH_BATCH_CERTS
+/*******************************************************************************
+ * Load and authenticate up front the certificates that the images in
+ * 'image_ids' depend on, before any of those images is loaded. The chain of
+ * trust is walked one level at a time: all the certificates whose parent has
+ * been authenticated are verified one after the other, so consecutive
+ * verifications often use the same key. Each certificate is loaded at
+ * 'cert_base', which must be free in 'mem_layout', and the parameters needed
+ * later are kept by the authentication module.
+ *
+ * An image whose certificates fail to load or authenticate is skipped. It is
+ * dealt with as usual when the image itself is loaded. Up to 'AUTH_BATCH_MAX'
+ * images may be passed.
+ ******************************************************************************/
+void load_auth_certs(meminfo_t *mem_layout, const unsigned int *image_ids,
+		     unsigned int num_images, uintptr_t cert_base)
+{
+	unsigned int image_cert[AUTH_BATCH_MAX];
+	unsigned int certs[AUTH_BATCH_MAX];
+	unsigned int skip[AUTH_BATCH_MAX];
+	image_info_t cert_data;
+	unsigned int cert_id, parent_id, num_certs, i, j;
+	int rc;
+
+	assert(num_images <= AUTH_BATCH_MAX);
+
+	memset(skip, 0, sizeof(skip));
+	cert_data.h.version = VERSION_1;
+
+	load_lock_acquire();
+
+	do {
+		/* Find the next certificate to be verified for each image */
+		num_certs = 0;
+		for (i = 0 ; i < num_images ; i++) {
+			if (skip[i] ||
+			    (auth_mod_get_parent_id(image_ids[i], &cert_id)
+			     != 0)) {
+				skip[i] = 1;
+				continue;
+			}
+
+			while (auth_mod_get_parent_id(cert_id, &parent_id)
+			       == 0) {
+				cert_id = parent_id;
+			}
+			image_cert[i] = cert_id;
+
+			/* Several images may share the certificate */
+			for (j = 0 ; j < num_certs ; j++) {
+				if (certs[j] == cert_id) {
+					break;
+				}
+			}
+			if (j == num_certs) {
+				certs[num_certs++] = cert_id;
+			}
+		}
+
+		/* Verify them as one batch */
+		for (j = 0 ; j < num_certs ; j++) {
+			rc = load_image(mem_layout, certs[j], cert_base,
+					&cert_data, NULL);
+			if (rc == 0) {
+				rc = authenticate_image(certs[j], &cert_data);
+			}
+			if (rc == 0) {
+				continue;
+			}
+
+			VERBOSE("Failed to authenticate certificate id=%u\n",
+				certs[j]);
+			for (i = 0 ; i < num_images ; i++) {
+				if (!skip[i] && (image_cert[i] == certs[j])) {
+					skip[i] = 1;
+				}
+			}
+		}
+	} while (num_certs != 0);
+
+	load_lock_release();
 }
+#endif /* TRUSTED_BOARD_BOOT && AUTH_BATCH_CERTS */
 
 /*******************************************************************************
  * Print the content of an entry_point_info_t structure.
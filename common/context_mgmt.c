@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -108,6 +108,11 @@ static void cm_init_context_common(cpu_context_t *ctx, const entry_point_info_t
 	if (GET_RW(ep->spsr) == MODE_RW_64)
 		scr_el3 |= SCR_RW_BIT;
 
+#if !CTX_INCLUDE_AARCH32_REGS
+	/* The context has no room for the AArch32 EL1 registers */
+	assert(GET_RW(ep->spsr) == MODE_RW_64);
+#endif
+
 	if (EP_GET_ST(ep->h.attr))
 		scr_el3 |= SCR_ST_BIT;
 
@@ -251,24 +256,88 @@ void cm_prepare_el3_exit(uint32_t security_state)
 		}
 	}
 
-	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+	el1_sysregs_context_restore(get_sysregs_ctx(ctx), CTX_EL1_SYSREGS_ALL);
 
 	cm_set_next_context(ctx);
 }
 
+/*******************************************************************************
+ * This function returns the groups of EL1 system registers which are switched
+ * between the two contexts of the current CPU, either of which may be NULL. A
+ * group is only left out if one of the contexts has been set up without it.
+ ******************************************************************************/
+static unsigned int cm_el1_sysregs_mask(cpu_context_t *ctx,
+					cpu_context_t *other_ctx)
+{
+	unsigned int skip = 0;
+
+	if (ctx)
+		skip |= read_ctx_reg(get_el3state_ctx(ctx),
+				     CTX_EL1_SYSREGS_SKIP);
+
+	if (other_ctx)
+		skip |= read_ctx_reg(get_el3state_ctx(other_ctx),
+				     CTX_EL1_SYSREGS_SKIP);
+
+	return CTX_EL1_SYSREGS_ALL & ~skip;
+}
+
+static unsigned int cm_get_el1_sysregs_mask(void)
+{
+	return cm_el1_sysregs_mask(cm_get_context(SECURE),
+				   cm_get_context(NON_SECURE));
+}
+
 /*******************************************************************************
  * The next four functions are used by runtime services to save and restore
  * EL1 context on the 'cpu_context' structure for the specified security
- * state.
+ * state. With CTX_INCLUDE_FPREGS, the FP registers are switched as well unless
+ * CTX_LAZY_FPREGS defers this to the first FP access of the incoming world.
+ * With CTX_INCLUDE_PMU_REGS, the performance monitors registers are switched
+ * too, so that the counters of each world only count its own events.
  ******************************************************************************/
 void cm_el1_sysregs_context_save(uint32_t security_state)
+{
+	cm_el1_sysregs_context_save_partial(security_state,
+					    CTX_EL1_SYSREGS_ALL);
+}
+
+/*******************************************************************************
+ * This function is a variant of cm_el1_sysregs_context_save() which only saves
+ * the groups of EL1 system registers in 'mask'. A dispatcher can use it when
+ * the other groups are known to still hold the values in the context, e.g.
+ * because they have been restored on entry into its Secure Payload and the
+ * Secure Payload never changes them.
+ ******************************************************************************/
+void cm_el1_sysregs_context_save_partial(uint32_t security_state,
+					 unsigned int mask)
 {
 	cpu_context_t *ctx;
 
 	ctx = cm_get_context(security_state);
 	assert(ctx);
+	assert((mask & ~CTX_EL1_SYSREGS_ALL) == 0);
+
+#if CTX_LAZY_FPREGS && CTX_INCLUDE_AARCH32_REGS
+	/*
+	 * Saving FPEXC32_EL2 traps if the FP registers of the world being
+	 * saved are not live. Allow the access, el3_exit() sets the trap again
+	 * as required by the world it returns to.
+	 */
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+#endif
+
+	el1_sysregs_context_save(get_sysregs_ctx(ctx),
+				 cm_get_el1_sysregs_mask() & mask);
+
+#if CTX_INCLUDE_FPREGS && !CTX_LAZY_FPREGS
+	fpregs_context_save(get_fpregs_ctx(ctx));
+#endif
 
-	el1_sysregs_context_save(get_sysregs_ctx(ctx));
+#if CTX_INCLUDE_PMU_REGS
+	pmuregs_context_save(get_pmuregs_ctx(ctx));
+#endif
 }
 
 void cm_el1_sysregs_context_restore(uint32_t security_state)
@@ -278,7 +347,113 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx);
 
-	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+#if CTX_LAZY_FPREGS && CTX_INCLUDE_AARCH32_REGS
+	/* See cm_el1_sysregs_context_save() */
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+#endif
+
+	el1_sysregs_context_restore(get_sysregs_ctx(ctx),
+				    cm_get_el1_sysregs_mask());
+
+#if CTX_INCLUDE_FPREGS && !CTX_LAZY_FPREGS
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+#endif
+
+#if CTX_INCLUDE_PMU_REGS
+	pmuregs_context_restore(get_pmuregs_ctx(ctx));
+#endif
+}
+
+/*******************************************************************************
+ * This function switches the EL1 context of the current CPU from
+ * 'security_state' to the other security state and prepares the latter for the
+ * next ERET. It is equivalent to cm_el1_sysregs_context_save() for
+ * 'security_state' followed by cm_el1_sysregs_context_restore() and
+ * cm_set_next_eret_context() for the other security state, but looks up the
+ * contexts and the registers to switch only once. Dispatchers use it on the
+ * round trip of an SMC between the normal world and their Secure Payload.
+ ******************************************************************************/
+void cm_el1_sysregs_context_switch(uint32_t security_state)
+{
+	cpu_context_t *ctx, *next_ctx;
+
+	ctx = cm_get_context(security_state);
+	next_ctx = cm_get_context(security_state == SECURE ?
+				  NON_SECURE : SECURE);
+	assert(ctx && next_ctx);
+
+#if CTX_LAZY_FPREGS && CTX_INCLUDE_AARCH32_REGS
+	/* See cm_el1_sysregs_context_save() */
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+#endif
+
+	el1_sysregs_context_switch(get_sysregs_ctx(ctx),
+				   get_sysregs_ctx(next_ctx),
+				   cm_el1_sysregs_mask(ctx, next_ctx));
+
+#if CTX_INCLUDE_FPREGS && !CTX_LAZY_FPREGS
+	fpregs_context_save(get_fpregs_ctx(ctx));
+	fpregs_context_restore(get_fpregs_ctx(next_ctx));
+#endif
+
+#if CTX_INCLUDE_PMU_REGS
+	pmuregs_context_save(get_pmuregs_ctx(ctx));
+	pmuregs_context_restore(get_pmuregs_ctx(next_ctx));
+#endif
+
+	cm_set_next_context(next_ctx);
+}
+
+#if CTX_LAZY_FPREGS
+/*******************************************************************************
+ * This function saves the FP registers of the calling CPU into the context of
+ * the world which they belong to, if any, and marks the FP state of both worlds
+ * as not live. PSCI calls it before the CPU is powered down, as the FP state
+ * held only in the registers would otherwise be lost. The next FP access of
+ * either world then traps and reloads its FP state from its context.
+ ******************************************************************************/
+void cm_fpregs_context_save_live(void)
+{
+	cpu_context_t *ctx;
+	uint32_t ss;
+
+	/* Allow the access, el3_exit() sets the trap again */
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+
+	for (ss = SECURE; ss <= NON_SECURE; ss++) {
+		ctx = cm_get_context(ss);
+		if (!ctx || !read_ctx_reg(get_el3state_ctx(ctx),
+					  CTX_FPREGS_LIVE))
+			continue;
+
+		fpregs_context_save(get_fpregs_ctx(ctx));
+		write_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE, 0);
+	}
+}
+#endif
+
+/*******************************************************************************
+ * This function sets the groups of EL1 system registers (CTX_EL1_SYSREGS_*)
+ * used by the software running in 'security_state' on the current CPU. The
+ * other groups are no longer saved and restored by
+ * cm_el1_sysregs_context_save() and cm_el1_sysregs_context_restore(), so both
+ * security states share their values. A Secure Payload Dispatcher calls this
+ * after initialising the context with cm_init_my_context(), which resets it to
+ * all the groups.
+ ******************************************************************************/
+void cm_set_el1_sysregs_mask(uint32_t security_state, unsigned int mask)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx);
+	assert((mask & ~CTX_EL1_SYSREGS_ALL) == 0);
+
+	write_ctx_reg(get_el3state_ctx(ctx), CTX_EL1_SYSREGS_SKIP,
+		      CTX_EL1_SYSREGS_ALL & ~mask);
 }
 
 /*******************************************************************************
@@ -350,6 +525,30 @@ void cm_write_scr_el3_bit(uint32_t security_state,
 	write_ctx_reg(state, CTX_SCR_EL3, scr_el3);
 }
 
+/*******************************************************************************
+ * This function is a variant of cm_write_scr_el3_bit() for callers which have
+ * worked out the SCR_EL3 bits beforehand: it replaces the bits in 'mask' of the
+ * SCR_EL3 member of the 'cpu_context' pertaining to the given security state
+ * with 'value'.
+ ******************************************************************************/
+void cm_write_scr_el3_bits(uint32_t security_state,
+			   uint32_t mask,
+			   uint32_t value)
+{
+	cpu_context_t *ctx;
+	el3_state_t *state;
+	uint32_t scr_el3;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx);
+	assert((mask & ~SCR_VALID_BIT_MASK) == 0);
+	assert((value & ~mask) == 0);
+
+	state = get_el3state_ctx(ctx);
+	scr_el3 = read_ctx_reg(state, CTX_SCR_EL3);
+	write_ctx_reg(state, CTX_SCR_EL3, (scr_el3 & ~mask) | value);
+}
+
 /*******************************************************************************
  * This function retrieves SCR_EL3 member of 'cpu_context' pertaining to the
  * given security state.
@@ -381,3 +580,151 @@ void cm_set_next_eret_context(uint32_t security_state)
 
 	cm_set_next_context(ctx);
 }
+
+#if CTX_SUSPEND_PACK
+/*
+ * Group of EL1 system registers of each 64-bit slot of 'el1_sys_regs'. The
+ * padding slots have no group and are never packed.
+ */
+#define CM_SYSREG_SLOT(reg)	((reg) >> DWORD_SHIFT)
+#define CM_GPREGS_NUM		(CTX_GPREGS_END >> DWORD_SHIFT)
+#define CM_EL3STATE_NUM		(CTX_EL3STATE_END >> DWORD_SHIFT)
+#define CM_SYSREGS_NUM		(CTX_SYSREGS_END >> DWORD_SHIFT)
+
+static const unsigned char cm_sysreg_groups[CM_SYSREGS_NUM] = {
+	[CM_SYSREG_SLOT(CTX_SPSR_EL1)]		= CTX_EL1_SYSREGS_EXC,
+	[CM_SYSREG_SLOT(CTX_ELR_EL1)]		= CTX_EL1_SYSREGS_EXC,
+	[CM_SYSREG_SLOT(CTX_SCTLR_EL1)]		= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_ACTLR_EL1)]		= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_CPACR_EL1)]		= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_CSSELR_EL1)]	= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_SP_EL1)]		= CTX_EL1_SYSREGS_EXC,
+	[CM_SYSREG_SLOT(CTX_ESR_EL1)]		= CTX_EL1_SYSREGS_EXC,
+	[CM_SYSREG_SLOT(CTX_TTBR0_EL1)]		= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_TTBR1_EL1)]		= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_MAIR_EL1)]		= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_AMAIR_EL1)]		= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_TCR_EL1)]		= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_TPIDR_EL1)]		= CTX_EL1_SYSREGS_TID,
+	[CM_SYSREG_SLOT(CTX_TPIDR_EL0)]		= CTX_EL1_SYSREGS_TID,
+	[CM_SYSREG_SLOT(CTX_TPIDRRO_EL0)]	= CTX_EL1_SYSREGS_TID,
+	[CM_SYSREG_SLOT(CTX_PAR_EL1)]		= CTX_EL1_SYSREGS_EXC,
+	[CM_SYSREG_SLOT(CTX_FAR_EL1)]		= CTX_EL1_SYSREGS_EXC,
+	[CM_SYSREG_SLOT(CTX_AFSR0_EL1)]		= CTX_EL1_SYSREGS_EXC,
+	[CM_SYSREG_SLOT(CTX_AFSR1_EL1)]		= CTX_EL1_SYSREGS_EXC,
+	[CM_SYSREG_SLOT(CTX_CONTEXTIDR_EL1)]	= CTX_EL1_SYSREGS_MMU,
+	[CM_SYSREG_SLOT(CTX_VBAR_EL1)]		= CTX_EL1_SYSREGS_EXC,
+#if CTX_INCLUDE_AARCH32_REGS
+	[CM_SYSREG_SLOT(CTX_SPSR_ABT)]		= CTX_EL1_SYSREGS_AARCH32,
+	[CM_SYSREG_SLOT(CTX_SPSR_UND)]		= CTX_EL1_SYSREGS_AARCH32,
+	[CM_SYSREG_SLOT(CTX_SPSR_IRQ)]		= CTX_EL1_SYSREGS_AARCH32,
+	[CM_SYSREG_SLOT(CTX_SPSR_FIQ)]		= CTX_EL1_SYSREGS_AARCH32,
+	[CM_SYSREG_SLOT(CTX_DACR32_EL2)]	= CTX_EL1_SYSREGS_AARCH32,
+	[CM_SYSREG_SLOT(CTX_IFSR32_EL2)]	= CTX_EL1_SYSREGS_AARCH32,
+	[CM_SYSREG_SLOT(CTX_FP_FPEXC32_EL2)]	= CTX_EL1_SYSREGS_AARCH32,
+#endif
+#if NS_TIMER_SWITCH
+	[CM_SYSREG_SLOT(CTX_CNTP_CTL_EL0)]	= CTX_EL1_SYSREGS_TIMER,
+	[CM_SYSREG_SLOT(CTX_CNTP_CVAL_EL0)]	= CTX_EL1_SYSREGS_TIMER,
+	[CM_SYSREG_SLOT(CTX_CNTV_CTL_EL0)]	= CTX_EL1_SYSREGS_TIMER,
+	[CM_SYSREG_SLOT(CTX_CNTV_CVAL_EL0)]	= CTX_EL1_SYSREGS_TIMER,
+	[CM_SYSREG_SLOT(CTX_CNTKCTL_EL1)]	= CTX_EL1_SYSREGS_TIMER,
+#endif
+};
+
+/* Header word of each packed context */
+#define CM_PACK_HDR(cpu_idx, ss, groups)	((cpu_idx) |		\
+						 ((ss) << 16) |		\
+						 ((groups) << 24))
+#define CM_PACK_HDR_CPU(hdr)			((hdr) & 0xffff)
+#define CM_PACK_HDR_SS(hdr)			(((hdr) >> 16) & 0xff)
+#define CM_PACK_HDR_GROUPS(hdr)			(((hdr) >> 24) & 0xff)
+
+/*******************************************************************************
+ * This function packs the contexts of both security states of all the CPUs in
+ * 'buf', which must be able to hold CM_PACKED_CONTEXTS_SIZE(PLATFORM_CORE_COUNT)
+ * bytes, and returns the number of bytes used. Only the general purpose
+ * registers, the EL3 state and the groups of EL1 system registers which are
+ * switched between the two contexts of a CPU are kept, without the AArch32
+ * registers when EL1 is AArch64. The FP and PMU registers are dropped as they
+ * are not retained over a power down state.
+ ******************************************************************************/
+size_t cm_pack_contexts(uint64_t *buf)
+{
+	uint64_t *p = buf + 1;
+	const uint64_t *regs;
+	cpu_context_t *ctx;
+	unsigned int cpu_idx, ss, groups, mask, i, num = 0;
+
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		mask = cm_el1_sysregs_mask(
+				cm_get_context_by_index(cpu_idx, SECURE),
+				cm_get_context_by_index(cpu_idx, NON_SECURE));
+
+		for (ss = SECURE; ss <= NON_SECURE; ss++) {
+			ctx = cm_get_context_by_index(cpu_idx, ss);
+			if (!ctx)
+				continue;
+
+			groups = mask;
+			if (read_ctx_reg(get_el3state_ctx(ctx), CTX_SCR_EL3) &
+								SCR_RW_BIT)
+				groups &= ~CTX_EL1_SYSREGS_AARCH32;
+
+			*p++ = CM_PACK_HDR(cpu_idx, ss, groups);
+
+			memcpy(p, get_gpregs_ctx(ctx), sizeof(gp_regs_t));
+			p += CM_GPREGS_NUM;
+			memcpy(p, get_el3state_ctx(ctx), sizeof(el3_state_t));
+			p += CM_EL3STATE_NUM;
+
+			regs = (const uint64_t *)get_sysregs_ctx(ctx);
+			for (i = 0; i < CM_SYSREGS_NUM; i++)
+				if (cm_sysreg_groups[i] & groups)
+					*p++ = regs[i];
+
+			num++;
+		}
+	}
+
+	buf[0] = num;
+	return (uintptr_t)p - (uintptr_t)buf;
+}
+
+/*******************************************************************************
+ * This function rebuilds the contexts packed in 'buf' by cm_pack_contexts().
+ * The registers which have not been packed are zeroed.
+ ******************************************************************************/
+void cm_unpack_contexts(const uint64_t *buf)
+{
+	const uint64_t *p = buf + 1;
+	uint64_t hdr, *regs;
+	cpu_context_t *ctx;
+	unsigned int num, groups, i;
+
+	for (num = buf[0]; num; num--) {
+		hdr = *p++;
+		ctx = cm_get_context_by_index(CM_PACK_HDR_CPU(hdr),
+					      CM_PACK_HDR_SS(hdr));
+		assert(ctx);
+		groups = CM_PACK_HDR_GROUPS(hdr);
+
+		memset(ctx, 0, sizeof(*ctx));
+
+		memcpy(get_gpregs_ctx(ctx), p, sizeof(gp_regs_t));
+		p += CM_GPREGS_NUM;
+		memcpy(get_el3state_ctx(ctx), p, sizeof(el3_state_t));
+		p += CM_EL3STATE_NUM;
+
+		regs = (uint64_t *)get_sysregs_ctx(ctx);
+		for (i = 0; i < CM_SYSREGS_NUM; i++)
+			if (cm_sysreg_groups[i] & groups)
+				regs[i] = *p++;
+
+#if CTX_LAZY_FPREGS
+		/* The FP registers of the CPU have been lost as well */
+		write_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE, 0);
+#endif
+	}
+}
+#endif /* CTX_SUSPEND_PACK */
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <debug.h>
+#include <load_stats.h>
+#include <platform.h>
+
+/*
+ * Statistics indexed by image ID. Images loaded in parallel on several CPUs
+ * are accounted to different entries, so no lock is needed.
+ */
+static load_stats_t load_stats[LOAD_STATS_MAX_IMAGES];
+
+/*******************************************************************************
+ * Account the ticks elapsed since 'start' to a phase of an image.
+ ******************************************************************************/
+void load_stats_add(unsigned int image_id, unsigned int phase, uint64_t start)
+{
+	if (image_id >= LOAD_STATS_MAX_IMAGES)
+		return;
+
+	load_stats[image_id].ticks[phase] += read_cntpct_el0() - start;
+}
+
+/*******************************************************************************
+ * Account the bytes read from the storage to an image.
+ ******************************************************************************/
+void load_stats_add_bytes(unsigned int image_id, size_t bytes)
+{
+	if (image_id >= LOAD_STATS_MAX_IMAGES)
+		return;
+
+	load_stats[image_id].bytes += bytes;
+}
+
+/*******************************************************************************
+ * Return the ticks accounted so far to a phase of an image.
+ ******************************************************************************/
+uint64_t load_stats_ticks(unsigned int image_id, unsigned int phase)
+{
+	if (image_id >= LOAD_STATS_MAX_IMAGES)
+		return 0;
+
+	return load_stats[image_id].ticks[phase];
+}
+
+/*******************************************************************************
+ * Return the bytes accounted so far to an image.
+ ******************************************************************************/
+uint64_t load_stats_bytes(unsigned int image_id)
+{
+	if (image_id >= LOAD_STATS_MAX_IMAGES)
+		return 0;
+
+	return load_stats[image_id].bytes;
+}
+
+/*******************************************************************************
+ * Print the statistics of the images accounted by this BL stage, in
+ * microseconds.
+ ******************************************************************************/
+void load_stats_print(void)
+{
+	const load_stats_t *stats;
+	uint64_t usec[LOAD_STATS_PHASES];
+	uint64_t freq;
+	unsigned int i, phase;
+
+	freq = plat_get_syscnt_freq();
+	if (freq == 0)
+		return;
+
+	for (i = 0; i < LOAD_STATS_MAX_IMAGES; i++) {
+		stats = &load_stats[i];
+		if (stats->bytes == 0)
+			continue;
+
+		for (phase = 0; phase < LOAD_STATS_PHASES; phase++)
+			usec[phase] = (stats->ticks[phase] * 1000000) / freq;
+
+		NOTICE("Image id=%u: %lu bytes, io %luus, hash %luus, "
+		       "parse %luus, sig %luus\n", i, stats->bytes,
+		       usec[LOAD_STATS_IO], usec[LOAD_STATS_HASH],
+		       usec[LOAD_STATS_PARSE], usec[LOAD_STATS_SIG]);
+	}
+}
+
+/*******************************************************************************
+ * Return the statistics table, LOAD_STATS_MAX_IMAGES entries indexed by image
+ * ID, after cleaning it to memory so that the next BL stage can read it.
+ ******************************************************************************/
+const load_stats_t *load_stats_export(void)
+{
+	flush_dcache_range((uintptr_t)load_stats, sizeof(load_stats));
+
+	return load_stats;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <debug.h>
+#include <log_record.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ * Print ' ' followed by 'val' in hexadecimal, without leading zeros. Only
+ * shifts are used, unlike tf_printf() which divides for each digit.
+ ******************************************************************************/
+static void log_record_hex(uint64_t val)
+{
+	int shift = 60;
+	unsigned int digit;
+
+	putchar(' ');
+
+	while ((shift > 0) && !(val >> shift))
+		shift -= 4;
+
+	for (; shift >= 0; shift -= 4) {
+		digit = (val >> shift) & 0xf;
+		putchar((digit < 0xa) ? ('0' + digit) : ('a' + digit - 0xa));
+	}
+}
+
+/*******************************************************************************
+ * Print the record of a log message, see log_record.h. Called through the
+ * LOG_RECORD() macro.
+ ******************************************************************************/
+void log_record(const char *fmt, unsigned int nargs, const uint64_t *args)
+{
+	unsigned int i;
+
+	putchar(LOG_RECORD_MARKER);
+	log_record_hex((uintptr_t)fmt);
+
+	for (i = 0; i < nargs; i++)
+		log_record_hex(args[i]);
+
+	putchar('\n');
+}
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <mem_region.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Initialise a pool whose only free extent is the region delimited by 'base'
+ * and 'size'.
+ ******************************************************************************/
+void mem_region_init(mem_region_pool_t *pool, uint64_t base, size_t size)
+{
+	assert(pool != NULL);
+
+	memset(pool, 0, sizeof(*pool));
+	if (size != 0) {
+		pool->free[0].base = base;
+		pool->free[0].size = size;
+		pool->num_free = 1;
+	}
+}
+
+/*******************************************************************************
+ * Return the index of the free extent which contains the memory delimited by
+ * 'base' and 'size', or -1 if that memory is not entirely free.
+ ******************************************************************************/
+static int find_extent(const mem_region_pool_t *pool, uint64_t base,
+		       size_t size)
+{
+	const mem_extent_t *ext;
+	unsigned int i;
+
+	for (i = 0; i < pool->num_free; i++) {
+		ext = &pool->free[i];
+		if ((base >= ext->base) &&
+		    (base + size <= ext->base + ext->size))
+			return i;
+	}
+
+	return -1;
+}
+
+/*******************************************************************************
+ * Return 1 if the memory delimited by 'base' and 'size' is free, 0 otherwise.
+ ******************************************************************************/
+int mem_region_is_free(const mem_region_pool_t *pool, uint64_t base,
+		       size_t size)
+{
+	assert(pool != NULL);
+
+	return find_extent(pool, base, size) >= 0;
+}
+
+/*******************************************************************************
+ * Reserve the memory delimited by 'base' and 'size', which must be free.
+ * Return 0 on success, -ENOMEM if the memory is not free.
+ ******************************************************************************/
+int mem_region_reserve(mem_region_pool_t *pool, uint64_t base, size_t size)
+{
+	mem_extent_t *ext;
+	size_t below, above, discard;
+	int i;
+
+	assert(pool != NULL);
+
+	i = find_extent(pool, base, size);
+	if (i < 0)
+		return -ENOMEM;
+
+	ext = &pool->free[i];
+	below = base - ext->base;
+	above = ext->base + ext->size - (base + size);
+
+	if ((below != 0) && (above != 0)) {
+		if (pool->num_free < MEM_REGION_MAX_FREE) {
+			/* Split the extent in two */
+			memmove(ext + 2, ext + 1,
+				(pool->num_free - i - 1) * sizeof(*ext));
+			pool->num_free++;
+			ext[1].base = base + size;
+			ext[1].size = above;
+			ext->size = below;
+			return 0;
+		}
+
+		/* No entry left, keep the larger part only */
+		if (below < above) {
+			discard = below;
+			below = 0;
+		} else {
+			discard = above;
+			above = 0;
+		}
+		pool->discarded += discard;
+		VERBOSE("Memory region: discarded 0x%lx bytes\n",
+			(unsigned long) discard);
+	}
+
+	if (below != 0) {
+		ext->size = below;
+	} else if (above != 0) {
+		ext->base = base + size;
+		ext->size = above;
+	} else {
+		/* The extent is used up */
+		memmove(ext, ext + 1, (pool->num_free - i - 1) * sizeof(*ext));
+		pool->num_free--;
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Allocate 'size' bytes aligned on 'align' bytes, a power of two (0 if no
+ * alignment is needed). The memory is taken from the free extent where it
+ * leaves the least free memory, to keep the larger extents for larger images.
+ * Return 0 on success with the address in '*base', -ENOMEM if there is no
+ * free extent large enough.
+ ******************************************************************************/
+int mem_region_alloc(mem_region_pool_t *pool, size_t size, size_t align,
+		     uint64_t *base)
+{
+	const mem_extent_t *ext;
+	uint64_t start, best_start = 0;
+	size_t left, best_left = 0;
+	unsigned int i;
+	int found = 0;
+
+	assert(pool != NULL);
+	assert(base != NULL);
+	assert((align & (align - 1)) == 0);
+
+	if (align == 0)
+		align = 1;
+
+	for (i = 0; i < pool->num_free; i++) {
+		ext = &pool->free[i];
+		start = (ext->base + align - 1) & ~((uint64_t) align - 1);
+		if ((start < ext->base) ||
+		    (start + size > ext->base + ext->size))
+			continue;
+
+		left = ext->size - size;
+		if (!found || (left < best_left)) {
+			best_start = start;
+			best_left = left;
+			found = 1;
+		}
+	}
+
+	if (!found)
+		return -ENOMEM;
+
+	*base = best_start;
+
+	return mem_region_reserve(pool, best_start, size);
+}
+
+/*******************************************************************************
+ * Give back the memory delimited by 'base' and 'size', which must have been
+ * reserved or allocated, merging it with the adjacent free extents. The memory
+ * is discarded if it is not adjacent to a free extent and no entry is left.
+ ******************************************************************************/
+void mem_region_free(mem_region_pool_t *pool, uint64_t base, size_t size)
+{
+	mem_extent_t *ext;
+	unsigned int i;
+
+	assert(pool != NULL);
+
+	if (size == 0)
+		return;
+
+	/* Find the first free extent above the memory */
+	for (i = 0; i < pool->num_free; i++) {
+		if (pool->free[i].base >= base + size)
+			break;
+	}
+
+	ext = &pool->free[i];
+	assert((i == 0) || (ext[-1].base + ext[-1].size <= base));
+
+	if ((i != 0) && (ext[-1].base + ext[-1].size == base)) {
+		/* Merge with the extent below, and the one above if adjacent */
+		ext[-1].size += size;
+		if ((i < pool->num_free) && (ext->base == base + size)) {
+			ext[-1].size += ext->size;
+			memmove(ext, ext + 1,
+				(pool->num_free - i - 1) * sizeof(*ext));
+			pool->num_free--;
+		}
+	} else if ((i < pool->num_free) && (ext->base == base + size)) {
+		/* Merge with the extent above */
+		ext->base = base;
+		ext->size += size;
+	} else if (pool->num_free < MEM_REGION_MAX_FREE) {
+		memmove(ext + 1, ext, (pool->num_free - i) * sizeof(*ext));
+		pool->num_free++;
+		ext->base = base;
+		ext->size = size;
+	} else {
+		pool->discarded += size;
+	}
+}
+
+/*******************************************************************************
+ * Return the total size of the free extents.
+ ******************************************************************************/
+size_t mem_region_free_size(const mem_region_pool_t *pool)
+{
+	size_t size = 0;
+	unsigned int i;
+
+	assert(pool != NULL);
+
+	for (i = 0; i < pool->num_free; i++)
+		size += pool->free[i].size;
+
+	return size;
+}
+
+/*******************************************************************************
+ * Return the size of the largest free extent, i.e. of the largest image which
+ * can still be allocated.
+ ******************************************************************************/
+size_t mem_region_largest_free(const mem_region_pool_t *pool)
+{
+	size_t size = 0;
+	unsigned int i;
+
+	assert(pool != NULL);
+
+	for (i = 0; i < pool->num_free; i++) {
+		if (pool->free[i].size > size)
+			size = pool->free[i].size;
+	}
+
+	return size;
+}
+
+/*******************************************************************************
+ * Print the free extents of a pool and its fragmentation, i.e. the percentage
+ * of the free memory which is not part of the largest free extent.
+ ******************************************************************************/
+void mem_region_print(const mem_region_pool_t *pool)
+{
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+	size_t free_size, largest;
+	unsigned int i;
+
+	free_size = mem_region_free_size(pool);
+	largest = mem_region_largest_free(pool);
+
+	INFO("Memory region: 0x%lx bytes free in %u extents, largest 0x%lx\n",
+	     (unsigned long) free_size, pool->num_free,
+	     (unsigned long) largest);
+	INFO("  fragmentation = %u%%, discarded = 0x%lx bytes\n",
+	     free_size ? (unsigned int) (100 - (largest * 100) / free_size) : 0,
+	     (unsigned long) pool->discarded);
+
+	for (i = 0; i < pool->num_free; i++) {
+		INFO("  free extent = [0x%lx, 0x%lx]\n",
+		     (unsigned long) pool->free[i].base,
+		     (unsigned long) (pool->free[i].base + pool->free[i].size));
+	}
+#endif
+}
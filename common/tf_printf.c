@@ -31,6 +31,11 @@
 #include <stdarg.h>
 #include <stdint.h>
 
+#if RUNTIME_LOG_LEVEL
+/* Level of the log messages printed by this image */
+unsigned int tf_log_level = LOG_LEVEL_INIT;
+#endif
+
 /***********************************************************
  * The tf_printf implementation for all BL stages
  ***********************************************************/
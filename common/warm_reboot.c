@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl_common.h>
+#include <debug.h>
+#include <platform.h>
+#include <sha256_ce.h>
+#include <string.h>
+#include <warm_reboot.h>
+
+#if IMAGE_BL2
+/* Armed manifest left by the previous boot, if any */
+static warm_reboot_manifest_t prev_manifest;
+/* Whether each image of the previous manifest can be used in place */
+static unsigned char prev_resident[WARM_REBOOT_MAX_IMAGES];
+/* Manifest of the images of this boot */
+static warm_reboot_manifest_t next_manifest;
+/* The manifests are only used if the CPU implements the SHA-256 instructions */
+static int warm_reboot_enabled;
+
+static void manifest_digest(const warm_reboot_manifest_t *manifest,
+			    unsigned char digest[SHA256_CE_DIGEST_SIZE])
+{
+	warm_reboot_manifest_t copy = *manifest;
+
+	copy.state = 0;
+	sha256_ce((const unsigned char *)&copy,
+		  __builtin_offsetof(warm_reboot_manifest_t, digest), digest);
+}
+
+static int prev_image_index(unsigned int image_id)
+{
+	unsigned int i;
+
+	for (i = 0; i < prev_manifest.num_images; i++) {
+		if (prev_manifest.images[i].image_id == image_id)
+			return i;
+	}
+
+	return -1;
+}
+
+/*******************************************************************************
+ * Read the manifest left by the previous boot and invalidate it, so that it is
+ * used at most once. The manifest is only kept if it has been armed by BL31 and
+ * is intact. Must be called on the primary CPU before any image is loaded.
+ ******************************************************************************/
+void warm_reboot_init(void)
+{
+	warm_reboot_manifest_t *manifest = plat_get_warm_reboot_manifest();
+	unsigned char digest[SHA256_CE_DIGEST_SIZE];
+
+	assert(manifest != NULL);
+
+	if (!sha256_ce_supported()) {
+		WARN("BL2: Fast warm reboot needs the SHA-256 instructions\n");
+		return;
+	}
+	warm_reboot_enabled = 1;
+
+	memcpy(&prev_manifest, manifest, sizeof(prev_manifest));
+	manifest->magic = 0;
+	flush_dcache_range((uintptr_t)manifest, sizeof(*manifest));
+
+	if ((prev_manifest.magic != WARM_REBOOT_MAGIC) ||
+	    (prev_manifest.state != WARM_REBOOT_ARMED) ||
+	    (prev_manifest.num_images > WARM_REBOOT_MAX_IMAGES))
+		goto discard;
+
+	manifest_digest(&prev_manifest, digest);
+	if (memcmp(digest, prev_manifest.digest, sizeof(digest)) != 0) {
+		WARN("BL2: Warm reboot manifest is corrupted\n");
+		goto discard;
+	}
+
+	return;
+
+discard:
+	prev_manifest.num_images = 0;
+}
+
+/*******************************************************************************
+ * Check whether an image of the previous manifest can be used in place: it must
+ * be recorded at 'image_base', within 'mem_layout', the image in the storage
+ * device must have the recorded size and the copy in memory the recorded
+ * digest. Must be called on the primary CPU, before the memory of the image
+ * may be written by any other image.
+ ******************************************************************************/
+void warm_reboot_check(unsigned int image_id,
+		       const meminfo_t *mem_layout, uintptr_t image_base)
+{
+	const warm_reboot_image_t *image;
+	unsigned char digest[SHA256_CE_DIGEST_SIZE];
+	int i;
+
+	i = prev_image_index(image_id);
+	if (i < 0)
+		return;
+	image = &prev_manifest.images[i];
+
+	if ((image->base != image_base) ||
+	    (image->base < mem_layout->total_base) ||
+	    (image->size > mem_layout->total_size) ||
+	    (image->base - mem_layout->total_base >
+	     mem_layout->total_size - image->size))
+		return;
+
+	if (image_size(image_id) != image->stored_size) {
+		INFO("BL2: Image id=%u has changed since the last boot\n",
+		     image_id);
+		return;
+	}
+
+	sha256_ce((const unsigned char *)image->base, image->size, digest);
+	if (memcmp(digest, image->sha256, sizeof(digest)) != 0) {
+		INFO("BL2: Image id=%u is no longer resident\n", image_id);
+		return;
+	}
+
+	prev_resident[i] = 1;
+}
+
+/*******************************************************************************
+ * Use an image in place if warm_reboot_check() has found it resident, filling
+ * its image and entry point information as load_auth_image() would. May be
+ * called on any CPU. Return 0 on success, -ENOENT if the image must be loaded.
+ ******************************************************************************/
+int warm_reboot_reuse(unsigned int image_id, image_info_t *image_data,
+		      entry_point_info_t *entry_point_info)
+{
+	const warm_reboot_image_t *image;
+	int i;
+
+	i = prev_image_index(image_id);
+	if ((i < 0) || !prev_resident[i])
+		return -ENOENT;
+	image = &prev_manifest.images[i];
+
+	image_data->h.attr &= ~IMAGE_ATTR_IN_PLACE;
+	image_data->image_base = image->base;
+	image_data->image_size = image->size;
+	if (entry_point_info != NULL)
+		entry_point_info->pc = image->base;
+
+	INFO("BL2: Image id=%u reused at %p (%u bytes)\n", image_id,
+	     (void *)image->base, image->size);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Record an image loaded or reused by this boot in the next manifest. Images
+ * used in place in the storage device are not recorded.
+ ******************************************************************************/
+void warm_reboot_record(unsigned int image_id, const image_info_t *image_data)
+{
+	warm_reboot_image_t *image;
+	int i;
+
+	if (!warm_reboot_enabled ||
+	    (image_data->h.attr & IMAGE_ATTR_IN_PLACE) ||
+	    (next_manifest.num_images == WARM_REBOOT_MAX_IMAGES))
+		return;
+
+	image = &next_manifest.images[next_manifest.num_images];
+	image->image_id = image_id;
+	image->size = image_data->image_size;
+	image->base = image_data->image_base;
+	image->stored_size = image_size(image_id);
+	if (image->stored_size == 0)
+		return;
+
+	/* An image used in place has already been hashed */
+	i = prev_image_index(image_id);
+	if ((i >= 0) && prev_resident[i])
+		memcpy(image->sha256, prev_manifest.images[i].sha256,
+		       sizeof(image->sha256));
+	else
+		sha256_ce((const unsigned char *)image->base, image->size,
+			  image->sha256);
+
+	next_manifest.num_images++;
+}
+
+/*******************************************************************************
+ * Hand the next manifest over to the platform. BL31 arms it if the system is
+ * reset through PSCI.
+ ******************************************************************************/
+void warm_reboot_seal(void)
+{
+	warm_reboot_manifest_t *manifest;
+
+	if (!warm_reboot_enabled || (next_manifest.num_images == 0))
+		return;
+
+	next_manifest.magic = WARM_REBOOT_MAGIC;
+	next_manifest.state = WARM_REBOOT_RECORDED;
+	manifest_digest(&next_manifest, next_manifest.digest);
+
+	manifest = plat_get_warm_reboot_manifest();
+	memcpy(manifest, &next_manifest, sizeof(*manifest));
+	flush_dcache_range((uintptr_t)manifest, sizeof(*manifest));
+}
+#endif /* IMAGE_BL2 */
+
+#if IMAGE_BL31
+/*******************************************************************************
+ * Arm the manifest recorded by BL2 before a system reset, so that the next boot
+ * may reuse the images it lists. The state is not covered by the digest of the
+ * manifest, so no hashing is needed here.
+ ******************************************************************************/
+void warm_reboot_arm(void)
+{
+	warm_reboot_manifest_t *manifest = plat_get_warm_reboot_manifest();
+
+	assert(manifest != NULL);
+
+	if ((manifest->magic != WARM_REBOOT_MAGIC) ||
+	    (manifest->state != WARM_REBOOT_RECORDED))
+		return;
+
+	manifest->state = WARM_REBOOT_ARMED;
+	flush_dcache_range((uintptr_t)&manifest->state,
+			   sizeof(manifest->state));
+}
+#endif /* IMAGE_BL31 */
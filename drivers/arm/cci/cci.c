@@ -94,7 +94,13 @@ void cci_init(uintptr_t cci_base,
 	g_cci_slave_if_map = map;
 }
 
-void cci_enable_snoop_dvm_reqs(unsigned int master_id)
+/*
+ * Request the snoops and DVM messages to be enabled for 'master_id' without
+ * waiting for the change to take effect. cci_wait_snoop_dvm_reqs() must be
+ * called before the master relies on being coherent, which leaves the caller
+ * free to do other work in the meantime.
+ */
+void cci_enable_snoop_dvm_reqs_async(unsigned int master_id)
 {
 	int slave_if_id;
 
@@ -111,12 +117,27 @@ void cci_enable_snoop_dvm_reqs(unsigned int master_id)
 	mmio_write_32(g_cci_base +
 		      SLAVE_IFACE_OFFSET(slave_if_id) +
 		      SNOOP_CTRL_REG, DVM_EN_BIT | SNOOP_EN_BIT);
+}
+
+/*
+ * Wait until the CCI has applied the pending changes of the snoop control
+ * registers.
+ */
+void cci_wait_snoop_dvm_reqs(void)
+{
+	assert(g_cci_base);
 
 	/* Wait for the dust to settle down */
 	while (mmio_read_32(g_cci_base + STATUS_REG) & CHANGE_PENDING_BIT)
 		;
 }
 
+void cci_enable_snoop_dvm_reqs(unsigned int master_id)
+{
+	cci_enable_snoop_dvm_reqs_async(master_id);
+	cci_wait_snoop_dvm_reqs();
+}
+
 void cci_disable_snoop_dvm_reqs(unsigned int master_id)
 {
 	int slave_if_id;
@@ -135,8 +156,6 @@ void cci_disable_snoop_dvm_reqs(unsigned int master_id)
 		      SLAVE_IFACE_OFFSET(slave_if_id) +
 		      SNOOP_CTRL_REG, ~(DVM_EN_BIT | SNOOP_EN_BIT));
 
-	/* Wait for the dust to settle down */
-	while (mmio_read_32(g_cci_base + STATUS_REG) & CHANGE_PENDING_BIT)
-		;
+	cci_wait_snoop_dvm_reqs();
 }
 
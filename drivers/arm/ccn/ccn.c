@@ -38,6 +38,17 @@
 #include "ccn_private.h"
 
 static const ccn_desc_t *ccn_plat_desc;
+
+/*
+ * Bit maps of the Request node ID each master interface resides on, and of the
+ * present HN-F and MN nodes. They are computed once in ccn_init() so that the
+ * snoop/DVM domain operations do not have to walk the platform's description
+ * or read the MN registers on every call.
+ */
+static unsigned long long ccn_master_rn_id_map[CCN_MAX_RN_MASTERS];
+static unsigned long long ccn_hnf_id_map;
+static unsigned long long ccn_mn_id_map;
+
 #if IMAGE_BL31
 DEFINE_BAKERY_LOCK(ccn_lock);
 #endif
@@ -234,11 +245,21 @@ static void ccn_validate_plat_params(const ccn_desc_t *plat_desc)
  ******************************************************************************/
 void ccn_init(const ccn_desc_t *plat_desc)
 {
+	unsigned int master_id;
+
 #if DEBUG
 	ccn_validate_plat_params(plat_desc);
 #endif
 
 	ccn_plat_desc = plat_desc;
+
+	for (master_id = 0; master_id < plat_desc->num_masters; master_id++)
+		ccn_master_rn_id_map[master_id] =
+			1ULL << plat_desc->master_to_rn_id_map[master_id];
+
+	ccn_hnf_id_map = CCN_GET_HN_NODEID_MAP(plat_desc->periphbase,
+					       MN_HNF_NODEID_OFFSET);
+	ccn_mn_id_map = CCN_GET_MN_NODEID_MAP(plat_desc->periphbase);
 }
 
 /*******************************************************************************
@@ -248,62 +269,93 @@ void ccn_init(const ccn_desc_t *plat_desc)
 static unsigned long long ccn_master_to_rn_id_map(unsigned long long master_map)
 {
 	unsigned long long rn_id_map = 0;
-	unsigned int node_id, iface_id;
+	unsigned int iface_id;
 
 	assert(master_map);
 	assert(ccn_plat_desc);
 
 	FOR_EACH_PRESENT_MASTER_INTERFACE(iface_id, master_map) {
-
-		/* Convert the master ID into the node ID */
-		node_id = ccn_plat_desc->master_to_rn_id_map[iface_id];
-
-		/* Set the bit corresponding to this node ID */
-		rn_id_map |= (1UL << node_id);
+		assert(iface_id < ccn_plat_desc->num_masters);
+		rn_id_map |= ccn_master_rn_id_map[iface_id];
 	}
 
 	return rn_id_map;
 }
 
 /*******************************************************************************
- * This function executes the necessary operations to add or remove Request node
- * IDs specified in the 'rn_id_map' bitmap from the snoop/DVM domains specified
- * in the 'hn_id_map'. The 'region_id' specifies the ID of the first HN-F/MN
- * on which the operation should be performed. 'op_reg_offset' specifies the
- * type of operation (add/remove). 'stat_reg_offset' specifies the register
- * which should be polled to determine if the operation has completed or not.
+ * This function requests the Request node IDs specified in the 'rn_id_map'
+ * bitmap to be added to or removed from the snoop/DVM domains specified in the
+ * 'hn_id_map'. The 'region_id' specifies the ID of the first HN-F/MN on which
+ * the operation should be performed. 'op_reg_offset' specifies the type of
+ * operation (add/remove). It does not wait for the operation to complete.
  ******************************************************************************/
-static void ccn_snoop_dvm_do_op(unsigned long long rn_id_map,
-				unsigned long long hn_id_map,
-				unsigned int region_id,
-				unsigned int op_reg_offset,
-				unsigned int stat_reg_offset)
+static void ccn_snoop_dvm_issue_op(unsigned long long rn_id_map,
+				   unsigned long long hn_id_map,
+				   unsigned int region_id,
+				   unsigned int op_reg_offset)
 {
-	unsigned int start_region_id;
-
-	assert(ccn_plat_desc);
-	assert(ccn_plat_desc->periphbase);
-
-#if IMAGE_BL31
-	bakery_lock_get(&ccn_lock);
-#endif
-	start_region_id = region_id;
-	FOR_EACH_PRESENT_REGION_ID(start_region_id, hn_id_map) {
+	FOR_EACH_PRESENT_REGION_ID(region_id, hn_id_map) {
 		ccn_reg_write(ccn_plat_desc->periphbase,
-			      start_region_id,
+			      region_id,
 			      op_reg_offset,
 			      rn_id_map);
 	}
+}
 
-	start_region_id = region_id;
-
-	FOR_EACH_PRESENT_REGION_ID(start_region_id, hn_id_map) {
-		WAIT_FOR_DOMAIN_CTRL_OP_COMPLETION(start_region_id,
+/*******************************************************************************
+ * This function waits for an operation issued by ccn_snoop_dvm_issue_op() with
+ * the same parameters to complete. 'stat_reg_offset' specifies the register
+ * which should be polled to determine if the operation has completed or not.
+ ******************************************************************************/
+static void ccn_snoop_dvm_wait_op(unsigned long long rn_id_map,
+				  unsigned long long hn_id_map,
+				  unsigned int region_id,
+				  unsigned int op_reg_offset,
+				  unsigned int stat_reg_offset)
+{
+	FOR_EACH_PRESENT_REGION_ID(region_id, hn_id_map) {
+		WAIT_FOR_DOMAIN_CTRL_OP_COMPLETION(region_id,
 						   stat_reg_offset,
 						   op_reg_offset,
 						   rn_id_map);
 	}
+}
 
+/*******************************************************************************
+ * This function adds or removes the master interfaces in 'master_iface_map'
+ * to/from the DVM domain and, if 'snoop' is set, the snoop domain as well. The
+ * writes to every HN-F and to the MN are issued before any of them is polled
+ * so that the nodes carry out the operation in parallel. 'snoop_op_offset' and
+ * 'dvm_op_offset' select the SET or CLR registers.
+ ******************************************************************************/
+static void ccn_snoop_dvm_do_op(unsigned long long master_iface_map,
+				int snoop,
+				unsigned int snoop_op_offset,
+				unsigned int dvm_op_offset)
+{
+	unsigned long long rn_id_map;
+
+	assert(ccn_plat_desc);
+	assert(ccn_plat_desc->periphbase);
+
+	rn_id_map = ccn_master_to_rn_id_map(master_iface_map);
+
+#if IMAGE_BL31
+	bakery_lock_get(&ccn_lock);
+#endif
+	if (snoop)
+		ccn_snoop_dvm_issue_op(rn_id_map, ccn_hnf_id_map,
+				       HNF_REGION_ID_START, snoop_op_offset);
+	ccn_snoop_dvm_issue_op(rn_id_map, ccn_mn_id_map,
+			       MN_REGION_ID, dvm_op_offset);
+
+	if (snoop)
+		ccn_snoop_dvm_wait_op(rn_id_map, ccn_hnf_id_map,
+				      HNF_REGION_ID_START, snoop_op_offset,
+				      HNF_SDC_STAT_OFFSET);
+	ccn_snoop_dvm_wait_op(rn_id_map, ccn_mn_id_map,
+			      MN_REGION_ID, dvm_op_offset,
+			      MN_DDC_STAT_OFFSET);
 #if IMAGE_BL31
 	bakery_lock_release(&ccn_lock);
 #endif
@@ -325,64 +377,24 @@ static void ccn_snoop_dvm_do_op(unsigned long long rn_id_map,
  ******************************************************************************/
 void ccn_enter_snoop_dvm_domain(unsigned long long master_iface_map)
 {
-	unsigned long long rn_id_map;
-
-	rn_id_map = ccn_master_to_rn_id_map(master_iface_map);
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_HN_NODEID_MAP(ccn_plat_desc->periphbase,
-						  MN_HNF_NODEID_OFFSET),
-			    HNF_REGION_ID_START,
-			    HNF_SDC_SET_OFFSET,
-			    HNF_SDC_STAT_OFFSET);
-
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_MN_NODEID_MAP(ccn_plat_desc->periphbase),
-			    MN_REGION_ID,
-			    MN_DDC_SET_OFFSET,
-			    MN_DDC_STAT_OFFSET);
+	ccn_snoop_dvm_do_op(master_iface_map, 1,
+			    HNF_SDC_SET_OFFSET, MN_DDC_SET_OFFSET);
 }
 
 void ccn_exit_snoop_dvm_domain(unsigned long long master_iface_map)
 {
-	unsigned long long rn_id_map;
-
-	rn_id_map = ccn_master_to_rn_id_map(master_iface_map);
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_HN_NODEID_MAP(ccn_plat_desc->periphbase,
-						  MN_HNF_NODEID_OFFSET),
-			    HNF_REGION_ID_START,
-			    HNF_SDC_CLR_OFFSET,
-			    HNF_SDC_STAT_OFFSET);
-
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_MN_NODEID_MAP(ccn_plat_desc->periphbase),
-			    MN_REGION_ID,
-			    MN_DDC_CLR_OFFSET,
-			    MN_DDC_STAT_OFFSET);
+	ccn_snoop_dvm_do_op(master_iface_map, 1,
+			    HNF_SDC_CLR_OFFSET, MN_DDC_CLR_OFFSET);
 }
 
 void ccn_enter_dvm_domain(unsigned long long master_iface_map)
 {
-	unsigned long long rn_id_map;
-
-	rn_id_map = ccn_master_to_rn_id_map(master_iface_map);
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_MN_NODEID_MAP(ccn_plat_desc->periphbase),
-			    MN_REGION_ID,
-			    MN_DDC_SET_OFFSET,
-			    MN_DDC_STAT_OFFSET);
+	ccn_snoop_dvm_do_op(master_iface_map, 0, 0, MN_DDC_SET_OFFSET);
 }
 
 void ccn_exit_dvm_domain(unsigned long long master_iface_map)
 {
-	unsigned long long rn_id_map;
-
-	rn_id_map = ccn_master_to_rn_id_map(master_iface_map);
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_MN_NODEID_MAP(ccn_plat_desc->periphbase),
-			    MN_REGION_ID,
-			    MN_DDC_CLR_OFFSET,
-			    MN_DDC_STAT_OFFSET);
+	ccn_snoop_dvm_do_op(master_iface_map, 0, 0, MN_DDC_CLR_OFFSET);
 }
 
 /*******************************************************************************
@@ -96,6 +96,52 @@ void gicv2_pcpu_distif_init(void)
 					driver_data->g0_interrupt_array);
 }
 
+/*******************************************************************************
+ * Save the banked distributor registers of the calling cpu, before it is
+ * powered down, in the context pointed to by `ctx`.
+ ******************************************************************************/
+void gicv2_save_pcpu_distif(gicv2_pcpu_ctx_t *ctx)
+{
+	unsigned int index;
+
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert(ctx);
+
+	ctx->igroupr0 = gicd_read_igroupr(driver_data->gicd_base, 0);
+	ctx->isenabler0 = gicd_read_isenabler(driver_data->gicd_base, 0);
+
+	for (index = 0; index < GICV2_PCPU_IPRIORITYR_NUM; index++)
+		ctx->ipriorityr[index] =
+			gicd_read_ipriorityr(driver_data->gicd_base,
+					     index << 2);
+}
+
+/*******************************************************************************
+ * Restore the banked distributor registers of the calling cpu from the context
+ * saved by gicv2_save_pcpu_distif(). This can replace gicv2_pcpu_distif_init()
+ * when the cpu is powered up again, as it programs the same registers without
+ * walking the list of Group 0 interrupts.
+ ******************************************************************************/
+void gicv2_restore_pcpu_distif(const gicv2_pcpu_ctx_t *ctx)
+{
+	unsigned int index;
+
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert(ctx);
+
+	/* As in gicv2_secure_ppi_sgi_setup(), disable the SGIs/PPIs first */
+	gicd_write_icenabler(driver_data->gicd_base, 0, ~0);
+
+	for (index = 0; index < GICV2_PCPU_IPRIORITYR_NUM; index++)
+		gicd_write_ipriorityr(driver_data->gicd_base, index << 2,
+				      ctx->ipriorityr[index]);
+
+	gicd_write_igroupr(driver_data->gicd_base, 0, ctx->igroupr0);
+	gicd_write_isenabler(driver_data->gicd_base, 0, ctx->isenabler0);
+}
+
 /*******************************************************************************
  * Global gic distributor init which will be done by the primary cpu after a
  * cold boot. It marks out the secure SPIs, PPIs & SGIs and enables them. It
@@ -240,6 +286,56 @@ void gicv2_end_of_interrupt(unsigned int id)
 	gicc_write_EOIR(driver_data->gicc_base, id);
 }
 
+/*******************************************************************************
+ * This function sets the priority mask of the GIC cpu interface to 'mask' and
+ * returns the previous one. Only the interrupts of higher priority than the
+ * mask, i.e. of lower priority value, are signaled to the cpu.
+ ******************************************************************************/
+unsigned int gicv2_set_pmr(unsigned int mask)
+{
+	unsigned int old_mask;
+
+	assert(driver_data);
+	assert(driver_data->gicc_base);
+
+	old_mask = gicc_read_pmr(driver_data->gicc_base);
+
+	/*
+	 * Order the memory updates done with the previous mask before the
+	 * interrupts that the new mask may let through.
+	 */
+	dsbish();
+	gicc_write_pmr(driver_data->gicc_base, mask);
+
+	return old_mask;
+}
+
+/*******************************************************************************
+ * This function returns the running priority of the GIC cpu interface, which
+ * is GIC_PRI_MASK when no interrupt is active on the cpu. Only the interrupts
+ * of higher priority than the running priority are signaled to the cpu.
+ ******************************************************************************/
+unsigned int gicv2_get_running_priority(void)
+{
+	assert(driver_data);
+	assert(driver_data->gicc_base);
+
+	return gicc_read_rpr(driver_data->gicc_base) & GIC_PRI_MASK;
+}
+
+/*******************************************************************************
+ * This function targets the SPI 'id' at the calling cpu only.
+ ******************************************************************************/
+void gicv2_set_spi_target_self(unsigned int id)
+{
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert(id >= MIN_SPI_ID);
+
+	gicd_set_itargetsr(driver_data->gicd_base, id,
+			   gicv2_get_cpuif_id(driver_data->gicd_base));
+}
+
 /*******************************************************************************
  * This function returns the type of the interrupt id depending upon the group
  * this interrupt has been configured under by the interrupt controller i.e.
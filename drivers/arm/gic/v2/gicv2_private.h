@@ -46,6 +46,7 @@ void gicv2_secure_ppi_sgi_setup(uintptr_t gicd_base,
 					unsigned int num_ints,
 					const unsigned int *sec_intr_list);
 unsigned int gicv2_get_cpuif_id(uintptr_t base);
+void gicd_set_itargetsr(uintptr_t base, unsigned int id, unsigned int target);
 
 /*******************************************************************************
  * GIC Distributor interface accessors for reading entire registers
@@ -89,6 +90,11 @@ static inline unsigned int gicc_read_hppir(uintptr_t base)
 	return mmio_read_32(base + GICC_HPPIR);
 }
 
+static inline unsigned int gicc_read_rpr(uintptr_t base)
+{
+	return mmio_read_32(base + GICC_RPR);
+}
+
 static inline unsigned int gicc_read_ahppir(uintptr_t base)
 {
 	return mmio_read_32(base + GICC_AHPPIR);
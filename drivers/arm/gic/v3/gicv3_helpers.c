@@ -312,50 +312,88 @@ void gicv3_spis_configure_defaults(uintptr_t gicd_base)
 }
 
 /*******************************************************************************
- * Helper function to configure secure G0 and G1S SPIs.
+ * Helper function to configure as secure G0 or G1S and to enable the SPIs set
+ * in 'mask' within the block of 32 interrupts starting at 'id'. Each of the
+ * GICD registers involved is accessed only once for the whole block.
+ ******************************************************************************/
+static void gicv3_secure_spis_block_configure(uintptr_t gicd_base,
+					       unsigned int id,
+					       unsigned int mask,
+					       unsigned int int_grp)
+{
+	unsigned int reg_val;
+
+	if (!mask)
+		return;
+
+	/* Configure these interrupts as secure interrupts */
+	reg_val = gicd_read_igroupr(gicd_base, id);
+	gicd_write_igroupr(gicd_base, id, reg_val & ~mask);
+
+	/* Configure these interrupts as G0 or G1S interrupts */
+	reg_val = gicd_read_igrpmodr(gicd_base, id);
+	if (int_grp == INTR_GROUP1S)
+		reg_val |= mask;
+	else
+		reg_val &= ~mask;
+	gicd_write_igrpmodr(gicd_base, id, reg_val);
+
+	/* Enable these interrupts */
+	gicd_write_isenabler(gicd_base, id, mask);
+}
+
+/*******************************************************************************
+ * Helper function to configure secure G0 and G1S SPIs. The group, modifier and
+ * enable bits of the interrupts are accumulated for each block of 32 interrupts
+ * so that consecutive entries of `sec_intr_list` falling in the same block are
+ * configured with a single write to each register.
  ******************************************************************************/
 void gicv3_secure_spis_configure(uintptr_t gicd_base,
 				     unsigned int num_ints,
 				     const unsigned int *sec_intr_list,
 				     unsigned int int_grp)
 {
-	unsigned int index, irq_num;
+	unsigned int index, irq_num, bit_num;
+	unsigned int block_id = 0, block_mask = 0;
 	uint64_t gic_affinity_val;
 
 	assert((int_grp == INTR_GROUP1S) || (int_grp == INTR_GROUP0));
 	/* If `num_ints` is not 0, ensure that `sec_intr_list` is not NULL */
 	assert(num_ints ? (uintptr_t)sec_intr_list : 1);
 
+	/* Target SPIs to the primary CPU */
+	gic_affinity_val = gicd_irouter_val_from_mpidr(read_mpidr(), 0);
+
 	for (index = 0; index < num_ints; index++) {
 		irq_num = sec_intr_list[index];
 		if (irq_num >= MIN_SPI_ID) {
 
-			/* Configure this interrupt as a secure interrupt */
-			gicd_clr_igroupr(gicd_base, irq_num);
+			bit_num = irq_num & ((1 << IGROUPR_SHIFT) - 1);
 
-			/* Configure this interrupt as G0 or a G1S interrupt */
-			if (int_grp == INTR_GROUP1S)
-				gicd_set_igrpmodr(gicd_base, irq_num);
-			else
-				gicd_clr_igrpmodr(gicd_base, irq_num);
+			/* Configure the previous block if this one differs */
+			if (irq_num - bit_num != block_id) {
+				gicv3_secure_spis_block_configure(gicd_base,
+								  block_id,
+								  block_mask,
+								  int_grp);
+				block_id = irq_num - bit_num;
+				block_mask = 0;
+			}
+			block_mask |= 1 << bit_num;
 
 			/* Set the priority of this interrupt */
 			gicd_set_ipriorityr(gicd_base,
 					      irq_num,
 					      GIC_HIGHEST_SEC_PRIORITY);
 
-			/* Target SPIs to the primary CPU */
-			gic_affinity_val =
-				gicd_irouter_val_from_mpidr(read_mpidr(), 0);
 			gicd_write_irouter(gicd_base,
 					   irq_num,
 					   gic_affinity_val);
-
-			/* Enable this interrupt */
-			gicd_set_isenabler(gicd_base, irq_num);
 		}
 	}
 
+	gicv3_secure_spis_block_configure(gicd_base, block_id, block_mask,
+					  int_grp);
 }
 
 /*******************************************************************************
@@ -394,7 +432,7 @@ void gicv3_secure_ppi_sgi_configure(uintptr_t gicr_base,
 					const unsigned int *sec_intr_list,
 					unsigned int int_grp)
 {
-	unsigned int index, irq_num;
+	unsigned int index, irq_num, mask = 0, reg_val;
 
 	assert((int_grp == INTR_GROUP1S) || (int_grp == INTR_GROUP0));
 	/* If `num_ints` is not 0, ensure that `sec_intr_list` is not NULL */
@@ -403,23 +441,29 @@ void gicv3_secure_ppi_sgi_configure(uintptr_t gicr_base,
 	for (index = 0; index < num_ints; index++) {
 		irq_num = sec_intr_list[index];
 		if (irq_num < MIN_SPI_ID) {
-
-			/* Configure this interrupt as a secure interrupt */
-			gicr_clr_igroupr0(gicr_base, irq_num);
-
-			/* Configure this interrupt as G0 or a G1S interrupt */
-			if (int_grp == INTR_GROUP1S)
-				gicr_set_igrpmodr0(gicr_base, irq_num);
-			else
-				gicr_clr_igrpmodr0(gicr_base, irq_num);
+			mask |= 1 << irq_num;
 
 			/* Set the priority of this interrupt */
 			gicr_set_ipriorityr(gicr_base,
 					    irq_num,
 					    GIC_HIGHEST_SEC_PRIORITY);
-
-			/* Enable this interrupt */
-			gicr_set_isenabler0(gicr_base, irq_num);
 		}
 	}
+
+	if (!mask)
+		return;
+
+	/* Configure these interrupts as secure interrupts */
+	gicr_write_igroupr0(gicr_base, gicr_read_igroupr0(gicr_base) & ~mask);
+
+	/* Configure these interrupts as G0 or G1S interrupts */
+	reg_val = gicr_read_igrpmodr0(gicr_base);
+	if (int_grp == INTR_GROUP1S)
+		reg_val |= mask;
+	else
+		reg_val &= ~mask;
+	gicr_write_igrpmodr0(gicr_base, reg_val);
+
+	/* Enable these interrupts */
+	gicr_write_isenabler0(gicr_base, mask);
 }
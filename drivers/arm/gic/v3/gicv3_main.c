@@ -159,6 +159,22 @@ void gicv3_distif_init(void)
 		      RWP_TRUE);
 }
 
+/*******************************************************************************
+ * This function returns the base address of the Redistributor interface frame
+ * of the CPU identified by the 'proc_num' parameter, as detected during the
+ * initialisation of the driver. A platform may save it in its per-cpu data and
+ * later pass it to the *_by_base() variants of the Redistributor and CPU
+ * interface functions to avoid looking it up again.
+ ******************************************************************************/
+uintptr_t gicv3_rdistif_base(unsigned int proc_num)
+{
+	assert(driver_data);
+	assert(proc_num < driver_data->rdistif_num);
+	assert(driver_data->rdistif_base_addrs);
+
+	return driver_data->rdistif_base_addrs[proc_num];
+}
+
 /*******************************************************************************
  * This function initialises the GIC Redistributor interface of the calling CPU
  * (identified by the 'proc_num' parameter) based upon the data provided by the
@@ -166,11 +182,17 @@ void gicv3_distif_init(void)
  ******************************************************************************/
 void gicv3_rdistif_init(unsigned int proc_num)
 {
-	uintptr_t gicr_base;
+	gicv3_rdistif_init_by_base(gicv3_rdistif_base(proc_num));
+}
 
+/*******************************************************************************
+ * This function initialises the GIC Redistributor interface whose frame starts
+ * at 'gicr_base', which must be the one of the calling CPU.
+ ******************************************************************************/
+void gicv3_rdistif_init_by_base(uintptr_t gicr_base)
+{
 	assert(driver_data);
-	assert(proc_num < driver_data->rdistif_num);
-	assert(driver_data->rdistif_base_addrs);
+	assert(gicr_base);
 	assert(driver_data->gicd_base);
 	assert(gicd_read_ctlr(driver_data->gicd_base) & CTLR_ARE_S_BIT);
 	assert(driver_data->g1s_interrupt_array);
@@ -178,8 +200,6 @@ void gicv3_rdistif_init(unsigned int proc_num)
 
 	assert(IS_IN_EL3());
 
-	gicr_base = driver_data->rdistif_base_addrs[proc_num];
-
 	/* Set the default attribute of all SGIs and PPIs */
 	gicv3_ppi_sgi_configure_defaults(gicr_base);
 
@@ -202,17 +222,22 @@ void gicv3_rdistif_init(unsigned int proc_num)
  ******************************************************************************/
 void gicv3_cpuif_enable(unsigned int proc_num)
 {
-	uintptr_t gicr_base;
+	gicv3_cpuif_enable_by_base(gicv3_rdistif_base(proc_num));
+}
+
+/*******************************************************************************
+ * This function enables the GIC CPU interface of the calling CPU whose
+ * Redistributor interface frame starts at 'gicr_base'.
+ ******************************************************************************/
+void gicv3_cpuif_enable_by_base(uintptr_t gicr_base)
+{
 	unsigned int scr_el3;
 	unsigned int icc_sre_el3;
 
-	assert(driver_data);
-	assert(proc_num < driver_data->rdistif_num);
-	assert(driver_data->rdistif_base_addrs);
+	assert(gicr_base);
 	assert(IS_IN_EL3());
 
 	/* Mark the connected core as awake */
-	gicr_base = driver_data->rdistif_base_addrs[proc_num];
 	gicv3_rdistif_mark_core_awake(gicr_base);
 
 	/* Disable the legacy interrupt bypass */
@@ -264,12 +289,16 @@ void gicv3_cpuif_enable(unsigned int proc_num)
  ******************************************************************************/
 void gicv3_cpuif_disable(unsigned int proc_num)
 {
-	uintptr_t gicr_base;
-
-	assert(driver_data);
-	assert(proc_num < driver_data->rdistif_num);
-	assert(driver_data->rdistif_base_addrs);
+	gicv3_cpuif_disable_by_base(gicv3_rdistif_base(proc_num));
+}
 
+/*******************************************************************************
+ * This function disables the GIC CPU interface of the calling CPU whose
+ * Redistributor interface frame starts at 'gicr_base'.
+ ******************************************************************************/
+void gicv3_cpuif_disable_by_base(uintptr_t gicr_base)
+{
+	assert(gicr_base);
 	assert(IS_IN_EL3());
 
 	/* Disable legacy interrupt bypass */
@@ -288,7 +317,6 @@ void gicv3_cpuif_disable(unsigned int proc_num)
 	isb();
 
 	/* Mark the connected core as asleep */
-	gicr_base = driver_data->rdistif_base_addrs[proc_num];
 	gicv3_rdistif_mark_core_asleep(gicr_base);
 }
 
@@ -328,6 +356,28 @@ unsigned int gicv3_get_pending_interrupt_type(void)
 	return read_icc_hppir0_el1() & HPPIR0_EL1_INTID_MASK;
 }
 
+/*******************************************************************************
+ * This function sets the priority mask of the GIC cpu interface to 'mask' and
+ * returns the previous one. Only the interrupts of higher priority than the
+ * mask, i.e. of lower priority value, are signaled to the cpu.
+ ******************************************************************************/
+unsigned int gicv3_set_pmr(unsigned int mask)
+{
+	unsigned int old_mask;
+
+	assert(IS_IN_EL3());
+	old_mask = read_icc_pmr_el1();
+
+	/*
+	 * Order the memory updates done with the previous mask before the
+	 * interrupts that the new mask may let through.
+	 */
+	dsbish();
+	write_icc_pmr_el1(mask);
+
+	return old_mask;
+}
+
 /*******************************************************************************
  * This function returns the type of the interrupt id depending upon the group
  * this interrupt has been configured under by the interrupt controller i.e.
@@ -380,3 +430,225 @@ unsigned int gicv3_get_interrupt_type(unsigned int id,
 	/* Else it is a Group 0 Secure interrupt */
 	return INTR_GROUP0;
 }
+
+/*******************************************************************************
+ * This function returns the number of interrupt ids covered by the SPIs the
+ * Distributor implements, capped to the ids that a context can hold.
+ ******************************************************************************/
+static unsigned int gicv3_spis_num(uintptr_t gicd_base)
+{
+	unsigned int num_ints;
+
+	num_ints = gicd_read_typer(gicd_base);
+	num_ints &= TYPER_IT_LINES_NO_MASK;
+	num_ints = (num_ints + 1) << 5;
+
+	return (num_ints > MAX_SPI_ID + 1) ? MAX_SPI_ID + 1 : num_ints;
+}
+
+/*******************************************************************************
+ * This function saves the configuration and state of the SPIs and the GICD_CTLR
+ * of the Distributor in the 'dist_ctx' supplied by the platform. It is meant to
+ * be called by the last CPU to go down before the Distributor loses power.
+ ******************************************************************************/
+void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
+{
+	unsigned int id, num_ints;
+	uintptr_t gicd_base;
+
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert(dist_ctx);
+
+	assert(IS_IN_EL3());
+
+	gicd_base = driver_data->gicd_base;
+	num_ints = gicv3_spis_num(gicd_base);
+
+	/* Wait for any update of the GICD_CTLR to take effect */
+	gicd_wait_for_pending_write(gicd_base);
+	dist_ctx->gicd_ctlr = gicd_read_ctlr(gicd_base);
+
+	for (id = MIN_SPI_ID; id < num_ints; id += (1 << IGROUPR_SHIFT)) {
+		unsigned int n = (id - MIN_SPI_ID) >> IGROUPR_SHIFT;
+
+		dist_ctx->gicd_igroupr[n] = gicd_read_igroupr(gicd_base, id);
+		dist_ctx->gicd_isenabler[n] =
+			gicd_read_isenabler(gicd_base, id);
+		dist_ctx->gicd_ispendr[n] = gicd_read_ispendr(gicd_base, id);
+		dist_ctx->gicd_isactiver[n] =
+			gicd_read_isactiver(gicd_base, id);
+		dist_ctx->gicd_igrpmodr[n] = gicd_read_igrpmodr(gicd_base, id);
+	}
+
+	for (id = MIN_SPI_ID; id < num_ints; id += (1 << IPRIORITYR_SHIFT)) {
+		unsigned int n = (id - MIN_SPI_ID) >> IPRIORITYR_SHIFT;
+
+		dist_ctx->gicd_ipriorityr[n] =
+			gicd_read_ipriorityr(gicd_base, id);
+	}
+
+	for (id = MIN_SPI_ID; id < num_ints; id += (1 << ICFGR_SHIFT)) {
+		unsigned int n = (id - MIN_SPI_ID) >> ICFGR_SHIFT;
+
+		dist_ctx->gicd_icfgr[n] = gicd_read_icfgr(gicd_base, id);
+		dist_ctx->gicd_nsacr[n] = gicd_read_nsacr(gicd_base, id);
+	}
+
+	for (id = MIN_SPI_ID; id < num_ints; id++)
+		dist_ctx->gicd_irouter[id - MIN_SPI_ID] =
+			gicd_read_irouter(gicd_base, id);
+}
+
+/*******************************************************************************
+ * This function restores the Distributor from the 'dist_ctx' saved earlier by
+ * gicv3_distif_save() once it has been powered up again. It is meant to be
+ * called instead of gicv3_distif_init() by the first CPU to resume. The SPIs
+ * are enabled only once all their other attributes have been restored, and the
+ * Distributor is enabled last.
+ ******************************************************************************/
+void gicv3_distif_restore(const gicv3_dist_ctx_t * const dist_ctx)
+{
+	unsigned int id, num_ints;
+	uintptr_t gicd_base;
+
+	assert(driver_data);
+	assert(driver_data->gicd_base);
+	assert(dist_ctx);
+
+	assert(IS_IN_EL3());
+
+	gicd_base = driver_data->gicd_base;
+	num_ints = gicv3_spis_num(gicd_base);
+
+	/*
+	 * Clear the "enable" bits for G0/G1S/G1NS interrupts before configuring
+	 * the ARE_S bit. The Distributor might generate a system error
+	 * otherwise.
+	 */
+	gicd_clr_ctlr(gicd_base,
+		      CTLR_ENABLE_G0_BIT |
+		      CTLR_ENABLE_G1S_BIT |
+		      CTLR_ENABLE_G1NS_BIT,
+		      RWP_TRUE);
+
+	/* Set the ARE_S and ARE_NS bits now that interrupts are disabled */
+	gicd_set_ctlr(gicd_base, CTLR_ARE_S_BIT | CTLR_ARE_NS_BIT, RWP_TRUE);
+
+	for (id = MIN_SPI_ID; id < num_ints; id += (1 << IGROUPR_SHIFT)) {
+		unsigned int n = (id - MIN_SPI_ID) >> IGROUPR_SHIFT;
+
+		gicd_write_igroupr(gicd_base, id, dist_ctx->gicd_igroupr[n]);
+		gicd_write_igrpmodr(gicd_base, id, dist_ctx->gicd_igrpmodr[n]);
+	}
+
+	for (id = MIN_SPI_ID; id < num_ints; id += (1 << IPRIORITYR_SHIFT)) {
+		unsigned int n = (id - MIN_SPI_ID) >> IPRIORITYR_SHIFT;
+
+		gicd_write_ipriorityr(gicd_base, id,
+				      dist_ctx->gicd_ipriorityr[n]);
+	}
+
+	for (id = MIN_SPI_ID; id < num_ints; id += (1 << ICFGR_SHIFT)) {
+		unsigned int n = (id - MIN_SPI_ID) >> ICFGR_SHIFT;
+
+		gicd_write_icfgr(gicd_base, id, dist_ctx->gicd_icfgr[n]);
+		gicd_write_nsacr(gicd_base, id, dist_ctx->gicd_nsacr[n]);
+	}
+
+	for (id = MIN_SPI_ID; id < num_ints; id++)
+		gicd_write_irouter(gicd_base, id,
+				   dist_ctx->gicd_irouter[id - MIN_SPI_ID]);
+
+	/* Restore the pending, active and enabled states last */
+	for (id = MIN_SPI_ID; id < num_ints; id += (1 << ISENABLER_SHIFT)) {
+		unsigned int n = (id - MIN_SPI_ID) >> ISENABLER_SHIFT;
+
+		gicd_write_ispendr(gicd_base, id, dist_ctx->gicd_ispendr[n]);
+		gicd_write_isactiver(gicd_base, id,
+				     dist_ctx->gicd_isactiver[n]);
+		gicd_write_isenabler(gicd_base, id,
+				     dist_ctx->gicd_isenabler[n]);
+	}
+
+	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr);
+	gicd_wait_for_pending_write(gicd_base);
+}
+
+/*******************************************************************************
+ * This function saves the configuration and state of the SGIs and PPIs of the
+ * Redistributor of the CPU identified by 'proc_num' in the 'rdist_ctx'
+ * supplied by the platform, before the Redistributor loses power.
+ ******************************************************************************/
+void gicv3_rdistif_save(unsigned int proc_num,
+			gicv3_redist_ctx_t * const rdist_ctx)
+{
+	unsigned int id;
+	uintptr_t gicr_base;
+
+	assert(driver_data);
+	assert(proc_num < driver_data->rdistif_num);
+	assert(driver_data->rdistif_base_addrs);
+	assert(rdist_ctx);
+
+	assert(IS_IN_EL3());
+
+	gicr_base = driver_data->rdistif_base_addrs[proc_num];
+
+	rdist_ctx->gicr_igroupr0 = gicr_read_igroupr0(gicr_base);
+	rdist_ctx->gicr_isenabler0 = gicr_read_isenabler0(gicr_base);
+	rdist_ctx->gicr_ispendr0 = gicr_read_ispendr0(gicr_base);
+	rdist_ctx->gicr_isactiver0 = gicr_read_isactiver0(gicr_base);
+	rdist_ctx->gicr_icfgr0 = gicr_read_icfgr0(gicr_base);
+	rdist_ctx->gicr_icfgr1 = gicr_read_icfgr1(gicr_base);
+	rdist_ctx->gicr_igrpmodr0 = gicr_read_igrpmodr0(gicr_base);
+	rdist_ctx->gicr_nsacr = gicr_read_nsacr(gicr_base);
+
+	for (id = 0; id < TOTAL_PCPU_INTR_NUM; id += (1 << IPRIORITYR_SHIFT))
+		rdist_ctx->gicr_ipriorityr[id >> IPRIORITYR_SHIFT] =
+			gicr_read_ipriorityr(gicr_base, id);
+}
+
+/*******************************************************************************
+ * This function restores the Redistributor of the CPU identified by 'proc_num'
+ * from the 'rdist_ctx' saved earlier by gicv3_rdistif_save(). It is meant to be
+ * called instead of gicv3_rdistif_init() when the CPU resumes.
+ ******************************************************************************/
+void gicv3_rdistif_restore(unsigned int proc_num,
+			   const gicv3_redist_ctx_t * const rdist_ctx)
+{
+	unsigned int id;
+	uintptr_t gicr_base;
+
+	assert(driver_data);
+	assert(proc_num < driver_data->rdistif_num);
+	assert(driver_data->rdistif_base_addrs);
+	assert(driver_data->gicd_base);
+	assert(gicd_read_ctlr(driver_data->gicd_base) & CTLR_ARE_S_BIT);
+	assert(rdist_ctx);
+
+	assert(IS_IN_EL3());
+
+	gicr_base = driver_data->rdistif_base_addrs[proc_num];
+
+	/* Disable all SGIs/PPIs while they are being configured */
+	gicr_write_icenabler0(gicr_base, ~0);
+	gicr_wait_for_pending_write(gicr_base);
+
+	gicr_write_igroupr0(gicr_base, rdist_ctx->gicr_igroupr0);
+	gicr_write_igrpmodr0(gicr_base, rdist_ctx->gicr_igrpmodr0);
+
+	for (id = 0; id < TOTAL_PCPU_INTR_NUM; id += (1 << IPRIORITYR_SHIFT))
+		gicr_write_ipriorityr(gicr_base, id,
+			rdist_ctx->gicr_ipriorityr[id >> IPRIORITYR_SHIFT]);
+
+	gicr_write_icfgr0(gicr_base, rdist_ctx->gicr_icfgr0);
+	gicr_write_icfgr1(gicr_base, rdist_ctx->gicr_icfgr1);
+	gicr_write_nsacr(gicr_base, rdist_ctx->gicr_nsacr);
+
+	/* Restore the pending, active and enabled states last */
+	gicr_write_ispendr0(gicr_base, rdist_ctx->gicr_ispendr0);
+	gicr_write_isactiver0(gicr_base, rdist_ctx->gicr_isactiver0);
+	gicr_write_isenabler0(gicr_base, rdist_ctx->gicr_isenabler0);
+	gicr_wait_for_pending_write(gicr_base);
+}
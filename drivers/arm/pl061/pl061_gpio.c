@@ -58,6 +58,10 @@ static int pl061_get_direction(int gpio);
 static void pl061_set_direction(int gpio, int direction);
 static int pl061_get_value(int gpio);
 static void pl061_set_value(int gpio, int value);
+static void pl061_set_directions(int gpio, unsigned int mask,
+				 unsigned int directions);
+static unsigned int pl061_get_values(int gpio, unsigned int mask);
+static void pl061_set_values(int gpio, unsigned int mask, unsigned int values);
 
 static uintptr_t pl061_reg_base[MAX_GPIO_DEVICES];
 
@@ -66,6 +70,9 @@ static const gpio_ops_t pl061_gpio_ops = {
 	.set_direction	= pl061_set_direction,
 	.get_value	= pl061_get_value,
 	.set_value	= pl061_set_value,
+	.set_directions	= pl061_set_directions,
+	.get_values	= pl061_get_values,
+	.set_values	= pl061_set_values,
 };
 
 static int pl061_get_direction(int gpio)
@@ -143,6 +150,97 @@ static void pl061_set_value(int gpio, int value)
 		mmio_write_8(base_addr + BIT(offset + 2), 0);
 }
 
+/*
+ * The operations on several GPIOs access each PL061 once for all the GPIOs of
+ * the mask it controls. 'mask' selects the GPIOs from 'gpio' onwards, the
+ * first controller handles the bits up to the end of its 8 GPIOs, the next
+ * one the following 8 bits, and so on.
+ */
+static void pl061_check_mask(int gpio, unsigned int mask)
+{
+	assert(gpio >= 0);
+	assert((mask == 0) ||
+	       (gpio + 32 - __builtin_clz(mask) <= PLAT_PL061_MAX_GPIOS));
+}
+
+static void pl061_set_directions(int gpio, unsigned int mask,
+				 unsigned int directions)
+{
+	uintptr_t base_addr;
+	unsigned int data, dev_mask, offset;
+
+	pl061_check_mask(gpio, mask);
+
+	while (mask != 0) {
+		base_addr = pl061_reg_base[gpio / GPIOS_PER_PL061];
+		offset = gpio % GPIOS_PER_PL061;
+		dev_mask = (mask << offset) & 0xff;
+		if (dev_mask != 0) {
+			/* A bit set in GPIODIR configures an output */
+			data = mmio_read_8(base_addr + PL061_GPIO_DIR);
+			data &= ~dev_mask;
+			data |= ~(directions << offset) & dev_mask;
+			mmio_write_8(base_addr + PL061_GPIO_DIR, data);
+		}
+
+		offset = GPIOS_PER_PL061 - offset;
+		gpio += offset;
+		mask >>= offset;
+		directions >>= offset;
+	}
+}
+
+/*
+ * With the address mask of GPIODATA set to the GPIOs of the mask, a single
+ * read returns their values and a single write changes them, leaving the other
+ * GPIOs of the controller unchanged.
+ */
+static unsigned int pl061_get_values(int gpio, unsigned int mask)
+{
+	uintptr_t base_addr;
+	unsigned int dev_mask, offset, shift = 0, values = 0;
+
+	pl061_check_mask(gpio, mask);
+
+	while (mask != 0) {
+		base_addr = pl061_reg_base[gpio / GPIOS_PER_PL061];
+		offset = gpio % GPIOS_PER_PL061;
+		dev_mask = (mask << offset) & 0xff;
+		if (dev_mask != 0)
+			values |= (mmio_read_8(base_addr + (dev_mask << 2)) >>
+				   offset) << shift;
+
+		offset = GPIOS_PER_PL061 - offset;
+		gpio += offset;
+		mask >>= offset;
+		shift += offset;
+	}
+
+	return values;
+}
+
+static void pl061_set_values(int gpio, unsigned int mask, unsigned int values)
+{
+	uintptr_t base_addr;
+	unsigned int dev_mask, offset;
+
+	pl061_check_mask(gpio, mask);
+
+	while (mask != 0) {
+		base_addr = pl061_reg_base[gpio / GPIOS_PER_PL061];
+		offset = gpio % GPIOS_PER_PL061;
+		dev_mask = (mask << offset) & 0xff;
+		if (dev_mask != 0)
+			mmio_write_8(base_addr + (dev_mask << 2),
+				     (values << offset) & dev_mask);
+
+		offset = GPIOS_PER_PL061 - offset;
+		gpio += offset;
+		mask >>= offset;
+		values >>= offset;
+	}
+}
+
 
 /*
  * Register the PL061 GPIO controller with a base address and the offset
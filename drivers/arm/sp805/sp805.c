@@ -44,6 +44,11 @@ static inline void sp805_write_wdog_ctrl(uintptr_t base, unsigned long value)
 	mmio_write_32(base + SP805_WDOG_CTR_OFF, value);
 }
 
+static inline void sp805_write_wdog_intclr(uintptr_t base)
+{
+	mmio_write_32(base + SP805_WDOG_INTCLR_OFF, 0);
+}
+
 static inline void sp805_write_wdog_lock(uintptr_t base, unsigned long value)
 {
 	mmio_write_32(base + SP805_WDOG_LOCK_OFF, value);
@@ -72,3 +77,15 @@ void sp805_refresh(uintptr_t base, unsigned long ticks)
 	sp805_write_wdog_load(base, ticks);
 	sp805_write_wdog_lock(base, 0);
 }
+
+/*
+ * Clear the interrupt raised when the counter reached zero for the first time,
+ * which also reloads the counter. Unless the interrupt is cleared, the watchdog
+ * resets the system when the counter reaches zero again.
+ */
+void sp805_clear_interrupt(uintptr_t base)
+{
+	sp805_write_wdog_lock(base, WDOG_UNLOCK_KEY);
+	sp805_write_wdog_intclr(base);
+	sp805_write_wdog_lock(base, 0);
+}
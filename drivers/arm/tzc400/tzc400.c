@@ -65,6 +65,11 @@ static inline void tzc_write_gate_keeper(uintptr_t base, uint32_t val)
 	mmio_write_32(base + GATE_KEEPER_OFF, val);
 }
 
+static inline uint32_t tzc_read_action(uintptr_t base)
+{
+	return mmio_read_32(base + ACTION_OFF);
+}
+
 static inline void tzc_write_action(uintptr_t base, tzc_action_t action)
 {
 	mmio_write_32(base + ACTION_OFF, action);
@@ -139,6 +144,21 @@ static uint32_t tzc_get_gate_keeper(uintptr_t base, uint8_t filter)
 	return (tmp >> filter) & GATE_KEEPER_FILTER_MASK;
 }
 
+/*
+ * Request the filters in the 'filters' bitmap to be open and all others to be
+ * closed, then wait until the TZC reports that state. This function is not MP
+ * safe.
+ */
+static void tzc_write_gate_keeper_sync(uintptr_t base, uint32_t filters)
+{
+	tzc_write_gate_keeper(base, (filters & GATE_KEEPER_OR_MASK) <<
+			      GATE_KEEPER_OR_SHIFT);
+
+	while (((tzc_read_gate_keeper(base) >> GATE_KEEPER_OS_SHIFT) &
+		GATE_KEEPER_OS_MASK) != (filters & GATE_KEEPER_OS_MASK))
+		;
+}
+
 /* This function is not MP safe. */
 static void tzc_set_gate_keeper(uintptr_t base, uint8_t filter, uint32_t val)
 {
@@ -153,13 +173,8 @@ static void tzc_set_gate_keeper(uintptr_t base, uint8_t filter, uint32_t val)
 	else
 		tmp &= ~(1 << filter);
 
-	tzc_write_gate_keeper(base, (tmp & GATE_KEEPER_OR_MASK) <<
-			      GATE_KEEPER_OR_SHIFT);
-
 	/* Wait here until we see the change reflected in the TZC status. */
-	while (((tzc_read_gate_keeper(base) >> GATE_KEEPER_OS_SHIFT) &
-		GATE_KEEPER_OS_MASK) != tmp)
-	  ;
+	tzc_write_gate_keeper_sync(base, tmp);
 }
 
 
@@ -285,6 +300,27 @@ void tzc_configure_region(uint32_t filters,
 	tzc_write_region_id_access(tzc.base, region, ns_device_access);
 }
 
+/*
+ * `tzc_configure_regions` programs a list of regions in one pass. It is meant
+ * to be called once, between tzc_disable_filters() and tzc_enable_filters(),
+ * instead of calling tzc_configure_region() for each region.
+ */
+void tzc_configure_regions(const tzc_region_t *regions,
+			   unsigned int num_regions)
+{
+	unsigned int i;
+
+	assert(regions || (num_regions == 0));
+
+	for (i = 0; i < num_regions; i++)
+		tzc_configure_region(regions[i].filters,
+				     regions[i].region,
+				     regions[i].region_base,
+				     regions[i].region_top,
+				     regions[i].sec_attr,
+				     regions[i].ns_device_access);
+}
+
 
 void tzc_set_action(tzc_action_t action)
 {
@@ -299,6 +335,54 @@ void tzc_set_action(tzc_action_t action)
 }
 
 
+/*
+ * `tzc_get_int_status` returns the bitmap of filters which have rejected an
+ * access since their interrupt was last cleared.
+ */
+uint32_t tzc_get_int_status(void)
+{
+	assert(tzc.base);
+
+	return (mmio_read_32(tzc.base + INT_STATUS) >>
+		INT_STATUS_STATUS_SHIFT) & INT_STATUS_STATUS_MASK;
+}
+
+/*
+ * `tzc_get_fail_info` reads the details of the last access rejected by
+ * 'filter'. They are only valid while the interrupt status of the filter is
+ * set.
+ */
+void tzc_get_fail_info(uint32_t filter, tzc_fail_info_t *info)
+{
+	uintptr_t fail_base;
+
+	assert(tzc.base);
+	assert(info);
+	assert(filter < tzc.num_filters);
+
+	fail_base = tzc.base + FAIL_NUM_OFF(filter);
+
+	info->address = mmio_read_32(fail_base + FAIL_ADDRESS_LOW_OFF);
+	info->address |= (uint64_t)mmio_read_32(fail_base +
+						FAIL_ADDRESS_HIGH_OFF) << 32;
+	info->control = mmio_read_32(fail_base + FAIL_CONTROL_OFF);
+	info->id = mmio_read_32(fail_base + FAIL_ID);
+	info->filter = filter;
+}
+
+/*
+ * `tzc_clear_int` clears the interrupt status, and the overrun status, of the
+ * filters in the 'filters' bitmap.
+ */
+void tzc_clear_int(uint32_t filters)
+{
+	assert(tzc.base);
+
+	mmio_write_32(tzc.base + INT_CLEAR,
+		      (filters & INT_CLEAR_CLEAR_MASK) << INT_CLEAR_CLEAR_SHIFT);
+}
+
+
 void tzc_enable_filters(void)
 {
 	uint32_t state;
@@ -338,3 +422,58 @@ void tzc_disable_filters(void)
 	for (filter = 0; filter < tzc.num_filters; filter++)
 		tzc_set_gate_keeper(tzc.base, filter, 0);
 }
+
+/*
+ * `tzc_save_state` copies the action, the filter states and the registers of
+ * all implemented regions into 'state'.
+ */
+void tzc_save_state(tzc_state_t *state)
+{
+	uintptr_t reg_base;
+	uint32_t region, i;
+
+	assert(tzc.base);
+	assert(state);
+	assert(tzc.num_regions <= TZC400_MAX_REGIONS);
+
+	state->action = tzc_read_action(tzc.base);
+	state->gate_keeper = (tzc_read_gate_keeper(tzc.base) >>
+			      GATE_KEEPER_OS_SHIFT) & GATE_KEEPER_OS_MASK;
+
+	for (region = 0; region < tzc.num_regions; region++) {
+		reg_base = tzc.base + REGION_BASE_LOW_OFF +
+			REGION_NUM_OFF(region);
+		for (i = 0; i < REGION_NUM_REGS; i++)
+			state->region[region][i] =
+				mmio_read_32(reg_base + (i << 2));
+	}
+}
+
+/*
+ * `tzc_restore_state` writes back a copy taken by tzc_save_state(). The
+ * filters are closed while the regions are reprogrammed, as the TZC may
+ * have kept its configuration, and are then set back to the saved state.
+ * Region 0 has fixed addresses, so only its attributes and id access
+ * registers are written.
+ */
+void tzc_restore_state(const tzc_state_t *state)
+{
+	uintptr_t reg_base;
+	uint32_t region, i;
+
+	assert(tzc.base);
+	assert(state);
+
+	tzc_write_gate_keeper_sync(tzc.base, 0);
+
+	for (region = 0; region < tzc.num_regions; region++) {
+		reg_base = tzc.base + REGION_BASE_LOW_OFF +
+			REGION_NUM_OFF(region);
+		for (i = region ? 0 : 4; i < REGION_NUM_REGS; i++)
+			mmio_write_32(reg_base + (i << 2),
+				      state->region[region][i]);
+	}
+
+	tzc_write_action(tzc.base, state->action);
+	tzc_write_gate_keeper_sync(tzc.base, state->gate_keeper);
+}
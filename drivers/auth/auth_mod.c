@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -35,11 +35,14 @@
 #include <crypto_mod.h>
 #include <debug.h>
 #include <img_parser_mod.h>
+#include <load_stats.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <stdint.h>
 #include <string.h>
 
+#pragma weak plat_get_img_hash
+
 #define return_if_error(rc) \
 	do { \
 		if (rc != 0) { \
@@ -50,6 +53,66 @@
 /* Pointer to CoT */
 extern const auth_img_desc_t *const cot_desc_ptr;
 extern unsigned int auth_img_flags[];
+extern const unsigned int cot_desc_size;
+
+#if AUTH_PARAM_POOL
+/*
+ * The parameters without a buffer of their own are stored in the pool
+ * registered by the CoT, in one block per image. A block is freed when space is
+ * needed for another image, preferably once all the children of its image have
+ * been authenticated. Its image is then no longer considered authenticated, so
+ * it is loaded and verified again if one of its children still needs it.
+ */
+extern auth_pool_blk_t auth_img_pool_blks[];
+extern uint8_t *const cot_param_pool;
+extern const unsigned int cot_param_pool_size;
+
+static uint16_t pool_use_count;
+#endif
+
+#if AUTH_HANDOFF
+/*
+ * Record of the authentication data handed over to the next BL stage. The
+ * record is followed by 'len' bytes of data, padded to a multiple of 8 bytes.
+ * The 'param' field is the index in the 'authenticated_data' array of image
+ * 'img_id', or HANDOFF_PARAM_ROTPK for the ROTPK.
+ */
+#define HANDOFF_PARAM_ROTPK		0xffffffff
+#define HANDOFF_REC_ALIGN		8
+#define HANDOFF_DATA_SIZE(len)		(((len) + HANDOFF_REC_ALIGN - 1) & \
+					 ~(HANDOFF_REC_ALIGN - 1))
+
+typedef struct handoff_rec_s {
+	uint32_t img_id;
+	uint32_t param;
+	uint32_t len;
+	uint32_t reserved;
+} handoff_rec_t;
+
+/*
+ * Copy of the ROTPK that has been verified against the hash in the platform,
+ * large enough for an RSA-4096 key. A certificate signed with the same key
+ * does not need the hash of the key to be calculated again.
+ */
+#define ROTPK_MAX_LEN			1024
+
+static unsigned char rotpk_buf[ROTPK_MAX_LEN];
+static unsigned int rotpk_len;
+#endif
+
+#if AUTH_STREAM_HASH
+/*
+ * Hash of an image calculated while the image is being loaded. When the image
+ * is authenticated, the precomputed digest is matched against the hash from
+ * the parent image instead of hashing the loaded image again.
+ */
+static struct {
+	const auth_img_desc_t *img_desc;	/* NULL if no hash in progress */
+	const auth_method_param_hash_t *param;	/* Method being precomputed */
+	uintptr_t base;				/* Start of the hashed data */
+	size_t len;				/* Length of the hashed data */
+} stream;
+#endif
 
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
@@ -60,28 +123,338 @@ static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 	return 1;
 }
 
+#if AUTH_PARAM_POOL
+/*
+ * Return the number of bytes of the pool needed by the parameters of an image
+ */
+static unsigned int pool_blk_size(const auth_img_desc_t *img_desc)
+{
+	const auth_param_desc_t *auth_data;
+	unsigned int size = 0;
+	int i;
+
+	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+		auth_data = &img_desc->authenticated_data[i];
+		if ((auth_data->type_desc != NULL) &&
+		    (auth_data->data.ptr == NULL)) {
+			size += auth_data->data.len;
+		}
+	}
+
+	return size;
+}
+
+/*
+ * Return 1 if all the children of an image have been authenticated, so its
+ * parameters are not needed any more, 0 otherwise
+ */
+static int pool_img_is_dead(unsigned int img_id)
+{
+	unsigned int i;
+
+	for (i = 0 ; i < cot_desc_size ; i++) {
+		if ((cot_desc_ptr[i].parent == &cot_desc_ptr[img_id]) &&
+		    ((auth_img_flags[i] & IMG_FLAG_AUTHENTICATED) == 0)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Find a free range of 'size' bytes in the pool. Only the start of the pool
+ * and the end of each block are tried.
+ *
+ * Return: 0 = success with the start of the range in '*offset', 1 = no range
+ */
+static int pool_find(unsigned int size, unsigned int *offset)
+{
+	const auth_pool_blk_t *blk;
+	unsigned int start, i, j;
+
+	for (i = 0 ; i <= cot_desc_size ; i++) {
+		if (i == 0) {
+			start = 0;
+		} else if (auth_img_pool_blks[i - 1].size != 0) {
+			start = auth_img_pool_blks[i - 1].offset +
+				auth_img_pool_blks[i - 1].size;
+		} else {
+			continue;
+		}
+
+		if (start + size > cot_param_pool_size) {
+			continue;
+		}
+
+		for (j = 0 ; j < cot_desc_size ; j++) {
+			blk = &auth_img_pool_blks[j];
+			if ((blk->size != 0) &&
+			    (start < blk->offset + blk->size) &&
+			    (blk->offset < start + size)) {
+				break;
+			}
+		}
+
+		if (j == cot_desc_size) {
+			*offset = start;
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Free the block of the image whose parameters are the least likely to be
+ * needed again: the image whose children have all been authenticated, or else
+ * the least recently used one.
+ *
+ * Return: 0 = a block has been freed, 1 = the pool is empty
+ */
+static int pool_evict(void)
+{
+	const auth_pool_blk_t *blk;
+	unsigned int img_id, victim = 0;
+	int found = 0, dead, victim_dead = 0;
+	uint16_t age, victim_age = 0;
+
+	for (img_id = 0 ; img_id < cot_desc_size ; img_id++) {
+		blk = &auth_img_pool_blks[img_id];
+		if (blk->size == 0) {
+			continue;
+		}
+
+		dead = pool_img_is_dead(img_id);
+		age = pool_use_count - blk->last_use;
+		if (!found || (dead > victim_dead) ||
+		    ((dead == victim_dead) && (age > victim_age))) {
+			victim = img_id;
+			victim_dead = dead;
+			victim_age = age;
+			found = 1;
+		}
+	}
+
+	if (!found) {
+		return 1;
+	}
+
+	VERBOSE("Parameters of image id=%u dropped from the pool\n", victim);
+	auth_img_pool_blks[victim].size = 0;
+	auth_img_flags[victim] &= ~IMG_FLAG_AUTHENTICATED;
+
+	return 0;
+}
+
+/*
+ * Allocate the block of the pool where the parameters of an image are stored,
+ * freeing the blocks of other images if needed
+ *
+ * Return: 0 = success, 1 = the parameters do not fit in the pool
+ */
+static int pool_alloc(const auth_img_desc_t *img_desc)
+{
+	auth_pool_blk_t *blk = &auth_img_pool_blks[img_desc->img_id];
+	unsigned int size, offset;
+
+	size = pool_blk_size(img_desc);
+	if (size == 0) {
+		return 0;
+	}
+
+	/* The image may be verified again while its block is still there */
+	if (blk->size == 0) {
+		while (pool_find(size, &offset) != 0) {
+			if (pool_evict() != 0) {
+				return 1;
+			}
+		}
+
+		blk->offset = offset;
+		blk->size = size;
+	}
+
+	blk->last_use = ++pool_use_count;
+
+	return 0;
+}
+#else
+#define pool_alloc(_img_desc)	0
+#endif /* AUTH_PARAM_POOL */
+
+/*
+ * Return the address of the data of the parameter in slot 'i' of the
+ * 'authenticated_data' array of an image
+ */
+static void *auth_param_data(const auth_img_desc_t *img_desc, unsigned int i)
+{
+#if AUTH_PARAM_POOL
+	const auth_param_desc_t *auth_data = img_desc->authenticated_data;
+	unsigned int offset, j;
+
+	if (auth_data[i].data.ptr == NULL) {
+		offset = auth_img_pool_blks[img_desc->img_id].offset;
+		for (j = 0 ; j < i ; j++) {
+			if ((auth_data[j].type_desc != NULL) &&
+			    (auth_data[j].data.ptr == NULL)) {
+				offset += auth_data[j].data.len;
+			}
+		}
+
+		return cot_param_pool + offset;
+	}
+#endif
+
+	return img_desc->authenticated_data[i].data.ptr;
+}
+
 /*
  * This function obtains the requested authentication parameter data from the
- * information extracted from the parent image after its authentication.
+ * information extracted from the parent image after its authentication. The
+ * parameter is found in the slot given by its type descriptor.
  */
 static int auth_get_param(const auth_param_type_desc_t *param_type_desc,
 			  const auth_img_desc_t *img_desc,
 			  void **param, unsigned int *len)
 {
+	const auth_param_desc_t *auth_data;
+
+	if (param_type_desc->slot >= COT_MAX_VERIFIED_PARAMS) {
+		return 1;
+	}
+
+	auth_data = &img_desc->authenticated_data[param_type_desc->slot];
+	if ((auth_data->type_desc == NULL) ||
+	    (cmp_auth_param_type_desc(param_type_desc,
+				      auth_data->type_desc) != 0)) {
+		return 1;
+	}
+
+#if AUTH_PARAM_POOL
+	/* The parameters of the image may have been dropped from the pool */
+	if ((auth_img_flags[img_desc->img_id] & IMG_FLAG_AUTHENTICATED) == 0) {
+		return 1;
+	}
+
+	if (auth_data->data.ptr == NULL) {
+		auth_img_pool_blks[img_desc->img_id].last_use =
+			++pool_use_count;
+	}
+#endif
+
+	*param = auth_param_data(img_desc, param_type_desc->slot);
+	*len = auth_data->data.len;
+
+	return 0;
+}
+
+#if AUTH_STREAM_HASH
+/*
+ * Abandon the hash in progress, if any
+ */
+static void stream_hash_abort(void)
+{
+	if (stream.img_desc != NULL) {
+		(void)crypto_mod_verify_hash_finish();
+		stream.img_desc = NULL;
+	}
+}
+
+/*
+ * Prepare to hash an image while it is being loaded
+ *
+ * The hash can only be calculated in advance for raw images that are
+ * authenticated by hash and whose parent has already been authenticated, so
+ * that the hash to be matched is known. For any other image this function
+ * does nothing and the image is hashed by auth_mod_verify_img() as usual.
+ */
+void auth_mod_stream_hash_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_method_desc_t *auth_method;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
 	int i;
 
-	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
-		if (0 == cmp_auth_param_type_desc(param_type_desc,
-				img_desc->authenticated_data[i].type_desc)) {
-			*param = img_desc->authenticated_data[i].data.ptr;
-			*len = img_desc->authenticated_data[i].data.len;
-			return 0;
+	stream_hash_abort();
+
+	img_desc = &cot_desc_ptr[img_id];
+	if ((img_desc->img_type != IMG_RAW) || (img_desc->parent == NULL)) {
+		return;
+	}
+
+	if ((auth_img_flags[img_desc->parent->img_id] &
+	     IMG_FLAG_AUTHENTICATED) == 0) {
+		return;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type != AUTH_METHOD_HASH) {
+			continue;
+		}
+
+		if (auth_get_param(auth_method->param.hash.hash,
+				   img_desc->parent,
+				   &hash_der_ptr, &hash_der_len) != 0) {
+			return;
+		}
+
+		if (crypto_mod_verify_hash_start(hash_der_ptr,
+						 hash_der_len) != 0) {
+			return;
 		}
+
+		stream.img_desc = img_desc;
+		stream.param = &auth_method->param.hash;
+		stream.base = 0;
+		stream.len = 0;
+		return;
 	}
+}
 
-	return 1;
+/*
+ * Add a chunk of the image being loaded to the hash in progress. Chunks must
+ * be consecutive in memory, otherwise the precomputed hash is abandoned.
+ */
+void auth_mod_stream_hash_update(void *data_ptr, unsigned int data_len)
+{
+	if ((stream.img_desc == NULL) || (data_len == 0)) {
+		return;
+	}
+
+	if (stream.len == 0) {
+		stream.base = (uintptr_t)data_ptr;
+	} else if ((uintptr_t)data_ptr != stream.base + stream.len) {
+		stream_hash_abort();
+		return;
+	}
+
+	if (crypto_mod_verify_hash_update(data_ptr, data_len) != 0) {
+		stream_hash_abort();
+		return;
+	}
+
+	stream.len += data_len;
 }
 
+/*
+ * Return the number of bytes hashed so far by the hash in progress for image
+ * 'img_id', if that hash starts at 'data_ptr'. Otherwise return 0.
+ */
+size_t auth_mod_stream_hash_len(unsigned int img_id, const void *data_ptr)
+{
+	if ((stream.img_desc == NULL) ||
+	    (stream.img_desc != &cot_desc_ptr[img_id]) ||
+	    (stream.base != (uintptr_t)data_ptr)) {
+		return 0;
+	}
+
+	return stream.len;
+}
+#endif /* AUTH_STREAM_HASH */
+
 /*
  * Authenticate an image by matching the data hash
  *
@@ -126,6 +499,17 @@ static int auth_hash(const auth_method_param_hash_t *param,
 			img, img_len, &data_ptr, &data_len);
 	return_if_error(rc);
 
+#if AUTH_STREAM_HASH
+	/* Use the hash calculated while loading if it covers the same data */
+	if ((stream.img_desc == img_desc) && (stream.param == param) &&
+	    (stream.base == (uintptr_t)data_ptr) &&
+	    (stream.len == data_len)) {
+		stream.img_desc = NULL;
+		return crypto_mod_verify_hash_finish();
+	}
+	stream_hash_abort();
+#endif
+
 	/* Ask the crypto module to verify this hash */
 	rc = crypto_mod_verify_hash(data_ptr, data_len,
 				    hash_der_ptr, hash_der_len);
@@ -133,6 +517,59 @@ static int auth_hash(const auth_method_param_hash_t *param,
 	return rc;
 }
 
+/*
+ * Default platform hook: the platform holds no image hashes
+ */
+int plat_get_img_hash(unsigned int image_id, void **hash_ptr,
+		      unsigned int *hash_len)
+{
+	return 1;
+}
+
+/*
+ * Authenticate an image by matching the data hash with a hash held by the
+ * platform, e.g. in a table of fused digests
+ *
+ * This function implements 'AUTH_METHOD_PLAT_HASH'. The image is authenticated
+ * without any certificate, so it is suitable for images the platform stores
+ * in trusted memory only.
+ *
+ * Parameters:
+ *   param: parameters to perform the hash authentication
+ *   img_desc: pointer to image descriptor so we can know the image type
+ *   img: pointer to image in memory
+ *   img_len: length of image (in bytes)
+ *
+ * Return:
+ *   0 = success, Otherwise = error
+ */
+static int auth_plat_hash(const auth_method_param_plat_hash_t *param,
+			  const auth_img_desc_t *img_desc,
+			  void *img, unsigned int img_len)
+{
+	void *data_ptr, *hash_der_ptr;
+	unsigned int data_len, hash_der_len;
+	int rc;
+
+	/* Get the DER encoded hash of the image from the platform */
+	rc = plat_get_img_hash(img_desc->img_id, &hash_der_ptr, &hash_der_len);
+	return_if_error(rc);
+
+	/* Get the data to be hashed from the current image */
+	rc = img_parser_get_auth_param(img_desc->img_type, param->data,
+			img, img_len, &data_ptr, &data_len);
+	return_if_error(rc);
+
+#if AUTH_STREAM_HASH
+	/* A hash precomputed for another method cannot be used */
+	stream_hash_abort();
+#endif
+
+	/* Ask the crypto module to verify this hash */
+	return crypto_mod_verify_hash(data_ptr, data_len,
+				      hash_der_ptr, hash_der_len);
+}
+
 /*
  * Authenticate by digital signature
  *
@@ -212,9 +649,24 @@ static int auth_signature(const auth_method_param_sig_t *param,
 						 pk_ptr, pk_len);
 		return_if_error(rc);
 
+#if AUTH_HANDOFF
+		/* The key hash has been verified already if it is the ROTPK */
+		if ((rotpk_len != 0) && (pk_len == rotpk_len) &&
+		    (memcmp(pk_ptr, rotpk_buf, pk_len) == 0)) {
+			return 0;
+		}
+#endif
+
 		/* Ask the crypto-module to verify the key hash */
 		rc = crypto_mod_verify_hash(pk_ptr, pk_len,
 					    pk_hash_ptr, pk_hash_len);
+#if AUTH_HANDOFF
+		if ((rc == 0) && (img_desc->parent == NULL) &&
+		    (pk_len <= ROTPK_MAX_LEN)) {
+			memcpy(rotpk_buf, pk_ptr, pk_len);
+			rotpk_len = pk_len;
+		}
+#endif
 	} else {
 		/* Ask the crypto module to verify the signature */
 		rc = crypto_mod_verify_signature(data_ptr, data_len,
@@ -226,6 +678,47 @@ static int auth_signature(const auth_method_param_sig_t *param,
 	return rc;
 }
 
+#if MEASURED_BOOT
+/*
+ * Return in '*digest' the DER encoded digest (including the hash algorithm) of
+ * an image that has been authenticated by hash. As the authentication checked
+ * that the digest of the image matches the one in the parent image, or the one
+ * held by the platform, the latter is returned and the image does not need to
+ * be hashed again.
+ *
+ * Return value:
+ *   0 = success, 1 = image not authenticated or not authenticated by hash
+ */
+int auth_mod_get_img_digest(unsigned int img_id, void **digest,
+			    unsigned int *len)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_method_desc_t *auth_method;
+	int i;
+
+	assert((digest != NULL) && (len != NULL));
+
+	img_desc = &cot_desc_ptr[img_id];
+	if ((auth_img_flags[img_id] & IMG_FLAG_AUTHENTICATED) == 0) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if ((auth_method->type == AUTH_METHOD_HASH) &&
+		    (img_desc->parent != NULL)) {
+			return auth_get_param(auth_method->param.hash.hash,
+					      img_desc->parent, digest, len);
+		}
+		if (auth_method->type == AUTH_METHOD_PLAT_HASH) {
+			return plat_get_img_hash(img_id, digest, len);
+		}
+	}
+
+	return 1;
+}
+#endif
+
 /*
  * Return the parent id in the output parameter '*parent_id'
  *
@@ -262,9 +755,29 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
  */
 void auth_mod_init(void)
 {
+#if DEBUG
+	unsigned int img_id, i;
+	const auth_param_desc_t *auth_data;
+#endif
+
 	/* Check we have a valid CoT registered */
 	assert(cot_desc_ptr != NULL);
 
+#if DEBUG
+	/* Check the parameters of the CoT are stored in their own slot */
+	for (img_id = 0 ; img_id < cot_desc_size ; img_id++) {
+		for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+			auth_data = &cot_desc_ptr[img_id].authenticated_data[i];
+			assert((auth_data->type_desc == NULL) ||
+			       (auth_data->type_desc->slot == i));
+		}
+#if AUTH_PARAM_POOL
+		assert(pool_blk_size(&cot_desc_ptr[img_id]) <=
+		       cot_param_pool_size);
+#endif
+	}
+#endif
+
 	/* Crypto module */
 	crypto_mod_init();
 
@@ -285,19 +798,23 @@ int auth_mod_verify_img(unsigned int img_id,
 	const auth_method_desc_t *auth_method = NULL;
 	void *param_ptr;
 	unsigned int param_len;
+	uint64_t start;
 	int rc, i;
 
 	/* Get the image descriptor from the chain of trust */
 	img_desc = &cot_desc_ptr[img_id];
 
 	/* Ask the parser to check the image integrity */
+	start = load_stats_now();
 	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
+	load_stats_add(img_id, LOAD_STATS_PARSE, start);
 	return_if_error(rc);
 
 	/* Authenticate the image using the methods indicated in the image
 	 * descriptor. */
 	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
 		auth_method = &img_desc->img_auth_methods[i];
+		start = load_stats_now();
 		switch (auth_method->type) {
 		case AUTH_METHOD_NONE:
 			rc = 0;
@@ -305,10 +822,17 @@ int auth_mod_verify_img(unsigned int img_id,
 		case AUTH_METHOD_HASH:
 			rc = auth_hash(&auth_method->param.hash,
 					img_desc, img_ptr, img_len);
+			load_stats_add(img_id, LOAD_STATS_HASH, start);
 			break;
 		case AUTH_METHOD_SIG:
 			rc = auth_signature(&auth_method->param.sig,
 					img_desc, img_ptr, img_len);
+			load_stats_add(img_id, LOAD_STATS_SIG, start);
+			break;
+		case AUTH_METHOD_PLAT_HASH:
+			rc = auth_plat_hash(&auth_method->param.plat_hash,
+					img_desc, img_ptr, img_len);
+			load_stats_add(img_id, LOAD_STATS_HASH, start);
 			break;
 		default:
 			/* Unknown authentication method */
@@ -320,6 +844,9 @@ int auth_mod_verify_img(unsigned int img_id,
 
 	/* Extract the parameters indicated in the image descriptor to
 	 * authenticate the children images. */
+	start = load_stats_now();
+	rc = pool_alloc(img_desc);
+	return_if_error(rc);
 	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
 		if (img_desc->authenticated_data[i].type_desc == NULL) {
 			continue;
@@ -337,12 +864,159 @@ int auth_mod_verify_img(unsigned int img_id,
 		}
 
 		/* Copy the parameter for later use */
-		memcpy((void *)img_desc->authenticated_data[i].data.ptr,
-				(void *)param_ptr, param_len);
+		memcpy(auth_param_data(img_desc, i), (void *)param_ptr,
+		       param_len);
 	}
+	load_stats_add(img_id, LOAD_STATS_PARSE, start);
 
 	/* Mark image as authenticated */
 	auth_img_flags[img_desc->img_id] |= IMG_FLAG_AUTHENTICATED;
 
 	return 0;
 }
+
+#if AUTH_HANDOFF
+/*
+ * Append a record to the authentication data being handed over. Return the
+ * updated offset, or 0 if the record does not fit in the buffer.
+ */
+static size_t handoff_add(uint8_t *buf, size_t size, size_t offset,
+			  unsigned int img_id, unsigned int param,
+			  const void *data, unsigned int len)
+{
+	handoff_rec_t *rec;
+	size_t rec_size;
+
+	rec_size = sizeof(handoff_rec_t) + HANDOFF_DATA_SIZE(len);
+	if (rec_size > size - offset) {
+		return 0;
+	}
+
+	rec = (handoff_rec_t *)(buf + offset);
+	rec->img_id = img_id;
+	rec->param = param;
+	rec->len = len;
+	rec->reserved = 0;
+	memcpy(rec + 1, data, len);
+
+	return offset + rec_size;
+}
+
+/*
+ * Write the parameters extracted from the images authenticated so far and the
+ * verified ROTPK into 'buf', so the next BL stage does not have to verify the
+ * same certificates again. The buffer must be 8-byte aligned.
+ *
+ * Return: number of bytes written, 0 if there is nothing to hand over or it
+ * does not fit in 'size' bytes
+ */
+size_t auth_mod_handoff_export(void *buf, size_t size)
+{
+	const auth_img_desc_t *img_desc;
+	auth_handoff_t *handoff = buf;
+	size_t offset;
+	unsigned int img_id;
+	int i;
+
+	assert(buf != NULL);
+	assert(((uintptr_t)buf & (HANDOFF_REC_ALIGN - 1)) == 0);
+
+	if (size < sizeof(auth_handoff_t)) {
+		return 0;
+	}
+
+	offset = sizeof(auth_handoff_t);
+
+	if (rotpk_len != 0) {
+		offset = handoff_add(buf, size, offset, 0, HANDOFF_PARAM_ROTPK,
+				     rotpk_buf, rotpk_len);
+		if (offset == 0) {
+			return 0;
+		}
+	}
+
+	for (img_id = 0 ; img_id < cot_desc_size ; img_id++) {
+		if ((auth_img_flags[img_id] & IMG_FLAG_AUTHENTICATED) == 0) {
+			continue;
+		}
+
+		img_desc = &cot_desc_ptr[img_id];
+		for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+			if (img_desc->authenticated_data[i].type_desc == NULL) {
+				continue;
+			}
+
+			offset = handoff_add(buf, size, offset, img_id, i,
+				auth_param_data(img_desc, i),
+				img_desc->authenticated_data[i].data.len);
+			if (offset == 0) {
+				return 0;
+			}
+		}
+	}
+
+	if (offset == sizeof(auth_handoff_t)) {
+		return 0;
+	}
+
+	handoff->magic = AUTH_HANDOFF_MAGIC;
+	handoff->size = offset - sizeof(auth_handoff_t);
+
+	return offset;
+}
+
+/*
+ * Import the authentication data handed over by the previous BL stage. The
+ * images it describes are marked as authenticated, so they are not loaded
+ * again when they are the parent of an image. This function must be called
+ * after auth_mod_init() and before any image is loaded.
+ */
+void auth_mod_handoff_import(const void *buf)
+{
+	const auth_handoff_t *handoff = buf;
+	const auth_img_desc_t *img_desc;
+	const auth_param_desc_t *auth_data;
+	const handoff_rec_t *rec;
+	const uint8_t *end;
+
+	if ((buf == NULL) ||
+	    (((uintptr_t)buf & (HANDOFF_REC_ALIGN - 1)) != 0) ||
+	    (handoff->magic != AUTH_HANDOFF_MAGIC)) {
+		return;
+	}
+
+	rec = (const handoff_rec_t *)(handoff + 1);
+	end = (const uint8_t *)rec + handoff->size;
+
+	while ((const uint8_t *)(rec + 1) <= end) {
+		if (HANDOFF_DATA_SIZE(rec->len) >
+		    (size_t)(end - (const uint8_t *)(rec + 1))) {
+			break;
+		}
+
+		if (rec->param == HANDOFF_PARAM_ROTPK) {
+			if (rec->len <= ROTPK_MAX_LEN) {
+				memcpy(rotpk_buf, rec + 1, rec->len);
+				rotpk_len = rec->len;
+			}
+		} else if ((rec->img_id < cot_desc_size) &&
+			   (rec->param < COT_MAX_VERIFIED_PARAMS)) {
+			img_desc = &cot_desc_ptr[rec->img_id];
+			auth_data = &img_desc->authenticated_data[rec->param];
+			if ((auth_data->type_desc != NULL) &&
+			    (rec->len <= auth_data->data.len) &&
+			    (pool_alloc(img_desc) == 0)) {
+				memcpy(auth_param_data(img_desc, rec->param),
+				       rec + 1, rec->len);
+				auth_img_flags[rec->img_id] |=
+					IMG_FLAG_AUTHENTICATED;
+				VERBOSE("Image id=%u authenticated by BL1\n",
+					rec->img_id);
+			}
+		}
+
+		rec = (const handoff_rec_t *)((const uint8_t *)(rec + 1) +
+			HANDOFF_DATA_SIZE(rec->len));
+	}
+}
+#endif /* AUTH_HANDOFF */
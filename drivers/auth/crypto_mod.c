@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -31,10 +31,19 @@
 #include <assert.h>
 #include <crypto_mod.h>
 #include <debug.h>
+#include <platform.h>
 
 /* Variable exported by the crypto library through REGISTER_CRYPTO_LIB() */
 extern const crypto_lib_desc_t crypto_lib_desc;
 
+/* Hardware crypto engine provided by the platform, if any */
+static const crypto_engine_desc_t *crypto_engine;
+
+/* Set while the incremental hash in progress is calculated by the engine */
+static int hash_on_engine;
+
+#pragma weak plat_get_crypto_engine
+
 /*
  * The crypto module is responsible for verifying digital signatures and hashes.
  * It relies on a crypto library to perform the cryptographic operations.
@@ -63,6 +72,14 @@ extern const crypto_lib_desc_t crypto_lib_desc;
  *     SignatureValue ::= BIT STRING
  */
 
+/*
+ * Default platform hook: there is no hardware crypto engine
+ */
+const crypto_engine_desc_t *plat_get_crypto_engine(void)
+{
+	return NULL;
+}
+
 /*
  * Perform some static checking and call the library initialization function
  */
@@ -76,6 +93,56 @@ void crypto_mod_init(void)
 	/* Initialize the cryptographic library */
 	crypto_lib_desc.init();
 	INFO("Using crypto library '%s'\n", crypto_lib_desc.name);
+
+	crypto_engine = plat_get_crypto_engine();
+	if (crypto_engine != NULL) {
+		assert(crypto_engine->name != NULL);
+		assert(crypto_engine->hash_start != NULL);
+		assert(crypto_engine->hash_update != NULL);
+		assert(crypto_engine->hash_finish != NULL);
+		assert(crypto_engine->poll != NULL);
+		INFO("Using crypto engine '%s'\n", crypto_engine->name);
+	}
+}
+
+/*
+ * Wait for the crypto engine to complete the operation in progress
+ */
+static int crypto_engine_wait(void)
+{
+	int rc;
+
+	do {
+		rc = crypto_engine->poll();
+	} while (rc == CRYPTO_IN_PROGRESS);
+
+	return rc;
+}
+
+/*
+ * Start a hash on the crypto engine. The engine is not used for a one-shot
+ * operation while it is calculating an incremental hash.
+ */
+static int crypto_engine_hash_start(void *digest_info_ptr,
+				    unsigned int digest_info_len)
+{
+	if ((crypto_engine == NULL) || hash_on_engine)
+		return CRYPTO_ERR_HASH;
+
+	return crypto_engine->hash_start(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Wait for the queued data to be hashed and compare the result
+ */
+static int crypto_engine_hash_finish(void)
+{
+	int rc, finish_rc;
+
+	rc = crypto_engine_wait();
+	finish_rc = crypto_engine->hash_finish();
+
+	return (rc != CRYPTO_SUCCESS) ? rc : finish_rc;
 }
 
 /*
@@ -102,6 +169,15 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 	assert(pk_ptr != NULL);
 	assert(pk_len != 0);
 
+	if ((crypto_engine != NULL) && !hash_on_engine &&
+	    (crypto_engine->verify_signature_start != NULL) &&
+	    (crypto_engine->verify_signature_start(data_ptr, data_len,
+						   sig_ptr, sig_len,
+						   sig_alg_ptr, sig_alg_len,
+						   pk_ptr, pk_len)
+	     == CRYPTO_SUCCESS))
+		return crypto_engine_wait();
+
 	return crypto_lib_desc.verify_signature(data_ptr, data_len,
 						sig_ptr, sig_len,
 						sig_alg_ptr, sig_alg_len,
@@ -119,11 +195,91 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len)
 {
+	int rc, finish_rc;
+
 	assert(data_ptr != NULL);
 	assert(data_len != 0);
 	assert(digest_info_ptr != NULL);
 	assert(digest_info_len != 0);
 
+	if (crypto_engine_hash_start(digest_info_ptr, digest_info_len)
+	    == CRYPTO_SUCCESS) {
+		rc = crypto_engine->hash_update(data_ptr, data_len);
+		finish_rc = crypto_engine_hash_finish();
+		return (rc != CRYPTO_SUCCESS) ? rc : finish_rc;
+	}
+
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start the incremental calculation of a hash
+ *
+ * The data is passed in consecutive chunks to crypto_mod_verify_hash_update()
+ * and the result is compared with the expected hash when
+ * crypto_mod_verify_hash_finish() is called. The hash is calculated by the
+ * platform crypto engine when it supports the algorithm, so the chunks are
+ * processed while the caller loads the next ones. Otherwise the crypto library
+ * is used. Libraries that do not support it return an error, in which case the
+ * caller must use crypto_mod_verify_hash().
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ */
+int crypto_mod_verify_hash_start(void *digest_info_ptr,
+				 unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if (crypto_engine_hash_start(digest_info_ptr, digest_info_len)
+	    == CRYPTO_SUCCESS) {
+		hash_on_engine = 1;
+		return CRYPTO_SUCCESS;
+	}
+
+	if (crypto_lib_desc.verify_hash_start == NULL)
+		return CRYPTO_ERR_HASH;
+
+	return crypto_lib_desc.verify_hash_start(digest_info_ptr,
+						 digest_info_len);
+}
+
+/*
+ * Add a chunk of data to the hash being calculated
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+
+	if (hash_on_engine)
+		return crypto_engine->hash_update(data_ptr, data_len);
+
+	assert(crypto_lib_desc.verify_hash_update != NULL);
+
+	return crypto_lib_desc.verify_hash_update(data_ptr, data_len);
+}
+
+/*
+ * Complete the hash calculation and compare it with the expected value. This
+ * must also be called to release the library resources when the incremental
+ * hash is abandoned.
+ */
+int crypto_mod_verify_hash_finish(void)
+{
+	if (hash_on_engine) {
+		hash_on_engine = 0;
+		return crypto_engine_hash_finish();
+	}
+
+	assert(crypto_lib_desc.verify_hash_finish != NULL);
+
+	return crypto_lib_desc.verify_hash_finish();
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -29,20 +29,40 @@
  */
 
 #include <assert.h>
+#include <debug.h>
+#include <mbedtls_common.h>
+#if MBEDTLS_HEAP_STATS
+#include <string.h>
+#endif
 
 /* mbed TLS headers */
 #include <mbedtls/memory_buffer_alloc.h>
 
 /*
- * mbed TLS heap
+ * mbed TLS heap. The default size covers the TBBR CoT and may be overridden
+ * from the build command line.
  */
+#ifndef MBEDTLS_HEAP_SIZE
 #if (MBEDTLS_KEY_ALG_ID == MBEDTLS_ECDSA)
 #define MBEDTLS_HEAP_SIZE		(14*1024)
 #elif (MBEDTLS_KEY_ALG_ID == MBEDTLS_RSA)
 #define MBEDTLS_HEAP_SIZE		(8*1024)
 #endif
+#endif
 static unsigned char heap[MBEDTLS_HEAP_SIZE];
 
+#if MBEDTLS_HEAP_STATS
+/*
+ * The free part of the heap is filled with a pattern after the allocator has
+ * been initialized. The allocator hands out the lowest free block that fits,
+ * so the last byte that no longer holds the pattern marks the heap size needed
+ * by the allocations made so far. The start of the heap is left alone as it
+ * holds the allocator's first block header.
+ */
+#define HEAP_PATTERN			0xa5
+#define HEAP_PATTERN_OFFSET		256
+#endif
+
 /*
  * mbed TLS initialization function
  */
@@ -53,6 +73,27 @@ void mbedtls_init(void)
 	if (!ready) {
 		/* Initialize the mbed TLS heap */
 		mbedtls_memory_buffer_alloc_init(heap, MBEDTLS_HEAP_SIZE);
+#if MBEDTLS_HEAP_STATS
+		memset(&heap[HEAP_PATTERN_OFFSET], HEAP_PATTERN,
+		       MBEDTLS_HEAP_SIZE - HEAP_PATTERN_OFFSET);
+#endif
 		ready = 1;
 	}
 }
+
+#if MBEDTLS_HEAP_STATS
+/*
+ * Report the peak amount of heap used since mbedtls_init()
+ */
+void mbedtls_heap_report(void)
+{
+	unsigned int used = MBEDTLS_HEAP_SIZE;
+
+	while ((used > HEAP_PATTERN_OFFSET) &&
+	       (heap[used - 1] == HEAP_PATTERN)) {
+		used--;
+	}
+
+	INFO("mbed TLS heap: peak %u of %u bytes\n", used, MBEDTLS_HEAP_SIZE);
+}
+#endif
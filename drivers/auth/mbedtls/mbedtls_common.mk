@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
 #
 # Redistribution and use in source and binary forms, with or without
 # modification, are permitted provided that the following conditions are met:
@@ -44,6 +44,18 @@ INCLUDES		+=	-I${MBEDTLS_DIR}/include		\
 MBEDTLS_CONFIG_FILE	:=	"<mbedtls_config.h>"
 $(eval $(call add_define,MBEDTLS_CONFIG_FILE))
 
+# The size of the mbed TLS heap in bytes may be set on the command line
+ifneq (${MBEDTLS_HEAP_SIZE},)
+    $(eval $(call add_define,MBEDTLS_HEAP_SIZE))
+endif
+
+# Report the peak heap usage after each signature verification
+ifeq (${MBEDTLS_HEAP_STATS},)
+    MBEDTLS_HEAP_STATS	:=	0
+endif
+$(eval $(call assert_boolean,MBEDTLS_HEAP_STATS))
+$(eval $(call add_define,MBEDTLS_HEAP_STATS))
+
 MBEDTLS_COMMON_SOURCES	:=	drivers/auth/mbedtls/mbedtls_common.c	\
 				$(addprefix ${MBEDTLS_DIR}/library/,	\
 				asn1parse.c 				\
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -32,10 +32,16 @@
 #include <crypto_mod.h>
 #include <debug.h>
 #include <mbedtls_common.h>
+#if AUTH_SHA256_CE
+#include <sha256_ce.h>
+#endif
 #include <stddef.h>
 #include <string.h>
 
 /* mbed TLS headers */
+#if (MBEDTLS_KEY_ALG_ID == MBEDTLS_ECDSA)
+#include <mbedtls/ecdsa.h>
+#endif
 #include <mbedtls/md.h>
 #include <mbedtls/memory_buffer_alloc.h>
 #include <mbedtls/oid.h>
@@ -60,6 +66,32 @@
  * }
  */
 
+#if AUTH_SHA256_CE
+/* Non-zero if SHA-256 is calculated with the Cryptographic Extension */
+static int use_sha256_ce;
+#endif
+
+/* Public key of the signature being verified */
+static mbedtls_pk_context sig_pk;
+
+#if AUTH_BATCH_CERTS
+/* DER encoding of the key held in 'sig_pk', 0 length if it is not kept */
+#define SIG_PK_CACHE_LEN		1024
+
+static unsigned char sig_pk_der[SIG_PK_CACHE_LEN];
+static unsigned int sig_pk_len;
+#endif
+
+#if (MBEDTLS_KEY_ALG_ID == MBEDTLS_ECDSA)
+/*
+ * ECDSA context used to verify P-256 signatures. It is kept for the lifetime of
+ * the BL image, so the table of multiples of the base point that mbed TLS
+ * precomputes in the group on the first verification is reused by all the
+ * others. Only the public key is replaced for each verification.
+ */
+static mbedtls_ecdsa_context ecdsa_p256;
+#endif
+
 /*
  * Initialize the library and export the descriptor
  */
@@ -67,8 +99,114 @@ static void init(void)
 {
 	/* Initialize mbed TLS */
 	mbedtls_init();
+
+#if (MBEDTLS_KEY_ALG_ID == MBEDTLS_ECDSA)
+	mbedtls_ecdsa_init(&ecdsa_p256);
+	if (mbedtls_ecp_group_load(&ecdsa_p256.grp,
+				   MBEDTLS_ECP_DP_SECP256R1) != 0) {
+		ERROR("Failed to load the P-256 curve\n");
+		panic();
+	}
+#endif
+
+#if AUTH_SHA256_CE
+	use_sha256_ce = sha256_ce_supported();
+	VERBOSE("SHA-256 %s the Cryptographic Extension\n",
+		use_sha256_ce ? "uses" : "does not use");
+#endif
+}
+
+/*
+ * Calculate the hash of the data with the algorithm described by 'md_info'.
+ * Return 0 on success, as mbedtls_md() does.
+ */
+static int calc_hash(const mbedtls_md_info_t *md_info, unsigned char *data_ptr,
+		     unsigned int data_len, unsigned char *hash)
+{
+#if AUTH_SHA256_CE
+	if (use_sha256_ce &&
+	    (mbedtls_md_get_type(md_info) == MBEDTLS_MD_SHA256)) {
+		sha256_ce(data_ptr, data_len, hash);
+		return 0;
+	}
+#endif
+
+	return mbedtls_md(md_info, data_ptr, data_len, hash);
 }
 
+/*
+ * Parse the public key of a signature into 'sig_pk'. With AUTH_BATCH_CERTS,
+ * the key is kept after the verification, so the next certificate signed with
+ * the same key reuses it along with what mbed TLS derives from it on first use,
+ * such as the Montgomery constant of an RSA modulus.
+ */
+static int get_sig_pk(void *pk_ptr, unsigned int pk_len)
+{
+	unsigned char *p, *end;
+	int rc;
+
+#if AUTH_BATCH_CERTS
+	if ((pk_len == sig_pk_len) &&
+	    (memcmp(pk_ptr, sig_pk_der, pk_len) == 0)) {
+		return 0;
+	}
+
+	if (sig_pk_len != 0) {
+		mbedtls_pk_free(&sig_pk);
+		sig_pk_len = 0;
+	}
+#endif
+
+	mbedtls_pk_init(&sig_pk);
+	p = (unsigned char *)pk_ptr;
+	end = (unsigned char *)(p + pk_len);
+	rc = mbedtls_pk_parse_subpubkey(&p, end, &sig_pk);
+
+#if AUTH_BATCH_CERTS
+	if ((rc == 0) && (pk_len <= SIG_PK_CACHE_LEN)) {
+		memcpy(sig_pk_der, pk_ptr, pk_len);
+		sig_pk_len = pk_len;
+	}
+#endif
+
+	return rc;
+}
+
+/*
+ * Release the public key parsed by get_sig_pk(), unless it is kept for the next
+ * verification
+ */
+static void put_sig_pk(void)
+{
+#if AUTH_BATCH_CERTS
+	if (sig_pk_len != 0) {
+		return;
+	}
+#endif
+	mbedtls_pk_free(&sig_pk);
+}
+
+#if (MBEDTLS_KEY_ALG_ID == MBEDTLS_ECDSA)
+/*
+ * Verify an ECDSA signature with a P-256 public key, using the persistent
+ * context. Return 0 on success, as mbedtls_pk_verify_ext() does.
+ */
+static int verify_ecdsa_p256(mbedtls_pk_context *pk, unsigned char *hash,
+			     size_t hash_len, unsigned char *sig,
+			     size_t sig_len)
+{
+	int rc;
+
+	rc = mbedtls_ecp_copy(&ecdsa_p256.Q, &mbedtls_pk_ec(*pk)->Q);
+	if (rc != 0) {
+		return rc;
+	}
+
+	return mbedtls_ecdsa_read_signature(&ecdsa_p256, hash, hash_len,
+					    sig, sig_len);
+}
+#endif
+
 /*
  * Verify a signature.
  *
@@ -84,7 +222,6 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	mbedtls_asn1_buf signature;
 	mbedtls_md_type_t md_alg;
 	mbedtls_pk_type_t pk_alg;
-	mbedtls_pk_context pk;
 	int rc;
 	void *sig_opts = NULL;
 	const mbedtls_md_info_t *md_info;
@@ -106,10 +243,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Parse the public key */
-	mbedtls_pk_init(&pk);
-	p = (unsigned char *)pk_ptr;
-	end = (unsigned char *)(p + pk_len);
-	rc = mbedtls_pk_parse_subpubkey(&p, end, &pk);
+	rc = get_sig_pk(pk_ptr, pk_len);
 	if (rc != 0) {
 		return CRYPTO_ERR_SIGNATURE;
 	}
@@ -132,16 +266,29 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 		goto end;
 	}
 	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, hash);
+	rc = calc_hash(md_info, p, data_len, hash);
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
 		goto end;
 	}
 
 	/* Verify the signature */
-	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &pk, md_alg, hash,
+#if (MBEDTLS_KEY_ALG_ID == MBEDTLS_ECDSA)
+	if ((pk_alg == MBEDTLS_PK_ECDSA) &&
+	    mbedtls_pk_can_do(&sig_pk, MBEDTLS_PK_ECDSA) &&
+	    (mbedtls_pk_ec(sig_pk)->grp.id == MBEDTLS_ECP_DP_SECP256R1)) {
+		rc = verify_ecdsa_p256(&sig_pk, hash, mbedtls_md_get_size(md_info),
+				       signature.p, signature.len);
+	} else {
+		rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &sig_pk, md_alg, hash,
+				mbedtls_md_get_size(md_info),
+				signature.p, signature.len);
+	}
+#else
+	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &sig_pk, md_alg, hash,
 			mbedtls_md_get_size(md_info),
 			signature.p, signature.len);
+#endif
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
 		goto end;
@@ -151,24 +298,26 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	rc = CRYPTO_SUCCESS;
 
 end:
-	mbedtls_pk_free(&pk);
+	put_sig_pk();
+#if MBEDTLS_HEAP_STATS
+	mbedtls_heap_report();
+#endif
 	return rc;
 }
 
 /*
- * Match a hash
+ * Obtain the hash algorithm and the hash value from a DigestInfo
  *
  * Digest info is passed in DER format following the ASN.1 structure detailed
  * above.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -192,8 +341,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -204,14 +353,36 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, data_hash);
+	rc = calc_hash(md_info, p, data_len, data_hash);
 	if (rc != 0) {
 		return CRYPTO_ERR_HASH;
 	}
@@ -225,7 +396,135 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+#if AUTH_STREAM_HASH
+/*
+ * Context of the hash calculated incrementally and the value it must match
+ */
+static mbedtls_md_context_t stream_md_ctx;
+static unsigned char stream_hash[MBEDTLS_MD_MAX_SIZE];
+static unsigned int stream_hash_len;
+static int stream_status = CRYPTO_ERR_HASH;
+#if AUTH_SHA256_CE
+static sha256_ce_ctx_t stream_ce_ctx;
+static int stream_use_ce;
+#endif
+
+/*
+ * Start an incremental hash calculation
+ */
+static int verify_hash_start(void *digest_info_ptr,
+			     unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+	stream_hash_len = mbedtls_md_get_size(md_info);
+	memcpy(stream_hash, hash, stream_hash_len);
+
+	mbedtls_md_init(&stream_md_ctx);
+
+#if AUTH_SHA256_CE
+	stream_use_ce = use_sha256_ce &&
+			(mbedtls_md_get_type(md_info) == MBEDTLS_MD_SHA256);
+	if (stream_use_ce) {
+		sha256_ce_starts(&stream_ce_ctx);
+		stream_status = CRYPTO_SUCCESS;
+		return CRYPTO_SUCCESS;
+	}
+#endif
+
+	rc = mbedtls_md_setup(&stream_md_ctx, md_info, 0);
+	if (rc == 0) {
+		rc = mbedtls_md_starts(&stream_md_ctx);
+	}
+	if (rc != 0) {
+		mbedtls_md_free(&stream_md_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	stream_status = CRYPTO_SUCCESS;
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Add data to the hash being calculated. An error is remembered and reported
+ * when the calculation is completed.
+ */
+static int verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	if (stream_status != CRYPTO_SUCCESS) {
+		return stream_status;
+	}
+
+#if AUTH_SHA256_CE
+	if (stream_use_ce) {
+		sha256_ce_update(&stream_ce_ctx, (unsigned char *)data_ptr,
+				 data_len);
+		return stream_status;
+	}
+#endif
+
+	if (mbedtls_md_update(&stream_md_ctx, (unsigned char *)data_ptr,
+			      data_len) != 0) {
+		stream_status = CRYPTO_ERR_HASH;
+	}
+
+	return stream_status;
+}
+
+/*
+ * Output the hash calculated incrementally. Return 0 on success, as
+ * mbedtls_md_finish() does.
+ */
+static int stream_hash_finish(unsigned char *data_hash)
+{
+#if AUTH_SHA256_CE
+	if (stream_use_ce) {
+		sha256_ce_finish(&stream_ce_ctx, data_hash);
+		return 0;
+	}
+#endif
+
+	return mbedtls_md_finish(&stream_md_ctx, data_hash);
+}
+
+/*
+ * Complete the hash calculation and match it with the expected value
+ */
+static int verify_hash_finish(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc = stream_status;
+
+	if ((rc == CRYPTO_SUCCESS) &&
+	    (stream_hash_finish(data_hash) != 0)) {
+		rc = CRYPTO_ERR_HASH;
+	}
+
+	if ((rc == CRYPTO_SUCCESS) &&
+	    (memcmp(data_hash, stream_hash, stream_hash_len) != 0)) {
+		rc = CRYPTO_ERR_HASH;
+	}
+
+	mbedtls_md_free(&stream_md_ctx);
+	stream_status = CRYPTO_ERR_HASH;
+
+	return rc;
+}
+#endif /* AUTH_STREAM_HASH */
+
 /*
  * Register crypto library descriptor
  */
+#if AUTH_STREAM_HASH
+REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(LIB_NAME, init, verify_signature,
+				     verify_hash, verify_hash_start,
+				     verify_hash_update, verify_hash_finish);
+#else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+#endif
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
 #
 # Redistribution and use in source and binary forms, with or without
 # modification, are permitted provided that the following conditions are met:
@@ -65,6 +65,13 @@ else
     $(error "MBEDTLS_KEY_ALG=${MBEDTLS_KEY_ALG} not supported on mbed TLS")
 endif
 
+# SHA-256 using the ARMv8 Cryptographic Extension, falling back to mbed TLS at
+# runtime if the CPU does not implement it
+ifeq (${AUTH_SHA256_CE},1)
+    MBEDTLS_CRYPTO_SOURCES	+=	drivers/auth/sha256_ce/sha256_ce.c	\
+    					drivers/auth/sha256_ce/sha256_ce_helpers.S
+endif
+
 # mbed TLS libraries rely on this define to build correctly
 $(eval $(call add_define,MBEDTLS_KEY_ALG_ID))
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -53,79 +53,79 @@
 
 #define LIB_NAME	"mbed TLS X509v3"
 
+/* Maximum number of X509v3 extensions in a certificate */
+#define MAX_CERT_EXTS			16
+
 /* Temporary variables to speed up the authentication parameters search. These
  * variables are assigned once during the integrity check and used any time an
  * authentication parameter is requested, so we do not have to parse the image
  * again */
 static mbedtls_asn1_buf tbs;
-static mbedtls_asn1_buf v3_ext;
 static mbedtls_asn1_buf pk;
 static mbedtls_asn1_buf sig_alg;
 static mbedtls_asn1_buf signature;
 
+/* Extensions found in the certificate during the integrity check */
+static struct {
+	mbedtls_asn1_buf oid;		/* Extension ID */
+	void *data;			/* Contents of the extension value */
+	unsigned int len;
+} exts[MAX_CERT_EXTS];
+static unsigned int num_exts;
+
+/* Extensions requested so far, looked up by parameter type descriptor */
+static struct {
+	const auth_param_type_desc_t *type_desc;
+	void *data;
+	unsigned int len;
+} ext_params[MAX_CERT_EXTS];
+static unsigned int num_ext_params;
+
 /*
  * Get X509v3 extension
  *
- * Global variable 'v3_ext' must point to the extensions region
- * in the certificate. No need to check for errors since the image has passed
- * the integrity check.
+ * The extensions have been located by the integrity check, so only their IDs
+ * have to be compared. The result is kept for further requests of the same
+ * parameter until the next certificate is parsed.
  */
-static int get_ext(const char *oid, void **ext, unsigned int *ext_len)
+static int get_ext(const auth_param_type_desc_t *type_desc,
+		   void **ext, unsigned int *ext_len)
 {
 	int oid_len;
-	size_t len;
-	unsigned char *end_ext_data, *end_ext_octet;
-	unsigned char *p;
-	const unsigned char *end;
+	unsigned int i;
 	char oid_str[MAX_OID_STR_LEN];
-	mbedtls_asn1_buf extn_oid;
-	int is_critical;
 
-	assert(oid != NULL);
+	assert(type_desc->cookie != NULL);
 
-	p = v3_ext.p;
-	end = v3_ext.p + v3_ext.len;
-
-	mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
-			     MBEDTLS_ASN1_SEQUENCE);
-
-	while (p < end) {
-		memset(&extn_oid, 0x0, sizeof(extn_oid));
-		is_critical = 0; /* DEFAULT FALSE */
-
-		mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
-				     MBEDTLS_ASN1_SEQUENCE);
-		end_ext_data = p + len;
-
-		/* Get extension ID */
-		extn_oid.tag = *p;
-		mbedtls_asn1_get_tag(&p, end, &extn_oid.len, MBEDTLS_ASN1_OID);
-		extn_oid.p = p;
-		p += extn_oid.len;
-
-		/* Get optional critical */
-		mbedtls_asn1_get_bool(&p, end_ext_data, &is_critical);
-
-		/* Extension data */
-		mbedtls_asn1_get_tag(&p, end_ext_data, &len,
-				     MBEDTLS_ASN1_OCTET_STRING);
-		end_ext_octet = p + len;
+	for (i = 0 ; i < num_ext_params ; i++) {
+		if (ext_params[i].type_desc == type_desc) {
+			*ext = ext_params[i].data;
+			*ext_len = ext_params[i].len;
+			return IMG_PARSER_OK;
+		}
+	}
 
+	for (i = 0 ; i < num_exts ; i++) {
 		/* Detect requested extension */
 		oid_len = mbedtls_oid_get_numeric_string(oid_str,
 							 MAX_OID_STR_LEN,
-							 &extn_oid);
+							 &exts[i].oid);
 		if (oid_len == MBEDTLS_ERR_OID_BUF_TOO_SMALL) {
 			return IMG_PARSER_ERR;
 		}
-		if ((oid_len == strlen(oid_str)) && !strcmp(oid, oid_str)) {
-			*ext = (void *)p;
-			*ext_len = (unsigned int)len;
+		if ((oid_len == strlen(oid_str)) &&
+		    !strcmp(type_desc->cookie, oid_str)) {
+			*ext = exts[i].data;
+			*ext_len = exts[i].len;
+
+			if (num_ext_params < MAX_CERT_EXTS) {
+				i = num_ext_params++;
+				ext_params[i].type_desc = type_desc;
+				ext_params[i].data = *ext;
+				ext_params[i].len = *ext_len;
+			}
 			return IMG_PARSER_OK;
 		}
-
-		/* Next */
-		p = end_ext_octet;
 	}
 
 	return IMG_PARSER_ERR_NOT_FOUND;
@@ -143,6 +143,9 @@ static int cert_parse(void *img, unsigned int img_len)
 	unsigned char *p, *end, *crt_end;
 	mbedtls_asn1_buf sig_alg1, sig_alg2;
 
+	num_exts = 0;
+	num_ext_params = 0;
+
 	p = (unsigned char *)img;
 	len = img_len;
 	end = p + len;
@@ -297,18 +300,20 @@ static int cert_parse(void *img, unsigned int img_len)
 	/*
 	 * Extensions  ::=  SEQUENCE SIZE (1..MAX) OF Extension
 	 */
-	v3_ext.p = p;
 	ret = mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
 				   MBEDTLS_ASN1_SEQUENCE);
 	if (ret != 0) {
 		return IMG_PARSER_ERR_FORMAT;
 	}
-	v3_ext.len = (p + len) - v3_ext.p;
 
 	/*
-	 * Check extensions integrity
+	 * Check extensions integrity and record where they are
 	 */
 	while (p < end) {
+		if (num_exts == MAX_CERT_EXTS) {
+			return IMG_PARSER_ERR_FORMAT;
+		}
+
 		ret = mbedtls_asn1_get_tag(&p, end, &len,
 					   MBEDTLS_ASN1_CONSTRUCTED |
 					   MBEDTLS_ASN1_SEQUENCE);
@@ -317,11 +322,14 @@ static int cert_parse(void *img, unsigned int img_len)
 		}
 
 		/* Get extension ID */
-		ret = mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_OID);
+		exts[num_exts].oid.tag = *p;
+		ret = mbedtls_asn1_get_tag(&p, end, &exts[num_exts].oid.len,
+					   MBEDTLS_ASN1_OID);
 		if (ret != 0) {
 			return IMG_PARSER_ERR_FORMAT;
 		}
-		p += len;
+		exts[num_exts].oid.p = p;
+		p += exts[num_exts].oid.len;
 
 		/* Get optional critical */
 		ret = mbedtls_asn1_get_bool(&p, end, &is_critical);
@@ -335,6 +343,9 @@ static int cert_parse(void *img, unsigned int img_len)
 		if (ret != 0) {
 			return IMG_PARSER_ERR_FORMAT;
 		}
+		exts[num_exts].data = (void *)p;
+		exts[num_exts].len = (unsigned int)len;
+		num_exts++;
 		p += len;
 	}
 
@@ -413,7 +424,7 @@ static int get_auth_param(const auth_param_type_desc_t *type_desc,
 	int rc = IMG_PARSER_OK;
 
 	/* We do not use img because the check_integrity function has already
-	 * extracted the relevant data (v3_ext, pk, sig_alg, etc) */
+	 * extracted the relevant data (exts, pk, sig_alg, etc) */
 
 	switch (type_desc->type) {
 	case AUTH_PARAM_RAW_DATA:
@@ -423,12 +434,12 @@ static int get_auth_param(const auth_param_type_desc_t *type_desc,
 		break;
 	case AUTH_PARAM_HASH:
 		/* All these parameters are included as X509v3 extensions */
-		rc = get_ext(type_desc->cookie, param, param_len);
+		rc = get_ext(type_desc, param, param_len);
 		break;
 	case AUTH_PARAM_PUB_KEY:
 		if (type_desc->cookie != 0) {
 			/* Get public key from extension */
-			rc = get_ext(type_desc->cookie, param, param_len);
+			rc = get_ext(type_desc, param, param_len);
 		} else {
 			/* Get the subject public key */
 			*param = (void *)pk.p;
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <sha256_ce.h>
+#include <string.h>
+
+/* Initial hash value, as defined in FIPS 180-4 */
+static const uint32_t sha256_ce_init_state[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/*
+ * Return non-zero if the CPU implements the SHA-256 instructions
+ */
+int sha256_ce_supported(void)
+{
+	return ((read_id_aa64isar0_el1() >> ID_AA64ISAR0_SHA2_SHIFT) &
+		ID_AA64ISAR0_SHA2_MASK) != 0;
+}
+
+/*
+ * Start an incremental hash calculation
+ */
+void sha256_ce_starts(sha256_ce_ctx_t *ctx)
+{
+	memcpy(ctx->state, sha256_ce_init_state, sizeof(ctx->state));
+	ctx->total_len = 0;
+}
+
+/*
+ * Add data to the hash being calculated. Whole blocks are hashed straight from
+ * 'data', only the data left over is buffered in the context.
+ */
+void sha256_ce_update(sha256_ce_ctx_t *ctx, const unsigned char *data,
+		      unsigned int len)
+{
+	unsigned int used = ctx->total_len % SHA256_CE_BLOCK_SIZE;
+	unsigned int n;
+
+	ctx->total_len += len;
+
+	/* Complete the block buffered by the previous calls first */
+	if (used) {
+		n = SHA256_CE_BLOCK_SIZE - used;
+		if (len < n) {
+			memcpy(ctx->buf + used, data, len);
+			return;
+		}
+		memcpy(ctx->buf + used, data, n);
+		sha256_ce_transform(ctx->state, ctx->buf, 1);
+		data += n;
+		len -= n;
+	}
+
+	n = len / SHA256_CE_BLOCK_SIZE;
+	if (n)
+		sha256_ce_transform(ctx->state, data, n);
+
+	memcpy(ctx->buf, data + n * SHA256_CE_BLOCK_SIZE,
+	       len % SHA256_CE_BLOCK_SIZE);
+}
+
+/*
+ * Pad the data hashed so far as defined in FIPS 180-4 and output the digest
+ */
+void sha256_ce_finish(sha256_ce_ctx_t *ctx,
+		      unsigned char digest[SHA256_CE_DIGEST_SIZE])
+{
+	uint64_t bit_len = ctx->total_len * 8;
+	unsigned int used = ctx->total_len % SHA256_CE_BLOCK_SIZE;
+	unsigned int i;
+
+	/* Append a single 1 bit, then the zero bits and the length */
+	ctx->buf[used++] = 0x80;
+	if (used > SHA256_CE_BLOCK_SIZE - sizeof(bit_len)) {
+		memset(ctx->buf + used, 0, SHA256_CE_BLOCK_SIZE - used);
+		sha256_ce_transform(ctx->state, ctx->buf, 1);
+		used = 0;
+	}
+	memset(ctx->buf + used, 0,
+	       SHA256_CE_BLOCK_SIZE - sizeof(bit_len) - used);
+
+	for (i = 0; i < sizeof(bit_len); i++)
+		ctx->buf[SHA256_CE_BLOCK_SIZE - 1 - i] = bit_len >> (8 * i);
+	sha256_ce_transform(ctx->state, ctx->buf, 1);
+
+	/* The digest is the big-endian representation of the state */
+	for (i = 0; i < 8; i++) {
+		digest[4 * i] = ctx->state[i] >> 24;
+		digest[4 * i + 1] = ctx->state[i] >> 16;
+		digest[4 * i + 2] = ctx->state[i] >> 8;
+		digest[4 * i + 3] = ctx->state[i];
+	}
+}
+
+/*
+ * Calculate the hash of a buffer in one go
+ */
+void sha256_ce(const unsigned char *data, unsigned int len,
+	       unsigned char digest[SHA256_CE_DIGEST_SIZE])
+{
+	sha256_ce_ctx_t ctx;
+
+	sha256_ce_starts(&ctx);
+	sha256_ce_update(&ctx, data, len);
+	sha256_ce_finish(&ctx, digest);
+}
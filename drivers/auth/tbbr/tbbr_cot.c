@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -39,6 +39,21 @@
 #define PK_DER_LEN			294
 #define HASH_DER_LEN			51
 
+#if AUTH_PARAM_POOL
+/*
+ * The authentication parameters extracted from the certificates are stored in
+ * a pool shared by all of them. It must at least hold the parameters of the
+ * Trusted Key certificate. Certificates whose parameters are dropped to make
+ * room for others are loaded again when needed.
+ */
+#ifndef AUTH_PARAM_POOL_SIZE
+#define AUTH_PARAM_POOL_SIZE		(2 * PK_DER_LEN + HASH_DER_LEN)
+#endif
+
+static uint8_t param_pool[AUTH_PARAM_POOL_SIZE];
+
+#define PARAM_BUF(_buf)			NULL
+#else
 /*
  * The platform must allocate buffers to store the authentication parameters
  * extracted from the certificates. In this case, because of the way the CoT is
@@ -53,6 +68,28 @@ static unsigned char trusted_world_pk_buf[PK_DER_LEN];
 static unsigned char non_trusted_world_pk_buf[PK_DER_LEN];
 static unsigned char content_pk_buf[PK_DER_LEN];
 
+#define PARAM_BUF(_buf)			(void *)_buf
+#endif
+
+/*
+ * Slots of the parameters in the 'authenticated_data' array of the image they
+ * are extracted from
+ */
+#define TB_FW_HASH_SLOT			0
+#define TRUSTED_WORLD_PK_SLOT		0
+#define NON_TRUSTED_WORLD_PK_SLOT	1
+#define SCP_FW_CONTENT_PK_SLOT		0
+#define SOC_FW_CONTENT_PK_SLOT		0
+#define TOS_FW_CONTENT_PK_SLOT		0
+#define NT_FW_CONTENT_PK_SLOT		0
+#define SCP_FW_HASH_SLOT		0
+#define SOC_FW_HASH_SLOT		0
+#define TOS_FW_HASH_SLOT		0
+#define NT_WORLD_BL_HASH_SLOT		0
+#define SCP_BL2U_HASH_SLOT		0
+#define BL2U_HASH_SLOT			1
+#define NS_BL2U_HASH_SLOT		2
+
 /*
  * Parameter type descriptors
  */
@@ -65,36 +102,50 @@ static auth_param_type_desc_t sig_alg = AUTH_PARAM_TYPE_DESC(
 static auth_param_type_desc_t raw_data = AUTH_PARAM_TYPE_DESC(
 		AUTH_PARAM_RAW_DATA, 0);
 
-static auth_param_type_desc_t trusted_world_pk = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_PUB_KEY, TRUSTED_WORLD_PK_OID);
-static auth_param_type_desc_t non_trusted_world_pk = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_PUB_KEY, NON_TRUSTED_WORLD_PK_OID);
+static auth_param_type_desc_t trusted_world_pk = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_PUB_KEY, TRUSTED_WORLD_PK_OID,
+		TRUSTED_WORLD_PK_SLOT);
+static auth_param_type_desc_t non_trusted_world_pk = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_PUB_KEY, NON_TRUSTED_WORLD_PK_OID,
+		NON_TRUSTED_WORLD_PK_SLOT);
 
-static auth_param_type_desc_t scp_fw_content_pk = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_PUB_KEY, SCP_FW_CONTENT_CERT_PK_OID);
-static auth_param_type_desc_t soc_fw_content_pk = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_PUB_KEY, SOC_FW_CONTENT_CERT_PK_OID);
-static auth_param_type_desc_t tos_fw_content_pk = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_PUB_KEY, TRUSTED_OS_FW_CONTENT_CERT_PK_OID);
-static auth_param_type_desc_t nt_fw_content_pk = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_PUB_KEY, NON_TRUSTED_FW_CONTENT_CERT_PK_OID);
+static auth_param_type_desc_t scp_fw_content_pk = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_PUB_KEY, SCP_FW_CONTENT_CERT_PK_OID,
+		SCP_FW_CONTENT_PK_SLOT);
+static auth_param_type_desc_t soc_fw_content_pk = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_PUB_KEY, SOC_FW_CONTENT_CERT_PK_OID,
+		SOC_FW_CONTENT_PK_SLOT);
+static auth_param_type_desc_t tos_fw_content_pk = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_PUB_KEY, TRUSTED_OS_FW_CONTENT_CERT_PK_OID,
+		TOS_FW_CONTENT_PK_SLOT);
+static auth_param_type_desc_t nt_fw_content_pk = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_PUB_KEY, NON_TRUSTED_FW_CONTENT_CERT_PK_OID,
+		NT_FW_CONTENT_PK_SLOT);
 
-static auth_param_type_desc_t tb_fw_hash = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_HASH, TRUSTED_BOOT_FW_HASH_OID);
-static auth_param_type_desc_t scp_fw_hash = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_HASH, SCP_FW_HASH_OID);
-static auth_param_type_desc_t soc_fw_hash = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_HASH, SOC_AP_FW_HASH_OID);
-static auth_param_type_desc_t tos_fw_hash = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_HASH, TRUSTED_OS_FW_HASH_OID);
-static auth_param_type_desc_t nt_world_bl_hash = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_HASH, NON_TRUSTED_WORLD_BOOTLOADER_HASH_OID);
-static auth_param_type_desc_t scp_bl2u_hash = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_HASH, SCP_FWU_CFG_HASH_OID);
-static auth_param_type_desc_t bl2u_hash = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_HASH, AP_FWU_CFG_HASH_OID);
-static auth_param_type_desc_t ns_bl2u_hash = AUTH_PARAM_TYPE_DESC(
-		AUTH_PARAM_HASH, FWU_HASH_OID);
+static auth_param_type_desc_t tb_fw_hash = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_HASH, TRUSTED_BOOT_FW_HASH_OID,
+		TB_FW_HASH_SLOT);
+static auth_param_type_desc_t scp_fw_hash = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_HASH, SCP_FW_HASH_OID,
+		SCP_FW_HASH_SLOT);
+static auth_param_type_desc_t soc_fw_hash = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_HASH, SOC_AP_FW_HASH_OID,
+		SOC_FW_HASH_SLOT);
+static auth_param_type_desc_t tos_fw_hash = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_HASH, TRUSTED_OS_FW_HASH_OID,
+		TOS_FW_HASH_SLOT);
+static auth_param_type_desc_t nt_world_bl_hash = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_HASH, NON_TRUSTED_WORLD_BOOTLOADER_HASH_OID,
+		NT_WORLD_BL_HASH_SLOT);
+static auth_param_type_desc_t scp_bl2u_hash = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_HASH, SCP_FWU_CFG_HASH_OID,
+		SCP_BL2U_HASH_SLOT);
+static auth_param_type_desc_t bl2u_hash = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_HASH, AP_FWU_CFG_HASH_OID,
+		BL2U_HASH_SLOT);
+static auth_param_type_desc_t ns_bl2u_hash = AUTH_PARAM_TYPE_DESC_SLOT(
+		AUTH_PARAM_HASH, FWU_HASH_OID,
+		NS_BL2U_HASH_SLOT);
 
 /*
  * TBBR Chain of trust definition
@@ -119,10 +170,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[TB_FW_HASH_SLOT] = {
 				.type_desc = &tb_fw_hash,
 				.data = {
-					.ptr = (void *)tb_fw_hash_buf,
+					.ptr = PARAM_BUF(tb_fw_hash_buf),
 					.len = (unsigned int)HASH_DER_LEN
 				}
 			}
@@ -131,6 +182,21 @@ static const auth_img_desc_t cot_desc[] = {
 	[BL2_IMAGE_ID] = {
 		.img_id = BL2_IMAGE_ID,
 		.img_type = IMG_RAW,
+#if AUTH_BL2_PLAT_HASH
+		/*
+		 * BL2 is matched against the hash held by the platform, so the
+		 * Trusted Boot Firmware certificate is not needed.
+		 */
+		.parent = NULL,
+		.img_auth_methods = {
+			[0] = {
+				.type = AUTH_METHOD_PLAT_HASH,
+				.param.plat_hash = {
+					.data = &raw_data,
+				}
+			}
+		}
+#else
 		.parent = &cot_desc[TRUSTED_BOOT_FW_CERT_ID],
 		.img_auth_methods = {
 			[0] = {
@@ -141,6 +207,7 @@ static const auth_img_desc_t cot_desc[] = {
 				}
 			}
 		}
+#endif
 	},
 	/*
 	 * Trusted key certificate
@@ -161,17 +228,18 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[TRUSTED_WORLD_PK_SLOT] = {
 				.type_desc = &trusted_world_pk,
 				.data = {
-					.ptr = (void *)trusted_world_pk_buf,
+					.ptr = PARAM_BUF(trusted_world_pk_buf),
 					.len = (unsigned int)PK_DER_LEN
 				}
 			},
-			[1] = {
+			[NON_TRUSTED_WORLD_PK_SLOT] = {
 				.type_desc = &non_trusted_world_pk,
 				.data = {
-					.ptr = (void *)non_trusted_world_pk_buf,
+					.ptr = PARAM_BUF(
+						non_trusted_world_pk_buf),
 					.len = (unsigned int)PK_DER_LEN
 				}
 			}
@@ -196,10 +264,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[SCP_FW_CONTENT_PK_SLOT] = {
 				.type_desc = &scp_fw_content_pk,
 				.data = {
-					.ptr = (void *)content_pk_buf,
+					.ptr = PARAM_BUF(content_pk_buf),
 					.len = (unsigned int)PK_DER_LEN
 				}
 			}
@@ -221,10 +289,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[SCP_FW_HASH_SLOT] = {
 				.type_desc = &scp_fw_hash,
 				.data = {
-					.ptr = (void *)scp_fw_hash_buf,
+					.ptr = PARAM_BUF(scp_fw_hash_buf),
 					.len = (unsigned int)HASH_DER_LEN
 				}
 			}
@@ -263,10 +331,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[SOC_FW_CONTENT_PK_SLOT] = {
 				.type_desc = &soc_fw_content_pk,
 				.data = {
-					.ptr = (void *)content_pk_buf,
+					.ptr = PARAM_BUF(content_pk_buf),
 					.len = (unsigned int)PK_DER_LEN
 				}
 			}
@@ -288,10 +356,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[SOC_FW_HASH_SLOT] = {
 				.type_desc = &soc_fw_hash,
 				.data = {
-					.ptr = (void *)soc_fw_hash_buf,
+					.ptr = PARAM_BUF(soc_fw_hash_buf),
 					.len = (unsigned int)HASH_DER_LEN
 				}
 			}
@@ -330,10 +398,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[TOS_FW_CONTENT_PK_SLOT] = {
 				.type_desc = &tos_fw_content_pk,
 				.data = {
-					.ptr = (void *)content_pk_buf,
+					.ptr = PARAM_BUF(content_pk_buf),
 					.len = (unsigned int)PK_DER_LEN
 				}
 			}
@@ -355,10 +423,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[TOS_FW_HASH_SLOT] = {
 				.type_desc = &tos_fw_hash,
 				.data = {
-					.ptr = (void *)tos_fw_hash_buf,
+					.ptr = PARAM_BUF(tos_fw_hash_buf),
 					.len = (unsigned int)HASH_DER_LEN
 				}
 			}
@@ -397,10 +465,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[NT_FW_CONTENT_PK_SLOT] = {
 				.type_desc = &nt_fw_content_pk,
 				.data = {
-					.ptr = (void *)content_pk_buf,
+					.ptr = PARAM_BUF(content_pk_buf),
 					.len = (unsigned int)PK_DER_LEN
 				}
 			}
@@ -422,10 +490,10 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[NT_WORLD_BL_HASH_SLOT] = {
 				.type_desc = &nt_world_bl_hash,
 				.data = {
-					.ptr = (void *)nt_world_bl_hash_buf,
+					.ptr = PARAM_BUF(nt_world_bl_hash_buf),
 					.len = (unsigned int)HASH_DER_LEN
 				}
 			}
@@ -464,24 +532,24 @@ static const auth_img_desc_t cot_desc[] = {
 			}
 		},
 		.authenticated_data = {
-			[0] = {
+			[SCP_BL2U_HASH_SLOT] = {
 				.type_desc = &scp_bl2u_hash,
 				.data = {
-					.ptr = (void *)scp_fw_hash_buf,
+					.ptr = PARAM_BUF(scp_fw_hash_buf),
 					.len = (unsigned int)HASH_DER_LEN
 				}
 			},
-			[1] = {
+			[BL2U_HASH_SLOT] = {
 				.type_desc = &bl2u_hash,
 				.data = {
-					.ptr = (void *)tb_fw_hash_buf,
+					.ptr = PARAM_BUF(tb_fw_hash_buf),
 					.len = (unsigned int)HASH_DER_LEN
 				}
 			},
-			[2] = {
+			[NS_BL2U_HASH_SLOT] = {
 				.type_desc = &ns_bl2u_hash,
 				.data = {
-					.ptr = (void *)nt_world_bl_hash_buf,
+					.ptr = PARAM_BUF(nt_world_bl_hash_buf),
 					.len = (unsigned int)HASH_DER_LEN
 				}
 			}
@@ -542,3 +610,6 @@ static const auth_img_desc_t cot_desc[] = {
 
 /* Register the CoT in the authentication module */
 REGISTER_COT(cot_desc);
+#if AUTH_PARAM_POOL
+REGISTER_COT_PARAM_POOL(param_pool);
+#endif
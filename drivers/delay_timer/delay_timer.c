@@ -48,7 +48,15 @@ void udelay(uint32_t usec)
 		(ops->clk_div != 0) &&
 		(ops->get_timer_value != 0));
 
-	uint32_t start, cnt, delta, delta_us;
+	uint32_t start, cnt, delta;
+	uint64_t ticks;
+
+	/*
+	 * Convert the delay into timer ticks once, rounding up, so that
+	 * the polling loop does not divide.
+	 */
+	ticks = ((uint64_t)usec * ops->clk_div + ops->clk_mult - 1) /
+		ops->clk_mult;
 
 	/* counter is decreasing */
 	start = ops->get_timer_value();
@@ -59,8 +67,17 @@ void udelay(uint32_t usec)
 			delta += start;
 		} else
 			delta = start - cnt;
-		delta_us = (delta * ops->clk_mult) / ops->clk_div;
-	} while (delta_us < usec);
+	} while (delta < ticks);
+}
+
+/***********************************************************
+ * Delay for the given number of nanoseconds, rounded up to
+ * the next microsecond. The driver must be initialized before
+ * calling this function.
+ ***********************************************************/
+void ndelay(uint32_t nsec)
+{
+	udelay((nsec / 1000) + ((nsec % 1000) ? 1 : 0));
 }
 
 /***********************************************************
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <debug.h>
+#include <delay_timer.h>
+#include <errno.h>
+#include <mmio.h>
+#include <stdint.h>
+
+#define NSEC_PER_SEC		1000000000ULL
+
+/* Period of the event stream waking up wait_for_condition() */
+#define WAIT_EVENT_PERIOD_NS	1000
+
+/***********************************************************
+ * Delay timer implementation based on the system counter
+ * of the Generic Timer. A number of nanoseconds is turned
+ * into counter ticks with a multiplication and a shift:
+ * ticks = (nsec * ns_to_ticks_mult) >> 32.
+ ***********************************************************/
+static uint64_t ns_to_ticks_mult;
+
+/* Counter bit whose transitions generate the event stream */
+static unsigned int wait_evnti;
+
+/* Statistics of wait_for_condition(), updated without locking */
+static wait_stats_t wait_stats;
+
+static uint64_t ns_to_ticks(uint64_t nsec)
+{
+	/*
+	 * 'ns_to_ticks_mult' is at most 2^32, so splitting
+	 * 'nsec' into two 32-bit halves avoids any overflow.
+	 */
+	return (nsec >> 32) * ns_to_ticks_mult +
+		(((nsec & UINT32_MAX) * ns_to_ticks_mult) >> 32);
+}
+
+static void counter_delay(uint64_t nsec)
+{
+	uint64_t start, ticks;
+
+	assert(ns_to_ticks_mult != 0);
+
+	ticks = ns_to_ticks(nsec);
+	start = read_cntpct_el0();
+	while ((read_cntpct_el0() - start) < ticks)
+		;
+}
+
+/***********************************************************
+ * Delay for the given number of nanoseconds, rounded up to
+ * the next system counter tick. The driver must be
+ * initialized before calling this function.
+ ***********************************************************/
+void ndelay(uint32_t nsec)
+{
+	counter_delay(nsec);
+}
+
+/***********************************************************
+ * Delay for the given number of microseconds. The driver must
+ * be initialized before calling this function.
+ ***********************************************************/
+void udelay(uint32_t usec)
+{
+	counter_delay((uint64_t)usec * 1000);
+}
+
+/***********************************************************
+ * Delay for the given number of milliseconds. The driver must
+ * be initialized before calling this function.
+ ***********************************************************/
+void mdelay(uint32_t msec)
+{
+	counter_delay((uint64_t)msec * 1000000);
+}
+
+/***********************************************************
+ * Wait until the 32-bit register at 'addr', masked with
+ * 'mask', reads 'value', for at most 'timeout_us'
+ * microseconds. The CPU sleeps in WFE between two reads, woken
+ * up by the event stream of the Generic Timer, which is
+ * enabled for the duration of the wait. Returns 0 on success
+ * or -ETIMEDOUT.
+ ***********************************************************/
+int wait_for_condition(uintptr_t addr, uint32_t mask, uint32_t value,
+		       uint32_t timeout_us)
+{
+	uint64_t start, elapsed, ticks;
+	uint64_t cntkctl;
+	int rc = 0;
+
+	assert(ns_to_ticks_mult != 0);
+
+	ticks = ns_to_ticks((uint64_t)timeout_us * 1000);
+
+	/* CNTKCTL_EL1 belongs to the world that called into EL3 */
+	cntkctl = read_cntkctl_el1();
+	write_cntkctl_el1((cntkctl & ~(EVNTDIR_BIT |
+				       (EVNTI_MASK << EVNTI_SHIFT))) |
+			  EVNTEN_BIT | (wait_evnti << EVNTI_SHIFT));
+	isb();
+
+	start = read_cntpct_el0();
+	while ((mmio_read_32(addr) & mask) != value) {
+		if ((read_cntpct_el0() - start) >= ticks) {
+			rc = -ETIMEDOUT;
+			break;
+		}
+		wfe();
+	}
+	elapsed = read_cntpct_el0() - start;
+
+	write_cntkctl_el1(cntkctl);
+	isb();
+
+	wait_stats.waits++;
+	if (elapsed > wait_stats.max_wait_ticks)
+		wait_stats.max_wait_ticks = elapsed;
+
+	if (rc) {
+		wait_stats.timeouts++;
+		WARN("Timeout waiting for 0x%lx & 0x%x == 0x%x (%u of %u waits)\n",
+		     addr, mask, value, wait_stats.timeouts, wait_stats.waits);
+	}
+
+	return rc;
+}
+
+/***********************************************************
+ * Return the statistics of wait_for_condition() since boot.
+ ***********************************************************/
+void wait_for_condition_stats(wait_stats_t *stats)
+{
+	*stats = wait_stats;
+}
+
+/***********************************************************
+ * Initialize the timer from the frequency of the system
+ * counter programmed in CNTFRQ_EL0, which must not exceed
+ * 1GHz. The conversion factor is rounded up so that the
+ * delays are never shorter than requested.
+ ***********************************************************/
+void generic_delay_timer_init(void)
+{
+	uint64_t freq = read_cntfrq_el0();
+
+	assert((freq != 0) && (freq <= NSEC_PER_SEC));
+
+	ns_to_ticks_mult = ((freq << 32) + NSEC_PER_SEC - 1) / NSEC_PER_SEC;
+
+	/*
+	 * An event is generated each time counter bit 'wait_evnti'
+	 * changes, i.e. every 2^(wait_evnti + 1) ticks. Pick the
+	 * longest period not exceeding WAIT_EVENT_PERIOD_NS.
+	 */
+	wait_evnti = 0;
+	while ((wait_evnti < EVNTI_MASK) &&
+	       ((2ULL << (wait_evnti + 1)) <= ns_to_ticks(WAIT_EVENT_PERIOD_NS)))
+		wait_evnti++;
+}
@@ -80,9 +80,79 @@ void gpio_set_value(int gpio, int value)
 	ops->set_value(gpio, value);
 }
 
+/*
+ * Set the direction of the GPIOs selected by 'mask', bit N of which selects
+ * the GPIO 'gpio + N', to the GPIO_DIR_* value in the matching bit of
+ * 'directions'.
+ */
+void gpio_set_directions(int gpio, unsigned int mask, unsigned int directions)
+{
+	int i;
+
+	assert(ops);
+	assert(gpio >= 0);
+
+	if (ops->set_directions != 0) {
+		ops->set_directions(gpio, mask, directions);
+		return;
+	}
+
+	for (i = 0; mask != 0; i++, mask >>= 1, directions >>= 1) {
+		if (mask & 1)
+			ops->set_direction(gpio + i, directions & 1);
+	}
+}
+
+/*
+ * Return the levels of the GPIOs selected by 'mask', bit N of which selects
+ * the GPIO 'gpio + N'. The bits not selected by 'mask' are 0.
+ */
+unsigned int gpio_get_values(int gpio, unsigned int mask)
+{
+	unsigned int values = 0;
+	int i;
+
+	assert(ops);
+	assert(gpio >= 0);
+
+	if (ops->get_values != 0)
+		return ops->get_values(gpio, mask);
+
+	for (i = 0; (mask >> i) != 0; i++) {
+		if (((mask >> i) & 1) &&
+		    (ops->get_value(gpio + i) == GPIO_LEVEL_HIGH))
+			values |= 1U << i;
+	}
+
+	return values;
+}
+
+/*
+ * Set the GPIOs selected by 'mask', bit N of which selects the GPIO
+ * 'gpio + N', to the GPIO_LEVEL_* value in the matching bit of 'values'.
+ */
+void gpio_set_values(int gpio, unsigned int mask, unsigned int values)
+{
+	int i;
+
+	assert(ops);
+	assert(gpio >= 0);
+
+	if (ops->set_values != 0) {
+		ops->set_values(gpio, mask, values);
+		return;
+	}
+
+	for (i = 0; mask != 0; i++, mask >>= 1, values >>= 1) {
+		if (mask & 1)
+			ops->set_value(gpio + i, values & 1);
+	}
+}
+
 /*
  * Initialize the gpio. The fields in the provided gpio
- * ops pointer must be valid.
+ * ops pointer must be valid, except for the optional
+ * operations on several GPIOs.
  */
 void gpio_init(const gpio_ops_t *ops_ptr)
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -36,6 +36,7 @@
 #include <io_driver.h>
 #include <io_fip.h>
 #include <io_storage.h>
+#include <lz4_stream.h>
 #include <platform.h>
 #include <platform_def.h>
 #include <stdint.h>
@@ -57,13 +58,80 @@ typedef struct {
 	 */
 	unsigned int file_pos;
 	fip_toc_entry_t entry;
+	/* Backend entity used by an asynchronous read in progress */
+	uintptr_t async_backend;
+#if FIP_DECOMPRESS
+	/* State of the decompression of a compressed file */
+	lz4_stream_t lz4;
+	/* Offset of the next compressed data to read from the payload */
+	size_t comp_pos;
+	/* Compressed data read but not yet decompressed in fip_comp_buf */
+	size_t comp_buf_pos;
+	size_t comp_buf_len;
+#endif
 } file_state_t;
 
+/*
+ * Number of Table of Contents entries cached by fip_dev_init(). A package
+ * with more entries is still usable: the entries that do not fit in the
+ * cache are looked up by scanning the ToC in the backend.
+ */
+#ifndef FIP_TOC_CACHE_ENTRIES
+#define FIP_TOC_CACHE_ENTRIES	16
+#endif
+
+/*
+ * Number of files in package which can be open at the same time, e.g. a
+ * certificate and the image it covers.
+ */
+#ifndef FIP_MAX_FILES
+#define FIP_MAX_FILES		1
+#endif
+
 static const uuid_t uuid_null = {0};
-static file_state_t current_file = {0};
+/*
+ * State of the open files. A slot is free when its ToC entry offset is zero,
+ * as the header lives at offset zero.
+ */
+static file_state_t fip_files[FIP_MAX_FILES];
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
 
+/*
+ * Image id of the package the device has been initialised with, or
+ * INVALID_IMAGE_ID. While it is valid, the header has been checked and the ToC
+ * index below describes the package.
+ */
+static unsigned int fip_image_id = INVALID_IMAGE_ID;
+
+/* In-memory ToC index, sorted by UUID */
+static fip_toc_entry_t toc_cache[FIP_TOC_CACHE_ENTRIES];
+static unsigned int toc_cache_count;
+/* Set when the index holds every entry of the ToC */
+static int toc_cache_complete;
+
+#if FIP_DECOMPRESS
+/*
+ * Size of the buffer the payload of a compressed file is read into before
+ * being decompressed to its destination.
+ */
+#ifndef FIP_COMP_BUF_SIZE
+#define FIP_COMP_BUF_SIZE	4096
+#endif
+
+static uint8_t fip_comp_buf[FIP_COMP_BUF_SIZE];
+/* Compressed file whose data fip_comp_buf holds */
+static file_state_t *fip_comp_buf_owner;
+#endif
+
+#if FIP_PERSISTENT_BACKEND
+/*
+ * In persistent mode the backend entity is opened by fip_dev_init() and kept
+ * open until fip_dev_close(), so that file accesses only need to seek.
+ */
+static uintptr_t backend_handle_cache;
+#endif
+
 
 /* Firmware Image Package driver functions */
 static int fip_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
@@ -75,6 +143,11 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 static int fip_file_close(io_entity_t *entity);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
+static int fip_file_block_size(io_entity_t *entity, size_t *block_size);
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length);
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read);
+static int fip_file_address(io_entity_t *entity, uintptr_t *address);
 
 
 /* Return 0 for equal uuids. */
@@ -84,6 +157,114 @@ static inline int compare_uuids(const uuid_t *uuid1, const uuid_t *uuid2)
 }
 
 
+/* Forget the cached ToC */
+static void toc_cache_invalidate(void)
+{
+	fip_image_id = INVALID_IMAGE_ID;
+	toc_cache_count = 0;
+	toc_cache_complete = 0;
+}
+
+
+/*
+ * Read the ToC following the header from the backend and build the sorted
+ * index. The backend cursor must be positioned just after the header.
+ */
+static int toc_cache_fill(uintptr_t backend_handle)
+{
+	int result;
+	fip_toc_entry_t entry;
+	size_t bytes_read;
+	unsigned int i;
+
+	toc_cache_count = 0;
+	toc_cache_complete = 0;
+
+	for (;;) {
+		result = io_read(backend_handle, (uintptr_t)&entry,
+				 sizeof(entry), &bytes_read);
+		if ((result != 0) || (bytes_read != sizeof(entry))) {
+			WARN("Failed to read FIP (%i)\n", result);
+			return -ENOENT;
+		}
+
+		if (compare_uuids(&entry.uuid, &uuid_null) == 0) {
+			toc_cache_complete = 1;
+			break;
+		}
+
+		if (toc_cache_count == FIP_TOC_CACHE_ENTRIES) {
+			VERBOSE("FIP ToC does not fit in the cache\n");
+			break;
+		}
+
+		/* Insertion sort: the ToC only has a handful of entries */
+		for (i = toc_cache_count; i > 0; i--) {
+			if (compare_uuids(&toc_cache[i - 1].uuid,
+					  &entry.uuid) < 0)
+				break;
+			toc_cache[i] = toc_cache[i - 1];
+		}
+		toc_cache[i] = entry;
+		toc_cache_count++;
+	}
+
+	return 0;
+}
+
+
+/* Binary search the ToC index. Return 0 and copy the entry if found. */
+static int toc_cache_lookup(const uuid_t *uuid, fip_toc_entry_t *entry)
+{
+	unsigned int low = 0, high = toc_cache_count;
+	unsigned int mid;
+	int cmp;
+
+	while (low < high) {
+		mid = low + (high - low) / 2;
+		cmp = compare_uuids(&toc_cache[mid].uuid, uuid);
+		if (cmp == 0) {
+			*entry = toc_cache[mid];
+			return 0;
+		}
+
+		if (cmp < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return -ENOENT;
+}
+
+
+/*
+ * Obtain a handle to the backend entity containing the package. The handle
+ * must be released with backend_put() once the access is complete.
+ */
+static int backend_get(uintptr_t *backend_handle)
+{
+#if FIP_PERSISTENT_BACKEND
+	if (backend_handle_cache != (uintptr_t)NULL) {
+		*backend_handle = backend_handle_cache;
+		return 0;
+	}
+#endif
+	return io_open(backend_dev_handle, backend_image_spec, backend_handle);
+}
+
+
+static void backend_put(uintptr_t backend_handle)
+{
+#if FIP_PERSISTENT_BACKEND
+	/* The persistent backend is only closed in fip_dev_close() */
+	if (backend_handle == backend_handle_cache)
+		return;
+#endif
+	io_close(backend_handle);
+}
+
+
 /* TODO: We could check version numbers or do a package checksum? */
 static inline int is_valid_header(fip_toc_header_t *header)
 {
@@ -95,6 +276,59 @@ static inline int is_valid_header(fip_toc_header_t *header)
 }
 
 
+/* Return the compression method of a file in package */
+static inline unsigned int fip_file_compression(const file_state_t *fp)
+{
+	return (fp->entry.flags >> TOC_ENTRY_FLAGS_COMPRESSION_SHIFT) &
+		TOC_ENTRY_FLAGS_COMPRESSION_MASK;
+}
+
+
+/* Return a free file state, or NULL if all of them are in use */
+static file_state_t *fip_file_alloc(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < FIP_MAX_FILES; i++) {
+		if (fip_files[i].entry.offset_address == 0)
+			return &fip_files[i];
+	}
+
+	return NULL;
+}
+
+
+/*
+ * Finish opening the file whose ToC entry has just been found in 'fp'. A
+ * compressed file can only be opened if the driver knows how to decompress it.
+ */
+static int fip_file_start(io_entity_t *entity, file_state_t *fp)
+{
+	unsigned int compression = fip_file_compression(fp);
+
+#if FIP_DECOMPRESS
+	if (compression == TOC_ENTRY_COMPRESSION_LZ4)
+		compression = TOC_ENTRY_COMPRESSION_NONE;
+#endif
+	if (compression != TOC_ENTRY_COMPRESSION_NONE) {
+		WARN("FIP entry uses unsupported compression %u\n",
+		     compression);
+		fp->entry.offset_address = 0;
+		return -ENOENT;
+	}
+
+	fp->file_pos = 0;
+#if FIP_DECOMPRESS
+	fp->comp_pos = 0;
+	fp->comp_buf_pos = 0;
+	fp->comp_buf_len = 0;
+#endif
+	entity->info = (uintptr_t)fp;
+
+	return 0;
+}
+
+
 /* Identify the device type as a virtual driver */
 io_type_t device_type_fip(void)
 {
@@ -117,6 +351,10 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
 	.dev_close = fip_dev_close,
+	.block_size = fip_file_block_size,
+	.read_start = fip_file_read_start,
+	.read_wait = fip_file_read_wait,
+	.address = fip_file_address,
 };
 
 
@@ -138,7 +376,7 @@ static int fip_dev_open(const uintptr_t dev_spec __unused,
 }
 
 
-/* Do some basic package checks. */
+/* Do some basic package checks and index the Table of Contents. */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
@@ -147,6 +385,18 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 	fip_toc_header_t header;
 	size_t bytes_read;
 
+	/* The package has already been checked and indexed */
+	if (fip_image_id == image_id)
+		return 0;
+
+#if FIP_PERSISTENT_BACKEND
+	if (backend_handle_cache != (uintptr_t)NULL) {
+		io_close(backend_handle_cache);
+		backend_handle_cache = (uintptr_t)NULL;
+	}
+#endif
+	toc_cache_invalidate();
+
 	/* Obtain a reference to the image by querying the platform layer */
 	result = plat_get_image_source(image_id, &backend_dev_handle,
 				       &backend_image_spec);
@@ -174,9 +424,20 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			result = -ENOENT;
 		} else {
 			VERBOSE("FIP header looks OK.\n");
+			result = toc_cache_fill(backend_handle);
 		}
 	}
 
+	if (result == 0)
+		fip_image_id = image_id;
+
+#if FIP_PERSISTENT_BACKEND
+	if (result == 0) {
+		/* Keep the backend open until the device is closed */
+		backend_handle_cache = backend_handle;
+		goto fip_dev_init_exit;
+	}
+#endif
 	io_close(backend_handle);
 
  fip_dev_init_exit:
@@ -188,6 +449,14 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 {
 	/* TODO: Consider tracking open files and cleaning them up here */
 
+#if FIP_PERSISTENT_BACKEND
+	if (backend_handle_cache != (uintptr_t)NULL) {
+		io_close(backend_handle_cache);
+		backend_handle_cache = (uintptr_t)NULL;
+	}
+#endif
+	toc_cache_invalidate();
+
 	/* Clear the backend. */
 	backend_dev_handle = (uintptr_t)NULL;
 	backend_image_spec = (uintptr_t)NULL;
@@ -205,24 +474,38 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
 	size_t bytes_read;
 	int found_file = 0;
+	file_state_t *fp;
 
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
 
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
+	/*
+	 * We need to track state like the file cursor position for each open
+	 * file, in one of the FIP_MAX_FILES file states.
 	 */
-	if (current_file.entry.offset_address != 0) {
-		WARN("fip_file_open : Only one open file at a time.\n");
+	fp = fip_file_alloc();
+	if (fp == NULL) {
+		WARN("fip_file_open : Only %u open files at a time.\n",
+		     FIP_MAX_FILES);
 		return -ENOMEM;
 	}
 
+	/* Look the file up in the ToC index built by fip_dev_init() */
+	if (fip_image_id != INVALID_IMAGE_ID) {
+		if (toc_cache_lookup(&uuid_spec->uuid, &fp->entry) == 0)
+			return fip_file_start(entity, fp);
+
+		if (toc_cache_complete)
+			return -ENOENT;
+	}
+
+	/*
+	 * Either the device has not been initialised or the ToC is larger
+	 * than the index: scan the ToC in the backend.
+	 */
+
 	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	result = backend_get(&backend_handle);
 	if (result != 0) {
 		WARN("Failed to open Firmware Image Package (%i)\n", result);
 		result = -ENOENT;
@@ -240,54 +523,166 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	found_file = 0;
 	do {
 		result = io_read(backend_handle,
-				 (uintptr_t)&current_file.entry,
-				 sizeof(current_file.entry),
+				 (uintptr_t)&fp->entry,
+				 sizeof(fp->entry),
 				 &bytes_read);
 		if (result == 0) {
-			if (compare_uuids(&current_file.entry.uuid,
+			if (compare_uuids(&fp->entry.uuid,
 					  &uuid_spec->uuid) == 0) {
 				found_file = 1;
 				break;
 			}
 		} else {
 			WARN("Failed to read FIP (%i)\n", result);
+			fp->entry.offset_address = 0;
 			goto fip_file_open_close;
 		}
-	} while (compare_uuids(&current_file.entry.uuid, &uuid_null) != 0);
+	} while (compare_uuids(&fp->entry.uuid, &uuid_null) != 0);
 
 	if (found_file == 1) {
 		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_file.entry' holds the
-		 * base and size of the file.
+		 * the file position to 0. The 'fp->entry' holds the base and
+		 * size of the file.
 		 */
-		current_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_file;
+		result = fip_file_start(entity, fp);
 	} else {
 		/* Did not find the file in the FIP. */
-		current_file.entry.offset_address = 0;
+		fp->entry.offset_address = 0;
 		result = -ENOENT;
 	}
 
  fip_file_open_close:
-	io_close(backend_handle);
+	backend_put(backend_handle);
 
  fip_file_open_exit:
 	return result;
 }
 
 
-/* Return the size of a file in package */
+/*
+ * Return the size of a file in package. The size of a compressed file is the
+ * size of its decompressed data.
+ */
+static size_t fip_file_size(const file_state_t *fp)
+{
+	if (fip_file_compression(fp) != TOC_ENTRY_COMPRESSION_NONE)
+		return (fp->entry.flags >> TOC_ENTRY_FLAGS_SIZE_SHIFT) &
+			TOC_ENTRY_FLAGS_SIZE_MASK;
+
+	return fp->entry.size;
+}
+
+
 static int fip_file_len(io_entity_t *entity, size_t *length)
 {
 	assert(entity != NULL);
 	assert(length != NULL);
 
-	*length =  ((file_state_t *)entity->info)->entry.size;
+	*length = fip_file_size((file_state_t *)entity->info);
 
 	return 0;
 }
 
 
+#if FIP_DECOMPRESS
+/*
+ * Read and decompress data from a compressed file in package. The payload is
+ * read through fip_comp_buf and decompressed straight into the destination.
+ * Matches may refer to any data decompressed earlier, so the successive reads
+ * of a file must fill a single contiguous buffer, as io_read_chunked() does.
+ */
+static int fip_file_read_compressed(file_state_t *fp, uintptr_t buffer,
+				    size_t length, size_t *length_read)
+{
+	int result;
+	size_t file_size;
+	size_t out_limit;
+	size_t bytes_read;
+	size_t bytes_used;
+	uintptr_t backend_handle;
+
+	file_size = fip_file_size(fp);
+
+	if (fp->file_pos == 0) {
+		lz4_stream_init(&fp->lz4, buffer, file_size);
+	} else if (buffer != fp->lz4.out_base + fp->file_pos) {
+		WARN("Compressed FIP entries must be read sequentially\n");
+		return -EINVAL;
+	}
+
+	out_limit = fp->file_pos + length;
+	if (out_limit > file_size)
+		out_limit = file_size;
+
+	/*
+	 * Another file may have used the buffer since the last read of this
+	 * one. Read again the data it held that was not decompressed yet.
+	 */
+	if (fip_comp_buf_owner != fp) {
+		fp->comp_pos -= fp->comp_buf_len - fp->comp_buf_pos;
+		fp->comp_buf_pos = 0;
+		fp->comp_buf_len = 0;
+		fip_comp_buf_owner = fp;
+	}
+
+	result = backend_get(&backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	while (fp->lz4.out_pos < out_limit) {
+		/* Refill the buffer once all its data has been decompressed */
+		if (fp->comp_buf_pos == fp->comp_buf_len) {
+			bytes_read = fp->entry.size - fp->comp_pos;
+			if (bytes_read == 0) {
+				WARN("Compressed FIP entry is truncated\n");
+				result = -EINVAL;
+				break;
+			}
+			if (bytes_read > sizeof(fip_comp_buf))
+				bytes_read = sizeof(fip_comp_buf);
+
+			result = io_seek(backend_handle, IO_SEEK_SET,
+					 fp->entry.offset_address +
+					 fp->comp_pos);
+			if (result == 0)
+				result = io_read(backend_handle,
+						 (uintptr_t)fip_comp_buf,
+						 bytes_read, &bytes_read);
+			if ((result != 0) || (bytes_read == 0)) {
+				WARN("Failed to read payload (%i)\n", result);
+				result = -ENOENT;
+				break;
+			}
+			fp->comp_pos += bytes_read;
+			fp->comp_buf_pos = 0;
+			fp->comp_buf_len = bytes_read;
+		}
+
+		result = lz4_stream_decode(&fp->lz4,
+					   fip_comp_buf + fp->comp_buf_pos,
+					   fp->comp_buf_len - fp->comp_buf_pos,
+					   &bytes_used, out_limit);
+		if (result != 0) {
+			WARN("Failed to decompress payload (%i)\n", result);
+			break;
+		}
+		fp->comp_buf_pos += bytes_used;
+	}
+
+	backend_put(backend_handle);
+
+	if (result == 0) {
+		*length_read = fp->lz4.out_pos - fp->file_pos;
+		fp->file_pos = fp->lz4.out_pos;
+	}
+
+	return result;
+}
+#endif
+
+
 /* Read data from a file in package */
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read)
@@ -303,9 +698,15 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
+#if FIP_DECOMPRESS
+	if (fip_file_compression((file_state_t *)entity->info) !=
+	    TOC_ENTRY_COMPRESSION_NONE)
+		return fip_file_read_compressed((file_state_t *)entity->info,
+						buffer, length, length_read);
+#endif
+
 	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	result = backend_get(&backend_handle);
 	if (result != 0) {
 		WARN("Failed to open FIP (%i)\n", result);
 		result = -ENOENT;
@@ -337,21 +738,146 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 
 /* Close the backend. */
  fip_file_read_close:
-	io_close(backend_handle);
+	backend_put(backend_handle);
 
  fip_file_read_exit:
 	return result;
 }
 
 
+/* Return the preferred transfer size of the backend */
+static int fip_file_block_size(io_entity_t *entity, size_t *block_size)
+{
+	int result;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(block_size != NULL);
+
+	result = backend_get(&backend_handle);
+	if (result == 0) {
+		result = io_block_size(backend_handle, block_size);
+		backend_put(backend_handle);
+	}
+
+	return result;
+}
+
+
+/*
+ * Return the address of a file in package when the package itself is mapped
+ * in memory, so that the payload can be used without being read.
+ */
+static int fip_file_address(io_entity_t *entity, uintptr_t *address)
+{
+	int result;
+	file_state_t *fp;
+	uintptr_t backend_handle;
+	uintptr_t backend_address;
+
+	assert(entity != NULL);
+	assert(address != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	/* The payload of a compressed file cannot be used as it is */
+	if (fip_file_compression(fp) != TOC_ENTRY_COMPRESSION_NONE)
+		return -ENODEV;
+
+	result = backend_get(&backend_handle);
+	if (result == 0) {
+		result = io_address(backend_handle, &backend_address);
+		if (result == 0)
+			*address = backend_address + fp->entry.offset_address;
+		backend_put(backend_handle);
+	}
+
+	return result;
+}
+
+
+/* Start an asynchronous read of a file in package, if the backend allows it */
+static int fip_file_read_start(io_entity_t *entity, uintptr_t buffer,
+			       size_t length)
+{
+	int result;
+	file_state_t *fp;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(buffer != (uintptr_t)NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+	assert(fp->async_backend == (uintptr_t)NULL);
+
+	/* Compressed files are decompressed by fip_file_read() */
+	if (fip_file_compression(fp) != TOC_ENTRY_COMPRESSION_NONE)
+		return -ENODEV;
+
+	result = backend_get(&backend_handle);
+	if (result != 0)
+		return -ENOENT;
+
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 fp->entry.offset_address + fp->file_pos);
+	if (result == 0)
+		result = io_read_start(backend_handle, buffer, length);
+
+	if (result == 0)
+		fp->async_backend = backend_handle;
+	else
+		backend_put(backend_handle);
+
+	return result;
+}
+
+
+/* Wait for the completion of an asynchronous read of a file in package */
+static int fip_file_read_wait(io_entity_t *entity, size_t *length_read)
+{
+	int result;
+	file_state_t *fp;
+	size_t bytes_read;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+	assert(fp->async_backend != (uintptr_t)NULL);
+
+	result = io_read_wait(fp->async_backend, &bytes_read);
+	if (result == 0) {
+		*length_read = bytes_read;
+		fp->file_pos += bytes_read;
+	} else {
+		WARN("Failed to read payload (%i)\n", result);
+		result = -ENOENT;
+	}
+
+	backend_put(fp->async_backend);
+	fp->async_backend = (uintptr_t)NULL;
+
+	return result;
+}
+
+
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
+	file_state_t *fp = (file_state_t *)entity->info;
+
+	/* Release the file state.
 	 * If we had malloc() we would free() here.
 	 */
-	if (current_file.entry.offset_address != 0) {
-		memset(&current_file, 0, sizeof(current_file));
+	if ((fp != NULL) && (fp->entry.offset_address != 0)) {
+#if FIP_DECOMPRESS
+		if (fip_comp_buf_owner == fp)
+			fip_comp_buf_owner = NULL;
+#endif
+		memset(fp, 0, sizeof(*fp));
 	}
 
 	/* Clear the Entity info. */
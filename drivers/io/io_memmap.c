@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -32,6 +32,7 @@
 #include <debug.h>
 #include <io_driver.h>
 #include <io_storage.h>
+#include <stdint.h>
 #include <string.h>
 
 /* As we need to be able to keep state for seek, only one file can be open
@@ -68,6 +69,7 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written);
 static int memmap_block_close(io_entity_t *entity);
+static int memmap_block_address(io_entity_t *entity, uintptr_t *address);
 static int memmap_dev_close(io_dev_info_t *dev_info);
 
 
@@ -86,6 +88,7 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.close = memmap_block_close,
 	.dev_init = NULL,
 	.dev_close = memmap_dev_close,
+	.address = memmap_block_address,
 };
 
 
@@ -178,6 +181,61 @@ static int memmap_block_len(io_entity_t *entity, size_t *length)
 }
 
 
+/* Return the address of a file on the memmap device */
+static int memmap_block_address(io_entity_t *entity, uintptr_t *address)
+{
+	assert(entity != NULL);
+	assert(address != NULL);
+
+	*address = ((file_state_t *)entity->info)->base;
+
+	return 0;
+}
+
+
+/*
+ * Copy data out of the memmap device. The device memory is read with aligned
+ * 64-bit loads only, whatever the alignment of the destination buffer, as the
+ * loads from flash are the costly part of the transfer. The loads are
+ * volatile so that the compiler turns the loop neither into byte loads nor
+ * into a call to memcpy().
+ */
+static void memmap_bulk_copy(uintptr_t dst, uintptr_t src, size_t length)
+{
+	const size_t word_mask = sizeof(uint64_t) - 1;
+	uint64_t word;
+	unsigned int i;
+
+	/* Copy the bytes up to the first aligned word of the source */
+	while (length && (src & word_mask)) {
+		*(uint8_t *)dst++ = *(const volatile uint8_t *)src++;
+		length--;
+	}
+
+	if (!(dst & word_mask)) {
+		while (length > word_mask) {
+			*(uint64_t *)dst = *(const volatile uint64_t *)src;
+			dst += sizeof(uint64_t);
+			src += sizeof(uint64_t);
+			length -= sizeof(uint64_t);
+		}
+	} else {
+		/* Scatter each word to the unaligned destination */
+		while (length > word_mask) {
+			word = *(const volatile uint64_t *)src;
+			for (i = 0; i < sizeof(uint64_t); i++) {
+				*(uint8_t *)dst++ = (uint8_t)word;
+				word >>= 8;
+			}
+			src += sizeof(uint64_t);
+			length -= sizeof(uint64_t);
+		}
+	}
+
+	while (length--)
+		*(uint8_t *)dst++ = *(const volatile uint8_t *)src++;
+}
+
 /* Read data from a file on the memmap device */
 static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 			     size_t length, size_t *length_read)
@@ -190,7 +248,7 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 
 	fp = (file_state_t *)entity->info;
 
-	memcpy((void *)buffer, (void *)(fp->base + fp->file_pos), length);
+	memmap_bulk_copy(buffer, fp->base + fp->file_pos, length);
 
 	*length_read = length;
 	/* advance the file 'cursor' for incremental reads */
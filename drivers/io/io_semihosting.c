@@ -29,11 +29,36 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <io_driver.h>
 #include <io_storage.h>
+#include <platform_def.h>
 #include <semihosting.h>
+#include <string.h>
 
 
+/*
+ * State of a file open on the host. The position of the IO entity is only
+ * applied to the host file when data is transferred, so a seek to where the
+ * host file already is costs no semihosting call.
+ *
+ * With SEMIHOSTING_FAST_IO, a file closed through the IO layer is kept open on
+ * the host and reused if it is opened again: the image loaders open every
+ * image once to check that it exists and once to load it. Its length is only
+ * asked once.
+ */
+typedef struct {
+	const char *path;	/* NULL if the entry does not hold a file */
+	unsigned int mode;
+	int in_use;		/* Open through the IO layer */
+	long handle;
+	long length;		/* -1 until it has been asked to the host */
+	ssize_t pos;		/* Position of the IO entity */
+	ssize_t host_pos;	/* Position of the host file, -1 if unknown */
+} sh_file_t;
+
+static sh_file_t sh_files[MAX_IO_HANDLES];
+
 
 /* Identify the device type as semihosting */
 static io_type_t device_type_sh(void)
@@ -54,6 +79,9 @@ static int sh_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 		size_t length, size_t *length_written);
 static int sh_file_close(io_entity_t *entity);
+#if SEMIHOSTING_FAST_IO
+static int sh_dev_close(io_dev_info_t *dev_info);
+#endif
 
 static const io_dev_connector_t sh_dev_connector = {
 	.dev_open = sh_dev_open
@@ -69,7 +97,11 @@ static const io_dev_funcs_t sh_dev_funcs = {
 	.write = sh_file_write,
 	.close = sh_file_close,
 	.dev_init = NULL,	/* NOP */
+#if SEMIHOSTING_FAST_IO
+	.dev_close = sh_dev_close,
+#else
 	.dev_close = NULL,	/* NOP */
+#endif
 };
 
 
@@ -90,59 +122,134 @@ static int sh_dev_open(const uintptr_t dev_spec __unused,
 }
 
 
+#if SEMIHOSTING_FAST_IO
+/* Close the files kept open on the host when the device is closed */
+static int sh_dev_close(io_dev_info_t *dev_info __unused)
+{
+	sh_file_t *file;
+	int result = 0;
+
+	for (file = sh_files; file < &sh_files[MAX_IO_HANDLES]; file++) {
+		if ((file->path == NULL) || file->in_use)
+			continue;
+
+		if (semihosting_file_close(file->handle) < 0)
+			result = -ENOENT;
+		file->path = NULL;
+	}
+
+	return result;
+}
+#endif
+
+
 /* Open a file on the semi-hosting device */
 static int sh_file_open(io_dev_info_t *dev_info __unused,
 		const uintptr_t spec, io_entity_t *entity)
 {
-	int result = -ENOENT;
 	long sh_result = -1;
 	const io_file_spec_t *file_spec = (const io_file_spec_t *)spec;
+	sh_file_t *file, *free_file = NULL;
 
 	assert(file_spec != NULL);
 	assert(entity != NULL);
 
-	sh_result = semihosting_file_open(file_spec->path, file_spec->mode);
+	for (file = sh_files; file < &sh_files[MAX_IO_HANDLES]; file++) {
+		if (file->in_use)
+			continue;
+
+#if SEMIHOSTING_FAST_IO
+		/* Reuse the file if it is still open on the host */
+		if ((file->path != NULL) &&
+		    (file->mode == file_spec->mode) &&
+		    (strcmp(file->path, file_spec->path) == 0))
+			goto found;
+#endif
+		/* Prefer an entry that does not hold a file */
+		if ((free_file == NULL) || (file->path == NULL))
+			free_file = file;
+	}
+
+	if (free_file == NULL)
+		return -ENOMEM;
+	file = free_file;
 
-	if (sh_result > 0) {
-		entity->info = (uintptr_t)sh_result;
-		result = 0;
+#if SEMIHOSTING_FAST_IO
+	/* Make room by closing a file kept open on the host */
+	if (file->path != NULL) {
+		(void)semihosting_file_close(file->handle);
+		file->path = NULL;
 	}
-	return result;
+#endif
+
+	sh_result = semihosting_file_open(file_spec->path, file_spec->mode);
+	if (sh_result <= 0)
+		return -ENOENT;
+
+	file->path = file_spec->path;
+	file->mode = file_spec->mode;
+	file->handle = sh_result;
+	file->length = -1;
+	file->host_pos = 0;
+
+#if SEMIHOSTING_FAST_IO
+found:
+#endif
+	file->in_use = 1;
+	file->pos = 0;
+	entity->info = (uintptr_t)file;
+
+	return 0;
 }
 
 
 /* Seek to a particular file offset on the semi-hosting device */
-static int sh_file_seek(io_entity_t *entity, int mode, ssize_t offset)
+static int sh_file_seek(io_entity_t *entity, int mode __unused,
+		ssize_t offset)
 {
-	long file_handle, sh_result;
-
 	assert(entity != NULL);
 
-	file_handle = (long)entity->info;
+	/* The host file is positioned by the next transfer */
+	((sh_file_t *)entity->info)->pos = offset;
+
+	return 0;
+}
+
 
-	sh_result = semihosting_file_seek(file_handle, offset);
+/* Position the host file for a transfer at the position of the entity */
+static int sh_file_sync_pos(sh_file_t *file)
+{
+	if (file->host_pos == file->pos)
+		return 0;
 
-	return (sh_result == 0) ? 0 : -ENOENT;
+	file->host_pos = -1;
+	if (semihosting_file_seek(file->handle, file->pos) != 0)
+		return -ENOENT;
+
+	file->host_pos = file->pos;
+	return 0;
 }
 
 
 /* Return the size of a file on the semi-hosting device */
 static int sh_file_len(io_entity_t *entity, size_t *length)
 {
-	int result = -ENOENT;
+	sh_file_t *file;
 
 	assert(entity != NULL);
 	assert(length != NULL);
 
-	long sh_handle = (long)entity->info;
-	long sh_result = semihosting_file_length(sh_handle);
+	file = (sh_file_t *)entity->info;
 
-	if (sh_result >= 0) {
-		result = 0;
-		*length = (size_t)sh_result;
+	if (file->length < 0) {
+		file->length = semihosting_file_length(file->handle);
+		if (file->length < 0)
+			return -ENOENT;
 	}
 
-	return result;
+	*length = (size_t)file->length;
+
+	return 0;
 }
 
 
@@ -150,25 +257,33 @@ static int sh_file_len(io_entity_t *entity, size_t *length)
 static int sh_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		size_t *length_read)
 {
-	int result = -ENOENT;
 	long sh_result = -1;
 	size_t bytes = length;
-	long file_handle;
+	sh_file_t *file;
 
 	assert(entity != NULL);
 	assert(buffer != (uintptr_t)NULL);
 	assert(length_read != NULL);
 
-	file_handle = (long)entity->info;
+	file = (sh_file_t *)entity->info;
+
+	if (sh_file_sync_pos(file) != 0)
+		return -ENOENT;
 
-	sh_result = semihosting_file_read(file_handle, &bytes, buffer);
+	sh_result = semihosting_file_read(file->handle, &bytes, buffer);
 
-	if (sh_result >= 0) {
-		*length_read = (bytes != length) ? bytes : length;
-		result = 0;
+	if (sh_result != 0) {
+		file->host_pos = -1;
+		if (sh_result < 0)
+			return -ENOENT;
 	}
 
-	return result;
+	*length_read = bytes;
+	file->pos += bytes;
+	if (file->host_pos >= 0)
+		file->host_pos = file->pos;
+
+	return 0;
 }
 
 
@@ -177,18 +292,25 @@ static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 		size_t length, size_t *length_written)
 {
 	long sh_result = -1;
-	long file_handle;
 	size_t bytes = length;
+	sh_file_t *file;
 
 	assert(entity != NULL);
 	assert(buffer != (uintptr_t)NULL);
 	assert(length_written != NULL);
 
-	file_handle = (long)entity->info;
+	file = (sh_file_t *)entity->info;
 
-	sh_result = semihosting_file_write(file_handle, &bytes, buffer);
+	if (sh_file_sync_pos(file) != 0)
+		return -ENOENT;
+
+	sh_result = semihosting_file_write(file->handle, &bytes, buffer);
 
 	*length_written = length - bytes;
+	file->pos += *length_written;
+	file->host_pos = file->pos;
+	/* The length of the file may have changed */
+	file->length = -1;
 
 	return (sh_result == 0) ? 0 : -ENOENT;
 }
@@ -197,14 +319,19 @@ static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 /* Close a file on the semi-hosting device */
 static int sh_file_close(io_entity_t *entity)
 {
-	long sh_result = -1;
-	long file_handle;
+	long sh_result = 0;
+	sh_file_t *file;
 
 	assert(entity != NULL);
 
-	file_handle = (long)entity->info;
+	file = (sh_file_t *)entity->info;
+	file->in_use = 0;
+	entity->info = 0;
 
-	sh_result = semihosting_file_close(file_handle);
+#if !SEMIHOSTING_FAST_IO
+	sh_result = semihosting_file_close(file->handle);
+	file->path = NULL;
+#endif
 
 	return (sh_result >= 0) ? 0 : -ENOENT;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -38,12 +38,14 @@
 /* Storage for a fixed maximum number of IO entities, definable by platform */
 static io_entity_t entity_pool[MAX_IO_HANDLES];
 
-/* Simple way of tracking used storage - each entry is NULL or a pointer to an
- * entity */
-static io_entity_t *entity_map[MAX_IO_HANDLES];
+/* Stack of indexes of released entities, so allocation and release are O(1) */
+static unsigned int free_entities[MAX_IO_HANDLES];
 
-/* Track number of allocated entities */
-static unsigned int entity_count;
+/* Number of indexes on the free stack */
+static unsigned int free_count;
+
+/* Number of entities handed out from the pool at least once */
+static unsigned int pool_count;
 
 /* Array of fixed maximum of registered devices, definable by platform */
 static const io_dev_info_t *devices[MAX_IO_DEVICES];
@@ -113,53 +115,43 @@ static void set_handle(uintptr_t *handle, io_entity_t *entity)
 }
 
 
-/* Locate an entity in the pool, specified by address */
-static int find_first_entity(const io_entity_t *entity, unsigned int *index_out)
-{
-	int result = -ENOENT;
-	for (int index = 0; index < MAX_IO_HANDLES; ++index) {
-		if (entity_map[index] == entity) {
-			result = 0;
-			*index_out = index;
-			break;
-		}
-	}
-	return result;
-}
-
-
 /* Allocate an entity from the pool and return a pointer to it */
 static int allocate_entity(io_entity_t **entity)
 {
-	int result = -ENOMEM;
+	unsigned int index;
 	assert(entity != NULL);
 
-	if (entity_count < MAX_IO_HANDLES) {
-		unsigned int index = 0;
-		result = find_first_entity(NULL, &index);
-		assert(result == 0);
-		*entity = entity_map[index] = &entity_pool[index];
-		++entity_count;
-	}
+	if (free_count > 0)
+		index = free_entities[--free_count];
+	else if (pool_count < MAX_IO_HANDLES)
+		index = pool_count++;
+	else
+		return -ENOMEM;
 
-	return result;
+	*entity = &entity_pool[index];
+	return 0;
 }
 
 
 /* Release an entity back to the pool */
-static int free_entity(const io_entity_t *entity)
+static int free_entity(io_entity_t *entity)
 {
-	int result;
-	unsigned int index = 0;
+	unsigned int index;
 	assert(entity != NULL);
 
-	result = find_first_entity(entity, &index);
-	if (result ==  0) {
-		entity_map[index] = NULL;
-		--entity_count;
-	}
+	/* Reject entities outside the pool and ones already released */
+	if ((entity < entity_pool) || (entity >= &entity_pool[pool_count]) ||
+	    (entity->dev_handle == NULL))
+		return -ENOENT;
 
-	return result;
+	index = entity - entity_pool;
+	assert(free_count < pool_count);
+	free_entities[free_count++] = index;
+
+	/* Make stale handles to this entity fail validation */
+	entity->dev_handle = NULL;
+
+	return 0;
 }
 
 
@@ -249,12 +241,12 @@ int io_open(uintptr_t dev_handle, const uintptr_t spec, uintptr_t *handle)
 
 	if (result == 0) {
 		assert(dev->funcs->open != NULL);
+		entity->dev_handle = dev;
 		result = dev->funcs->open(dev, spec, entity);
 
-		if (result == 0) {
-			entity->dev_handle = dev;
+		if (result == 0)
 			set_handle(handle, entity);
-		} else
+		else
 			free_entity(entity);
 	}
 	return result;
@@ -356,3 +348,158 @@ int io_close(uintptr_t handle)
 
 	return result;
 }
+
+
+/* Determine the preferred transfer size for reads from an IO entity */
+int io_block_size(uintptr_t handle, size_t *block_size)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (block_size != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->block_size != NULL)
+		result = dev->funcs->block_size(entity, block_size);
+
+	return result;
+}
+
+
+/* Return the address at which the data of an IO entity is mapped in memory.
+ * Only devices that are memory mapped support this. */
+int io_address(uintptr_t handle, uintptr_t *address)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (address != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->address != NULL)
+		result = dev->funcs->address(entity, address);
+
+	return result;
+}
+
+
+/* Start reading data from an IO entity. The read must be completed with
+ * io_read_wait() before any other operation is performed on the entity. */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (buffer != (uintptr_t)NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if ((dev->funcs->read_start != NULL) && (dev->funcs->read_wait != NULL))
+		result = dev->funcs->read_start(entity, buffer, length);
+
+	return result;
+}
+
+
+/* Wait for the completion of a read started by io_read_start() */
+int io_read_wait(uintptr_t handle, size_t *length_read)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (length_read != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->read_wait != NULL)
+		result = dev->funcs->read_wait(entity, length_read);
+
+	return result;
+}
+
+
+/*
+ * Read data from an IO entity in chunks of its preferred block size, calling
+ * 'chunk_cb' (if not NULL) on each chunk once it has been read. If the device
+ * supports asynchronous reads, the transfer of the next chunk is started
+ * before the callback processes the current one. A synchronous device which
+ * does not report a preferred block size is read in a single transfer, as
+ * chunks would only add to the cost of the read.
+ */
+int io_read_chunked(uintptr_t handle,
+		uintptr_t buffer,
+		size_t length,
+		size_t *length_read,
+		io_chunk_cb_t chunk_cb,
+		void *cb_arg)
+{
+	size_t block_size, chunk_size, next_size, chunk_read;
+	size_t offset = 0;
+	int async, has_block_size;
+	int result;
+	assert(is_valid_entity(handle) && (buffer != (uintptr_t)NULL));
+	assert(length_read != NULL);
+
+	has_block_size = (io_block_size(handle, &block_size) == 0) &&
+			 (block_size != 0);
+	if (!has_block_size)
+		block_size = IO_DEFAULT_BLOCK_SIZE;
+
+	*length_read = 0;
+	if (length == 0)
+		return 0;
+
+	chunk_size = (length < block_size) ? length : block_size;
+
+	/* Kick off the first transfer if the device can work in background */
+	async = (io_read_start(handle, buffer, chunk_size) == 0);
+	if (!async && !has_block_size)
+		block_size = chunk_size = length;
+
+	for (;;) {
+		if (async)
+			result = io_read_wait(handle, &chunk_read);
+		else
+			result = io_read(handle, buffer + offset, chunk_size,
+					 &chunk_read);
+		if (result != 0)
+			return result;
+
+		*length_read += chunk_read;
+		next_size = length - *length_read;
+		if (next_size > block_size)
+			next_size = block_size;
+
+		/* Stop on a short read, the caller checks the length read */
+		if (chunk_read < chunk_size)
+			next_size = 0;
+
+		/* Overlap the next transfer with the processing of this chunk */
+		if (async && (next_size != 0)) {
+			result = io_read_start(handle, buffer + *length_read,
+					       next_size);
+			if (result != 0)
+				return result;
+		}
+
+		if (chunk_cb != NULL) {
+			result = chunk_cb(buffer + offset, chunk_read, cb_arg);
+			if (result != 0) {
+				/* Do not leave a transfer in flight */
+				if (async && (next_size != 0))
+					(void)io_read_wait(handle, &chunk_read);
+				return result;
+			}
+		}
+
+		if (next_size == 0)
+			break;
+
+		offset = *length_read;
+		chunk_size = next_size;
+	}
+
+	return 0;
+}
@@ -51,7 +51,7 @@
  * BL1 SMC version
  */
 #define BL1_SMC_MAJOR_VER		0x0
-#define BL1_SMC_MINOR_VER		0x1
+#define BL1_SMC_MINOR_VER		0x2
 
 /*
  * Defines for FWU SMC function ids.
@@ -63,11 +63,23 @@
 #define FWU_SMC_IMAGE_RESUME		0x13
 #define FWU_SMC_SEC_IMAGE_DONE		0x14
 #define FWU_SMC_UPDATE_DONE		0x15
+#define FWU_SMC_IMAGE_COPY_LIST		0x16
+
+/*
+ * Value returned by FWU_SMC_IMAGE_AUTH when only part of the image has been
+ * hashed, so that the SMC must be called again to carry on
+ */
+#define FWU_AUTH_IN_PROGRESS		1
+
+/*
+ * Maximum number of blocks in the list passed to FWU_SMC_IMAGE_COPY_LIST
+ */
+#define FWU_COPY_LIST_MAX_BLOCKS	1024
 
 /*
  * Number of FWU calls (above) implemented
  */
-#define FWU_NUM_SMC_CALLS		6
+#define FWU_NUM_SMC_CALLS		7
 
 #if TRUSTED_BOARD_BOOT
 # define BL1_NUM_SMC_CALLS		(FWU_NUM_SMC_CALLS + 4)
@@ -80,12 +92,21 @@
  * calls from the SMC function ID
  */
 #define FWU_SMC_FID_START		FWU_SMC_IMAGE_COPY
-#define FWU_SMC_FID_END			FWU_SMC_UPDATE_DONE
+#define FWU_SMC_FID_END			FWU_SMC_IMAGE_COPY_LIST
 #define is_fwu_fid(_fid) \
     ((_fid >= FWU_SMC_FID_START) && (_fid <= FWU_SMC_FID_END))
 
 #ifndef __ASSEMBLY__
 #include <cassert.h>
+#include <stdint.h>
+
+/*
+ * Entry of the list of normal world blocks passed to FWU_SMC_IMAGE_COPY_LIST
+ */
+typedef struct fwu_copy_block {
+	uint64_t addr;
+	uint64_t size;
+} fwu_copy_block_t;
 
 /*
  * Check if the total number of FWU SMC calls are as expected.
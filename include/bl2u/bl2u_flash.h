@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BL2U_FLASH_H__
+#define __BL2U_FLASH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Operations on the flash device written by bl2u_flash_write(). Erases run in
+ * the background: program() and verify() are called while the erase of
+ * another block is in progress, and must suspend it if the device cannot
+ * access another block during an erase.
+ */
+typedef struct bl2u_flash_ops {
+	/* Size of an erase block. Writes start on a block boundary. */
+	size_t block_size;
+
+	/* Start erasing the block at 'addr', without waiting. */
+	int (*erase_start)(uintptr_t addr);
+
+	/*
+	 * Return 0 once the erase of the block at 'addr' has completed,
+	 * -EBUSY while it is in progress, or another negative error code.
+	 */
+	int (*erase_poll)(uintptr_t addr);
+
+	/* Program 'size' bytes of 'data' at 'addr' and wait for completion. */
+	int (*program)(uintptr_t addr, const void *data, size_t size);
+
+	/*
+	 * Return 0 if the 'size' bytes at 'addr' match 'data'. Optional: the
+	 * flash is compared with memcmp() if NULL.
+	 */
+	int (*verify)(uintptr_t addr, const void *data, size_t size);
+} bl2u_flash_ops_t;
+
+int bl2u_flash_write(const bl2u_flash_ops_t *ops, uintptr_t dst,
+		     const void *src, size_t size,
+		     unsigned int report_blocks);
+uint64_t bl2u_fwu_resume(uint64_t image_param);
+
+#endif /* __BL2U_FLASH_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -33,14 +33,44 @@
 
 #include <stdint.h>
 
+/*******************************************************************************
+ * SHA-256 digest of an image preloaded at 'base', which BL31 checks before
+ * running it when RESET_TO_BL31_VERIFY is set
+ ******************************************************************************/
+typedef struct bl31_image_digest {
+	uintptr_t base;
+	uint32_t size;
+	unsigned char sha256[32];
+} bl31_image_digest_t;
+
+/*******************************************************************************
+ * Step of the BL31 platform setup run by bl31_run_boot_tasks(). 'start' begins
+ * the step. 'is_done' returns non-zero once the step has completed, or is NULL
+ * if the step has completed when 'start' returns. 'deps' is the bitmap of the
+ * indices of the tasks which must have completed before the step starts.
+ ******************************************************************************/
+typedef struct bl31_boot_task {
+	const char *name;
+	void (*start)(void);
+	int (*is_done)(void);
+	uint32_t deps;
+} bl31_boot_task_t;
+
+#define BL31_BOOT_TASK_DEP(_idx)	(1U << (_idx))
+#define BL31_BOOT_TASKS_MAX		32
+
 /*******************************************************************************
  * Function prototypes
  ******************************************************************************/
 void bl31_arch_setup(void);
+uint64_t bl31_get_syscnt_freq(void);
 void bl31_next_el_arch_setup(uint32_t security_state);
 void bl31_set_next_image_type(uint32_t type);
 uint32_t bl31_get_next_image_type(void);
 void bl31_prepare_next_image_entry(void);
 void bl31_register_bl32_init(int32_t (*)(void));
+void bl31_verify_images(void);
+void bl31_run_boot_tasks(const bl31_boot_task_t *tasks,
+			 unsigned int num_tasks);
 
 #endif /* __BL31_H__ */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CONSOLE_BUFFER_H__
+#define __CONSOLE_BUFFER_H__
+
+/*******************************************************************************
+ * Buffered console of BL31. When CONSOLE_BUFFERED is set, the characters
+ * printed by BL31 once its data cache is enabled are written to a ring of the
+ * calling CPU instead of the UART. Each complete line is then drained to the
+ * UART only as long as its transmit FIFO has room, by whichever CPU manages to
+ * take the drain lock. What does not fit is sent by a later drain, so a print
+ * never waits for the UART.
+ *
+ * The rings keep the last CONSOLE_BUF_SIZE characters printed by each CPU,
+ * drained or not, and the normal world can read them back with a SiP call.
+ * Positions in a ring are free running 32-bit character counts.
+ ******************************************************************************/
+
+/* Size of the ring of each CPU in bytes, a power of two */
+#ifndef CONSOLE_BUF_SIZE
+#define CONSOLE_BUF_SIZE		1024
+#endif
+
+/*
+ * SiP function ID reading the ring of a CPU. It must be dispatched to
+ * console_buffer_smc_handler() by the SiP service of the platform.
+ *
+ * CONSOLE_BUF_READ: x1 = CPU linear index, x2 = position of the first
+ *   character to read.
+ *   Returns x0 = number of characters read (up to 24), or CONSOLE_BUF_E_LOST
+ *   with x1 = position of the oldest character still held, or
+ *   CONSOLE_BUF_E_INVALID. The characters are returned in x1-x3, the first one
+ *   in the least significant byte of x1.
+ */
+#define CONSOLE_BUF_READ		0xc200ff20
+
+#define is_console_buf_fid(_fid)	((_fid) == CONSOLE_BUF_READ)
+
+/* Error codes */
+#define CONSOLE_BUF_E_INVALID		-1
+#define CONSOLE_BUF_E_LOST		-2
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+int console_buffer_putc(int c);
+void console_buffer_drain(void);
+void console_buffer_flush(void);
+uint64_t console_buffer_smc_handler(uint32_t smc_fid,
+				    uint64_t x1,
+				    uint64_t x2,
+				    uint64_t x3,
+				    uint64_t x4,
+				    void *cookie,
+				    void *handle,
+				    uint64_t flags);
+
+#endif /* __ASSEMBLY__ */
+#endif /* __CONSOLE_BUFFER_H__ */
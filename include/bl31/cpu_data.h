@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -31,16 +31,36 @@
 #ifndef __CPU_DATA_H__
 #define __CPU_DATA_H__
 
+#include <hang_detect.h>
+#include <smc_stats.h>
+
 /* Offsets for the cpu_data structure */
+#if EL3_HANG_DETECT
+#define CPU_DATA_PROGRESS_OFFSET	0x18
+#define CPU_DATA_CRASH_BUF_OFFSET	(CPU_DATA_PROGRESS_OFFSET + \
+					 EL3_PROGRESS_SIZE)
+#else
 #define CPU_DATA_CRASH_BUF_OFFSET	0x18
-#if CRASH_REPORTING
+#endif
+#if SMC_LATENCY_STATS
+#define CPU_DATA_LOG2SIZE		10
+#elif CRASH_REPORTING && EL3_HANG_DETECT
+#define CPU_DATA_LOG2SIZE		8
+#elif CRASH_REPORTING || EL3_HANG_DETECT
 #define CPU_DATA_LOG2SIZE		7
 #else
 #define CPU_DATA_LOG2SIZE		6
 #endif
 /* need enough space in crash buffer to save 8 registers */
 #define CPU_DATA_CRASH_BUF_SIZE		64
+#define CPU_DATA_CPU_CONTEXT		0x0
 #define CPU_DATA_CPU_OPS_PTR		0x10
+#if CRASH_REPORTING
+#define CPU_DATA_SMC_STATS_OFFSET	(CPU_DATA_CRASH_BUF_OFFSET + \
+					 CPU_DATA_CRASH_BUF_SIZE)
+#else
+#define CPU_DATA_SMC_STATS_OFFSET	CPU_DATA_CRASH_BUF_OFFSET
+#endif
 
 #ifndef __ASSEMBLY__
 
@@ -59,6 +79,13 @@
 		(cpu_data_t, platform_cpu_data)
 #endif
 
+#if SMC_LATENCY_STATS || (CRASH_REPORTING && EL3_HANG_DETECT)
+/* The members do not fill the structure, pad it to its power of two size */
+#define CPU_DATA_ALIGN			(1 << CPU_DATA_LOG2SIZE)
+#else
+#define CPU_DATA_ALIGN			CACHE_WRITEBACK_GRANULE
+#endif
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
@@ -79,14 +106,28 @@
 typedef struct cpu_data {
 	void *cpu_context[2];
 	uint64_t cpu_ops_ptr;
+#if EL3_HANG_DETECT
+	el3_progress_t el3_progress;
+#endif
 #if CRASH_REPORTING
 	uint64_t crash_buf[CPU_DATA_CRASH_BUF_SIZE >> 3];
 #endif
+#if SMC_LATENCY_STATS
+	smc_stats_t smc_stats;
+#endif
+	/* Offset of the copy of the per-cpu variables of this cpu */
+	uintptr_t percpu_offset;
 	struct psci_cpu_data psci_svc_cpu_data;
 #if PLAT_PCPU_DATA_SIZE
 	uint8_t platform_cpu_data[PLAT_PCPU_DATA_SIZE];
 #endif
-} __aligned(CACHE_WRITEBACK_GRANULE) cpu_data_t;
+} __aligned(CPU_DATA_ALIGN) cpu_data_t;
+
+#if EL3_HANG_DETECT
+CASSERT(CPU_DATA_PROGRESS_OFFSET == __builtin_offsetof
+	(cpu_data_t, el3_progress),
+	assert_cpu_data_progress_offset_mismatch);
+#endif
 
 #if CRASH_REPORTING
 /* verify assembler offsets match data structures */
@@ -95,9 +136,19 @@ CASSERT(CPU_DATA_CRASH_BUF_OFFSET == __builtin_offsetof
 	assert_cpu_data_crash_stack_offset_mismatch);
 #endif
 
+#if SMC_LATENCY_STATS
+CASSERT(CPU_DATA_SMC_STATS_OFFSET == __builtin_offsetof
+	(cpu_data_t, smc_stats),
+	assert_cpu_data_smc_stats_offset_mismatch);
+#endif
+
 CASSERT((1 << CPU_DATA_LOG2SIZE) == sizeof(cpu_data_t),
 	assert_cpu_data_log2size_mismatch);
 
+CASSERT(CPU_DATA_CPU_CONTEXT == __builtin_offsetof
+		(cpu_data_t, cpu_context),
+		assert_cpu_data_cpu_context_offset_mismatch);
+
 CASSERT(CPU_DATA_CPU_OPS_PTR == __builtin_offsetof
 		(cpu_data_t, cpu_ops_ptr),
 		assert_cpu_data_cpu_ops_ptr_offset_mismatch);
@@ -134,6 +185,45 @@ void init_cpu_ops(void);
 					 &(_cpu_data_by_index(_ix)->_m),  \
 					 sizeof(_cpu_data_by_index(_ix)->_m))
 
+#if EL3_HANG_DETECT
+/* Record a progress point of the calling CPU (see hang_detect.h) */
+static inline void el3_progress(unsigned int point, unsigned int arg)
+{
+	el3_progress_t *progress = &get_cpu_data(el3_progress);
+
+	progress->count++;
+	progress->timestamp = read_cntpct_el0();
+	progress->point = point;
+	progress->arg = arg;
+}
+#else
+#define el3_progress(_point, _arg)
+#endif
+
+/**************************************************************************
+ * Per-cpu variables. A variable defined with DEFINE_PERCPU() is placed in
+ * the 'percpu' section of BL31, which the linker script replicates once
+ * per CPU, each copy starting on its own cache line. The variable must not
+ * be accessed directly, as its name refers to the copy of CPU 0. The copy
+ * of the calling CPU is found from the offset cached in its cpu_data, the
+ * copy of any CPU from its linear index. Per-cpu variables are zeroed at
+ * cold boot and may only be used from bl31_main() onwards.
+ *************************************************************************/
+extern void *__PERCPU_SIZE__;
+#define PERCPU_SIZE			((uintptr_t)&__PERCPU_SIZE__)
+
+#define DEFINE_PERCPU(_type, _name)	_type _name __section("percpu")
+#define DECLARE_PERCPU(_type, _name)	extern _type _name
+
+#define this_cpu_ptr(_name)						\
+	((__typeof__(&(_name)))((uintptr_t)&(_name) +			\
+				get_cpu_data(percpu_offset)))
+#define percpu_ptr_by_index(_ix, _name)					\
+	((__typeof__(&(_name)))((uintptr_t)&(_name) +			\
+				(_ix) * PERCPU_SIZE))
+
+void init_percpu_vars(void);
+
 
 #endif /* __ASSEMBLY__ */
 #endif /* __CPU_DATA_H__ */
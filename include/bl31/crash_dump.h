@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CRASH_DUMP_H__
+#define __CRASH_DUMP_H__
+
+#include <platform_def.h>
+
+/*******************************************************************************
+ * Binary crash dump. When CRASH_DUMP is set, the crash reporting code of BL31
+ * first writes a record of the state of the crashing CPU to its slot of the
+ * persistent memory region PLAT_CRASH_DUMP_BASE/PLAT_CRASH_DUMP_SIZE, cleans it
+ * to the point of coherency and only then prints the state to the crash
+ * console. The record survives a reset that does not clear the memory, e.g.
+ * one triggered by a watchdog because the console was stuck.
+ *
+ * The record starts with the fixed layout below, followed by the regions
+ * listed in crash_dump_regions[]. Each region is stored as its size in bytes
+ * (8 bytes) followed by its contents for the crashing CPU. The regions which
+ * do not fit in the slot are left out. The magic is written last, so that a
+ * record interrupted by a reset is not taken for a valid one.
+ ******************************************************************************/
+#if CRASH_DUMP
+#if !defined(PLAT_CRASH_DUMP_BASE) || !defined(PLAT_CRASH_DUMP_SIZE)
+#error "CRASH_DUMP requires the platform to define PLAT_CRASH_DUMP_BASE/SIZE"
+#endif
+
+/* Size of the slot of each CPU, a multiple of the cache line size */
+#define CRASH_DUMP_SLOT_SIZE	((PLAT_CRASH_DUMP_SIZE / PLATFORM_CORE_COUNT) \
+				 & ~(CACHE_WRITEBACK_GRANULE - 1))
+#endif
+
+#define CRASH_DUMP_MAGIC	0x504d4443	/* "CDMP" */
+#define CRASH_DUMP_VERSION	1
+
+/* Offsets of the fields of the record */
+#define CRASH_DUMP_MAGIC_OFF	0x0	/* u32 */
+#define CRASH_DUMP_VERSION_OFF	0x4	/* u32 */
+#define CRASH_DUMP_CPU_OFF	0x8	/* u32, linear index of the CPU */
+#define CRASH_DUMP_SIZE_OFF	0x10	/* u64, size of the whole record */
+#define CRASH_DUMP_MPIDR_OFF	0x18	/* u64 */
+#define CRASH_DUMP_CNTPCT_OFF	0x20	/* u64, system counter at the crash */
+#define CRASH_DUMP_MSG_OFF	0x28	/* u64, address of the crash message */
+#define CRASH_DUMP_GP_OFF	0x30	/* x0 - x30 */
+#define CRASH_DUMP_EL3_OFF	0x128	/* EL3 registers, in crash print order */
+#define CRASH_DUMP_EL3_REGS	11
+#define CRASH_DUMP_EL1_OFF	0x180	/* Other registers, in print order */
+#define CRASH_DUMP_EL1_REGS	36
+#define CRASH_DUMP_REGIONS_OFF	0x2a0
+
+#ifndef __ASSEMBLY__
+
+#include <cassert.h>
+#include <stdint.h>
+
+/*
+ * Per-CPU region copied to the record. The copy of the crashing CPU starts at
+ * 'base + cpu index * stride'. 'size' must be a multiple of 8.
+ */
+typedef struct crash_dump_region {
+	uintptr_t base;
+	uint64_t stride;
+	uint64_t size;
+} crash_dump_region_t;
+
+CASSERT(CRASH_DUMP_GP_OFF + 31 * 8 == CRASH_DUMP_EL3_OFF,
+	assert_crash_dump_el3_off);
+CASSERT(CRASH_DUMP_EL3_OFF + CRASH_DUMP_EL3_REGS * 8 == CRASH_DUMP_EL1_OFF,
+	assert_crash_dump_el1_off);
+CASSERT(CRASH_DUMP_EL1_OFF + CRASH_DUMP_EL1_REGS * 8 ==
+	CRASH_DUMP_REGIONS_OFF, assert_crash_dump_regions_off);
+#if CRASH_DUMP
+CASSERT(CRASH_DUMP_SLOT_SIZE >= CRASH_DUMP_REGIONS_OFF,
+	assert_crash_dump_slot_size);
+#endif
+
+/* NULL terminated list of the regions, read by the crash reporting code */
+extern const crash_dump_region_t *const crash_dump_regions[];
+
+#if ENABLE_PSCI_TRACE
+extern const crash_dump_region_t psci_trace_dump_region;
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __CRASH_DUMP_H__ */
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __EL3_TELEMETRY_H__
+#define __EL3_TELEMETRY_H__
+
+/*******************************************************************************
+ * EL3 telemetry snapshot. When EL3_TELEMETRY is set, the normal world can have
+ * BL31 copy the statistics and traces of all the instrumentations it is built
+ * with into a buffer in its memory with a single SiP call, instead of reading
+ * them one value at a time through the SiP call of each instrumentation. The
+ * buffer is then saved to a file and decoded on any host with
+ * tools/telemetry_decode.
+ *
+ * The snapshot starts with an el3_telemetry_hdr_t header followed by
+ * 'num_sections' sections. Each section starts with an el3_telemetry_sect_t
+ * header followed by 'num_recs' records of 'rec_size' bytes, whose layout
+ * depends on the type of the section. The sections of the instrumentations
+ * BL31 is not built with are left out. Sections and record fields may be
+ * added without changing the major version, so a decoder must skip the
+ * sections it does not know and the bytes of each record beyond the fields it
+ * knows.
+ *
+ * The size of a snapshot only depends on the build of BL31. The records are
+ * read while the other CPUs keep running, so the values of a record may have
+ * been updated in between. All times are in system counter ticks, of
+ * frequency 'cntfrq'.
+ ******************************************************************************/
+
+/*
+ * SiP function ID taking a snapshot. It must be dispatched to
+ * el3_telemetry_smc_handler() by the SiP service of the platform.
+ *
+ * EL3_TELEMETRY_SNAPSHOT: x1 = page aligned physical address of the buffer,
+ *   or 0 to only get the size of the snapshot, x2 = size of the buffer, a
+ *   multiple of the page size.
+ *   Returns x0 = 0, EL3_TELEMETRY_E_INVALID or EL3_TELEMETRY_E_NO_SPACE, x1 =
+ *   size of the snapshot in bytes.
+ */
+#define EL3_TELEMETRY_SNAPSHOT		0xc200ff50
+
+#define is_el3_telemetry_fid(_fid)	((_fid) == EL3_TELEMETRY_SNAPSHOT)
+
+/* Error codes */
+#define EL3_TELEMETRY_E_INVALID		-1
+#define EL3_TELEMETRY_E_NO_SPACE	-2
+
+/* "EL3T" in the first bytes of the snapshot */
+#define EL3_TELEMETRY_MAGIC		0x54334c45
+#define EL3_TELEMETRY_VERSION_MAJOR	1
+#define EL3_TELEMETRY_VERSION_MINOR	0
+
+/* Section types */
+#define EL3_TELEMETRY_SECT_SMC_STATS	0x1	/* SMC_LATENCY_STATS */
+#define EL3_TELEMETRY_SECT_PSCI_STAT	0x2	/* ENABLE_PSCI_STAT */
+#define EL3_TELEMETRY_SECT_LOCK_PROFILE	0x3	/* ENABLE_LOCK_PROFILING */
+#define EL3_TELEMETRY_SECT_PSCI_TRACE	0x4	/* ENABLE_PSCI_TRACE */
+
+/* Number of latency histogram buckets, as in smc_stats.h */
+#define EL3_TELEMETRY_HIST_BUCKETS	8
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+typedef struct el3_telemetry_hdr {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	/* Size of the snapshot in bytes, this header included */
+	uint32_t size;
+	uint32_t num_sections;
+	uint32_t num_cpus;
+	uint32_t reserved;
+	/* System counter value and frequency when the snapshot was taken */
+	uint64_t timestamp;
+	uint64_t cntfrq;
+} el3_telemetry_hdr_t;
+
+typedef struct el3_telemetry_sect {
+	uint32_t type;
+	uint32_t num_recs;
+	uint32_t rec_size;
+	uint32_t reserved;
+} el3_telemetry_sect_t;
+
+/*
+ * SMC latency statistics: one record per slot of each CPU, whose 'smc_fid' is
+ * 0 if the slot is unused (see smc_stats.h).
+ */
+typedef struct el3_telemetry_smc_rec {
+	uint32_t cpu;
+	uint32_t smc_fid;
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint32_t reserved;
+	uint64_t total;
+	uint32_t hist[EL3_TELEMETRY_HIST_BUCKETS];
+} el3_telemetry_smc_rec_t;
+
+/*
+ * PSCI residency statistics: one record per local power state of each power
+ * domain. 'node' is the CPU linear index for the CPUs (power level 0), and
+ * the number of CPUs plus the non-CPU power domain index for the others.
+ */
+typedef struct el3_telemetry_psci_stat_rec {
+	uint32_t node;
+	uint8_t pwrlvl;
+	uint8_t local_state;
+	uint16_t reserved;
+	uint64_t residency;
+	uint64_t count;
+} el3_telemetry_psci_stat_rec_t;
+
+/*
+ * Lock contention profiles: one record per bakery lock of BL31, summed up over
+ * all the CPUs (see lock_profile.h). 'lock' is the address of the lock, to be
+ * looked up in the symbols of BL31.
+ */
+typedef struct el3_telemetry_lock_rec {
+	uint64_t lock;
+	uint64_t acquire_count;
+	uint64_t contended_count;
+	uint64_t wait_ticks;
+	uint64_t max_wait_ticks;
+} el3_telemetry_lock_rec_t;
+
+/*
+ * PSCI traces: the last PSCI_TRACE_ENTRIES entries of the ring of each CPU,
+ * oldest first. 'event' is 0 for the entries not written yet or overwritten
+ * while the snapshot was taken (see psci_trace.h).
+ */
+typedef struct el3_telemetry_trace_rec {
+	uint32_t cpu;
+	uint32_t event;
+	uint32_t arg;
+	uint32_t reserved;
+	uint64_t seq;
+	uint64_t timestamp;
+} el3_telemetry_trace_rec_t;
+
+uint64_t el3_telemetry_smc_handler(uint32_t smc_fid,
+				   uint64_t x1,
+				   uint64_t x2,
+				   uint64_t x3,
+				   uint64_t x4,
+				   void *cookie,
+				   void *handle,
+				   uint64_t flags);
+
+#endif /* __ASSEMBLY__ */
+#endif /* __EL3_TELEMETRY_H__ */
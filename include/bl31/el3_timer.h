@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __EL3_TIMER_H__
+#define __EL3_TIMER_H__
+
+/*******************************************************************************
+ * EL3 timer service. When EL3_TIMER_SERVICE is set, BL31 owns the secure
+ * physical timer (CNTPS) of each CPU and multiplexes on it the software timers
+ * of the EL3 services and dispatchers. Each CPU keeps its armed timers in a
+ * min-heap ordered by deadline and programs CNTPS with the earliest one. When
+ * the timer interrupt is taken, the handler of each expired timer is called on
+ * the CPU the timer was armed on.
+ *
+ * A timer expires on the CPU it was armed on, and must only be armed or
+ * cancelled from that CPU, e.g. a service uses one timer per CPU. The timers of
+ * a CPU which is powered down expire once it is powered on again.
+ ******************************************************************************/
+
+#ifndef __ASSEMBLY__
+
+#include <errno.h>
+#include <stdint.h>
+
+/* Index of a timer which is not armed */
+#define EL3_TIMER_IDLE			0xffffffffU
+
+struct el3_timer;
+
+/*
+ * Handler called at EL3 when a timer expires, with the timer no longer armed
+ * and 'handle' pointing to the context of the interrupted world. It may arm
+ * the timer again.
+ */
+typedef void (*el3_timer_handler_t)(struct el3_timer *timer, void *handle);
+
+typedef struct el3_timer {
+	/* System counter value at which the timer expires */
+	uint64_t deadline;
+	el3_timer_handler_t handler;
+	/* Position in the heap of its CPU, EL3_TIMER_IDLE if not armed */
+	unsigned int index;
+} el3_timer_t;
+
+#define EL3_TIMER_INIT(_handler)	{ 0, (_handler), EL3_TIMER_IDLE }
+
+static inline int el3_timer_is_armed(const el3_timer_t *timer)
+{
+	return timer->index != EL3_TIMER_IDLE;
+}
+
+#if EL3_TIMER_SERVICE
+int32_t el3_timer_setup(uint32_t id);
+int el3_timer_arm(el3_timer_t *timer, uint64_t deadline);
+void el3_timer_cancel(el3_timer_t *timer);
+void el3_timer_restore(void);
+#else
+static inline int el3_timer_arm(el3_timer_t *timer, uint64_t deadline)
+{
+	return -ENOSYS;
+}
+static inline void el3_timer_cancel(el3_timer_t *timer)
+{
+}
+static inline void el3_timer_restore(void)
+{
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __EL3_TIMER_H__ */
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __HANG_DETECT_H__
+#define __HANG_DETECT_H__
+
+/*******************************************************************************
+ * EL3 hang detection. When EL3_HANG_DETECT is set, each CPU keeps a progress
+ * record in its cpu_data structure, updated at SMC dispatch, at EL3 interrupt
+ * entry, at each PSCI trace point and when it leaves EL3 or enters a low power
+ * state. The platform calls el3_hang_check() periodically, typically from the
+ * pre-timeout interrupt of a secure watchdog. A CPU which is found executing in
+ * EL3 without having made any progress since the previous check is reported as
+ * hung along with the records of all the CPUs and, with ENABLE_PSCI_TRACE, its
+ * PSCI trace. EL3 work which legitimately lasts longer than the check period
+ * must record progress points with el3_progress().
+ ******************************************************************************/
+
+/*
+ * Progress points. The argument recorded with each point is given in brackets.
+ * EL3_PROGRESS_IDLE means that the CPU does not execute in EL3.
+ */
+#define EL3_PROGRESS_IDLE		0x0	/* (0) */
+#define EL3_PROGRESS_SMC		0x1	/* (function ID) */
+#define EL3_PROGRESS_INTR		0x2	/* (0) */
+#define EL3_PROGRESS_PSCI		0x3	/* (PSCI trace event) */
+
+/*
+ * Offsets for the assembler, relative to the el3_progress structure. The
+ * argument of the point is stored in the word which follows it.
+ */
+#define EL3_PROGRESS_COUNT		0x0
+#define EL3_PROGRESS_TIMESTAMP		0x8
+#define EL3_PROGRESS_POINT		0x10
+#define EL3_PROGRESS_SIZE		0x18
+
+#ifndef __ASSEMBLY__
+
+#include <cassert.h>
+#include <stdint.h>
+
+typedef struct el3_progress {
+	/* Number of progress points ever recorded by the CPU */
+	uint64_t count;
+	/* System counter value when the last point was recorded */
+	uint64_t timestamp;
+	uint32_t point;
+	uint32_t arg;
+} el3_progress_t;
+
+CASSERT(EL3_PROGRESS_COUNT == __builtin_offsetof(el3_progress_t, count), \
+	assert_el3_progress_count_offset_mismatch);
+CASSERT(EL3_PROGRESS_TIMESTAMP == __builtin_offsetof(el3_progress_t,
+						     timestamp), \
+	assert_el3_progress_timestamp_offset_mismatch);
+CASSERT(EL3_PROGRESS_POINT == __builtin_offsetof(el3_progress_t, point), \
+	assert_el3_progress_point_offset_mismatch);
+/* The assembler writes the point and its argument with a single store */
+CASSERT(EL3_PROGRESS_POINT + 4 == __builtin_offsetof(el3_progress_t, arg), \
+	assert_el3_progress_arg_offset_mismatch);
+CASSERT(EL3_PROGRESS_SIZE == sizeof(el3_progress_t), \
+	assert_el3_progress_size_mismatch);
+
+unsigned int el3_hang_check(void);
+void el3_hang_report(void);
+
+#endif /* __ASSEMBLY__ */
+#endif /* __HANG_DETECT_H__ */
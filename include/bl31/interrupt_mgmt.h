@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -117,6 +117,8 @@
 
 #ifndef __ASSEMBLY__
 
+#include <arch_helpers.h>
+
 /* Prototype for defining a handler for an interrupt type */
 typedef uint64_t (*interrupt_type_handler_t)(uint32_t id,
 					     uint32_t flags,
@@ -132,8 +134,26 @@ int32_t register_interrupt_type_handler(uint32_t type,
 					interrupt_type_handler_t handler,
 					uint32_t flags);
 interrupt_type_handler_t get_interrupt_type_handler(uint32_t interrupt_type);
+int32_t register_interrupt_handler(uint32_t id,
+				   interrupt_type_handler_t handler,
+				   uint32_t flags);
 int disable_intr_rm_local(uint32_t type, uint32_t security_state);
 int enable_intr_rm_local(uint32_t type, uint32_t security_state);
 
+#if EL3_NS_PREEMPT
+uint32_t el3_preempt_enable(uint32_t pri_mask);
+void el3_preempt_disable(uint32_t prev_pri_mask);
+
+/*******************************************************************************
+ * This function returns non-zero if an interrupt let through by
+ * el3_preempt_enable() is pending. It only reads ISR_EL1, so it is cheap enough
+ * to be polled from the inner loop of the work.
+ ******************************************************************************/
+static inline int el3_preempt_pending(void)
+{
+	return (read_isr_el1() & ((1 << ISR_I_SHIFT) | (1 << ISR_F_SHIFT))) != 0;
+}
+#endif
+
 #endif /*__ASSEMBLY__*/
 #endif /* __INTERRUPT_MGMT_H__ */
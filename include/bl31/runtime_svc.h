@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -55,6 +55,19 @@
  */
 #define MAX_RT_SVCS		128
 
+/*
+ * Constants to allow the assembler access the table of runtime service
+ * functions. Individual SMC function IDs registered by the services are looked
+ * up in this table before the owning entity number is used. The table is
+ * indexed by a hash of the function ID (see 'rt_svc_func_hash').
+ */
+#define RT_SVC_FUNC_SIZE_LOG2	4
+#define SIZEOF_RT_SVC_FUNC	(1 << RT_SVC_FUNC_SIZE_LOG2)
+#define RT_SVC_FUNC_FID		0
+#define RT_SVC_FUNC_HANDLE	8
+#define RT_SVC_FUNCS_LOG2	6
+#define MAX_RT_SVC_FUNCS	(1 << RT_SVC_FUNCS_LOG2)
+
 #ifndef __ASSEMBLY__
 
 /* Prototype for runtime service initializing function */
@@ -96,6 +109,27 @@ typedef struct rt_svc_desc {
 			.init = _setup, \
 			.handle = _smch }
 
+/*
+ * A runtime service function descriptor binds a single SMC function ID to the
+ * handler to call for it, bypassing the handler of the runtime service owning
+ * the function ID. The runtime service must still be registered with
+ * DECLARE_RT_SVC(), and the function handler is only used if that service has
+ * been successfully initialised.
+ */
+typedef struct rt_svc_func_desc {
+	uint32_t smc_fid;
+	rt_svc_handle_t handle;
+} rt_svc_func_desc_t;
+
+/*
+ * Convenience macro to declare a runtime service function descriptor
+ */
+#define DECLARE_RT_SVC_FUNC(_name, _fid, _smch) \
+	static const rt_svc_func_desc_t __svc_func_ ## _name \
+		__section("rt_svc_funcs") __used = { \
+			.smc_fid = _fid, \
+			.handle = _smch }
+
 /*
  * Compile time assertions related to the 'rt_svc_desc' structure to:
  * 1. ensure that the assembler and the compiler view of the size
@@ -112,6 +146,17 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+/*
+ * Compile time assertions related to the 'rt_svc_func_desc' structure to
+ * ensure that the assembler and the compiler view of its layout are the same.
+ */
+CASSERT((sizeof(rt_svc_func_desc_t) == SIZEOF_RT_SVC_FUNC), \
+	assert_sizeof_rt_svc_func_desc_mismatch);
+CASSERT(RT_SVC_FUNC_FID == __builtin_offsetof(rt_svc_func_desc_t, smc_fid), \
+	assert_rt_svc_func_desc_fid_offset_mismatch);
+CASSERT(RT_SVC_FUNC_HANDLE == __builtin_offsetof(rt_svc_func_desc_t, handle), \
+	assert_rt_svc_func_desc_handle_offset_mismatch);
+
 
 /*
  * This macro combines the call type and the owning entity number corresponding
@@ -123,12 +168,23 @@ CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 					((call_type & FUNCID_TYPE_MASK) \
 					 << FUNCID_OEN_WIDTH))
 
+/*
+ * This macro computes the index of a function ID in the table of runtime
+ * service functions. It folds the call convention and the owning entity number
+ * onto the function number so that the SMC32 and SMC64 variants of a function
+ * land in different entries. It must match the computation in smc_handler64.
+ */
+#define rt_svc_func_hash(fid)	(((fid) ^ ((fid) >> 25)) &		\
+				 (MAX_RT_SVC_FUNCS - 1))
+
 /*******************************************************************************
  * Function & variable prototypes
  ******************************************************************************/
 void runtime_svc_init(void);
 extern uint64_t __RT_SVC_DESCS_START__;
 extern uint64_t __RT_SVC_DESCS_END__;
+extern uint64_t __RT_SVC_FUNCS_START__;
+extern uint64_t __RT_SVC_FUNCS_END__;
 void init_crash_reporting(void);
 
 #endif /*__ASSEMBLY__*/
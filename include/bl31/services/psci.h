@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -78,8 +78,16 @@
 #define PSCI_SYSTEM_OFF			0x84000008
 #define PSCI_SYSTEM_RESET		0x84000009
 #define PSCI_FEATURES			0x8400000A
+#define PSCI_CPU_FREEZE			0x8400000B
+#define PSCI_CPU_DEFAULT_SUSPEND_AARCH32	0x8400000C
+#define PSCI_CPU_DEFAULT_SUSPEND_AARCH64	0xc400000C
 #define PSCI_SYSTEM_SUSPEND_AARCH32	0x8400000E
 #define PSCI_SYSTEM_SUSPEND_AARCH64	0xc400000E
+#define PSCI_SET_SUSPEND_MODE		0x8400000F
+#define PSCI_STAT_RESIDENCY_AARCH32	0x84000010
+#define PSCI_STAT_RESIDENCY_AARCH64	0xc4000010
+#define PSCI_STAT_COUNT_AARCH32		0x84000011
+#define PSCI_STAT_COUNT_AARCH64		0xc4000011
 
 /* Macro to help build the psci capabilities bitfield */
 #define define_psci_cap(x)		(1 << (x & 0x1f))
@@ -87,7 +95,8 @@
 /*
  * Number of PSCI calls (above) implemented
  */
-#define PSCI_NUM_CALLS			18
+#define PSCI_NUM_CALLS			(21 + (ENABLE_PSCI_STAT * 4) + \
+					 PSCI_OS_INIT_MODE)
 
 /*******************************************************************************
  * PSCI Migrate and friends
@@ -96,6 +105,18 @@
 #define PSCI_TOS_NOT_UP_MIG_CAP	1
 #define PSCI_TOS_NOT_PRESENT_MP	2
 
+/*******************************************************************************
+ * PSCI suspend modes selected by PSCI_SET_SUSPEND_MODE
+ ******************************************************************************/
+#define PSCI_MODE_PC		0
+#define PSCI_MODE_OSI		1
+
+/*******************************************************************************
+ * Maximum number of cpus which can be turned on by a single psci_cpu_on_batch()
+ * call. It bounds the stack usage of the call.
+ ******************************************************************************/
+#define PSCI_CPU_ON_BATCH_MAX	16
+
 /*******************************************************************************
  * PSCI CPU_SUSPEND 'power_state' parameter specific defines
  ******************************************************************************/
@@ -171,6 +192,7 @@
 
 #ifndef __ASSEMBLY__
 
+#include <cdefs.h>
 #include <stdint.h>
 #include <types.h>
 
@@ -251,8 +273,44 @@ typedef struct psci_cpu_data {
 
 	/* The local power state of this CPU */
 	plat_local_state_t local_state;
+
+	/*
+	 * The local power states requested by this CPU for its ancestor power
+	 * domains from level 1 to PLAT_MAX_PWR_LVL, used for the coordination
+	 * of their target states.
+	 */
+	plat_local_state_t req_local_state[PLAT_MAX_PWR_LVL];
+
+#if PSCI_PARK_SECONDARIES
+	/*
+	 * Set while this CPU waits in BL31 for a CPU_ON after it has been
+	 * brought up at cold boot. It is read with the data cache disabled.
+	 */
+	unsigned char parked;
+#endif
+
+#if PSCI_RESIDENCY_PREDICTOR
+	/*
+	 * System counter value at which the next timer event of the normal
+	 * world is due on this CPU, recorded on entry to CPU_SUSPEND.
+	 */
+	uint64_t next_wakeup;
+#endif
 } psci_cpu_data_t;
 
+/*******************************************************************************
+ * Latencies of a local power state of a power domain, declared by the platform
+ * through plat_get_state_latency() when PSCI_STATE_LATENCY is set. The entry
+ * and exit latencies are the time taken by the hardware and the platform to
+ * enter and leave the state. The minimum residency is the time the power
+ * domain must stay in the state for it to save power, including both.
+ ******************************************************************************/
+typedef struct plat_state_latency {
+	uint32_t entry_us;
+	uint32_t exit_us;
+	uint32_t min_residency_us;
+} plat_state_latency_t;
+
 /*******************************************************************************
  * Structure populated by platform specific code to export routines which
  * perform common low level power management functions
@@ -272,6 +330,10 @@ typedef struct plat_psci_ops {
 	int (*validate_ns_entrypoint)(uintptr_t ns_entrypoint);
 	void (*get_sys_suspend_power_state)(
 				    psci_power_state_t *req_state);
+	int (*pwr_domain_on_batch)(const u_register_t *mpidr_list,
+				   unsigned int num_cpus);
+	unsigned int (*get_pwr_down_cache_lvl)(
+				    const psci_power_state_t *target_state);
 } plat_psci_ops_t;
 
 /*******************************************************************************
@@ -292,6 +354,36 @@ typedef struct spd_pm_ops {
 	void (*svc_system_reset)(void);
 } spd_pm_ops_t;
 
+/*******************************************************************************
+ * Optional structure declared by the drivers of the system components which
+ * lose their state when the system power domain is powered down, e.g. on
+ * SYSTEM_SUSPEND. It is only used when PSCI_SYS_SUSPEND_OPS is set. `save` is
+ * called on the last CPU before the system is powered down and `restore` on the
+ * first CPU to power up, before the platform suspend finisher and with the data
+ * cache disabled. Both are given a buffer of `state_size` bytes preserved over
+ * the suspend, and either of them may be NULL. The handlers are restored in
+ * increasing `order` and saved in the reverse order.
+ ******************************************************************************/
+typedef struct psci_sys_suspend_ops {
+	const char *name;
+	unsigned int order;
+	unsigned int state_size;
+	void (*save)(void *state);
+	void (*restore)(const void *state);
+} psci_sys_suspend_ops_t;
+
+/*
+ * Convenience macro to declare the system suspend handlers of a driver
+ */
+#define DECLARE_PSCI_SYS_SUSPEND_OPS(_name, _order, _size, _save, _restore) \
+	static const psci_sys_suspend_ops_t __psci_sys_suspend_ ## _name \
+		__section("psci_sys_suspend_ops") __used = { \
+			.name = #_name, \
+			.order = _order, \
+			.state_size = _size, \
+			.save = _save, \
+			.restore = _restore }
+
 /*******************************************************************************
  * Function & Data prototypes
  ******************************************************************************/
@@ -299,17 +391,38 @@ unsigned int psci_version(void);
 int psci_cpu_on(u_register_t target_cpu,
 		uintptr_t entrypoint,
 		u_register_t context_id);
+int psci_cpu_on_batch(const u_register_t *target_cpus,
+		      unsigned int num_cpus,
+		      uintptr_t entrypoint,
+		      u_register_t context_id,
+		      uint64_t *on_mask);
 int psci_cpu_suspend(unsigned int power_state,
 		     uintptr_t entrypoint,
 		     u_register_t context_id);
 int psci_system_suspend(uintptr_t entrypoint, u_register_t context_id);
 int psci_cpu_off(void);
+int psci_cpu_freeze(void);
+int psci_cpu_default_suspend(uintptr_t entrypoint, u_register_t context_id);
 int psci_affinity_info(u_register_t target_affinity,
 		       unsigned int lowest_affinity_level);
 int psci_migrate(u_register_t target_cpu);
 int psci_migrate_info_type(void);
 long psci_migrate_info_up_cpu(void);
 int psci_features(unsigned int psci_fid);
+#if PSCI_OS_INIT_MODE
+int psci_set_suspend_mode(unsigned int mode);
+#endif
+#if ENABLE_PSCI_STAT
+u_register_t psci_stat_residency(u_register_t target_cpu,
+				 unsigned int power_state);
+u_register_t psci_stat_count(u_register_t target_cpu,
+			     unsigned int power_state);
+int psci_stat_read(unsigned int node,
+		   unsigned int local_state,
+		   unsigned int *pwrlvl,
+		   uint64_t *residency,
+		   uint64_t *count);
+#endif
 void __dead2 psci_power_down_wfi(void);
 void psci_entrypoint(void);
 void psci_register_spd_pm_hook(const spd_pm_ops_t *);
@@ -324,6 +437,12 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 
 /* PSCI setup function */
 int psci_setup(void);
+#if PSCI_PARK_SECONDARIES
+void psci_park_secondaries(void);
+#endif
+#if PSCI_SYS_SUSPEND_OPS
+const void *psci_get_sys_suspend_state(size_t *size);
+#endif
 
 #endif /*__ASSEMBLY__*/
 
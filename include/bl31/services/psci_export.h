@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __PSCI_EXPORT_H__
+#define __PSCI_EXPORT_H__
+
+/*******************************************************************************
+ * Export of the PSCI power domain states. When PSCI_STATE_EXPORT is set, the
+ * normal world can register a page in its memory to which BL31 publishes the
+ * power domain topology and the current local state of each CPU and non-CPU
+ * power domain, so that it can poll them without an SMC.
+ *
+ * The page starts with a psci_export_hdr_t header, followed by 'num_cpus'
+ * psci_export_cpu_t records indexed by CPU linear index and 'num_nodes'
+ * psci_export_node_t records indexed by non-CPU power domain index. The
+ * 'parent_node' fields are non-CPU power domain indices, ~0 for the root.
+ *
+ * The topology fields are written once at registration. The 'local_state'
+ * fields are updated as the power domains power down and up, under a seqlock:
+ * 'seq' is odd while they are being updated. A reader copies them between two
+ * reads of an even and unchanged 'seq' to get a consistent snapshot.
+ ******************************************************************************/
+
+/*
+ * SiP function ID registering the page. It must be dispatched to
+ * psci_export_smc_handler() by the SiP service of the platform.
+ *
+ * PSCI_EXPORT_REGISTER: x1 = page aligned physical address of the page, or 0
+ *   to unregister it, x2 = size of the page, a multiple of the page size.
+ *   Returns x0 = 0 or PSCI_EXPORT_E_INVALID, x1 = number of CPUs, x2 = number
+ *   of non-CPU power domains, x3 = size needed for the page in bytes.
+ */
+#define PSCI_EXPORT_REGISTER		0x8200ff30
+
+#define is_psci_export_fid(_fid)	((_fid) == PSCI_EXPORT_REGISTER)
+
+/* Error code returned for invalid arguments */
+#define PSCI_EXPORT_E_INVALID		-1
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+typedef struct psci_export_hdr {
+	uint64_t seq;
+	uint32_t num_cpus;
+	uint32_t num_nodes;
+} psci_export_hdr_t;
+
+typedef struct psci_export_cpu {
+	uint64_t mpidr;
+	uint32_t parent_node;
+	uint8_t local_state;
+	uint8_t reserved[3];
+} psci_export_cpu_t;
+
+typedef struct psci_export_node {
+	uint32_t parent_node;
+	uint8_t level;
+	uint8_t local_state;
+	uint16_t reserved;
+} psci_export_node_t;
+
+uint64_t psci_export_smc_handler(uint32_t smc_fid,
+				 uint64_t x1,
+				 uint64_t x2,
+				 uint64_t x3,
+				 uint64_t x4,
+				 void *cookie,
+				 void *handle,
+				 uint64_t flags);
+
+#endif /* __ASSEMBLY__ */
+#endif /* __PSCI_EXPORT_H__ */
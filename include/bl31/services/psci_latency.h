@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __PSCI_LATENCY_H__
+#define __PSCI_LATENCY_H__
+
+/*******************************************************************************
+ * Latencies of the local power states entered through CPU_SUSPEND. When
+ * PSCI_STATE_LATENCY is set, the latencies declared by the platform through
+ * plat_get_state_latency() are reported to the normal world along with the
+ * ones measured by each CPU:
+ * - the entry latency, from CPU_SUSPEND to the point where the CPU is ready to
+ *   enter the state, before the caches are flushed for a power down state;
+ * - the exit latency, from the timer event of the normal world which woke the
+ *   CPU up to the point where BL31 has restored the state of the CPU. It is
+ *   only measured for the wakeups due to this timer, as the time of other
+ *   wakeup events is unknown.
+ * The measurements of a CPU are keyed by the deepest power level which is not
+ * RUN, and by the local state of this level.
+ ******************************************************************************/
+
+/*
+ * SiP function ID reading the latencies of a state. It must be dispatched to
+ * psci_latency_smc_handler() by the SiP service of the platform.
+ *
+ * PSCI_LATENCY_READ: x1 = CPU linear index, x2 = power level, x3 = local state.
+ *   Returns x0 = 0 or PSCI_LATENCY_E_INVALID, x1 = declared entry latency |
+ *   declared exit latency << 32, x2 = declared minimum residency | number of
+ *   entries into the state << 32, x3 = maximum measured entry latency | maximum measured
+ *   exit latency << 32. The latencies are in microseconds, 0 if unknown.
+ */
+#define PSCI_LATENCY_READ		0xc200ff40
+
+#define is_psci_latency_fid(_fid)	((_fid) == PSCI_LATENCY_READ)
+
+/* Error code returned for invalid arguments */
+#define PSCI_LATENCY_E_INVALID		-1
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+uint64_t psci_latency_smc_handler(uint32_t smc_fid,
+				  uint64_t x1,
+				  uint64_t x2,
+				  uint64_t x3,
+				  uint64_t x4,
+				  void *cookie,
+				  void *handle,
+				  uint64_t flags);
+
+#endif /* __ASSEMBLY__ */
+#endif /* __PSCI_LATENCY_H__ */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __PSCI_TRACE_H__
+#define __PSCI_TRACE_H__
+
+/*******************************************************************************
+ * PSCI operation tracing. When ENABLE_PSCI_TRACE is set, each CPU records the
+ * timestamped events of the PSCI operations it performs in its own ring buffer
+ * of PSCI_TRACE_ENTRIES entries. Any CPU can read them with psci_trace_read()
+ * without taking a lock, as the entries carry their sequence number.
+ ******************************************************************************/
+
+/* Number of entries of the ring buffer of each CPU, a power of 2 */
+#define PSCI_TRACE_ENTRIES		32
+
+/*
+ * Trace events. The argument recorded with each event is given in brackets.
+ * The 'states' arguments pack the local state of each power level in a byte,
+ * level 0 in the least significant one.
+ */
+#define PSCI_TRACE_CPU_ON		0x1	/* (target cpu index) */
+#define PSCI_TRACE_CPU_ON_PLAT_START	0x2	/* (target cpu index, or
+						   PSCI_TRACE_ARG_BATCH | number
+						   of cpus of a batch) */
+#define PSCI_TRACE_CPU_ON_PLAT_END	0x3	/* (error code) */
+#define PSCI_TRACE_SUSPEND		0x4	/* (requested states) */
+#define PSCI_TRACE_LOCKS_ACQUIRED	0x5	/* (highest locked level) */
+#define PSCI_TRACE_COORD_RESULT		0x6	/* (target states) */
+#define PSCI_TRACE_SUSPEND_PLAT_START	0x7	/* (1 if powering down) */
+#define PSCI_TRACE_SUSPEND_PLAT_END	0x8	/* (0), not recorded when
+						   powering down */
+#define PSCI_TRACE_WAKEUP		0x9	/* (states woken up from) */
+
+#define PSCI_TRACE_ARG_BATCH		0x80000000
+
+/* Error code returned for entries which are overwritten or not written yet */
+#define PSCI_TRACE_E_NOT_AVAIL		-1
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+typedef struct psci_trace_entry {
+	/* Sequence number of the event on its CPU */
+	uint64_t seq;
+	/* System counter value when the event was recorded */
+	uint64_t timestamp;
+	uint32_t event;
+	uint32_t arg;
+} psci_trace_entry_t;
+
+int psci_trace_read(unsigned int cpu_idx,
+		    uint64_t seq,
+		    psci_trace_entry_t *entry,
+		    uint64_t *next_seq);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __PSCI_TRACE_H__ */
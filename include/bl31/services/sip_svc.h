@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIP_SVC_H__
+#define __SIP_SVC_H__
+
+#include <bl_common.h>
+#include <runtime_svc.h>
+#include <stdint.h>
+#include <uuid.h>
+
+/*******************************************************************************
+ * Common SiP service framework. A platform describes its SiP calls with an
+ * array of sip_call_t sorted by function ID and registers it as its SiP runtime
+ * service with DECLARE_SIP_SVC(). The framework looks up the function ID of
+ * each SiP SMC in the array, applies the checks of the call and then invokes
+ * its handler. It answers the general queries of the SiP service itself. The
+ * function numbers from SIP_SVC_FNUM_RESERVED upwards are reserved for them.
+ ******************************************************************************/
+
+/* SMC function IDs of the general queries of the SiP service */
+#define SIP_SVC_CALL_COUNT		0x8200ff00
+#define SIP_SVC_UID			0x8200ff01
+/*					0x8200ff02 is reserved */
+#define SIP_SVC_VERSION			0x8200ff03
+
+/*
+ * SIP_SVC_CALL_STATS (SIP_SVC_STATS): x1 = function ID of a SiP call
+ *   Returns x0 = 0 (SMC_UNK if the call is not implemented), x1 = number of
+ *   times it has been invoked on all the CPUs since cold boot.
+ */
+#define SIP_SVC_CALL_STATS		0x8200fe00
+
+#define SIP_SVC_FNUM_RESERVED		0xfe00
+
+/* The call is rejected with SMC_UNK when made from the Secure world */
+#define SIP_CALL_NS_ONLY		(1 << 0)
+
+/*
+ * Argument check of a SiP call, called before its handler. It returns 0 if
+ * the arguments are valid, and otherwise the value to return in x0 instead of
+ * calling the handler.
+ */
+typedef uint64_t (*sip_call_check_t)(uint64_t x1,
+				     uint64_t x2,
+				     uint64_t x3,
+				     uint64_t x4);
+
+typedef struct sip_call {
+	uint32_t smc_fid;
+	uint32_t flags;
+	sip_call_check_t check;
+	rt_svc_handle_t handle;
+} sip_call_t;
+
+typedef struct sip_svc_desc {
+	const sip_call_t *calls;
+	unsigned int num_calls;
+	/* UUID returned by SIP_SVC_UID, or NULL if the query is unsupported */
+	const uuid_t *uuid;
+	uint32_t version_major;
+	uint32_t version_minor;
+} sip_svc_desc_t;
+
+int32_t sip_svc_setup(const sip_svc_desc_t *svc);
+uint64_t sip_svc_dispatch(const sip_svc_desc_t *svc,
+			  uint32_t smc_fid,
+			  uint64_t x1,
+			  uint64_t x2,
+			  uint64_t x3,
+			  uint64_t x4,
+			  void *cookie,
+			  void *handle,
+			  uint64_t flags);
+
+/*
+ * Convenience macro to register the array of SiP calls '_calls' as the SiP
+ * runtime service of the platform. The array is checked once when the runtime
+ * services are initialised.
+ */
+#define DECLARE_SIP_SVC(_name, _calls, _uuid, _major, _minor)		\
+	static const sip_svc_desc_t _name ## _desc = {			\
+		.calls = (_calls),					\
+		.num_calls = ARRAY_SIZE(_calls),			\
+		.uuid = (_uuid),					\
+		.version_major = (_major),				\
+		.version_minor = (_minor) };				\
+	static int32_t _name ## _setup(void)				\
+	{								\
+		return sip_svc_setup(&_name ## _desc);			\
+	}								\
+	static uint64_t _name ## _handler(uint32_t smc_fid,		\
+					  uint64_t x1,			\
+					  uint64_t x2,			\
+					  uint64_t x3,			\
+					  uint64_t x4,			\
+					  void *cookie,			\
+					  void *handle,			\
+					  uint64_t flags)		\
+	{								\
+		return sip_svc_dispatch(&_name ## _desc, smc_fid, x1,	\
+					x2, x3, x4, cookie, handle,	\
+					flags);				\
+	}								\
+	DECLARE_RT_SVC(_name, OEN_SIP_START, OEN_SIP_END,		\
+		       SMC_TYPE_FAST, _name ## _setup, _name ## _handler)
+
+#endif /* __SIP_SVC_H__ */
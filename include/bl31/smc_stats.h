@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SMC_STATS_H__
+#define __SMC_STATS_H__
+
+/*******************************************************************************
+ * SMC latency statistics. When SMC_LATENCY_STATS is set, BL31 samples the
+ * system counter when it dispatches an SMC (or an EL3 interrupt) and when it
+ * exits EL3, and accumulates the difference per function ID and per CPU in the
+ * cpu_data structure. With SMC_STATS_PMU, it also accumulates the number of
+ * cycles and of occurrences of a PMU event counted in EL3 while the PMU has
+ * been handed over to EL3 on the CPU with SMC_STATS_PMU_START.
+ ******************************************************************************/
+
+/* Number of function IDs tracked per CPU */
+#define SMC_STATS_SLOTS			8
+
+/*
+ * Number of latency histogram buckets. Bucket 'n' counts the samples lasting
+ * from 4^n to 4^(n+1) - 1 counter ticks, the last bucket counts all longer
+ * samples.
+ */
+#define SMC_STATS_HIST_BUCKETS		8
+
+/* Function ID under which EL3 interrupts are accounted */
+#define SMC_STATS_FID_INTR		0xffffffff
+
+/* Offsets for the assembler, relative to the smc_stats structure */
+#define SMC_STATS_START_TS		0x0
+#define SMC_STATS_CUR_FID		0x8
+#if SMC_STATS_PMU
+#define SMC_STATS_START_CYCLES		0x10
+#define SMC_STATS_START_EVENTS		0x18
+#endif
+
+/*
+ * SiP function IDs giving access to the statistics. They must be dispatched to
+ * smc_stats_smc_handler() by the SiP service of the platform.
+ *
+ * SMC_STATS_GET: x1 = CPU linear index, x2 = slot index
+ *   Returns x0 = function ID (0 if the slot is unused), x1 = sample count,
+ *   x2 = sum of the samples, x3 = maximum << 32 | minimum (in counter ticks).
+ * SMC_STATS_GET_HIST: x1 = CPU linear index, x2 = slot index
+ *   Returns the histogram buckets of the slot, two 32-bit buckets per register
+ *   in x0-x3, lowest bucket in the least significant bits of x0.
+ * SMC_STATS_RESET: clears the statistics of all the CPUs. Returns x0 = 0.
+ *
+ * With SMC_STATS_PMU:
+ * SMC_STATS_GET_PMU: x1 = CPU linear index, x2 = slot index
+ *   Returns x0 = function ID (0 if the slot is unused), x1 = sample count,
+ *   x2 = sum of the EL3 cycles and x3 = sum of the PMU events of the samples
+ *   taken while the PMU belonged to EL3.
+ * SMC_STATS_PMU_START: x1 = PMU event number (e.g. 0x3 for L1D_CACHE_REFILL)
+ *   Hands the PMU of the calling CPU over to EL3, which programs the cycle
+ *   counter and event counter 0 to count in EL3 only. The normal world must
+ *   not use the PMU until SMC_STATS_PMU_STOP. Returns x0 = 0 or
+ *   SMC_STATS_E_INVALID.
+ * SMC_STATS_PMU_STOP: stops the PMU counters of the calling CPU and gives the
+ *   PMU back to the normal world. Returns x0 = 0.
+ */
+#define SMC_STATS_GET			0xc200ff00
+#define SMC_STATS_GET_HIST		0xc200ff01
+#define SMC_STATS_RESET			0x8200ff02
+#define SMC_STATS_GET_PMU		0xc200ff03
+#define SMC_STATS_PMU_START		0x8200ff04
+#define SMC_STATS_PMU_STOP		0x8200ff05
+
+#define is_smc_stats_fid(_fid)		(((_fid) & ~0x40000007) == 0x8200ff00)
+
+/* Error code returned for invalid arguments */
+#define SMC_STATS_E_INVALID		-1
+
+#ifndef __ASSEMBLY__
+
+#include <cassert.h>
+#include <stdint.h>
+
+typedef struct smc_stats_slot {
+	uint32_t smc_fid;
+	uint32_t count;
+	uint64_t total;
+	uint32_t min;
+	uint32_t max;
+	uint32_t hist[SMC_STATS_HIST_BUCKETS];
+#if SMC_STATS_PMU
+	uint64_t cycles;
+	uint64_t events;
+#endif
+} smc_stats_slot_t;
+
+typedef struct smc_stats {
+	/* Entry time stamp of the SMC being handled, 0 if none */
+	uint64_t start_ts;
+	uint32_t cur_fid;
+	/* Number of samples discarded because all the slots were in use */
+	uint32_t dropped;
+#if SMC_STATS_PMU
+	/* PMU counts when the SMC being handled has been dispatched */
+	uint64_t start_cycles;
+	uint64_t start_events;
+	/* Event counted by event counter 0 while the PMU belongs to EL3 */
+	uint32_t pmu_event;
+	uint32_t pmu_active;
+#endif
+	smc_stats_slot_t slot[SMC_STATS_SLOTS];
+} smc_stats_t;
+
+CASSERT(SMC_STATS_START_TS == __builtin_offsetof(smc_stats_t, start_ts), \
+	assert_smc_stats_start_ts_offset_mismatch);
+CASSERT(SMC_STATS_CUR_FID == __builtin_offsetof(smc_stats_t, cur_fid), \
+	assert_smc_stats_cur_fid_offset_mismatch);
+#if SMC_STATS_PMU
+CASSERT(SMC_STATS_START_CYCLES == __builtin_offsetof(smc_stats_t,
+						     start_cycles), \
+	assert_smc_stats_start_cycles_offset_mismatch);
+CASSERT(SMC_STATS_START_EVENTS == __builtin_offsetof(smc_stats_t,
+						     start_events), \
+	assert_smc_stats_start_events_offset_mismatch);
+#endif
+
+void smc_stats_exit(void);
+void smc_stats_discard(void);
+uint64_t smc_stats_smc_handler(uint32_t smc_fid,
+			       uint64_t x1,
+			       uint64_t x2,
+			       uint64_t x3,
+			       uint64_t x4,
+			       void *cookie,
+			       void *handle,
+			       uint64_t flags);
+
+#endif /* __ASSEMBLY__ */
+#endif /* __SMC_STATS_H__ */
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SPD_TRACE_H__
+#define __SPD_TRACE_H__
+
+/*******************************************************************************
+ * Tracing of the world switches performed by the Secure Payload Dispatchers.
+ * When SPD_TRACE is set, the normal world can register a ring in its memory
+ * for each CPU. The SPD then writes a record to it each time the secure
+ * payload returns to the normal world, describing why it was entered and for
+ * how long it ran. The normal world reads the ring without any SMC.
+ *
+ * The ring starts with a spd_trace_ring_t header followed by as many
+ * spd_trace_rec_t records as fit in its size. Record 'seq' is written at index
+ * 'seq % number of records'. Its 'seq' field holds SPD_TRACE_SEQ_BUSY while it
+ * is being written, so that a reader can detect a torn copy.
+ ******************************************************************************/
+
+/* Events recorded. The 'fid' of the record is given in brackets */
+#define SPD_TRACE_FAST_SMC		0x1	/* (SMC function ID) */
+#define SPD_TRACE_STD_SMC		0x2	/* (SMC function ID) */
+#define SPD_TRACE_STD_RESUME		0x3	/* (SMC function ID) */
+#define SPD_TRACE_SEL1_INTR		0x4	/* (0) */
+
+/*
+ * SiP function ID registering the ring of the calling CPU. It must be
+ * dispatched to spd_trace_smc_handler() by the SiP service of the platform.
+ *
+ * SPD_TRACE_REGISTER: x1 = page aligned physical address of the ring, or 0 to
+ *   unregister it, x2 = size of the ring, a multiple of the page size.
+ *   Returns x0 = 0 or SPD_TRACE_E_INVALID.
+ */
+#define SPD_TRACE_REGISTER		0x8200ff10
+
+#define is_spd_trace_fid(_fid)		((_fid) == SPD_TRACE_REGISTER)
+
+/* Error code returned for invalid arguments */
+#define SPD_TRACE_E_INVALID		-1
+
+#define SPD_TRACE_SEQ_BUSY		~0ULL
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+typedef struct spd_trace_ring {
+	/* Sequence number of the next record to be written */
+	uint64_t next_seq;
+	/* Number of records the ring holds */
+	uint32_t num_recs;
+	uint32_t reserved;
+} spd_trace_ring_t;
+
+typedef struct spd_trace_rec {
+	uint64_t seq;
+	/* System counter values on entry into and exit from the SP */
+	uint64_t entry_ts;
+	uint64_t exit_ts;
+	uint32_t fid;
+	uint16_t event;
+	uint16_t cpu;
+} spd_trace_rec_t;
+
+#if SPD_TRACE
+void spd_trace_enter(unsigned int event, uint32_t fid);
+void spd_trace_exit(void);
+uint64_t spd_trace_smc_handler(uint32_t smc_fid,
+			       uint64_t x1,
+			       uint64_t x2,
+			       uint64_t x3,
+			       uint64_t x4,
+			       void *cookie,
+			       void *handle,
+			       uint64_t flags);
+#else
+static inline void spd_trace_enter(unsigned int event, uint32_t fid)
+{
+}
+
+static inline void spd_trace_exit(void)
+{
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __SPD_TRACE_H__ */
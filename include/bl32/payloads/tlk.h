@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -58,6 +58,7 @@
 #define TLK_SUSPEND_DONE	(0x32000005 | (1 << 31))
 #define TLK_RESUME_DONE		(0x32000006 | (1 << 31))
 #define TLK_SYSTEM_OFF_DONE	(0x32000007 | (1 << 31))
+#define TLK_VA_TRANSLATE_RANGE	(0x32000008 | (1 << 31))
 
 /*
  * Trusted Application specific function IDs
@@ -67,10 +68,18 @@
 #define TLK_TA_LAUNCH_OP	TLK_TA_STD_FID(0x3)
 #define TLK_TA_SEND_EVENT	TLK_TA_STD_FID(0x4)
 
+/*
+ * Process the first 'x1' requests queued in the buffer registered through
+ * TLK_REGISTER_REQBUF in one entry into TLK. TLK stores the completion status
+ * of each request in the buffer and returns, through TLK_REQUEST_DONE, the
+ * status of the batch in r0 and the number of requests completed in r1.
+ */
+#define TLK_TA_LAUNCH_BATCH	TLK_TA_STD_FID(0x5)
+
 /*
  * Total number of function IDs implemented for services offered to NS clients.
  */
-#define TLK_NUM_FID		7
+#define TLK_NUM_FID		8
 
 /* TLK implementation version numbers */
 #define TLK_VERSION_MAJOR	0x0 /* Major version */
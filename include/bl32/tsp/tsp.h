@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -55,6 +55,24 @@
 /* SMC function ID that TSP uses to request service from secure monitor */
 #define TSP_GET_ARGS		0xf2001000
 
+/*
+ * SMC function IDs that the TSP uses to measure the cost of the calls into the
+ * secure monitor when TSP_BENCH is set. TSP_BENCH_NOP returns at once, while
+ * TSP_BENCH_SWITCH switches the EL1 context to the normal world and back, as
+ * a round trip through the normal world does.
+ */
+#define TSP_BENCH_NOP		0xf2001001
+#define TSP_BENCH_SWITCH	0xf2001002
+
+/*
+ * SMC function ID that the TSP uses to select the cpu suspends it is notified
+ * of: only those which turn off at least the power level in x1. The default
+ * is 0, i.e. all the suspends which power the cpu down. Returns 0, or
+ * TSP_PM_NOTIFY_ERROR if the power level is above PLAT_MAX_PWR_LVL + 1.
+ */
+#define TSP_PM_NOTIFY		0xf2001003
+#define TSP_PM_NOTIFY_ERROR	0xffffffff
+
 /*
  * Identifiers for various TSP services. Corresponding function IDs (whether
  * fast or standard) are generated by macros defined below
@@ -65,6 +83,76 @@
 #define TSP_DIV		0x2003
 #define TSP_HANDLE_SEL1_INTR_AND_RETURN	0x2004
 
+/*
+ * Identifier of the fast SMC used to read the S-EL1 interrupt latency
+ * histograms when TSP_INTR_LATENCY_BENCH is set. It is handled by the TSPD.
+ */
+#define TSP_INTR_LATENCY	0x2005
+
+/*
+ * Identifiers of the fast SMCs which pass the operands of an arithmetic
+ * operation through a per-CPU mailbox in normal world memory instead of the
+ * registers, so that any number of them is handled by a single SMC without
+ * being copied.
+ *
+ * TSP_MBOX_REGISTER takes the physical address of the TSP_MBOX_SIZE aligned
+ * mailbox of the calling CPU in x1, or 0 to unregister it. The TSP maps it
+ * once, with the dynamic mapping support of the translation tables library.
+ *
+ * TSP_MBOX_CALL takes the operation (TSP_ADD to TSP_DIV) in x1 and the number
+ * of operand pairs at the start of the mailbox in x2. The first 64-bit word of
+ * each pair is replaced by the result of the operation on the pair.
+ *
+ * Both return TSP_MBOX_SUCCESS or TSP_MBOX_ERROR in x0.
+ */
+#define TSP_MBOX_REGISTER	0x2006
+#define TSP_MBOX_CALL		0x2007
+
+#define TSP_MBOX_SIZE		0x1000
+#define TSP_MBOX_SUCCESS	0
+#define TSP_MBOX_ERROR		0xffffffff
+
+/*
+ * Identifier of the fast SMC used to read the number of times the standard
+ * SMCs have been preempted on a CPU. It is handled by the TSPD.
+ */
+#define TSP_PREEMPT_STATS	0x2008
+
+/*
+ * Identifiers of the SMCs of the work stealing scheduler of the TSP, which is
+ * present when TSP_WORK_STEALING is set.
+ *
+ * TSP_WORK_PUSH is a standard SMC which queues x1 work items of x2 busy loop
+ * iterations on the deque of the calling CPU and runs them. The TSP on other
+ * CPUs can steal the items meanwhile. It returns once all the items have been
+ * run, with the number of items run by the calling CPU in x1 and the number
+ * of items run by other CPUs in x2.
+ *
+ * TSP_WORK_STEAL is a fast SMC which lets the TSP steal and run up to x1 items
+ * (at most TSP_WORK_STEAL_MAX) from the deques of other CPUs. It returns the
+ * number of items run in x1. The TSP also steals items when it resumes a CPU.
+ *
+ * TSP_WORK_DEPTH is a fast SMC which returns the number of items waiting in
+ * the deque of the CPU whose linear index is in x1, in x1.
+ */
+#define TSP_WORK_PUSH		0x2009
+#define TSP_WORK_STEAL		0x200a
+#define TSP_WORK_DEPTH		0x200b
+
+#define TSP_WORK_STEAL_MAX	16
+
+/*
+ * Identifier of the fast SMC which makes the TSP issue x2 (at most
+ * TSP_BENCH_MAX_CALLS) calls of SMC function ID x1 (TSP_BENCH_NOP or
+ * TSP_BENCH_SWITCH) to the secure monitor when TSP_BENCH is set. It returns
+ * the number of system counter ticks they took in x1 and the number of calls
+ * in x2, or TSP_BENCH_ERROR in x0 if x1 is not valid.
+ */
+#define TSP_BENCH_RUN		0x200c
+
+#define TSP_BENCH_MAX_CALLS	0x10000
+#define TSP_BENCH_ERROR		0xffffffff
+
 /*
  * Generate function IDs for TSP services to be used in SMC calls, by
  * appropriately setting bit 31 to differentiate standard and fast SMC calls
@@ -89,6 +89,9 @@
 #define EP_GET_EXE(x) (x & EP_EXE_MASK)
 #define EP_SET_EXE(x, ee) ((x) = ((x) & ~EP_EXE_MASK) | (ee))
 
+/* Set in an image_info by load_image() when the image is used in its device */
+#define IMAGE_ATTR_IN_PLACE	0x10
+
 #define PARAM_EP		0x01
 #define PARAM_IMAGE_BINARY	0x02
 #define PARAM_BL31		0x03
@@ -135,11 +138,26 @@
 #ifndef __ASSEMBLY__
 #include <cdefs.h> /* For __dead2 */
 #include <cassert.h>
+#include <mem_region.h>
 #include <stdint.h>
 #include <stddef.h>
 
 #define ARRAY_SIZE(a)	(sizeof(a) / sizeof((a)[0]))
 
+/*
+ * Code and read-only data only used during the cold boot of BL31. When
+ * BL31_RECLAIM_INIT is set, they are placed in pages which are handed over to
+ * the platform at the end of bl31_main(), so they must not be referenced once
+ * the cold boot is done.
+ */
+#if IMAGE_BL31 && BL31_RECLAIM_INIT
+#define __init		__section("init_text")
+#define __initconst	__section("init_rodata")
+#else
+#define __init
+#define __initconst
+#endif
+
 /*
  * Declarations of linker defined symbols to help determine memory layout of
  * BL images
@@ -156,6 +174,11 @@ extern unsigned long __BL31_END__;
 extern unsigned long __BL32_END__;
 #endif /* IMAGE_BLX */
 
+#if IMAGE_BL31 && BL31_RECLAIM_INIT
+extern unsigned long __INIT_START__;
+extern unsigned long __INIT_END__;
+#endif
+
 #if USE_COHERENT_MEM
 extern unsigned long __COHERENT_RAM_START__;
 extern unsigned long __COHERENT_RAM_END__;
@@ -261,8 +284,47 @@ typedef struct bl31_params {
 	image_info_t *bl32_image_info;
 	entry_point_info_t *bl33_ep_info;
 	image_info_t *bl33_image_info;
+#if LOAD_IMAGE_STATS
+	/*
+	 * Loading statistics of BL2, indexed by image ID. They are in BL2
+	 * memory so BL31 must copy them during its early platform setup if it
+	 * wants to keep them.
+	 */
+	const struct load_stats *load_stats;
+#endif
+#if TRUSTED_BOARD_BOOT && MEASURED_BOOT
+	/*
+	 * Measured boot event log of BL1 and BL2. It is in BL2 memory so BL31
+	 * must copy it during its early platform setup to keep it or pass it
+	 * on to BL33.
+	 */
+	const struct event_log_s *event_log;
+#endif
 } bl31_params_t;
 
+#if TRUSTED_BOARD_BOOT && MEASURED_BOOT
+/*******************************************************************************
+ * Measured boot event log. The header is followed by 'size' bytes of records,
+ * one for each image authenticated by hash, in the order the images have been
+ * authenticated. Each record is followed by 'digest_len' bytes holding the DER
+ * encoded digest of the image (including the hash algorithm), padded to a
+ * multiple of 8 bytes.
+ ******************************************************************************/
+#define EVENT_LOG_MAGIC		0x45564c47	/* "EVLG" */
+#define EVENT_LOG_SIZE		512
+#define EVENT_LOG_ALIGN		8
+
+typedef struct event_log_s {
+	uint32_t magic;
+	uint32_t size;
+} event_log_t;
+
+typedef struct event_log_rec_s {
+	uint32_t image_id;
+	uint32_t digest_len;
+} event_log_rec_t;
+#endif
+
 
 /*
  * Compile time assertions related to the 'entry_point_info' structure to
@@ -297,6 +359,24 @@ int load_auth_image(meminfo_t *mem_layout,
 		    uintptr_t image_base,
 		    image_info_t *image_data,
 		    entry_point_info_t *entry_point_info);
+int load_auth_image_alloc(mem_region_pool_t *pool,
+			  unsigned int image_id,
+			  size_t align,
+			  image_info_t *image_data);
+#if IMAGE_BL2 && BL2_IMAGE_PREFETCH
+void load_image_set_next(const meminfo_t *mem_layout, unsigned int image_id,
+			 uintptr_t image_base);
+#endif
+#if TRUSTED_BOARD_BOOT && AUTH_BATCH_CERTS
+/* Maximum number of images whose certificates are verified in one batch */
+#define AUTH_BATCH_MAX		8
+void load_auth_certs(meminfo_t *mem_layout, const unsigned int *image_ids,
+		     unsigned int num_images, uintptr_t cert_base);
+#endif
+#if TRUSTED_BOARD_BOOT && MEASURED_BOOT
+void event_log_import(const event_log_t *log);
+const event_log_t *event_log_export(void);
+#endif
 extern const char build_message[];
 extern const char version_string[];
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -80,7 +80,40 @@
 #define CTX_RUNTIME_SP		0x8
 #define CTX_SPSR_EL3		0x10
 #define CTX_ELR_EL3		0x18
-#define CTX_EL3STATE_END	0x20
+/* Groups of EL1 system registers which are not switched for this context */
+#define CTX_EL1_SYSREGS_SKIP	0x20
+#if CTX_LAZY_FPREGS
+/* Non-zero when the FP registers of the CPU hold the FP state of this context */
+#define CTX_FPREGS_LIVE		0x28
+#endif
+#define CTX_EL3STATE_END	0x30
+
+/*******************************************************************************
+ * Groups of EL1 system registers saved and restored by
+ * el1_sysregs_context_save() and el1_sysregs_context_restore(), as selected by
+ * the mask passed to them. A Secure Payload Dispatcher can leave out the groups
+ * which its Secure Payload does not use with cm_set_el1_sysregs_mask().
+ ******************************************************************************/
+/* SPSR, ELR, SP, ESR, FAR, PAR, AFSR0/1 and VBAR */
+#define CTX_EL1_SYSREGS_EXC_BIT		0
+/* SCTLR, ACTLR, CPACR, CSSELR, TTBR0/1, MAIR, AMAIR, TCR and CONTEXTIDR */
+#define CTX_EL1_SYSREGS_MMU_BIT		1
+/* TPIDR_EL1, TPIDR_EL0 and TPIDRRO_EL0 */
+#define CTX_EL1_SYSREGS_TID_BIT		2
+/*
+ * Banked AArch32 SPSRs, DACR32, IFSR32 and FPEXC32, only saved and restored
+ * with CTX_INCLUDE_AARCH32_REGS
+ */
+#define CTX_EL1_SYSREGS_AARCH32_BIT	3
+/* Non-secure timer registers, only saved and restored with NS_TIMER_SWITCH */
+#define CTX_EL1_SYSREGS_TIMER_BIT	4
+
+#define CTX_EL1_SYSREGS_EXC		(1 << CTX_EL1_SYSREGS_EXC_BIT)
+#define CTX_EL1_SYSREGS_MMU		(1 << CTX_EL1_SYSREGS_MMU_BIT)
+#define CTX_EL1_SYSREGS_TID		(1 << CTX_EL1_SYSREGS_TID_BIT)
+#define CTX_EL1_SYSREGS_AARCH32		(1 << CTX_EL1_SYSREGS_AARCH32_BIT)
+#define CTX_EL1_SYSREGS_TIMER		(1 << CTX_EL1_SYSREGS_TIMER_BIT)
+#define CTX_EL1_SYSREGS_ALL		0x1f
 
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the
@@ -91,48 +124,58 @@
 #define CTX_SYSREGS_OFFSET	(CTX_EL3STATE_OFFSET + CTX_EL3STATE_END)
 #define CTX_SPSR_EL1		0x0
 #define CTX_ELR_EL1		0x8
-#define CTX_SPSR_ABT		0x10
-#define CTX_SPSR_UND		0x18
-#define CTX_SPSR_IRQ		0x20
-#define CTX_SPSR_FIQ		0x28
-#define CTX_SCTLR_EL1		0x30
-#define CTX_ACTLR_EL1		0x38
-#define CTX_CPACR_EL1		0x40
-#define CTX_CSSELR_EL1		0x48
-#define CTX_SP_EL1		0x50
-#define CTX_ESR_EL1		0x58
-#define CTX_TTBR0_EL1		0x60
-#define CTX_TTBR1_EL1		0x68
-#define CTX_MAIR_EL1		0x70
-#define CTX_AMAIR_EL1		0x78
-#define CTX_TCR_EL1		0x80
-#define CTX_TPIDR_EL1		0x88
-#define CTX_TPIDR_EL0		0x90
-#define CTX_TPIDRRO_EL0		0x98
-#define CTX_DACR32_EL2		0xa0
-#define CTX_IFSR32_EL2		0xa8
-#define CTX_PAR_EL1		0xb0
-#define CTX_FAR_EL1		0xb8
-#define CTX_AFSR0_EL1		0xc0
-#define CTX_AFSR1_EL1		0xc8
-#define CTX_CONTEXTIDR_EL1	0xd0
-#define CTX_VBAR_EL1		0xd8
+#define CTX_SCTLR_EL1		0x10
+#define CTX_ACTLR_EL1		0x18
+#define CTX_CPACR_EL1		0x20
+#define CTX_CSSELR_EL1		0x28
+#define CTX_SP_EL1		0x30
+#define CTX_ESR_EL1		0x38
+#define CTX_TTBR0_EL1		0x40
+#define CTX_TTBR1_EL1		0x48
+#define CTX_MAIR_EL1		0x50
+#define CTX_AMAIR_EL1		0x58
+#define CTX_TCR_EL1		0x60
+#define CTX_TPIDR_EL1		0x68
+#define CTX_TPIDR_EL0		0x70
+#define CTX_TPIDRRO_EL0		0x78
+#define CTX_PAR_EL1		0x80
+#define CTX_FAR_EL1		0x88
+#define CTX_AFSR0_EL1		0x90
+#define CTX_AFSR1_EL1		0x98
+#define CTX_CONTEXTIDR_EL1	0xa0
+#define CTX_VBAR_EL1		0xa8
+/*
+ * If the lower ELs are AArch64 only, we don't have to reserve space for the
+ * AArch32 registers in the context
+ */
+#if CTX_INCLUDE_AARCH32_REGS
+#define CTX_SPSR_ABT		0xb0
+#define CTX_SPSR_UND		0xb8
+#define CTX_SPSR_IRQ		0xc0
+#define CTX_SPSR_FIQ		0xc8
+#define CTX_DACR32_EL2		0xd0
+#define CTX_IFSR32_EL2		0xd8
+#define CTX_FP_FPEXC32_EL2	0xe0
+#define CTX_AARCH32_END		0xe8
+#else
+#define CTX_AARCH32_END		0xb0
+#endif
 /*
  * If the timer registers aren't saved and restored, we don't have to reserve
  * space for them in the context
  */
 #if NS_TIMER_SWITCH
-#define CTX_CNTP_CTL_EL0	0xe0
-#define CTX_CNTP_CVAL_EL0	0xe8
-#define CTX_CNTV_CTL_EL0	0xf0
-#define CTX_CNTV_CVAL_EL0	0xf8
-#define CTX_CNTKCTL_EL1		0x100
-#define CTX_FP_FPEXC32_EL2	0x108
-#define CTX_SYSREGS_END		0x110
+#define CTX_CNTP_CTL_EL0	(CTX_AARCH32_END + 0x0)
+#define CTX_CNTP_CVAL_EL0	(CTX_AARCH32_END + 0x8)
+#define CTX_CNTV_CTL_EL0	(CTX_AARCH32_END + 0x10)
+#define CTX_CNTV_CVAL_EL0	(CTX_AARCH32_END + 0x18)
+#define CTX_CNTKCTL_EL1		(CTX_AARCH32_END + 0x20)
+#define CTX_TIMER_SYSREGS_END	(CTX_AARCH32_END + 0x28)
 #else
-#define CTX_FP_FPEXC32_EL2	0xe0
-#define CTX_SYSREGS_END		0xf0
+#define CTX_TIMER_SYSREGS_END	CTX_AARCH32_END
 #endif
+/* Keep the size of 'el1_sys_regs' a multiple of its 16 byte alignment */
+#define CTX_SYSREGS_END		((CTX_TIMER_SYSREGS_END + 0xf) & ~0xf)
 
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the 'fp_regs'
@@ -177,6 +220,28 @@
 #define CTX_FPREGS_END		0x210
 #endif
 
+/*******************************************************************************
+ * Constants that allow assembler code to access members of the 'pmu_regs'
+ * structure at their correct offsets. Each implemented event counter 'n' is
+ * saved with its event type at CTX_PMEVCNTR0_EL0 + 'n' * CTX_PMEVREGS_SIZE.
+ ******************************************************************************/
+#if CTX_INCLUDE_PMU_REGS
+#define CTX_PMCR_EL0		0x0
+#define CTX_PMCNTENSET_EL0	0x8
+#define CTX_PMINTENSET_EL1	0x10
+#define CTX_PMOVSSET_EL0	0x18
+#define CTX_PMCCNTR_EL0		0x20
+#define CTX_PMCCFILTR_EL0	0x28
+#define CTX_PMSELR_EL0		0x30
+#define CTX_PMUSERENR_EL0	0x38
+#define CTX_PMEVCNTR0_EL0	0x40
+#define CTX_PMEVTYPER0_EL0	0x48
+#define CTX_PMEVREGS_SIZE	0x10
+#define CTX_PMEVREGS_MAX	31
+#define CTX_PMUREGS_END		(CTX_PMEVCNTR0_EL0 + CTX_PMEVREGS_MAX * \
+				 CTX_PMEVREGS_SIZE)
+#endif
+
 #ifndef __ASSEMBLY__
 
 #include <cassert.h>
@@ -199,6 +264,9 @@
 #if CTX_INCLUDE_FPREGS
 #define CTX_FPREG_ALL		(CTX_FPREGS_END >> DWORD_SHIFT)
 #endif
+#if CTX_INCLUDE_PMU_REGS
+#define CTX_PMUREG_ALL		(CTX_PMUREGS_END >> DWORD_SHIFT)
+#endif
 #define CTX_EL3STATE_ALL	(CTX_EL3STATE_END >> DWORD_SHIFT)
 
 /*
@@ -226,6 +294,15 @@ DEFINE_REG_STRUCT(el1_sys_regs, CTX_SYSREG_ALL);
 DEFINE_REG_STRUCT(fp_regs, CTX_FPREG_ALL);
 #endif
 
+/*
+ * AArch64 performance monitors register context structure for preserving the
+ * counters and their configuration during switches from one security state to
+ * another, so that neither world sees the events of the other.
+ */
+#if CTX_INCLUDE_PMU_REGS
+DEFINE_REG_STRUCT(pmu_regs, CTX_PMUREG_ALL);
+#endif
+
 /*
  * Miscellaneous registers used by EL3 firmware to maintain its state
  * across exception entries and exits
@@ -247,7 +324,9 @@ DEFINE_REG_STRUCT(el3_state, CTX_EL3STATE_ALL);
  * EL and security state. The context management library will be used
  * to ensure that SP_EL3 always points to an instance of this
  * structure at exception entry and exit. Each instance will
- * correspond to either the secure or the non-secure state.
+ * correspond to either the secure or the non-secure state. Instances
+ * are aligned to the cache writeback granule so that exception entry
+ * touches as few cache lines of the structure as possible.
  */
 typedef struct cpu_context {
 	gp_regs_t gpregs_ctx;
@@ -256,13 +335,19 @@ typedef struct cpu_context {
 #if CTX_INCLUDE_FPREGS
 	fp_regs_t fpregs_ctx;
 #endif
-} cpu_context_t;
+#if CTX_INCLUDE_PMU_REGS
+	pmu_regs_t pmuregs_ctx;
+#endif
+} __aligned(CACHE_WRITEBACK_GRANULE) cpu_context_t;
 
 /* Macros to access members of the 'cpu_context_t' structure */
 #define get_el3state_ctx(h)	(&((cpu_context_t *) h)->el3state_ctx)
 #if CTX_INCLUDE_FPREGS
 #define get_fpregs_ctx(h)	(&((cpu_context_t *) h)->fpregs_ctx)
 #endif
+#if CTX_INCLUDE_PMU_REGS
+#define get_pmuregs_ctx(h)	(&((cpu_context_t *) h)->pmuregs_ctx)
+#endif
 #define get_sysregs_ctx(h)	(&((cpu_context_t *) h)->sysregs_ctx)
 #define get_gpregs_ctx(h)	(&((cpu_context_t *) h)->gpregs_ctx)
 
@@ -321,18 +406,28 @@ CASSERT(CTX_EL3STATE_OFFSET == __builtin_offsetof(cpu_context_t, el3state_ctx),
 /*******************************************************************************
  * Function prototypes
  ******************************************************************************/
-void el1_sysregs_context_save(el1_sys_regs_t *regs);
-void el1_sysregs_context_restore(el1_sys_regs_t *regs);
+void el1_sysregs_context_save(el1_sys_regs_t *regs, unsigned int mask);
+void el1_sysregs_context_restore(el1_sys_regs_t *regs, unsigned int mask);
+void el1_sysregs_context_switch(el1_sys_regs_t *save_regs,
+				el1_sys_regs_t *restore_regs,
+				unsigned int mask);
 #if CTX_INCLUDE_FPREGS
 void fpregs_context_save(fp_regs_t *regs);
 void fpregs_context_restore(fp_regs_t *regs);
 #endif
+#if CTX_INCLUDE_PMU_REGS
+void pmuregs_context_save(pmu_regs_t *regs);
+void pmuregs_context_restore(pmu_regs_t *regs);
+#endif
 
 
 #undef CTX_SYSREG_ALL
 #if CTX_INCLUDE_FPREGS
 #undef CTX_FPREG_ALL
 #endif
+#if CTX_INCLUDE_PMU_REGS
+#undef CTX_PMUREG_ALL
+#endif
 #undef CTX_GPREG_ALL
 #undef CTX_EL3STATE_ALL
 
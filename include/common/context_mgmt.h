@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -32,7 +32,11 @@
 #define __CM_H__
 
 #include <arch.h>
+#include <assert.h>
 #include <bl_common.h>
+#if IMAGE_BL31
+#include <cpu_data.h>
+#endif
 
 /*******************************************************************************
  * Forward declarations
@@ -53,8 +57,10 @@ void *cm_get_context_by_index(unsigned int cpu_idx,
 void cm_set_context_by_index(unsigned int cpu_idx,
 			     void *context,
 			     unsigned int security_state);
+#if !IMAGE_BL31
 void *cm_get_context(uint32_t security_state);
 void cm_set_context(void *context, uint32_t security_state);
+#endif
 inline void cm_set_next_context(void *context);
 void cm_init_context(uint64_t mpidr,
 		     const struct entry_point_info *ep) __deprecated;
@@ -63,18 +69,65 @@ void cm_init_context_by_index(unsigned int cpu_idx,
 			      const struct entry_point_info *ep);
 void cm_prepare_el3_exit(uint32_t security_state);
 void cm_el1_sysregs_context_save(uint32_t security_state);
+void cm_el1_sysregs_context_save_partial(uint32_t security_state,
+					 unsigned int mask);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
+void cm_el1_sysregs_context_switch(uint32_t security_state);
+void cm_set_el1_sysregs_mask(uint32_t security_state, unsigned int mask);
 void cm_set_elr_el3(uint32_t security_state, uint64_t entrypoint);
 void cm_set_elr_spsr_el3(uint32_t security_state,
 			 uint64_t entrypoint, uint32_t spsr);
 void cm_write_scr_el3_bit(uint32_t security_state,
 			  uint32_t bit_pos,
 			  uint32_t value);
+void cm_write_scr_el3_bits(uint32_t security_state,
+			   uint32_t mask,
+			   uint32_t value);
 void cm_set_next_eret_context(uint32_t security_state);
 uint32_t cm_get_scr_el3(uint32_t security_state);
+#if CTX_LAZY_FPREGS
+void cm_fpregs_context_save_live(void);
+#endif
+
+#if CTX_SUSPEND_PACK
+/* Largest size of the contexts of 'n' CPUs packed by cm_pack_contexts() */
+#define CM_PACKED_CONTEXTS_SIZE(n)					\
+	((n) * 2 * (sizeof(uint64_t) + CTX_GPREGS_END + CTX_EL3STATE_END + \
+		    CTX_SYSREGS_END) + sizeof(uint64_t))
+
+size_t cm_pack_contexts(uint64_t *buf);
+void cm_unpack_contexts(const uint64_t *buf);
+#endif
 
 /* Inline definitions */
 
+#if IMAGE_BL31
+/*******************************************************************************
+ * This function returns a pointer to the most recent 'cpu_context' structure
+ * for the calling CPU that was set as the context for the specified security
+ * state. NULL is returned if no such structure has been specified. It is on
+ * the path of every world switch, so BL31 reads it straight from the per-cpu
+ * data pointed to by TPIDR_EL3.
+ ******************************************************************************/
+static inline void *cm_get_context(uint32_t security_state)
+{
+	assert(security_state <= NON_SECURE);
+
+	return get_cpu_data(cpu_context[security_state]);
+}
+
+/*******************************************************************************
+ * This function sets the pointer to the current 'cpu_context' structure for the
+ * specified security state for the calling CPU
+ ******************************************************************************/
+static inline void cm_set_context(void *context, uint32_t security_state)
+{
+	assert(security_state <= NON_SECURE);
+
+	set_cpu_data(cpu_context[security_state], context);
+}
+#endif
+
 /*******************************************************************************
  * This function is used to program the context that's used for exception
  * return. This initializes the SP_EL3 to a pointer to a 'cpu_context' set for
@@ -50,32 +50,54 @@
 #ifndef __ASSEMBLY__
 #include <stdio.h>
 
+#if DEFERRED_LOG && IMAGE_BL31
+#include <log_record.h>
+# define TF_LOG(...)	LOG_RECORD(__VA_ARGS__)
+#else
+# define TF_LOG(...)	tf_printf(__VA_ARGS__)
+#endif
+
+/*
+ * When RUNTIME_LOG_LEVEL is set, the messages compiled in are also filtered
+ * against 'tf_log_level', before their arguments are evaluated.
+ */
+#if RUNTIME_LOG_LEVEL
+extern unsigned int tf_log_level;
+# define TF_LOG_AT(_lvl, ...)						\
+	do {								\
+		if (tf_log_level >= (_lvl))				\
+			TF_LOG(__VA_ARGS__);				\
+	} while (0)
+#else
+# define TF_LOG_AT(_lvl, ...)	TF_LOG(__VA_ARGS__)
+#endif
+
 #if LOG_LEVEL >= LOG_LEVEL_NOTICE
-# define NOTICE(...)	tf_printf("NOTICE:  " __VA_ARGS__)
+# define NOTICE(...)	TF_LOG_AT(LOG_LEVEL_NOTICE, "NOTICE:  " __VA_ARGS__)
 #else
 # define NOTICE(...)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_ERROR
-# define ERROR(...)	tf_printf("ERROR:   " __VA_ARGS__)
+# define ERROR(...)	TF_LOG_AT(LOG_LEVEL_ERROR, "ERROR:   " __VA_ARGS__)
 #else
 # define ERROR(...)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_WARNING
-# define WARN(...)	tf_printf("WARNING: " __VA_ARGS__)
+# define WARN(...)	TF_LOG_AT(LOG_LEVEL_WARNING, "WARNING: " __VA_ARGS__)
 #else
 # define WARN(...)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-# define INFO(...)	tf_printf("INFO:    " __VA_ARGS__)
+# define INFO(...)	TF_LOG_AT(LOG_LEVEL_INFO, "INFO:    " __VA_ARGS__)
 #else
 # define INFO(...)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
-# define VERBOSE(...)	tf_printf("VERBOSE: " __VA_ARGS__)
+# define VERBOSE(...)	TF_LOG_AT(LOG_LEVEL_VERBOSE, "VERBOSE: " __VA_ARGS__)
 #else
 # define VERBOSE(...)
 #endif
@@ -37,6 +37,26 @@
 /* This is used as a signature to validate the blob header */
 #define TOC_HEADER_NAME	0xAA640001
 
+/*
+ * ToC header flags: log2 of the alignment of the images within the package,
+ * relative to its start. 0 means that the images are not aligned.
+ */
+#define TOC_HEADER_FLAGS_ALIGN_SHIFT	0
+#define TOC_HEADER_FLAGS_ALIGN_MASK	0xff
+
+/*
+ * The compression method of an image is held in the flags of its ToC entry.
+ * The 'size' of a compressed image is the size of its payload in the package,
+ * the size of the decompressed image is held in the top of the flags.
+ */
+#define TOC_ENTRY_FLAGS_COMPRESSION_SHIFT	0
+#define TOC_ENTRY_FLAGS_COMPRESSION_MASK	0xff
+#define TOC_ENTRY_FLAGS_SIZE_SHIFT		32
+#define TOC_ENTRY_FLAGS_SIZE_MASK		0xffffffff
+
+#define TOC_ENTRY_COMPRESSION_NONE	0
+#define TOC_ENTRY_COMPRESSION_LZ4	1
+
 
 /* ToC Entry UUIDs */
 #define UUID_TRUSTED_UPDATE_FIRMWARE_SCP_BL2U \
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LOAD_STATS_H__
+#define __LOAD_STATS_H__
+
+/*******************************************************************************
+ * Image loading statistics. When LOAD_IMAGE_STATS is set, the BL stages that
+ * load and authenticate images account, per image ID, the number of bytes
+ * read and the system counter ticks spent in each phase of the process. The
+ * time spent in the image parser by an authentication method is accounted to
+ * that method.
+ ******************************************************************************/
+
+/* Phases of the loading and authentication of an image */
+#define LOAD_STATS_IO			0
+#define LOAD_STATS_HASH			1
+#define LOAD_STATS_PARSE		2
+#define LOAD_STATS_SIG			3
+#define LOAD_STATS_PHASES		4
+
+/* Number of image IDs tracked. Images with a larger ID are not accounted */
+#define LOAD_STATS_MAX_IMAGES		32
+
+#ifndef __ASSEMBLY__
+
+#include <arch_helpers.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct load_stats {
+	uint64_t bytes;
+	uint64_t ticks[LOAD_STATS_PHASES];
+} load_stats_t;
+
+#if LOAD_IMAGE_STATS
+/* Return a time stamp marking the start of a phase */
+static inline uint64_t load_stats_now(void)
+{
+	return read_cntpct_el0();
+}
+
+void load_stats_add(unsigned int image_id, unsigned int phase, uint64_t start);
+void load_stats_add_bytes(unsigned int image_id, size_t bytes);
+uint64_t load_stats_ticks(unsigned int image_id, unsigned int phase);
+uint64_t load_stats_bytes(unsigned int image_id);
+void load_stats_print(void);
+const load_stats_t *load_stats_export(void);
+#else
+static inline uint64_t load_stats_now(void)
+{
+	return 0;
+}
+
+static inline void load_stats_add(unsigned int image_id, unsigned int phase,
+				  uint64_t start)
+{
+}
+
+static inline void load_stats_add_bytes(unsigned int image_id, size_t bytes)
+{
+}
+
+static inline uint64_t load_stats_ticks(unsigned int image_id,
+					unsigned int phase)
+{
+	return 0;
+}
+
+static inline uint64_t load_stats_bytes(unsigned int image_id)
+{
+	return 0;
+}
+
+static inline void load_stats_print(void)
+{
+}
+#endif /* LOAD_IMAGE_STATS */
+
+#endif /* __ASSEMBLY__ */
+#endif /* __LOAD_STATS_H__ */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LOG_RECORD_H__
+#define __LOG_RECORD_H__
+
+/*******************************************************************************
+ * Deferred formatting of the log messages. When DEFERRED_LOG is set, the log
+ * macros of BL31 do not format their message. They print a record holding the
+ * address of the format string and the raw value of each argument instead, and
+ * tools/log_decode formats it on the host from the ELF file of BL31.
+ *
+ * A record is a line made of LOG_RECORD_MARKER followed by the address of the
+ * format string and the argument values, each in hexadecimal and preceded by a
+ * space. The arguments of %s must point to strings held by the ELF file.
+ ******************************************************************************/
+
+/* First character of a record, the ASCII record separator */
+#define LOG_RECORD_MARKER		0x1e
+
+/* Maximum number of arguments of a message */
+#define LOG_RECORD_MAX_ARGS		8
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+void log_record(const char *fmt, unsigned int nargs, const uint64_t *args);
+
+/*
+ * Count the arguments following the format string. The trailing '_' keeps the
+ * variable part of LOG_REC_NARGS_() non-empty, as ISO C99 requires.
+ */
+#define LOG_REC_NARGS(...)						\
+	LOG_REC_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, _)
+#define LOG_REC_NARGS_(_fmt, _1, _2, _3, _4, _5, _6, _7, _8, _n, ...)	_n
+
+#define LOG_REC_CAT(_a, _b)		LOG_REC_CAT_(_a, _b)
+#define LOG_REC_CAT_(_a, _b)		_a##_b
+
+#define LOG_REC_ARG(_a)			((uint64_t)(_a))
+
+#define LOG_REC_EMIT(_fmt, _n, ...)					\
+	do {								\
+		const uint64_t log_rec_args[] = { __VA_ARGS__ };	\
+		log_record(_fmt, _n, log_rec_args);			\
+	} while (0)
+
+#define LOG_REC_0(_fmt)							\
+	log_record(_fmt, 0, (const uint64_t *)0)
+#define LOG_REC_1(_fmt, _1)						\
+	LOG_REC_EMIT(_fmt, 1, LOG_REC_ARG(_1))
+#define LOG_REC_2(_fmt, _1, _2)						\
+	LOG_REC_EMIT(_fmt, 2, LOG_REC_ARG(_1), LOG_REC_ARG(_2))
+#define LOG_REC_3(_fmt, _1, _2, _3)					\
+	LOG_REC_EMIT(_fmt, 3, LOG_REC_ARG(_1), LOG_REC_ARG(_2),	\
+		     LOG_REC_ARG(_3))
+#define LOG_REC_4(_fmt, _1, _2, _3, _4)					\
+	LOG_REC_EMIT(_fmt, 4, LOG_REC_ARG(_1), LOG_REC_ARG(_2),	\
+		     LOG_REC_ARG(_3), LOG_REC_ARG(_4))
+#define LOG_REC_5(_fmt, _1, _2, _3, _4, _5)				\
+	LOG_REC_EMIT(_fmt, 5, LOG_REC_ARG(_1), LOG_REC_ARG(_2),	\
+		     LOG_REC_ARG(_3), LOG_REC_ARG(_4), LOG_REC_ARG(_5))
+#define LOG_REC_6(_fmt, _1, _2, _3, _4, _5, _6)				\
+	LOG_REC_EMIT(_fmt, 6, LOG_REC_ARG(_1), LOG_REC_ARG(_2),	\
+		     LOG_REC_ARG(_3), LOG_REC_ARG(_4), LOG_REC_ARG(_5),	\
+		     LOG_REC_ARG(_6))
+#define LOG_REC_7(_fmt, _1, _2, _3, _4, _5, _6, _7)			\
+	LOG_REC_EMIT(_fmt, 7, LOG_REC_ARG(_1), LOG_REC_ARG(_2),	\
+		     LOG_REC_ARG(_3), LOG_REC_ARG(_4), LOG_REC_ARG(_5),	\
+		     LOG_REC_ARG(_6), LOG_REC_ARG(_7))
+#define LOG_REC_8(_fmt, _1, _2, _3, _4, _5, _6, _7, _8)			\
+	LOG_REC_EMIT(_fmt, 8, LOG_REC_ARG(_1), LOG_REC_ARG(_2),	\
+		     LOG_REC_ARG(_3), LOG_REC_ARG(_4), LOG_REC_ARG(_5),	\
+		     LOG_REC_ARG(_6), LOG_REC_ARG(_7), LOG_REC_ARG(_8))
+
+/*
+ * Print a record for the format string and arguments given, which follow the
+ * tf_printf() conventions. The format string must be a string literal. The
+ * dead call to tf_printf() only keeps the compiler checking the arguments
+ * against it.
+ */
+#define LOG_RECORD(...)							\
+	do {								\
+		if (0)							\
+			tf_printf(__VA_ARGS__);				\
+		LOG_REC_CAT(LOG_REC_, LOG_REC_NARGS(__VA_ARGS__))	\
+			(__VA_ARGS__);					\
+	} while (0)
+
+#endif /* __ASSEMBLY__ */
+#endif /* __LOG_RECORD_H__ */
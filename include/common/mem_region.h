@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __MEM_REGION_H__
+#define __MEM_REGION_H__
+
+/*******************************************************************************
+ * Memory region allocator. A pool tracks the free extents of a memory region,
+ * so that images placed anywhere in the region do not waste the memory around
+ * them, unlike a meminfo_t which only describes a single free extent. Images
+ * with a fixed address are reserved with mem_region_reserve(), the other ones
+ * are placed by mem_region_alloc() in the free extent they fit best.
+ ******************************************************************************/
+
+/*
+ * Maximum number of free extents tracked in a pool. When a reservation would
+ * split an extent and no entry is left, the smaller part is discarded.
+ */
+#ifndef MEM_REGION_MAX_FREE
+#define MEM_REGION_MAX_FREE		8
+#endif
+
+#ifndef __ASSEMBLY__
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct mem_extent {
+	uint64_t base;
+	size_t size;
+} mem_extent_t;
+
+typedef struct mem_region_pool {
+	/* Free extents, sorted by address */
+	mem_extent_t free[MEM_REGION_MAX_FREE];
+	unsigned int num_free;
+	/* Memory discarded because too many extents were needed */
+	size_t discarded;
+} mem_region_pool_t;
+
+void mem_region_init(mem_region_pool_t *pool, uint64_t base, size_t size);
+int mem_region_is_free(const mem_region_pool_t *pool, uint64_t base,
+		       size_t size);
+int mem_region_reserve(mem_region_pool_t *pool, uint64_t base, size_t size);
+int mem_region_alloc(mem_region_pool_t *pool, size_t size, size_t align,
+		     uint64_t *base);
+void mem_region_free(mem_region_pool_t *pool, uint64_t base, size_t size);
+size_t mem_region_free_size(const mem_region_pool_t *pool);
+size_t mem_region_largest_free(const mem_region_pool_t *pool);
+void mem_region_print(const mem_region_pool_t *pool);
+
+#endif /* __ASSEMBLY__ */
+#endif /* __MEM_REGION_H__ */
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __WARM_REBOOT_H__
+#define __WARM_REBOOT_H__
+
+/*******************************************************************************
+ * Fast warm reboot (FAST_WARM_REBOOT). BL2 records the SHA-256 digest of each
+ * image it leaves in DRAM in a manifest held by the platform in secure memory
+ * which survives a system reset. BL31 arms the manifest when the normal world
+ * requests a PSCI SYSTEM_RESET. On the next boot, BL2 uses an image recorded in
+ * an armed manifest in place, instead of loading and authenticating it again,
+ * if it is still resident at the same address with the same digest and if the
+ * image in the storage device has the same size. The manifest is invalidated
+ * by BL2 as soon as it has been read, so any other reset leads to a full boot.
+ ******************************************************************************/
+
+#define WARM_REBOOT_MAGIC		0x544f4257	/* "WBOT" */
+#define WARM_REBOOT_MAX_IMAGES		4
+
+/* States of the manifest */
+#define WARM_REBOOT_RECORDED		0x1	/* Written by BL2 */
+#define WARM_REBOOT_ARMED		0x2	/* System reset requested */
+
+#ifndef __ASSEMBLY__
+
+#include <errno.h>
+#include <stdint.h>
+
+struct entry_point_info;
+struct image_info;
+struct meminfo;
+
+typedef struct warm_reboot_image {
+	uint32_t image_id;
+	/* Size of the image in memory */
+	uint32_t size;
+	uint64_t base;
+	/* Size of the image in the storage device */
+	uint32_t stored_size;
+	uint32_t reserved;
+	unsigned char sha256[32];
+} warm_reboot_image_t;
+
+typedef struct warm_reboot_manifest {
+	uint32_t magic;
+	/* Not covered by the digest, as BL31 arms the manifest in place */
+	uint32_t state;
+	uint32_t num_images;
+	uint32_t reserved;
+	warm_reboot_image_t images[WARM_REBOOT_MAX_IMAGES];
+	/* SHA-256 of the fields above, with 'state' taken as 0 */
+	unsigned char digest[32];
+} warm_reboot_manifest_t;
+
+#if FAST_WARM_REBOOT && IMAGE_BL2
+void warm_reboot_init(void);
+void warm_reboot_check(unsigned int image_id,
+		       const struct meminfo *mem_layout, uintptr_t image_base);
+int warm_reboot_reuse(unsigned int image_id, struct image_info *image_data,
+		      struct entry_point_info *entry_point_info);
+void warm_reboot_record(unsigned int image_id,
+			const struct image_info *image_data);
+void warm_reboot_seal(void);
+#else
+static inline int warm_reboot_reuse(unsigned int image_id,
+				    struct image_info *image_data,
+				    struct entry_point_info *entry_point_info)
+{
+	return -ENOENT;
+}
+#endif
+
+#if FAST_WARM_REBOOT && IMAGE_BL31
+void warm_reboot_arm(void);
+#endif
+
+#endif /* __ASSEMBLY__ */
+#endif /* __WARM_REBOOT_H__ */
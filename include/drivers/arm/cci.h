@@ -151,6 +151,8 @@ void cci_init(uintptr_t cci_base,
 	unsigned int num_cci_masters);
 
 void cci_enable_snoop_dvm_reqs(unsigned int master_id);
+void cci_enable_snoop_dvm_reqs_async(unsigned int master_id);
+void cci_wait_snoop_dvm_reqs(void);
 void cci_disable_snoop_dvm_reqs(unsigned int master_id);
 
 #endif /* __ASSEMBLY__ */
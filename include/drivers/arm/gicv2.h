@@ -146,6 +146,20 @@ typedef struct gicv2_driver_data {
 	const unsigned int *g0_interrupt_array;
 } gicv2_driver_data_t;
 
+/*******************************************************************************
+ * This structure holds the banked Distributor registers of a CPU, i.e. the
+ * configuration of its SGIs and PPIs, so that a platform can save them before
+ * powering the CPU down and restore them quickly when it is powered up again.
+ ******************************************************************************/
+/* 32 SGIs and PPIs, 4 per register */
+#define GICV2_PCPU_IPRIORITYR_NUM	8
+
+typedef struct gicv2_pcpu_ctx {
+	unsigned int igroupr0;
+	unsigned int isenabler0;
+	unsigned int ipriorityr[GICV2_PCPU_IPRIORITYR_NUM];
+} gicv2_pcpu_ctx_t;
+
 /*******************************************************************************
  * Function prototypes
  ******************************************************************************/
@@ -154,12 +168,17 @@ void gicv2_distif_init(void);
 void gicv2_pcpu_distif_init(void);
 void gicv2_cpuif_enable(void);
 void gicv2_cpuif_disable(void);
+void gicv2_save_pcpu_distif(gicv2_pcpu_ctx_t *ctx);
+void gicv2_restore_pcpu_distif(const gicv2_pcpu_ctx_t *ctx);
 unsigned int gicv2_is_fiq_enabled(void);
 unsigned int gicv2_get_pending_interrupt_type(void);
 unsigned int gicv2_get_pending_interrupt_id(void);
 unsigned int gicv2_acknowledge_interrupt(void);
 void gicv2_end_of_interrupt(unsigned int id);
 unsigned int gicv2_get_interrupt_group(unsigned int id);
+unsigned int gicv2_set_pmr(unsigned int mask);
+unsigned int gicv2_get_running_priority(void);
+void gicv2_set_spi_target_self(unsigned int id);
 
 #endif /* __ASSEMBLY__ */
 #endif /* __GICV2_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -100,10 +100,13 @@
 #define GICR_IGROUPR0		(GICR_SGIBASE_OFFSET + 0x80)
 #define GICR_ISENABLER0		(GICR_SGIBASE_OFFSET + 0x100)
 #define GICR_ICENABLER0		(GICR_SGIBASE_OFFSET + 0x180)
+#define GICR_ISPENDR0		(GICR_SGIBASE_OFFSET + 0x200)
+#define GICR_ISACTIVER0		(GICR_SGIBASE_OFFSET + 0x300)
 #define GICR_IPRIORITYR		(GICR_SGIBASE_OFFSET + 0x400)
 #define GICR_ICFGR0		(GICR_SGIBASE_OFFSET + 0xc00)
 #define GICR_ICFGR1		(GICR_SGIBASE_OFFSET + 0xc04)
 #define GICR_IGRPMODR0		(GICR_SGIBASE_OFFSET + 0xd00)
+#define GICR_NSACR		(GICR_SGIBASE_OFFSET + 0xe00)
 
 /* GICR_CTLR bit definitions */
 #define GICR_CTLR_RWP_SHIFT	3
@@ -169,6 +172,7 @@
 
 #ifndef __ASSEMBLY__
 
+#include <gic_common.h>
 #include <stdint.h>
 
 #define gicv3_is_intr_id_special_identifier(id)	\
@@ -248,18 +252,74 @@ typedef struct gicv3_driver_data {
 	mpidr_hash_fn mpidr_to_core_pos;
 } gicv3_driver_data_t;
 
+/*******************************************************************************
+ * Number of interrupts and of 32-bit registers of a given 'shift' (number of
+ * interrupts per register expressed as a power of 2) used to describe the SPIs
+ * in the Distributor and the SGIs/PPIs in a Redistributor.
+ ******************************************************************************/
+#define TOTAL_SPI_INTR_NUM	(MAX_SPI_ID - MIN_SPI_ID + 1)
+#define TOTAL_PCPU_INTR_NUM	MIN_SPI_ID
+#define GICV3_SPI_REGS_NUM(shift)	\
+	((TOTAL_SPI_INTR_NUM + (1 << (shift)) - 1) >> (shift))
+
+/*******************************************************************************
+ * These structures are used by the platform port to save the configuration and
+ * state of the Distributor and of a Redistributor before they lose power (e.g.
+ * on system suspend) through gicv3_distif_save() and gicv3_rdistif_save(), and
+ * to restore it on resume through gicv3_distif_restore() and
+ * gicv3_rdistif_restore() instead of reinitialising the GIC. The memory has to
+ * be allocated by the platform port and retained across the power down. Only
+ * the SPIs implemented by the Distributor are saved and restored. LPIs are not
+ * supported.
+ ******************************************************************************/
+typedef struct gicv3_dist_ctx {
+	uint32_t gicd_ctlr;
+	uint32_t gicd_igroupr[GICV3_SPI_REGS_NUM(IGROUPR_SHIFT)];
+	uint32_t gicd_isenabler[GICV3_SPI_REGS_NUM(ISENABLER_SHIFT)];
+	uint32_t gicd_ispendr[GICV3_SPI_REGS_NUM(ISPENDR_SHIFT)];
+	uint32_t gicd_isactiver[GICV3_SPI_REGS_NUM(ISACTIVER_SHIFT)];
+	uint32_t gicd_ipriorityr[GICV3_SPI_REGS_NUM(IPRIORITYR_SHIFT)];
+	uint32_t gicd_icfgr[GICV3_SPI_REGS_NUM(ICFGR_SHIFT)];
+	uint32_t gicd_igrpmodr[GICV3_SPI_REGS_NUM(IGRPMODR_SHIFT)];
+	uint32_t gicd_nsacr[GICV3_SPI_REGS_NUM(NSACR_SHIFT)];
+	uint64_t gicd_irouter[TOTAL_SPI_INTR_NUM];
+} gicv3_dist_ctx_t;
+
+typedef struct gicv3_redist_ctx {
+	uint32_t gicr_igroupr0;
+	uint32_t gicr_isenabler0;
+	uint32_t gicr_ispendr0;
+	uint32_t gicr_isactiver0;
+	uint32_t gicr_ipriorityr[TOTAL_PCPU_INTR_NUM >> IPRIORITYR_SHIFT];
+	uint32_t gicr_icfgr0;
+	uint32_t gicr_icfgr1;
+	uint32_t gicr_igrpmodr0;
+	uint32_t gicr_nsacr;
+} gicv3_redist_ctx_t;
+
 /*******************************************************************************
  * GICv3 EL3 driver API
  ******************************************************************************/
 void gicv3_driver_init(const gicv3_driver_data_t *plat_driver_data);
 void gicv3_distif_init(void);
 void gicv3_rdistif_init(unsigned int proc_num);
+void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx);
+void gicv3_distif_restore(const gicv3_dist_ctx_t * const dist_ctx);
+void gicv3_rdistif_save(unsigned int proc_num,
+			gicv3_redist_ctx_t * const rdist_ctx);
+void gicv3_rdistif_restore(unsigned int proc_num,
+			   const gicv3_redist_ctx_t * const rdist_ctx);
 void gicv3_cpuif_enable(unsigned int proc_num);
 void gicv3_cpuif_disable(unsigned int proc_num);
+uintptr_t gicv3_rdistif_base(unsigned int proc_num);
+void gicv3_rdistif_init_by_base(uintptr_t gicr_base);
+void gicv3_cpuif_enable_by_base(uintptr_t gicr_base);
+void gicv3_cpuif_disable_by_base(uintptr_t gicr_base);
 unsigned int gicv3_get_pending_interrupt_type(void);
 unsigned int gicv3_get_pending_interrupt_id(void);
 unsigned int gicv3_get_interrupt_type(unsigned int id,
 					  unsigned int proc_num);
+unsigned int gicv3_set_pmr(unsigned int mask);
 
 
 #endif /* __ASSEMBLY__ */
@@ -34,6 +34,7 @@
 /* SP805 register offset */
 #define SP805_WDOG_LOAD_OFF		0x000
 #define SP805_WDOG_CTR_OFF		0x008
+#define SP805_WDOG_INTCLR_OFF		0x00c
 #define SP805_WDOG_LOCK_OFF		0xc00
 
 /* Magic word to unlock the wd registers */
@@ -52,6 +53,7 @@
 void sp805_start(uintptr_t base, unsigned long ticks);
 void sp805_stop(uintptr_t base);
 void sp805_refresh(uintptr_t base, unsigned long ticks);
+void sp805_clear_interrupt(uintptr_t base);
 
 #endif /* __ASSEMBLY__ */
 
@@ -43,6 +43,7 @@
 #define FAIL_ADDRESS_HIGH_OFF	0x024
 #define FAIL_CONTROL_OFF	0x028
 #define FAIL_ID			0x02c
+#define FAIL_NUM_OFF(filter)	(0x10 * filter)
 
 #define REGION_BASE_LOW_OFF	0x100
 #define REGION_BASE_HIGH_OFF	0x104
@@ -51,6 +52,10 @@
 #define REGION_ATTRIBUTES_OFF	0x110
 #define REGION_ID_ACCESS_OFF	0x114
 #define REGION_NUM_OFF(region)  (0x20 * region)
+#define REGION_NUM_REGS		6
+
+/* Maximum number of regions, including region 0, a TZC-400 can implement */
+#define TZC400_MAX_REGIONS	9
 
 /* ID Registers */
 #define PID0_OFF		0xfe0
@@ -139,10 +144,10 @@
 
 /* Macros for setting Region ID access permissions based on NSAID */
 #define TZC_REGION_ACCESS_RD(id)					\
-		((1 << (id & REGION_ID_ACCESS_NSAID_ID_MASK)) <<	\
+		((1U << (id & REGION_ID_ACCESS_NSAID_ID_MASK)) <<	\
 		 REGION_ID_ACCESS_NSAID_RD_EN_SHIFT)
 #define TZC_REGION_ACCESS_WR(id)					\
-		((1 << (id & REGION_ID_ACCESS_NSAID_ID_MASK)) <<	\
+		((1U << (id & REGION_ID_ACCESS_NSAID_ID_MASK)) <<	\
 		 REGION_ID_ACCESS_NSAID_WR_EN_SHIFT)
 #define TZC_REGION_ACCESS_RDWR(id)					\
 		(TZC_REGION_ACCESS_RD(id) | TZC_REGION_ACCESS_WR(id))
@@ -190,6 +195,41 @@ typedef enum {
 	TZC_REGION_S_RDWR = (TZC_REGION_S_RD | TZC_REGION_S_WR)
 } tzc_region_attributes_t;
 
+/*
+ * Describes a region to be programmed by tzc_configure_regions(). The fields
+ * are the parameters of tzc_configure_region().
+ */
+typedef struct tzc_region {
+	uint32_t filters;
+	uint8_t region;
+	uint64_t region_base;
+	uint64_t region_top;
+	tzc_region_attributes_t sec_attr;
+	uint32_t ns_device_access;
+} tzc_region_t;
+
+/*
+ * Copy of the TZC registers that tzc_save_state() takes and
+ * tzc_restore_state() writes back. The region registers are stored in the
+ * order they appear in the programmer's view.
+ */
+/*
+ * Information about the last access a filter has rejected, as reported by its
+ * FAIL_ADDRESS, FAIL_CONTROL and FAIL_ID registers.
+ */
+typedef struct tzc_fail_info {
+	uint64_t address;
+	uint32_t control;
+	uint32_t id;
+	uint32_t filter;
+} tzc_fail_info_t;
+
+typedef struct tzc_state {
+	uint32_t action;
+	uint32_t gate_keeper;
+	uint32_t region[TZC400_MAX_REGIONS][REGION_NUM_REGS];
+} tzc_state_t;
+
 
 void tzc_init(uintptr_t base);
 void tzc_configure_region0(tzc_region_attributes_t sec_attr,
@@ -200,9 +240,16 @@ void tzc_configure_region(uint32_t filters,
 			uint64_t region_top,
 			tzc_region_attributes_t sec_attr,
 			uint32_t ns_device_access);
+void tzc_configure_regions(const tzc_region_t *regions,
+			unsigned int num_regions);
 void tzc_enable_filters(void);
 void tzc_disable_filters(void);
 void tzc_set_action(tzc_action_t action);
+uint32_t tzc_get_int_status(void);
+void tzc_get_fail_info(uint32_t filter, tzc_fail_info_t *info);
+void tzc_clear_int(uint32_t filters);
+void tzc_save_state(tzc_state_t *state);
+void tzc_restore_state(const tzc_state_t *state);
 
 #endif /* __ASSEMBLY__ */
 
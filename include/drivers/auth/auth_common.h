@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -50,11 +50,17 @@ typedef enum auth_param_type_enum {
 
 /*
  * Defines an authentication parameter. The cookie will be interpreted by the
- * image parser module.
+ * image parser module. A parameter which is extracted from an image to verify
+ * its children has a fixed slot in the 'authenticated_data' array of that
+ * image, so the authentication module can find it without a search. The slot
+ * is AUTH_PARAM_NO_SLOT for the other parameters.
  */
+#define AUTH_PARAM_NO_SLOT		0xffffffff
+
 typedef struct auth_param_type_desc_s {
 	auth_param_type_t type;
 	void *cookie;
+	unsigned int slot;
 } auth_param_type_desc_t;
 
 /*
@@ -80,6 +86,7 @@ typedef enum auth_method_type_enum {
 	AUTH_METHOD_NONE = 0,
 	AUTH_METHOD_HASH,	/* Authenticate by hash matching */
 	AUTH_METHOD_SIG,	/* Authenticate by PK operation */
+	AUTH_METHOD_PLAT_HASH,	/* Authenticate by platform hash matching */
 	AUTH_METHOD_NUM 	/* Number of methods */
 } auth_method_type_t;
 
@@ -91,6 +98,13 @@ typedef struct auth_method_param_hash_s {
 	auth_param_type_desc_t *hash;	/* Hash to match with */
 } auth_method_param_hash_t;
 
+/*
+ * Parameters for authentication by matching a hash held by the platform
+ */
+typedef struct auth_method_param_plat_hash_s {
+	auth_param_type_desc_t *data;	/* Data to hash */
+} auth_method_param_plat_hash_t;
+
 /*
  * Parameters for authentication by signature
  */
@@ -116,6 +130,7 @@ typedef struct auth_method_desc_s {
 	union {
 		auth_method_param_hash_t hash;
 		auth_method_param_sig_t sig;
+		auth_method_param_plat_hash_t plat_hash;
 		auth_method_param_nv_ctr_t nv_ctr;
 	} param;
 } auth_method_desc_t;
@@ -126,7 +141,19 @@ typedef struct auth_method_desc_s {
 #define AUTH_PARAM_TYPE_DESC(_type, _cookie) \
 	{ \
 		.type = _type, \
-		.cookie = (void *)_cookie \
+		.cookie = (void *)_cookie, \
+		.slot = AUTH_PARAM_NO_SLOT \
+	}
+
+/*
+ * Helper macro to define the type descriptor of a parameter stored in slot
+ * '_slot' of the 'authenticated_data' array of the image it is extracted from
+ */
+#define AUTH_PARAM_TYPE_DESC_SLOT(_type, _cookie, _slot) \
+	{ \
+		.type = _type, \
+		.cookie = (void *)_cookie, \
+		.slot = _slot \
 	}
 
 /*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -36,12 +36,27 @@
 #include <auth_common.h>
 #include <cot_def.h>
 #include <img_parser_mod.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /*
  * Image flags
  */
 #define IMG_FLAG_AUTHENTICATED		(1 << 0)
 
+#if AUTH_HANDOFF
+/*
+ * Header of the authentication data handed over by BL1 to BL2. It is followed
+ * by 'size' bytes of records holding the parameters extracted from the images
+ * authenticated by BL1 and the ROTPK verified against the platform hash.
+ */
+#define AUTH_HANDOFF_MAGIC		0x41555448	/* "AUTH" */
+
+typedef struct auth_handoff_s {
+	uint32_t magic;
+	uint32_t size;
+} auth_handoff_t;
+#endif
 
 /*
  * Authentication image descriptor
@@ -54,18 +69,61 @@ typedef struct auth_img_desc_s {
 	auth_param_desc_t authenticated_data[COT_MAX_VERIFIED_PARAMS];
 } auth_img_desc_t;
 
+#if AUTH_PARAM_POOL
+/*
+ * Block of the parameter pool holding the parameters extracted from an image.
+ * Only the parameters whose data descriptor has a NULL pointer are stored in
+ * the pool, one after the other.
+ */
+typedef struct auth_pool_blk_s {
+	uint16_t offset;
+	uint16_t size;		/* 0 if the image has no block */
+	uint16_t last_use;	/* Pool use count when last used */
+} auth_pool_blk_t;
+#endif
+
 /* Public functions */
 void auth_mod_init(void);
 int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+#if AUTH_STREAM_HASH
+void auth_mod_stream_hash_start(unsigned int img_id);
+void auth_mod_stream_hash_update(void *data_ptr, unsigned int data_len);
+size_t auth_mod_stream_hash_len(unsigned int img_id, const void *data_ptr);
+#endif
+#if MEASURED_BOOT
+int auth_mod_get_img_digest(unsigned int img_id, void **digest,
+			    unsigned int *len);
+#endif
+#if AUTH_HANDOFF
+size_t auth_mod_handoff_export(void *buf, size_t size);
+void auth_mod_handoff_import(const void *buf);
+#endif
+
+#if AUTH_PARAM_POOL
+#define REGISTER_COT_POOL_BLKS(_cot) \
+	auth_pool_blk_t auth_img_pool_blks[sizeof(_cot)/sizeof(_cot[0])];
+#else
+#define REGISTER_COT_POOL_BLKS(_cot)
+#endif
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t */
 #define REGISTER_COT(_cot) \
 	const auth_img_desc_t *const cot_desc_ptr = \
 			(const auth_img_desc_t *const)&_cot[0]; \
-	unsigned int auth_img_flags[sizeof(_cot)/sizeof(_cot[0])]
+	unsigned int auth_img_flags[sizeof(_cot)/sizeof(_cot[0])]; \
+	REGISTER_COT_POOL_BLKS(_cot) \
+	const unsigned int cot_desc_size = sizeof(_cot)/sizeof(_cot[0])
+
+/*
+ * Macro to register the memory, an array of bytes, from which the parameters
+ * of the CoT without a buffer of their own are allocated
+ */
+#define REGISTER_COT_PARAM_POOL(_pool) \
+	uint8_t *const cot_param_pool = _pool; \
+	const unsigned int cot_param_pool_size = sizeof(_pool)
 
 #endif /* TRUSTED_BOARD_BOOT */
 
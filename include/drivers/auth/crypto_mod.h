@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -37,7 +37,8 @@ enum crypto_ret_value {
 	CRYPTO_ERR_INIT,
 	CRYPTO_ERR_HASH,
 	CRYPTO_ERR_SIGNATURE,
-	CRYPTO_ERR_UNKNOWN
+	CRYPTO_ERR_UNKNOWN,
+	CRYPTO_IN_PROGRESS
 };
 
 /*
@@ -61,8 +62,59 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Verify a hash calculated incrementally. These functions are optional.
+	 * 'verify_hash_start' takes the hash to be matched, 'verify_hash_update'
+	 * is called for each consecutive chunk of data and 'verify_hash_finish'
+	 * performs the comparison. Only one incremental hash is in progress at
+	 * a time. Return one of the 'enum crypto_ret_value' options */
+	int (*verify_hash_start)(void *digest_info_ptr,
+				 unsigned int digest_info_len);
+	int (*verify_hash_update)(void *data_ptr, unsigned int data_len);
+	int (*verify_hash_finish)(void);
 } crypto_lib_desc_t;
 
+/*
+ * Hardware crypto engine descriptor, returned by plat_get_crypto_engine()
+ *
+ * The engine operates asynchronously on data in memory (e.g. by DMA), so the
+ * CPU can carry on loading the next chunk of an image while the previous one
+ * is being hashed. The engine driver performs any cache maintenance the
+ * transfers require. Only one operation is in progress on the engine at a time.
+ */
+typedef struct crypto_engine_desc_s {
+	const char *name;
+
+	/* Start a hash calculated incrementally. Return CRYPTO_SUCCESS if the
+	 * engine supports the algorithm in 'digest_info_ptr', any other value
+	 * makes the crypto module fall back to the crypto library */
+	int (*hash_start)(void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Queue a chunk of data after the previous ones and return without
+	 * waiting for it to be processed. The data must not be modified until
+	 * 'poll' reports that the engine is idle */
+	int (*hash_update)(void *data_ptr, unsigned int data_len);
+
+	/* Compare the hash of the data queued with the expected value and
+	 * release the engine. Only called once the engine is idle, also when
+	 * the hash is abandoned */
+	int (*hash_finish)(void);
+
+	/* Start verifying a digital signature. This function is optional and
+	 * takes the same parameters as 'verify_signature' in the crypto
+	 * library. Return CRYPTO_SUCCESS if the verification has been started,
+	 * any other value makes the crypto module fall back to the library */
+	int (*verify_signature_start)(void *data_ptr, unsigned int data_len,
+				      void *sig_ptr, unsigned int sig_len,
+				      void *sig_alg, unsigned int sig_alg_len,
+				      void *pk_ptr, unsigned int pk_len);
+
+	/* Return CRYPTO_IN_PROGRESS while the engine is busy. Once idle,
+	 * return the result of the signature verification, or CRYPTO_SUCCESS
+	 * if all the hash data queued has been processed */
+	int (*poll)(void);
+} crypto_engine_desc_t;
+
 /* Public functions */
 void crypto_mod_init(void);
 int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
@@ -71,6 +123,10 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_verify_hash_start(void *digest_info_ptr,
+				 unsigned int digest_info_len);
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_verify_hash_finish(void);
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
@@ -81,4 +137,18 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 		.verify_hash = _verify_hash \
 	}
 
+/* Macro to register a cryptographic library that can hash incrementally */
+#define REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(_name, _init, _verify_signature, \
+		_verify_hash, _verify_hash_start, _verify_hash_update, \
+		_verify_hash_finish) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.verify_hash_start = _verify_hash_start, \
+		.verify_hash_update = _verify_hash_update, \
+		.verify_hash_finish = _verify_hash_finish \
+	}
+
 #endif /* __CRYPTO_MOD_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -32,5 +32,8 @@
 #define __MBEDTLS_COMMON_H__
 
 void mbedtls_init(void);
+#if MBEDTLS_HEAP_STATS
+void mbedtls_heap_report(void);
+#endif
 
 #endif /* __MBEDTLS_COMMON_H__ */
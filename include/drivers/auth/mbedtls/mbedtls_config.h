@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -73,6 +73,7 @@
 #define MBEDTLS_ECDSA_C
 #define MBEDTLS_ECP_C
 #define MBEDTLS_ECP_DP_SECP256R1_ENABLED
+#define MBEDTLS_ECP_NIST_OPTIM
 #elif (MBEDTLS_KEY_ALG_ID == MBEDTLS_RSA)
 #define MBEDTLS_RSA_C
 #endif
@@ -88,6 +89,13 @@
 #define MBEDTLS_MPI_WINDOW_SIZE              2
 #define MBEDTLS_MPI_MAX_SIZE               256
 
+#if (MBEDTLS_KEY_ALG_ID == MBEDTLS_ECDSA)
+/* ECP options: P-256 only, base point table as wide as the comb allows */
+#define MBEDTLS_ECP_MAX_BITS               256
+#define MBEDTLS_ECP_WINDOW_SIZE              5
+#define MBEDTLS_ECP_FIXED_POINT_OPTIM        1
+#endif
+
 /* Memory buffer allocator options */
 #define MBEDTLS_MEMORY_ALIGN_MULTIPLE        8
 
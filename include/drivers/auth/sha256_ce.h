@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SHA256_CE_H__
+#define __SHA256_CE_H__
+
+#include <stdint.h>
+
+/*
+ * SHA-256 using the instructions of the ARMv8 Cryptographic Extension. The
+ * caller must check that the CPU implements them with sha256_ce_supported()
+ * and must be allowed to access the Advanced SIMD registers.
+ */
+
+#define SHA256_CE_BLOCK_SIZE	64
+#define SHA256_CE_DIGEST_SIZE	32
+
+/* Context of a hash calculated incrementally */
+typedef struct sha256_ce_ctx {
+	uint32_t state[8];
+	uint64_t total_len;
+	unsigned char buf[SHA256_CE_BLOCK_SIZE];
+} sha256_ce_ctx_t;
+
+int sha256_ce_supported(void);
+void sha256_ce_starts(sha256_ce_ctx_t *ctx);
+void sha256_ce_update(sha256_ce_ctx_t *ctx, const unsigned char *data,
+		      unsigned int len);
+void sha256_ce_finish(sha256_ce_ctx_t *ctx,
+		      unsigned char digest[SHA256_CE_DIGEST_SIZE]);
+void sha256_ce(const unsigned char *data, unsigned int len,
+	       unsigned char digest[SHA256_CE_DIGEST_SIZE]);
+
+/* Assembler helper processing 'blocks' consecutive blocks of 'data' */
+void sha256_ce_transform(uint32_t state[8], const unsigned char *data,
+			 unsigned int blocks);
+
+#endif /* __SHA256_CE_H__ */
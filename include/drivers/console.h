@@ -38,6 +38,7 @@ int console_init(uintptr_t base_addr,
 void console_uninit(void);
 int console_putc(int c);
 int console_getc(void);
+int console_putc_nowait(int c);
 
 #endif /* __CONSOLE_H__ */
 
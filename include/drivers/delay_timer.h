@@ -39,6 +39,12 @@
  * function pointer to return the timer value and a clock
  * multiplier/divider. The ratio of the multiplier and the divider is
  * the clock period in microseconds.
+ *
+ * Alternatively, generic_delay_timer.c implements the same delay
+ * functions with the system counter of the Generic Timer, once
+ * generic_delay_timer_init() has been called. It also provides
+ * wait_for_condition(), which polls a register in a low power state
+ * until it reads a given value.
  ********************************************************************/
 
 typedef struct timer_ops {
@@ -47,9 +53,22 @@ typedef struct timer_ops {
 	uint32_t clk_div;
 } timer_ops_t;
 
+/* Statistics of wait_for_condition() */
+typedef struct wait_stats {
+	uint32_t waits;
+	uint32_t timeouts;
+	/* Longest wait, in system counter ticks */
+	uint64_t max_wait_ticks;
+} wait_stats_t;
+
 void mdelay(uint32_t msec);
 void udelay(uint32_t usec);
+void ndelay(uint32_t nsec);
 void timer_init(const timer_ops_t *ops);
+void generic_delay_timer_init(void);
+int wait_for_condition(uintptr_t addr, uint32_t mask, uint32_t value,
+		       uint32_t timeout_us);
+void wait_for_condition_stats(wait_stats_t *stats);
 
 
 #endif /* __DELAY_TIMER_H__ */
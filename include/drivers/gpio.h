@@ -37,17 +37,30 @@
 #define GPIO_LEVEL_LOW		0
 #define GPIO_LEVEL_HIGH		1
 
+/*
+ * The operations on several GPIOs take a mask whose bit N selects the GPIO
+ * 'gpio + N'. The matching bit of the directions or values holds the
+ * GPIO_DIR_* or GPIO_LEVEL_* value of that GPIO. These operations are optional
+ * in a driver, the framework falls back to the operations on a single GPIO.
+ */
 typedef struct gpio_ops {
 	int (*get_direction)(int gpio);
 	void (*set_direction)(int gpio, int direction);
 	int (*get_value)(int gpio);
 	void (*set_value)(int gpio, int value);
+	void (*set_directions)(int gpio, unsigned int mask,
+			       unsigned int directions);
+	unsigned int (*get_values)(int gpio, unsigned int mask);
+	void (*set_values)(int gpio, unsigned int mask, unsigned int values);
 } gpio_ops_t;
 
 int gpio_get_direction(int gpio);
 void gpio_set_direction(int gpio, int direction);
 int gpio_get_value(int gpio);
 void gpio_set_value(int gpio, int value);
+void gpio_set_directions(int gpio, unsigned int mask, unsigned int directions);
+unsigned int gpio_get_values(int gpio, unsigned int mask);
+void gpio_set_values(int gpio, unsigned int mask, unsigned int values);
 void gpio_init(const gpio_ops_t *ops);
 
 #endif	/* __GPIO_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -72,6 +72,16 @@ typedef struct io_dev_funcs {
 	int (*close)(io_entity_t *entity);
 	int (*dev_init)(io_dev_info_t *dev_info, const uintptr_t init_params);
 	int (*dev_close)(io_dev_info_t *dev_info);
+	/* Optional: preferred transfer size for reads from this entity */
+	int (*block_size)(io_entity_t *entity, size_t *block_size);
+	/* Optional: start a read and wait for its completion. A device that
+	 * implements them can transfer the next chunk of an io_read_chunked()
+	 * request (e.g. by DMA) while the caller processes the current one */
+	int (*read_start)(io_entity_t *entity, uintptr_t buffer, size_t length);
+	int (*read_wait)(io_entity_t *entity, size_t *length_read);
+	/* Optional: address at which the data of the entity can be accessed
+	 * directly, for devices that are mapped in memory */
+	int (*address)(io_entity_t *entity, uintptr_t *address);
 } io_dev_funcs_t;
 
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -83,6 +83,15 @@ typedef struct io_block_spec {
 } io_block_spec_t;
 
 
+/* Function called by io_read_chunked() for each chunk of data once it has
+ * been read. A non-zero return value aborts the read. */
+typedef int (*io_chunk_cb_t)(uintptr_t buffer, size_t length, void *arg);
+
+/* Transfer size used by io_read_chunked() for devices that read in the
+ * background without reporting a preferred block size */
+#define IO_DEFAULT_BLOCK_SIZE	(16 * 1024)
+
+
 /* Access modes used when accessing data on a device */
 #define IO_MODE_INVALID (0)
 #define IO_MODE_RO	(1 << 0)
@@ -120,5 +129,18 @@ int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 
 int io_close(uintptr_t handle);
 
+int io_block_size(uintptr_t handle, size_t *block_size);
+
+int io_read_chunked(uintptr_t handle, uintptr_t buffer, size_t length,
+		size_t *length_read, io_chunk_cb_t chunk_cb, void *cb_arg);
+
+int io_address(uintptr_t handle, uintptr_t *address);
+
+
+/* Asynchronous operations */
+int io_read_start(uintptr_t handle, uintptr_t buffer, size_t length);
+
+int io_read_wait(uintptr_t handle, size_t *length_read);
+
 
 #endif /* __IO_H__ */
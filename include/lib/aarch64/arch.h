@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -118,6 +118,10 @@
 /* CSSELR definitions */
 #define LEVEL_SHIFT		1
 
+/* DCZID_EL0 definitions */
+#define DCZID_BS_MASK		0xf
+#define DCZID_DZP_BIT		(1 << 4)
+
 /* D$ set/way op type defines */
 #define DCISW			0x0
 #define DCCISW			0x1
@@ -134,6 +138,19 @@
 #define ID_AA64PFR0_GIC_WIDTH	4
 #define ID_AA64PFR0_GIC_MASK	((1 << ID_AA64PFR0_GIC_WIDTH) - 1)
 
+/* ID_AA64ISAR0_EL1 definitions */
+#define ID_AA64ISAR0_SHA2_SHIFT		12
+#define ID_AA64ISAR0_SHA2_MASK		0xf
+
+/* ID_AA64MMFR0_EL1 definitions */
+#define ID_AA64MMFR0_TGRAN16_SHIFT	20
+#define ID_AA64MMFR0_TGRAN64_SHIFT	24
+#define ID_AA64MMFR0_TGRAN4_SHIFT	28
+#define ID_AA64MMFR0_TGRAN_MASK		0xf
+#define ID_AA64MMFR0_TGRAN4_SUPPORTED	0x0
+#define ID_AA64MMFR0_TGRAN16_SUPPORTED	0x1
+#define ID_AA64MMFR0_TGRAN64_SUPPORTED	0x0
+
 /* ID_PFR1_EL1 definitions */
 #define ID_PFR1_VIRTEXT_SHIFT	12
 #define ID_PFR1_VIRTEXT_MASK	0xf
@@ -211,6 +228,29 @@
 #define TTA_BIT			(1 << 20)
 #define TFP_BIT			(1 << 10)
 
+/* MDCR_EL3 definitions */
+#define MDCR_SPME_BIT		(1 << 17)
+
+/* PMCR_EL0 definitions */
+#define PMCR_EL0_N_SHIFT	11
+#define PMCR_EL0_N_MASK		0x1f
+#define PMCR_EL0_LC_BIT		(1 << 6)
+#define PMCR_EL0_C_BIT		(1 << 2)
+#define PMCR_EL0_P_BIT		(1 << 1)
+#define PMCR_EL0_E_BIT		(1 << 0)
+
+/* PMCNTENSET_EL0 definitions */
+#define PMCNTENSET_C_BIT	(1 << 31)
+
+/* PMCCFILTR_EL0 and PMEVTYPER<n>_EL0 definitions */
+#define PMEVTYPER_P_BIT		(1 << 31)
+#define PMEVTYPER_U_BIT		(1 << 30)
+#define PMEVTYPER_NSK_BIT	(1 << 29)
+#define PMEVTYPER_NSU_BIT	(1 << 28)
+#define PMEVTYPER_NSH_BIT	(1 << 27)
+#define PMEVTYPER_M_BIT		(1 << 26)
+#define PMEVTYPER_EVTCOUNT_MASK	0x3ff
+
 /* CPSR/SPSR definitions */
 #define DAIF_FIQ_BIT		(1 << 0)
 #define DAIF_IRQ_BIT		(1 << 1)
@@ -272,6 +312,11 @@
 #define TCR_SH_OUTER_SHAREABLE	(0x2 << 12)
 #define TCR_SH_INNER_SHAREABLE	(0x3 << 12)
 
+#define TCR_TG0_SHIFT		14
+#define TCR_TG0_4K		(0x0 << TCR_TG0_SHIFT)
+#define TCR_TG0_64K		(0x1 << TCR_TG0_SHIFT)
+#define TCR_TG0_16K		(0x2 << TCR_TG0_SHIFT)
+
 #define MODE_SP_SHIFT		0x0
 #define MODE_SP_MASK		0x1
 #define MODE_SP_EL0		0x0
@@ -367,6 +412,8 @@
 #define TWO_MB_SHIFT		21
 #define ONE_GB_SHIFT		30
 #define FOUR_KB_SHIFT		12
+#define SIXTEEN_KB_SHIFT	14
+#define SIXTY_FOUR_KB_SHIFT	16
 
 #define ONE_GB_INDEX(x)		((x) >> ONE_GB_SHIFT)
 #define TWO_MB_INDEX(x)		((x) >> TWO_MB_SHIFT)
@@ -375,6 +422,9 @@
 #define INVALID_DESC		0x0
 #define BLOCK_DESC		0x1
 #define TABLE_DESC		0x3
+#define DESC_MASK		0x3
+
+#define TABLE_ADDR_MASK		0x0000FFFFFFFFF000ul
 
 #define FIRST_LEVEL_DESC_N	ONE_GB_SHIFT
 #define SECOND_LEVEL_DESC_N	TWO_MB_SHIFT
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -103,10 +103,43 @@ void mmap_add_region(unsigned long base_pa, unsigned long base_va,
 				unsigned long size, unsigned attr);
 void mmap_add(const mmap_region_t *mm);
 
+/*
+ * Map and unmap a region at runtime, once the translation tables are in use.
+ * Only available when PLAT_XLAT_TABLES_DYNAMIC is set. The region must not
+ * overlap any region already mapped, and the callers must ensure that no two
+ * calls run concurrently.
+ */
+int mmap_add_dynamic_region(unsigned long base_pa, unsigned long base_va,
+				unsigned long size, unsigned attr);
+int mmap_remove_dynamic_region(unsigned long base_va, unsigned long size);
+
+/*
+ * Change the attributes of an area mapped by init_xlat_tables(), which must not
+ * straddle the boundary of any region, once the translation tables are in use.
+ * Only available when PLAT_XLAT_TABLES_DYNAMIC is set. The area must not be
+ * accessed while it is remapped. The attributes recorded for the regions are
+ * left unchanged, they only serve to check the overlaps of dynamic regions.
+ */
+int mmap_remap_region(unsigned long base_va, unsigned long size,
+				unsigned attr);
+
 void init_xlat_tables(void);
 
 void enable_mmu_el1(uint32_t flags);
 void enable_mmu_el3(uint32_t flags);
 
+/*
+ * Early translation tables of BL1 and BL2, generated at build time from the
+ * regions in PLAT_XLAT_EARLY_MMAP when XLAT_EARLY_MMU is set. The image installs
+ * them at its entry point with xlat_early_enable_el<x>(), before any C code
+ * runs, and enable_mmu_el<x>() replaces them with xlat_early_switch_el<x>().
+ */
+void xlat_early_enable_el1(void);
+void xlat_early_enable_el3(void);
+void xlat_early_switch_el1(uint64_t ttbr, uint64_t tcr, uint64_t mair,
+				uint64_t sctlr);
+void xlat_early_switch_el3(uint64_t ttbr, uint64_t tcr, uint64_t mair,
+				uint64_t sctlr);
+
 #endif /*__ASSEMBLY__*/
 #endif /* __XLAT_TABLES_H__ */
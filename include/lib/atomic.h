@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ATOMIC_H__
+#define __ATOMIC_H__
+
+#include <stdint.h>
+
+/*
+ * Atomic read-modify-write operations on 32-bit and 64-bit memory locations.
+ * They return the value of the location before the operation and order the
+ * memory accesses around them like an acquire and a release would.
+ *
+ * When USE_LSE_ATOMICS is set, they are implemented with the ARMv8.1 Large
+ * System Extension instructions, which the interconnect can perform near the
+ * memory. Otherwise, exclusive access loops are used. In both cases, the
+ * memory location must be in cacheable Normal memory and the data cache must
+ * be enabled.
+ */
+#if USE_LSE_ATOMICS
+
+#define DEFINE_ATOMIC_FETCH_ADD(_name, _type, _r)			\
+static inline _type _name(volatile _type *ptr, _type val)		\
+{									\
+	_type old;							\
+	__asm__ volatile ("ldaddal %" _r "2, %" _r "0, %1"		\
+			  : "=r" (old), "+Q" (*ptr)			\
+			  : "r" (val)					\
+			  : "memory");					\
+	return old;							\
+}
+
+#define DEFINE_ATOMIC_SWAP(_name, _type, _r)				\
+static inline _type _name(volatile _type *ptr, _type val)		\
+{									\
+	_type old;							\
+	__asm__ volatile ("swpal %" _r "2, %" _r "0, %1"		\
+			  : "=r" (old), "+Q" (*ptr)			\
+			  : "r" (val)					\
+			  : "memory");					\
+	return old;							\
+}
+
+#define DEFINE_ATOMIC_CMPXCHG(_name, _type, _r)				\
+static inline _type _name(volatile _type *ptr, _type expected, _type val)\
+{									\
+	_type old = expected;						\
+	__asm__ volatile ("casal %" _r "0, %" _r "2, %1"		\
+			  : "+r" (old), "+Q" (*ptr)			\
+			  : "r" (val)					\
+			  : "memory");					\
+	return old;							\
+}
+
+#else
+
+#define DEFINE_ATOMIC_FETCH_ADD(_name, _type, _r)			\
+static inline _type _name(volatile _type *ptr, _type val)		\
+{									\
+	_type old, new;							\
+	unsigned int fail;						\
+	__asm__ volatile ("1:	ldaxr	%" _r "0, %3\n"			\
+			  "	add	%" _r "1, %" _r "0, %" _r "4\n"	\
+			  "	stlxr	%w2, %" _r "1, %3\n"		\
+			  "	cbnz	%w2, 1b"			\
+			  : "=&r" (old), "=&r" (new), "=&r" (fail),	\
+			    "+Q" (*ptr)					\
+			  : "r" (val)					\
+			  : "memory");					\
+	return old;							\
+}
+
+#define DEFINE_ATOMIC_SWAP(_name, _type, _r)				\
+static inline _type _name(volatile _type *ptr, _type val)		\
+{									\
+	_type old;							\
+	unsigned int fail;						\
+	__asm__ volatile ("1:	ldaxr	%" _r "0, %2\n"			\
+			  "	stlxr	%w1, %" _r "3, %2\n"		\
+			  "	cbnz	%w1, 1b"			\
+			  : "=&r" (old), "=&r" (fail), "+Q" (*ptr)	\
+			  : "r" (val)					\
+			  : "memory");					\
+	return old;							\
+}
+
+#define DEFINE_ATOMIC_CMPXCHG(_name, _type, _r)				\
+static inline _type _name(volatile _type *ptr, _type expected, _type val)\
+{									\
+	_type old;							\
+	unsigned int fail;						\
+	__asm__ volatile ("1:	ldaxr	%" _r "0, %2\n"			\
+			  "	cmp	%" _r "0, %" _r "3\n"		\
+			  "	b.ne	2f\n"				\
+			  "	stlxr	%w1, %" _r "4, %2\n"		\
+			  "	cbnz	%w1, 1b\n"			\
+			  "2:"						\
+			  : "=&r" (old), "=&r" (fail), "+Q" (*ptr)	\
+			  : "r" (expected), "r" (val)			\
+			  : "cc", "memory");				\
+	return old;							\
+}
+
+#endif /* USE_LSE_ATOMICS */
+
+DEFINE_ATOMIC_FETCH_ADD(atomic_fetch_add_32, uint32_t, "w")
+DEFINE_ATOMIC_FETCH_ADD(atomic_fetch_add_64, uint64_t, "x")
+DEFINE_ATOMIC_SWAP(atomic_swap_32, uint32_t, "w")
+DEFINE_ATOMIC_SWAP(atomic_swap_64, uint64_t, "x")
+DEFINE_ATOMIC_CMPXCHG(atomic_cmpxchg_32, uint32_t, "w")
+DEFINE_ATOMIC_CMPXCHG(atomic_cmpxchg_64, uint64_t, "x")
+
+#endif /* __ATOMIC_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -36,6 +36,7 @@
 #define BAKERY_LOCK_MAX_CPUS		PLATFORM_CORE_COUNT
 
 #ifndef __ASSEMBLY__
+#include <lock_profile.h>
 #include <stdint.h>
 
 /*****************************************************************************
@@ -70,6 +71,10 @@ typedef struct bakery_lock {
 	 * Bits[1 - 15] : number. This is the bakery number allocated.
 	 */
 	volatile uint16_t lock_data[BAKERY_LOCK_MAX_CPUS];
+#if ENABLE_LOCK_PROFILING
+	/* Contention profile of each CPU for this lock */
+	lock_profile_t profile[BAKERY_LOCK_MAX_CPUS];
+#endif
 } bakery_lock_t;
 
 #else
@@ -90,6 +95,10 @@ typedef struct bakery_info {
 	 * Bits[1 - 15] : number. This is the bakery number allocated.
 	 */
 	volatile uint16_t lock_data;
+#if ENABLE_LOCK_PROFILING
+	/* Contention profile of this CPU for this lock */
+	lock_profile_t profile;
+#endif
 } bakery_info_t;
 
 typedef bakery_info_t bakery_lock_t;
@@ -99,6 +108,10 @@ typedef bakery_info_t bakery_lock_t;
 inline void bakery_lock_init(bakery_lock_t *bakery) {}
 void bakery_lock_get(bakery_lock_t *bakery);
 void bakery_lock_release(bakery_lock_t *bakery);
+#if ENABLE_LOCK_PROFILING
+bakery_lock_t *bakery_lock_read_profile(unsigned int lock_idx,
+					lock_profile_t *profile);
+#endif
 
 #define DEFINE_BAKERY_LOCK(_name) bakery_lock_t _name __section("bakery_lock")
 
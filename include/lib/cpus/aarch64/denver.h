@@ -37,4 +37,18 @@
 /* CPU state ids - implementation defined */
 #define DENVER_CPU_STATE_POWER_DOWN	0x3
 
+/*
+ * Offsets of the system counter ticks recorded by each CPU when
+ * DENVER_DCO_STATS is set: the time taken to make the DCO quiescent on the
+ * last core power down, and to enable it again on the last reset.
+ */
+#define DENVER_DCO_STATS_QUIESCE	0x0
+#define DENVER_DCO_STATS_ENABLE		0x8
+
+#ifndef __ASSEMBLY__
+#include <stdint.h>
+
+uint64_t denver_get_dco_ticks(unsigned int cpu_idx, unsigned int offset);
+#endif
+
 #endif /* __DENVER_H__ */
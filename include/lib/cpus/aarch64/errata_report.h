@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ERRATA_REPORT_H__
+#define __ERRATA_REPORT_H__
+
+/*******************************************************************************
+ * Errata report of BL31 (REPORT_ERRATA). The errata of the cpus are declared
+ * with declare_cpu_erratum alongside their cpu_ops. The status of each erratum
+ * on a cpu is derived from the revision of the cpu and the build flag of its
+ * workaround, which are also what the cpu_ops reset function goes by. The
+ * duration of the reset handler is measured on every cold and warm boot of
+ * BL31 on each cpu.
+ ******************************************************************************/
+
+/* Status of an erratum on a cpu */
+#define ERRATA_NOT_NEEDED	0	/* The revision of the cpu is not affected */
+#define ERRATA_APPLIED		1	/* The workaround is applied at reset */
+#define ERRATA_MISSING		2	/* The workaround is not built in */
+
+#ifndef __ASSEMBLY__
+
+#include <cdefs.h>
+#include <platform_def.h>
+#include <stdint.h>
+
+/* Erratum declared by declare_cpu_erratum */
+typedef struct cpu_erratum {
+	uint64_t midr;
+	const char *cpu_name;
+	uint32_t id;
+	uint8_t min_rev;
+	uint8_t max_rev;
+	uint8_t enabled;
+	uint8_t reserved;
+} cpu_erratum_t;
+
+/*
+ * Timestamps of the reset handler of a cpu. They are written by the cpu with
+ * its MMU disabled, so each cpu has its own cache writeback granule.
+ */
+typedef struct cpu_reset_time {
+	uint64_t start;
+	uint64_t ret_addr;
+	uint64_t ticks;
+} __aligned(CACHE_WRITEBACK_GRANULE) cpu_reset_time_t;
+
+void errata_report_record(void);
+int errata_report_read(unsigned int cpu_idx,
+		       unsigned int index,
+		       unsigned int *id,
+		       unsigned int *status,
+		       uint64_t *reset_ticks,
+		       unsigned int *num_errata);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __ERRATA_REPORT_H__ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LOCK_PROFILE_H__
+#define __LOCK_PROFILE_H__
+
+#ifndef __ASSEMBLY__
+#include <arch_helpers.h>
+#include <stdint.h>
+
+/*
+ * Contention profile of a lock, recorded when ENABLE_LOCK_PROFILING is set.
+ * An acquisition is contended when the lock was held by another CPU. Wait
+ * times are in system counter ticks, from the call to the lock acquisition
+ * function until the lock is acquired.
+ */
+typedef struct lock_profile {
+	uint64_t acquire_count;
+	uint64_t contended_count;
+	uint64_t wait_ticks;
+	uint64_t max_wait_ticks;
+} lock_profile_t;
+
+/* Accounts an acquisition started at system counter value 'start' */
+static inline void lock_profile_update(lock_profile_t *profile,
+				       uint64_t start,
+				       unsigned int contended)
+{
+	uint64_t wait = read_cntpct_el0() - start;
+
+	profile->acquire_count++;
+	if (contended)
+		profile->contended_count++;
+	profile->wait_ticks += wait;
+	if (wait > profile->max_wait_ticks)
+		profile->max_wait_ticks = wait;
+}
+
+/* Adds the profile 'from' to 'to', e.g. to sum up the profiles of each CPU */
+static inline void lock_profile_add(lock_profile_t *to,
+				    const lock_profile_t *from)
+{
+	to->acquire_count += from->acquire_count;
+	to->contended_count += from->contended_count;
+	to->wait_ticks += from->wait_ticks;
+	if (from->max_wait_ticks > to->max_wait_ticks)
+		to->max_wait_ticks = from->max_wait_ticks;
+}
+
+#endif /* __ASSEMBLY__ */
+#endif /* __LOCK_PROFILE_H__ */
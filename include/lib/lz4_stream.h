@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LZ4_STREAM_H__
+#define __LZ4_STREAM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Incremental decoder for the LZ4 block format. The compressed data can be
+ * fed in pieces of any size, and the output is produced in place in a single
+ * contiguous buffer, which also serves as the history window of the matches.
+ */
+typedef struct lz4_stream {
+	uintptr_t out_base;	/* Start of the output buffer */
+	size_t out_size;	/* Size of the decompressed data */
+	size_t out_pos;		/* Number of bytes decompressed so far */
+	size_t length;		/* Bytes left in the current literal run/match */
+	size_t offset;		/* Distance of the current match */
+	unsigned int token;	/* Token of the current sequence */
+	unsigned int state;
+} lz4_stream_t;
+
+void lz4_stream_init(lz4_stream_t *stream, uintptr_t out_base,
+		     size_t out_size);
+int lz4_stream_decode(lz4_stream_t *stream, const uint8_t *in, size_t in_len,
+		      size_t *in_used, size_t out_limit);
+
+#endif /* __LZ4_STREAM_H__ */
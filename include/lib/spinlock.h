@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -31,11 +31,37 @@
 #ifndef __SPINLOCK_H__
 #define __SPINLOCK_H__
 
+#if ENABLE_LOCK_PROFILING
+#include <arch_helpers.h>
+#include <lock_profile.h>
+#endif
+
 typedef struct spinlock {
 	volatile unsigned int lock;
+#if ENABLE_LOCK_PROFILING
+	/* Only updated by the owner of the lock, while it holds it */
+	lock_profile_t profile;
+#endif
 } spinlock_t;
 
-void spin_lock(spinlock_t *lock);
+int spin_trylock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
 
+#if ENABLE_LOCK_PROFILING
+static inline void spin_lock(spinlock_t *lock)
+{
+	uint64_t start = read_cntpct_el0();
+	unsigned int contended = 0;
+
+	while (!spin_trylock(lock)) {
+		contended = 1;
+		wfe();
+	}
+
+	lock_profile_update(&lock->profile, start, contended);
+}
+#else
+void spin_lock(spinlock_t *lock);
+#endif
+
 #endif /* __SPINLOCK_H__ */
@@ -75,7 +75,12 @@
  */
 #if IMAGE_BL31 || IMAGE_BL32
 # define PLAT_ARM_MMAP_ENTRIES		6
-# define MAX_XLAT_TABLES		4
+# if RESET_TO_BL31_VERIFY && IMAGE_BL31
+/* Up to 2 more tables for each of the preloaded images mapped by BL31 */
+#  define MAX_XLAT_TABLES		(8 + ARM_COLD_XLAT_TABLES)
+# else
+#  define MAX_XLAT_TABLES		(4 + ARM_COLD_XLAT_TABLES)
+# endif
 #else
 # define PLAT_ARM_MMAP_ENTRIES		10
 # define MAX_XLAT_TABLES		5
@@ -93,6 +98,8 @@
 
 #define PLAT_ARM_NVM_BASE		V2M_FLASH0_BASE
 #define PLAT_ARM_NVM_SIZE		V2M_FLASH0_SIZE
+/* Erase block of the NOR flash, with its two banks accessed in parallel */
+#define PLAT_ARM_NVM_BLOCK_SIZE		0x00040000	/* 256 KB */
 
 
 #endif /* __BOARD_ARM_DEF_H__ */
@@ -70,6 +70,12 @@
 
 #define PLAT_ARM_DRAM2_SIZE			MAKE_ULL(0x180000000)
 
+/* Regions of the platform mapped by BL31 */
+#define BOARD_CSS_BL31_MMAP			ARM_MAP_SHARED_RAM,	\
+						V2M_MAP_IOFPGA,		\
+						CSS_MAP_DEVICE,		\
+						SOC_CSS_MAP_DEVICE
+
 /* UART related constants */
 #define PLAT_ARM_BOOT_UART_BASE			SOC_CSS_UART0_BASE
 #define PLAT_ARM_BOOT_UART_CLK_IN_HZ		SOC_CSS_UART0_CLK_IN_HZ
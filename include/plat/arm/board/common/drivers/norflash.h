@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -43,10 +43,23 @@
 #define NOR_CMD_WORD_PROGRAM		0x40
 #define NOR_CMD_BLOCK_ERASE		0x20
 #define NOR_CMD_LOCK_UNLOCK		0x60
+#define NOR_CMD_SUSPEND			0xB0
 
 /* Second bus cycle */
 #define NOR_LOCK_BLOCK			0x01
 #define NOR_UNLOCK_BLOCK		0xD0
+#define NOR_BLOCK_ERASE_CONFIRM		0xD0
+#define NOR_CMD_RESUME			0xD0
+
+/* Last bus cycle of a write to buffer */
+#define NOR_BUFFER_PROGRAM_CONFIRM	0xD0
+
+/*
+ * Size of the write buffer, in 32-bit words of the two flash banks accessed in
+ * parallel. A buffered program does not cross a buffer aligned boundary.
+ */
+#define NOR_BUFFER_WORDS		32
+#define NOR_BUFFER_SIZE			(NOR_BUFFER_WORDS * sizeof(uint32_t))
 
 /* Status register bits */
 #define NOR_DWS				(1 << 7)
@@ -61,6 +74,13 @@
 /* Public API */
 void nor_send_cmd(uintptr_t base_addr, unsigned long cmd);
 int nor_word_program(uintptr_t base_addr, unsigned long data);
+int nor_buffer_program(uintptr_t base_addr, const uint32_t *data,
+		       unsigned int num_words);
+int nor_erase(uintptr_t base_addr);
+void nor_erase_start(uintptr_t base_addr);
+int nor_erase_poll(uintptr_t base_addr);
+int nor_erase_suspend(uintptr_t base_addr);
+void nor_erase_resume(uintptr_t base_addr);
 void nor_lock(uintptr_t base_addr);
 void nor_unlock(uintptr_t base_addr);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -127,6 +127,21 @@
 						V2M_FLASH0_SIZE,	\
 						MT_MEMORY | MT_RO | MT_SECURE)
 
+/*
+ * Split mapping of the flash: the first page stays writable Device memory so
+ * that commands can still be sent to the flash, the rest is read through the
+ * caches.
+ */
+#define V2M_FLASH0_CMD_SIZE		0x00001000
+#define V2M_MAP_FLASH0_CMD		MAP_REGION_FLAT(V2M_FLASH0_BASE,\
+						V2M_FLASH0_CMD_SIZE,	\
+						MT_DEVICE | MT_RW | MT_SECURE)
+
+#define V2M_MAP_FLASH0_DATA_RO		MAP_REGION_FLAT(		\
+					V2M_FLASH0_BASE + V2M_FLASH0_CMD_SIZE,\
+					V2M_FLASH0_SIZE - V2M_FLASH0_CMD_SIZE,\
+					MT_MEMORY | MT_RO | MT_SECURE)
+
 #define V2M_MAP_IOFPGA			MAP_REGION_FLAT(V2M_IOFPGA_BASE,\
 						V2M_IOFPGA_SIZE,		\
 						MT_DEVICE | MT_RW | MT_SECURE)
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARM_BOOT_TS_H__
+#define __ARM_BOOT_TS_H__
+
+#include <arm_def.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Boot-path timestamps of the ARM standard platforms (ARM_BOOT_TIMESTAMPS).
+ * Each BL stage appends markers, stamped with the physical count of the system
+ * counter, to a table at the top of the shared trusted SRAM. The table is
+ * initialised by the first BL stage to run on the cold boot path and survives
+ * the successive handoffs. The normal world reads it back through the
+ * ARM_SIP_BOOT_TS_READ SiP call.
+ *
+ * When LOAD_IMAGE_STATS is also set, BL2 appends the loading statistics of
+ * each image it has read before it exits. These records hold a value instead
+ * of a timestamp.
+ ******************************************************************************/
+
+/* Markers of the boot path. Image markers hold the image ID as argument. */
+#define ARM_BOOT_TS_BL1_ENTRY		0x01
+#define ARM_BOOT_TS_BL1_IO_SETUP	0x02
+#define ARM_BOOT_TS_BL1_EXIT		0x03
+#define ARM_BOOT_TS_BL2_ENTRY		0x11
+#define ARM_BOOT_TS_BL2_IO_SETUP	0x12
+#define ARM_BOOT_TS_IMAGE_LOADED	0x13
+#define ARM_BOOT_TS_BL2_EXIT		0x14
+#define ARM_BOOT_TS_BL31_ENTRY		0x21
+#define ARM_BOOT_TS_BL31_EXIT		0x22
+
+/*
+ * Records of the loading statistics of an image, with the image ID as argument:
+ * the number of bytes read and the system counter ticks spent reading it (bits
+ * [31:0]) and authenticating it (bits [63:32]), saturated to 32 bits.
+ */
+#define ARM_BOOT_TS_IMAGE_BYTES		0x31
+#define ARM_BOOT_TS_IMAGE_TICKS		0x32
+
+#define ARM_BOOT_TS_MAGIC		0x53544f42	/* "BOTS" */
+#define ARM_BOOT_TS_MAX_RECS		60
+
+/* Location of the table, at the top of the shared trusted SRAM */
+#define ARM_BOOT_TS_TABLE_SIZE		0x400
+#define ARM_BOOT_TS_TABLE_BASE		(ARM_SHARED_RAM_BASE +		\
+					 ARM_SHARED_RAM_SIZE -		\
+					 ARM_BOOT_TS_TABLE_SIZE)
+
+#ifndef __ASSEMBLY__
+
+typedef struct arm_boot_ts_rec {
+	uint32_t id;
+	uint32_t arg;
+	/* System counter physical count, or value of a statistics record */
+	uint64_t timestamp;
+} arm_boot_ts_rec_t;
+
+typedef struct arm_boot_ts_table {
+	uint32_t magic;
+	uint32_t num_recs;
+	uint64_t reserved;
+	arm_boot_ts_rec_t recs[ARM_BOOT_TS_MAX_RECS];
+} arm_boot_ts_table_t;
+
+#if ARM_BOOT_TIMESTAMPS
+void arm_boot_ts_init(void);
+void arm_boot_ts_mark(unsigned int id, unsigned int arg);
+int arm_boot_ts_read(unsigned int index, arm_boot_ts_rec_t *rec,
+		     unsigned int *num_recs);
+#else
+static inline void arm_boot_ts_init(void)
+{
+}
+
+static inline void arm_boot_ts_mark(unsigned int id, unsigned int arg)
+{
+}
+#endif
+
+#if ARM_BOOT_TIMESTAMPS && LOAD_IMAGE_STATS && IMAGE_BL2
+void arm_boot_ts_load_stats(void);
+#else
+static inline void arm_boot_ts_load_stats(void)
+{
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __ARM_BOOT_TS_H__ */
@@ -78,6 +78,15 @@
 #define ARM_SHARED_RAM_BASE		ARM_TRUSTED_SRAM_BASE
 #define ARM_SHARED_RAM_SIZE		0x00001000	/* 4 KB */
 
+/*
+ * Manifest of the images reused across a warm reboot (FAST_WARM_REBOOT), in the
+ * shared memory below the 1KB table of boot timestamps
+ */
+#define ARM_WARM_REBOOT_MANIFEST_SIZE	0x200
+#define ARM_WARM_REBOOT_MANIFEST_BASE	(ARM_SHARED_RAM_BASE +		\
+					 ARM_SHARED_RAM_SIZE - 0x400 -	\
+					 ARM_WARM_REBOOT_MANIFEST_SIZE)
+
 /* The remaining Trusted SRAM is used to load the BL images */
 #define ARM_BL_RAM_BASE			(ARM_SHARED_RAM_BASE +	\
 					 ARM_SHARED_RAM_SIZE)
@@ -139,6 +148,19 @@
  * terminology. On a GICv2 system or mode, the lists will be merged and treated
  * as Group 0 interrupts.
  */
+#if EL3_TIMER_SERVICE
+/* The secure physical timer is owned by the EL3 timer service */
+#define ARM_G1S_IRQS			ARM_IRQ_SEC_SGI_1,		\
+					ARM_IRQ_SEC_SGI_2,		\
+					ARM_IRQ_SEC_SGI_3,		\
+					ARM_IRQ_SEC_SGI_4,		\
+					ARM_IRQ_SEC_SGI_5,		\
+					ARM_IRQ_SEC_SGI_7
+
+#define ARM_G0_IRQS			ARM_IRQ_SEC_PHY_TIMER,		\
+					ARM_IRQ_SEC_SGI_0,		\
+					ARM_IRQ_SEC_SGI_6
+#else
 #define ARM_G1S_IRQS			ARM_IRQ_SEC_PHY_TIMER,		\
 					ARM_IRQ_SEC_SGI_1,		\
 					ARM_IRQ_SEC_SGI_2,		\
@@ -149,6 +171,7 @@
 
 #define ARM_G0_IRQS			ARM_IRQ_SEC_SGI_0,		\
 					ARM_IRQ_SEC_SGI_6
+#endif
 
 #define ARM_MAP_SHARED_RAM		MAP_REGION_FLAT(		\
 						ARM_SHARED_RAM_BASE,	\
@@ -160,11 +183,42 @@
 						ARM_NS_DRAM1_SIZE,	\
 						MT_MEMORY | MT_RW | MT_NS)
 
+/*
+ * BL1 only reads the normal world buffers passed to the FWU SMCs, and
+ * authenticates non-secure images in place, so it maps them read-only
+ */
+#define ARM_MAP_NS_DRAM1_RO		MAP_REGION_FLAT(		\
+						ARM_NS_DRAM1_BASE,	\
+						ARM_NS_DRAM1_SIZE,	\
+						MT_MEMORY | MT_RO | MT_NS)
+
 #define ARM_MAP_TSP_SEC_MEM		MAP_REGION_FLAT(		\
 						TSP_SEC_MEM_BASE,	\
 						TSP_SEC_MEM_SIZE,	\
 						MT_MEMORY | MT_RW | MT_SECURE)
 
+/*
+ * Regions of the early translation tables of BL1 and BL2 (XLAT_EARLY_MMU),
+ * to which the platforms add the devices used before the MMU is configured.
+ * BL1 also executes from the Trusted ROM.
+ */
+#define ARM_MAP_EARLY_BL_RAM		MAP_REGION_FLAT(		\
+						ARM_BL_RAM_BASE,	\
+						ARM_BL_RAM_SIZE,	\
+						MT_MEMORY | MT_RW | MT_SECURE)
+
+#if IMAGE_BL1
+#define ARM_XLAT_EARLY_MMAP		MAP_REGION_FLAT(		\
+						PLAT_ARM_TRUSTED_ROM_BASE, \
+						PLAT_ARM_TRUSTED_ROM_SIZE, \
+						MT_MEMORY | MT_RO | MT_SECURE), \
+					ARM_MAP_SHARED_RAM,		\
+					ARM_MAP_EARLY_BL_RAM
+#else
+#define ARM_XLAT_EARLY_MMAP		ARM_MAP_SHARED_RAM,		\
+					ARM_MAP_EARLY_BL_RAM
+#endif
+
 #if ARM_BL31_IN_DRAM
 #define ARM_MAP_BL31_SEC_DRAM		MAP_REGION_FLAT(		\
 						BL31_BASE,		\
@@ -182,8 +236,29 @@
 #define ARM_BL_REGIONS			2
 #endif
 
+/* BL31 maps the preloaded BL33 and BL32 images to verify them */
+#if RESET_TO_BL31_VERIFY && IMAGE_BL31
+#define ARM_VERIFY_REGIONS		2
+#else
+#define ARM_VERIFY_REGIONS		0
+#endif
+
+/*
+ * BL31 maps its cold region, which needs up to 2 more translation tables as
+ * it is in DRAM
+ */
+#if BL31_SPLIT_COLD && IMAGE_BL31
+#define ARM_COLD_REGIONS		1
+#define ARM_COLD_XLAT_TABLES		2
+#else
+#define ARM_COLD_REGIONS		0
+#define ARM_COLD_XLAT_TABLES		0
+#endif
+
 #define MAX_MMAP_REGIONS		(PLAT_ARM_MMAP_ENTRIES +	\
-					 ARM_BL_REGIONS)
+					 ARM_BL_REGIONS +		\
+					 ARM_VERIFY_REGIONS +		\
+					 ARM_COLD_REGIONS)
 
 /* Memory mapped Generic timer interfaces  */
 #define ARM_SYS_CNTCTL_BASE		0x2a430000
@@ -219,6 +294,13 @@
  */
 #define PLAT_MAX_OFF_STATE		ARM_LOCAL_STATE_OFF
 
+/*
+ * This macro defines the predicted residency, in microseconds, below which a
+ * power domain entering a power down state through CPU_SUSPEND is kept in
+ * retention instead when PSCI_RESIDENCY_PREDICTOR is set.
+ */
+#define PLAT_MIN_OFF_RESIDENCY_US	2500
+
 /*
  * Some data must be aligned on the biggest cache line size in the platform.
  * This is known only to the platform as it might have a combination of
@@ -282,6 +364,62 @@
 #define BL31_LIMIT			(ARM_BL_RAM_BASE + ARM_BL_RAM_SIZE)
 #endif
 
+#if BL31_SPLIT_COLD
+/*
+ * Put the cold region of BL31 at the bottom of TZC secured DRAM
+ */
+#define BL31_COLD_BASE			ARM_AP_TZC_DRAM1_BASE
+#define BL31_COLD_LIMIT			(ARM_AP_TZC_DRAM1_BASE +	\
+						PLAT_ARM_MAX_BL31_COLD_SIZE)
+#define ARM_BL31_COLD_SIZE		PLAT_ARM_MAX_BL31_COLD_SIZE
+#else
+#define ARM_BL31_COLD_SIZE		0
+#endif
+
+/*
+ * Regions of BL31 itself in the translation tables generated at build time
+ * (BL31_PREBUILT_XLAT), as mapped by arm_bl31_plat_arch_setup(). The platforms
+ * add their own regions of BL31 to them.
+ */
+#define ARM_MAP_BL31_TOTAL		MAP_REGION_FLAT(		\
+					XLAT_SYM(__RO_START__),		\
+					XLAT_SYM(__BL31_END__) -	\
+						XLAT_SYM(__RO_START__),	\
+					MT_MEMORY | MT_RW | MT_SECURE)
+#define ARM_MAP_BL31_RO			MAP_REGION_FLAT(		\
+					XLAT_SYM(__RO_START__),		\
+					XLAT_SYM(__RO_END__) -		\
+						XLAT_SYM(__RO_START__),	\
+					MT_MEMORY | MT_RO | MT_SECURE)
+#if USE_COHERENT_MEM
+#define ARM_MAP_BL31_COHERENT		, MAP_REGION_FLAT(		\
+					XLAT_SYM(__COHERENT_RAM_START__), \
+					XLAT_SYM(__COHERENT_RAM_END__) - \
+					XLAT_SYM(__COHERENT_RAM_START__), \
+					MT_DEVICE | MT_RW | MT_SECURE)
+#else
+#define ARM_MAP_BL31_COHERENT
+#endif
+#if BL31_SPLIT_COLD
+#define ARM_MAP_BL31_COLD		, MAP_REGION_FLAT(		\
+					BL31_COLD_BASE,			\
+					BL31_COLD_LIMIT - BL31_COLD_BASE, \
+					MT_MEMORY | MT_RO | MT_SECURE)
+#else
+#define ARM_MAP_BL31_COLD
+#endif
+
+#define ARM_BL31_PREBUILT_MMAP		ARM_MAP_BL31_TOTAL,		\
+					ARM_MAP_BL31_RO			\
+					ARM_MAP_BL31_COHERENT		\
+					ARM_MAP_BL31_COLD
+
+/*
+ * The per-cpu data of BL31 holds the base address of the GICv3 Redistributor
+ * frame of each CPU (see plat/arm/common/arm_gicv3.c).
+ */
+#define PLAT_PCPU_DATA_SIZE		8
+
 /*******************************************************************************
  * BL32 specific defines.
  ******************************************************************************/
@@ -312,9 +450,12 @@
 # define BL32_LIMIT			(PLAT_ARM_TRUSTED_DRAM_BASE	\
 						+ (1 << 21))
 #elif ARM_TSP_RAM_LOCATION_ID == ARM_DRAM_ID
-# define TSP_SEC_MEM_BASE		ARM_AP_TZC_DRAM1_BASE
-# define TSP_SEC_MEM_SIZE		ARM_AP_TZC_DRAM1_SIZE
-# define BL32_BASE			ARM_AP_TZC_DRAM1_BASE
+# define TSP_SEC_MEM_BASE		(ARM_AP_TZC_DRAM1_BASE +	\
+						ARM_BL31_COLD_SIZE)
+# define TSP_SEC_MEM_SIZE		(ARM_AP_TZC_DRAM1_SIZE -	\
+						ARM_BL31_COLD_SIZE)
+# define BL32_BASE			(ARM_AP_TZC_DRAM1_BASE +	\
+						ARM_BL31_COLD_SIZE)
 # define BL32_LIMIT			(ARM_AP_TZC_DRAM1_BASE +	\
 						ARM_AP_TZC_DRAM1_SIZE)
 #else
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARM_HANG_DETECT_H__
+#define __ARM_HANG_DETECT_H__
+
+/*******************************************************************************
+ * EL3 hang detection of the ARM standard platforms (EL3_HANG_DETECT). BL31
+ * runs the trusted SP805 watchdog with a period of ARM_HANG_DETECT_PERIOD_MS
+ * and takes its interrupt at EL3 at the end of each period. Unless a CPU has
+ * been executing in EL3 without progress for the whole period, the handler
+ * clears the interrupt, which starts the next period. Otherwise it prints the
+ * progress of all the CPUs and panics, leaving the watchdog to reset the system
+ * at the end of the next period.
+ ******************************************************************************/
+
+/* Period of the watchdog, i.e. the time after which a CPU is reported hung */
+#define ARM_HANG_DETECT_PERIOD_MS	1000
+
+#ifndef __ASSEMBLY__
+
+#if EL3_HANG_DETECT && IMAGE_BL31
+void arm_hang_detect_setup(void);
+void arm_hang_detect_stop(void);
+#else
+static inline void arm_hang_detect_setup(void)
+{
+}
+static inline void arm_hang_detect_stop(void)
+{
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __ARM_HANG_DETECT_H__ */
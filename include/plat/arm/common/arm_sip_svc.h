@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARM_SIP_SVC_H__
+#define __ARM_SIP_SVC_H__
+
+/*******************************************************************************
+ * SiP Service Calls of the ARM standard platforms
+ ******************************************************************************/
+
+/*
+ * ARM_SIP_CPU_ON_BATCH: turns on several CPUs of a cluster in one call.
+ *   x1 = MPIDR giving the affinity levels 1 to 3 of the target CPUs (its
+ *        affinity level 0 field is ignored)
+ *   x2 = target list, bit 'n' selecting the CPU with affinity level 0 'n', for
+ *        'n' lower than ARM_SIP_CPU_ON_BATCH_MAX
+ *   x3 = entry point address, x4 = context ID, shared by all the target CPUs
+ *   Returns x0 = PSCI_E_SUCCESS if all the target CPUs are being turned on, or
+ *   otherwise the PSCI error returned for one of them, and x1 = target list of
+ *   the CPUs which are being turned on.
+ */
+#define ARM_SIP_CPU_ON_BATCH		0xc2000001
+#define ARM_SIP_CPU_ON_BATCH_MAX	PSCI_CPU_ON_BATCH_MAX
+
+/*
+ * ARM_SIP_PSCI_TRACE_READ: reads an event of the PSCI trace of a CPU, when
+ * ENABLE_PSCI_TRACE is set (see psci_trace.h).
+ *   x1 = CPU linear index, x2 = sequence number of the event
+ *   Returns x0 = 0 if the event is available or PSCI_TRACE_E_NOT_AVAIL, x1 =
+ *   timestamp, x2 = argument << 32 | event, x3 = sequence number of the next
+ *   event the CPU will record.
+ */
+#define ARM_SIP_PSCI_TRACE_READ		0xc2000002
+
+/*
+ * ARM_SIP_LOCK_PROFILE_READ: reads the contention profile of a bakery lock of
+ * BL31, summed up over all the CPUs, when ENABLE_LOCK_PROFILING is set (see
+ * lock_profile.h).
+ *   x1 = index of the lock, in the link order of the bakery locks of BL31
+ *   Returns x0 = 0 if the lock exists or ARM_SIP_E_NOT_AVAIL, x1 = contended
+ *   acquisition count << 32 | acquisition count (both modulo 2^32), x2 =
+ *   total wait time and x3 = maximum wait time, in system counter ticks.
+ */
+#define ARM_SIP_LOCK_PROFILE_READ	0xc2000003
+
+/*
+ * ARM_SIP_BOOT_TS_READ: reads a boot-path timestamp marker, when
+ * ARM_BOOT_TIMESTAMPS is set (see arm_boot_ts.h).
+ *   x1 = index of the marker, in recording order
+ *   Returns x0 = 0 if the marker exists or ARM_SIP_E_NOT_AVAIL, x1 = argument
+ *   << 32 | marker ID, x2 = system counter physical count when the marker was
+ *   recorded and x3 = number of markers in the table.
+ */
+#define ARM_SIP_BOOT_TS_READ		0xc2000004
+
+/*
+ * ARM_SIP_SET_LOG_LEVEL: sets the level of the log messages printed by BL31,
+ * when RUNTIME_LOG_LEVEL is set. Messages above LOG_LEVEL are never printed
+ * as they are not compiled in.
+ *   x1 = new level, from LOG_LEVEL_NONE to LOG_LEVEL_VERBOSE
+ *   Returns x0 = 0 or ARM_SIP_E_INVALID_PARAMS, x1 = previous level.
+ */
+#define ARM_SIP_SET_LOG_LEVEL		0x82000005
+
+/*
+ * ARM_SIP_TZC_FAULT_READ: reads a TZC access violation recorded by BL31, when
+ * ARM_TZC_FAULT_HANDLER is set (see arm_tzc_fault.h).
+ *   x1 = sequence number of the fault
+ *   Returns x0 = 0 if the fault is still in the ring or ARM_SIP_E_NOT_AVAIL,
+ *   x1 = fail address, x2 = fail ID << 32 | fail control, x3 = filter << 32 |
+ *   sequence number of the next fault to be recorded.
+ */
+#define ARM_SIP_TZC_FAULT_READ		0xc2000006
+
+/*
+ * ARM_SIP_ERRATA_READ: reads the status of an erratum of a CPU and the duration
+ * of its last reset handler, when REPORT_ERRATA is set (see errata_report.h).
+ *   x1 = CPU linear index, x2 = index of the erratum among those of the CPU
+ *   Returns x0 = 0 if the erratum exists or ARM_SIP_E_NOT_AVAIL, x1 = status
+ *   << 32 | erratum number, x2 = duration of the last reset handler of the
+ *   CPU, in system counter ticks, and x3 = number of errata of the CPU. x2 and
+ *   x3 are also returned if only the index of the erratum is out of range.
+ */
+#define ARM_SIP_ERRATA_READ		0xc2000007
+
+/*
+ * ARM_SIP_STACK_USAGE: reads the deepest use of the BL31 stack of a CPU since
+ * cold boot, when MEASURE_STACK_USAGE is set.
+ *   x1 = CPU linear index
+ *   Returns x0 = 0 or ARM_SIP_E_NOT_AVAIL, x1 = number of bytes used, x2 = size
+ *   of the stack.
+ */
+#define ARM_SIP_STACK_USAGE		0xc2000008
+
+/* Error codes of the ARM SiP Service Calls */
+#define ARM_SIP_E_NOT_AVAIL		-1
+#define ARM_SIP_E_INVALID_PARAMS	-2
+
+#endif /* __ARM_SIP_SVC_H__ */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARM_TZC_FAULT_H__
+#define __ARM_TZC_FAULT_H__
+
+#include <tzc400.h>
+
+/*******************************************************************************
+ * TZC-400 fault reporting of the ARM standard platforms (ARM_TZC_FAULT_HANDLER).
+ * BL31 takes the TZC interrupt at EL3, copies the fail status of each filter
+ * which rejected an access into a ring of the most recent faults and clears
+ * the interrupt. Faults are printed on the console at most once per
+ * ARM_TZC_FAULT_LOG_PERIOD_MS, along with the number of faults that were not
+ * printed. The normal world reads the ring through the ARM_SIP_TZC_FAULT_READ
+ * SiP call.
+ ******************************************************************************/
+
+/* Number of faults kept in the ring. Must be a power of 2. */
+#define ARM_TZC_FAULT_RING_SIZE		16
+
+/* Minimum interval between two faults printed on the console */
+#define ARM_TZC_FAULT_LOG_PERIOD_MS	1000
+
+#ifndef __ASSEMBLY__
+
+#if ARM_TZC_FAULT_HANDLER && IMAGE_BL31
+void arm_tzc_fault_setup(void);
+int arm_tzc_fault_read(unsigned int seq, tzc_fail_info_t *info,
+		       unsigned int *next_seq);
+#else
+static inline void arm_tzc_fault_setup(void)
+{
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* __ARM_TZC_FAULT_H__ */
@@ -154,6 +154,7 @@ void arm_bl1_plat_arch_setup(void);
 void arm_bl2_early_platform_setup(meminfo_t *mem_layout);
 void arm_bl2_platform_setup(void);
 void arm_bl2_plat_arch_setup(void);
+void arm_bl2_plat_flush_bl31_params(void);
 uint32_t arm_get_spsr_for_bl32_entry(void);
 uint32_t arm_get_spsr_for_bl33_entry(void);
 
@@ -162,6 +163,7 @@ void arm_bl2u_early_platform_setup(struct meminfo *mem_layout,
 				void *plat_info);
 void arm_bl2u_platform_setup(void);
 void arm_bl2u_plat_arch_setup(void);
+extern const struct bl2u_flash_ops arm_nor_flash_ops;
 
 /* BL31 utility functions */
 void arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
@@ -189,7 +191,11 @@ void plat_arm_security_setup(void);
 void plat_arm_pwrc_setup(void);
 void plat_arm_interconnect_init(void);
 void plat_arm_interconnect_enter_coherency(void);
+void plat_arm_interconnect_enter_coherency_async(void);
+void plat_arm_interconnect_wait_coherency(void);
 void plat_arm_interconnect_exit_coherency(void);
+void plat_arm_interconnect_enter_system_idle(void);
+void plat_arm_interconnect_exit_system_idle(void);
 
 /*
  * Optional functions required in ARM standard platforms
@@ -199,6 +205,7 @@ int plat_arm_get_alt_image_source(
 	unsigned int image_id,
 	uintptr_t *dev_handle,
 	uintptr_t *image_spec);
+int plat_arm_prefer_alt_image_source(unsigned int image_id);
 unsigned int plat_arm_calc_core_pos(u_register_t mpidr);
 const mmap_region_t *plat_arm_get_mmap(void);
 
@@ -64,11 +64,26 @@
 /*
  * Define a list of Group 1 Secure interrupts as per GICv3 terminology. On a
  * GICv2 system or mode, the interrupts will be treated as Group 0 interrupts.
+ * When BL31 handles the TZC interrupt (ARM_TZC_FAULT_HANDLER) or the trusted
+ * watchdog interrupt (EL3_HANG_DETECT), the platform lists it as a Group 0
+ * interrupt instead.
  */
+#if ARM_TZC_FAULT_HANDLER
+#define CSS_G1S_TZC_IRQ
+#else
+#define CSS_G1S_TZC_IRQ			CSS_IRQ_TZC,
+#endif
+
+#if EL3_HANG_DETECT
+#define CSS_G1S_TZ_WDOG_IRQ
+#else
+#define CSS_G1S_TZ_WDOG_IRQ		CSS_IRQ_TZ_WDOG,
+#endif
+
 #define CSS_G1S_IRQS			CSS_IRQ_MHU,		\
 					CSS_IRQ_GPU_SMMU_0,	\
-					CSS_IRQ_TZC,		\
-					CSS_IRQ_TZ_WDOG,	\
+					CSS_G1S_TZC_IRQ		\
+					CSS_G1S_TZ_WDOG_IRQ	\
 					CSS_IRQ_SEC_SYS_TIMER
 
 /*
@@ -134,7 +149,20 @@
  * SCP_BL2 is loaded to the same place as BL31.  Once SCP_BL2 is transferred to the
  * SCP, it is discarded and BL31 is loaded over the top.
  */
+#if CSS_SCP_BL2_DRAM_XFER
+/*
+ * SCP_BL2 is loaded to the DRAM reserved for SCP instead, from where SCP reads
+ * it directly.
+ */
+#define SCP_BL2_BASE			ARM_SCP_TZC_DRAM1_BASE
+
+#define CSS_MAP_SCP_TZC_DRAM1		MAP_REGION_FLAT(		\
+						ARM_SCP_TZC_DRAM1_BASE,	\
+						ARM_SCP_TZC_DRAM1_SIZE,	\
+						MT_MEMORY | MT_RW | MT_SECURE)
+#else
 #define SCP_BL2_BASE			BL31_BASE
+#endif
 
 #define SCP_BL2U_BASE			BL31_BASE
 #endif /* CSS_LOAD_SCP_IMAGES */
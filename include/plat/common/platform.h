@@ -43,7 +43,10 @@ struct meminfo;
 struct image_info;
 struct entry_point_info;
 struct bl31_params;
+struct bl31_image_digest;
 struct image_desc;
+struct crypto_engine_desc_s;
+struct warm_reboot_manifest;
 
 /*******************************************************************************
  * plat_get_rotpk_info() flags
@@ -85,6 +88,18 @@ int plat_crash_console_putc(int c);
 void plat_error_handler(int err) __dead2;
 void plat_panic_handler(void) __dead2;
 
+/*******************************************************************************
+ * Common functions provided with the platform stacks when MEASURE_STACK_USAGE
+ * is set
+ ******************************************************************************/
+void plat_paint_stacks(void);
+unsigned int plat_get_stack_usage(unsigned int cpu_idx);
+
+/*******************************************************************************
+ * Mandatory BL2 and BL31 function when FAST_WARM_REBOOT is set
+ ******************************************************************************/
+struct warm_reboot_manifest *plat_get_warm_reboot_manifest(void);
+
 /*******************************************************************************
  * Mandatory BL1 functions
  ******************************************************************************/
@@ -123,6 +138,7 @@ struct image_desc *bl1_plat_get_image_desc(unsigned int image_id);
  * feature and may optionally be overridden.
  */
 __dead2 void bl1_plat_fwu_done(void *client_cookie, void *reserved);
+int bl1_plat_fwu_copy(uintptr_t dst, uintptr_t src, size_t size);
 
 
 /*******************************************************************************
@@ -192,6 +208,12 @@ void bl2_plat_get_bl32_meminfo(struct meminfo *mem_info);
 /*******************************************************************************
  * Optional BL2 functions (may be overridden)
  ******************************************************************************/
+unsigned int bl2_plat_release_helper_cpus(uintptr_t entrypoint);
+void bl2_plat_park_helper_cpu(void) __dead2;
+void bl2_plat_image_chunk_loaded(unsigned int image_id, uintptr_t buffer,
+				 size_t length);
+int bl2_plat_image_in_place(unsigned int image_id, uintptr_t address,
+			    size_t size);
 
 /*******************************************************************************
  * Mandatory BL2U functions.
@@ -220,6 +242,11 @@ void bl31_platform_setup(void);
 void bl31_plat_runtime_setup(void);
 struct entry_point_info *bl31_plat_get_next_image_ep_info(uint32_t type);
 
+/*******************************************************************************
+ * Mandatory BL31 function when RESET_TO_BL31_VERIFY is set
+ ******************************************************************************/
+const struct bl31_image_digest *bl31_plat_get_image_digests(unsigned int *num);
+
 /*******************************************************************************
  * Mandatory PSCI functions (BL31)
  ******************************************************************************/
@@ -233,11 +260,22 @@ const unsigned char *plat_get_power_domain_tree_desc(void);
 plat_local_state_t plat_get_target_pwr_state(unsigned int lvl,
 			const plat_local_state_t *states,
 			unsigned int ncpu);
+plat_local_state_t plat_get_predicted_pwr_state(unsigned int lvl,
+			plat_local_state_t target_state,
+			uint64_t residency_us);
+const plat_state_latency_t *plat_get_state_latency(unsigned int lvl,
+			plat_local_state_t state);
 
 /*******************************************************************************
  * Optional BL31 functions (may be overridden)
  ******************************************************************************/
 void bl31_plat_enable_mmu(uint32_t flags);
+void bl31_plat_init_mem_reclaimed(uintptr_t base, size_t size);
+
+/*******************************************************************************
+ * Mandatory BL31 function when EL3_NS_PREEMPT is set
+ ******************************************************************************/
+uint32_t plat_ic_set_priority_mask(uint32_t mask);
 
 /*******************************************************************************
  * Optional BL32 functions (may be overridden)
@@ -249,6 +287,9 @@ void bl32_plat_enable_mmu(uint32_t flags);
  ******************************************************************************/
 int plat_get_rotpk_info(void *cookie, void **key_ptr, unsigned int *key_len,
 			unsigned int *flags);
+const struct crypto_engine_desc_s *plat_get_crypto_engine(void);
+int plat_get_img_hash(unsigned int image_id, void **hash_ptr,
+		      unsigned int *hash_len);
 
 #if ENABLE_PLAT_COMPAT
 /*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -34,6 +34,7 @@
 #include <bl_common.h>
 #include <cassert.h>
 #include <debug.h>
+#include <errno.h>
 #include <platform_def.h>
 #include <string.h>
 #include <xlat_tables.h>
@@ -56,23 +57,115 @@
 
 /*
  * The virtual address space size must be a power of two (as set in TCR.T0SZ).
- * As we start the initial lookup at level 1, it must also be between 2 GB and
- * 512 GB (with the virtual address size therefore 31 to 39 bits). See section
- * D4.2.5 in the ARMv8-A Architecture Reference Manual (DDI 0487A.i) for more
- * information.
+ * It must also be between 2 GB and 512 GB (with the virtual address size
+ * therefore 31 to 39 bits), so that the initial lookup is at level 1 or 2 for
+ * all the granule sizes. See section D4.2.5 in the ARMv8-A Architecture
+ * Reference Manual (DDI 0487A.i) for more information.
  */
 CASSERT(ADDR_SPACE_SIZE >= (1ull << 31) && ADDR_SPACE_SIZE <= (1ull << 39) &&
 	IS_POWER_OF_TWO(ADDR_SPACE_SIZE), assert_valid_addr_space_size);
 
+/*
+ * Translation granule. It is 4KB unless the platform selects a 16KB or 64KB
+ * granule for the image by defining PLAT_XLAT_GRANULE_SHIFT to 14 or 16 in
+ * platform_def.h. All the regions must be aligned to the granule size.
+ */
+#ifdef PLAT_XLAT_GRANULE_SHIFT
+#define XLAT_GRANULE_SHIFT	PLAT_XLAT_GRANULE_SHIFT
+#else
+#define XLAT_GRANULE_SHIFT	FOUR_KB_SHIFT
+#endif
+
+#if XLAT_GRANULE_SHIFT == FOUR_KB_SHIFT
+#define XLAT_TCR_TG0		TCR_TG0_4K
+#elif XLAT_GRANULE_SHIFT == SIXTEEN_KB_SHIFT
+#define XLAT_TCR_TG0		TCR_TG0_16K
+#elif XLAT_GRANULE_SHIFT == SIXTY_FOUR_KB_SHIFT
+#define XLAT_TCR_TG0		TCR_TG0_64K
+#else
+#error "PLAT_XLAT_GRANULE_SHIFT must be 12, 14 or 16"
+#endif
+
+#define XLAT_GRANULE_SIZE	(1ul << XLAT_GRANULE_SHIFT)
+#define IS_XLAT_GRANULE_ALIGNED(addr)	\
+				(((addr) & (XLAT_GRANULE_SIZE - 1)) == 0)
+
+/* Each translation table fills one granule with 8-byte entries */
+#define XLAT_ENTRIES_SHIFT	(XLAT_GRANULE_SHIFT - XLAT_ENTRY_SIZE_SHIFT)
+#define XLAT_ENTRIES		(1 << XLAT_ENTRIES_SHIFT)
+#define XLAT_ENTRIES_MASK	(XLAT_ENTRIES - 1)
+
+/* Shift of the size of the area mapped by an entry at the given level */
+#define XLAT_ADDR_SHIFT(level)	(XLAT_GRANULE_SHIFT + \
+					(3 - (level)) * XLAT_ENTRIES_SHIFT)
+
+/*
+ * Level of the initial lookup: level 2 if one table at that level can map the
+ * whole virtual address space, level 1 otherwise.
+ */
+#define XLAT_BASE_LEVEL		\
+		((ADDR_SPACE_SIZE <= (1ull << XLAT_ADDR_SHIFT(1))) ? 2 : 1)
+
+/*
+ * Block descriptors are only allowed at level 1 with the 4KB granule. Levels 2
+ * and 3 always allow them (level 3 descriptors being page descriptors).
+ */
+#define XLAT_BLOCK_ALLOWED(level)	((level) >= 2 || \
+				XLAT_GRANULE_SHIFT == FOUR_KB_SHIFT)
+
+/*
+ * Number of adjacent entries sharing a TLB entry with the Contiguous bit. It
+ * is 16 with the 4KB granule, and 32 with the 16KB and 64KB granules except
+ * for level 3 with the 16KB granule where it is 128.
+ */
+#define XLAT_CONT_ENTRIES(level)					\
+	((XLAT_GRANULE_SHIFT == FOUR_KB_SHIFT) ? 16 :			\
+	 ((XLAT_GRANULE_SHIFT == SIXTEEN_KB_SHIFT && (level) == 3) ?	\
+	  128 : 32))
+
 #define UNSET_DESC	~0ul
 
-#define NUM_L1_ENTRIES (ADDR_SPACE_SIZE >> L1_XLAT_ADDRESS_SHIFT)
+/*
+ * Attribute flag used internally to tell the regions added at runtime apart
+ * from the ones added before init_xlat_tables(). It is ignored by mmap_desc().
+ */
+#define MT_DYNAMIC		(1 << 7)
+
+CASSERT((MT_DYNAMIC & (MT_TYPE_MASK | MT_RW | MT_NS)) == 0,
+	assert_mt_dynamic_unused);
+
+#define NUM_BASE_ENTRIES \
+		(ADDR_SPACE_SIZE >> XLAT_ADDR_SHIFT(XLAT_BASE_LEVEL))
+
+#if BL31_PREBUILT_XLAT && IMAGE_BL31
+/*
+ * The translation tables of BL31 are generated at build time by
+ * tools/xlat_prebuilt from the regions in PLAT_XLAT_PREBUILT_MMAP, and written
+ * into the image once it is linked, along with the sorted list of the regions
+ * they map. They must therefore be in the loaded data of the image. The list
+ * is left empty if the tables have not been generated. The list and the number
+ * of tables used are global so that the compiler cannot assume they keep their
+ * initial value.
+ */
+#define XLAT_TABLES_SECTION	"xlat_table_prebuilt"
+#define __xlat_prebuilt		__section(XLAT_TABLES_SECTION)
+
+mmap_region_t xlat_prebuilt_mmap[MAX_MMAP_REGIONS + 1] __xlat_prebuilt;
+unsigned int xlat_prebuilt_tables __xlat_prebuilt;
 
-static uint64_t l1_xlation_table[NUM_L1_ENTRIES]
-__aligned(NUM_L1_ENTRIES * sizeof(uint64_t));
+static int xlat_prebuilt_adopt(void);
+#define XLAT_PREBUILT_ADOPT()	xlat_prebuilt_adopt()
+#else
+#define XLAT_TABLES_SECTION	"xlat_table"
+#define __xlat_prebuilt
+#define XLAT_PREBUILT_ADOPT()	0
+#endif
 
-static uint64_t xlat_tables[MAX_XLAT_TABLES][XLAT_TABLE_ENTRIES]
-__aligned(XLAT_TABLE_SIZE) __section("xlat_table");
+static uint64_t base_xlation_table[NUM_BASE_ENTRIES]
+__aligned(NUM_BASE_ENTRIES * sizeof(uint64_t)) __xlat_prebuilt;
+
+static uint64_t xlat_tables[MAX_XLAT_TABLES][XLAT_ENTRIES]
+__aligned(XLAT_GRANULE_SIZE) __section(XLAT_TABLES_SECTION);
 
 static unsigned next_xlat;
 static unsigned long max_pa;
@@ -80,10 +173,14 @@ static unsigned long max_va;
 static unsigned long tcr_ps_bits;
 
 /*
- * Array of all memory regions stored in order of ascending base address.
- * The list is terminated by the first entry with size == 0.
+ * Array of all memory regions. The regions added before init_xlat_tables() are
+ * stored in the order they are added, and init_xlat_tables() sorts them in
+ * order of ascending base address. The regions added after that are inserted
+ * in place. The list is terminated by the first entry with size == 0.
  */
 static mmap_region_t mmap[MAX_MMAP_REGIONS + 1];
+static unsigned mmap_num;
+static int mmap_sorted;
 
 
 static void print_mmap(void)
@@ -103,32 +200,46 @@ static void print_mmap(void)
 void mmap_add_region(unsigned long base_pa, unsigned long base_va,
 			unsigned long size, unsigned attr)
 {
-	mmap_region_t *mm = mmap;
-	mmap_region_t *mm_last = mm + ARRAY_SIZE(mmap) - 1;
+	mmap_region_t *mm = &mmap[mmap_num];
 	unsigned long pa_end = base_pa + size - 1;
 	unsigned long va_end = base_va + size - 1;
+	unsigned lo, hi, mid;
 
-	assert(IS_PAGE_ALIGNED(base_pa));
-	assert(IS_PAGE_ALIGNED(base_va));
-	assert(IS_PAGE_ALIGNED(size));
+	assert(IS_XLAT_GRANULE_ALIGNED(base_pa));
+	assert(IS_XLAT_GRANULE_ALIGNED(base_va));
+	assert(IS_XLAT_GRANULE_ALIGNED(size));
 
 	if (!size)
 		return;
 
-	/* Find correct place in mmap to insert new region */
-	while (mm->base_va < base_va && mm->size)
-		++mm;
+	/* Check there is room left for the new region and the sentinel */
+	assert(mmap_num < MAX_MMAP_REGIONS);
 
-	/* Make room for new region by moving other regions up by one place */
-	memmove(mm + 1, mm, (uintptr_t)mm_last - (uintptr_t)mm);
+	if (mmap_sorted) {
+		/* Find correct place in mmap to insert new region */
+		lo = 0;
+		hi = mmap_num;
+		while (lo < hi) {
+			mid = (lo + hi) / 2;
+			if (mmap[mid].base_va < base_va)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		mm = &mmap[lo];
 
-	/* Check we haven't lost the empty sentinal from the end of the array */
-	assert(mm_last->size == 0);
+		/*
+		 * Make room for new region by moving the other regions and
+		 * the sentinel up by one place
+		 */
+		memmove(mm + 1, mm, (mmap_num - lo + 1) * sizeof(*mm));
+	}
 
 	mm->base_pa = base_pa;
 	mm->base_va = base_va;
 	mm->size = size;
 	mm->attr = attr;
+	mmap_num++;
 
 	if (pa_end > max_pa)
 		max_pa = pa_end;
@@ -223,14 +334,50 @@ static int mmap_region_attr(mmap_region_t *mm, unsigned long base_va,
 	}
 }
 
+/*
+ * Sets the Contiguous bit in each aligned run of XLAT_CONT_ENTRIES block or
+ * page descriptors of 'table' which map contiguous physical memory with the same
+ * attributes, so that each run only needs one TLB entry.
+ */
+static void xlat_set_contiguous(unsigned long *table, unsigned entries,
+				unsigned level)
+{
+	unsigned level_size_shift = XLAT_ADDR_SHIFT(level);
+	unsigned run = XLAT_CONT_ENTRIES(level);
+	unsigned long run_mask = ((unsigned long)run << level_size_shift) - 1;
+	unsigned leaf_desc = level == 3 ? TABLE_DESC : BLOCK_DESC;
+	unsigned i, j;
+
+	for (i = 0; i + run <= entries; i += run) {
+		unsigned long desc = table[i];
+
+		if ((desc & DESC_MASK) != leaf_desc ||
+		    (desc & TABLE_ADDR_MASK & run_mask))
+			continue;
+
+		for (j = 1; j < run; j++) {
+			if (table[i + j] !=
+			    desc + ((unsigned long)j << level_size_shift))
+				break;
+		}
+
+		if (j < run)
+			continue;
+
+		for (j = 0; j < run; j++)
+			table[i + j] |= UPPER_ATTRS(CONT_HINT);
+	}
+}
+
 static mmap_region_t *init_xlation_table(mmap_region_t *mm,
 					unsigned long base_va,
 					unsigned long *table, unsigned level)
 {
-	unsigned level_size_shift = L1_XLAT_ADDRESS_SHIFT - (level - 1) *
-						XLAT_TABLE_ENTRIES_SHIFT;
-	unsigned level_size = 1 << level_size_shift;
-	unsigned long level_index_mask = XLAT_TABLE_ENTRIES_MASK << level_size_shift;
+	unsigned level_size_shift = XLAT_ADDR_SHIFT(level);
+	unsigned long level_size = 1ul << level_size_shift;
+	unsigned long level_index_mask =
+			(unsigned long)XLAT_ENTRIES_MASK << level_size_shift;
+	unsigned long *table_start = table;
 
 	assert(level <= 3);
 
@@ -248,14 +395,16 @@ static mmap_region_t *init_xlation_table(mmap_region_t *mm,
 			continue;
 		}
 
-		debug_print("%s VA:0x%lx size:0x%x ", get_level_spacer(level),
+		debug_print("%s VA:0x%lx size:0x%lx ", get_level_spacer(level),
 				base_va, level_size);
 
 		if (mm->base_va >= base_va + level_size) {
 			/* Next region is after area so nothing to map yet */
 			desc = INVALID_DESC;
-		} else if (mm->base_va <= base_va && mm->base_va + mm->size >=
-				base_va + level_size) {
+		} else if (XLAT_BLOCK_ALLOWED(level) &&
+				mm->base_va <= base_va &&
+				mm->base_va + mm->size >=
+					base_va + level_size) {
 			/* Next region covers all of area */
 			int attr = mmap_region_attr(mm, base_va, level_size);
 			if (attr >= 0)
@@ -282,6 +431,8 @@ static mmap_region_t *init_xlation_table(mmap_region_t *mm,
 		base_va += level_size;
 	} while ((base_va & level_index_mask) && (base_va < ADDR_SPACE_SIZE));
 
+	xlat_set_contiguous(table_start, table - table_start, level);
+
 	return mm;
 }
 
@@ -313,14 +464,621 @@ static unsigned int calc_physical_addr_size_bits(unsigned long max_addr)
 	return TCR_PS_BITS_4GB;
 }
 
+/*
+ * Returns true if region 'a' must come before region 'b' in mmap. Regions with
+ * the same base address are ordered by decreasing size, so that the largest
+ * one is tried first for block mappings.
+ */
+static int mmap_region_before(const mmap_region_t *a, const mmap_region_t *b)
+{
+	return a->base_va < b->base_va ||
+		(a->base_va == b->base_va && a->size > b->size);
+}
+
+static void mmap_sift_down(unsigned root, unsigned num)
+{
+	mmap_region_t tmp;
+	unsigned child;
+
+	while ((child = 2 * root + 1) < num) {
+		if (child + 1 < num &&
+		    mmap_region_before(&mmap[child], &mmap[child + 1]))
+			child++;
+
+		if (!mmap_region_before(&mmap[root], &mmap[child]))
+			return;
+
+		tmp = mmap[root];
+		mmap[root] = mmap[child];
+		mmap[child] = tmp;
+		root = child;
+	}
+}
+
+/*
+ * Sorts the regions added so far in order of ascending base address. This is
+ * an in-place heapsort, so it needs neither recursion nor extra memory.
+ */
+static void mmap_sort(void)
+{
+	mmap_region_t tmp;
+	unsigned i;
+
+	for (i = mmap_num / 2; i-- > 0; )
+		mmap_sift_down(i, mmap_num);
+
+	for (i = mmap_num; i-- > 1; ) {
+		tmp = mmap[0];
+		mmap[0] = mmap[i];
+		mmap[i] = tmp;
+		mmap_sift_down(0, i);
+	}
+}
+
+/*
+ * Merges each region of the sorted mmap with the next one if they are
+ * contiguous in both the virtual and physical address spaces and have the
+ * same attributes. This lets init_xlation_table() use larger blocks across
+ * the boundaries between regions.
+ */
+static void mmap_coalesce(void)
+{
+	mmap_region_t *prev;
+	unsigned i, j = 0;
+
+	for (i = 1; i < mmap_num; i++) {
+		prev = &mmap[j];
+		if (prev->attr == mmap[i].attr &&
+		    prev->base_va + prev->size == mmap[i].base_va &&
+		    prev->base_pa + prev->size == mmap[i].base_pa)
+			prev->size += mmap[i].size;
+		else
+			mmap[++j] = mmap[i];
+	}
+
+	if (mmap_num)
+		mmap_num = j + 1;
+
+	memset(&mmap[mmap_num], 0,
+		(MAX_MMAP_REGIONS + 1 - mmap_num) * sizeof(mmap[0]));
+}
+
+/*
+ * Checks that the regions which overlap each other in the sorted mmap
+ * translate the shared virtual addresses to the same physical addresses.
+ */
+static void mmap_check_overlaps(void)
+{
+#if DEBUG
+	unsigned i, j;
+
+	for (i = 0; i < mmap_num; i++) {
+		for (j = i + 1; j < mmap_num; j++) {
+			if (mmap[j].base_va >= mmap[i].base_va + mmap[i].size)
+				break;
+
+			assert(mmap[j].base_va - mmap[i].base_va ==
+				mmap[j].base_pa - mmap[i].base_pa);
+		}
+	}
+#endif
+}
+
 void init_xlat_tables(void)
 {
+	mmap_sort();
+	mmap_coalesce();
+	mmap_check_overlaps();
+	mmap_sorted = 1;
+
 	print_mmap();
-	init_xlation_table(mmap, 0, l1_xlation_table, 1);
+	if (!XLAT_PREBUILT_ADOPT())
+		init_xlation_table(mmap, 0, base_xlation_table,
+				   XLAT_BASE_LEVEL);
 	tcr_ps_bits = calc_physical_addr_size_bits(max_pa);
 	assert(max_va < ADDR_SPACE_SIZE);
+
+	INFO("Translation tables: %u of %u used\n", next_xlat,
+		MAX_XLAT_TABLES);
+}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*
+ * Translation tables from the xlat_tables pool which are in use by dynamic
+ * regions. Tables below next_xlat belong to the static regions and are never
+ * released.
+ */
+static unsigned char xlat_tables_dyn_used[MAX_XLAT_TABLES];
+
+static unsigned long *xlat_table_dyn_alloc(void)
+{
+	unsigned int i;
+
+	for (i = next_xlat; i < MAX_XLAT_TABLES; i++) {
+		if (!xlat_tables_dyn_used[i]) {
+			xlat_tables_dyn_used[i] = 1;
+			memset(xlat_tables[i], 0, XLAT_GRANULE_SIZE);
+			flush_dcache_range((uint64_t)xlat_tables[i],
+					   XLAT_GRANULE_SIZE);
+			return (unsigned long *)xlat_tables[i];
+		}
+	}
+
+	return NULL;
 }
 
+/*
+ * Releases 'table' if it was allocated by xlat_table_dyn_alloc() and has no
+ * valid entries left. Returns 1 if the table has been released.
+ */
+static int xlat_table_dyn_release(unsigned long *table)
+{
+	unsigned int i = ((uintptr_t)table - (uintptr_t)xlat_tables) /
+							XLAT_GRANULE_SIZE;
+	unsigned int j;
+
+	if (i < next_xlat || !xlat_tables_dyn_used[i])
+		return 0;
+
+	for (j = 0; j < XLAT_ENTRIES; j++)
+		if (table[j] != INVALID_DESC)
+			return 0;
+
+	xlat_tables_dyn_used[i] = 0;
+	return 1;
+}
+
+/*
+ * Writes 'desc' to the translation table entry at 'entry' and cleans it to the
+ * point of coherency, so that it is also seen by the cores walking the tables
+ * with their data cache disabled.
+ */
+static void xlat_write_desc(unsigned long *entry, unsigned long desc)
+{
+	*entry = desc;
+	flush_dcache_range((uint64_t)entry, sizeof(*entry));
+}
+
+static void xlat_tlbi_va(unsigned long va)
+{
+	/* Ensure the translation table write has drained into memory */
+	dsbish();
+
+	/* The operand holds the VA in 4KB units whatever the granule size */
+	if (IS_IN_EL(3))
+		tlbivae3is(va >> PAGE_SIZE_SHIFT);
+	else
+		tlbivaae1is(va >> PAGE_SIZE_SHIFT);
+}
+
+/*
+ * Maps the part of the region 'mm' which falls in the area covered by 'table',
+ * the translation table at 'level' whose first entry maps 'table_va'. Must
+ * only be called for areas with no other region mapped, so that all the
+ * entries written are invalid beforehand and no break-before-make sequence is
+ * needed.
+ */
+static int map_dynamic_region(const mmap_region_t *mm, unsigned long table_va,
+				unsigned long *table, unsigned level)
+{
+	unsigned level_size_shift = XLAT_ADDR_SHIFT(level);
+	unsigned long level_size = 1ul << level_size_shift;
+	unsigned long region_end = mm->base_va + mm->size;
+	unsigned long entries = (level == XLAT_BASE_LEVEL) ? NUM_BASE_ENTRIES :
+								XLAT_ENTRIES;
+	unsigned long va, idx;
+	int rc;
+
+	va = mm->base_va & ~(level_size - 1);
+	if (va < table_va)
+		va = table_va;
+	idx = (va - table_va) >> level_size_shift;
+
+	for (; idx < entries && va < region_end; idx++, va += level_size) {
+		unsigned long desc = table[idx];
+		unsigned long *next_table;
+
+		if (XLAT_BLOCK_ALLOWED(level) &&
+		    mm->base_va <= va && va + level_size <= region_end &&
+		    ((mm->base_pa - mm->base_va) & (level_size - 1)) == 0) {
+			/* Region covers all of the entry with a block */
+			assert(desc == INVALID_DESC);
+			xlat_write_desc(&table[idx], mmap_desc(mm->attr,
+					va - mm->base_va + mm->base_pa, level));
+			continue;
+		}
+
+		assert(level < 3);
+
+		if (desc == INVALID_DESC) {
+			/* Region covers part of the entry, needs a table */
+			next_table = xlat_table_dyn_alloc();
+			if (!next_table)
+				return -ENOMEM;
+			xlat_write_desc(&table[idx],
+					TABLE_DESC | (unsigned long)next_table);
+		} else {
+			assert((desc & DESC_MASK) == TABLE_DESC);
+			next_table = (unsigned long *)(desc & TABLE_ADDR_MASK);
+		}
+
+		rc = map_dynamic_region(mm, va, next_table, level + 1);
+		if (rc)
+			return rc;
+	}
+
+	return 0;
+}
+
+/*
+ * Invalidates all the translation table entries mapping the region 'mm' in
+ * the area covered by 'table', and the TLB entries cached for them. The tables
+ * left empty by this are released.
+ */
+static void unmap_dynamic_region(const mmap_region_t *mm,
+				unsigned long table_va, unsigned long *table,
+				unsigned level)
+{
+	unsigned level_size_shift = XLAT_ADDR_SHIFT(level);
+	unsigned long level_size = 1ul << level_size_shift;
+	unsigned long region_end = mm->base_va + mm->size;
+	unsigned long entries = (level == XLAT_BASE_LEVEL) ? NUM_BASE_ENTRIES :
+								XLAT_ENTRIES;
+	unsigned long va, idx;
+
+	va = mm->base_va & ~(level_size - 1);
+	if (va < table_va)
+		va = table_va;
+	idx = (va - table_va) >> level_size_shift;
+
+	for (; idx < entries && va < region_end; idx++, va += level_size) {
+		unsigned long desc = table[idx];
+		unsigned long *next_table;
+
+		if (desc == INVALID_DESC)
+			continue;
+
+		if (level < 3 && (desc & DESC_MASK) == TABLE_DESC) {
+			next_table = (unsigned long *)(desc & TABLE_ADDR_MASK);
+			unmap_dynamic_region(mm, va, next_table, level + 1);
+			if (!xlat_table_dyn_release(next_table))
+				continue;
+		} else {
+			/* Blocks in this area can only map the region */
+			assert(mm->base_va <= va &&
+			       va + level_size <= region_end);
+		}
+
+		xlat_write_desc(&table[idx], INVALID_DESC);
+		xlat_tlbi_va(va);
+	}
+}
+
+int mmap_add_dynamic_region(unsigned long base_pa, unsigned long base_va,
+				unsigned long size, unsigned attr)
+{
+	mmap_region_t *mm;
+	int rc;
+
+	if (!IS_XLAT_GRANULE_ALIGNED(base_pa) ||
+	    !IS_XLAT_GRANULE_ALIGNED(base_va) ||
+	    !IS_XLAT_GRANULE_ALIGNED(size) || !size || (attr & MT_DYNAMIC))
+		return -EINVAL;
+
+	if (base_va + size - 1 < base_va ||
+	    base_va + size - 1 >= ADDR_SPACE_SIZE ||
+	    base_pa + size - 1 < base_pa ||
+	    ((base_pa + size - 1) & ADDR_MASK_48_TO_63) ||
+	    calc_physical_addr_size_bits(base_pa + size - 1) > tcr_ps_bits)
+		return -ERANGE;
+
+	/* The translation tables must have been created already */
+	if (!mmap_sorted)
+		return -EPERM;
+
+	/* The region must not overlap any region already mapped */
+	for (mm = mmap; mm->size; ++mm) {
+		if (base_va < mm->base_va + mm->size &&
+		    mm->base_va < base_va + size)
+			return -EPERM;
+	}
+
+	/* Check there is room left in mmap for the new region */
+	if (mmap_num == MAX_MMAP_REGIONS)
+		return -ENOMEM;
+
+	mmap_add_region(base_pa, base_va, size, attr | MT_DYNAMIC);
+
+	for (mm = mmap; mm->base_va != base_va; ++mm)
+		;
+
+	rc = map_dynamic_region(mm, 0, base_xlation_table,
+						XLAT_BASE_LEVEL);
+	if (rc) {
+		/* Undo the part of the mapping already in place */
+		unmap_dynamic_region(mm, 0, base_xlation_table,
+						XLAT_BASE_LEVEL);
+		memmove(mm, mm + 1, (uintptr_t)&mmap[mmap_num] -
+							(uintptr_t)mm);
+		mmap_num--;
+		dsbish();
+		return rc;
+	}
+
+	/* Make the new mapping visible to the table walks */
+	dsbish();
+	isb();
+
+	return 0;
+}
+
+int mmap_remove_dynamic_region(unsigned long base_va, unsigned long size)
+{
+	mmap_region_t *mm;
+
+	for (mm = mmap; mm->size; ++mm) {
+		if (mm->base_va == base_va && mm->size == size)
+			break;
+	}
+
+	if (!mm->size)
+		return -EINVAL;
+
+	/* Regions mapped by init_xlat_tables() cannot be removed */
+	if (!(mm->attr & MT_DYNAMIC))
+		return -EPERM;
+
+	unmap_dynamic_region(mm, 0, base_xlation_table,
+						XLAT_BASE_LEVEL);
+
+	/* Wait for the TLB invalidations to complete */
+	dsbish();
+	isb();
+
+	memmove(mm, mm + 1, (uintptr_t)&mmap[mmap_num] -
+							(uintptr_t)mm);
+	mmap_num--;
+
+	return 0;
+}
+
+/*
+ * Walks the entries of 'table', the translation table at 'level' whose first
+ * entry maps 'table_va', which map the area [base_va, end_va). If 'attr' is
+ * negative, it only checks that the area is mapped by blocks or pages which
+ * do not extend beyond it. Otherwise it rewrites the blocks and pages of the
+ * area with 'attr', using a break-before-make sequence. The runs of entries
+ * sharing a TLB entry with the Contiguous bit are broken up as a whole, as
+ * all the entries of a run must have the same attributes.
+ */
+static int remap_area(unsigned long base_va, unsigned long end_va, int attr,
+		      unsigned long table_va, unsigned long *table,
+		      unsigned level)
+{
+	unsigned level_size_shift = XLAT_ADDR_SHIFT(level);
+	unsigned long level_size = 1ul << level_size_shift;
+	unsigned long entries = (level == XLAT_BASE_LEVEL) ? NUM_BASE_ENTRIES :
+								XLAT_ENTRIES;
+	unsigned run = XLAT_CONT_ENTRIES(level);
+	unsigned long first, last, idx, lo, hi, i, va, desc, cont_desc;
+	int rc;
+
+	first = (base_va > table_va) ? (base_va - table_va) >> level_size_shift
+				     : 0;
+	last = (end_va - 1 - table_va) >> level_size_shift;
+	if (last >= entries)
+		last = entries - 1;
+
+	for (idx = first; idx <= last; idx = hi) {
+		desc = table[idx];
+		va = table_va + (idx << level_size_shift);
+
+		if (level < 3 && (desc & DESC_MASK) == TABLE_DESC) {
+			rc = remap_area(base_va, end_va, attr, va,
+				(unsigned long *)(desc & TABLE_ADDR_MASK),
+				level + 1);
+			if (rc)
+				return rc;
+			hi = idx + 1;
+			continue;
+		}
+
+		if (desc == INVALID_DESC || va < base_va ||
+		    va + level_size > end_va)
+			return -EPERM;
+
+		if (attr < 0) {
+			hi = idx + 1;
+			continue;
+		}
+
+		/* Entries to rewrite: the whole run if it is contiguous */
+		lo = idx;
+		hi = idx + 1;
+		cont_desc = 0;
+		if (desc & UPPER_ATTRS(CONT_HINT)) {
+			lo = idx & ~(unsigned long)(run - 1);
+			hi = lo + run;
+			cont_desc = table[lo] & ~UPPER_ATTRS(CONT_HINT);
+		}
+
+		for (i = lo; i < hi; i++) {
+			xlat_write_desc(&table[i], INVALID_DESC);
+			xlat_tlbi_va(table_va + (i << level_size_shift));
+		}
+
+		/* Wait for the TLB invalidations to complete */
+		dsbish();
+
+		for (i = lo; i < hi; i++) {
+			if (cont_desc)
+				desc = cont_desc + ((i - lo) << level_size_shift);
+			va = table_va + (i << level_size_shift);
+			if (va >= base_va && va + level_size <= end_va)
+				desc = mmap_desc(attr, desc & TABLE_ADDR_MASK,
+									level);
+			xlat_write_desc(&table[i], desc);
+		}
+	}
+
+	return 0;
+}
+
+int mmap_remap_region(unsigned long base_va, unsigned long size,
+				unsigned attr)
+{
+	mmap_region_t *mm;
+	int rc;
+
+	if (!IS_XLAT_GRANULE_ALIGNED(base_va) ||
+	    !IS_XLAT_GRANULE_ALIGNED(size) || !size || (attr & MT_DYNAMIC) ||
+	    base_va + size - 1 < base_va)
+		return -EINVAL;
+
+	if (!mmap_sorted)
+		return -EPERM;
+
+	/* The area must be either inside or outside of each region */
+	for (mm = mmap; mm->size; ++mm) {
+		if (base_va < mm->base_va + mm->size &&
+		    mm->base_va < base_va + size &&
+		    (base_va < mm->base_va ||
+		     base_va + size > mm->base_va + mm->size))
+			return -EPERM;
+	}
+
+	rc = remap_area(base_va, base_va + size, -1, 0, base_xlation_table,
+							XLAT_BASE_LEVEL);
+	if (rc)
+		return rc;
+
+	remap_area(base_va, base_va + size, attr, 0, base_xlation_table,
+							XLAT_BASE_LEVEL);
+
+	/* Make the new mapping visible to the table walks */
+	dsbish();
+	isb();
+
+	return 0;
+}
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
+
+#if BL31_PREBUILT_XLAT && IMAGE_BL31
+static int mmap_region_equal(const mmap_region_t *a, const mmap_region_t *b)
+{
+	return a->base_pa == b->base_pa && a->base_va == b->base_va &&
+		a->size == b->size && a->attr == b->attr;
+}
+
+static int mmap_region_overlaps(const mmap_region_t *mm)
+{
+	const mmap_region_t *other;
+
+	for (other = mmap; other->size; ++other) {
+		if (other != mm &&
+		    mm->base_va < other->base_va + other->size &&
+		    other->base_va < mm->base_va + mm->size)
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Adopts the translation tables generated at build time if all the regions
+ * they map are in the sorted mmap. The other regions, e.g. the ones only known
+ * at runtime, are then mapped like dynamic regions. This requires
+ * PLAT_XLAT_TABLES_DYNAMIC and that they do not overlap any other region.
+ * Returns 0 if the translation tables must be built at runtime instead.
+ */
+static int xlat_prebuilt_adopt(void)
+{
+	const mmap_region_t *pre = xlat_prebuilt_mmap;
+	mmap_region_t *mm;
+	unsigned int extra = 0;
+
+	/* The tables have not been generated for this image */
+	if (!xlat_prebuilt_tables)
+		return 0;
+
+	for (mm = mmap; mm->size; ++mm) {
+		if (pre->size && mmap_region_equal(mm, pre)) {
+			++pre;
+			continue;
+		}
+
+		if (!PLAT_XLAT_TABLES_DYNAMIC || mmap_region_overlaps(mm))
+			return 0;
+		extra++;
+	}
+
+	if (pre->size)
+		return 0;
+
+	next_xlat = xlat_prebuilt_tables;
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+	for (mm = mmap, pre = xlat_prebuilt_mmap; extra && mm->size; ++mm) {
+		if (pre->size && mmap_region_equal(mm, pre)) {
+			++pre;
+			continue;
+		}
+
+		if (map_dynamic_region(mm, 0, base_xlation_table,
+				       XLAT_BASE_LEVEL)) {
+			/* Out of tables, rebuild them all */
+			memset(xlat_tables_dyn_used, 0,
+			       sizeof(xlat_tables_dyn_used));
+			next_xlat = 0;
+			return 0;
+		}
+	}
+#endif
+
+	INFO("Translation tables generated at build time, %u region(s) "
+	     "added\n", extra);
+	return 1;
+}
+#endif /* BL31_PREBUILT_XLAT && IMAGE_BL31 */
+
+#if DEBUG
+/*
+ * Returns true if the CPU supports the granule size used by the translation
+ * tables.
+ */
+static int xlat_granule_supported(void)
+{
+	uint64_t mmfr0 = read_id_aa64mmfr0_el1();
+	unsigned int shift, supported;
+
+	if (XLAT_GRANULE_SHIFT == SIXTEEN_KB_SHIFT) {
+		shift = ID_AA64MMFR0_TGRAN16_SHIFT;
+		supported = ID_AA64MMFR0_TGRAN16_SUPPORTED;
+	} else if (XLAT_GRANULE_SHIFT == SIXTY_FOUR_KB_SHIFT) {
+		shift = ID_AA64MMFR0_TGRAN64_SHIFT;
+		supported = ID_AA64MMFR0_TGRAN64_SUPPORTED;
+	} else {
+		shift = ID_AA64MMFR0_TGRAN4_SHIFT;
+		supported = ID_AA64MMFR0_TGRAN4_SUPPORTED;
+	}
+
+	return ((mmfr0 >> shift) & ID_AA64MMFR0_TGRAN_MASK) == supported;
+}
+#endif
+
+/*
+ * With XLAT_EARLY_MMU, BL1 and BL2 run with the early translation tables from
+ * their entry point, so the MMU is already enabled when they switch to the
+ * tables built by init_xlat_tables().
+ */
+#if XLAT_EARLY_MMU && (IMAGE_BL1 || IMAGE_BL2)
+#define XLAT_EARLY_TABLES_IN_USE(_el)	(read_sctlr_el##_el() & SCTLR_M_BIT)
+#define XLAT_EARLY_SWITCH(_el, ...)	xlat_early_switch_el##_el(__VA_ARGS__)
+#else
+#define XLAT_EARLY_TABLES_IN_USE(_el)	0
+#define XLAT_EARLY_SWITCH(_el, ...)	panic()
+#endif
+
 /*******************************************************************************
  * Macro generating the code for the function enabling the MMU in the given
  * exception level, assuming that the pagetables have already been created.
@@ -336,9 +1094,13 @@ void init_xlat_tables(void)
 	{								\
 		uint64_t mair, tcr, ttbr;				\
 		uint32_t sctlr;						\
+		int early = XLAT_EARLY_TABLES_IN_USE(_el);		\
 									\
 		assert(IS_IN_EL(_el));					\
-		assert((read_sctlr_el##_el() & SCTLR_M_BIT) == 0);	\
+		assert(early ||						\
+			(read_sctlr_el##_el() & SCTLR_M_BIT) == 0);	\
+		assert(!early || (flags & DISABLE_DCACHE) == 0);	\
+		assert(xlat_granule_supported());			\
 									\
 		/* Set attributes in the right indices of the MAIR */	\
 		mair = MAIR_ATTR_SET(ATTR_DEVICE, ATTR_DEVICE_INDEX);	\
@@ -346,29 +1108,16 @@ void init_xlat_tables(void)
 				ATTR_IWBWA_OWBWA_NTR_INDEX);		\
 		mair |= MAIR_ATTR_SET(ATTR_NON_CACHEABLE,		\
 				ATTR_NON_CACHEABLE_INDEX);		\
-		write_mair_el##_el(mair);				\
-									\
-		/* Invalidate TLBs at the current exception level */	\
-		_tlbi_fct();						\
 									\
 		/* Set TCR bits as well. */				\
 		/* Inner & outer WBWA & shareable + T0SZ = 32 */	\
 		tcr = TCR_SH_INNER_SHAREABLE | TCR_RGN_OUTER_WBA |	\
 			TCR_RGN_INNER_WBA |				\
 			(64 - __builtin_ctzl(ADDR_SPACE_SIZE));		\
-		tcr |= _tcr_extra;					\
-		write_tcr_el##_el(tcr);					\
+		tcr |= XLAT_TCR_TG0 | _tcr_extra;			\
 									\
 		/* Set TTBR bits as well */				\
-		ttbr = (uint64_t) l1_xlation_table;			\
-		write_ttbr0_el##_el(ttbr);				\
-									\
-		/* Ensure all translation table writes have drained */	\
-		/* into memory, the TLB invalidation is complete, */	\
-		/* and translation register writes are committed */	\
-		/* before enabling the MMU */				\
-		dsb();							\
-		isb();							\
+		ttbr = (uint64_t) base_xlation_table;			\
 									\
 		sctlr = read_sctlr_el##_el();				\
 		sctlr |= SCTLR_WXN_BIT | SCTLR_M_BIT;			\
@@ -378,6 +1127,27 @@ void init_xlat_tables(void)
 		else							\
 			sctlr |= SCTLR_C_BIT;				\
 									\
+		/* Replace the early tables in a single step */	\
+		if (early) {						\
+			XLAT_EARLY_SWITCH(_el, ttbr, tcr, mair, sctlr);	\
+			return;						\
+		}							\
+									\
+		write_mair_el##_el(mair);				\
+									\
+		/* Invalidate TLBs at the current exception level */	\
+		_tlbi_fct();						\
+									\
+		write_tcr_el##_el(tcr);					\
+		write_ttbr0_el##_el(ttbr);				\
+									\
+		/* Ensure all translation table writes have drained */	\
+		/* into memory, the TLB invalidation is complete, */	\
+		/* and translation register writes are committed */	\
+		/* before enabling the MMU */				\
+		dsb();							\
+		isb();							\
+									\
 		write_sctlr_el##_el(sctlr);				\
 									\
 		/* Ensure the MMU enable takes effect immediately */	\
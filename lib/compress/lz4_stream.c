@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <lz4_stream.h>
+
+/*
+ * A compressed block is a series of sequences, each made of a token, the
+ * extra bytes of the literal length, the literals, the offset of the match
+ * and the extra bytes of the match length. The last sequence stops after its
+ * literals. A length field of 15 in the token is continued by bytes which are
+ * added to it until one of them is not 255.
+ */
+#define LZ4_RUN_MASK		0xf
+#define LZ4_MIN_MATCH		4
+
+enum {
+	LZ4_STATE_TOKEN,
+	LZ4_STATE_LITERAL_LEN,
+	LZ4_STATE_LITERALS,
+	LZ4_STATE_OFFSET_LOW,
+	LZ4_STATE_OFFSET_HIGH,
+	LZ4_STATE_MATCH_LEN,
+	LZ4_STATE_MATCH,
+	LZ4_STATE_DONE
+};
+
+/*******************************************************************************
+ * Prepare 'stream' to decompress 'out_size' bytes of data at 'out_base'.
+ ******************************************************************************/
+void lz4_stream_init(lz4_stream_t *stream, uintptr_t out_base,
+		     size_t out_size)
+{
+	assert(stream != NULL);
+
+	stream->out_base = out_base;
+	stream->out_size = out_size;
+	stream->out_pos = 0;
+	stream->length = 0;
+	stream->offset = 0;
+	stream->token = 0;
+	stream->state = (out_size == 0) ? LZ4_STATE_DONE : LZ4_STATE_TOKEN;
+}
+
+/*******************************************************************************
+ * Decompress the 'in_len' bytes of compressed data at 'in' until either all of
+ * them have been consumed or 'out_limit' bytes of output have been produced in
+ * total. The number of input bytes consumed is returned in 'in_used'; the
+ * remaining ones must be passed again by the next call. Returns 0 on success or
+ * -EINVAL if the data is corrupted.
+ ******************************************************************************/
+int lz4_stream_decode(lz4_stream_t *stream, const uint8_t *in, size_t in_len,
+		      size_t *in_used, size_t out_limit)
+{
+	const uint8_t *in_start = in;
+	const uint8_t *in_end = in + in_len;
+	uint8_t *out;
+	size_t count;
+	unsigned int byte;
+
+	assert(stream != NULL);
+	assert(in_used != NULL);
+
+	if (out_limit > stream->out_size)
+		out_limit = stream->out_size;
+
+	out = (uint8_t *)(stream->out_base + stream->out_pos);
+
+	for (;;) {
+		switch (stream->state) {
+		case LZ4_STATE_TOKEN:
+			if (in == in_end)
+				goto exit;
+			stream->token = *in++;
+			stream->length = stream->token >> 4;
+			stream->state = (stream->length == LZ4_RUN_MASK) ?
+				LZ4_STATE_LITERAL_LEN : LZ4_STATE_LITERALS;
+			break;
+
+		case LZ4_STATE_LITERAL_LEN:
+			if (in == in_end)
+				goto exit;
+			byte = *in++;
+			stream->length += byte;
+			if (byte != 255)
+				stream->state = LZ4_STATE_LITERALS;
+			break;
+
+		case LZ4_STATE_LITERALS:
+			if (stream->length == 0) {
+				/* The last sequence has no match */
+				stream->state =
+					(stream->out_pos == stream->out_size) ?
+					LZ4_STATE_DONE : LZ4_STATE_OFFSET_LOW;
+				break;
+			}
+			count = stream->length;
+			if (count > (size_t)(in_end - in))
+				count = in_end - in;
+			if (count > out_limit - stream->out_pos)
+				count = out_limit - stream->out_pos;
+			if (count == 0)
+				goto exit;
+			stream->length -= count;
+			stream->out_pos += count;
+			while (count--)
+				*out++ = *in++;
+			break;
+
+		case LZ4_STATE_OFFSET_LOW:
+			if (in == in_end)
+				goto exit;
+			stream->offset = *in++;
+			stream->state = LZ4_STATE_OFFSET_HIGH;
+			break;
+
+		case LZ4_STATE_OFFSET_HIGH:
+			if (in == in_end)
+				goto exit;
+			stream->offset |= (size_t)*in++ << 8;
+			if ((stream->offset == 0) ||
+			    (stream->offset > stream->out_pos))
+				return -EINVAL;
+			stream->length = (stream->token & LZ4_RUN_MASK) +
+					 LZ4_MIN_MATCH;
+			stream->state = ((stream->token & LZ4_RUN_MASK) ==
+					 LZ4_RUN_MASK) ?
+				LZ4_STATE_MATCH_LEN : LZ4_STATE_MATCH;
+			break;
+
+		case LZ4_STATE_MATCH_LEN:
+			if (in == in_end)
+				goto exit;
+			byte = *in++;
+			stream->length += byte;
+			if (byte != 255)
+				stream->state = LZ4_STATE_MATCH;
+			break;
+
+		case LZ4_STATE_MATCH:
+			if (stream->length == 0) {
+				stream->state = LZ4_STATE_TOKEN;
+				break;
+			}
+			count = stream->length;
+			if (count > out_limit - stream->out_pos)
+				count = out_limit - stream->out_pos;
+			if (count == 0)
+				goto exit;
+			stream->length -= count;
+			stream->out_pos += count;
+			/* The match may overlap the bytes it produces */
+			while (count--) {
+				*out = *(out - stream->offset);
+				out++;
+			}
+			break;
+
+		default:
+			goto exit;
+		}
+	}
+
+exit:
+	*in_used = in - in_start;
+	return 0;
+}
@@ -40,6 +40,10 @@ A53_DISABLE_NON_TEMPORAL_HINT	?=1
 # It is enabled by default.
 A57_DISABLE_NON_TEMPORAL_HINT	?=1
 
+# Flag to record the time taken to quiesce and to enable the Denver
+# dynamic code optimizer. It is disabled by default.
+DENVER_DCO_STATS		?=0
+
 # Process SKIP_A57_L1_FLUSH_PWR_DWN flag
 $(eval $(call assert_boolean,SKIP_A57_L1_FLUSH_PWR_DWN))
 $(eval $(call add_define,SKIP_A57_L1_FLUSH_PWR_DWN))
@@ -52,6 +56,10 @@ $(eval $(call add_define,A53_DISABLE_NON_TEMPORAL_HINT))
 $(eval $(call assert_boolean,A57_DISABLE_NON_TEMPORAL_HINT))
 $(eval $(call add_define,A57_DISABLE_NON_TEMPORAL_HINT))
 
+# Process DENVER_DCO_STATS flag
+$(eval $(call assert_boolean,DENVER_DCO_STATS))
+$(eval $(call add_define,DENVER_DCO_STATS))
+
 
 # CPU Errata Build flags. These should be enabled by the
 # platform if the errata needs to be applied.
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <cassert.h>
+#include <debug.h>
+#include <errata_report.h>
+#include <platform.h>
+#include <platform_def.h>
+
+/* Fields of the MIDR which identify the cpu, as matched by the cpu_ops */
+#define MIDR_CPU_MASK	((MIDR_IMPL_MASK << MIDR_IMPL_SHIFT) | \
+			 (MIDR_PN_MASK << MIDR_PN_SHIFT))
+
+/* Linker defined symbols delimiting the errata declared by the cpus */
+extern const cpu_erratum_t __CPU_ERRATA_START__[];
+extern const cpu_erratum_t __CPU_ERRATA_END__[];
+
+/*
+ * Timestamps of the reset handler of each cpu, written by reset_handler. They
+ * are in .data rather than .bss so that the ones of the cold boot survive the
+ * zeroing of .bss.
+ */
+cpu_reset_time_t cpu_reset_times[PLATFORM_CORE_COUNT] __section(".data");
+
+CASSERT(sizeof(cpu_reset_time_t) == CACHE_WRITEBACK_GRANULE,
+	assert_cpu_reset_time_size_mismatch);
+
+/* MIDR of each cpu, or 0 until the cpu has been through BL31 */
+static uint32_t cpu_midr[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * This function returns the variant and revision of 'midr', packed as
+ * variant[4:7] and revision[0:3] as in the cpu_ops reset functions.
+ ******************************************************************************/
+static unsigned int midr_rev(uint32_t midr)
+{
+	return (((midr >> MIDR_VAR_SHIFT) & ((1 << MIDR_VAR_BITS) - 1)) <<
+		MIDR_REV_BITS) |
+	       ((midr >> MIDR_REV_SHIFT) & ((1 << MIDR_REV_BITS) - 1));
+}
+
+/*******************************************************************************
+ * This function returns the status of 'erratum' on a cpu with 'midr'.
+ ******************************************************************************/
+static unsigned int erratum_status(const cpu_erratum_t *erratum, uint32_t midr)
+{
+	unsigned int rev = midr_rev(midr);
+
+	if (rev < erratum->min_rev || rev > erratum->max_rev)
+		return ERRATA_NOT_NEEDED;
+
+	return erratum->enabled ? ERRATA_APPLIED : ERRATA_MISSING;
+}
+
+/*******************************************************************************
+ * This function returns the number of cycles spent by the last reset handler of
+ * the cpu at 'cpu_idx'. They are written with the MMU of that cpu disabled, so
+ * any stale copy in the cache is discarded first.
+ ******************************************************************************/
+static uint64_t cpu_reset_ticks(unsigned int cpu_idx)
+{
+	inv_dcache_range((uintptr_t) &cpu_reset_times[cpu_idx],
+			 sizeof(cpu_reset_time_t));
+
+	return cpu_reset_times[cpu_idx].ticks;
+}
+
+/*******************************************************************************
+ * This function is called by each cpu in BL31 once its data cache is enabled,
+ * on the cold boot and on every warm boot. The first time, it records the MIDR
+ * of the cpu, and prints the status of its errata and the duration of its reset
+ * handler unless another cpu with the same part and revision has already done
+ * so.
+ ******************************************************************************/
+void errata_report_record(void)
+{
+	const cpu_erratum_t *erratum;
+	unsigned int cpu_idx = plat_my_core_pos(), i;
+	uint32_t midr = read_midr();
+
+	if (cpu_midr[cpu_idx] != 0)
+		return;
+
+	cpu_midr[cpu_idx] = midr;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (i != cpu_idx && cpu_midr[i] == midr)
+			return;
+	}
+
+	INFO("BL31: CPU 0x%x r%up%u: reset handler took %lu ticks\n",
+	     (midr >> MIDR_PN_SHIFT) & MIDR_PN_MASK,
+	     midr_rev(midr) >> MIDR_REV_BITS,
+	     midr_rev(midr) & ((1 << MIDR_REV_BITS) - 1),
+	     cpu_reset_ticks(cpu_idx));
+
+	for (erratum = __CPU_ERRATA_START__; erratum < __CPU_ERRATA_END__;
+	     erratum++) {
+		if ((erratum->midr & MIDR_CPU_MASK) != (midr & MIDR_CPU_MASK))
+			continue;
+
+		switch (erratum_status(erratum, midr)) {
+		case ERRATA_APPLIED:
+			INFO("BL31: %s erratum %u: applied\n",
+			     erratum->cpu_name, erratum->id);
+			break;
+		case ERRATA_MISSING:
+			WARN("BL31: %s erratum %u: missing\n",
+			     erratum->cpu_name, erratum->id);
+			break;
+		default:
+			VERBOSE("BL31: %s erratum %u: not needed\n",
+				erratum->cpu_name, erratum->id);
+			break;
+		}
+	}
+}
+
+/*******************************************************************************
+ * This function reads the erratum number 'index' among the errata declared for
+ * the cpu at 'cpu_idx', and the number of cycles its last reset handler took.
+ * It returns 0 on success, or -1 if the cpu has not been through BL31 yet. If
+ * 'index' is not lower than the number of errata of the cpu, 'num_errata' and
+ * 'reset_ticks' are still set but -1 is returned.
+ ******************************************************************************/
+int errata_report_read(unsigned int cpu_idx,
+		       unsigned int index,
+		       unsigned int *id,
+		       unsigned int *status,
+		       uint64_t *reset_ticks,
+		       unsigned int *num_errata)
+{
+	const cpu_erratum_t *erratum;
+	uint32_t midr;
+	unsigned int n = 0;
+	int rc = -1;
+
+	if (cpu_idx >= PLATFORM_CORE_COUNT || cpu_midr[cpu_idx] == 0)
+		return -1;
+
+	midr = cpu_midr[cpu_idx];
+
+	for (erratum = __CPU_ERRATA_START__; erratum < __CPU_ERRATA_END__;
+	     erratum++) {
+		if ((erratum->midr & MIDR_CPU_MASK) != (midr & MIDR_CPU_MASK))
+			continue;
+
+		if (n++ == index) {
+			*id = erratum->id;
+			*status = erratum_status(erratum, midr);
+			rc = 0;
+		}
+	}
+
+	*num_errata = n;
+	*reset_ticks = cpu_reset_ticks(cpu_idx);
+
+	return rc;
+}
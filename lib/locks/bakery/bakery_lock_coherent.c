@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -117,6 +117,10 @@ void bakery_lock_get(bakery_lock_t *bakery)
 	unsigned int they, me;
 	unsigned int my_ticket, my_prio, their_ticket;
 	unsigned int their_bakery_data;
+#if ENABLE_LOCK_PROFILING
+	uint64_t start = read_cntpct_el0();
+	unsigned int contended = 0;
+#endif
 
 	me = plat_my_core_pos();
 
@@ -151,6 +155,9 @@ void bakery_lock_get(bakery_lock_t *bakery)
 			 * to have it dropped to 0; or drop and probably content
 			 * again for the same lock to have an even higher value)
 			 */
+#if ENABLE_LOCK_PROFILING
+			contended = 1;
+#endif
 			do {
 				wfe();
 			} while (their_ticket ==
@@ -158,6 +165,9 @@ void bakery_lock_get(bakery_lock_t *bakery)
 		}
 	}
 	/* Lock acquired */
+#if ENABLE_LOCK_PROFILING
+	lock_profile_update(&bakery->profile[me], start, contended);
+#endif
 }
 
 
@@ -177,3 +187,31 @@ void bakery_lock_release(bakery_lock_t *bakery)
 	dsb();
 	sev();
 }
+
+#if ENABLE_LOCK_PROFILING
+/* Bounds of the bakery locks allocated by the compiler */
+extern void *__BAKERY_LOCK_START__;
+extern void *__BAKERY_LOCK_DATA_END__;
+
+/*
+ * Sum up the contention profiles of each CPU for the 'lock_idx'th bakery lock
+ * of the image, in link order. Returns this lock, or NULL if there is none.
+ * A profile being updated by its CPU may be read partially updated.
+ */
+bakery_lock_t *bakery_lock_read_profile(unsigned int lock_idx,
+					lock_profile_t *profile)
+{
+	bakery_lock_t *bakery = (bakery_lock_t *)&__BAKERY_LOCK_START__;
+	unsigned int cpu;
+
+	bakery += lock_idx;
+	if ((uintptr_t)(bakery + 1) > (uintptr_t)&__BAKERY_LOCK_DATA_END__)
+		return NULL;
+
+	memset(profile, 0, sizeof(*profile));
+	for (cpu = 0; cpu < BAKERY_LOCK_MAX_CPUS; cpu++)
+		lock_profile_add(profile, &bakery->profile[cpu]);
+
+	return bakery;
+}
+#endif
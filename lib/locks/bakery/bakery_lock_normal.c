@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -90,6 +90,33 @@ extern void *__PERCPU_BAKERY_LOCK_SIZE__;
 #define read_cache_op(addr, cached)	if (cached) \
 					    dccivac((uint64_t)addr)
 
+/*
+ * Bounds, in yield instructions, of the exponential backoff between two polls
+ * of the bakery information of a contender that has not changed. Each poll goes
+ * to main memory, with cache maintenance if the data cache is enabled, so
+ * backing off limits the traffic on the interconnect while a contender is
+ * choosing its ticket or while the owner of the lock holds it for long.
+ */
+#define BAKERY_BACKOFF_MIN	8
+#define BAKERY_BACKOFF_MAX	1024
+
+/*
+ * Wait for 'delay' yield instructions and double 'delay', starting from 0 so
+ * that the first poll after the initial one is done immediately.
+ */
+static void bakery_backoff(unsigned int *delay)
+{
+	unsigned int i;
+
+	for (i = 0; i < *delay; i++)
+		yield();
+
+	if (*delay == 0)
+		*delay = BAKERY_BACKOFF_MIN;
+	else if (*delay < BAKERY_BACKOFF_MAX)
+		*delay <<= 1;
+}
+
 static unsigned int bakery_get_ticket(bakery_lock_t *lock,
 						unsigned int me, int is_cached)
 {
@@ -160,10 +187,16 @@ static unsigned int bakery_get_ticket(bakery_lock_t *lock,
 
 void bakery_lock_get(bakery_lock_t *lock)
 {
-	unsigned int they, me, is_cached;
+	unsigned int they, me, is_cached, delay;
 	unsigned int my_ticket, my_prio, their_ticket;
 	bakery_info_t *their_bakery_info;
 	unsigned int their_bakery_data;
+#if ENABLE_LOCK_PROFILING
+	uint64_t start = read_cntpct_el0();
+	unsigned int contended = 0;
+	bakery_info_t *my_bakery_info;
+	lock_profile_t *my_profile;
+#endif
 
 	me = plat_my_core_pos();
 
@@ -189,10 +222,14 @@ void bakery_lock_get(bakery_lock_t *lock)
 		assert(their_bakery_info);
 
 		/* Wait for the contender to get their ticket */
-		do {
+		delay = 0;
+		read_cache_op(their_bakery_info, is_cached);
+		their_bakery_data = their_bakery_info->lock_data;
+		while (bakery_is_choosing(their_bakery_data)) {
+			bakery_backoff(&delay);
 			read_cache_op(their_bakery_info, is_cached);
 			their_bakery_data = their_bakery_info->lock_data;
-		} while (bakery_is_choosing(their_bakery_data));
+		}
 
 		/*
 		 * If the other party is a contender, they'll have non-zero
@@ -205,15 +242,39 @@ void bakery_lock_get(bakery_lock_t *lock)
 			 * their ticket value to change (either release the lock
 			 * to have it dropped to 0; or drop and probably content
 			 * again for the same lock to have an even higher value)
+			 *
+			 * The release of any bakery lock generates an event, so
+			 * the wake-ups which find no change are followed by a
+			 * growing backoff. An event sent during the backoff is
+			 * not lost as it makes the next wfe() return at once.
 			 */
+#if ENABLE_LOCK_PROFILING
+			contended = 1;
+#endif
+			delay = 0;
 			do {
 				wfe();
+				bakery_backoff(&delay);
 				read_cache_op(their_bakery_info, is_cached);
 			} while (their_ticket
 				== bakery_ticket_number(their_bakery_info->lock_data));
 		}
 	}
 	/* Lock acquired */
+
+#if ENABLE_LOCK_PROFILING
+	/*
+	 * As for the lock data, keep the main memory copy of the profile up to
+	 * date so that it can be updated and read with the data cache disabled.
+	 */
+	my_bakery_info = get_bakery_info(me, lock);
+	my_profile = &my_bakery_info->profile;
+	lock_profile_update(my_profile, start, contended);
+	if (is_cached)
+		flush_dcache_range((uint64_t)my_profile, sizeof(*my_profile));
+	else
+		inv_dcache_range((uint64_t)my_profile, sizeof(*my_profile));
+#endif
 }
 
 void bakery_lock_release(bakery_lock_t *lock)
@@ -228,3 +289,39 @@ void bakery_lock_release(bakery_lock_t *lock)
 	write_cache_op(my_bakery_info, is_cached);
 	sev();
 }
+
+#if ENABLE_LOCK_PROFILING
+/* Bounds of the bakery locks allocated by the compiler for the first CPU */
+extern void *__BAKERY_LOCK_START__;
+extern void *__BAKERY_LOCK_DATA_END__;
+
+/*
+ * Sum up the contention profiles of each CPU for the 'lock_idx'th bakery lock
+ * of the image, in link order. Returns this lock, or NULL if there is none.
+ * A profile being updated by its CPU may be read partially updated.
+ */
+bakery_lock_t *bakery_lock_read_profile(unsigned int lock_idx,
+					lock_profile_t *profile)
+{
+	bakery_lock_t *lock = (bakery_lock_t *)&__BAKERY_LOCK_START__;
+	bakery_info_t *their_bakery_info;
+	unsigned int they, is_cached;
+
+	lock += lock_idx;
+	if ((uintptr_t)(lock + 1) > (uintptr_t)&__BAKERY_LOCK_DATA_END__)
+		return NULL;
+
+	is_cached = read_sctlr_el3() & SCTLR_C_BIT;
+
+	memset(profile, 0, sizeof(*profile));
+	for (they = 0; they < BAKERY_LOCK_MAX_CPUS; they++) {
+		their_bakery_info = get_bakery_info(they, lock);
+		if (is_cached)
+			flush_dcache_range((uint64_t)&their_bakery_info->profile,
+					   sizeof(their_bakery_info->profile));
+		lock_profile_add(profile, &their_bakery_info->profile);
+	}
+
+	return lock;
+}
+#endif
@@ -29,6 +29,9 @@
  */
 
 #include <debug.h>
+#if CONSOLE_BUFFERED && IMAGE_BL31
+#include <console_buffer.h>
+#endif
 
 /*
  * This is a basic implementation. This could be improved.
@@ -37,5 +40,8 @@ void __assert (const char *function, const char *file, unsigned int line,
 		const char *assertion)
 {
 	tf_printf("ASSERT: %s <%d> : %s\n", function, line, assertion);
+#if CONSOLE_BUFFERED && IMAGE_BL31
+	console_buffer_flush();
+#endif
 	while(1);
 }
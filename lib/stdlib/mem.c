@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -29,6 +29,23 @@
  */
 
 #include <stddef.h> /* size_t */
+#include <stdint.h>
+
+#if OPTIMISE_MEM_FUNCS
+/*
+ * The optimised routines access the buffers one 64-bit word at a time when the
+ * buffers are (or can be brought) word aligned, since unaligned accesses are not
+ * permitted (-mstrict-align). The word type may alias buffers of any type.
+ */
+typedef uint64_t __attribute__((__may_alias__)) mem_word_t;
+
+#define WORD_SIZE	sizeof(mem_word_t)
+#define WORD_MASK	(WORD_SIZE - 1)
+
+/* True if @a and @b become word aligned after skipping the same byte count */
+#define CO_ALIGNED(a, b)	\
+	((((uintptr_t)(a) ^ (uintptr_t)(b)) & WORD_MASK) == 0)
+#endif /* OPTIMISE_MEM_FUNCS */
 
 /*
  * Fill @count bytes of memory pointed to by @dst with @val
@@ -36,6 +53,35 @@
 void *memset(void *dst, int val, size_t count)
 {
 	char *ptr = dst;
+#if OPTIMISE_MEM_FUNCS
+	mem_word_t *wptr;
+	mem_word_t wval;
+
+	while (count && ((uintptr_t)ptr & WORD_MASK)) {
+		*ptr++ = val;
+		count--;
+	}
+
+	if (count >= WORD_SIZE) {
+		wval = (unsigned char)val;
+		wval |= wval << 8;
+		wval |= wval << 16;
+		wval |= wval << 32;
+
+		wptr = (mem_word_t *)ptr;
+		while (count >= 2 * WORD_SIZE) {
+			wptr[0] = wval;
+			wptr[1] = wval;
+			wptr += 2;
+			count -= 2 * WORD_SIZE;
+		}
+		if (count >= WORD_SIZE) {
+			*wptr++ = wval;
+			count -= WORD_SIZE;
+		}
+		ptr = (char *)wptr;
+	}
+#endif
 
 	while (count--)
 		*ptr++ = val;
@@ -53,6 +99,32 @@ int memcmp(const void *s1, const void *s2, size_t len)
 	char dc;
 	char sc;
 
+#if OPTIMISE_MEM_FUNCS
+	if (CO_ALIGNED(s, d)) {
+		const mem_word_t *ws;
+		const mem_word_t *wd;
+
+		while (len && ((uintptr_t)s & WORD_MASK)) {
+			sc = *s++;
+			dc = *d++;
+			if (sc - dc)
+				return (sc - dc);
+			len--;
+		}
+
+		/* Skip the identical words, the bytes loop finds the difference */
+		ws = (const mem_word_t *)s;
+		wd = (const mem_word_t *)d;
+		while ((len >= WORD_SIZE) && (*ws == *wd)) {
+			ws++;
+			wd++;
+			len -= WORD_SIZE;
+		}
+		s = (const char *)ws;
+		d = (const char *)wd;
+	}
+#endif
+
 	while (len--) {
 		sc = *s++;
 		dc = *d++;
@@ -71,6 +143,34 @@ void *memcpy(void *dst, const void *src, size_t len)
 	const char *s = src;
 	char *d = dst;
 
+#if OPTIMISE_MEM_FUNCS
+	if (CO_ALIGNED(s, d)) {
+		const mem_word_t *ws;
+		mem_word_t *wd;
+
+		while (len && ((uintptr_t)d & WORD_MASK)) {
+			*d++ = *s++;
+			len--;
+		}
+
+		ws = (const mem_word_t *)s;
+		wd = (mem_word_t *)d;
+		while (len >= 2 * WORD_SIZE) {
+			wd[0] = ws[0];
+			wd[1] = ws[1];
+			ws += 2;
+			wd += 2;
+			len -= 2 * WORD_SIZE;
+		}
+		if (len >= WORD_SIZE) {
+			*wd++ = *ws++;
+			len -= WORD_SIZE;
+		}
+		s = (const char *)ws;
+		d = (char *)wd;
+	}
+#endif
+
 	while (len--)
 		*d++ = *s++;
 
@@ -98,6 +198,22 @@ void *memmove(void *dst, const void *src, size_t len)
 		const char *end = dst;
 		const char *s = (const char *)src + len;
 		char *d = (char *)dst + len;
+#if OPTIMISE_MEM_FUNCS
+		if (CO_ALIGNED(s, d)) {
+			const mem_word_t *ws;
+			mem_word_t *wd;
+
+			while ((d != end) && ((uintptr_t)d & WORD_MASK))
+				*--d = *--s;
+
+			ws = (const mem_word_t *)s;
+			wd = (mem_word_t *)d;
+			while ((size_t)((char *)wd - end) >= WORD_SIZE)
+				*--wd = *--ws;
+			s = (const char *)ws;
+			d = (char *)wd;
+		}
+#endif
 		while (d != end)
 			*--d = *--s;
 	}
@@ -30,6 +30,9 @@
 
 #include <stdio.h>
 #include <console.h>
+#if CONSOLE_BUFFERED && IMAGE_BL31
+#include <console_buffer.h>
+#endif
 
 /* Putchar() should either return the character printed or EOF in case of error.
  * Our current console_putc() function assumes success and returns the
@@ -39,7 +42,11 @@
 int putchar(int c)
 {
 	int res;
+#if CONSOLE_BUFFERED && IMAGE_BL31
+	if (console_buffer_putc((unsigned char)c) >= 0)
+#else
 	if (console_putc((unsigned char)c) >= 0)
+#endif
 		res = c;
 	else
 		res = EOF;
@@ -272,6 +272,82 @@ define MAKE_OBJS
 endef
 
 
+# MAKE_XLAT_EARLY generates the early translation tables of BL1 or BL2. The
+# regions of the platform are expanded by the preprocessor with the flags of
+# the image, and built into the generator run on the host.
+#   $(1) = output directory
+#   $(2) = BL stage (1, 2)
+#   $(3) = exception level the image runs at (1, 3)
+define MAKE_XLAT_EARLY
+
+$(eval MMAP := $(1)/xlat_early_mmap.i)
+$(eval GEN := $(1)/xlat_early)
+$(eval SRC := $(1)/xlat_early_tables.c)
+$(eval OBJ := $(1)/xlat_early_tables.o)
+$(eval PREREQUISITES := $(MMAP).d)
+$(eval IMAGE := IMAGE_BL$(call uppercase,$(2)))
+
+$(MMAP): ${XLAT_EARLY_PATH}/xlat_early_mmap.S
+	@echo "  PP      $$<"
+	$$(Q)$$(AS) $$(ASFLAGS) -P -E -D__LINKER__ -D$(IMAGE) -o $$@ $$<
+
+$(PREREQUISITES): ${XLAT_EARLY_PATH}/xlat_early_mmap.S
+	@echo "  DEPS    $$@"
+	@mkdir -p $(1)
+	$$(Q)$$(AS) $$(ASFLAGS) -D$(IMAGE) -M -MT $(MMAP) -MF $$@ $$<
+
+$(GEN): ${XLAT_EARLY_PATH}/xlat_early.c $(MMAP)
+	@echo "  HOSTCC  $$<"
+	$$(Q)$${HOSTCC} -Wall -Werror -std=c99 -Iinclude/lib/aarch64 \
+		-DXLAT_EARLY_INPUT=\"$(abspath $(MMAP))\" $$< -o $$@
+
+$(SRC): $(GEN)
+	@echo "  GEN     $$@"
+	$$(Q)$(GEN) bl$(2) $(3) > $$@ || { rm -f $$@; exit 1; }
+
+$(OBJ): $(SRC)
+	@echo "  CC      $$<"
+	$$(Q)$$(CC) $$(CFLAGS) -D$(IMAGE) -c $$< -o $$@
+
+ifdef IS_ANYTHING_TO_BUILD
+-include $(PREREQUISITES)
+endif
+
+endef
+
+
+# MAKE_XLAT_PREBUILT builds the generator of the translation tables of BL31,
+# which writes them into the image once it is linked. The regions of the
+# platform are expanded by the preprocessor with the flags of the image, and
+# built into the generator run on the host.
+#   $(1) = output directory
+define MAKE_XLAT_PREBUILT
+
+$(eval MMAP := $(1)/xlat_prebuilt_mmap.i)
+$(eval GEN := $(1)/xlat_prebuilt)
+$(eval PREREQUISITES := $(MMAP).d)
+
+$(MMAP): ${XLAT_PREBUILT_PATH}/xlat_prebuilt_mmap.S
+	@echo "  PP      $$<"
+	$$(Q)$$(AS) $$(ASFLAGS) -P -E -D__LINKER__ -DIMAGE_BL31 -o $$@ $$<
+
+$(PREREQUISITES): ${XLAT_PREBUILT_PATH}/xlat_prebuilt_mmap.S
+	@echo "  DEPS    $$@"
+	@mkdir -p $(1)
+	$$(Q)$$(AS) $$(ASFLAGS) -DIMAGE_BL31 -M -MT $(MMAP) -MF $$@ $$<
+
+$(GEN): ${XLAT_PREBUILT_PATH}/xlat_prebuilt.c $(MMAP)
+	@echo "  HOSTCC  $$<"
+	$$(Q)$${HOSTCC} -Wall -Werror -std=c99 -Iinclude/lib/aarch64 \
+		-DXLAT_PREBUILT_INPUT=\"$(abspath $(MMAP))\" $$< -o $$@
+
+ifdef IS_ANYTHING_TO_BUILD
+-include $(PREREQUISITES)
+endif
+
+endef
+
+
 # NOTE: The line continuation '\' is required in the next define otherwise we
 # end up with a line-feed characer at the end of the last c filename.
 # Also bare this issue in mind if extending the list of supported filetypes.
@@ -310,20 +386,31 @@ define MAKE_BL
         $(eval DUMP       := $(call IMG_DUMP,$(1)))
         $(eval BIN        := $(call IMG_BIN,$(1)))
         $(eval BL_LINKERFILE := $(BL$(call uppercase,$(1))_LINKERFILE))
+        $(eval STACK_USAGE := ${BUILD_PLAT}/bl$(1)_stack_usage.txt)
+        $(eval FOOTPRINT_REPORT := ${BUILD_PLAT}/bl$(1)_footprint.txt)
+        $(eval FOOTPRINT_BUDGET := $(BL$(call uppercase,$(1))_FOOTPRINT_BUDGET))
 
         $(eval $(call MAKE_OBJS,$(BUILD_DIR),$(SOURCES),$(1)))
         $(eval $(call MAKE_LD,$(LINKERFILE),$(BL_LINKERFILE)))
 
+        $(if $(filter 1,${XLAT_EARLY_MMU}),$(if $(filter 1 2,$(1)),	\
+                $(eval $(call MAKE_XLAT_EARLY,$(BUILD_DIR),$(1),$(if $(filter 1,$(1)),3,1)))	\
+                $(eval OBJS += $(BUILD_DIR)/xlat_early_tables.o)))
+        $(eval XLAT_PREBUILT := $(if $(filter 1,${BL31_PREBUILT_XLAT}),$(if $(filter 31,$(1)),$(BUILD_DIR)/xlat_prebuilt)))
+        $(if $(XLAT_PREBUILT),$(eval $(call MAKE_XLAT_PREBUILT,$(BUILD_DIR))))
+
 $(BUILD_DIR):
 	$$(Q)mkdir -p "$$@"
 
-$(ELF): $(OBJS) $(LINKERFILE)
+$(ELF): $(OBJS) $(LINKERFILE) $(XLAT_PREBUILT)
 	@echo "  LD      $$@"
 	@echo 'const char build_message[] = "Built : "$(BUILD_MESSAGE_TIMESTAMP); \
 	       const char version_string[] = "${VERSION_STRING}";' | \
 		$$(CC) $$(CFLAGS) -xc - -o $(BUILD_DIR)/build_message.o
 	$$(Q)$$(LD) -o $$@ $$(LDFLAGS) -Map=$(MAPFILE) --script $(LINKERFILE) \
 					$(BUILD_DIR)/build_message.o $(OBJS)
+	$(if $(XLAT_PREBUILT),@echo "  XLAT    $$@")
+	$(if $(XLAT_PREBUILT),$$(Q)$(XLAT_PREBUILT) $$@ || { rm -f $$@; exit 1; })
 
 $(DUMP): $(ELF)
 	@echo "  OD      $$@"
@@ -336,8 +423,32 @@ $(BIN): $(ELF)
 	@echo "Built $$@ successfully"
 	@echo
 
+# List the stack frame of every function of the image, deepest first
+$(STACK_USAGE): $(ELF)
+	@echo "  SU      $$@"
+	$$(Q)cat $(BUILD_DIR)/*.su | sort -t '	' -k2,2nr > $$@
+
+# Break the image down by module and kind of section, and check the budget
+$(FOOTPRINT_REPORT): $(ELF) | ${FOOTPRINT}
+	@echo "  FP      $$@"
+	$$(Q)${FOOTPRINT} $(MAPFILE) $(FOOTPRINT_BUDGET) > $$@ || \
+		{ rm -f $$@; exit 1; }
+
+.PHONY: bl$(1)_footprint
+bl$(1)_footprint: $(FOOTPRINT_REPORT)
+	@cat $$<
+
+footprint: bl$(1)_footprint
+
 .PHONY: bl$(1)
+ifeq (${MEASURE_STACK_USAGE},1)
+bl$(1): $(BUILD_DIR) $(BIN) $(DUMP) $(STACK_USAGE)
+else
 bl$(1): $(BUILD_DIR) $(BIN) $(DUMP)
+endif
+ifneq (${FOOTPRINT_BUDGET},)
+bl$(1): $(FOOTPRINT_REPORT)
+endif
 
 all: bl$(1)
 
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <assert.h>
+#include <bl2u_flash.h>
+#include <errno.h>
+#include <norflash.h>
+#include <plat_arm.h>
+#include <platform_def.h>
+#include <string.h>
+
+/*
+ * NOR flash operations for bl2u_flash_write() on ARM boards. The flash cannot
+ * be read or programmed while a block is being erased, so the erase in
+ * progress is suspended around each access to another block.
+ */
+
+/* Block whose erase is in progress, if nor_erasing is set */
+static uintptr_t nor_erase_addr;
+static int nor_erasing;
+
+static int nor_flash_erase_start(uintptr_t addr)
+{
+	nor_unlock(addr);
+	nor_erase_start(addr);
+	nor_erase_addr = addr;
+	nor_erasing = 1;
+	return 0;
+}
+
+static int nor_flash_erase_poll(uintptr_t addr)
+{
+	int ret;
+
+	ret = nor_erase_poll(addr);
+	if (ret != -EBUSY)
+		nor_erasing = 0;
+
+	return ret;
+}
+
+/* Suspend the erase in progress, if any. Return whether to resume it. */
+static int nor_flash_suspend(void)
+{
+	return nor_erasing ? nor_erase_suspend(nor_erase_addr) : 0;
+}
+
+static void nor_flash_resume(int suspended)
+{
+	if (suspended)
+		nor_erase_resume(nor_erase_addr);
+}
+
+static int nor_flash_program(uintptr_t addr, const void *data, size_t size)
+{
+	size_t words = size / sizeof(uint32_t);
+	size_t tail = size % sizeof(uint32_t);
+	uint32_t last = 0xffffffff;
+	int suspended, ret;
+
+	assert(((addr | (uintptr_t)data) & (sizeof(uint32_t) - 1)) == 0);
+
+	suspended = nor_flash_suspend();
+
+	ret = nor_buffer_program(addr, data, words);
+
+	/* Pad a partial last word with the erased value */
+	if ((ret == 0) && (tail != 0)) {
+		memcpy(&last, (const uint32_t *)data + words, tail);
+		ret = nor_word_program(addr + words * sizeof(uint32_t), last);
+	}
+
+	nor_flash_resume(suspended);
+	return ret;
+}
+
+static int nor_flash_verify(uintptr_t addr, const void *data, size_t size)
+{
+	int suspended, ret;
+
+	suspended = nor_flash_suspend();
+	ret = memcmp((const void *)addr, data, size) ? -EIO : 0;
+	nor_flash_resume(suspended);
+
+	return ret;
+}
+
+const bl2u_flash_ops_t arm_nor_flash_ops = {
+	.block_size = PLAT_ARM_NVM_BLOCK_SIZE,
+	.erase_start = nor_flash_erase_start,
+	.erase_poll = nor_flash_erase_poll,
+	.program = nor_flash_program,
+	.verify = nor_flash_verify,
+};
@@ -38,6 +38,9 @@ BL1_SOURCES		+=	plat/arm/board/common/drivers/norflash/norflash.c
 
 BL2_SOURCES		+=	plat/arm/board/common/drivers/norflash/norflash.c
 
+BL2U_SOURCES		+=	plat/arm/board/common/board_arm_bl2u_flash.c		\
+				plat/arm/board/common/drivers/norflash/norflash.c
+
 #BL31_SOURCES		+=
 
 ifneq (${TRUSTED_BOARD_BOOT},0)
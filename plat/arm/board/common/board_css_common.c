@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -43,7 +43,7 @@ const mmap_region_t plat_arm_mmap[] = {
 	CSS_MAP_DEVICE,
 	SOC_CSS_MAP_DEVICE,
 #if TRUSTED_BOARD_BOOT
-	ARM_MAP_NS_DRAM1,
+	ARM_MAP_NS_DRAM1_RO,
 #endif
 	{0}
 };
@@ -57,6 +57,9 @@ const mmap_region_t plat_arm_mmap[] = {
 	SOC_CSS_MAP_DEVICE,
 	ARM_MAP_NS_DRAM1,
 	ARM_MAP_TSP_SEC_MEM,
+#if CSS_SCP_BL2_DRAM_XFER
+	CSS_MAP_SCP_TZC_DRAM1,
+#endif
 	{0}
 };
 #endif
@@ -70,10 +73,7 @@ const mmap_region_t plat_arm_mmap[] = {
 #endif
 #if IMAGE_BL31
 const mmap_region_t plat_arm_mmap[] = {
-	ARM_MAP_SHARED_RAM,
-	V2M_MAP_IOFPGA,
-	CSS_MAP_DEVICE,
-	SOC_CSS_MAP_DEVICE,
+	BOARD_CSS_BL31_MMAP,
 	{0}
 };
 #endif
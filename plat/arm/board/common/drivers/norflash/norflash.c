@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -28,12 +28,14 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <assert.h>
 #include <errno.h>
 #include <mmio.h>
 #include <norflash.h>
+#include <stddef.h>
 
 /* Helper macros to access two flash banks in parallel */
-#define NOR_2X16(d)			((d << 16) | (d & 0xffff))
+#define NOR_2X16(d)			(((d) << 16) | ((d) & 0xffff))
 
 /*
  * DWS ready poll retries. The number of retries in this driver have been
@@ -41,6 +43,8 @@
  * model
  */
 #define DWS_WORD_PROGRAM_RETRIES	1000
+#define DWS_BUFFER_PROGRAM_RETRIES	(DWS_WORD_PROGRAM_RETRIES *	\
+					 NOR_BUFFER_WORDS)
 
 /*
  * Poll Write State Machine. Return values:
@@ -74,6 +78,26 @@ void nor_send_cmd(uintptr_t base_addr, unsigned long cmd)
 	mmio_write_32(base_addr, NOR_2X16(cmd));
 }
 
+/*
+ * Check the status of the last program operation. Return values:
+ *    0      = success
+ *    -EPERM = Device protected or Block locked
+ */
+static int nor_full_status_check(uintptr_t base_addr)
+{
+	uint32_t status;
+
+	nor_send_cmd(base_addr, NOR_CMD_READ_STATUS_REG);
+	status = mmio_read_32(base_addr);
+
+	if (status & (NOR_PS | NOR_BLS)) {
+		nor_send_cmd(base_addr, NOR_CMD_CLEAR_STATUS_REG);
+		return -EPERM;
+	}
+
+	return 0;
+}
+
 /*
  * Return values:
  *    0      = success
@@ -82,7 +106,6 @@ void nor_send_cmd(uintptr_t base_addr, unsigned long cmd)
  */
 int nor_word_program(uintptr_t base_addr, unsigned long data)
 {
-	uint32_t status;
 	int ret;
 
 	/* Set the device in write word mode */
@@ -90,24 +113,176 @@ int nor_word_program(uintptr_t base_addr, unsigned long data)
 	mmio_write_32(base_addr, data);
 
 	ret = nor_poll_dws(base_addr, DWS_WORD_PROGRAM_RETRIES);
-	if (ret != 0) {
-		goto word_program_end;
+	if (ret == 0) {
+		ret = nor_full_status_check(base_addr);
 	}
 
-	/* Full status check */
+	nor_send_cmd(base_addr, NOR_CMD_READ_ARRAY);
+	return ret;
+}
+
+/*
+ * Program up to a write buffer of words at 'base_addr', which must not cross
+ * a buffer aligned boundary, and wait for the operation to complete.
+ */
+static int nor_buffer_program_one(uintptr_t base_addr, const uint32_t *data,
+				  unsigned int num_words)
+{
+	unsigned int retries = DWS_WORD_PROGRAM_RETRIES;
+	uint32_t status;
+	unsigned int i;
+	int ret;
+
+	/* Wait for a write buffer to be available */
+	for (;;) {
+		nor_send_cmd(base_addr, NOR_CMD_WRITE_TO_BUFFER);
+		status = mmio_read_32(base_addr);
+		if ((status & NOR_DWS) && (status & (NOR_DWS << 16))) {
+			break;
+		}
+		if (retries-- == 0) {
+			return -EBUSY;
+		}
+	}
+
+	/* Word count minus one, then the data, then the confirmation */
+	mmio_write_32(base_addr, NOR_2X16(num_words - 1));
+	for (i = 0; i < num_words; i++) {
+		mmio_write_32(base_addr + i * sizeof(uint32_t), data[i]);
+	}
+	nor_send_cmd(base_addr, NOR_BUFFER_PROGRAM_CONFIRM);
+
+	/* A single status poll for the whole buffer */
+	ret = nor_poll_dws(base_addr, DWS_BUFFER_PROGRAM_RETRIES);
+	if (ret == 0) {
+		ret = nor_full_status_check(base_addr);
+	}
+
+	return ret;
+}
+
+/*
+ * Program 'num_words' words from 'data' at the word aligned 'base_addr', using
+ * the write buffer of the flash. The data is split at the buffer aligned
+ * boundaries. Return values:
+ *    0      = success
+ *    -EBUSY = WSM not ready
+ *    -EPERM = Device protected or Block locked
+ */
+int nor_buffer_program(uintptr_t base_addr, const uint32_t *data,
+		       unsigned int num_words)
+{
+	unsigned int chunk;
+	uintptr_t start = base_addr;
+	int ret = 0;
+
+	assert((base_addr & (sizeof(uint32_t) - 1)) == 0);
+	assert((data != NULL) || (num_words == 0));
+
+	while (num_words != 0) {
+		/* Words left up to the next buffer aligned boundary */
+		chunk = (base_addr & (NOR_BUFFER_SIZE - 1)) / sizeof(uint32_t);
+		chunk = NOR_BUFFER_WORDS - chunk;
+		if (chunk > num_words) {
+			chunk = num_words;
+		}
+
+		ret = nor_buffer_program_one(base_addr, data, chunk);
+		if (ret != 0) {
+			break;
+		}
+
+		base_addr += chunk * sizeof(uint32_t);
+		data += chunk;
+		num_words -= chunk;
+	}
+
+	nor_send_cmd(start, NOR_CMD_READ_ARRAY);
+	return ret;
+}
+
+/*
+ * Start erasing the block at 'base_addr' and return without waiting for the
+ * erase to complete. The block must be unlocked.
+ */
+void nor_erase_start(uintptr_t base_addr)
+{
+	nor_send_cmd(base_addr, NOR_CMD_BLOCK_ERASE);
+	nor_send_cmd(base_addr, NOR_BLOCK_ERASE_CONFIRM);
+}
+
+/*
+ * Check the progress of the erase started at 'base_addr'. Return values:
+ *    0      = erase complete, the flash is back in read array mode
+ *    -EBUSY = erase in progress
+ *    -EPERM = Device protected or Block locked
+ *    -EIO   = erase failure
+ */
+int nor_erase_poll(uintptr_t base_addr)
+{
+	uint32_t status;
+	int ret = 0;
+
 	nor_send_cmd(base_addr, NOR_CMD_READ_STATUS_REG);
 	status = mmio_read_32(base_addr);
+	if (!(status & NOR_DWS) || !(status & (NOR_DWS << 16))) {
+		return -EBUSY;
+	}
 
-	if (status & (NOR_PS | NOR_BLS)) {
-		nor_send_cmd(base_addr, NOR_CMD_CLEAR_STATUS_REG);
+	if (status & ((NOR_PS | NOR_BLS) | ((NOR_PS | NOR_BLS) << 16))) {
 		ret = -EPERM;
+	} else if (status & (NOR_ES | (NOR_ES << 16))) {
+		ret = -EIO;
+	}
+	if (ret != 0) {
+		nor_send_cmd(base_addr, NOR_CMD_CLEAR_STATUS_REG);
 	}
 
-word_program_end:
 	nor_send_cmd(base_addr, NOR_CMD_READ_ARRAY);
 	return ret;
 }
 
+/*
+ * Erase the block at 'base_addr' and wait for the erase to complete. Return
+ * values are those of nor_erase_poll(), except -EBUSY.
+ */
+int nor_erase(uintptr_t base_addr)
+{
+	int ret;
+
+	nor_erase_start(base_addr);
+	do {
+		ret = nor_erase_poll(base_addr);
+	} while (ret == -EBUSY);
+
+	return ret;
+}
+
+/*
+ * Suspend the erase started at 'base_addr' so that other blocks can be read
+ * or programmed. Return 1 if the erase has been suspended, and must then be
+ * resumed with nor_erase_resume(), or 0 if it had already completed.
+ */
+int nor_erase_suspend(uintptr_t base_addr)
+{
+	uint32_t status;
+
+	nor_send_cmd(base_addr, NOR_CMD_SUSPEND);
+	do {
+		nor_send_cmd(base_addr, NOR_CMD_READ_STATUS_REG);
+		status = mmio_read_32(base_addr);
+	} while (!(status & NOR_DWS) || !(status & (NOR_DWS << 16)));
+
+	nor_send_cmd(base_addr, NOR_CMD_READ_ARRAY);
+	return (status & (NOR_ESS | (NOR_ESS << 16))) ? 1 : 0;
+}
+
+/* Resume an erase suspended by nor_erase_suspend() */
+void nor_erase_resume(uintptr_t base_addr)
+{
+	nor_send_cmd(base_addr, NOR_CMD_RESUME);
+}
+
 void nor_lock(uintptr_t base_addr)
 {
 	nor_send_cmd(base_addr, NOR_CMD_LOCK_UNLOCK);
@@ -55,19 +55,6 @@ extern gicv2_driver_data_t arm_gic_data;
  ******************************************************************************/
 arm_config_t arm_config;
 
-#define MAP_DEVICE0	MAP_REGION_FLAT(DEVICE0_BASE,			\
-					DEVICE0_SIZE,			\
-					MT_DEVICE | MT_RW | MT_SECURE)
-
-#define MAP_DEVICE1	MAP_REGION_FLAT(DEVICE1_BASE,			\
-					DEVICE1_SIZE,			\
-					MT_DEVICE | MT_RW | MT_SECURE)
-
-#define MAP_DEVICE2	MAP_REGION_FLAT(DEVICE2_BASE,			\
-					DEVICE2_SIZE,			\
-					MT_DEVICE | MT_RO | MT_SECURE)
-
-
 /*
  * Table of regions for various BL stages to map using the MMU.
  * This doesn't include TZRAM as the 'mem_layout' argument passed to
@@ -76,13 +63,18 @@ arm_config_t arm_config;
 #if IMAGE_BL1
 const mmap_region_t plat_arm_mmap[] = {
 	ARM_MAP_SHARED_RAM,
+#if FVP_NOR_FIP_CACHED
+	V2M_MAP_FLASH0_CMD,
+	V2M_MAP_FLASH0_DATA_RO,
+#else
 	V2M_MAP_FLASH0_RW,
+#endif
 	V2M_MAP_IOFPGA,
 	MAP_DEVICE0,
 	MAP_DEVICE1,
 	MAP_DEVICE2,
 #if TRUSTED_BOARD_BOOT
-	ARM_MAP_NS_DRAM1,
+	ARM_MAP_NS_DRAM1_RO,
 #endif
 	{0}
 };
@@ -90,7 +82,12 @@ const mmap_region_t plat_arm_mmap[] = {
 #if IMAGE_BL2
 const mmap_region_t plat_arm_mmap[] = {
 	ARM_MAP_SHARED_RAM,
+#if FVP_NOR_FIP_CACHED
+	V2M_MAP_FLASH0_CMD,
+	V2M_MAP_FLASH0_DATA_RO,
+#else
 	V2M_MAP_FLASH0_RW,
+#endif
 	V2M_MAP_IOFPGA,
 	MAP_DEVICE0,
 	MAP_DEVICE1,
@@ -112,10 +109,7 @@ const mmap_region_t plat_arm_mmap[] = {
 #endif
 #if IMAGE_BL31
 const mmap_region_t plat_arm_mmap[] = {
-	ARM_MAP_SHARED_RAM,
-	V2M_MAP_IOFPGA,
-	MAP_DEVICE0,
-	MAP_DEVICE1,
+	FVP_BL31_MMAP,
 	{0}
 };
 #endif
@@ -244,6 +238,18 @@ void fvp_interconnect_enable(void)
 		plat_arm_interconnect_enter_coherency();
 }
 
+void fvp_interconnect_enable_async(void)
+{
+	if (arm_config.flags & ARM_CONFIG_HAS_INTERCONNECT)
+		plat_arm_interconnect_enter_coherency_async();
+}
+
+void fvp_interconnect_wait(void)
+{
+	if (arm_config.flags & ARM_CONFIG_HAS_INTERCONNECT)
+		plat_arm_interconnect_wait_coherency();
+}
+
 void fvp_interconnect_disable(void)
 {
 	if (arm_config.flags & ARM_CONFIG_HAS_INTERCONNECT)
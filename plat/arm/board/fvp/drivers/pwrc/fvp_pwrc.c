@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -93,6 +93,24 @@ void fvp_pwrc_write_pcoffr(unsigned long mpidr)
 	arm_lock_release();
 }
 
+/*
+ * Program the power controller to power off the cpu 'mpidr' and, if 'flags'
+ * has PWRC_PD_CLUSTER, its cluster when it next enters wfi. PWRC_PD_WEN also
+ * enables the wakeup interrupts of the cpu. The registers are written in one
+ * go under a single acquisition of the lock.
+ */
+void fvp_pwrc_power_down(unsigned long mpidr, unsigned int flags)
+{
+	arm_lock_get();
+	if (flags & PWRC_PD_WEN)
+		mmio_write_32(PWRC_BASE + PWKUPR_OFF,
+			      (unsigned int) (PWKUPR_WEN | mpidr));
+	mmio_write_32(PWRC_BASE + PPOFFR_OFF, (unsigned int) mpidr);
+	if (flags & PWRC_PD_CLUSTER)
+		mmio_write_32(PWRC_BASE + PCOFFR_OFF, (unsigned int) mpidr);
+	arm_lock_release();
+}
+
 /* Nothing else to do here apart from initializing the lock */
 void plat_arm_pwrc_setup(void)
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -59,6 +59,10 @@
 
 #define PSYSR_INVALID		0xffffffff
 
+/* Flags of fvp_pwrc_power_down() */
+#define PWRC_PD_WEN		(1 << 0)	/* Enable wakeup interrupts */
+#define PWRC_PD_CLUSTER		(1 << 1)	/* Also power off the cluster */
+
 #ifndef __ASSEMBLY__
 
 /*******************************************************************************
@@ -71,6 +75,7 @@ void fvp_pwrc_set_wen(unsigned long);
 void fvp_pwrc_clr_wen(unsigned long);
 unsigned int fvp_pwrc_read_psysr(unsigned long);
 unsigned int fvp_pwrc_get_cpu_wkr(unsigned long);
+void fvp_pwrc_power_down(unsigned long, unsigned int);
 
 #endif /*__ASSEMBLY__*/
 
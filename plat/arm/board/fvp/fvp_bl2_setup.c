@@ -28,10 +28,14 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <arch_helpers.h>
+#include <cassert.h>
 #include <mmio.h>
 #include <plat_arm.h>
+#include <platform.h>
 #include <sp804_delay_timer.h>
 #include <v2m_def.h>
+#include "drivers/pwrc/fvp_pwrc.h"
 #include "fvp_def.h"
 #include "fvp_private.h"
 
@@ -56,3 +60,36 @@ void bl2_platform_setup(void)
 	sp804_timer_init(V2M_SP804_TIMER0_BASE,
 			SP804_TIMER_CLKMULT, SP804_TIMER_CLKDIV);
 }
+
+#if BL2_PARALLEL_LOAD
+CASSERT(FVP_BL2_HELPER_CPUS < FVP_MAX_CPUS_PER_CLUSTER,
+	assert_fvp_bl2_helper_cpus_in_cluster_0);
+
+/*******************************************************************************
+ * Release the helper cpus held in BL1 (see plat_secondary_cold_boot_setup()) by
+ * writing 'entrypoint' in their mailbox once they are waiting there. The cpus
+ * which the model has been configured without are skipped. BL2 is the only
+ * user of the power controller at this point, so no lock is needed.
+ ******************************************************************************/
+unsigned int bl2_plat_release_helper_cpus(uintptr_t entrypoint)
+{
+	uintptr_t mailbox = FVP_BL2_HELPER_MAILBOX_BASE;
+	unsigned int i;
+
+	for (i = 0; i < FVP_BL2_HELPER_CPUS; i++, mailbox += sizeof(uint64_t)) {
+		mmio_write_32(PWRC_BASE + PSYSR_OFF, i + 1);
+		if (mmio_read_32(PWRC_BASE + PSYSR_OFF) == PSYSR_INVALID)
+			break;
+
+		while (mmio_read_64(mailbox) != FVP_BL2_HELPER_READY)
+			wfe();
+		mmio_write_64(mailbox, entrypoint);
+	}
+
+	/* The mailboxes are mapped as Device memory */
+	dsbsy();
+	sev();
+
+	return i;
+}
+#endif
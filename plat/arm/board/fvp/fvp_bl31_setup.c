@@ -32,7 +32,7 @@
 #include "fvp_private.h"
 
 
-void bl31_early_platform_setup(bl31_params_t *from_bl2,
+void __init bl31_early_platform_setup(bl31_params_t *from_bl2,
 				void *plat_params_from_bl2)
 {
 	arm_bl31_early_platform_setup(from_bl2, plat_params_from_bl2);
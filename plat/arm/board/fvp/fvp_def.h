@@ -40,6 +40,16 @@
 
 #define FVP_PRIMARY_CPU			0x0
 
+/*
+ * With BL2_PARALLEL_LOAD, BL1 holds the first FVP_BL2_HELPER_CPUS secondary
+ * cpus of cluster 0 in a pen until BL2 releases them to help with image
+ * loading. Each of them has a mailbox in the shared memory, after the trusted
+ * mailbox, in which it writes FVP_BL2_HELPER_READY while it waits.
+ */
+#define FVP_BL2_HELPER_CPUS		2
+#define FVP_BL2_HELPER_MAILBOX_BASE	(ARM_SHARED_RAM_BASE + 0x8)
+#define FVP_BL2_HELPER_READY		0x1
+
 /*******************************************************************************
  * FVP memory map related constants
  ******************************************************************************/
@@ -64,6 +74,24 @@
 #define DEVICE2_BASE			0x7fe00000
 #define DEVICE2_SIZE			0x00200000
 
+#define MAP_DEVICE0	MAP_REGION_FLAT(DEVICE0_BASE,			\
+					DEVICE0_SIZE,			\
+					MT_DEVICE | MT_RW | MT_SECURE)
+
+#define MAP_DEVICE1	MAP_REGION_FLAT(DEVICE1_BASE,			\
+					DEVICE1_SIZE,			\
+					MT_DEVICE | MT_RW | MT_SECURE)
+
+#define MAP_DEVICE2	MAP_REGION_FLAT(DEVICE2_BASE,			\
+					DEVICE2_SIZE,			\
+					MT_DEVICE | MT_RO | MT_SECURE)
+
+/* Regions of the platform mapped by BL31 */
+#define FVP_BL31_MMAP	ARM_MAP_SHARED_RAM,				\
+			V2M_MAP_IOFPGA,					\
+			MAP_DEVICE0,					\
+			MAP_DEVICE1
+
 #define NSRAM_BASE			0x2e000000
 #define NSRAM_SIZE			0x10000
 
@@ -66,30 +66,25 @@ const unsigned int arm_pm_idle_states[] = {
 
 /*******************************************************************************
  * Function which implements the common FVP specific operations to power down a
- * cpu in response to a CPU_OFF or CPU_SUSPEND request.
+ * cpu, and its cluster if 'target_state' requires it, in response to a CPU_OFF
+ * or CPU_SUSPEND request. 'pwrc_flags' holds any further PWRC_PD_* flag for
+ * the power controller, which is programmed in one go.
  ******************************************************************************/
-static void fvp_cpu_pwrdwn_common(void)
+static void fvp_pwrdwn_common(const psci_power_state_t *target_state,
+			      unsigned int pwrc_flags)
 {
 	/* Prevent interrupts from spuriously waking up this cpu */
 	plat_arm_gic_cpuif_disable();
 
-	/* Program the power controller to power off this cpu. */
-	fvp_pwrc_write_ppoffr(read_mpidr_el1());
-}
-
-/*******************************************************************************
- * Function which implements the common FVP specific operations to power down a
- * cluster in response to a CPU_OFF or CPU_SUSPEND request.
- ******************************************************************************/
-static void fvp_cluster_pwrdwn_common(void)
-{
-	uint64_t mpidr = read_mpidr_el1();
-
-	/* Disable coherency if this cluster is to be turned off */
-	fvp_interconnect_disable();
+	if (target_state->pwr_domain_state[ARM_PWR_LVL1] ==
+					ARM_LOCAL_STATE_OFF) {
+		/* Disable coherency if this cluster is to be turned off */
+		fvp_interconnect_disable();
+		pwrc_flags |= PWRC_PD_CLUSTER;
+	}
 
-	/* Program the power controller to turn the cluster off */
-	fvp_pwrc_write_pcoffr(mpidr);
+	/* Program the power controller to power off this cpu and cluster */
+	fvp_pwrc_power_down(read_mpidr_el1(), pwrc_flags);
 }
 
 static void fvp_power_domain_on_finish_common(const psci_power_state_t *target_state)
@@ -116,8 +111,11 @@ static void fvp_power_domain_on_finish_common(const psci_power_state_t *target_s
 		 */
 		fvp_pwrc_write_pponr(mpidr);
 
-		/* Enable coherency if this cluster was off */
-		fvp_interconnect_enable();
+		/*
+		 * Enable coherency if this cluster was off. The finisher waits
+		 * for it only once it is done with the rest of its work.
+		 */
+		fvp_interconnect_enable_async();
 	}
 
 	/*
@@ -180,12 +178,7 @@ void fvp_pwr_domain_off(const psci_power_state_t *target_state)
 	 * suspended. Perform at least the cpu specific actions followed
 	 * by the cluster specific operations if applicable.
 	 */
-	fvp_cpu_pwrdwn_common();
-
-	if (target_state->pwr_domain_state[ARM_PWR_LVL1] ==
-					ARM_LOCAL_STATE_OFF)
-		fvp_cluster_pwrdwn_common();
-
+	fvp_pwrdwn_common(target_state, 0);
 }
 
 /*******************************************************************************
@@ -194,8 +187,6 @@ void fvp_pwr_domain_off(const psci_power_state_t *target_state)
  ******************************************************************************/
 void fvp_pwr_domain_suspend(const psci_power_state_t *target_state)
 {
-	unsigned long mpidr;
-
 	/*
 	 * FVP has retention only at cpu level. Just return
 	 * as nothing is to be done for retention.
@@ -207,19 +198,11 @@ void fvp_pwr_domain_suspend(const psci_power_state_t *target_state)
 	assert(target_state->pwr_domain_state[ARM_PWR_LVL0] ==
 					ARM_LOCAL_STATE_OFF);
 
-	/* Get the mpidr for this cpu */
-	mpidr = read_mpidr_el1();
-
-	/* Program the power controller to enable wakeup interrupts. */
-	fvp_pwrc_set_wen(mpidr);
-
-	/* Perform the common cpu specific operations */
-	fvp_cpu_pwrdwn_common();
-
-	/* Perform the common cluster specific operations */
-	if (target_state->pwr_domain_state[ARM_PWR_LVL1] ==
-					ARM_LOCAL_STATE_OFF)
-		fvp_cluster_pwrdwn_common();
+	/*
+	 * Perform the common cpu and cluster specific operations, also
+	 * programming the power controller to enable wakeup interrupts.
+	 */
+	fvp_pwrdwn_common(target_state, PWRC_PD_WEN);
 }
 
 /*******************************************************************************
@@ -236,6 +219,10 @@ void fvp_pwr_domain_on_finish(const psci_power_state_t *target_state)
 
 	/* Program the gic per-cpu distributor or re-distributor interface */
 	plat_arm_gic_cpuif_enable();
+
+	if (target_state->pwr_domain_state[ARM_PWR_LVL1] ==
+					ARM_LOCAL_STATE_OFF)
+		fvp_interconnect_wait();
 }
 
 /*******************************************************************************
@@ -258,6 +245,10 @@ void fvp_pwr_domain_suspend_finish(const psci_power_state_t *target_state)
 
 	/* Enable the gic cpu interface */
 	plat_arm_gic_cpuif_enable();
+
+	if (target_state->pwr_domain_state[ARM_PWR_LVL1] ==
+					ARM_LOCAL_STATE_OFF)
+		fvp_interconnect_wait();
 }
 
 /*******************************************************************************
@@ -41,6 +41,8 @@ void fvp_config_setup(void);
 
 void fvp_interconnect_init(void);
 void fvp_interconnect_enable(void);
+void fvp_interconnect_enable_async(void);
+void fvp_interconnect_wait(void);
 void fvp_interconnect_disable(void);
 
 
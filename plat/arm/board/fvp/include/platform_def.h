@@ -43,6 +43,7 @@
 					PLATFORM_CORE_COUNT)
 #define PLAT_MAX_PWR_LVL		ARM_PWR_LVL1
 #define PLATFORM_CORE_COUNT		(FVP_CLUSTER_COUNT * FVP_MAX_CPUS_PER_CLUSTER)
+#define PLAT_PSCI_CPUS_PER_CLUSTER	FVP_MAX_CPUS_PER_CLUSTER
 
 /*
  * Other platform porting definitions are provided by included headers
@@ -59,6 +60,22 @@
 #define PLAT_ARM_TRUSTED_DRAM_BASE	0x06000000
 #define PLAT_ARM_TRUSTED_DRAM_SIZE	0x02000000	/* 32 MB */
 
+#if FVP_NOR_FIP_CACHED && (IMAGE_BL1 || IMAGE_BL2) && !ARM_BOARD_OPTIMISE_MMAP
+/* The split mapping of the FIP flash needs one more translation table */
+#undef MAX_XLAT_TABLES
+#define MAX_XLAT_TABLES			6
+#endif
+
+/* Regions of the early translation tables of BL1 and BL2 */
+#define PLAT_XLAT_EARLY_MMAP		ARM_XLAT_EARLY_MMAP,		\
+					V2M_MAP_IOFPGA,			\
+					MAP_DEVICE0,			\
+					MAP_DEVICE1
+
+/* Regions of the translation tables of BL31 generated at build time */
+#define PLAT_XLAT_PREBUILT_MMAP		ARM_BL31_PREBUILT_MMAP,		\
+					FVP_BL31_MMAP
+
 /* No SCP in FVP */
 #define PLAT_ARM_SCP_TZC_DRAM1_SIZE	MAKE_ULL(0x0)
 
@@ -136,11 +153,22 @@
  * terminology. On a GICv2 system or mode, the lists will be merged and treated
  * as Group 0 interrupts.
  */
+#if EL3_HANG_DETECT
+#define PLAT_ARM_G1S_IRQS		ARM_G1S_IRQS,			\
+					FVP_IRQ_SEC_SYS_TIMER
+
+#define PLAT_ARM_G0_IRQS		ARM_G0_IRQS,			\
+					FVP_IRQ_TZ_WDOG
+#else
 #define PLAT_ARM_G1S_IRQS		ARM_G1S_IRQS,			\
 					FVP_IRQ_TZ_WDOG,		\
 					FVP_IRQ_SEC_SYS_TIMER
 
 #define PLAT_ARM_G0_IRQS		ARM_G0_IRQS
+#endif
+
+/* Trusted watchdog interrupt, handled by BL31 if EL3_HANG_DETECT is set */
+#define PLAT_ARM_TWDG_IRQ		FVP_IRQ_TZ_WDOG
 
 /*
  * PLAT_ARM_MAX_BL1_RW_SIZE is calculated using the current BL1 RW debug size
@@ -164,4 +192,10 @@
  */
 #define PLAT_ARM_MAX_BL31_SIZE		0x1D000
 
+/*
+ * PLAT_ARM_MAX_BL31_COLD_SIZE is the size of the TZC secured DRAM reserved for
+ * the cold code and read-only data of BL31 when BL31_SPLIT_COLD is set.
+ */
+#define PLAT_ARM_MAX_BL31_COLD_SIZE	0x10000
+
 #endif /* __PLATFORM_DEF_H__ */
@@ -34,6 +34,11 @@ FVP_USE_GIC_DRIVER	:= FVP_GICV3_LEGACY
 # The FVP platform depends on this macro to build with correct GIC driver.
 $(eval $(call add_define,FVP_USE_GIC_DRIVER))
 
+# Read the FIP from NOR flash through the caches in BL1 and BL2
+FVP_NOR_FIP_CACHED	:= 0
+$(eval $(call assert_boolean,FVP_NOR_FIP_CACHED))
+$(eval $(call add_define,FVP_NOR_FIP_CACHED))
+
 # If FVP_CLUSTER_COUNT has been defined, pass it into the build system.
 ifdef FVP_CLUSTER_COUNT
 $(eval $(call add_define,FVP_CLUSTER_COUNT))
@@ -102,6 +107,10 @@ BL2_SOURCES		+=	drivers/arm/sp804/sp804_delay_timer.c		\
 				plat/arm/board/fvp/fvp_io_storage.c		\
 				${FVP_SECURITY_SOURCES}
 
+ifeq (${BL2_PARALLEL_LOAD},1)
+BL2_SOURCES		+=	plat/arm/board/fvp/aarch64/fvp_bl2_helpers.S
+endif
+
 BL2U_SOURCES		+=	plat/arm/board/fvp/fvp_bl2u_setup.c		\
 				${FVP_SECURITY_SOURCES}
 
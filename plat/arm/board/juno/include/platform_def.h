@@ -88,7 +88,11 @@
 #endif
 
 #if IMAGE_BL2
-# define PLAT_ARM_MMAP_ENTRIES		8
+# if CSS_SCP_BL2_DRAM_XFER
+#  define PLAT_ARM_MMAP_ENTRIES		9
+# else
+#  define PLAT_ARM_MMAP_ENTRIES		8
+# endif
 # define MAX_XLAT_TABLES		3
 #endif
 
@@ -99,7 +103,12 @@
 
 #if IMAGE_BL31
 # define PLAT_ARM_MMAP_ENTRIES		5
-# define MAX_XLAT_TABLES		2
+# if RESET_TO_BL31_VERIFY
+/* Up to 2 more tables for each of the preloaded images mapped by BL31 */
+#  define MAX_XLAT_TABLES		(6 + ARM_COLD_XLAT_TABLES)
+# else
+#  define MAX_XLAT_TABLES		(2 + ARM_COLD_XLAT_TABLES)
+# endif
 #endif
 
 #if IMAGE_BL32
@@ -109,6 +118,24 @@
 
 #endif /* ARM_BOARD_OPTIMISE_MMAP */
 
+/* Regions of the early translation tables of BL1 and BL2 */
+#define PLAT_XLAT_EARLY_MMAP		ARM_XLAT_EARLY_MMAP,		\
+					V2M_MAP_IOFPGA,			\
+					CSS_MAP_DEVICE,			\
+					SOC_CSS_MAP_DEVICE
+
+/* Regions of the translation tables of BL31 generated at build time */
+#define PLAT_XLAT_PREBUILT_MMAP		ARM_BL31_PREBUILT_MMAP,		\
+					BOARD_CSS_BL31_MMAP
+
+#if JUNO_BOOT_MAX_OPP
+/*
+ * SCPI DVFS domain of the cluster BL2 runs on, which is raised to its highest
+ * operating point while BL2 loads the AP images. It is the cluster ID on Juno.
+ */
+#define PLAT_CSS_BOOT_DVFS_DOMAIN(mpidr)	MPIDR_AFFLVL1_VAL(mpidr)
+#endif
+
 /* CCI related constants */
 #define PLAT_ARM_CCI_BASE		0x2c090000
 #define PLAT_ARM_CCI_CLUSTER0_SL_IFACE_IX	4
@@ -174,7 +201,27 @@
 					JUNO_IRQ_GPU_SMMU_1,		\
 					JUNO_IRQ_ETR_SMMU
 
-#define PLAT_ARM_G0_IRQS		ARM_G0_IRQS
+#if ARM_TZC_FAULT_HANDLER
+#define JUNO_G0_TZC_IRQ			CSS_IRQ_TZC,
+#else
+#define JUNO_G0_TZC_IRQ
+#endif
+
+#if EL3_HANG_DETECT
+#define JUNO_G0_TZ_WDOG_IRQ		CSS_IRQ_TZ_WDOG,
+#else
+#define JUNO_G0_TZ_WDOG_IRQ
+#endif
+
+#define PLAT_ARM_G0_IRQS		JUNO_G0_TZC_IRQ			\
+					JUNO_G0_TZ_WDOG_IRQ		\
+					ARM_G0_IRQS
+
+/* Interrupt of the TZC-400, handled by BL31 if ARM_TZC_FAULT_HANDLER is set */
+#define PLAT_ARM_TZC_IRQ		CSS_IRQ_TZC
+
+/* Trusted watchdog interrupt, handled by BL31 if EL3_HANG_DETECT is set */
+#define PLAT_ARM_TWDG_IRQ		CSS_IRQ_TZ_WDOG
 
 /*
  * Required ARM CSS SoC based platform porting definitions
@@ -209,4 +256,10 @@
  */
 #define PLAT_ARM_MAX_BL31_SIZE		0x1D000
 
+/*
+ * PLAT_ARM_MAX_BL31_COLD_SIZE is the size of the TZC secured DRAM reserved for
+ * the cold code and read-only data of BL31 when BL31_SPLIT_COLD is set.
+ */
+#define PLAT_ARM_MAX_BL31_COLD_SIZE	0x10000
+
 #endif /* __PLATFORM_DEF_H__ */
@@ -86,6 +86,22 @@ include plat/arm/common/arm_common.mk
 include plat/arm/soc/common/soc_css.mk
 include plat/arm/css/common/css_common.mk
 
+# Flag used to raise the boot cluster to its highest operating point while BL2
+# loads and authenticates the AP images.
+JUNO_BOOT_MAX_OPP		:=	0
+
+$(eval $(call assert_boolean,JUNO_BOOT_MAX_OPP))
+$(eval $(call add_define,JUNO_BOOT_MAX_OPP))
+
+ifeq (${JUNO_BOOT_MAX_OPP},1)
+  ifneq (${CSS_DEFER_SCP_READY},0)
+    $(error "JUNO_BOOT_MAX_OPP requires CSS_DEFER_SCP_READY=0")
+  endif
+  ifdef EL3_PAYLOAD_BASE
+    $(error "JUNO_BOOT_MAX_OPP is not supported with EL3_PAYLOAD_BASE")
+  endif
+endif
+
 ifeq (${KEY_ALG},ecdsa)
     $(error "ECDSA key algorithm is not fully supported on Juno.")
 endif
@@ -29,9 +29,12 @@
  */
 #include <arch.h>
 #include <arch_helpers.h>
+#include <arm_boot_ts.h>
+#include <cassert.h>
 #include <mmio.h>
 #include <plat_arm.h>
 #include <platform_def.h>
+#include <warm_reboot.h>
 #include <xlat_tables.h>
 
 extern const mmap_region_t plat_arm_mmap[];
@@ -159,3 +162,20 @@ const mmap_region_t *plat_arm_get_mmap(void)
 {
 	return plat_arm_mmap;
 }
+
+#if FAST_WARM_REBOOT
+CASSERT(sizeof(warm_reboot_manifest_t) <= ARM_WARM_REBOOT_MANIFEST_SIZE,
+	assert_arm_warm_reboot_manifest_size);
+CASSERT(ARM_WARM_REBOOT_MANIFEST_BASE + ARM_WARM_REBOOT_MANIFEST_SIZE <=
+	ARM_BOOT_TS_TABLE_BASE, assert_arm_warm_reboot_manifest_overlap);
+
+/*******************************************************************************
+ * The manifest of the images reused across a warm reboot is kept in the shared
+ * trusted SRAM, which is only accessible to the secure world and retains its
+ * contents across a system reset.
+ ******************************************************************************/
+warm_reboot_manifest_t *plat_get_warm_reboot_manifest(void)
+{
+	return (warm_reboot_manifest_t *)ARM_WARM_REBOOT_MANIFEST_BASE;
+}
+#endif
@@ -85,11 +85,15 @@ int bl1_plat_mem_check(uintptr_t mem_base,
 	else
 		mmap = fwu_addr_map_non_secure;
 
+	/*
+	 * The block comes from the normal world, so compare offsets rather
+	 * than end addresses that could wrap around.
+	 */
 	while (mmap[index].mem_size) {
 		if ((mem_base >= mmap[index].mem_base) &&
-			((mem_base + mem_size)
-			<= (mmap[index].mem_base +
-			mmap[index].mem_size)))
+			(mem_size <= mmap[index].mem_size) &&
+			((mem_base - mmap[index].mem_base) <=
+			(mmap[index].mem_size - mem_size)))
 			return 0;
 
 		index++;
@@ -29,6 +29,7 @@
  */
 
 #include <arch.h>
+#include <arm_boot_ts.h>
 #include <arm_def.h>
 #include <bl_common.h>
 #include <console.h>
@@ -73,6 +74,10 @@ void arm_bl1_early_platform_setup(void)
 {
 	const size_t bl1_size = BL1_RAM_LIMIT - BL1_RAM_BASE;
 
+	/* BL1 is the first stage of the cold boot path */
+	arm_boot_ts_init();
+	arm_boot_ts_mark(ARM_BOOT_TS_BL1_ENTRY, 0);
+
 #if !ARM_DISABLE_TRUSTED_WDOG
 	/* Enable watchdog */
 	sp805_start(ARM_SP805_TWDG_BASE, ARM_TWDG_LOAD_VAL);
@@ -142,6 +147,7 @@ void arm_bl1_platform_setup(void)
 {
 	/* Initialise the IO layer and register platform IO devices */
 	plat_arm_io_setup();
+	arm_boot_ts_mark(ARM_BOOT_TS_BL1_IO_SETUP, 0);
 }
 
 void bl1_platform_setup(void)
@@ -151,6 +157,9 @@ void bl1_platform_setup(void)
 
 void bl1_plat_prepare_exit(entry_point_info_t *ep_info)
 {
+	/* The next image has been loaded and authenticated by now */
+	arm_boot_ts_mark(ARM_BOOT_TS_BL1_EXIT, 0);
+
 #if !ARM_DISABLE_TRUSTED_WDOG
 	/* Disable watchdog before leaving BL1 */
 	sp805_stop(ARM_SP805_TWDG_BASE);
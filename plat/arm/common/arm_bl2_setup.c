@@ -29,6 +29,7 @@
  */
 
 #include <arch_helpers.h>
+#include <arm_boot_ts.h>
 #include <arm_def.h>
 #include <bl_common.h>
 #include <console.h>
@@ -172,12 +173,20 @@ bl31_params_t *bl2_plat_get_bl31_params(void)
 }
 
 /* Flush the TF params and the TF plat params */
-void bl2_plat_flush_bl31_params(void)
+void arm_bl2_plat_flush_bl31_params(void)
 {
+	arm_boot_ts_load_stats();
+	arm_boot_ts_mark(ARM_BOOT_TS_BL2_EXIT, 0);
+
 	flush_dcache_range((unsigned long)&bl31_params_mem,
 			sizeof(bl2_to_bl31_params_mem_t));
 }
 
+void bl2_plat_flush_bl31_params(void)
+{
+	arm_bl2_plat_flush_bl31_params();
+}
+
 /*******************************************************************************
  * This function returns a pointer to the shared memory that the platform
  * has kept to point to entry point information of BL31 to BL2
@@ -198,6 +207,8 @@ struct entry_point_info *bl2_plat_get_bl31_ep_info(void)
  ******************************************************************************/
 void arm_bl2_early_platform_setup(meminfo_t *mem_layout)
 {
+	arm_boot_ts_mark(ARM_BOOT_TS_BL2_ENTRY, 0);
+
 	/* Initialize the console to provide early debug support */
 	console_init(PLAT_ARM_BOOT_UART_BASE, PLAT_ARM_BOOT_UART_CLK_IN_HZ,
 			ARM_CONSOLE_BAUDRATE);
@@ -207,6 +218,7 @@ void arm_bl2_early_platform_setup(meminfo_t *mem_layout)
 
 	/* Initialise the IO layer and register platform IO devices */
 	plat_arm_io_setup();
+	arm_boot_ts_mark(ARM_BOOT_TS_BL2_IO_SETUP, 0);
 }
 
 void bl2_early_platform_setup(meminfo_t *mem_layout)
@@ -268,6 +280,8 @@ void bl2_plat_get_scp_bl2_meminfo(meminfo_t *scp_bl2_meminfo)
 void bl2_plat_set_bl31_ep_info(image_info_t *bl31_image_info,
 					entry_point_info_t *bl31_ep_info)
 {
+	arm_boot_ts_mark(ARM_BOOT_TS_IMAGE_LOADED, BL31_IMAGE_ID);
+
 	SET_SECURITY_STATE(bl31_ep_info->h.attr, SECURE);
 	bl31_ep_info->spsr = SPSR_64(MODE_EL3, MODE_SP_ELX,
 					DISABLE_ALL_EXCEPTIONS);
@@ -283,6 +297,8 @@ void bl2_plat_set_bl31_ep_info(image_info_t *bl31_image_info,
 void bl2_plat_set_bl32_ep_info(image_info_t *bl32_image_info,
 					entry_point_info_t *bl32_ep_info)
 {
+	arm_boot_ts_mark(ARM_BOOT_TS_IMAGE_LOADED, BL32_IMAGE_ID);
+
 	SET_SECURITY_STATE(bl32_ep_info->h.attr, SECURE);
 	bl32_ep_info->spsr = arm_get_spsr_for_bl32_entry();
 }
@@ -296,6 +312,7 @@ void bl2_plat_set_bl32_ep_info(image_info_t *bl32_image_info,
 void bl2_plat_set_bl33_ep_info(image_info_t *image,
 					entry_point_info_t *bl33_ep_info)
 {
+	arm_boot_ts_mark(ARM_BOOT_TS_IMAGE_LOADED, BL33_IMAGE_ID);
 
 	SET_SECURITY_STATE(bl33_ep_info->h.attr, NON_SECURE);
 	bl33_ep_info->spsr = arm_get_spsr_for_bl33_entry();
@@ -30,11 +30,16 @@
 
 #include <arch.h>
 #include <arch_helpers.h>
+#include <arm_boot_ts.h>
 #include <arm_def.h>
+#include <arm_hang_detect.h>
+#include <arm_tzc_fault.h>
 #include <assert.h>
 #include <bl_common.h>
+#include <bl31.h>
 #include <console.h>
 #include <debug.h>
+#include <el3_timer.h>
 #include <mmio.h>
 #include <plat_arm.h>
 #include <platform.h>
@@ -70,6 +75,20 @@
 static entry_point_info_t bl32_image_ep_info;
 static entry_point_info_t bl33_image_ep_info;
 
+#if RESET_TO_BL31_VERIFY
+/*
+ * SHA-256 digests of the images preloaded at their entry point, calculated by
+ * the build system from the images passed in BL33 and BL32. The base addresses
+ * are filled in once the entry points are known.
+ */
+static bl31_image_digest_t arm_image_digests[] = {
+	{ 0, ARM_BL33_SIZE, { ARM_BL33_SHA256 } },
+#ifdef ARM_BL32_SHA256
+	{ 0, ARM_BL32_SIZE, { ARM_BL32_SHA256 } },
+#endif
+};
+#endif
+
 
 /* Weak definitions may be overridden in specific ARM standard platform */
 #pragma weak bl31_early_platform_setup
@@ -110,9 +129,15 @@ entry_point_info_t *bl31_plat_get_next_image_ep_info(uint32_t type)
  * while creating page tables. BL2 has flushed this information to memory, so
  * we are guaranteed to pick up good data.
  ******************************************************************************/
-void arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
+void __init arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
 				void *plat_params_from_bl2)
 {
+#if RESET_TO_BL31
+	/* BL31 is the first stage of the cold boot path */
+	arm_boot_ts_init();
+#endif
+	arm_boot_ts_mark(ARM_BOOT_TS_BL31_ENTRY, 0);
+
 	/* Initialize the console to provide early debug support */
 	console_init(PLAT_ARM_BOOT_UART_BASE, PLAT_ARM_BOOT_UART_CLK_IN_HZ,
 			ARM_CONSOLE_BAUDRATE);
@@ -171,7 +196,7 @@ void arm_bl31_early_platform_setup(bl31_params_t *from_bl2,
 #endif
 }
 
-void bl31_early_platform_setup(bl31_params_t *from_bl2,
+void __init bl31_early_platform_setup(bl31_params_t *from_bl2,
 				void *plat_params_from_bl2)
 {
 	arm_bl31_early_platform_setup(from_bl2, plat_params_from_bl2);
@@ -193,33 +218,101 @@ void bl31_early_platform_setup(bl31_params_t *from_bl2,
 	plat_arm_interconnect_enter_coherency();
 }
 
-/*******************************************************************************
- * Perform any BL31 platform setup common to ARM standard platforms
- ******************************************************************************/
-void arm_bl31_platform_setup(void)
+/* Enable and initialize the System level generic timer */
+static void __init arm_sys_timer_setup(void)
 {
-	/* Initialize the GIC driver, cpu and distributor interfaces */
-	plat_arm_gic_driver_init();
-	plat_arm_gic_init();
-
-#if RESET_TO_BL31
-	/*
-	 * Do initial security configuration to allow DRAM/device access
-	 * (if earlier BL has not already done so).
-	 */
-	plat_arm_security_setup();
-
-#endif /* RESET_TO_BL31 */
-
-	/* Enable and initialize the System level generic timer */
 	mmio_write_32(ARM_SYS_CNTCTL_BASE + CNTCR_OFF,
 			CNTCR_FCREQ(0) | CNTCR_EN);
 
 	/* Allow access to the System counter timer module */
 	arm_configure_sys_timer();
+}
+
+#if EL3_TIMER_SERVICE
+/* Take the secure physical timer interrupt at EL3 */
+static void __init arm_el3_timer_setup(void)
+{
+	int32_t rc = el3_timer_setup(ARM_IRQ_SEC_PHY_TIMER);
+
+	if (rc) {
+		ERROR("Cannot register the EL3 timer handler (%d)\n", rc);
+		panic();
+	}
+}
+#endif
+
+/*
+ * Steps of the BL31 platform setup common to ARM standard platforms, in the
+ * order in which they are started when nothing holds them back.
+ */
+enum {
+	ARM_BOOT_TASK_GIC_DRIVER,
+	ARM_BOOT_TASK_GIC,
+#if RESET_TO_BL31
+	ARM_BOOT_TASK_SECURITY,
+#endif
+	ARM_BOOT_TASK_TZC_FAULT,
+	ARM_BOOT_TASK_HANG_DETECT,
+#if EL3_TIMER_SERVICE
+	ARM_BOOT_TASK_EL3_TIMER,
+#endif
+	ARM_BOOT_TASK_SYS_TIMER,
+	ARM_BOOT_TASK_PWRC,
+	ARM_BOOT_TASK_NUM
+};
 
+static const bl31_boot_task_t arm_bl31_boot_tasks[] __initconst = {
+	/* Initialize the GIC driver, cpu and distributor interfaces */
+	[ARM_BOOT_TASK_GIC_DRIVER] = {
+		"GIC driver", plat_arm_gic_driver_init, NULL, 0
+	},
+	[ARM_BOOT_TASK_GIC] = {
+		"GIC", plat_arm_gic_init, NULL,
+		BL31_BOOT_TASK_DEP(ARM_BOOT_TASK_GIC_DRIVER)
+	},
+#if RESET_TO_BL31
+	/*
+	 * Do initial security configuration to allow DRAM/device access
+	 * (if earlier BL has not already done so).
+	 */
+	[ARM_BOOT_TASK_SECURITY] = {
+		"security", plat_arm_security_setup, NULL, 0
+	},
+#endif
+	/* Report the TZC access violations from now on */
+	[ARM_BOOT_TASK_TZC_FAULT] = {
+		"TZC fault reporting", arm_tzc_fault_setup, NULL,
+#if RESET_TO_BL31
+		BL31_BOOT_TASK_DEP(ARM_BOOT_TASK_SECURITY) |
+#endif
+		BL31_BOOT_TASK_DEP(ARM_BOOT_TASK_GIC)
+	},
+	/* Watch the CPUs executing in EL3 from now on */
+	[ARM_BOOT_TASK_HANG_DETECT] = {
+		"hang detection", arm_hang_detect_setup, NULL,
+		BL31_BOOT_TASK_DEP(ARM_BOOT_TASK_GIC)
+	},
+#if EL3_TIMER_SERVICE
+	[ARM_BOOT_TASK_EL3_TIMER] = {
+		"EL3 timer", arm_el3_timer_setup, NULL,
+		BL31_BOOT_TASK_DEP(ARM_BOOT_TASK_GIC)
+	},
+#endif
+	[ARM_BOOT_TASK_SYS_TIMER] = {
+		"system timer", arm_sys_timer_setup, NULL, 0
+	},
 	/* Initialize power controller before setting up topology */
-	plat_arm_pwrc_setup();
+	[ARM_BOOT_TASK_PWRC] = {
+		"power controller", plat_arm_pwrc_setup, NULL, 0
+	},
+};
+
+/*******************************************************************************
+ * Perform any BL31 platform setup common to ARM standard platforms
+ ******************************************************************************/
+void __init arm_bl31_platform_setup(void)
+{
+	bl31_run_boot_tasks(arm_bl31_boot_tasks, ARM_BOOT_TASK_NUM);
 }
 
 /*******************************************************************************
@@ -228,12 +321,14 @@ void arm_bl31_platform_setup(void)
  ******************************************************************************/
 void arm_bl31_plat_runtime_setup(void)
 {
+	arm_boot_ts_mark(ARM_BOOT_TS_BL31_EXIT, 0);
+
 	/* Initialize the runtime console */
 	console_init(PLAT_ARM_BL31_RUN_UART_BASE, PLAT_ARM_BL31_RUN_UART_CLK_IN_HZ,
 			ARM_CONSOLE_BAUDRATE);
 }
 
-void bl31_platform_setup(void)
+void __init bl31_platform_setup(void)
 {
 	arm_bl31_platform_setup();
 }
@@ -243,12 +338,52 @@ void bl31_plat_runtime_setup(void)
 	arm_bl31_plat_runtime_setup();
 }
 
+#if RESET_TO_BL31_VERIFY
+/*******************************************************************************
+ * Add read-only mappings of the preloaded images to the memory map of BL31, so
+ * that bl31_verify_images() can read them with the data cache enabled.
+ ******************************************************************************/
+static void __init arm_map_preloaded_images(void)
+{
+	unsigned long base, limit;
+	unsigned int i;
+
+	arm_image_digests[0].base = bl33_image_ep_info.pc;
+#ifdef ARM_BL32_SHA256
+	arm_image_digests[1].base = bl32_image_ep_info.pc;
+#endif
+
+	for (i = 0; i < ARRAY_SIZE(arm_image_digests); i++) {
+		base = arm_image_digests[i].base & ~(PAGE_SIZE - 1);
+		limit = (arm_image_digests[i].base + arm_image_digests[i].size +
+			 PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+		mmap_add_region(base, base, limit - base, MT_MEMORY | MT_RO |
+				((i == 0) ? MT_NS : MT_SECURE));
+	}
+}
+
+const bl31_image_digest_t *bl31_plat_get_image_digests(unsigned int *num)
+{
+	*num = ARRAY_SIZE(arm_image_digests);
+	return arm_image_digests;
+}
+#endif /* RESET_TO_BL31_VERIFY */
+
 /*******************************************************************************
  * Perform the very early platform specific architectural setup here. At the
  * moment this is only intializes the mmu in a quick and dirty way.
  ******************************************************************************/
-void arm_bl31_plat_arch_setup(void)
+void __init arm_bl31_plat_arch_setup(void)
 {
+#if RESET_TO_BL31_VERIFY
+	arm_map_preloaded_images();
+#endif
+#if BL31_SPLIT_COLD
+	/* The cold code and read-only data of BL31, copied there at boot */
+	mmap_add_region(BL31_COLD_BASE, BL31_COLD_BASE,
+			BL31_COLD_LIMIT - BL31_COLD_BASE,
+			MT_MEMORY | MT_RO | MT_SECURE);
+#endif
 	arm_configure_mmu_el3(BL31_RO_BASE,
 			      (BL31_END - BL31_RO_BASE),
 			      BL31_RO_BASE,
@@ -260,7 +395,7 @@ void arm_bl31_plat_arch_setup(void)
 			      );
 }
 
-void bl31_plat_arch_setup(void)
+void __init bl31_plat_arch_setup(void)
 {
 	arm_bl31_plat_arch_setup();
 }
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <arm_boot_ts.h>
+#include <assert.h>
+#include <cassert.h>
+#include <load_stats.h>
+#include <spinlock.h>
+
+CASSERT(sizeof(arm_boot_ts_table_t) <= ARM_BOOT_TS_TABLE_SIZE,
+	assert_arm_boot_ts_table_size);
+
+/*
+ * The shared trusted SRAM is mapped as device memory by all the BL stages, so
+ * the table needs no cache maintenance across the handoffs.
+ */
+#define boot_ts_table	((arm_boot_ts_table_t *)ARM_BOOT_TS_TABLE_BASE)
+
+#if IMAGE_BL2 && BL2_PARALLEL_LOAD
+/* Images loaded on different CPUs are marked one at a time */
+static spinlock_t boot_ts_lock;
+#define boot_ts_lock_acquire()	spin_lock(&boot_ts_lock)
+#define boot_ts_lock_release()	spin_unlock(&boot_ts_lock)
+#else
+#define boot_ts_lock_acquire()
+#define boot_ts_lock_release()
+#endif
+
+/*******************************************************************************
+ * Empty the table. Called by the first BL stage of the cold boot path.
+ ******************************************************************************/
+void arm_boot_ts_init(void)
+{
+	boot_ts_table->num_recs = 0;
+	boot_ts_table->magic = ARM_BOOT_TS_MAGIC;
+}
+
+/*******************************************************************************
+ * Append a record to the table. Records beyond the capacity of the table, or
+ * recorded before it has been initialised, are dropped.
+ ******************************************************************************/
+static void boot_ts_append(unsigned int id, unsigned int arg, uint64_t value)
+{
+	arm_boot_ts_rec_t *rec;
+	unsigned int n;
+
+	boot_ts_lock_acquire();
+
+	n = boot_ts_table->num_recs;
+	if (boot_ts_table->magic == ARM_BOOT_TS_MAGIC &&
+	    n < ARM_BOOT_TS_MAX_RECS) {
+		rec = &boot_ts_table->recs[n];
+		rec->id = id;
+		rec->arg = arg;
+		rec->timestamp = value;
+		boot_ts_table->num_recs = n + 1;
+	}
+
+	boot_ts_lock_release();
+}
+
+/*******************************************************************************
+ * Append a marker, stamped with the current physical count, to the table.
+ ******************************************************************************/
+void arm_boot_ts_mark(unsigned int id, unsigned int arg)
+{
+	boot_ts_append(id, arg, read_cntpct_el0());
+}
+
+#if LOAD_IMAGE_STATS && IMAGE_BL2
+static uint32_t boot_ts_sat32(uint64_t ticks)
+{
+	return ticks > UINT32_MAX ? UINT32_MAX : ticks;
+}
+
+/*******************************************************************************
+ * Append the loading statistics of the images read by BL2 to the table.
+ ******************************************************************************/
+void arm_boot_ts_load_stats(void)
+{
+	uint64_t bytes, auth_ticks;
+	unsigned int i;
+
+	for (i = 0; i < LOAD_STATS_MAX_IMAGES; i++) {
+		bytes = load_stats_bytes(i);
+		if (bytes == 0)
+			continue;
+
+		auth_ticks = load_stats_ticks(i, LOAD_STATS_HASH) +
+			load_stats_ticks(i, LOAD_STATS_PARSE) +
+			load_stats_ticks(i, LOAD_STATS_SIG);
+
+		boot_ts_append(ARM_BOOT_TS_IMAGE_BYTES, i, bytes);
+		boot_ts_append(ARM_BOOT_TS_IMAGE_TICKS, i,
+			       ((uint64_t)boot_ts_sat32(auth_ticks) << 32) |
+			       boot_ts_sat32(load_stats_ticks(i, LOAD_STATS_IO)));
+	}
+}
+#endif
+
+/*******************************************************************************
+ * Read back the marker at 'index'. Returns 0 and the number of markers in the
+ * table, or -1 if there is no such marker.
+ ******************************************************************************/
+int arm_boot_ts_read(unsigned int index, arm_boot_ts_rec_t *rec,
+		     unsigned int *num_recs)
+{
+	assert(rec && num_recs);
+
+	if (boot_ts_table->magic != ARM_BOOT_TS_MAGIC ||
+	    index >= boot_ts_table->num_recs)
+		return -1;
+
+	*rec = boot_ts_table->recs[index];
+	*num_recs = boot_ts_table->num_recs;
+
+	return 0;
+}
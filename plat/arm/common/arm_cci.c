@@ -44,7 +44,11 @@ static const int cci_map[] = {
  *****************************************************************************/
 #pragma weak plat_arm_interconnect_init
 #pragma weak plat_arm_interconnect_enter_coherency
+#pragma weak plat_arm_interconnect_enter_coherency_async
+#pragma weak plat_arm_interconnect_wait_coherency
 #pragma weak plat_arm_interconnect_exit_coherency
+#pragma weak plat_arm_interconnect_enter_system_idle
+#pragma weak plat_arm_interconnect_exit_system_idle
 
 
 /******************************************************************************
@@ -63,6 +67,23 @@ void plat_arm_interconnect_enter_coherency(void)
 	cci_enable_snoop_dvm_reqs(MPIDR_AFFLVL1_VAL(read_mpidr_el1()));
 }
 
+/******************************************************************************
+ * Helper function to start placing current master into coherency. It must be
+ * followed by plat_arm_interconnect_wait_coherency().
+ *****************************************************************************/
+void plat_arm_interconnect_enter_coherency_async(void)
+{
+	cci_enable_snoop_dvm_reqs_async(MPIDR_AFFLVL1_VAL(read_mpidr_el1()));
+}
+
+/******************************************************************************
+ * Helper function to wait until current master is coherent
+ *****************************************************************************/
+void plat_arm_interconnect_wait_coherency(void)
+{
+	cci_wait_snoop_dvm_reqs();
+}
+
 /******************************************************************************
  * Helper function to remove current master from coherency
  *****************************************************************************/
@@ -70,3 +91,14 @@ void plat_arm_interconnect_exit_coherency(void)
 {
 	cci_disable_snoop_dvm_reqs(MPIDR_AFFLVL1_VAL(read_mpidr_el1()));
 }
+
+/******************************************************************************
+ * The CCI has no system level state to manage when the system goes idle
+ *****************************************************************************/
+void plat_arm_interconnect_enter_system_idle(void)
+{
+}
+
+void plat_arm_interconnect_exit_system_idle(void)
+{
+}
@@ -33,6 +33,18 @@
 #include <plat_arm.h>
 #include <platform_def.h>
 
+/*
+ * L3 run mode the HN-Fs are dropped to while the whole system is idle. A
+ * platform can define it to CCN_L3_RUN_MODE_SFONLY to save more power at the
+ * cost of refilling the L3 on wake up.
+ */
+#ifndef PLAT_ARM_CCN_IDLE_L3_RUN_MODE
+#define PLAT_ARM_CCN_IDLE_L3_RUN_MODE	CCN_L3_RUN_MODE_HAM
+#endif
+
+/* L3 run mode to restore when the system leaves idle */
+static unsigned int arm_ccn_l3_run_mode;
+
 static const unsigned char master_to_rn_id_map[] = {
 	PLAT_ARM_CLUSTER_TO_CCN_ID_MAP
 };
@@ -49,7 +61,11 @@ static const ccn_desc_t arm_ccn_desc = {
  *****************************************************************************/
 #pragma weak plat_arm_interconnect_init
 #pragma weak plat_arm_interconnect_enter_coherency
+#pragma weak plat_arm_interconnect_enter_coherency_async
+#pragma weak plat_arm_interconnect_wait_coherency
 #pragma weak plat_arm_interconnect_exit_coherency
+#pragma weak plat_arm_interconnect_enter_system_idle
+#pragma weak plat_arm_interconnect_exit_system_idle
 
 
 /******************************************************************************
@@ -68,6 +84,19 @@ void plat_arm_interconnect_enter_coherency(void)
 	ccn_enter_snoop_dvm_domain(1 << MPIDR_AFFLVL1_VAL(read_mpidr_el1()));
 }
 
+/******************************************************************************
+ * The CCN driver has no asynchronous variant, so current master is placed
+ * into coherency straight away and there is nothing left to wait for.
+ *****************************************************************************/
+void plat_arm_interconnect_enter_coherency_async(void)
+{
+	plat_arm_interconnect_enter_coherency();
+}
+
+void plat_arm_interconnect_wait_coherency(void)
+{
+}
+
 /******************************************************************************
  * Helper function to remove current master from coherency
  *****************************************************************************/
@@ -75,3 +104,26 @@ void plat_arm_interconnect_exit_coherency(void)
 {
 	ccn_exit_snoop_dvm_domain(1 << MPIDR_AFFLVL1_VAL(read_mpidr_el1()));
 }
+
+/******************************************************************************
+ * Helper function called by the last cpu to power down when the system power
+ * domain is about to be turned off. It drops the L3 to a lower run mode and
+ * remembers the current one.
+ *****************************************************************************/
+void plat_arm_interconnect_enter_system_idle(void)
+{
+	arm_ccn_l3_run_mode = ccn_get_l3_run_mode();
+
+	if (arm_ccn_l3_run_mode > PLAT_ARM_CCN_IDLE_L3_RUN_MODE)
+		ccn_set_l3_run_mode(PLAT_ARM_CCN_IDLE_L3_RUN_MODE);
+}
+
+/******************************************************************************
+ * Helper function called by the first cpu to wake up from a system power
+ * domain power down. It restores the L3 run mode saved before going idle.
+ *****************************************************************************/
+void plat_arm_interconnect_exit_system_idle(void)
+{
+	if (arm_ccn_l3_run_mode > PLAT_ARM_CCN_IDLE_L3_RUN_MODE)
+		ccn_set_l3_run_mode(arm_ccn_l3_run_mode);
+}
@@ -82,6 +82,24 @@ ARM_BL31_IN_DRAM		:=	0
 $(eval $(call assert_boolean,ARM_BL31_IN_DRAM))
 $(eval $(call add_define,ARM_BL31_IN_DRAM))
 
+# The cold region of BL31 is in TZC secured DRAM, where BL31 already is when
+# ARM_BL31_IN_DRAM is set
+ifeq (${BL31_SPLIT_COLD},1)
+    ifeq (${ARM_BL31_IN_DRAM},1)
+        $(error "BL31_SPLIT_COLD is not supported with ARM_BL31_IN_DRAM=1")
+    endif
+endif
+
+# Process ARM_BOOT_TIMESTAMPS flag
+ARM_BOOT_TIMESTAMPS		:=	0
+$(eval $(call assert_boolean,ARM_BOOT_TIMESTAMPS))
+$(eval $(call add_define,ARM_BOOT_TIMESTAMPS))
+
+# Process ARM_TZC_FAULT_HANDLER flag
+ARM_TZC_FAULT_HANDLER		:=	0
+$(eval $(call assert_boolean,ARM_TZC_FAULT_HANDLER))
+$(eval $(call add_define,ARM_TZC_FAULT_HANDLER))
+
 PLAT_INCLUDES		+=	-Iinclude/common/tbbr				\
 				-Iinclude/plat/arm/common			\
 				-Iinclude/plat/arm/common/aarch64
@@ -117,10 +135,47 @@ BL2U_SOURCES		+=	plat/arm/common/arm_bl2u_setup.c		\
 
 BL31_SOURCES		+=	plat/arm/common/arm_bl31_setup.c		\
 				plat/arm/common/arm_pm.c			\
+				plat/arm/common/arm_sip_svc.c			\
 				plat/arm/common/arm_topology.c			\
 				plat/common/aarch64/platform_mp_stack.S		\
 				plat/common/aarch64/plat_psci_common.c
 
+ifeq (${ARM_BOOT_TIMESTAMPS},1)
+BL1_SOURCES		+=	plat/arm/common/arm_boot_ts.c
+BL2_SOURCES		+=	plat/arm/common/arm_boot_ts.c
+BL31_SOURCES		+=	plat/arm/common/arm_boot_ts.c
+endif
+
+ifeq (${ARM_TZC_FAULT_HANDLER},1)
+BL31_SOURCES		+=	plat/arm/common/arm_tzc_fault.c
+endif
+
+ifeq (${EL3_HANG_DETECT},1)
+BL31_SOURCES		+=	drivers/arm/sp805/sp805.c			\
+				plat/arm/common/arm_hang_detect.c
+endif
+
+# With RESET_TO_BL31_VERIFY, BL31 checks the preloaded BL33 and BL32 images
+# against the size and SHA-256 digest of the images passed in BL33 and BL32
+ifeq (${RESET_TO_BL31_VERIFY},1)
+    ifeq (${BL33},)
+        $(error "RESET_TO_BL31_VERIFY requires BL33 to be the preloaded image")
+    endif
+    ARM_BL33_SIZE	:=	$(shell stat -c %s ${BL33})
+    ARM_BL33_SHA256	:=	$(shell sha256sum ${BL33} | cut -c1-64 | sed 's/../0x&,/g')
+    $(eval $(call add_define,ARM_BL33_SIZE))
+    $(eval $(call add_define,ARM_BL33_SHA256))
+    ifneq (${SPD},none)
+        ifeq (${BL32},)
+            $(error "RESET_TO_BL31_VERIFY requires BL32 to be the preloaded image")
+        endif
+        ARM_BL32_SIZE	:=	$(shell stat -c %s ${BL32})
+        ARM_BL32_SHA256	:=	$(shell sha256sum ${BL32} | cut -c1-64 | sed 's/../0x&,/g')
+        $(eval $(call add_define,ARM_BL32_SIZE))
+        $(eval $(call add_define,ARM_BL32_SHA256))
+    endif
+endif
+
 ifneq (${TRUSTED_BOARD_BOOT},0)
 
     # By default, ARM platforms use RSA keys
@@ -28,6 +28,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <arch_helpers.h>
+#include <cpu_data.h>
 #include <gicv2.h>
 #include <plat_arm.h>
 #include <platform.h>
@@ -64,10 +66,26 @@ gicv2_driver_data_t arm_gic_data = {
 	.g0_interrupt_array = g0_interrupt_array,
 };
 
+#if IMAGE_BL31
+/******************************************************************************
+ * The banked distributor registers of each cpu, saved when it is powered down
+ * so that they can be restored when it is powered up again instead of being
+ * initialised from scratch. The data cache of the cpu is disabled on both
+ * sides, unless there is hardware assisted coherency.
+ *****************************************************************************/
+typedef struct arm_gic_pcpu_state {
+	gicv2_pcpu_ctx_t ctx;
+	/* Zero until the cpu has been powered down once since cold boot */
+	unsigned int saved;
+} arm_gic_pcpu_state_t;
+
+static DEFINE_PERCPU(arm_gic_pcpu_state_t, arm_gic_pcpu_state);
+#endif
+
 /******************************************************************************
  * ARM common helper to initialize the GICv2 only driver.
  *****************************************************************************/
-void plat_arm_gic_driver_init(void)
+void __init plat_arm_gic_driver_init(void)
 {
 	gicv2_driver_init(&arm_gic_data);
 }
@@ -92,13 +110,42 @@ void plat_arm_gic_cpuif_enable(void)
  *****************************************************************************/
 void plat_arm_gic_cpuif_disable(void)
 {
+#if IMAGE_BL31
+	arm_gic_pcpu_state_t *state = this_cpu_ptr(arm_gic_pcpu_state);
+
+	/*
+	 * This is called on the way to a power down, so save the banked
+	 * distributor registers for plat_arm_gic_pcpu_init(). The same cache
+	 * maintenance as for the affinity info state in psci_do_cpu_off()
+	 * makes the writes reach main memory.
+	 */
+#if !HW_ASSISTED_COHERENCY
+	flush_dcache_range((uintptr_t)state, sizeof(*state));
+#endif
+	gicv2_save_pcpu_distif(&state->ctx);
+	state->saved = 1;
+#if !HW_ASSISTED_COHERENCY
+	dsbish();
+	inv_dcache_range((uintptr_t)state, sizeof(*state));
+#endif
+#endif
 	gicv2_cpuif_disable();
 }
 
 /******************************************************************************
- * ARM common helper to initialize the per cpu distributor interface in GICv2
+ * ARM common helper to initialize the per cpu distributor interface in GICv2.
+ * A cpu which has been powered down since cold boot restores the registers it
+ * saved then.
  *****************************************************************************/
 void plat_arm_gic_pcpu_init(void)
 {
+#if IMAGE_BL31
+	arm_gic_pcpu_state_t *state = this_cpu_ptr(arm_gic_pcpu_state);
+
+	if (state->saved) {
+		gicv2_restore_pcpu_distif(&state->ctx);
+		return;
+	}
+#endif
 	gicv2_pcpu_distif_init();
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -29,6 +29,10 @@
  */
 
 #include <arm_def.h>
+#include <cassert.h>
+#if IMAGE_BL31
+#include <cpu_data.h>
+#endif
 #include <gicv3.h>
 #include <plat_arm.h>
 #include <platform.h>
@@ -69,7 +73,26 @@ const gicv3_driver_data_t arm_gic_data = {
 	.mpidr_to_core_pos = plat_arm_calc_core_pos
 };
 
-void plat_arm_gic_driver_init(void)
+#if IMAGE_BL31
+/*
+ * The base address of the Redistributor frame of each CPU is kept in the
+ * platform area of its per-cpu data so that the warm boot and power down paths
+ * can retrieve it with a single load from the cpu_data of the calling CPU.
+ */
+CASSERT(PLAT_PCPU_DATA_SIZE >= sizeof(uintptr_t),
+	assert_arm_pcpu_data_too_small);
+CASSERT((CPU_DATA_PLAT_PCPU_OFFSET & (sizeof(uintptr_t) - 1)) == 0,
+	assert_arm_pcpu_data_misaligned);
+
+#define arm_gicr_base_by_index(_ix)	\
+	(*(uintptr_t *) get_cpu_data_by_index(_ix, platform_cpu_data))
+#define arm_gicr_base()			\
+	(*(uintptr_t *) get_cpu_data(platform_cpu_data))
+#else
+#define arm_gicr_base()			gicv3_rdistif_base(plat_my_core_pos())
+#endif
+
+void __init plat_arm_gic_driver_init(void)
 {
 	/*
 	 * The GICv3 driver is initialized in EL3 and does not need
@@ -78,7 +101,12 @@ void plat_arm_gic_driver_init(void)
 	 * not need GIC interface base addresses to be configured.
 	 */
 #if IMAGE_BL31
+	unsigned int i;
+
 	gicv3_driver_init(&arm_gic_data);
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		arm_gicr_base_by_index(i) = gicv3_rdistif_base(i);
 #endif
 }
 
@@ -88,8 +116,8 @@ void plat_arm_gic_driver_init(void)
 void plat_arm_gic_init(void)
 {
 	gicv3_distif_init();
-	gicv3_rdistif_init(plat_my_core_pos());
-	gicv3_cpuif_enable(plat_my_core_pos());
+	gicv3_rdistif_init_by_base(arm_gicr_base());
+	gicv3_cpuif_enable_by_base(arm_gicr_base());
 }
 
 /******************************************************************************
@@ -97,7 +125,7 @@ void plat_arm_gic_init(void)
  *****************************************************************************/
 void plat_arm_gic_cpuif_enable(void)
 {
-	gicv3_cpuif_enable(plat_my_core_pos());
+	gicv3_cpuif_enable_by_base(arm_gicr_base());
 }
 
 /******************************************************************************
@@ -105,7 +133,7 @@ void plat_arm_gic_cpuif_enable(void)
  *****************************************************************************/
 void plat_arm_gic_cpuif_disable(void)
 {
-	gicv3_cpuif_disable(plat_my_core_pos());
+	gicv3_cpuif_disable_by_base(arm_gicr_base());
 }
 
 /******************************************************************************
@@ -113,5 +141,5 @@ void plat_arm_gic_cpuif_disable(void)
  *****************************************************************************/
 void plat_arm_gic_pcpu_init(void)
 {
-	gicv3_rdistif_init(plat_my_core_pos());
+	gicv3_rdistif_init_by_base(arm_gicr_base());
 }
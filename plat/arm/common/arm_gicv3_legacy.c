@@ -53,7 +53,7 @@ const unsigned int irq_sec_array[] = {
 	PLAT_ARM_G1S_IRQS
 };
 
-void plat_arm_gic_driver_init(void)
+void __init plat_arm_gic_driver_init(void)
 {
 	arm_gic_init(PLAT_ARM_GICC_BASE,
 		     PLAT_ARM_GICD_BASE,
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arm_def.h>
+#include <arm_hang_detect.h>
+#include <debug.h>
+#include <hang_detect.h>
+#include <interrupt_mgmt.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <sp805.h>
+
+#ifndef PLAT_ARM_TWDG_IRQ
+#error "EL3_HANG_DETECT requires the platform to define PLAT_ARM_TWDG_IRQ"
+#endif
+
+#define ARM_HANG_DETECT_LOAD_VAL	(ARM_SP805_TWDG_CLK_HZ *	\
+					 ARM_HANG_DETECT_PERIOD_MS / 1000)
+
+static int hang_detect_handler_registered;
+
+/*******************************************************************************
+ * Handler of the trusted watchdog interrupt, raised at the end of each period.
+ ******************************************************************************/
+static uint64_t hang_detect_handler(uint32_t id,
+				    uint32_t flags,
+				    void *handle,
+				    void *cookie)
+{
+	if (!el3_hang_check()) {
+		/* Start the next period */
+		sp805_clear_interrupt(ARM_SP805_TWDG_BASE);
+		return 0;
+	}
+
+	/*
+	 * The interrupt is left pending, so the watchdog resets the system
+	 * when its counter reaches zero again.
+	 */
+	el3_hang_report();
+	plat_panic_handler();
+}
+
+/*******************************************************************************
+ * Start the trusted watchdog and register the handler of its interrupt at EL3
+ * on the first call. Called at cold boot and on resume from system suspend.
+ ******************************************************************************/
+void arm_hang_detect_setup(void)
+{
+	uint32_t flags = 0;
+	int32_t rc;
+
+	if (!hang_detect_handler_registered) {
+		/* Take the interrupt at EL3 from both security states */
+		set_interrupt_rm_flag(flags, SECURE);
+		set_interrupt_rm_flag(flags, NON_SECURE);
+		rc = register_interrupt_handler(PLAT_ARM_TWDG_IRQ,
+						hang_detect_handler, flags);
+		if (rc) {
+			ERROR("Cannot register the hang detection handler (%d)\n",
+			      rc);
+			panic();
+		}
+
+		hang_detect_handler_registered = 1;
+	}
+
+	sp805_start(ARM_SP805_TWDG_BASE, ARM_HANG_DETECT_LOAD_VAL);
+}
+
+/*******************************************************************************
+ * Stop the trusted watchdog before the system is suspended, as no CPU is left
+ * to take its interrupt.
+ ******************************************************************************/
+void arm_hang_detect_stop(void)
+{
+	sp805_stop(ARM_SP805_TWDG_BASE);
+}
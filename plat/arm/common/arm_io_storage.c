@@ -44,6 +44,10 @@ static uintptr_t fip_dev_handle;
 static const io_dev_connector_t *memmap_dev_con;
 static uintptr_t memmap_dev_handle;
 
+/* Set once a device has been initialised, see init_dev() */
+static int fip_dev_ready;
+static int memmap_dev_ready;
+
 static const io_block_spec_t fip_block_spec = {
 	.offset = PLAT_ARM_FIP_BASE,
 	.length = PLAT_ARM_FIP_MAX_SIZE
@@ -207,10 +211,41 @@ static const struct plat_io_policy policies[] = {
 #endif /* TRUSTED_BOARD_BOOT */
 };
 
+/*
+ * Source on which each image has been found, so that later lookups go straight
+ * to it instead of trying first a source where the image is not available
+ */
+#define IMAGE_SOURCE_UNKNOWN	0
+#define IMAGE_SOURCE_PRIMARY	1
+#define IMAGE_SOURCE_ALT	2
+
+static unsigned char image_source[ARRAY_SIZE(policies)];
+
 
 /* Weak definitions may be overridden in specific ARM standard platform */
 #pragma weak plat_arm_io_setup
 #pragma weak plat_arm_get_alt_image_source
+#pragma weak plat_arm_prefer_alt_image_source
+
+
+/*
+ * Initialise a device before looking up an image on it. With KEEP_IO_DEV_OPEN
+ * nothing closes the device connections opened by arm_io_setup(), so the
+ * device only needs initialising once and later lookups reuse it as is.
+ */
+static int init_dev(uintptr_t dev_handle, uintptr_t init_params, int *ready)
+{
+	int result;
+
+#if KEEP_IO_DEV_OPEN
+	if (*ready)
+		return 0;
+#endif
+	result = io_dev_init(dev_handle, init_params);
+	*ready = (result == 0);
+
+	return result;
+}
 
 
 static int open_fip(const uintptr_t spec)
@@ -219,7 +254,8 @@ static int open_fip(const uintptr_t spec)
 	uintptr_t local_image_handle;
 
 	/* See if a Firmware Image Package is available */
-	result = io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID);
+	result = init_dev(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID,
+			  &fip_dev_ready);
 	if (result == 0) {
 		result = io_open(fip_dev_handle, spec, &local_image_handle);
 		if (result == 0) {
@@ -236,7 +272,7 @@ static int open_memmap(const uintptr_t spec)
 	int result;
 	uintptr_t local_image_handle;
 
-	result = io_dev_init(memmap_dev_handle, (uintptr_t)NULL);
+	result = init_dev(memmap_dev_handle, (uintptr_t)NULL, &memmap_dev_ready);
 	if (result == 0) {
 		result = io_open(memmap_dev_handle, spec, &local_image_handle);
 		if (result == 0) {
@@ -285,25 +321,74 @@ int plat_arm_get_alt_image_source(
 	return -ENOENT;
 }
 
+int plat_arm_prefer_alt_image_source(unsigned int image_id __unused)
+{
+	/* By default the FIP is tried first */
+	return 0;
+}
+
+static int get_primary_image_source(const struct plat_io_policy *policy,
+				    uintptr_t *dev_handle,
+				    uintptr_t *image_spec)
+{
+	int result;
+
+	result = policy->check(policy->image_spec);
+	if (result == 0) {
+		*image_spec = policy->image_spec;
+		*dev_handle = *(policy->dev_handle);
+	}
+
+	return result;
+}
+
 /* Return an IO device handle and specification which can be used to access
  * an image. Use this to enforce platform load policy */
 int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 			  uintptr_t *image_spec)
 {
-	int result;
+	int result, alt_first;
 	const struct plat_io_policy *policy;
 
 	assert(image_id < ARRAY_SIZE(policies));
 
 	policy = &policies[image_id];
-	result = policy->check(policy->image_spec);
+
+	/*
+	 * Use the source the image has been found on before. If it fails, all
+	 * the sources are tried again on the next lookup.
+	 */
+	if (image_source[image_id] != IMAGE_SOURCE_UNKNOWN) {
+		if (image_source[image_id] == IMAGE_SOURCE_PRIMARY)
+			result = get_primary_image_source(policy, dev_handle,
+							  image_spec);
+		else
+			result = plat_arm_get_alt_image_source(image_id,
+						dev_handle, image_spec);
+		if (result != 0)
+			image_source[image_id] = IMAGE_SOURCE_UNKNOWN;
+		return result;
+	}
+
+	alt_first = plat_arm_prefer_alt_image_source(image_id);
+	if (alt_first) {
+		result = plat_arm_get_alt_image_source(image_id, dev_handle,
+						       image_spec);
+		if (result == 0) {
+			image_source[image_id] = IMAGE_SOURCE_ALT;
+			return 0;
+		}
+	}
+
+	result = get_primary_image_source(policy, dev_handle, image_spec);
 	if (result == 0) {
-		*image_spec = policy->image_spec;
-		*dev_handle = *(policy->dev_handle);
-	} else {
+		image_source[image_id] = IMAGE_SOURCE_PRIMARY;
+	} else if (!alt_first) {
 		VERBOSE("Trying alternative IO\n");
 		result = plat_arm_get_alt_image_source(image_id, dev_handle,
 						       image_spec);
+		if (result == 0)
+			image_source[image_id] = IMAGE_SOURCE_ALT;
 	}
 
 	return result;
@@ -317,7 +402,8 @@ int arm_io_is_toc_valid(void)
 {
 	int result;
 
-	result = io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID);
+	result = init_dev(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID,
+			  &fip_dev_ready);
 
 	return (result == 0);
 }
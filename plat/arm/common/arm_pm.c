@@ -31,6 +31,8 @@
 #include <arch_helpers.h>
 #include <arm_def.h>
 #include <arm_gic.h>
+#include <arm_hang_detect.h>
+#include <arm_tzc_fault.h>
 #include <assert.h>
 #include <console.h>
 #include <errno.h>
@@ -171,6 +173,8 @@ void arm_system_pwr_domain_resume(void)
 	 */
 	plat_arm_gic_init();
 	plat_arm_security_setup();
+	arm_tzc_fault_setup();
+	arm_hang_detect_setup();
 	arm_configure_sys_timer();
 }
 
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arm_boot_ts.h>
+#include <arm_sip_svc.h>
+#include <arm_tzc_fault.h>
+#include <bakery_lock.h>
+#include <console_buffer.h>
+#include <debug.h>
+#include <el3_telemetry.h>
+#include <errata_report.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <psci_export.h>
+#include <psci_latency.h>
+#include <psci_trace.h>
+#include <runtime_svc.h>
+#include <smc_stats.h>
+#include <spd_trace.h>
+#include <stdint.h>
+
+/*
+ * Handler of ARM_SIP_CPU_ON_BATCH. It builds the list of MPIDRs of the target
+ * CPUs and turns them on through a single batched PSCI request.
+ */
+static int arm_sip_cpu_on_batch(u_register_t target_affinity,
+				uint64_t target_list,
+				uintptr_t entrypoint,
+				u_register_t context_id,
+				uint64_t *on_list)
+{
+	u_register_t target_cpus[ARM_SIP_CPU_ON_BATCH_MAX];
+	unsigned int i, n, num_cpus = 0;
+	uint64_t on_mask;
+	int rc;
+
+	if (target_list & ~((1ULL << ARM_SIP_CPU_ON_BATCH_MAX) - 1)) {
+		*on_list = 0;
+		return PSCI_E_INVALID_PARAMS;
+	}
+
+	target_affinity &= MPIDR_AFFINITY_MASK &
+			~(MPIDR_AFFLVL_MASK << MPIDR_AFF0_SHIFT);
+
+	for (i = 0; i < ARM_SIP_CPU_ON_BATCH_MAX; i++) {
+		if (target_list & (1ULL << i))
+			target_cpus[num_cpus++] = target_affinity |
+						  (i << MPIDR_AFF0_SHIFT);
+	}
+
+	rc = psci_cpu_on_batch(target_cpus, num_cpus, entrypoint, context_id,
+			       &on_mask);
+
+	/* Convert the mask of target_cpus[] back into a target list */
+	*on_list = 0;
+	for (i = 0, n = 0; i < ARM_SIP_CPU_ON_BATCH_MAX; i++) {
+		if (!(target_list & (1ULL << i)))
+			continue;
+
+		if (on_mask & (1ULL << n))
+			*on_list |= 1ULL << i;
+		n++;
+	}
+
+	return rc;
+}
+
+/*
+ * Top-level SiP Service SMC handler of the ARM standard platforms.
+ */
+static uint64_t arm_sip_handler(uint32_t smc_fid,
+				uint64_t x1,
+				uint64_t x2,
+				uint64_t x3,
+				uint64_t x4,
+				void *cookie,
+				void *handle,
+				uint64_t flags)
+{
+	int rc;
+	uint64_t on_list;
+#if ENABLE_PSCI_TRACE
+	psci_trace_entry_t entry;
+	uint64_t next_seq;
+#endif
+#if ENABLE_LOCK_PROFILING
+	lock_profile_t profile;
+#endif
+#if ARM_BOOT_TIMESTAMPS
+	arm_boot_ts_rec_t ts_rec;
+	unsigned int num_recs;
+#endif
+#if ARM_TZC_FAULT_HANDLER
+	tzc_fail_info_t fail_info;
+	unsigned int next_fault_seq;
+#endif
+#if REPORT_ERRATA
+	unsigned int erratum_id, erratum_status, num_errata;
+	uint64_t reset_ticks;
+#endif
+
+#if SMC_LATENCY_STATS
+	if (is_smc_stats_fid(smc_fid)) {
+		return smc_stats_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					     handle, flags);
+	}
+#endif
+
+#if SPD_TRACE
+	if (is_spd_trace_fid(smc_fid)) {
+		return spd_trace_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					     handle, flags);
+	}
+#endif
+
+#if CONSOLE_BUFFERED
+	if (is_console_buf_fid(smc_fid)) {
+		return console_buffer_smc_handler(smc_fid, x1, x2, x3, x4,
+						  cookie, handle, flags);
+	}
+#endif
+
+#if PSCI_STATE_LATENCY
+	if (is_psci_latency_fid(smc_fid)) {
+		return psci_latency_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+						handle, flags);
+	}
+#endif
+
+#if PSCI_STATE_EXPORT
+	if (is_psci_export_fid(smc_fid)) {
+		return psci_export_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					       handle, flags);
+	}
+#endif
+
+#if EL3_TELEMETRY
+	if (is_el3_telemetry_fid(smc_fid)) {
+		return el3_telemetry_smc_handler(smc_fid, x1, x2, x3, x4,
+						 cookie, handle, flags);
+	}
+#endif
+
+	switch (smc_fid) {
+	case ARM_SIP_CPU_ON_BATCH:
+		if (is_caller_secure(flags))
+			break;
+
+		rc = arm_sip_cpu_on_batch(x1, x2, x3, x4, &on_list);
+		SMC_RET2(handle, rc, on_list);
+
+#if ENABLE_PSCI_TRACE
+	case ARM_SIP_PSCI_TRACE_READ:
+		if (is_caller_secure(flags))
+			break;
+
+		if (x1 >= PLATFORM_CORE_COUNT)
+			SMC_RET1(handle, PSCI_TRACE_E_NOT_AVAIL);
+
+		rc = psci_trace_read(x1, x2, &entry, &next_seq);
+		SMC_RET4(handle, rc, entry.timestamp,
+			 ((uint64_t)entry.arg << 32) | entry.event, next_seq);
+#endif
+
+#if ENABLE_LOCK_PROFILING
+	case ARM_SIP_LOCK_PROFILE_READ:
+		if (is_caller_secure(flags))
+			break;
+
+		if (x1 > UINT32_MAX || !bakery_lock_read_profile(x1, &profile))
+			SMC_RET1(handle, ARM_SIP_E_NOT_AVAIL);
+
+		SMC_RET4(handle, 0,
+			 (profile.contended_count << 32) |
+			 (uint32_t)profile.acquire_count,
+			 profile.wait_ticks, profile.max_wait_ticks);
+#endif
+
+#if ARM_BOOT_TIMESTAMPS
+	case ARM_SIP_BOOT_TS_READ:
+		if (is_caller_secure(flags))
+			break;
+
+		if (x1 > UINT32_MAX || arm_boot_ts_read(x1, &ts_rec, &num_recs))
+			SMC_RET1(handle, ARM_SIP_E_NOT_AVAIL);
+
+		SMC_RET4(handle, 0, ((uint64_t)ts_rec.arg << 32) | ts_rec.id,
+			 ts_rec.timestamp, num_recs);
+#endif
+
+#if RUNTIME_LOG_LEVEL
+	case ARM_SIP_SET_LOG_LEVEL:
+		if (is_caller_secure(flags))
+			break;
+
+		if (x1 > LOG_LEVEL_VERBOSE)
+			SMC_RET2(handle, ARM_SIP_E_INVALID_PARAMS, tf_log_level);
+
+		rc = tf_log_level;
+		tf_log_level = x1;
+		SMC_RET2(handle, 0, rc);
+#endif
+
+#if ARM_TZC_FAULT_HANDLER
+	case ARM_SIP_TZC_FAULT_READ:
+		if (is_caller_secure(flags))
+			break;
+
+		if (x1 > UINT32_MAX ||
+		    arm_tzc_fault_read(x1, &fail_info, &next_fault_seq))
+			SMC_RET1(handle, ARM_SIP_E_NOT_AVAIL);
+
+		SMC_RET4(handle, 0, fail_info.address,
+			 ((uint64_t)fail_info.id << 32) | fail_info.control,
+			 ((uint64_t)fail_info.filter << 32) | next_fault_seq);
+#endif
+
+#if REPORT_ERRATA
+	case ARM_SIP_ERRATA_READ:
+		if (is_caller_secure(flags))
+			break;
+
+		if (x1 >= PLATFORM_CORE_COUNT || x2 > UINT32_MAX)
+			SMC_RET1(handle, ARM_SIP_E_NOT_AVAIL);
+
+		erratum_id = 0;
+		erratum_status = 0;
+		num_errata = 0;
+		reset_ticks = 0;
+		rc = errata_report_read(x1, x2, &erratum_id, &erratum_status,
+					&reset_ticks, &num_errata);
+		SMC_RET4(handle, rc ? ARM_SIP_E_NOT_AVAIL : 0,
+			 ((uint64_t)erratum_status << 32) | erratum_id,
+			 reset_ticks, num_errata);
+#endif
+
+#if MEASURE_STACK_USAGE
+	case ARM_SIP_STACK_USAGE:
+		if (is_caller_secure(flags))
+			break;
+
+		if (x1 >= PLATFORM_CORE_COUNT)
+			SMC_RET1(handle, ARM_SIP_E_NOT_AVAIL);
+
+		SMC_RET3(handle, 0, plat_get_stack_usage(x1),
+			 PLATFORM_STACK_SIZE);
+#endif
+
+	default:
+		break;
+	}
+
+	WARN("Unimplemented ARM SiP Service Call: 0x%x\n", smc_fid);
+	SMC_RET1(handle, SMC_UNK);
+}
+
+/* Register the ARM SiP Service Calls as runtime service */
+DECLARE_RT_SVC(
+		arm_sip_svc,
+
+		OEN_SIP_START,
+		OEN_SIP_END,
+		SMC_TYPE_FAST,
+		NULL,
+		arm_sip_handler
+);
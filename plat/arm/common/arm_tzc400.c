@@ -29,6 +29,7 @@
  */
 
 #include <arm_def.h>
+#include <bl_common.h>
 #include <debug.h>
 #include <platform_def.h>
 #include <tzc400.h>
@@ -37,6 +38,34 @@
 /* Weak definitions may be overridden in specific ARM standard platform */
 #pragma weak plat_arm_security_setup
 
+#ifndef EL3_PAYLOAD_BASE
+static const tzc_region_t arm_tzc_regions[] = {
+	/* Region 1 set to cover Secure part of DRAM */
+	{ PLAT_ARM_TZC_FILTERS, 1,
+	  ARM_AP_TZC_DRAM1_BASE, ARM_AP_TZC_DRAM1_END,
+	  TZC_REGION_S_RDWR, 0 },
+	/*
+	 * Region 2 set to cover Non-Secure access to 1st DRAM address range.
+	 * Apply the same configuration to given filters in the TZC.
+	 */
+	{ PLAT_ARM_TZC_FILTERS, 2,
+	  ARM_NS_DRAM1_BASE, ARM_NS_DRAM1_END,
+	  TZC_REGION_S_NONE, PLAT_ARM_TZC_NS_DEV_ACCESS },
+	/* Region 3 set to cover Non-Secure access to 2nd DRAM address range */
+	{ PLAT_ARM_TZC_FILTERS, 3,
+	  ARM_DRAM2_BASE, ARM_DRAM2_END,
+	  TZC_REGION_S_NONE, PLAT_ARM_TZC_NS_DEV_ACCESS }
+};
+#endif /* EL3_PAYLOAD_BASE */
+
+#if IMAGE_BL31
+/*
+ * Copy of the TZC configuration taken at cold boot. It is written back when
+ * resuming from system suspend instead of programming the TZC again.
+ */
+static tzc_state_t arm_tzc_state;
+static int arm_tzc_state_saved;
+#endif
 
 /*******************************************************************************
  * Initialize the TrustZone Controller for ARM standard platforms.
@@ -47,9 +76,19 @@
  *
  * When booting an EL3 payload, this is simplified: we configure region 0 with
  * secure access only and do not enable any other region.
+ *
+ * In BL31, the configuration is saved the first time and restored on the
+ * following calls, which happen on resume from system suspend.
  ******************************************************************************/
 void arm_tzc_setup(void)
 {
+#if IMAGE_BL31
+	if (arm_tzc_state_saved) {
+		tzc_restore_state(&arm_tzc_state);
+		return;
+	}
+#endif
+
 	INFO("Configuring TrustZone Controller\n");
 
 	tzc_init(PLAT_ARM_TZC_BASE);
@@ -61,24 +100,8 @@ void arm_tzc_setup(void)
 	/* Region 0 set to no access by default */
 	tzc_configure_region0(TZC_REGION_S_NONE, 0);
 
-	/* Region 1 set to cover Secure part of DRAM */
-	tzc_configure_region(PLAT_ARM_TZC_FILTERS, 1,
-			ARM_AP_TZC_DRAM1_BASE, ARM_AP_TZC_DRAM1_END,
-			TZC_REGION_S_RDWR,
-			0);
-
-	/* Region 2 set to cover Non-Secure access to 1st DRAM address range.
-	 * Apply the same configuration to given filters in the TZC. */
-	tzc_configure_region(PLAT_ARM_TZC_FILTERS, 2,
-			ARM_NS_DRAM1_BASE, ARM_NS_DRAM1_END,
-			TZC_REGION_S_NONE,
-			PLAT_ARM_TZC_NS_DEV_ACCESS);
-
-	/* Region 3 set to cover Non-Secure access to 2nd DRAM address range */
-	tzc_configure_region(PLAT_ARM_TZC_FILTERS, 3,
-			ARM_DRAM2_BASE, ARM_DRAM2_END,
-			TZC_REGION_S_NONE,
-			PLAT_ARM_TZC_NS_DEV_ACCESS);
+	/* Regions 1 to 3 cover the Secure and Non-Secure DRAM */
+	tzc_configure_regions(arm_tzc_regions, ARRAY_SIZE(arm_tzc_regions));
 #else
 	/* Allow secure access only to DRAM for EL3 payloads. */
 	tzc_configure_region0(TZC_REGION_S_RDWR, 0);
@@ -92,6 +115,11 @@ void arm_tzc_setup(void)
 
 	/* Enable filters. */
 	tzc_enable_filters();
+
+#if IMAGE_BL31
+	tzc_save_state(&arm_tzc_state);
+	arm_tzc_state_saved = 1;
+#endif
 }
 
 void plat_arm_security_setup(void)
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <arm_tzc_fault.h>
+#include <assert.h>
+#include <debug.h>
+#include <interrupt_mgmt.h>
+#include <platform_def.h>
+#include <tzc400.h>
+
+#ifndef PLAT_ARM_TZC_IRQ
+#error "ARM_TZC_FAULT_HANDLER requires the platform to define PLAT_ARM_TZC_IRQ"
+#endif
+
+#define TZC_FAULT_RING_MASK	(ARM_TZC_FAULT_RING_SIZE - 1)
+
+/*
+ * Ring of the most recent faults. The GIC does not signal the TZC interrupt
+ * again until it has been completed, so the handler is the only writer and
+ * needs no lock. 'tzc_fault_seq' counts the faults ever recorded; a slot is
+ * filled before the count is published so that readers can detect both
+ * records which have not been written yet and records which have been
+ * overwritten while they were copying them.
+ */
+static tzc_fail_info_t tzc_fault_ring[ARM_TZC_FAULT_RING_SIZE];
+static volatile unsigned int tzc_fault_seq;
+
+/* Console rate limiting state, only used by the handler */
+static uint64_t tzc_fault_log_period;
+static uint64_t tzc_fault_last_log;
+static unsigned int tzc_fault_not_logged;
+static int tzc_fault_logged;
+
+static int tzc_fault_handler_registered;
+
+/*******************************************************************************
+ * Print a fault unless another one has been printed less than
+ * ARM_TZC_FAULT_LOG_PERIOD_MS ago.
+ ******************************************************************************/
+static void tzc_fault_log(const tzc_fail_info_t *info)
+{
+	uint64_t now = read_cntpct_el0();
+
+	if (tzc_fault_logged && (now - tzc_fault_last_log) <
+	    tzc_fault_log_period) {
+		tzc_fault_not_logged++;
+		return;
+	}
+
+	if (tzc_fault_not_logged) {
+		ERROR("TZC: %u faults not reported\n", tzc_fault_not_logged);
+		tzc_fault_not_logged = 0;
+	}
+
+	ERROR("TZC: filter %u denied %s %s access to 0x%lx (id 0x%x)\n",
+	      info->filter,
+	      (info->control & FAIL_CONTROL_NS_SHIFT) ? "NS" : "S",
+	      (info->control & FAIL_CONTROL_DIR_SHIFT) ? "write" : "read",
+	      info->address, info->id);
+
+	tzc_fault_last_log = now;
+	tzc_fault_logged = 1;
+}
+
+/*******************************************************************************
+ * Handler of the TZC interrupt. It records the fail status of each filter
+ * which has rejected an access, then clears their interrupt.
+ ******************************************************************************/
+static uint64_t tzc_fault_handler(uint32_t id,
+				  uint32_t flags,
+				  void *handle,
+				  void *cookie)
+{
+	uint32_t status, pending, filter;
+	unsigned int seq;
+
+	status = tzc_get_int_status();
+
+	for (pending = status; pending; pending &= pending - 1) {
+		filter = __builtin_ctz(pending);
+
+		seq = tzc_fault_seq;
+		tzc_get_fail_info(filter, &tzc_fault_ring[seq &
+							  TZC_FAULT_RING_MASK]);
+		dmbish();
+		tzc_fault_seq = seq + 1;
+
+		tzc_fault_log(&tzc_fault_ring[seq & TZC_FAULT_RING_MASK]);
+	}
+
+	tzc_clear_int(status);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Read back the fault with sequence number 'seq'. Returns 0 and the sequence
+ * number of the next fault to be recorded, or -1 if the fault has not been
+ * recorded yet or has already been overwritten.
+ ******************************************************************************/
+int arm_tzc_fault_read(unsigned int seq, tzc_fail_info_t *info,
+		       unsigned int *next_seq)
+{
+	unsigned int cur_seq;
+
+	assert(info && next_seq);
+
+	cur_seq = tzc_fault_seq;
+	dmbish();
+	if ((cur_seq - seq - 1) >= ARM_TZC_FAULT_RING_SIZE)
+		return -1;
+
+	*info = tzc_fault_ring[seq & TZC_FAULT_RING_MASK];
+	dmbish();
+
+	/* Check that the handler has not reused the slot in the meantime */
+	cur_seq = tzc_fault_seq;
+	if ((cur_seq - seq - 1) >= ARM_TZC_FAULT_RING_SIZE)
+		return -1;
+
+	*next_seq = cur_seq;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Make the TZC raise its interrupt on an access violation and register the
+ * handler of that interrupt at EL3 on the first call. Called at cold boot and
+ * after the TZC has been reprogrammed on resume from system suspend.
+ ******************************************************************************/
+void arm_tzc_fault_setup(void)
+{
+	uint32_t flags = 0;
+	int32_t rc;
+
+	if (!tzc_fault_handler_registered) {
+		tzc_init(PLAT_ARM_TZC_BASE);
+
+		tzc_fault_log_period = (read_cntfrq_el0() *
+					ARM_TZC_FAULT_LOG_PERIOD_MS) / 1000;
+
+		/* Take the interrupt at EL3 from both security states */
+		set_interrupt_rm_flag(flags, SECURE);
+		set_interrupt_rm_flag(flags, NON_SECURE);
+		rc = register_interrupt_handler(PLAT_ARM_TZC_IRQ,
+						tzc_fault_handler, flags);
+		if (rc) {
+			ERROR("TZC: cannot register the fault handler (%d)\n",
+			      rc);
+			panic();
+		}
+
+		tzc_fault_handler_registered = 1;
+	}
+
+	tzc_set_action(TZC_ACTION_ERR_INT);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -28,6 +28,8 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <arch_helpers.h>
+#include <arm_boot_ts.h>
 #include <bl_common.h>
 #include <css_def.h>
 #include <debug.h>
@@ -35,6 +37,7 @@
 #include <plat_arm.h>
 #include <string.h>
 #include "css_scp_bootloader.h"
+#include "css_scpi.h"
 
 /* Weak definition may be overridden in specific CSS based platform */
 #pragma weak bl2_plat_handle_scp_bl2
@@ -47,6 +50,8 @@ int bl2_plat_handle_scp_bl2(image_info_t *scp_bl2_image_info)
 {
 	int ret;
 
+	arm_boot_ts_mark(ARM_BOOT_TS_IMAGE_LOADED, SCP_BL2_IMAGE_ID);
+
 	INFO("BL2: Initiating SCP_BL2 transfer to SCP\n");
 
 	ret = scp_bootloader_transfer((void *)scp_bl2_image_info->image_base,
@@ -60,6 +65,80 @@ int bl2_plat_handle_scp_bl2(image_info_t *scp_bl2_image_info)
 	return ret;
 }
 
+#if CSS_SCP_BL2_DRAM_XFER
+/*******************************************************************************
+ * SCP_BL2 is loaded to the DRAM reserved for SCP, which is free at that point.
+ ******************************************************************************/
+void bl2_plat_get_scp_bl2_meminfo(meminfo_t *scp_bl2_meminfo)
+{
+	scp_bl2_meminfo->total_base = ARM_SCP_TZC_DRAM1_BASE;
+	scp_bl2_meminfo->total_size = ARM_SCP_TZC_DRAM1_SIZE;
+	scp_bl2_meminfo->free_base = ARM_SCP_TZC_DRAM1_BASE;
+	scp_bl2_meminfo->free_size = ARM_SCP_TZC_DRAM1_SIZE;
+}
+#endif
+
+#if defined(PLAT_CSS_BOOT_DVFS_DOMAIN) && !defined(EL3_PAYLOAD_BASE)
+/*
+ * Operating point of the boot cluster before BL2 raised it, or -1 if BL2 did
+ * not change it.
+ */
+static int css_boot_opp = -1;
+
+/*******************************************************************************
+ * Raise the cluster BL2 runs on to its highest operating point, SCP_BL2 being
+ * up by now, so that the AP images are authenticated at full speed.
+ ******************************************************************************/
+void bl2_platform_setup(void)
+{
+	unsigned int domain = PLAT_CSS_BOOT_DVFS_DOMAIN(read_mpidr_el1());
+	static scpi_dvfs_info_t info;
+	unsigned int i, max = 0;
+	int opp;
+
+	arm_bl2_platform_setup();
+
+	opp = scpi_get_dvfs(domain);
+	if (opp < 0 || scpi_get_dvfs_info(domain, &info) != 0 ||
+	    info.num_opps == 0) {
+		WARN("BL2: Failed to get the operating points of the boot "
+			"cluster\n");
+		return;
+	}
+
+	for (i = 1; i < info.num_opps; i++)
+		if (info.opps[i].freq > info.opps[max].freq)
+			max = i;
+
+	if ((int) max == opp)
+		return;
+
+	if (scpi_set_dvfs(domain, max) != 0) {
+		WARN("BL2: Failed to raise the boot cluster operating point\n");
+		return;
+	}
+
+	css_boot_opp = opp;
+	INFO("BL2: Boot cluster running at %u MHz\n",
+		info.opps[max].freq / 1000000);
+}
+
+/*******************************************************************************
+ * Bring the boot cluster back to the operating point it booted at before BL2
+ * hands over to BL31.
+ ******************************************************************************/
+void bl2_plat_flush_bl31_params(void)
+{
+	unsigned int domain = PLAT_CSS_BOOT_DVFS_DOMAIN(read_mpidr_el1());
+
+	if (css_boot_opp >= 0 && scpi_set_dvfs(domain, css_boot_opp) != 0)
+		WARN("BL2: Failed to restore the boot cluster operating "
+			"point\n");
+
+	arm_bl2_plat_flush_bl31_params();
+}
+#endif
+
 #ifdef EL3_PAYLOAD_BASE
 /*
  * We need to override some of the platform functions when booting an EL3
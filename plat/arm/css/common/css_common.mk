@@ -73,6 +73,34 @@ ifeq (${CSS_LOAD_SCP_IMAGES},1)
   BL2_SOURCES		+=	plat/arm/css/common/css_scp_bootloader.c
 endif
 
+# Flag used to load SCP_BL2 to the DRAM reserved for SCP and let SCP take it
+# from there with a single command.
+CSS_SCP_BL2_DRAM_XFER		:=	0
+
+# Process CSS_SCP_BL2_DRAM_XFER flag
+$(eval $(call assert_boolean,CSS_SCP_BL2_DRAM_XFER))
+$(eval $(call add_define,CSS_SCP_BL2_DRAM_XFER))
+
+ifeq (${CSS_SCP_BL2_DRAM_XFER},1)
+  ifneq (${CSS_LOAD_SCP_IMAGES},1)
+    $(error "CSS_SCP_BL2_DRAM_XFER requires CSS_LOAD_SCP_IMAGES=1")
+  endif
+endif
+
+# Flag used to let BL2 carry on loading the AP images once SCP_BL2 has been
+# transferred, BL31 waiting for SCP_BL2 to be ready before it first uses SCPI.
+CSS_DEFER_SCP_READY		:=	0
+
+# Process CSS_DEFER_SCP_READY flag
+$(eval $(call assert_boolean,CSS_DEFER_SCP_READY))
+$(eval $(call add_define,CSS_DEFER_SCP_READY))
+
+ifeq (${CSS_DEFER_SCP_READY},1)
+  ifdef EL3_PAYLOAD_BASE
+    $(error "CSS_DEFER_SCP_READY is not supported with EL3_PAYLOAD_BASE")
+  endif
+endif
+
 # Enable option to detect whether the SCP ROM firmware in use predates version
 # 1.7.0 and therefore, is incompatible.
 CSS_DETECT_PRE_1_7_0_SCP	:=	1
@@ -80,3 +108,26 @@ CSS_DETECT_PRE_1_7_0_SCP	:=	1
 # Process CSS_DETECT_PRE_1_7_0_SCP flag
 $(eval $(call assert_boolean,CSS_DETECT_PRE_1_7_0_SCP))
 $(eval $(call add_define,CSS_DETECT_PRE_1_7_0_SCP))
+
+# Number of MHU slots, in addition to the SCPI one, used to send power requests
+# to SCP without waiting for the ones of the other cpus to be taken.
+CSS_SCPI_POWER_SLOTS		:=	0
+
+# Process CSS_SCPI_POWER_SLOTS flag
+$(eval $(call add_define,CSS_SCPI_POWER_SLOTS))
+
+# Flag used to let the cpus which suspend before the last one of their cluster
+# record their power request for SCP instead of sending it.
+CSS_CLUSTER_PWR_REQ_COALESCE	:=	0
+
+# Process CSS_CLUSTER_PWR_REQ_COALESCE flag
+$(eval $(call assert_boolean,CSS_CLUSTER_PWR_REQ_COALESCE))
+$(eval $(call add_define,CSS_CLUSTER_PWR_REQ_COALESCE))
+
+# Flag used to make BL31 wait for the responses of SCP in WFI, woken up by the
+# MHU secure receive interrupt, instead of polling the MHU.
+CSS_MHU_WFI			:=	0
+
+# Process CSS_MHU_WFI flag
+$(eval $(call assert_boolean,CSS_MHU_WFI))
+$(eval $(call add_define,CSS_MHU_WFI))
@@ -32,6 +32,10 @@
 #include <assert.h>
 #include <bakery_lock.h>
 #include <css_def.h>
+#if CSS_MHU_WFI && IMAGE_BL31
+#include <gic_common.h>
+#include <gicv2.h>
+#endif
 #include <mmio.h>
 #include <platform_def.h>
 #include <plat_arm.h>
@@ -67,6 +71,18 @@ void mhu_secure_message_start(unsigned int slot_id)
 	arm_lock_get();
 
 	/* Make sure any previous command has finished */
+	mhu_secure_message_wait_sent(slot_id);
+}
+
+/*
+ * Wait until SCP has taken the last command sent on 'slot_id', after which the
+ * payload area of the slot may be reused. It allows several commands to be
+ * sent between a single pair of mhu_secure_message_start/end() calls.
+ */
+void mhu_secure_message_wait_sent(unsigned int slot_id)
+{
+	assert(slot_id <= MHU_MAX_SLOT_ID);
+
 	while (mmio_read_32(PLAT_CSS_MHU_BASE + CPU_INTR_S_STAT) &
 							(1 << slot_id))
 		;
@@ -82,12 +98,46 @@ void mhu_secure_message_send(unsigned int slot_id)
 	mmio_write_32(PLAT_CSS_MHU_BASE + CPU_INTR_S_SET, 1 << slot_id);
 }
 
+#if CSS_MHU_WFI && IMAGE_BL31
+/*
+ * Return whether the calling cpu can wait for the response of SCP in WFI. The
+ * MHU secure receive interrupt is a secure SPI, which the GIC signals to the
+ * cpu while it is asserted, i.e. until mhu_secure_message_end() clears the
+ * response. BL31 runs with FIQs masked, so the interrupt is never taken: it
+ * only wakes the cpu up from WFI. The SPI is targeted at the waiting cpu,
+ * which holds the MHU lock. The GIC does not signal it if the cpu interface
+ * is disabled, e.g. on the power down path, or if the cpu is handling an EL3
+ * interrupt, in which case the cpu polls instead.
+ */
+static int mhu_wfi_prepare(void)
+{
+	if (!gicv2_is_fiq_enabled() ||
+	    (gicv2_get_running_priority() != GIC_PRI_MASK))
+		return 0;
+
+	gicv2_set_spi_target_self(CSS_IRQ_MHU);
+
+	/* Make sure the SPI is targeted at this cpu before it waits */
+	dsbsy();
+
+	return 1;
+}
+#endif
+
 uint32_t mhu_secure_message_wait(void)
 {
 	/* Wait for response from SCP */
 	uint32_t response;
+#if CSS_MHU_WFI && IMAGE_BL31
+	int use_wfi = mhu_wfi_prepare();
+
+	while (!(response = mmio_read_32(PLAT_CSS_MHU_BASE + SCP_INTR_S_STAT)))
+		if (use_wfi)
+			wfi();
+#else
 	while (!(response = mmio_read_32(PLAT_CSS_MHU_BASE + SCP_INTR_S_STAT)))
 		;
+#endif
 
 	return response;
 }
@@ -105,6 +155,32 @@ void mhu_secure_message_end(unsigned int slot_id)
 	arm_lock_release();
 }
 
+/*
+ * Return whether SCP has yet to take the last command sent on 'slot_id'. It is
+ * used by callers which track the commands in flight on several slots.
+ */
+int mhu_secure_message_pending(unsigned int slot_id)
+{
+	assert(slot_id <= MHU_MAX_SLOT_ID);
+
+	return (mmio_read_32(PLAT_CSS_MHU_BASE + CPU_INTR_S_STAT) &
+							(1 << slot_id)) != 0;
+}
+
+/*
+ * Take and release the lock which serialises the users of the MHU secure
+ * channel without waiting for any slot to become free.
+ */
+void mhu_secure_lock(void)
+{
+	arm_lock_get();
+}
+
+void mhu_secure_unlock(void)
+{
+	arm_lock_release();
+}
+
 void mhu_secure_init(void)
 {
 	arm_lock_init();
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -35,8 +35,12 @@
 
 void mhu_secure_message_start(unsigned int slot_id);
 void mhu_secure_message_send(unsigned int slot_id);
+void mhu_secure_message_wait_sent(unsigned int slot_id);
 uint32_t mhu_secure_message_wait(void);
 void mhu_secure_message_end(unsigned int slot_id);
+int mhu_secure_message_pending(unsigned int slot_id);
+void mhu_secure_lock(void);
+void mhu_secure_unlock(void);
 
 void mhu_secure_init(void);
 
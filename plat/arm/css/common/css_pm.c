@@ -29,8 +29,11 @@
  */
 
 #include <arch_helpers.h>
+#include <arm_hang_detect.h>
+#include <arm_tzc_fault.h>
 #include <assert.h>
 #include <cassert.h>
+#include <console.h>
 #include <css_pm.h>
 #include <debug.h>
 #include <errno.h>
@@ -97,17 +100,36 @@ int css_pwr_domain_on(u_register_t mpidr)
 	return PSCI_E_SUCCESS;
 }
 
+/*******************************************************************************
+ * Handler called when several CPUs are turned on by a single batched request.
+ * The SCPI power on requests are sent back-to-back.
+ ******************************************************************************/
+int css_pwr_domain_on_batch(const u_register_t *mpidr_list,
+			    unsigned int num_cpus)
+{
+	scpi_set_css_power_states(mpidr_list, num_cpus, scpi_power_on,
+				  scpi_power_on, scpi_power_on);
+
+	return PSCI_E_SUCCESS;
+}
+
 static void css_pwr_domain_on_finisher_common(
 		const psci_power_state_t *target_state)
 {
 	assert(CSS_CORE_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF);
 
+#if CSS_CLUSTER_PWR_REQ_COALESCE
+	/* Drop the request this cpu may have recorded before it went down */
+	scpi_clear_css_power_state(read_mpidr_el1());
+#endif
+
 	/*
 	 * Perform the common cluster specific operations i.e enable coherency
-	 * if this cluster was off.
+	 * if this cluster was off. The interconnect is not waited for here, so
+	 * that the rest of the finisher overlaps with it.
 	 */
 	if (CSS_CLUSTER_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF)
-		plat_arm_interconnect_enter_coherency();
+		plat_arm_interconnect_enter_coherency_async();
 }
 
 /*******************************************************************************
@@ -130,6 +152,10 @@ void css_pwr_domain_on_finish(const psci_power_state_t *target_state)
 
 	/* Enable the gic cpu interface */
 	plat_arm_gic_cpuif_enable();
+
+	/* The generic code relies on coherency from here on */
+	if (CSS_CLUSTER_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF)
+		plat_arm_interconnect_wait_coherency();
 }
 
 /*******************************************************************************
@@ -146,9 +172,16 @@ static void css_power_down_common(const psci_power_state_t *target_state)
 	/* Prevent interrupts from spuriously waking up this cpu */
 	plat_arm_gic_cpuif_disable();
 
-	/* Check if power down at system power domain level is requested */
-	if (CSS_SYSTEM_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF)
-			system_state = scpi_power_retention;
+	/*
+	 * Check if power down at system power domain level is requested. This
+	 * cpu is then the last one running, so let the interconnect drop into
+	 * its low power state as well.
+	 */
+	if (CSS_SYSTEM_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF) {
+		arm_hang_detect_stop();
+		plat_arm_interconnect_enter_system_idle();
+		system_state = scpi_power_retention;
+	}
 
 	/* Cluster is to be turned off, so disable coherency */
 	if (CSS_CLUSTER_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF) {
@@ -190,6 +223,21 @@ void css_pwr_domain_suspend(const psci_power_state_t *target_state)
 		return;
 
 	assert(CSS_CORE_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF);
+
+#if CSS_CLUSTER_PWR_REQ_COALESCE
+	/*
+	 * A cpu which is not the last one of its cluster to suspend only
+	 * records its request. The last cpu, which PSCI asks to power the
+	 * cluster off, sends the single request for the whole cluster.
+	 */
+	if (CSS_CLUSTER_PWR_STATE(target_state) != ARM_LOCAL_STATE_OFF) {
+		plat_arm_gic_cpuif_disable();
+		scpi_record_css_power_state(read_mpidr_el1(), scpi_power_off,
+					    scpi_power_on, scpi_power_on);
+		return;
+	}
+#endif
+
 	css_power_down_common(target_state);
 }
 
@@ -207,14 +255,32 @@ void css_pwr_domain_suspend_finish(
 	if (CSS_CORE_PWR_STATE(target_state) == ARM_LOCAL_STATE_RET)
 		return;
 
+	css_pwr_domain_on_finisher_common(target_state);
+
+#if PSCI_SYS_SUSPEND_OPS
+	/*
+	 * The PSCI system suspend handlers have already restored the system
+	 * components, and the gic cpu interface with them, if woken up from
+	 * system suspend.
+	 */
+	if (CSS_SYSTEM_PWR_STATE(target_state) != ARM_LOCAL_STATE_OFF)
+		plat_arm_gic_cpuif_enable();
+#else
 	/* Perform system domain restore if woken up from system suspend */
 	if (CSS_SYSTEM_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF)
 		arm_system_pwr_domain_resume();
 	else
 		/* Enable the gic cpu interface */
 		plat_arm_gic_cpuif_enable();
+#endif
 
-	css_pwr_domain_on_finisher_common(target_state);
+	/* The generic code relies on coherency from here on */
+	if (CSS_CLUSTER_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF)
+		plat_arm_interconnect_wait_coherency();
+
+	/* Restore the interconnect if the whole system was idle */
+	if (CSS_SYSTEM_PWR_STATE(target_state) == ARM_LOCAL_STATE_OFF)
+		plat_arm_interconnect_exit_system_idle();
 }
 
 /*******************************************************************************
@@ -292,12 +358,61 @@ void css_get_sys_suspend_power_state(psci_power_state_t *req_state)
 		req_state->pwr_domain_state[i] = ARM_LOCAL_STATE_OFF;
 }
 
+#if PSCI_SYS_SUSPEND_OPS
+/*******************************************************************************
+ * Handlers restoring the system components of CSS platforms after a system
+ * suspend, in place of arm_system_pwr_domain_resume(). None of them needs any
+ * state to be saved. PSCI calls them when the highest power level has been
+ * powered down, which must be the system power domain.
+ ******************************************************************************/
+CASSERT(PLAT_MAX_PWR_LVL == ARM_PWR_LVL2, assert_css_sys_suspend_pwr_lvl);
+
+#define CSS_SYS_SUSPEND_ORDER_CONSOLE	0
+#define CSS_SYS_SUSPEND_ORDER_GIC	10
+#define CSS_SYS_SUSPEND_ORDER_SECURITY	20
+#define CSS_SYS_SUSPEND_ORDER_TIMER	30
+
+static void css_console_restore(const void *state)
+{
+	console_init(PLAT_ARM_BL31_RUN_UART_BASE,
+		     PLAT_ARM_BL31_RUN_UART_CLK_IN_HZ, ARM_CONSOLE_BAUDRATE);
+}
+
+static void css_gic_restore(const void *state)
+{
+	/* Initializes the distributor and the interfaces of this cpu */
+	plat_arm_gic_init();
+}
+
+static void css_security_restore(const void *state)
+{
+	plat_arm_security_setup();
+	arm_tzc_fault_setup();
+	arm_hang_detect_setup();
+}
+
+static void css_sys_timer_restore(const void *state)
+{
+	arm_configure_sys_timer();
+}
+
+DECLARE_PSCI_SYS_SUSPEND_OPS(css_console, CSS_SYS_SUSPEND_ORDER_CONSOLE, 0,
+			     NULL, css_console_restore);
+DECLARE_PSCI_SYS_SUSPEND_OPS(css_gic, CSS_SYS_SUSPEND_ORDER_GIC, 0,
+			     NULL, css_gic_restore);
+DECLARE_PSCI_SYS_SUSPEND_OPS(css_security, CSS_SYS_SUSPEND_ORDER_SECURITY, 0,
+			     NULL, css_security_restore);
+DECLARE_PSCI_SYS_SUSPEND_OPS(css_sys_timer, CSS_SYS_SUSPEND_ORDER_TIMER, 0,
+			     NULL, css_sys_timer_restore);
+#endif /* PSCI_SYS_SUSPEND_OPS */
+
 /*******************************************************************************
  * Export the platform handlers via plat_arm_psci_pm_ops. The ARM Standard
  * platform will take care of registering the handlers with PSCI.
  ******************************************************************************/
 const plat_psci_ops_t plat_arm_psci_pm_ops = {
 	.pwr_domain_on		= css_pwr_domain_on,
+	.pwr_domain_on_batch	= css_pwr_domain_on_batch,
 	.pwr_domain_on_finish	= css_pwr_domain_on_finish,
 	.pwr_domain_off		= css_pwr_domain_off,
 	.cpu_standby		= css_cpu_standby,
@@ -44,6 +44,7 @@
 /* Boot commands sent from AP -> SCP */
 #define BOOT_CMD_INFO	0x00
 #define BOOT_CMD_DATA	0x01
+#define BOOT_CMD_LOAD	0x02
 
 /* BOM command header */
 typedef struct {
@@ -112,6 +113,125 @@ static void scp_boot_message_end(void)
 	mhu_secure_message_end(BOM_MHU_SLOT_ID);
 }
 
+/*
+ * Wait for SCP to signal that the image it has been given is running. BL2
+ * leaves it to BL31 when CSS_DEFER_SCP_READY is set, so that it can load the
+ * AP images while SCP boots.
+ */
+static int scp_bootloader_wait_ready(void)
+{
+#if CSS_DEFER_SCP_READY && IMAGE_BL2
+	VERBOSE("Not waiting for SCP to signal it is ready\n");
+
+	return 0;
+#else
+	VERBOSE("Waiting for SCP to signal it is ready to go on\n");
+
+	return scpi_wait_ready();
+#endif
+}
+
+#if CSS_SCP_BL2_DRAM_XFER
+/*
+ * Payload of the command which describes an image SCP has to take from memory
+ * in one go. The checksum of the image has already been verified by the AP.
+ */
+typedef struct {
+	uint32_t addr_lo;
+	uint32_t addr_hi;
+	uint32_t image_size;
+	uint32_t checksum;
+} cmd_load_payload_t;
+
+/*
+ * Checksum of SCP_BL2 computed while it is loaded, i.e. the sum of the 32-bit
+ * words of the image which follow the checksum word.
+ */
+static uint32_t scp_bl2_checksum;
+static uint32_t scp_bl2_word;
+static size_t scp_bl2_loaded;
+
+void bl2_plat_image_chunk_loaded(unsigned int image_id, uintptr_t buffer,
+				 size_t length)
+{
+	const uint8_t *p = (const uint8_t *) buffer;
+	unsigned int shift;
+
+	if (image_id != SCP_BL2_IMAGE_ID)
+		return;
+
+	/* The image is being loaded again */
+	if (buffer == SCP_BL2_BASE) {
+		scp_bl2_checksum = 0;
+		scp_bl2_word = 0;
+		scp_bl2_loaded = 0;
+	}
+
+	/* Add the whole words while the chunk is word aligned */
+	for (; length >= 4 && (scp_bl2_loaded % 4) == 0; length -= 4) {
+		if (scp_bl2_loaded != 0)
+			scp_bl2_checksum += *(const uint32_t *) p;
+		p += 4;
+		scp_bl2_loaded += 4;
+	}
+
+	/* Assemble the words which straddle two chunks byte by byte */
+	for (; length != 0; length--) {
+		shift = (scp_bl2_loaded % 4) * 8;
+		scp_bl2_word |= (uint32_t) *p++ << shift;
+		if (shift == 24) {
+			if (scp_bl2_loaded != 3)
+				scp_bl2_checksum += scp_bl2_word;
+			scp_bl2_word = 0;
+		}
+		scp_bl2_loaded++;
+	}
+}
+
+/*
+ * Ask SCP to take SCP_BL2 from the DRAM reserved for SCP, where it has been
+ * loaded, with a single command. SCP does not need to verify the checksum as
+ * the AP has already done it while the image was being loaded.
+ */
+static int scp_bootloader_load(void *image, unsigned int image_size,
+			       uint32_t checksum)
+{
+	cmd_load_payload_t *cmd_load_payload;
+	uint32_t response;
+
+	if (scp_bl2_loaded != image_size + sizeof(checksum) ||
+	    scp_bl2_checksum != checksum) {
+		ERROR("SCP_BL2 checksum mismatch (expected 0x%x, got 0x%x)\n",
+			checksum, scp_bl2_checksum);
+		return -1;
+	}
+
+	mhu_secure_init();
+
+	VERBOSE("Send SCP_BL2 image location to SCP\n");
+
+	scp_boot_message_start();
+
+	BOM_CMD_HEADER->id = BOOT_CMD_LOAD;
+	cmd_load_payload = BOM_CMD_PAYLOAD;
+	cmd_load_payload->addr_lo = (uint64_t) (uintptr_t) image & 0xffffffff;
+	cmd_load_payload->addr_hi = (uint64_t) (uintptr_t) image >> 32;
+	cmd_load_payload->image_size = image_size;
+	cmd_load_payload->checksum = checksum;
+
+	scp_boot_message_send(sizeof(*cmd_load_payload));
+	response = scp_boot_message_wait(sizeof(response));
+	scp_boot_message_end();
+
+	if (response != 0) {
+		ERROR("SCP BOOT_CMD_LOAD returned error %u\n", response);
+		return -1;
+	}
+
+	return scp_bootloader_wait_ready();
+}
+#endif /* CSS_SCP_BL2_DRAM_XFER */
+
 int scp_bootloader_transfer(void *image, unsigned int image_size)
 {
 	uint32_t response;
@@ -119,7 +239,8 @@ int scp_bootloader_transfer(void *image, unsigned int image_size)
 	cmd_info_payload_t *cmd_info_payload;
 	cmd_data_payload_t *cmd_data_payload;
 
-	assert((uintptr_t) image == SCP_BL2_BASE);
+	assert((uintptr_t) image == SCP_BL2_BASE ||
+	       (uintptr_t) image == SCP_BL2U_BASE);
 
 	if ((image_size == 0) || (image_size % 4 != 0)) {
 		ERROR("Invalid size for the SCP_BL2 image. Must be a multiple of "
@@ -133,6 +254,12 @@ int scp_bootloader_transfer(void *image, unsigned int image_size)
 	image = (char *) image + sizeof(checksum);
 	image_size -= sizeof(checksum);
 
+#if CSS_SCP_BL2_DRAM_XFER
+	/* SCP_BL2U is still transferred from Trusted RAM */
+	if ((uintptr_t) image == SCP_BL2_BASE + sizeof(checksum))
+		return scp_bootloader_load(image, image_size, checksum);
+#endif
+
 	mhu_secure_init();
 
 	VERBOSE("Send info about the SCP_BL2 image to be transferred to SCP\n");
@@ -194,8 +321,5 @@ int scp_bootloader_transfer(void *image, unsigned int image_size)
 		return -1;
 	}
 
-	VERBOSE("Waiting for SCP to signal it is ready to go on\n");
-
-	/* Wait for SCP to signal it's ready */
-	return scpi_wait_ready();
+	return scp_bootloader_wait_ready();
 }
@@ -30,6 +30,7 @@
 
 #include <arch_helpers.h>
 #include <assert.h>
+#include <cassert.h>
 #include <css_def.h>
 #include <debug.h>
 #include <platform.h>
@@ -45,10 +46,59 @@
 	((scpi_cmd_t *) SCPI_SHARED_MEM_AP_TO_SCP)
 #define SCPI_CMD_PAYLOAD_AP_TO_SCP		\
 	((void *) (SCPI_SHARED_MEM_AP_TO_SCP + sizeof(scpi_cmd_t)))
+#define SCPI_RES_PAYLOAD_SCP_TO_AP		\
+	((volatile uint32_t *) (SCPI_SHARED_MEM_SCP_TO_AP + sizeof(scpi_cmd_t)))
 
 /* ID of the MHU slot used for the SCPI protocol */
 #define SCPI_MHU_SLOT_ID		0
 
+#if CSS_SCPI_POWER_SLOTS
+/*
+ * The SET_CSS_POWER_STATE commands are sent on CSS_SCPI_POWER_SLOTS further
+ * MHU slots, following the SCPI slot. Each of them has its own payload area,
+ * following the one of the SCPI slot.
+ */
+#define SCPI_MAX_POWER_SLOTS		8
+#define SCPI_POWER_SLOT_MEM_SIZE	0x10
+
+#define SCPI_POWER_SLOT_ID(i)		(SCPI_MHU_SLOT_ID + 1 + (i))
+#define SCPI_POWER_SLOT_HEADER(i)					\
+	((scpi_cmd_t *) (SCPI_SHARED_MEM_AP_TO_SCP + 0x100		\
+				+ (uintptr_t) (i) * SCPI_POWER_SLOT_MEM_SIZE))
+#define SCPI_POWER_SLOT_PAYLOAD(i)					\
+	((void *) ((uintptr_t) SCPI_POWER_SLOT_HEADER(i) + sizeof(scpi_cmd_t)))
+
+CASSERT(CSS_SCPI_POWER_SLOTS <= SCPI_MAX_POWER_SLOTS,
+	assert_css_scpi_power_slots_too_many);
+
+/*
+ * Power request in flight on each of the power slots. The request is in flight
+ * from the time a cpu claims the slot until SCP has taken it off the MHU,
+ * which is when it completes as SCP does not reply to it. 'mpidr' identifies
+ * the cpu the request is for and is kept after the request has completed.
+ */
+typedef struct scpi_power_slot {
+	unsigned int mpidr;
+	unsigned int claimed;
+} scpi_power_slot_t;
+
+static volatile scpi_power_slot_t scpi_power_slots[CSS_SCPI_POWER_SLOTS];
+#endif
+
+#if CSS_CLUSTER_PWR_REQ_COALESCE
+/*
+ * Table of the power requests recorded by the cpus, indexed by core position.
+ * SCP acts on the requests recorded for the cpus of a cluster when it gets the
+ * request to power the cluster off.
+ */
+#define SCPI_PWR_REQ_TABLE_SIZE		0x100
+#define SCPI_PWR_REQ_TABLE						\
+	((volatile uint32_t *) (SCPI_SHARED_MEM_AP_TO_SCP + 0x200))
+
+CASSERT(PLATFORM_CORE_COUNT * sizeof(uint32_t) <= SCPI_PWR_REQ_TABLE_SIZE,
+	assert_scpi_pwr_req_table_too_small);
+#endif
+
 static void scpi_secure_message_start(void)
 {
 	mhu_secure_message_start(SCPI_MHU_SLOT_ID);
@@ -130,12 +180,37 @@ int scpi_wait_ready(void)
 	return status == SCP_OK ? 0 : -1;
 }
 
-void scpi_set_css_power_state(unsigned mpidr, scpi_power_state_t cpu_state,
-		scpi_power_state_t cluster_state, scpi_power_state_t css_state)
+#if CSS_DEFER_SCP_READY && IMAGE_BL31
+/*
+ * BL2 does not wait for SCP_BL2 to signal that it is ready, so BL31 does it
+ * before it sends the first SCPI command. Only the primary cpu can get here
+ * until then, as the other cpus are only powered on through SCPI.
+ */
+static int scpi_ready;
+
+static void scpi_wait_ready_once(void)
+{
+	if (scpi_ready)
+		return;
+
+	if (scpi_wait_ready() != 0) {
+		ERROR("SCP failed to signal it is ready\n");
+		panic();
+	}
+
+	scpi_ready = 1;
+}
+#else
+static void scpi_wait_ready_once(void)
+{
+}
+#endif
+
+static uint32_t scpi_css_power_state(unsigned mpidr,
+		scpi_power_state_t cpu_state, scpi_power_state_t cluster_state,
+		scpi_power_state_t css_state)
 {
-	scpi_cmd_t *cmd;
 	uint32_t state = 0;
-	uint32_t *payload_addr;
 
 	state |= mpidr & 0x0f;	/* CPU ID */
 	state |= (mpidr & 0xf00) >> 4;	/* Cluster ID */
@@ -143,7 +218,14 @@ void scpi_set_css_power_state(unsigned mpidr, scpi_power_state_t cpu_state,
 	state |= cluster_state << 12;
 	state |= css_state << 16;
 
-	scpi_secure_message_start();
+	return state;
+}
+
+#if !CSS_SCPI_POWER_SLOTS
+static void scpi_send_css_power_state(uint32_t state)
+{
+	scpi_cmd_t *cmd;
+	uint32_t *payload_addr;
 
 	/* Populate the command header */
 	cmd = SCPI_CMD_HEADER_AP_TO_SCP;
@@ -159,9 +241,182 @@ void scpi_set_css_power_state(unsigned mpidr, scpi_power_state_t cpu_state,
 	 * SCP does not reply to this command in order to avoid MHU interrupts
 	 * from the sender, which could interfere with its power state request.
 	 */
+}
+#endif
+
+#if CSS_SCPI_POWER_SLOTS
+static int scpi_power_slot_in_flight(unsigned int i)
+{
+	return scpi_power_slots[i].claimed ||
+		mhu_secure_message_pending(SCPI_POWER_SLOT_ID(i));
+}
+
+/*
+ * Claim a power slot to send a request for the cpu 'mpidr'. A request still in
+ * flight for the same cpu has to be taken by SCP before the new one so the
+ * slot it uses is waited for. Any free slot is claimed otherwise.
+ */
+static unsigned int scpi_power_slot_claim(unsigned int mpidr)
+{
+	unsigned int i, slot;
+
+	for (;;) {
+		slot = CSS_SCPI_POWER_SLOTS;
+
+		mhu_secure_lock();
+		for (i = 0; i < CSS_SCPI_POWER_SLOTS; i++) {
+			if (scpi_power_slots[i].mpidr == mpidr &&
+			    scpi_power_slot_in_flight(i)) {
+				slot = CSS_SCPI_POWER_SLOTS;
+				break;
+			}
+
+			if (slot == CSS_SCPI_POWER_SLOTS &&
+			    !scpi_power_slot_in_flight(i))
+				slot = i;
+		}
+
+		if (slot != CSS_SCPI_POWER_SLOTS) {
+			scpi_power_slots[slot].mpidr = mpidr;
+			scpi_power_slots[slot].claimed = 1;
+			mhu_secure_unlock();
+			return slot;
+		}
+		mhu_secure_unlock();
+	}
+}
+
+/*
+ * Send a power request on a power slot and return as soon as it is on the MHU.
+ * Several cpus may have requests in flight at the same time, each of them on
+ * its own slot.
+ */
+static void scpi_send_css_power_state_async(unsigned int mpidr, uint32_t state)
+{
+	scpi_cmd_t *cmd;
+	uint32_t *payload_addr;
+	unsigned int slot;
+
+	slot = scpi_power_slot_claim(mpidr);
+
+	cmd = SCPI_POWER_SLOT_HEADER(slot);
+	cmd->id = SCPI_CMD_SET_CSS_POWER_STATE;
+	cmd->set = SCPI_SET_NORMAL;
+	cmd->sender = 0;
+	cmd->size = sizeof(state);
+	payload_addr = SCPI_POWER_SLOT_PAYLOAD(slot);
+	*payload_addr = state;
+
+	/* Ensure that SCP sees the payload before the MHU register write */
+	dmbst();
+	mhu_secure_message_send(SCPI_POWER_SLOT_ID(slot));
+
+	/*
+	 * The slot remains in flight until SCP takes the request. Ensure that
+	 * the MHU register write has taken effect before the claim is dropped,
+	 * which does not need the lock as only the owner of a claim clears it.
+	 */
+	dsbsy();
+	scpi_power_slots[slot].claimed = 0;
+}
+
+/*
+ * Wait until SCP has taken all the power requests in flight. The caller holds
+ * the MHU lock so that no new request is sent meanwhile.
+ */
+static void scpi_power_slots_drain(void)
+{
+	unsigned int i;
 
+	for (i = 0; i < CSS_SCPI_POWER_SLOTS; i++)
+		while (scpi_power_slot_in_flight(i))
+			;
+}
+#endif
+
+void scpi_set_css_power_state(unsigned mpidr, scpi_power_state_t cpu_state,
+		scpi_power_state_t cluster_state, scpi_power_state_t css_state)
+{
+	uint32_t state = scpi_css_power_state(mpidr, cpu_state, cluster_state,
+					      css_state);
+
+	scpi_wait_ready_once();
+
+#if CSS_SCPI_POWER_SLOTS
+	scpi_send_css_power_state_async(mpidr, state);
+#else
+	scpi_secure_message_start();
+	scpi_send_css_power_state(state);
+	scpi_secure_message_end();
+#endif
+}
+
+/*
+ * Send the same power state request for each of the 'num_cpus' cpus in
+ * 'mpidr_list'. The requests are sent back-to-back while holding the MHU
+ * channel, each one as soon as SCP has taken the previous one.
+ */
+void scpi_set_css_power_states(const u_register_t *mpidr_list,
+		unsigned int num_cpus, scpi_power_state_t cpu_state,
+		scpi_power_state_t cluster_state, scpi_power_state_t css_state)
+{
+	unsigned int i;
+	uint32_t state;
+
+	assert(mpidr_list != NULL);
+
+	scpi_wait_ready_once();
+
+#if CSS_SCPI_POWER_SLOTS
+	/* Spread the requests over the power slots */
+	for (i = 0; i < num_cpus; i++) {
+		state = scpi_css_power_state(mpidr_list[i], cpu_state,
+					     cluster_state, css_state);
+		scpi_send_css_power_state_async(mpidr_list[i], state);
+	}
+#else
+	scpi_secure_message_start();
+	for (i = 0; i < num_cpus; i++) {
+		state = scpi_css_power_state(mpidr_list[i], cpu_state,
+					     cluster_state, css_state);
+		if (i != 0)
+			mhu_secure_message_wait_sent(SCPI_MHU_SLOT_ID);
+		scpi_send_css_power_state(state);
+	}
 	scpi_secure_message_end();
+#endif
+}
+
+#if CSS_CLUSTER_PWR_REQ_COALESCE
+/*
+ * Record the power state requested for the cpu 'mpidr' for SCP to act on when
+ * the last cpu of the cluster asks for the cluster to be powered off. No MHU
+ * message is sent. The encoding of the request never reads as 0 as the cpu
+ * is always to be turned off, which is how an empty entry is told apart.
+ */
+void scpi_record_css_power_state(unsigned mpidr, scpi_power_state_t cpu_state,
+		scpi_power_state_t cluster_state, scpi_power_state_t css_state)
+{
+	int idx = plat_core_pos_by_mpidr(mpidr);
+
+	assert(idx >= 0 && idx < PLATFORM_CORE_COUNT);
+	assert(cpu_state != scpi_power_on);
+
+	SCPI_PWR_REQ_TABLE[idx] = scpi_css_power_state(mpidr, cpu_state,
+						       cluster_state,
+						       css_state);
+}
+
+/* Drop any power request recorded for the cpu 'mpidr' */
+void scpi_clear_css_power_state(unsigned mpidr)
+{
+	int idx = plat_core_pos_by_mpidr(mpidr);
+
+	assert(idx >= 0 && idx < PLATFORM_CORE_COUNT);
+
+	SCPI_PWR_REQ_TABLE[idx] = 0;
 }
+#endif
 
 uint32_t scpi_sys_power_state(scpi_system_state_t system_state)
 {
@@ -169,8 +424,15 @@ uint32_t scpi_sys_power_state(scpi_system_state_t system_state)
 	uint8_t *payload_addr;
 	scpi_cmd_t response;
 
+	scpi_wait_ready_once();
+
 	scpi_secure_message_start();
 
+#if CSS_SCPI_POWER_SLOTS
+	/* SCP has to act on the power requests sent so far first */
+	scpi_power_slots_drain();
+#endif
+
 	/* Populate the command header */
 	cmd = SCPI_CMD_HEADER_AP_TO_SCP;
 	cmd->id = SCPI_CMD_SYS_POWER_STATE;
@@ -188,3 +450,127 @@ uint32_t scpi_sys_power_state(scpi_system_state_t system_state)
 
 	return response.status;
 }
+
+/*
+ * Read the operating points of the DVFS domain 'domain' into 'info', keeping
+ * the first SCPI_DVFS_MAX_OPPS of them. The SCP payload holds a word with the
+ * domain, the number of operating points and the transition latency, followed
+ * by a frequency and a voltage word for each operating point.
+ * Returns 0 on success, -1 otherwise.
+ */
+int scpi_get_dvfs_info(unsigned int domain, scpi_dvfs_info_t *info)
+{
+	scpi_cmd_t *cmd;
+	uint8_t *payload_addr;
+	scpi_cmd_t response;
+	volatile uint32_t *res_payload = SCPI_RES_PAYLOAD_SCP_TO_AP;
+	unsigned int num_opps, i;
+	uint32_t word;
+
+	assert(info != NULL);
+
+	scpi_wait_ready_once();
+
+	scpi_secure_message_start();
+
+	cmd = SCPI_CMD_HEADER_AP_TO_SCP;
+	cmd->id = SCPI_CMD_GET_DVFS_INFO;
+	cmd->set = SCPI_SET_NORMAL;
+	cmd->sender = 0;
+	cmd->size = sizeof(*payload_addr);
+	payload_addr = SCPI_CMD_PAYLOAD_AP_TO_SCP;
+	*payload_addr = domain & 0xff;
+	scpi_secure_message_send(sizeof(*payload_addr));
+
+	scpi_secure_message_receive(&response);
+
+	if (response.status != SCP_OK || response.size < sizeof(word)) {
+		scpi_secure_message_end();
+		return -1;
+	}
+
+	word = res_payload[0];
+	num_opps = (word >> 8) & 0xff;
+	if (response.size < sizeof(word) + num_opps * sizeof(scpi_opp_t)) {
+		scpi_secure_message_end();
+		return -1;
+	}
+
+	if (num_opps > SCPI_DVFS_MAX_OPPS)
+		num_opps = SCPI_DVFS_MAX_OPPS;
+	info->num_opps = num_opps;
+	info->latency = word >> 16;
+	for (i = 0; i < num_opps; i++) {
+		info->opps[i].freq = res_payload[1 + 2 * i];
+		info->opps[i].voltage = res_payload[2 + 2 * i];
+	}
+
+	scpi_secure_message_end();
+
+	return 0;
+}
+
+/*
+ * Return the index of the current operating point of the DVFS domain 'domain'
+ * or -1 on failure.
+ */
+int scpi_get_dvfs(unsigned int domain)
+{
+	scpi_cmd_t *cmd;
+	uint8_t *payload_addr;
+	scpi_cmd_t response;
+	int opp = -1;
+
+	scpi_wait_ready_once();
+
+	scpi_secure_message_start();
+
+	cmd = SCPI_CMD_HEADER_AP_TO_SCP;
+	cmd->id = SCPI_CMD_GET_DVFS;
+	cmd->set = SCPI_SET_NORMAL;
+	cmd->sender = 0;
+	cmd->size = sizeof(*payload_addr);
+	payload_addr = SCPI_CMD_PAYLOAD_AP_TO_SCP;
+	*payload_addr = domain & 0xff;
+	scpi_secure_message_send(sizeof(*payload_addr));
+
+	scpi_secure_message_receive(&response);
+
+	if (response.status == SCP_OK && response.size != 0)
+		opp = SCPI_RES_PAYLOAD_SCP_TO_AP[0] & 0xff;
+
+	scpi_secure_message_end();
+
+	return opp;
+}
+
+/*
+ * Move the DVFS domain 'domain' to its operating point of index 'opp'.
+ * Returns 0 on success, -1 otherwise.
+ */
+int scpi_set_dvfs(unsigned int domain, unsigned int opp)
+{
+	scpi_cmd_t *cmd;
+	uint16_t *payload_addr;
+	scpi_cmd_t response;
+
+	scpi_wait_ready_once();
+
+	scpi_secure_message_start();
+
+	cmd = SCPI_CMD_HEADER_AP_TO_SCP;
+	cmd->id = SCPI_CMD_SET_DVFS;
+	cmd->set = SCPI_SET_NORMAL;
+	cmd->sender = 0;
+	cmd->size = sizeof(*payload_addr);
+	/* The domain is in the first byte and the index in the second one */
+	payload_addr = SCPI_CMD_PAYLOAD_AP_TO_SCP;
+	*payload_addr = (domain & 0xff) | ((opp & 0xff) << 8);
+	scpi_secure_message_send(sizeof(*payload_addr));
+
+	scpi_secure_message_receive(&response);
+
+	scpi_secure_message_end();
+
+	return response.status == SCP_OK ? 0 : -1;
+}
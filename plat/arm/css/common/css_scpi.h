@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -33,6 +33,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/types.h>
 
 /*
  * An SCPI command consists of a header and a payload.
@@ -81,7 +82,10 @@ typedef uint32_t scpi_status_t;
 typedef enum {
 	SCPI_CMD_SCP_READY = 0x01,
 	SCPI_CMD_SET_CSS_POWER_STATE = 0x03,
-	SCPI_CMD_SYS_POWER_STATE = 0x05
+	SCPI_CMD_SYS_POWER_STATE = 0x05,
+	SCPI_CMD_GET_DVFS_INFO = 0x09,
+	SCPI_CMD_SET_DVFS = 0x0a,
+	SCPI_CMD_GET_DVFS = 0x0b
 } scpi_command_t;
 
 typedef enum {
@@ -96,12 +100,41 @@ typedef enum {
 	scpi_system_reset = 2
 } scpi_system_state_t;
 
+/* Maximum number of operating points of a DVFS domain read from SCP */
+#define SCPI_DVFS_MAX_OPPS	16
+
+/* Operating point of a DVFS domain */
+typedef struct {
+	uint32_t freq;		/* Frequency in Hz */
+	uint32_t voltage;	/* Voltage in mV */
+} scpi_opp_t;
+
+/* Operating points of a DVFS domain, as returned by SCP */
+typedef struct {
+	unsigned int num_opps;
+	unsigned int latency;	/* Transition latency in us */
+	scpi_opp_t opps[SCPI_DVFS_MAX_OPPS];
+} scpi_dvfs_info_t;
+
 extern int scpi_wait_ready(void);
 extern void scpi_set_css_power_state(unsigned mpidr,
 					scpi_power_state_t cpu_state,
 					scpi_power_state_t cluster_state,
 					scpi_power_state_t css_state);
+extern void scpi_set_css_power_states(const u_register_t *mpidr_list,
+					unsigned int num_cpus,
+					scpi_power_state_t cpu_state,
+					scpi_power_state_t cluster_state,
+					scpi_power_state_t css_state);
 uint32_t scpi_sys_power_state(scpi_system_state_t system_state);
+extern void scpi_record_css_power_state(unsigned mpidr,
+					scpi_power_state_t cpu_state,
+					scpi_power_state_t cluster_state,
+					scpi_power_state_t css_state);
+extern void scpi_clear_css_power_state(unsigned mpidr);
+extern int scpi_get_dvfs_info(unsigned int domain, scpi_dvfs_info_t *info);
+extern int scpi_get_dvfs(unsigned int domain);
+extern int scpi_set_dvfs(unsigned int domain, unsigned int opp);
 
 
 #endif	/* __CSS_SCPI_H__ */
@@ -40,6 +40,7 @@
 #pragma weak bl31_plat_enable_mmu
 #pragma weak bl32_plat_enable_mmu
 #pragma weak bl31_plat_runtime_setup
+#pragma weak bl31_plat_init_mem_reclaimed
 
 void bl31_plat_enable_mmu(uint32_t flags)
 {
@@ -60,6 +61,13 @@ void bl31_plat_runtime_setup(void)
 	console_uninit();
 }
 
+/*
+ * The memory of the BL31 init code and data is left unused by default.
+ */
+void bl31_plat_init_mem_reclaimed(uintptr_t base, size_t size)
+{
+}
+
 #if !ENABLE_PLAT_COMPAT
 /*
  * Helper function for platform_get_pos() when platform compatibility is
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -61,3 +61,69 @@ plat_local_state_t plat_get_target_pwr_state(unsigned int lvl,
 
 	return target;
 }
+
+#if PSCI_STATE_LATENCY
+#pragma weak plat_get_state_latency
+
+/*
+ * The PSCI generic code uses this API to get the latencies of the local power
+ * 'state' of the power domains at level 'lvl', or NULL if the platform does not
+ * support this state at this level. This default implementation declares
+ * none.
+ */
+const plat_state_latency_t *plat_get_state_latency(unsigned int lvl,
+						   plat_local_state_t state)
+{
+	return NULL;
+}
+#endif
+
+#if PSCI_RESIDENCY_PREDICTOR
+#pragma weak plat_get_predicted_pwr_state
+
+/*
+ * The PSCI generic code uses this API to let the platform reconsider the
+ * coordinated 'target_state' of a power domain at level 'lvl' entered through
+ * CPU_SUSPEND, given that the domain is predicted to be woken up by a timer
+ * event of one of its cpus after 'residency_us' microseconds. This default
+ * implementation demotes a power down state to the deepest retention state if
+ * the predicted residency is lower than PLAT_MIN_OFF_RESIDENCY_US, the time below
+ * which powering the domain down and up again costs more than it saves.
+ *
+ * With PSCI_STATE_LATENCY, if the platform declares the latencies of
+ * 'target_state', it returns instead the deepest state not deeper than
+ * 'target_state' whose minimum residency is covered by 'residency_us', or the
+ * shallowest declared state if none is.
+ */
+plat_local_state_t plat_get_predicted_pwr_state(unsigned int lvl,
+						plat_local_state_t target_state,
+						uint64_t residency_us)
+{
+#if PSCI_STATE_LATENCY
+	const plat_state_latency_t *lat;
+	plat_local_state_t state, shallowest = target_state;
+
+	if (plat_get_state_latency(lvl, target_state)) {
+		for (state = target_state; state > PSCI_LOCAL_STATE_RUN;
+		     state--) {
+			lat = plat_get_state_latency(lvl, state);
+			if (lat == NULL)
+				continue;
+
+			if (residency_us >= lat->min_residency_us)
+				return state;
+
+			shallowest = state;
+		}
+
+		return shallowest;
+	}
+#endif
+
+	if (is_local_state_off(target_state) &&
+	    residency_us < PLAT_MIN_OFF_RESIDENCY_US)
+		return PLAT_MAX_RET_STATE;
+
+	return target_state;
+}
+#endif
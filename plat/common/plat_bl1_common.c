@@ -34,6 +34,7 @@
 #include <debug.h>
 #include <errno.h>
 #include <platform_def.h>
+#include <string.h>
 
 /*
  * The following platform functions are weakly defined. They
@@ -45,6 +46,7 @@
 #pragma weak bl1_plat_set_ep_info
 #pragma weak bl1_plat_get_image_desc
 #pragma weak bl1_plat_fwu_done
+#pragma weak bl1_plat_fwu_copy
 
 
 unsigned int bl1_plat_get_next_image_id(void)
@@ -75,6 +77,16 @@ __dead2 void bl1_plat_fwu_done(void *client_cookie, void *reserved)
 		wfi();
 }
 
+/*
+ * Default FWU copy of a normal world block into secure memory, by the CPU.
+ */
+int bl1_plat_fwu_copy(uintptr_t dst, uintptr_t src, size_t size)
+{
+	memcpy((void *)dst, (const void *)src, size);
+	flush_dcache_range(dst, size);
+	return 0;
+}
+
 /*
  * The Platforms must override with real definition.
  */
@@ -43,6 +43,7 @@
 #pragma weak plat_ic_get_interrupt_type
 #pragma weak plat_ic_end_of_interrupt
 #pragma weak plat_interrupt_type_to_line
+#pragma weak plat_ic_set_priority_mask
 
 /*
  * This function returns the highest priority pending interrupt at
@@ -146,3 +147,12 @@ uint32_t plat_interrupt_type_to_line(uint32_t type,
 	return ((gicv2_is_fiq_enabled()) ? __builtin_ctz(SCR_FIQ_BIT) :
 						__builtin_ctz(SCR_IRQ_BIT));
 }
+
+/*
+ * This function sets the priority mask of the interrupt controller for the
+ * calling CPU to `mask` and returns the previous mask
+ */
+uint32_t plat_ic_set_priority_mask(uint32_t mask)
+{
+	return gicv2_set_pmr(mask);
+}
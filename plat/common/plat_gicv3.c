@@ -49,6 +49,7 @@
 #pragma weak plat_ic_get_interrupt_type
 #pragma weak plat_ic_end_of_interrupt
 #pragma weak plat_interrupt_type_to_line
+#pragma weak plat_ic_set_priority_mask
 
 CASSERT((INTR_TYPE_S_EL1 == INTR_GROUP1S) &&
 	(INTR_TYPE_NS == INTR_GROUP1NS) &&
@@ -179,6 +180,16 @@ uint32_t plat_interrupt_type_to_line(uint32_t type,
 		return __builtin_ctz(SCR_FIQ_BIT);
 	}
 }
+
+/*
+ * This function sets the priority mask of the interrupt controller for the
+ * calling CPU to `mask` and returns the previous mask
+ */
+uint32_t plat_ic_set_priority_mask(uint32_t mask)
+{
+	assert(IS_IN_EL3());
+	return gicv3_set_pmr(mask);
+}
 #endif
 #if IMAGE_BL32
 
@@ -38,6 +38,15 @@
 static unsigned char power_domain_tree_desc
 				[PLATFORM_NUM_AFFS - PLATFORM_CORE_COUNT + 1];
 
+/*
+ * The MPIDR of each present CPU, indexed by its linear core position. This is
+ * populated while the power domain tree descriptor is constructed so that
+ * plat_core_pos_by_mpidr() does not have to query the affinity count and
+ * state of every affinity level on each call.
+ */
+static unsigned long cpu_idx_to_mpidr[PLATFORM_CORE_COUNT];
+static int cpu_map_valid;
+
 /*******************************************************************************
  * Simple routine to set the id of an affinity instance at a given level
  * in the mpidr. The assumption is that the affinity level and the power
@@ -87,6 +96,28 @@ void sort_mpidr_by_cpu_idx(unsigned int aff_count, unsigned long mpidr_list[])
 	}
 }
 
+/*******************************************************************************
+ * Record the MPIDRs of the 'aff_count' CPUs below the affinity level 1
+ * instance identified by 'mpidr' against their linear core positions. CPUs
+ * that the platform reports as absent are left out of the map.
+ ******************************************************************************/
+static void record_cpu_mpidrs(unsigned long mpidr, unsigned int aff_count)
+{
+	unsigned int ctr, idx;
+	unsigned long cpu_mpidr;
+
+	for (ctr = 0; ctr < aff_count; ctr++) {
+		cpu_mpidr = mpidr_set_aff_inst(mpidr, ctr, MPIDR_AFFLVL0);
+		if (plat_get_aff_state(MPIDR_AFFLVL0, cpu_mpidr) ==
+							PSCI_AFF_ABSENT)
+			continue;
+
+		idx = platform_get_core_pos(cpu_mpidr);
+		assert(idx < PLATFORM_CORE_COUNT);
+		cpu_idx_to_mpidr[idx] = cpu_mpidr;
+	}
+}
+
 /*******************************************************************************
  * The compatibility routine to construct the power domain tree description.
  * The assumption made is that the power domains correspond to affinity
@@ -149,6 +180,10 @@ static unsigned int init_pwr_domain_tree_desc(unsigned long mpidr,
 		}
 	} else {
 		power_domain_tree_desc[affmap_idx++] = aff_count;
+
+		/* Record the present CPUs while describing the leaf level */
+		if (tgt_afflvl == MPIDR_AFFLVL0)
+			record_cpu_mpidrs(mpidr, aff_count);
 	}
 	return affmap_idx;
 }
@@ -161,7 +196,14 @@ static unsigned int init_pwr_domain_tree_desc(unsigned long mpidr,
  ******************************************************************************/
 const unsigned char *plat_get_power_domain_tree_desc(void)
 {
-	int afflvl, affmap_idx;
+	int afflvl, affmap_idx, i;
+
+	/*
+	 * Mark every core position as unused. An affinity value with bits
+	 * outside MPIDR_AFFINITY_MASK can never match a masked MPIDR.
+	 */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		cpu_idx_to_mpidr[i] = ~0UL;
 
 	/*
 	 * We assume that the platform allocates affinity instance ids from
@@ -177,6 +219,8 @@ const unsigned char *plat_get_power_domain_tree_desc(void)
 
 	assert(affmap_idx == (PLATFORM_NUM_AFFS - PLATFORM_CORE_COUNT + 1));
 
+	cpu_map_valid = 1;
+
 	return power_domain_tree_desc;
 }
 
@@ -186,15 +230,28 @@ const unsigned char *plat_get_power_domain_tree_desc(void)
  * for the platform and queries the platform layer whether the CPU specified
  * by the mpidr is present or not. If present, it returns the index of the
  * core corresponding to the 'mpidr'. Else it returns -1.
+ *
+ * Once the power domain tree descriptor has been constructed, the lookup is
+ * done against the CPU map recorded at that time instead.
  *****************************************************************************/
 int plat_core_pos_by_mpidr(u_register_t mpidr)
 {
 	unsigned long shift, aff_inst;
+	unsigned int idx;
 	int i;
 
 	/* Ignore the Reserved bits and U bit in MPIDR */
 	mpidr &= MPIDR_AFFINITY_MASK;
 
+	if (cpu_map_valid) {
+		idx = platform_get_core_pos(mpidr);
+		if (idx >= PLATFORM_CORE_COUNT ||
+				cpu_idx_to_mpidr[idx] != mpidr)
+			return -1;
+
+		return idx;
+	}
+
 	/*
 	 * Check if any affinity field higher than
 	 * the PLATFORM_MAX_AFFLVL is set.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -31,6 +31,7 @@
 #include <debug.h>
 #include <mtk_sip_svc.h>
 #include <runtime_svc.h>
+#include <sip_svc.h>
 #include <uuid.h>
 
 /* Mediatek SiP Service UUID */
@@ -39,87 +40,97 @@ DEFINE_SVC_UUID(mtk_sip_svc_uid,
 		0x8f, 0x95, 0x05, 0x00, 0x0f, 0x3d);
 
 /*
- * This function handles Mediatek defined SiP Calls */
-static uint64_t mediatek_sip_handler(uint32_t smc_fid,
-				     uint64_t x1,
-				     uint64_t x2,
-				     uint64_t x3,
-				     uint64_t x4,
-				     void *cookie,
-				     void *handle)
+ * Handlers of the Mediatek defined SiP Calls, all of which are only available
+ * to the NS world.
+ */
+static uint64_t mtk_sip_set_authorized_sreg(uint32_t smc_fid,
+					    uint64_t x1,
+					    uint64_t x2,
+					    uint64_t x3,
+					    uint64_t x4,
+					    void *cookie,
+					    void *handle,
+					    uint64_t flags)
 {
-	uint64_t ret;
-
-	switch (smc_fid) {
-	case MTK_SIP_SET_AUTHORIZED_SECURE_REG:
-		ret = mt_sip_set_authorized_sreg((uint32_t)x1, (uint32_t)x2);
-		SMC_RET1(handle, ret);
-
-	case MTK_SIP_PWR_ON_MTCMOS:
-		ret = mt_sip_pwr_on_mtcmos((uint32_t)x1);
-		SMC_RET1(handle, ret);
-
-	case MTK_SIP_PWR_OFF_MTCMOS:
-		ret = mt_sip_pwr_off_mtcmos((uint32_t)x1);
-		SMC_RET1(handle, ret);
-
-	case MTK_SIP_PWR_MTCMOS_SUPPORT:
-		ret = mt_sip_pwr_mtcmos_support();
-		SMC_RET1(handle, ret);
-
-	default:
-		ERROR("%s: unhandled SMC (0x%x)\n", __func__, smc_fid);
-		break;
-	}
-
-	SMC_RET1(handle, SMC_UNK);
+	SMC_RET1(handle, mt_sip_set_authorized_sreg((uint32_t)x1,
+						    (uint32_t)x2));
 }
 
-/*
- * This function is responsible for handling all SiP calls from the NS world
- */
-uint64_t sip_smc_handler(uint32_t smc_fid,
-			 uint64_t x1,
-			 uint64_t x2,
-			 uint64_t x3,
-			 uint64_t x4,
-			 void *cookie,
-			 void *handle,
-			 uint64_t flags)
+static uint64_t mtk_sip_pwr_on_mtcmos(uint32_t smc_fid,
+				      uint64_t x1,
+				      uint64_t x2,
+				      uint64_t x3,
+				      uint64_t x4,
+				      void *cookie,
+				      void *handle,
+				      uint64_t flags)
 {
-	uint32_t ns;
-
-	/* Determine which security state this SMC originated from */
-	ns = is_caller_non_secure(flags);
-	if (!ns)
-		SMC_RET1(handle, SMC_UNK);
+	SMC_RET1(handle, mt_sip_pwr_on_mtcmos((uint32_t)x1));
+}
 
-	switch (smc_fid) {
-	case SIP_SVC_CALL_COUNT:
-		/* Return the number of Mediatek SiP Service Calls. */
-		SMC_RET1(handle, MTK_SIP_NUM_CALLS);
+static uint64_t mtk_sip_pwr_off_mtcmos(uint32_t smc_fid,
+				       uint64_t x1,
+				       uint64_t x2,
+				       uint64_t x3,
+				       uint64_t x4,
+				       void *cookie,
+				       void *handle,
+				       uint64_t flags)
+{
+	SMC_RET1(handle, mt_sip_pwr_off_mtcmos((uint32_t)x1));
+}
 
-	case SIP_SVC_UID:
-		/* Return UID to the caller */
-		SMC_UUID_RET(handle, mtk_sip_svc_uid);
+static uint64_t mtk_sip_pwr_mtcmos_support(uint32_t smc_fid,
+					   uint64_t x1,
+					   uint64_t x2,
+					   uint64_t x3,
+					   uint64_t x4,
+					   void *cookie,
+					   void *handle,
+					   uint64_t flags)
+{
+	SMC_RET1(handle, mt_sip_pwr_mtcmos_support());
+}
 
-	case SIP_SVC_VERSION:
-		/* Return the version of current implementation */
-		SMC_RET2(handle, MTK_SIP_SVC_VERSION_MAJOR,
-			MTK_SIP_SVC_VERSION_MINOR);
+#if MTK_POWER_TRACE_BUFFER
+static uint64_t mtk_sip_power_trace_read(uint32_t smc_fid,
+					 uint64_t x1,
+					 uint64_t x2,
+					 uint64_t x3,
+					 uint64_t x4,
+					 void *cookie,
+					 void *handle,
+					 uint64_t flags)
+{
+	uint64_t ret, count = 0, data = 0, timestamp = 0;
 
-	default:
-		return mediatek_sip_handler(smc_fid, x1, x2, x3, x4,
-			cookie, handle);
-	}
+	ret = mt_sip_power_trace_read((uint32_t)x1, (uint32_t)x2,
+				      &count, &data, &timestamp);
+	SMC_RET4(handle, ret, count, data, timestamp);
 }
+#endif
+
+/* Mediatek SiP Calls, sorted by function ID */
+static const sip_call_t mtk_sip_calls[] = {
+	{ MTK_SIP_SET_AUTHORIZED_SECURE_REG, SIP_CALL_NS_ONLY, NULL,
+	  mtk_sip_set_authorized_sreg },
+	{ MTK_SIP_PWR_ON_MTCMOS, SIP_CALL_NS_ONLY, NULL,
+	  mtk_sip_pwr_on_mtcmos },
+	{ MTK_SIP_PWR_OFF_MTCMOS, SIP_CALL_NS_ONLY, NULL,
+	  mtk_sip_pwr_off_mtcmos },
+	{ MTK_SIP_PWR_MTCMOS_SUPPORT, SIP_CALL_NS_ONLY, NULL,
+	  mtk_sip_pwr_mtcmos_support },
+#if MTK_POWER_TRACE_BUFFER
+	{ MTK_SIP_POWER_TRACE_READ, SIP_CALL_NS_ONLY, NULL,
+	  mtk_sip_power_trace_read },
+#endif
+};
 
-/* Define a runtime service descriptor for fast SMC calls */
-DECLARE_RT_SVC(
+/* Register the Mediatek SiP Calls as runtime service for fast SMC calls */
+DECLARE_SIP_SVC(
 	mediatek_sip_svc,
-	OEN_SIP_START,
-	OEN_SIP_END,
-	SMC_TYPE_FAST,
-	NULL,
-	sip_smc_handler
+	mtk_sip_calls,
+	&mtk_sip_svc_uid,
+	MTK_SIP_SVC_VERSION_MAJOR,
+	MTK_SIP_SVC_VERSION_MINOR
 );
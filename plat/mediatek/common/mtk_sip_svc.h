@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -32,24 +32,16 @@
 
 #include <stdint.h>
 
-/* SMC function IDs for SiP Service queries */
-#define SIP_SVC_CALL_COUNT		0x8200ff00
-#define SIP_SVC_UID			0x8200ff01
-/*					0x8200ff02 is reserved */
-#define SIP_SVC_VERSION			0x8200ff03
-
 /* Mediatek SiP Service Calls version numbers */
 #define MTK_SIP_SVC_VERSION_MAJOR	0x0
 #define MTK_SIP_SVC_VERSION_MINOR	0x1
 
-/* Number of Mediatek SiP Calls implemented */
-#define MTK_SIP_NUM_CALLS		4
-
 /* Mediatek SiP Service Calls function IDs */
 #define MTK_SIP_SET_AUTHORIZED_SECURE_REG	0x82000001
 #define MTK_SIP_PWR_ON_MTCMOS			0x82000402
 #define MTK_SIP_PWR_OFF_MTCMOS			0x82000403
 #define MTK_SIP_PWR_MTCMOS_SUPPORT		0x82000404
+#define MTK_SIP_POWER_TRACE_READ		0x82000405
 
 /* Mediatek SiP Calls error code */
 enum {
@@ -68,4 +60,14 @@ uint64_t mt_sip_set_authorized_sreg(uint32_t sreg, uint32_t val);
 uint64_t mt_sip_pwr_on_mtcmos(uint32_t val);
 uint64_t mt_sip_pwr_off_mtcmos(uint32_t val);
 uint64_t mt_sip_pwr_mtcmos_support(void);
+
+/*
+ * MTK_SIP_POWER_TRACE_READ: return the power event with sequence number idx
+ * recorded by CPU cpu (linear index). On success, count holds the number of
+ * events recorded by that CPU, data holds (mode << 32 | mpidr) and timestamp
+ * holds the physical counter value of the event.
+ */
+uint64_t mt_sip_power_trace_read(uint32_t cpu, uint32_t idx,
+				 uint64_t *count, uint64_t *data,
+				 uint64_t *timestamp);
 #endif /* __PLAT_SIP_SVC_H__ */
@@ -121,8 +121,7 @@ enum {
  * According to designer, one mtcmos operation should be done
  * around 10us.
  */
-#define MTCMOS_ACK_POLLING_MAX_COUNT			10000
-#define MTCMOS_ACK_POLLING_INTERVAL			10
+#define MTCMOS_ACK_TIMEOUT_US				100000
 
 static void mtcmos_ctrl_little_off(unsigned int linear_id)
 {
@@ -183,34 +182,28 @@ void mtcmos_little_cpu_off(void)
 
 uint32_t wait_mtcmos_ack(uint32_t on, uint32_t mtcmos_sta, uint32_t spm_pwr_sta)
 {
-	int i = 0;
-	uint32_t cmp, pwr_sta, pwr_sta_2nd;
-
-	while (1) {
-		cmp = (mmio_read_32(SPM_PCM_PASR_DPD_3) >> mtcmos_sta) & 1;
-		pwr_sta = (mmio_read_32(SPM_PWR_STATUS) >> spm_pwr_sta) & 1;
-		pwr_sta_2nd =
-			(mmio_read_32(SPM_PWR_STATUS_2ND) >> spm_pwr_sta) & 1;
-		if ((cmp == on) && (pwr_sta == on) && (pwr_sta_2nd == on)) {
-			mmio_write_32(SPM_PCM_RESERVE2, 0);
-			return MTCMOS_CTRL_SUCCESS;
-		}
-		udelay(MTCMOS_ACK_POLLING_INTERVAL);
-		i++;
-		if (i > MTCMOS_ACK_POLLING_MAX_COUNT) {
-			INFO("MTCMOS control failed(%d), SPM_PWR_STA(%d),\n"
-				"SPM_PCM_RESERVE=0x%x,SPM_PCM_RESERVE2=0x%x,\n"
-				"SPM_PWR_STATUS=0x%x,SPM_PWR_STATUS_2ND=0x%x\n"
-				"SPM_PCM_PASR_DPD_3 = 0x%x\n",
-				on, spm_pwr_sta, mmio_read_32(SPM_PCM_RESERVE),
-				mmio_read_32(SPM_PCM_RESERVE2),
-				mmio_read_32(SPM_PWR_STATUS),
-				mmio_read_32(SPM_PWR_STATUS_2ND),
-				mmio_read_32(SPM_PCM_PASR_DPD_3));
-			mmio_write_32(SPM_PCM_RESERVE2, 0);
-			return MTCMOS_CTRL_ERROR;
-		}
+	/* Wait for each of the three acknowledgements in turn */
+	if (wait_for_condition(SPM_PCM_PASR_DPD_3, 1 << mtcmos_sta,
+			       on << mtcmos_sta, MTCMOS_ACK_TIMEOUT_US) ||
+	    wait_for_condition(SPM_PWR_STATUS, 1 << spm_pwr_sta,
+			       on << spm_pwr_sta, MTCMOS_ACK_TIMEOUT_US) ||
+	    wait_for_condition(SPM_PWR_STATUS_2ND, 1 << spm_pwr_sta,
+			       on << spm_pwr_sta, MTCMOS_ACK_TIMEOUT_US)) {
+		INFO("MTCMOS control failed(%d), SPM_PWR_STA(%d),\n"
+			"SPM_PCM_RESERVE=0x%x,SPM_PCM_RESERVE2=0x%x,\n"
+			"SPM_PWR_STATUS=0x%x,SPM_PWR_STATUS_2ND=0x%x\n"
+			"SPM_PCM_PASR_DPD_3 = 0x%x\n",
+			on, spm_pwr_sta, mmio_read_32(SPM_PCM_RESERVE),
+			mmio_read_32(SPM_PCM_RESERVE2),
+			mmio_read_32(SPM_PWR_STATUS),
+			mmio_read_32(SPM_PWR_STATUS_2ND),
+			mmio_read_32(SPM_PCM_PASR_DPD_3));
+		mmio_write_32(SPM_PCM_RESERVE2, 0);
+		return MTCMOS_CTRL_ERROR;
 	}
+
+	mmio_write_32(SPM_PCM_RESERVE2, 0);
+	return MTCMOS_CTRL_SUCCESS;
 }
 
 uint32_t mtcmos_non_cpu_ctrl(uint32_t on, uint32_t mtcmos_num)
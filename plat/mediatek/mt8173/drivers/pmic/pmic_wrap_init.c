@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -33,10 +33,9 @@
 #include <mt8173_def.h>
 #include <pmic_wrap_init.h>
 
-/* pmic wrap module wait_idle and read polling interval (in microseconds) */
+/* pmic wrap module wait_idle polling interval (in microseconds) */
 enum {
-	WAIT_IDLE_POLLING_DELAY_US	= 1,
-	READ_POLLING_DELAY_US		= 2
+	WAIT_IDLE_POLLING_DELAY_US	= 1
 };
 
 static inline uint32_t wait_for_state_idle(uint32_t timeout_us,
@@ -51,7 +50,6 @@ static inline uint32_t wait_for_state_idle(uint32_t timeout_us,
 		WAIT_IDLE_POLLING_DELAY_US;
 
 	do {
-		udelay(WAIT_IDLE_POLLING_DELAY_US);
 		reg_rdata = mmio_read_32((uintptr_t)wacs_register);
 		/* if last read command timeout,clear vldclr bit
 		   read command state machine:FSM_REQ-->wfdle-->WFVLDCLR;
@@ -74,6 +72,8 @@ static inline uint32_t wait_for_state_idle(uint32_t timeout_us,
 			break;
 		}
 
+		/* only delay if the wrapper is still busy */
+		udelay(WAIT_IDLE_POLLING_DELAY_US);
 		retry--;
 	} while (retry);
 
@@ -90,29 +90,31 @@ static inline uint32_t wait_for_state_ready(uint32_t timeout_us,
 					    void *wacs_register,
 					    uint32_t *read_reg)
 {
-	uint32_t reg_rdata;
-	uint32_t retry;
-
-	retry = (timeout_us + READ_POLLING_DELAY_US) / READ_POLLING_DELAY_US;
-
-	do {
-		udelay(READ_POLLING_DELAY_US);
-		reg_rdata = mmio_read_32((uintptr_t)wacs_register);
-
-		if (((reg_rdata >> RDATA_WACS_FSM_SHIFT) & RDATA_WACS_FSM_MASK)
-		    == WACS_FSM_WFVLDCLR)
-			break;
-
-		retry--;
-	} while (retry);
-
-	if (!retry) {	/* timeout */
+	if (wait_for_condition((uintptr_t)wacs_register,
+			       RDATA_WACS_FSM_MASK << RDATA_WACS_FSM_SHIFT,
+			       WACS_FSM_WFVLDCLR << RDATA_WACS_FSM_SHIFT,
+			       timeout_us)) {
 		ERROR("timeout when waiting for idle\n");
 		return E_PWR_WAIT_IDLE_TIMEOUT_READ;
 	}
 
 	if (read_reg)
-		*read_reg = reg_rdata;
+		*read_reg = mmio_read_32((uintptr_t)wacs_register);
+	return 0;
+}
+
+static int32_t pwrap_check_init_done(void)
+{
+	uint32_t reg_rdata;
+
+	reg_rdata = mmio_read_32((uintptr_t)&mt8173_pwrap->wacs2_rdata);
+	/* Prevent someone to used pwrap before pwrap init */
+	if (((reg_rdata >> RDATA_INIT_DONE_SHIFT) &
+	    RDATA_INIT_DONE_MASK) != WACS_INIT_DONE) {
+		ERROR("initialization isn't finished\n");
+		return E_PWR_NOT_INIT_DONE;
+	}
+
 	return 0;
 }
 
@@ -129,15 +131,10 @@ static int32_t pwrap_wacs2(uint32_t write,
 	uint32_t return_value = 0;
 
 	if (init_check) {
-		reg_rdata = mmio_read_32((uintptr_t)&mt8173_pwrap->wacs2_rdata);
-		/* Prevent someone to used pwrap before pwrap init */
-		if (((reg_rdata >> RDATA_INIT_DONE_SHIFT) &
-		    RDATA_INIT_DONE_MASK) != WACS_INIT_DONE) {
-			ERROR("initialization isn't finished\n");
-			return E_PWR_NOT_INIT_DONE;
-		}
+		return_value = pwrap_check_init_done();
+		if (return_value != 0)
+			return return_value;
 	}
-	reg_rdata = 0;
 	/* Check IDLE in advance */
 	return_value = wait_for_state_idle(TIMEOUT_WAIT_IDLE,
 				&mt8173_pwrap->wacs2_rdata,
@@ -185,3 +182,36 @@ int32_t pwrap_write(uint32_t adr, uint32_t wdata)
 {
 	return pwrap_wacs2(1, adr, wdata, 0, 1);
 }
+
+/*
+ * Issue a sequence of writes to the PMIC. The WACS2 channel only holds one
+ * command, so each write still waits for the previous one to be accepted,
+ * but the initialisation check is done once for the whole batch and the
+ * caller only pays for the final wait for completion.
+ */
+int32_t pwrap_write_batch(const struct pwrap_write_cmd *cmds,
+			  unsigned int num_cmds)
+{
+	uint32_t return_value;
+	unsigned int i;
+
+	return_value = pwrap_check_init_done();
+	if (return_value != 0)
+		return return_value;
+
+	for (i = 0; i < num_cmds; i++) {
+		return_value = pwrap_wacs2(1, cmds[i].adr, cmds[i].wdata, 0, 0);
+		if (return_value != 0)
+			return return_value;
+	}
+
+	/* Wait for the last write to leave the wrapper */
+	return_value = wait_for_state_idle(TIMEOUT_WAIT_IDLE,
+				&mt8173_pwrap->wacs2_rdata,
+				&mt8173_pwrap->wacs2_vldclr,
+				0);
+	if (return_value != 0)
+		ERROR("wait_for_fsm_idle fail,return_value=%d\n", return_value);
+
+	return return_value;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -31,9 +31,17 @@
 #ifndef __PMIC_WRAP_INIT_H__
 #define __PMIC_WRAP_INIT_H__
 
+/* a single PMIC register write, to be issued by pwrap_write_batch() */
+struct pwrap_write_cmd {
+	uint32_t adr;
+	uint32_t wdata;
+};
+
 /* external API */
 int32_t pwrap_read(uint32_t adr, uint32_t *rdata);
 int32_t pwrap_write(uint32_t adr, uint32_t wdata);
+int32_t pwrap_write_batch(const struct pwrap_write_cmd *cmds,
+			  unsigned int num_cmds);
 
 static struct mt8173_pmic_wrap_regs *const mt8173_pwrap =
 	(void *)PMIC_WRAP_BASE;
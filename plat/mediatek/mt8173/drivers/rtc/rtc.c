@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -28,18 +28,22 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 #include <assert.h>
+#include <bl_common.h>
 #include <debug.h>
 #include <delay_timer.h>
 #include <mt8173_def.h>
 #include <pmic_wrap_init.h>
 #include <rtc.h>
 
-/* RTC busy status polling interval and retry count */
+/* RTC busy status polling interval and retry count, 1s in total */
 enum {
-	RTC_WRTGR_POLLING_DELAY_MS	= 10,
-	RTC_WRTGR_POLLING_CNT		= 100
+	RTC_WRTGR_POLLING_DELAY_US	= 100,
+	RTC_WRTGR_POLLING_CNT		= 10000
 };
 
+/* Largest number of updates applied by rtc_write_batch() */
+#define RTC_BATCH_MAX_UPDATES		8
+
 static uint16_t RTC_Read(uint32_t addr)
 {
 	uint32_t rdata = 0;
@@ -53,14 +57,18 @@ static void RTC_Write(uint32_t addr, uint16_t data)
 	pwrap_write((uint32_t)addr, (uint32_t)data);
 }
 
+/*
+ * The write-through usually completes within a few 32kHz RTC clock cycles, so
+ * check the busy flag first and then poll at a short interval.
+ */
 static inline int32_t rtc_busy_wait(void)
 {
 	uint64_t retry = RTC_WRTGR_POLLING_CNT;
 
 	do {
-		mdelay(RTC_WRTGR_POLLING_DELAY_MS);
 		if (!(RTC_Read(RTC_BBPU) & RTC_BBPU_CBUSY))
 			return 1;
+		udelay(RTC_WRTGR_POLLING_DELAY_US);
 		retry--;
 	} while (retry);
 
@@ -86,17 +94,43 @@ static int32_t Writeif_unlock(void)
 	return 1;
 }
 
+/*
+ * Apply several register updates with a single write trigger. The protection
+ * of the RTC is unlocked first, then the updates and the trigger are issued
+ * as one PMIC wrapper batch and the write-through is waited for once.
+ * Returns 1 on success, 0 on failure.
+ */
+int32_t rtc_write_batch(const struct rtc_reg_update *updates,
+			unsigned int num_updates)
+{
+	struct pwrap_write_cmd cmds[RTC_BATCH_MAX_UPDATES + 1];
+	unsigned int i;
+
+	assert(num_updates <= RTC_BATCH_MAX_UPDATES);
+
+	if (!Writeif_unlock())
+		return 0;
+
+	for (i = 0; i < num_updates; i++) {
+		cmds[i].adr = updates[i].addr;
+		cmds[i].wdata = updates[i].data;
+	}
+	cmds[i].adr = RTC_WRTGR;
+	cmds[i].wdata = 1;
+
+	if (pwrap_write_batch(cmds, num_updates + 1) != 0)
+		return 0;
+
+	return rtc_busy_wait();
+}
+
 void rtc_bbpu_power_down(void)
 {
-	uint16_t bbpu;
-
-	/* pull PWRBB low */
-	bbpu = RTC_BBPU_KEY | RTC_BBPU_AUTO | RTC_BBPU_PWREN;
-	if (Writeif_unlock()) {
-		RTC_Write(RTC_BBPU, bbpu);
-		if (!Write_trigger())
-			assert(0);
-	} else {
+	const struct rtc_reg_update updates[] = {
+		/* pull PWRBB low */
+		{ RTC_BBPU, RTC_BBPU_KEY | RTC_BBPU_AUTO | RTC_BBPU_PWREN },
+	};
+
+	if (!rtc_write_batch(updates, ARRAY_SIZE(updates)))
 		assert(0);
-	}
 }
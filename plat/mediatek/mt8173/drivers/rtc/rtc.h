@@ -31,6 +31,8 @@
 #ifndef __PLAT_DRIVER_RTC_H__
 #define __PLAT_DRIVER_RTC_H__
 
+#include <stdint.h>
+
 /* RTC registers */
 enum {
 	RTC_BBPU = 0xE000,
@@ -73,6 +75,14 @@ enum {
 	RTC_BBPU_KEY	= 0x43 << 8
 };
 
+/* A single RTC register update, to be applied by rtc_write_batch() */
+struct rtc_reg_update {
+	uint16_t addr;
+	uint16_t data;
+};
+
+int32_t rtc_write_batch(const struct rtc_reg_update *updates,
+			unsigned int num_updates);
 void rtc_bbpu_power_down(void);
 
 #endif /* __PLAT_DRIVER_RTC_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -59,6 +59,9 @@ static int spm_hotplug_ready __section("tzfw_coherent_mem");
 static int spm_mcdi_ready __section("tzfw_coherent_mem");
 static int spm_suspend_ready __section("tzfw_coherent_mem");
 
+/* PCM firmware image currently held in the SPM instruction memory */
+static const struct pcm_desc *spm_im_pcmdesc __section("tzfw_coherent_mem");
+
 void spm_lock_init(void)
 {
 	bakery_lock_init(&spm_lock);
@@ -135,6 +138,7 @@ void spm_register_init(void)
 		CON1_SPM_SRAM_ISO_B | CON1_SPM_SRAM_SLP_B | CON1_MIF_APBEN);
 	mmio_write_32(SPM_PCM_IM_PTR, 0);
 	mmio_write_32(SPM_PCM_IM_LEN, 0);
+	spm_im_pcmdesc = NULL;
 
 	mmio_write_32(SPM_CLK_CON, CC_SYSCLK0_EN_1 | CC_SYSCLK0_EN_0 |
 		CC_SYSCLK1_EN_0 | CC_SRCLKENA_MASK_0 | CC_CLKSQ1_SEL |
@@ -266,20 +270,28 @@ void spm_kick_im_to_fetch(const struct pcm_desc *pcmdesc)
 
 	ptr = (unsigned int)(unsigned long)(pcmdesc->base);
 	len = pcmdesc->size - 1;
-	if (mmio_read_32(SPM_PCM_IM_PTR) != ptr ||
+	if (spm_im_pcmdesc != pcmdesc ||
+	    mmio_read_32(SPM_PCM_IM_PTR) != ptr ||
 	    mmio_read_32(SPM_PCM_IM_LEN) != len ||
 	    pcmdesc->sess > 2) {
 		mmio_write_32(SPM_PCM_IM_PTR, ptr);
 		mmio_write_32(SPM_PCM_IM_LEN, len);
+
+		/* kick IM to fetch (only toggle IM_KICK) */
+		con0 = mmio_read_32(SPM_PCM_CON0) &
+			~(CON0_IM_KICK | CON0_PCM_KICK);
+		mmio_write_32(SPM_PCM_CON0, con0 | CON0_CFG_KEY | CON0_IM_KICK);
+		mmio_write_32(SPM_PCM_CON0, con0 | CON0_CFG_KEY);
+
+		spm_im_pcmdesc = pcmdesc;
 	} else {
+		/*
+		 * The image is still resident in the instruction memory:
+		 * run it from there instead of fetching it again.
+		 */
 		mmio_setbits_32(SPM_PCM_CON1, CON1_CFG_KEY | CON1_IM_SLAVE);
 	}
 
-	/* kick IM to fetch (only toggle IM_KICK) */
-	con0 = mmio_read_32(SPM_PCM_CON0) & ~(CON0_IM_KICK | CON0_PCM_KICK);
-	mmio_write_32(SPM_PCM_CON0, con0 | CON0_CFG_KEY | CON0_IM_KICK);
-	mmio_write_32(SPM_PCM_CON0, con0 | CON0_CFG_KEY);
-
 	/* kick IM to fetch (only toggle PCM_KICK) */
 	con0 = mmio_read_32(SPM_PCM_CON0) & ~(CON0_IM_KICK | CON0_PCM_KICK);
 	mmio_write_32(SPM_PCM_CON0, con0 | CON0_CFG_KEY | CON0_PCM_KICK);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -494,31 +494,55 @@ void spm_mcdi_prepare_for_off_state(unsigned long mpidr, unsigned int afflvl)
 	const struct pcm_desc *pcmdesc = spm_mcdi.pcmdesc;
 	struct pwr_ctrl *pwrctrl = spm_mcdi.pwrctrl;
 
-	spm_lock_get();
+	/*
+	 * Loading the MCDI firmware is shared with the hotplug and suspend
+	 * paths, so it is done under the SPM lock. Once it is running, the
+	 * check below lets the common idle path skip the lock altogether.
+	 */
 	if (is_mcdi_ready() == 0) {
-		if (is_hotplug_ready() == 1)
-			spm_clear_hotplug();
-		set_pwrctrl_pcm_flags(pwrctrl, 0);
-		spm_reset_and_init_pcm();
-		spm_kick_im_to_fetch(pcmdesc);
-		spm_set_power_control(pwrctrl);
-		spm_set_wakeup_event(pwrctrl);
-		spm_kick_pcm_to_run(pwrctrl);
-		set_mcdi_ready();
+		spm_lock_get();
+		if (is_mcdi_ready() == 0) {
+			if (is_hotplug_ready() == 1)
+				spm_clear_hotplug();
+			set_pwrctrl_pcm_flags(pwrctrl, 0);
+			spm_reset_and_init_pcm();
+			spm_kick_im_to_fetch(pcmdesc);
+			spm_set_power_control(pwrctrl);
+			spm_set_wakeup_event(pwrctrl);
+			spm_kick_pcm_to_run(pwrctrl);
+			set_mcdi_ready();
+		}
+		spm_lock_release();
 	}
+
+	/* The WFI select and IRQ mask registers are private to each CPU */
 	spm_mcdi_wfi_sel_enter(mpidr);
-	if (afflvl == MPIDR_AFFLVL1)
+
+	/* SPM_PCM_RESERVE is shared by all CPUs and the hotplug path */
+	if (afflvl == MPIDR_AFFLVL1) {
+		spm_lock_get();
 		spm_mcdi_set_cputop_pwrctrl_for_cluster_off(mpidr);
-	spm_lock_release();
+		spm_lock_release();
+	}
 }
 
 void spm_mcdi_finish_for_on_state(unsigned long mpidr, unsigned int afflvl)
 {
-	unsigned long linear_id = platform_get_core_pos(mpidr);
+	unsigned long linear_id = plat_core_pos_by_mpidr(mpidr);
+	unsigned int pwrctl = (mpidr & MPIDR_CLUSTER_MASK) ?
+		PCM_MCDI_CA72_CPUTOP_PWRCTL : PCM_MCDI_CA53_CPUTOP_PWRCTL;
+
+	/*
+	 * Only take the lock to clear the cluster power control bit if some
+	 * CPU of this cluster actually requested the cluster to go off.
+	 */
+	if (mmio_read_32(SPM_PCM_RESERVE) & pwrctl) {
+		spm_lock_get();
+		spm_mcdi_clear_cputop_pwrctrl_for_cluster_on(mpidr);
+		spm_lock_release();
+	}
 
-	spm_lock_get();
-	spm_mcdi_clear_cputop_pwrctrl_for_cluster_on(mpidr);
+	/* Per-CPU registers and a write-one-to-clear bit: no lock needed */
 	spm_mcdi_wfi_sel_leave(mpidr);
 	mmio_write_32(SPM_PCM_SW_INT_CLEAR, (0x1 << linear_id));
-	spm_lock_release();
 }
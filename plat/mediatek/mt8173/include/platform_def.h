@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -55,7 +55,6 @@
 
 #define FIRMWARE_WELCOME_STR		"Booting Trusted Firmware\n"
 
-#define PLATFORM_MAX_AFFLVL		MPIDR_AFFLVL2
 #define PLATFORM_SYSTEM_COUNT		1
 #define PLATFORM_CLUSTER_COUNT		2
 #define PLATFORM_CLUSTER0_CORE_COUNT	4
@@ -63,9 +62,18 @@
 #define PLATFORM_CORE_COUNT		(PLATFORM_CLUSTER1_CORE_COUNT +	\
 					 PLATFORM_CLUSTER0_CORE_COUNT)
 #define PLATFORM_MAX_CPUS_PER_CLUSTER	4
-#define PLATFORM_NUM_AFFS		(PLATFORM_SYSTEM_COUNT +	\
+#define PLAT_NUM_PWR_DOMAINS		(PLATFORM_SYSTEM_COUNT +	\
 					 PLATFORM_CLUSTER_COUNT +	\
 					 PLATFORM_CORE_COUNT)
+#define PLAT_MAX_PWR_LVL		2
+
+/* Local power state of the power domains */
+#define MTK_LOCAL_STATE_RUN		0
+#define MTK_LOCAL_STATE_RET		1
+#define MTK_LOCAL_STATE_OFF		2
+
+#define PLAT_MAX_RET_STATE		MTK_LOCAL_STATE_RET
+#define PLAT_MAX_OFF_STATE		MTK_LOCAL_STATE_OFF
 
 /*******************************************************************************
  * Platform memory map related constants
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -31,6 +31,8 @@
 #ifndef __POWER_TRACER_H__
 #define __POWER_TRACER_H__
 
+#include <stdint.h>
+
 #define CPU_UP		0
 #define CPU_DOWN	1
 #define CPU_SUSPEND	2
@@ -38,6 +40,13 @@
 #define CLUSTER_DOWN	4
 #define CLUSTER_SUSPEND	5
 
+/* Number of events kept per CPU by the binary tracer (power of two) */
+#define POWER_TRACE_ENTRIES	32
+
 void trace_power_flow(unsigned long mpidr, unsigned char mode);
+#if MTK_POWER_TRACE_BUFFER
+int power_trace_read(unsigned int cpu, unsigned int idx, uint64_t *count,
+		     uint64_t *data, uint64_t *timestamp);
+#endif
 
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -35,7 +35,6 @@
 #include <cci.h>
 #include <console.h>
 #include <debug.h>
-#include <errno.h>
 #include <mcucfg.h>
 #include <mmio.h>
 #include <mt8173_def.h>
@@ -49,6 +48,23 @@
 #include <spm_mcdi.h>
 #include <spm_suspend.h>
 
+#define MTK_PWR_LVL0	0
+#define MTK_PWR_LVL1	1
+#define MTK_PWR_LVL2	2
+
+/* Macros to read the MTK power domain state */
+#define MTK_CORE_PWR_STATE(state)	(state)->pwr_domain_state[MTK_PWR_LVL0]
+#define MTK_CLUSTER_PWR_STATE(state)	(state)->pwr_domain_state[MTK_PWR_LVL1]
+#define MTK_SYSTEM_PWR_STATE(state)	(state)->pwr_domain_state[MTK_PWR_LVL2]
+
+/* Highest power level an MCDI idle state turns off: the CPU or its cluster */
+#define plat_mcdi_pwr_lvl(state)					\
+	((MTK_CLUSTER_PWR_STATE(state) == MTK_LOCAL_STATE_OFF) ?	\
+	 MTK_PWR_LVL1 : MTK_PWR_LVL0)
+
+/* Entry point of the CPUs on their way back from a power down */
+static uintptr_t secure_entrypoint;
+
 struct core_context {
 	unsigned long timer_data[8];
 	unsigned int count;
@@ -220,115 +236,60 @@ static void mt_platform_restore_context(unsigned long mpidr)
 }
 
 /*******************************************************************************
-* Private function which is used to determine if any platform actions
-* should be performed for the specified affinity instance given its
-* state. Nothing needs to be done if the 'state' is not off or if this is not
-* the highest affinity level which will enter the 'state'.
-*******************************************************************************/
-static int32_t plat_do_plat_actions(unsigned int afflvl, unsigned int state)
+ * MTK_platform handler called when a CPU is about to enter standby.
+ ******************************************************************************/
+static void plat_cpu_standby(plat_local_state_t cpu_state)
 {
-	unsigned int max_phys_off_afflvl;
-
-	assert(afflvl <= MPIDR_AFFLVL2);
-
-	if (state != PSCI_STATE_OFF)
-		return -EAGAIN;
+	assert(cpu_state == MTK_LOCAL_STATE_RET);
 
 	/*
-	 * Find the highest affinity level which will be suspended and postpone
-	 * all the platform specific actions until that level is hit.
+	 * Enter standby state. dsb is good practice before using wfi
+	 * to enter low power states.
 	 */
-	max_phys_off_afflvl = psci_get_max_phys_off_afflvl();
-	assert(max_phys_off_afflvl != PSCI_INVALID_DATA);
-	if (afflvl != max_phys_off_afflvl)
-		return -EAGAIN;
-
-	return 0;
+	dsb();
+	wfi();
 }
 
 /*******************************************************************************
- * MTK_platform handler called when an affinity instance is about to enter
- * standby.
+ * Return the address of the reset vector register of the CPU 'mpidr'.
  ******************************************************************************/
-static void plat_affinst_standby(unsigned int power_state)
+static uintptr_t plat_cpu_rv_addr(unsigned long mpidr)
 {
-	unsigned int target_afflvl;
+	unsigned long cpu_id = mpidr & MPIDR_CPU_MASK;
 
-	/* Sanity check the requested state */
-	target_afflvl = psci_get_pstate_afflvl(power_state);
+	if (mpidr & MPIDR_CLUSTER_MASK)
+		return (uintptr_t)&mt8173_mcucfg->mp1_rv_addr[cpu_id].rv_addr_lw;
 
-	/*
-	 * It's possible to enter standby only on affinity level 0 i.e. a cpu
-	 * on the MTK_platform. Ignore any other affinity level.
-	 */
-	if (target_afflvl == MPIDR_AFFLVL0) {
-		/*
-		 * Enter standby state. dsb is good practice before using wfi
-		 * to enter low power states.
-		 */
-		dsb();
-		wfi();
-	}
+	return (uintptr_t)&mt8173_mcucfg->mp0_rv_addr[cpu_id].rv_addr_lw;
 }
 
 /*******************************************************************************
- * MTK_platform handler called when an affinity instance is about to be turned
- * on. The level and mpidr determine the affinity instance.
+ * MTK_platform handler called when a power domain is about to be turned on.
+ * The mpidr determines the CPU to be turned on.
  ******************************************************************************/
-static int plat_affinst_on(unsigned long mpidr,
-		    unsigned long sec_entrypoint,
-		    unsigned int afflvl,
-		    unsigned int state)
+static int plat_power_domain_on(u_register_t mpidr)
 {
-	int rc = PSCI_E_SUCCESS;
-	unsigned long cpu_id;
-	unsigned long cluster_id;
-	uintptr_t rv;
-
-	/*
-	 * It's possible to turn on only affinity level 0 i.e. a cpu
-	 * on the MTK_platform. Ignore any other affinity level.
-	 */
-	if (afflvl != MPIDR_AFFLVL0)
-		return rc;
-
-	cpu_id = mpidr & MPIDR_CPU_MASK;
-	cluster_id = mpidr & MPIDR_CLUSTER_MASK;
+	uintptr_t rv = plat_cpu_rv_addr(mpidr);
 
-	if (cluster_id)
-		rv = (uintptr_t)&mt8173_mcucfg->mp1_rv_addr[cpu_id].rv_addr_lw;
-	else
-		rv = (uintptr_t)&mt8173_mcucfg->mp0_rv_addr[cpu_id].rv_addr_lw;
-
-	mmio_write_32(rv, sec_entrypoint);
+	mmio_write_32(rv, secure_entrypoint);
 	INFO("mt_on[%ld:%ld], entry %x\n",
-		cluster_id, cpu_id, mmio_read_32(rv));
+		(mpidr & MPIDR_CLUSTER_MASK) >> MPIDR_AFFINITY_BITS,
+		mpidr & MPIDR_CPU_MASK, mmio_read_32(rv));
 
 	spm_hotplug_on(mpidr);
 
-	return rc;
+	return PSCI_E_SUCCESS;
 }
 
 /*******************************************************************************
- * MTK_platform handler called when an affinity instance is about to be turned
- * off. The level and mpidr determine the affinity instance. The 'state' arg.
- * allows the platform to decide whether the cluster is being turned off and
- * take apt actions.
- *
- * CAUTION: This function is called with coherent stacks so that caches can be
- * turned off, flushed and coherency disabled. There is no guarantee that caches
- * will remain turned on across calls to this function as each affinity level is
- * dealt with. So do not write & read global variables across calls. It will be
- * wise to do flush a write to the global to prevent unpredictable results.
+ * MTK_platform handler called when a power domain is about to be turned off.
+ * The target_state encodes the power state that each level should transition
+ * to.
  ******************************************************************************/
-static void plat_affinst_off(unsigned int afflvl, unsigned int state)
+static void plat_power_domain_off(const psci_power_state_t *target_state)
 {
 	unsigned long mpidr = read_mpidr_el1();
 
-	/* Determine if any platform actions need to be executed. */
-	if (plat_do_plat_actions(afflvl, state) == -EAGAIN)
-		return;
-
 	/* Prevent interrupts from spuriously waking up this cpu */
 	arm_gic_cpuif_deactivate();
 
@@ -336,63 +297,41 @@ static void plat_affinst_off(unsigned int afflvl, unsigned int state)
 
 	trace_power_flow(mpidr, CPU_DOWN);
 
-	if (afflvl != MPIDR_AFFLVL0) {
+	if (MTK_CLUSTER_PWR_STATE(target_state) == MTK_LOCAL_STATE_OFF) {
 		/* Disable coherency if this cluster is to be turned off */
 		plat_cci_disable();
+		disable_scu(mpidr);
 
 		trace_power_flow(mpidr, CLUSTER_DOWN);
 	}
 }
 
 /*******************************************************************************
- * MTK_platform handler called when an affinity instance is about to be
- * suspended. The level and mpidr determine the affinity instance. The 'state'
- * arg. allows the platform to decide whether the cluster is being turned off
- * and take apt actions.
- *
- * CAUTION: This function is called with coherent stacks so that caches can be
- * turned off, flushed and coherency disabled. There is no guarantee that caches
- * will remain turned on across calls to this function as each affinity level is
- * dealt with. So do not write & read global variables across calls. It will be
- * wise to do flush a write to the global to prevent unpredictable results.
+ * MTK_platform handler called when a power domain is about to be suspended.
+ * The target_state encodes the power state that each level should transition
+ * to. CPU and cluster level states go through MCDI (multi-core deep idle),
+ * the system level state through the system suspend firmware of the SPM.
  ******************************************************************************/
-static void plat_affinst_suspend(unsigned long sec_entrypoint,
-			  unsigned int afflvl,
-			  unsigned int state)
+static void plat_power_domain_suspend(const psci_power_state_t *target_state)
 {
 	unsigned long mpidr = read_mpidr_el1();
-	unsigned long cluster_id;
-	unsigned long cpu_id;
-	uintptr_t rv;
 
-	/* Determine if any platform actions need to be executed. */
-	if (plat_do_plat_actions(afflvl, state) == -EAGAIN)
-		return;
+	mmio_write_32(plat_cpu_rv_addr(mpidr), secure_entrypoint);
 
-	cpu_id = mpidr & MPIDR_CPU_MASK;
-	cluster_id = mpidr & MPIDR_CLUSTER_MASK;
+	if (MTK_SYSTEM_PWR_STATE(target_state) != MTK_LOCAL_STATE_OFF)
+		spm_mcdi_prepare_for_off_state(mpidr,
+					       plat_mcdi_pwr_lvl(target_state));
 
-	if (cluster_id)
-		rv = (uintptr_t)&mt8173_mcucfg->mp1_rv_addr[cpu_id].rv_addr_lw;
-	else
-		rv = (uintptr_t)&mt8173_mcucfg->mp0_rv_addr[cpu_id].rv_addr_lw;
-
-	mmio_write_32(rv, sec_entrypoint);
-
-	if (afflvl < MPIDR_AFFLVL2)
-		spm_mcdi_prepare_for_off_state(mpidr, afflvl);
-
-	if (afflvl >= MPIDR_AFFLVL0)
-		mt_platform_save_context(mpidr);
+	mt_platform_save_context(mpidr);
 
 	/* Perform the common cluster specific operations */
-	if (afflvl >= MPIDR_AFFLVL1) {
+	if (MTK_CLUSTER_PWR_STATE(target_state) == MTK_LOCAL_STATE_OFF) {
 		/* Disable coherency if this cluster is to be turned off */
 		plat_cci_disable();
+		disable_scu(mpidr);
 	}
 
-	if (afflvl >= MPIDR_AFFLVL2) {
-		disable_scu(mpidr);
+	if (MTK_SYSTEM_PWR_STATE(target_state) == MTK_LOCAL_STATE_OFF) {
 		generic_timer_backup();
 		spm_system_suspend();
 		/* Prevent interrupts from spuriously waking up this cpu */
@@ -401,23 +340,20 @@ static void plat_affinst_suspend(unsigned long sec_entrypoint,
 }
 
 /*******************************************************************************
- * MTK_platform handler called when an affinity instance has just been powered
- * on after being turned off earlier. The level and mpidr determine the affinity
- * instance. The 'state' arg. allows the platform to decide whether the cluster
- * was turned off prior to wakeup and do what's necessary to setup it up
- * correctly.
+ * MTK_platform handler called when a power domain has just been powered on
+ * after being turned off earlier. The target_state encodes the low power state
+ * that each level has woken up from.
  ******************************************************************************/
-static void plat_affinst_on_finish(unsigned int afflvl, unsigned int state)
+static void plat_power_domain_on_finish(const psci_power_state_t *target_state)
 {
 	unsigned long mpidr = read_mpidr_el1();
 
-	/* Determine if any platform actions need to be executed. */
-	if (plat_do_plat_actions(afflvl, state) == -EAGAIN)
-		return;
+	assert(MTK_CORE_PWR_STATE(target_state) == MTK_LOCAL_STATE_OFF);
 
 	/* Perform the common cluster specific operations */
-	if (afflvl >= MPIDR_AFFLVL1) {
+	if (MTK_CLUSTER_PWR_STATE(target_state) == MTK_LOCAL_STATE_OFF) {
 		/* Enable coherency if this cluster was off */
+		enable_scu(mpidr);
 		plat_cci_enable();
 		trace_power_flow(mpidr, CLUSTER_UP);
 	}
@@ -429,45 +365,78 @@ static void plat_affinst_on_finish(unsigned int afflvl, unsigned int state)
 }
 
 /*******************************************************************************
- * MTK_platform handler called when an affinity instance has just been powered
- * on after having been suspended earlier. The level and mpidr determine the
- * affinity instance.
+ * MTK_platform handler called when a power domain has just been powered on
+ * after having been suspended earlier. The target_state encodes the low power
+ * state that each level has woken up from.
  ******************************************************************************/
-static void plat_affinst_suspend_finish(unsigned int afflvl, unsigned int state)
+static void plat_power_domain_suspend_finish(
+					const psci_power_state_t *target_state)
 {
 	unsigned long mpidr = read_mpidr_el1();
 
-	/* Determine if any platform actions need to be executed. */
-	if (plat_do_plat_actions(afflvl, state) == -EAGAIN)
-		return;
-
-	if (afflvl >= MPIDR_AFFLVL2) {
+	if (MTK_SYSTEM_PWR_STATE(target_state) == MTK_LOCAL_STATE_OFF) {
 		/* Enable the gic cpu interface */
 		arm_gic_setup();
 		arm_gic_cpuif_setup();
 		spm_system_suspend_finish();
-		enable_scu(mpidr);
 	}
 
 	/* Perform the common cluster specific operations */
-	if (afflvl >= MPIDR_AFFLVL1) {
+	if (MTK_CLUSTER_PWR_STATE(target_state) == MTK_LOCAL_STATE_OFF) {
 		/* Enable coherency if this cluster was off */
+		enable_scu(mpidr);
 		plat_cci_enable();
 	}
 
-	if (afflvl >= MPIDR_AFFLVL0)
-		mt_platform_restore_context(mpidr);
+	mt_platform_restore_context(mpidr);
 
-	if (afflvl < MPIDR_AFFLVL2)
-		spm_mcdi_finish_for_on_state(mpidr, afflvl);
+	if (MTK_SYSTEM_PWR_STATE(target_state) != MTK_LOCAL_STATE_OFF)
+		spm_mcdi_finish_for_on_state(mpidr,
+					     plat_mcdi_pwr_lvl(target_state));
 
 	arm_gic_pcpu_distif_setup();
 }
 
-static unsigned int plat_get_sys_suspend_power_state(void)
+static void plat_get_sys_suspend_power_state(psci_power_state_t *req_state)
+{
+	int i;
+
+	assert(PLAT_MAX_PWR_LVL >= MTK_PWR_LVL2);
+
+	for (i = MTK_PWR_LVL0; i <= PLAT_MAX_PWR_LVL; i++)
+		req_state->pwr_domain_state[i] = MTK_LOCAL_STATE_OFF;
+}
+
+/*******************************************************************************
+ * MTK_platform handler called to check the validity of the power state
+ * parameter. Standby is only possible at the CPU level, power down at any
+ * level up to the system. The State-ID is not used.
+ ******************************************************************************/
+static int plat_validate_power_state(unsigned int power_state,
+				     psci_power_state_t *req_state)
 {
-	/* StateID: 0, StateType: 1(power down), PowerLevel: 2(system) */
-	return psci_make_powerstate(0, 1, 2);
+	int pstate = psci_get_pstate_type(power_state);
+	int pwr_lvl = psci_get_pstate_pwrlvl(power_state);
+	int i;
+
+	assert(req_state);
+
+	if (pwr_lvl > PLAT_MAX_PWR_LVL)
+		return PSCI_E_INVALID_PARAMS;
+
+	if (pstate == PSTATE_TYPE_STANDBY) {
+		if (pwr_lvl != MTK_PWR_LVL0)
+			return PSCI_E_INVALID_PARAMS;
+
+		req_state->pwr_domain_state[MTK_PWR_LVL0] =
+					MTK_LOCAL_STATE_RET;
+	} else {
+		for (i = MTK_PWR_LVL0; i <= pwr_lvl; i++)
+			req_state->pwr_domain_state[i] =
+					MTK_LOCAL_STATE_OFF;
+	}
+
+	return PSCI_E_SUCCESS;
 }
 
 /*******************************************************************************
@@ -503,15 +472,16 @@ static void __dead2 plat_system_reset(void)
 /*******************************************************************************
  * Export the platform handlers to enable psci to invoke them
  ******************************************************************************/
-static const plat_pm_ops_t plat_plat_pm_ops = {
-	.affinst_standby		= plat_affinst_standby,
-	.affinst_on			= plat_affinst_on,
-	.affinst_off			= plat_affinst_off,
-	.affinst_suspend		= plat_affinst_suspend,
-	.affinst_on_finish		= plat_affinst_on_finish,
-	.affinst_suspend_finish		= plat_affinst_suspend_finish,
+static const plat_psci_ops_t plat_plat_pm_ops = {
+	.cpu_standby			= plat_cpu_standby,
+	.pwr_domain_on			= plat_power_domain_on,
+	.pwr_domain_off			= plat_power_domain_off,
+	.pwr_domain_suspend		= plat_power_domain_suspend,
+	.pwr_domain_on_finish		= plat_power_domain_on_finish,
+	.pwr_domain_suspend_finish	= plat_power_domain_suspend_finish,
 	.system_off			= plat_system_off,
 	.system_reset			= plat_system_reset,
+	.validate_power_state		= plat_validate_power_state,
 	.get_sys_suspend_power_state	= plat_get_sys_suspend_power_state,
 };
 
@@ -519,8 +489,10 @@ static const plat_pm_ops_t plat_plat_pm_ops = {
  * Export the platform specific power ops & initialize the mtk_platform power
  * controller
  ******************************************************************************/
-int platform_setup_pm(const plat_pm_ops_t **plat_ops)
+int plat_setup_psci_ops(uintptr_t sec_entrypoint,
+			const plat_psci_ops_t **psci_ops)
 {
-	*plat_ops = &plat_plat_pm_ops;
+	*psci_ops = &plat_plat_pm_ops;
+	secure_entrypoint = sec_entrypoint;
 	return 0;
 }
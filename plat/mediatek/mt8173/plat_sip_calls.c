@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -30,6 +30,7 @@
 #include <mmio.h>
 #include <mtk_sip_svc.h>
 #include <mtcmos.h>
+#include <power_tracer.h>
 
 /* Authorized secure register list */
 enum {
@@ -83,3 +84,15 @@ uint64_t mt_sip_pwr_mtcmos_support(void)
 {
 	return MTK_SIP_E_SUCCESS;
 }
+
+#if MTK_POWER_TRACE_BUFFER
+uint64_t mt_sip_power_trace_read(uint32_t cpu, uint32_t idx,
+				 uint64_t *count, uint64_t *data,
+				 uint64_t *timestamp)
+{
+	if (power_trace_read(cpu, idx, count, data, timestamp))
+		return MTK_SIP_E_INVALID_PARAM;
+
+	return MTK_SIP_E_SUCCESS;
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -29,9 +29,79 @@
  */
 
 #include <arch.h>
+#include <arch_helpers.h>
 #include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
 #include <power_tracer.h>
 
+#if MTK_POWER_TRACE_BUFFER
+
+/*
+ * Each CPU only ever writes its own ring buffer, so no lock is needed. The
+ * buffers live in coherent memory because events are also recorded while the
+ * CPU runs with its data cache disabled around power down.
+ */
+struct power_trace_entry {
+	uint64_t timestamp;
+	uint32_t mpidr;
+	uint32_t mode;
+};
+
+struct power_trace_ring {
+	struct power_trace_entry entry[POWER_TRACE_ENTRIES];
+	uint32_t count;
+};
+
+static struct power_trace_ring power_trace[PLATFORM_CORE_COUNT]
+	__section("tzfw_coherent_mem");
+
+void trace_power_flow(unsigned long mpidr, unsigned char mode)
+{
+	struct power_trace_ring *ring = &power_trace[plat_my_core_pos()];
+	struct power_trace_entry *entry;
+
+	entry = &ring->entry[ring->count & (POWER_TRACE_ENTRIES - 1)];
+	entry->timestamp = read_cntpct_el0();
+	entry->mpidr = mpidr & MPIDR_AFFINITY_MASK;
+	entry->mode = mode;
+	ring->count++;
+}
+
+/*
+ * Returns the event with sequence number 'idx' recorded by CPU 'cpu', along
+ * with the total number of events that CPU has recorded so far. Only the
+ * last POWER_TRACE_ENTRIES events are kept.
+ */
+int power_trace_read(unsigned int cpu, unsigned int idx, uint64_t *count,
+		     uint64_t *data, uint64_t *timestamp)
+{
+	struct power_trace_ring *ring;
+	struct power_trace_entry *entry;
+
+	if (cpu >= PLATFORM_CORE_COUNT)
+		return -1;
+
+	ring = &power_trace[cpu];
+	*count = ring->count;
+
+	if ((idx >= ring->count) ||
+	    (ring->count - idx > POWER_TRACE_ENTRIES))
+		return -1;
+
+	entry = &ring->entry[idx & (POWER_TRACE_ENTRIES - 1)];
+	*data = ((uint64_t)entry->mode << 32) | entry->mpidr;
+	*timestamp = entry->timestamp;
+
+	/* The event may have been overwritten while it was being read */
+	if (ring->count - idx > POWER_TRACE_ENTRIES)
+		return -1;
+
+	return 0;
+}
+
+#else /* MTK_POWER_TRACE_BUFFER */
+
 #define trace_log(...)  INFO("psci: " __VA_ARGS__)
 
 void trace_power_flow(unsigned long mpidr, unsigned char mode)
@@ -69,3 +139,5 @@ void trace_power_flow(unsigned long mpidr, unsigned char mode)
 		break;
 	}
 }
+
+#endif /* MTK_POWER_TRACE_BUFFER */
@@ -29,25 +29,70 @@
  */
 
 #include <arch.h>
+#include <arch_helpers.h>
 #include <mcucfg.h>
 #include <mmio.h>
+#include <platform_def.h>
 
-void disable_scu(unsigned long mpidr)
+/*
+ * Last ACINACTM state written for each cluster, so that the writes which
+ * would leave it unchanged are skipped, e.g. when the last CPU of a cluster
+ * aborts its power down. The MCUCFG registers keep their value across cluster
+ * power downs. A system suspend, which may reset them, always sets ACINACTM
+ * first, so the cached state never claims an active interface which is not.
+ * The state is read from the hardware the first time a cluster is seen. It is
+ * updated with the data cache disabled on the power down path, hence the
+ * flush after each update.
+ */
+enum {
+	SCU_STATE_UNKNOWN = 0,
+	SCU_STATE_ACTIVE,
+	SCU_STATE_INACTIVE
+};
+
+static uint32_t scu_state[PLATFORM_CLUSTER_COUNT];
+
+static uintptr_t scu_reg(unsigned long mpidr, uint32_t *bit)
+{
+	if (mpidr & MPIDR_CLUSTER_MASK) {
+		*bit = MP1_ACINACTM;
+		return (uintptr_t)&mt8173_mcucfg->mp1_miscdbg;
+	}
+
+	*bit = MP0_ACINACTM;
+	return (uintptr_t)&mt8173_mcucfg->mp0_axi_config;
+}
+
+static void scu_set_state(unsigned long mpidr, uint32_t state)
 {
-	if (mpidr & MPIDR_CLUSTER_MASK)
-		mmio_setbits_32((uintptr_t)&mt8173_mcucfg->mp1_miscdbg,
-			MP1_ACINACTM);
+	unsigned int cluster = (mpidr & MPIDR_CLUSTER_MASK) >>
+			       MPIDR_AFFINITY_BITS;
+	uint32_t *cached = &scu_state[cluster];
+	uint32_t bit;
+	uintptr_t reg = scu_reg(mpidr, &bit);
+
+	if (*cached == SCU_STATE_UNKNOWN)
+		*cached = (mmio_read_32(reg) & bit) ?
+			  SCU_STATE_INACTIVE : SCU_STATE_ACTIVE;
+
+	if (*cached == state)
+		return;
+
+	if (state == SCU_STATE_INACTIVE)
+		mmio_setbits_32(reg, bit);
 	else
-		mmio_setbits_32((uintptr_t)&mt8173_mcucfg->mp0_axi_config,
-			MP0_ACINACTM);
+		mmio_clrbits_32(reg, bit);
+
+	*cached = state;
+	flush_dcache_range((uint64_t)cached, sizeof(*cached));
+}
+
+void disable_scu(unsigned long mpidr)
+{
+	scu_set_state(mpidr, SCU_STATE_INACTIVE);
 }
 
 void enable_scu(unsigned long mpidr)
 {
-	if (mpidr & MPIDR_CLUSTER_MASK)
-		mmio_clrbits_32((uintptr_t)&mt8173_mcucfg->mp1_miscdbg,
-			MP1_ACINACTM);
-	else
-		mmio_clrbits_32((uintptr_t)&mt8173_mcucfg->mp0_axi_config,
-			MP0_ACINACTM);
+	scu_set_state(mpidr, SCU_STATE_ACTIVE);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -65,7 +65,33 @@ static const uint64_t flowctrl_offset_cc4_ctrl[4] = {
 	(TEGRA_FLOWCTRL_BASE + FLOWCTRL_CC4_CORE0_CTRL + 12)
 };
 
-static inline void tegra_fc_cc4_ctrl(int cpu_id, uint32_t val)
+/*
+ * HALT and CSR values used to power down each CPU on WFI. They only depend
+ * on the CPU number, so they are computed once rather than on every idle
+ * entry.
+ */
+#define FLOWCTRL_CPU_PWRDN_HALT	(FLOWCTRL_HALT_GIC_IRQ |		\
+				 FLOWCTRL_HALT_GIC_FIQ |		\
+				 FLOWCTRL_HALT_LIC_IRQ |		\
+				 FLOWCTRL_HALT_LIC_FIQ |		\
+				 FLOWCTRL_WAITEVENT)
+
+#define FLOWCTRL_CPU_PWRDN_CSR(cpu)	(FLOWCTRL_CSR_INTR_FLAG |	\
+					 FLOWCTRL_CSR_EVENT_FLAG |	\
+					 FLOWCTRL_CSR_ENABLE |		\
+					 (FLOWCTRL_WAIT_WFI_BITMAP << (cpu)))
+
+static const uint32_t flowctrl_cpu_pwrdn_csr[4] = {
+	FLOWCTRL_CPU_PWRDN_CSR(0),
+	FLOWCTRL_CPU_PWRDN_CSR(1),
+	FLOWCTRL_CPU_PWRDN_CSR(2),
+	FLOWCTRL_CPU_PWRDN_CSR(3)
+};
+
+/*******************************************************************************
+ * Enable or disable CC4 (clock gated retention) on WFI for a CPU
+ ******************************************************************************/
+void tegra_fc_cc4_ctrl(int cpu_id, uint32_t val)
 {
 	mmio_write_32(flowctrl_offset_cc4_ctrl[cpu_id], val);
 	val = mmio_read_32(flowctrl_offset_cc4_ctrl[cpu_id]);
@@ -85,16 +111,14 @@ static inline void tegra_fc_halt_cpu(int cpu_id, uint32_t val)
 
 static void tegra_fc_prepare_suspend(int cpu_id, uint32_t csr)
 {
-	uint32_t val;
-
-	val = FLOWCTRL_HALT_GIC_IRQ | FLOWCTRL_HALT_GIC_FIQ |
-	      FLOWCTRL_HALT_LIC_IRQ | FLOWCTRL_HALT_LIC_FIQ |
-	      FLOWCTRL_WAITEVENT;
-	tegra_fc_halt_cpu(cpu_id, val);
-
-	val = FLOWCTRL_CSR_INTR_FLAG | FLOWCTRL_CSR_EVENT_FLAG |
-	      FLOWCTRL_CSR_ENABLE | (FLOWCTRL_WAIT_WFI_BITMAP << cpu_id);
-	tegra_fc_cpu_csr(cpu_id, val | csr);
+	/*
+	 * Device accesses to the flow controller complete in program order,
+	 * so only the last write needs to be read back to make sure both
+	 * have reached the flow controller before the CPU executes WFI.
+	 */
+	mmio_write_32(flowctrl_offset_halt_cpu[cpu_id],
+		      FLOWCTRL_CPU_PWRDN_HALT);
+	tegra_fc_cpu_csr(cpu_id, flowctrl_cpu_pwrdn_csr[cpu_id] | csr);
 }
 
 /*******************************************************************************
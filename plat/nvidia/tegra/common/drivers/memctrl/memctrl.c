@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -31,21 +31,35 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
 #include <mmio.h>
 #include <memctrl.h>
 #include <string.h>
 #include <tegra_def.h>
+#include <tegra_private.h>
 #include <xlat_tables.h>
 
-extern void zeromem16(void *mem, unsigned int length);
-
 #define TEGRA_GPU_RESET_REG_OFFSET	0x28c
 #define  GPU_RESET_BIT			(1 << 24)
 
+/*
+ * The previous Video Memory carveout is scrubbed in blocks of this size,
+ * aligned to it, so that each block can be mapped with at most one level 3
+ * translation table.
+ */
+#define VIDEOMEM_SCRUB_CHUNK		(2 * 1024 * 1024)
+
 /* Video Memory base and size (live values) */
 static uintptr_t video_mem_base;
 static uint64_t video_mem_size;
 
+#if TEGRA_VIDEOMEM_SCRUB_BUDGET_US
+/* Carveout update left pending when the scrub ran out of time */
+static uint64_t videomem_pending_base;
+static uint32_t videomem_pending_size;
+static uint64_t videomem_pending_token;
+#endif
+
 /*
  * Init SMMU.
  */
@@ -107,6 +121,35 @@ void tegra_memctrl_tzdram_setup(uint64_t phys_base, uint32_t size_in_bytes)
 	tegra_mc_write_32(MC_SECURITY_CFG1_0, size_in_bytes >> 20);
 }
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
+				 unsigned long long non_overlap_area_size)
+{
+	int ret;
+
+	/*
+	 * Map the area as cacheable Normal memory so that 'zero_normalmem'
+	 * can use DC ZVA, then clean and invalidate it so that the zeroes
+	 * reach the main memory and no cache lines of the secure mapping
+	 * are left behind.
+	 */
+	ret = mmap_add_dynamic_region(non_overlap_area_start,
+				      non_overlap_area_start,
+				      non_overlap_area_size,
+				      MT_MEMORY | MT_RW | MT_SECURE);
+	if (ret != 0) {
+		ERROR("Failed to map the Video Memory (%d)\n", ret);
+		panic();
+	}
+
+	zero_normalmem((void *)non_overlap_area_start, non_overlap_area_size);
+	flush_dcache_range(non_overlap_area_start, non_overlap_area_size);
+
+	ret = mmap_remove_dynamic_region(non_overlap_area_start,
+					 non_overlap_area_size);
+	assert(ret == 0);
+}
+#else
 static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
 				 unsigned long long non_overlap_area_size)
 {
@@ -114,28 +157,99 @@ static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
 	 * Perform cache maintenance to ensure that the non-overlapping area is
 	 * zeroed out. The first invalidation of this range ensures that
 	 * possible evictions of dirty cache lines do not interfere with the
-	 * 'zeromem16' operation. Other CPUs could speculatively prefetch the
-	 * main memory contents of this area between the first invalidation and
-	 * the 'zeromem16' operation. The second invalidation ensures that any
-	 * such cache lines are removed as well.
+	 * 'zero_normalmem' operation. Other CPUs could speculatively prefetch
+	 * the main memory contents of this area between the first invalidation
+	 * and the 'zero_normalmem' operation. The second invalidation ensures
+	 * that any such cache lines are removed as well.
 	 */
 	inv_dcache_range(non_overlap_area_start, non_overlap_area_size);
-	zeromem16((void *)non_overlap_area_start, non_overlap_area_size);
+	zero_normalmem((void *)non_overlap_area_start, non_overlap_area_size);
 	inv_dcache_range(non_overlap_area_start, non_overlap_area_size);
 }
+#endif
+
+/*
+ * Scrub the parts of the current Video Memory carveout which are not covered
+ * by the new one, skipping the first '*done' bytes of them. '*done' is updated
+ * after each block. Returns -EAGAIN if the system counter reaches 'deadline'
+ * (when non-zero) before the end, and 0 once everything is scrubbed.
+ */
+static int tegra_scrub_old_videomem(uintptr_t new_base, uintptr_t new_end,
+				    uint64_t *done, uint64_t deadline)
+{
+	uintptr_t old_base = video_mem_base;
+	uintptr_t old_end = video_mem_base + (video_mem_size << 20);
+	uintptr_t area_start[2], area_end[2], pos;
+	uint64_t skip = *done, chunk;
+	int i, num_areas = 0;
+
+	/*
+	 * The following cases can occur -
+	 *
+	 * 1. clear whole old region (no overlap with new region)
+	 * 2. clear old sub-region below new base
+	 * 3. clear old sub-region above new end
+	 */
+	if (new_base > old_end || old_base > new_end) {
+		area_start[num_areas] = old_base;
+		area_end[num_areas++] = old_end;
+	} else {
+		if (old_base < new_base) {
+			area_start[num_areas] = old_base;
+			area_end[num_areas++] = new_base;
+		}
+		if (old_end > new_end) {
+			area_start[num_areas] = new_end;
+			area_end[num_areas++] = old_end;
+		}
+	}
+
+	for (i = 0; i < num_areas; i++) {
+		if (skip >= area_end[i] - area_start[i]) {
+			skip -= area_end[i] - area_start[i];
+			continue;
+		}
+
+		for (pos = area_start[i] + skip; pos < area_end[i];
+		     pos += chunk) {
+			chunk = VIDEOMEM_SCRUB_CHUNK -
+				(pos & (VIDEOMEM_SCRUB_CHUNK - 1));
+			if (chunk > area_end[i] - pos)
+				chunk = area_end[i] - pos;
+
+			tegra_clear_videomem(pos, chunk);
+			*done += chunk;
+
+			if (deadline && read_cntpct_el0() >= deadline &&
+			    (pos + chunk < area_end[i] || i + 1 < num_areas))
+				return -EAGAIN;
+		}
+		skip = 0;
+	}
+
+	return 0;
+}
 
 /*
  * Program the Video Memory carveout region
  *
  * phys_base = physical base of aperture
  * size_in_bytes = size of aperture in bytes
+ * token = continuation token, 0 for a new request
+ *
+ * When TEGRA_VIDEOMEM_SCRUB_BUDGET_US is non-zero and scrubbing the previous
+ * carveout takes longer than that, -EAGAIN is returned and 'token' is updated.
+ * The old carveout stays in place until the same request is issued again with
+ * that token and the scrub completes, so the memory not scrubbed yet is never
+ * exposed. Returns 0 on completion and -EINVAL for an unexpected token.
  */
-void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
+int tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes,
+				 uint64_t *token)
 {
-	uintptr_t vmem_end_old = video_mem_base + (video_mem_size << 20);
 	uintptr_t vmem_end_new = phys_base + size_in_bytes;
 	uint32_t regval;
-	unsigned long long non_overlap_area_size;
+	uint64_t scrubbed = 0, deadline = 0;
+	int ret;
 
 	/*
 	 * The GPU is the user of the Video Memory region. In order to
@@ -145,9 +259,23 @@ void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
 	regval = mmio_read_32(TEGRA_CAR_RESET_BASE + TEGRA_GPU_RESET_REG_OFFSET);
 	if ((regval & GPU_RESET_BIT) == 0) {
 		ERROR("GPU not in reset! Video Memory setup failed\n");
-		return;
+		return 0;
 	}
 
+#if TEGRA_VIDEOMEM_SCRUB_BUDGET_US
+	if (*token != 0) {
+		/* Resume the pending request */
+		if (*token != videomem_pending_token ||
+		    phys_base != videomem_pending_base ||
+		    size_in_bytes != videomem_pending_size)
+			return -EINVAL;
+		scrubbed = *token;
+	}
+
+	deadline = read_cntpct_el0() + (TEGRA_VIDEOMEM_SCRUB_BUDGET_US *
+					plat_get_syscnt_freq()) / 1000000;
+#endif
+
 	/*
 	 * Setup the Memory controller to restrict CPU accesses to the Video
 	 * Memory region
@@ -160,30 +288,34 @@ void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
 	if (video_mem_base == 0)
 		goto done;
 
-	/*
-	 * Clear the old regions now being exposed. The following cases
-	 * can occur -
-	 *
-	 * 1. clear whole old region (no overlap with new region)
-	 * 2. clear old sub-region below new base
-	 * 3. clear old sub-region above new end
-	 */
+	/* Clear the old regions now being exposed */
 	INFO("Cleaning previous Video Memory Carveout\n");
 
+#if !PLAT_XLAT_TABLES_DYNAMIC
 	disable_mmu_el3();
-	if (phys_base > vmem_end_old || video_mem_base > vmem_end_new) {
-		tegra_clear_videomem(video_mem_base, video_mem_size << 20);
-	} else {
-		if (video_mem_base < phys_base) {
-			non_overlap_area_size = phys_base - video_mem_base;
-			tegra_clear_videomem(video_mem_base, non_overlap_area_size);
-		}
-		if (vmem_end_old > vmem_end_new) {
-			non_overlap_area_size = vmem_end_old - vmem_end_new;
-			tegra_clear_videomem(vmem_end_new, non_overlap_area_size);
-		}
-	}
+#endif
+	ret = tegra_scrub_old_videomem(phys_base, vmem_end_new, &scrubbed,
+				       deadline);
+#if !PLAT_XLAT_TABLES_DYNAMIC
 	enable_mmu_el3(0);
+#endif
+
+#if TEGRA_VIDEOMEM_SCRUB_BUDGET_US
+	if (ret == -EAGAIN) {
+		videomem_pending_base = phys_base;
+		videomem_pending_size = size_in_bytes;
+		videomem_pending_token = scrubbed;
+		*token = scrubbed;
+		return ret;
+	}
+	videomem_pending_token = 0;
+#else
+	(void)token;
+#endif
+	if (ret != 0) {
+		ERROR("Failed to scrub the Video Memory (%d)\n", ret);
+		panic();
+	}
 
 done:
 	tegra_mc_write_32(MC_VIDEO_PROTECT_BASE, phys_base);
@@ -192,4 +324,6 @@ done:
 	/* store new values */
 	video_mem_base = phys_base;
 	video_mem_size = size_in_bytes >> 20;
+
+	return 0;
 }
@@ -31,10 +31,14 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
+#include <delay_timer.h>
 #include <mmio.h>
 #include <pmc.h>
 #include <tegra_def.h>
 
+/* Time allowed to each step of the power ungate procedure */
+#define PMC_PWRGATE_TIMEOUT_US		100000
+
 /* Module IDs used during power ungate procedure */
 static const int pmc_cpu_powergate_id[4] = {
 	0, /* CPU 0 */
@@ -43,6 +47,16 @@ static const int pmc_cpu_powergate_id[4] = {
 	11 /* CPU 3 */
 };
 
+/*******************************************************************************
+ * The PMC did not complete a step of the power ungate procedure in time. The
+ * CPU cannot be turned on and its state is unknown, so give up.
+ ******************************************************************************/
+static void __dead2 tegra_pmc_cpu_on_timeout(int cpu)
+{
+	ERROR("%s: CPU%d power ungate timed out\n", __func__, cpu);
+	panic();
+}
+
 /*******************************************************************************
  * Power ungate CPU to start the boot process. CPU reset vectors must be
  * populated before calling this function.
@@ -60,11 +74,11 @@ void tegra_pmc_cpu_on(int cpu)
 
 	/*
 	 * The PMC deasserts the START bit when it starts the power
-	 * ungate process. Loop till no power toggle is in progress.
+	 * ungate process. Wait till no power toggle is in progress.
 	 */
-	do {
-		val = tegra_pmc_read_32(PMC_PWRGATE_TOGGLE);
-	} while (val & PMC_TOGGLE_START);
+	if (wait_for_condition(TEGRA_PMC_BASE + PMC_PWRGATE_TOGGLE,
+			       PMC_TOGGLE_START, 0, PMC_PWRGATE_TIMEOUT_US))
+		tegra_pmc_cpu_on_timeout(cpu);
 
 	/*
 	 * Start the power ungate procedure
@@ -74,16 +88,17 @@ void tegra_pmc_cpu_on(int cpu)
 
 	/*
 	 * The PMC deasserts the START bit when it starts the power
-	 * ungate process. Loop till powergate START bit is asserted.
+	 * ungate process. Wait till powergate START bit is deasserted.
 	 */
-	do {
-		val = tegra_pmc_read_32(PMC_PWRGATE_TOGGLE);
-	} while (val & (1 << 8));
-
-	/* loop till the CPU is power ungated */
-	do {
-		val = tegra_pmc_read_32(PMC_PWRGATE_STATUS);
-	} while ((val & (1 << pmc_cpu_powergate_id[cpu])) == 0);
+	if (wait_for_condition(TEGRA_PMC_BASE + PMC_PWRGATE_TOGGLE,
+			       PMC_TOGGLE_START, 0, PMC_PWRGATE_TIMEOUT_US))
+		tegra_pmc_cpu_on_timeout(cpu);
+
+	/* wait till the CPU is power ungated */
+	val = 1 << pmc_cpu_powergate_id[cpu];
+	if (wait_for_condition(TEGRA_PMC_BASE + PMC_PWRGATE_STATUS, val, val,
+			       PMC_PWRGATE_TIMEOUT_US))
+		tegra_pmc_cpu_on_timeout(cpu);
 }
 
 /*******************************************************************************
@@ -37,6 +37,7 @@
 #include <cortex_a57.h>
 #include <cortex_a53.h>
 #include <debug.h>
+#include <delay_timer.h>
 #include <errno.h>
 #include <memctrl.h>
 #include <mmio.h>
@@ -161,7 +162,7 @@ void bl31_platform_setup(void)
 	/*
 	 * Initialize delay timer
 	 */
-	tegra_delay_timer_init();
+	generic_delay_timer_init();
 
 	/*
 	 * Setup secondary CPU POR infrastructure.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -145,6 +145,17 @@ void tegra_gic_setup(void)
 	tegra_gic_distif_setup(TEGRA_GICD_BASE);
 }
 
+/*******************************************************************************
+ * Setup the GIC state private to the current cpu i.e. the cpu interface and the
+ * banked distributor registers. This is all that is lost when a cpu or cluster
+ * is powered down, the rest of the distributor is only lost with the SoC.
+ ******************************************************************************/
+void tegra_gic_pcpu_setup(void)
+{
+	tegra_gic_cpuif_setup(TEGRA_GICC_BASE);
+	tegra_gic_pcpu_distif_setup(TEGRA_GICD_BASE);
+}
+
 /*******************************************************************************
  * An ARM processor signals interrupt exceptions through the IRQ and FIQ pins.
  * The interrupt controller knows which pin/line it uses to signal a type of
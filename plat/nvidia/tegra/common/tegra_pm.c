@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -50,12 +50,23 @@ extern uint64_t tegra_sec_entry_point;
  * The following platform setup functions are weakly defined. They
  * provide typical implementations that will be overridden by a SoC.
  */
+#pragma weak tegra_soc_cpu_standby
 #pragma weak tegra_soc_pwr_domain_suspend
 #pragma weak tegra_soc_pwr_domain_on
 #pragma weak tegra_soc_pwr_domain_off
 #pragma weak tegra_soc_pwr_domain_on_finish
 #pragma weak tegra_soc_prepare_system_reset
 
+void tegra_soc_cpu_standby(plat_local_state_t cpu_state)
+{
+	/*
+	 * Enter standby state
+	 * dsb is good practice before using wfi to enter low power states
+	 */
+	dsb();
+	wfi();
+}
+
 int tegra_soc_pwr_domain_suspend(const psci_power_state_t *target_state)
 {
 	return PSCI_E_NOT_SUPPORTED;
@@ -102,12 +113,7 @@ void tegra_get_sys_suspend_power_state(psci_power_state_t *req_state)
  ******************************************************************************/
 void tegra_cpu_standby(plat_local_state_t cpu_state)
 {
-	/*
-	 * Enter standby state
-	 * dsb is good practice before using wfi to enter low power states
-	 */
-	dsb();
-	wfi();
+	tegra_soc_cpu_standby(cpu_state);
 }
 
 /*******************************************************************************
@@ -149,17 +155,17 @@ void tegra_pwr_domain_on_finish(const psci_power_state_t *target_state)
 {
 	plat_params_from_bl2_t *plat_params;
 
-	/*
-	 * Initialize the GIC cpu and distributor interfaces
-	 */
-	tegra_gic_setup();
-
 	/*
 	 * Check if we are exiting from deep sleep.
 	 */
 	if (target_state->pwr_domain_state[PLAT_MAX_PWR_LVL] ==
 			PSTATE_ID_SOC_POWERDN) {
 
+		/*
+		 * Initialize the GIC cpu and distributor interfaces
+		 */
+		tegra_gic_setup();
+
 		/*
 		 * Lock scratch registers which hold the CPU vectors.
 		 */
@@ -176,6 +182,13 @@ void tegra_pwr_domain_on_finish(const psci_power_state_t *target_state)
 		plat_params = bl31_get_plat_params();
 		tegra_memctrl_tzdram_setup(tegra_bl31_phys_base,
 			plat_params->tzdram_size);
+	} else {
+
+		/*
+		 * Only the GIC state private to this cpu has been lost, the
+		 * distributor is still configured.
+		 */
+		tegra_gic_pcpu_setup();
 	}
 
 	/*
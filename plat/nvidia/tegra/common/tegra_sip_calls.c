@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -30,14 +30,17 @@
 
 #include <arch.h>
 #include <arch_helpers.h>
-#include <assert.h>
 #include <bl_common.h>
 #include <context_mgmt.h>
 #include <debug.h>
 #include <errno.h>
 #include <memctrl.h>
+#include <mmio.h>
 #include <runtime_svc.h>
+#include <sip_svc.h>
+#include <spinlock.h>
 #include <tegra_private.h>
+#include <xlat_tables.h>
 
 #define NS_SWITCH_AARCH32	1
 #define SCR_RW_BITPOS		__builtin_ctz(SCR_RW_BIT)
@@ -47,6 +50,44 @@
  ******************************************************************************/
 #define TEGRA_SIP_NEW_VIDEOMEM_REGION		0x82000003
 #define TEGRA_SIP_AARCH_SWITCH			0x82000004
+#define TEGRA_SIP_REG_BULK_ACCESS		0x82000005
+
+/* Tegra SiP Service Calls version numbers */
+#define TEGRA_SIP_SVC_VERSION_MAJOR		0x0
+#define TEGRA_SIP_SVC_VERSION_MINOR		0x1
+
+/*******************************************************************************
+ * TEGRA_SIP_REG_BULK_ACCESS takes the physical address of a Non-secure buffer
+ * holding an array of the following operations in x1, and their number in x2.
+ * A mask of 0 reads the register into 'value', any other mask updates the
+ * bits it selects with those of 'value'. The operations are run in order and
+ * the call stops at the first operation on a register which the SoC does not
+ * allow, returning -EPERM with the number of operations done in x1.
+ ******************************************************************************/
+typedef struct tegra_reg_op {
+	uint64_t addr;
+	uint32_t value;
+	uint32_t mask;
+} tegra_reg_op_t;
+
+#define TEGRA_REG_BULK_MAX_OPS		64
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+#pragma weak tegra_soc_bulk_reg_allowed
+
+/*
+ * Returns 1 if the normal world may access the secure register at 'addr'
+ * through TEGRA_SIP_REG_BULK_ACCESS. SoCs override this with their allow-list,
+ * no register is accessible by default.
+ */
+int tegra_soc_bulk_reg_allowed(uint64_t addr)
+{
+	return 0;
+}
+
+/* Serialises the SiP calls which map memory at runtime */
+static spinlock_t tegra_sip_map_lock;
+#endif
 
 /*******************************************************************************
  * SPSR settings for AARCH32/AARCH64 modes
@@ -55,94 +96,214 @@
 			DAIF_FIQ_BIT | DAIF_IRQ_BIT | DAIF_ABT_BIT)
 #define SPSR64		SPSR_64(MODE_EL2, MODE_SP_ELX, DISABLE_ALL_EXCEPTIONS)
 
+#if PLAT_XLAT_TABLES_DYNAMIC
 /*******************************************************************************
- * This function is responsible for handling all SiP calls from the NS world
+ * Handler of TEGRA_SIP_REG_BULK_ACCESS. Each operation is copied out of the
+ * Non-secure buffer before being checked, so that the normal world cannot
+ * change it between the check and the access.
  ******************************************************************************/
-uint64_t tegra_sip_handler(uint32_t smc_fid,
-			   uint64_t x1,
-			   uint64_t x2,
-			   uint64_t x3,
-			   uint64_t x4,
-			   void *cookie,
-			   void *handle,
-			   uint64_t flags)
+static int tegra_sip_reg_bulk_access(uint64_t buf_pa, uint64_t num_ops,
+				     uint64_t *num_done)
 {
-	uint32_t ns;
+	volatile tegra_reg_op_t *ops;
+	tegra_reg_op_t op;
+	uint64_t map_base, map_size, i;
+	uint32_t val;
 	int err;
 
-	/* Determine which security state this SMC originated from */
-	ns = is_caller_non_secure(flags);
-	if (!ns)
-		SMC_RET1(handle, SMC_UNK);
-
-	switch (smc_fid) {
-
-	case TEGRA_SIP_NEW_VIDEOMEM_REGION:
-
-		/* clean up the high bits */
-		x1 = (uint32_t)x1;
-		x2 = (uint32_t)x2;
-
-		/*
-		 * Check if Video Memory overlaps TZDRAM (contains bl31/bl32)
-		 * or falls outside of the valid DRAM range
-		 */
-		err = bl31_check_ns_address(x1, x2);
-		if (err)
-			SMC_RET1(handle, err);
-
-		/*
-		 * Check if Video Memory is aligned to 1MB.
-		 */
-		if ((x1 & 0xFFFFF) || (x2 & 0xFFFFF)) {
-			ERROR("Unaligned Video Memory base address!\n");
-			SMC_RET1(handle, -ENOTSUP);
-		}
+	*num_done = 0;
+
+	if ((num_ops == 0) || (num_ops > TEGRA_REG_BULK_MAX_OPS) ||
+	    (buf_pa & (sizeof(uint64_t) - 1)))
+		return -EINVAL;
 
-		/* new video memory carveout settings */
-		tegra_memctrl_videomem_setup(x1, x2);
+	err = bl31_check_ns_address(buf_pa, num_ops * sizeof(op));
+	if (err)
+		return err;
 
-		SMC_RET1(handle, 0);
-		break;
+	map_base = buf_pa & ~(uint64_t)PAGE_SIZE_MASK;
+	map_size = (buf_pa + num_ops * sizeof(op) - map_base + PAGE_SIZE_MASK) &
+		   ~(uint64_t)PAGE_SIZE_MASK;
 
-	case TEGRA_SIP_AARCH_SWITCH:
+	spin_lock(&tegra_sip_map_lock);
 
-		/* clean up the high bits */
-		x1 = (uint32_t)x1;
-		x2 = (uint32_t)x2;
+	err = mmap_add_dynamic_region(map_base, map_base, map_size,
+				      MT_MEMORY | MT_RW | MT_NS);
+	if (err) {
+		spin_unlock(&tegra_sip_map_lock);
+		return err;
+	}
+
+	ops = (volatile tegra_reg_op_t *)buf_pa;
+	for (i = 0; i < num_ops; i++) {
+		op.addr = ops[i].addr;
+		op.value = ops[i].value;
+		op.mask = ops[i].mask;
+
+		if ((op.addr & (sizeof(uint32_t) - 1)) ||
+		    !tegra_soc_bulk_reg_allowed(op.addr)) {
+			err = -EPERM;
+			break;
+		}
 
-		if (!x1 || x2 > NS_SWITCH_AARCH32) {
-			ERROR("%s: invalid parameters\n", __func__);
-			SMC_RET1(handle, SMC_UNK);
+		if (op.mask == 0) {
+			ops[i].value = mmio_read_32(op.addr);
+		} else if (op.mask == ~0U) {
+			mmio_write_32(op.addr, op.value);
+		} else {
+			val = mmio_read_32(op.addr);
+			val = (val & ~op.mask) | (op.value & op.mask);
+			mmio_write_32(op.addr, val);
 		}
+	}
+	*num_done = i;
+
+	if (mmap_remove_dynamic_region(map_base, map_size) != 0) {
+		ERROR("Failed to unmap the register access buffer\n");
+		panic();
+	}
+
+	spin_unlock(&tegra_sip_map_lock);
+
+	return err;
+}
+#endif
+
+/*******************************************************************************
+ * Checks the arguments of TEGRA_SIP_NEW_VIDEOMEM_REGION: the Video Memory must
+ * not overlap TZDRAM (which contains bl31/bl32) nor fall outside of the valid
+ * DRAM range, and must be aligned to 1MB.
+ ******************************************************************************/
+static uint64_t tegra_sip_videomem_check(uint64_t x1,
+					 uint64_t x2,
+					 uint64_t x3,
+					 uint64_t x4)
+{
+	int err;
+
+	/* clean up the high bits */
+	x1 = (uint32_t)x1;
+	x2 = (uint32_t)x2;
+
+	err = bl31_check_ns_address(x1, x2);
+	if (err)
+		return err;
+
+	if ((x1 & 0xFFFFF) || (x2 & 0xFFFFF)) {
+		ERROR("Unaligned Video Memory base address!\n");
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
 
-		/* x1 = ns entry point */
-		cm_set_elr_spsr_el3(NON_SECURE, x1,
-			(x2 == NS_SWITCH_AARCH32) ? SPSR32 : SPSR64);
+static uint64_t tegra_sip_new_videomem_region(uint32_t smc_fid,
+					      uint64_t x1,
+					      uint64_t x2,
+					      uint64_t x3,
+					      uint64_t x4,
+					      void *cookie,
+					      void *handle,
+					      uint64_t flags)
+{
+	int err;
 
-		/* switch NS world mode */
-		cm_write_scr_el3_bit(NON_SECURE, SCR_RW_BITPOS, !x2);
+	/*
+	 * new video memory carveout settings, x3 holds the token
+	 * returned with -EAGAIN to continue a pending request
+	 */
+#if PLAT_XLAT_TABLES_DYNAMIC
+	spin_lock(&tegra_sip_map_lock);
+#endif
+	err = tegra_memctrl_videomem_setup((uint32_t)x1, (uint32_t)x2, &x3);
+#if PLAT_XLAT_TABLES_DYNAMIC
+	spin_unlock(&tegra_sip_map_lock);
+#endif
+	if (err == -EAGAIN)
+		SMC_RET2(handle, err, x3);
 
-		INFO("CPU switched to AARCH%s mode\n",
-			(x2 == NS_SWITCH_AARCH32) ? "32" : "64");
-		SMC_RET1(handle, 0);
-		break;
+	SMC_RET1(handle, err);
+}
 
-	default:
-		ERROR("%s: unhandled SMC (0x%x)\n", __func__, smc_fid);
-		break;
+/*******************************************************************************
+ * Checks the arguments of TEGRA_SIP_AARCH_SWITCH: x1 holds the NS entry point
+ * and x2 the requested execution state.
+ ******************************************************************************/
+static uint64_t tegra_sip_aarch_switch_check(uint64_t x1,
+					     uint64_t x2,
+					     uint64_t x3,
+					     uint64_t x4)
+{
+	if (!(uint32_t)x1 || (uint32_t)x2 > NS_SWITCH_AARCH32) {
+		ERROR("%s: invalid parameters\n", __func__);
+		return SMC_UNK;
 	}
 
-	SMC_RET1(handle, SMC_UNK);
+	return 0;
+}
+
+static uint64_t tegra_sip_aarch_switch(uint32_t smc_fid,
+				       uint64_t x1,
+				       uint64_t x2,
+				       uint64_t x3,
+				       uint64_t x4,
+				       void *cookie,
+				       void *handle,
+				       uint64_t flags)
+{
+	/* clean up the high bits */
+	x1 = (uint32_t)x1;
+	x2 = (uint32_t)x2;
+
+	/* x1 = ns entry point */
+	cm_set_elr_spsr_el3(NON_SECURE, x1,
+		(x2 == NS_SWITCH_AARCH32) ? SPSR32 : SPSR64);
+
+	/* switch NS world mode */
+	cm_write_scr_el3_bit(NON_SECURE, SCR_RW_BITPOS, !x2);
+
+	INFO("CPU switched to AARCH%s mode\n",
+		(x2 == NS_SWITCH_AARCH32) ? "32" : "64");
+	SMC_RET1(handle, 0);
+}
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+static uint64_t tegra_sip_reg_bulk(uint32_t smc_fid,
+				   uint64_t x1,
+				   uint64_t x2,
+				   uint64_t x3,
+				   uint64_t x4,
+				   void *cookie,
+				   void *handle,
+				   uint64_t flags)
+{
+	int err;
+
+	err = tegra_sip_reg_bulk_access(x1, x2, &x3);
+	SMC_RET2(handle, err, x3);
 }
+#endif
+
+/*******************************************************************************
+ * Tegra SiP calls, sorted by function ID. They are only available to the NS
+ * world.
+ ******************************************************************************/
+static const sip_call_t tegra_sip_calls[] = {
+	{ TEGRA_SIP_NEW_VIDEOMEM_REGION, SIP_CALL_NS_ONLY,
+	  tegra_sip_videomem_check, tegra_sip_new_videomem_region },
+	{ TEGRA_SIP_AARCH_SWITCH, SIP_CALL_NS_ONLY,
+	  tegra_sip_aarch_switch_check, tegra_sip_aarch_switch },
+#if PLAT_XLAT_TABLES_DYNAMIC
+	{ TEGRA_SIP_REG_BULK_ACCESS, SIP_CALL_NS_ONLY,
+	  NULL, tegra_sip_reg_bulk },
+#endif
+};
 
 /* Define a runtime service descriptor for fast SMC calls */
-DECLARE_RT_SVC(
+DECLARE_SIP_SVC(
 	tegra_sip_fast,
-
-	OEN_SIP_START,
-	OEN_SIP_END,
-	SMC_TYPE_FAST,
+	tegra_sip_calls,
 	NULL,
-	tegra_sip_handler
+	TEGRA_SIP_SVC_VERSION_MAJOR,
+	TEGRA_SIP_SVC_VERSION_MINOR
 );
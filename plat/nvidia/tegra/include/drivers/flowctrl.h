@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -53,6 +53,7 @@
 #define FLOWCTRL_HALT_CPU1_EVENTS	0x14
 #define FLOWCTRL_CPU1_CSR		0x18
 #define FLOWCTRL_CC4_CORE0_CTRL		0x6c
+#define  FLOWCTRL_CC4_ENABLE		(1 << 0)
 #define FLOWCTRL_WAIT_WFI_BITMAP	0x100
 #define FLOWCTRL_L2_FLUSH_CONTROL	0x94
 #define FLOWCTRL_BPMP_CLUSTER_CONTROL	0x98
@@ -73,6 +74,7 @@ static inline void tegra_fc_write_32(uint32_t off, uint32_t val)
 	mmio_write_32(TEGRA_FLOWCTRL_BASE + off, val);
 }
 
+void tegra_fc_cc4_ctrl(int cpu_id, uint32_t val);
 void tegra_fc_cluster_idle(uint32_t midr);
 void tegra_fc_cpu_powerdn(uint32_t mpidr);
 void tegra_fc_cluster_powerdn(uint32_t midr);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -84,8 +84,17 @@
  * Platform specific page table and MMU setup constants
  ******************************************************************************/
 #define ADDR_SPACE_SIZE			(1ull << 32)
+#if PLAT_XLAT_TABLES_DYNAMIC
+/*
+ * Two more tables and a region to map a block of the video memory or the
+ * buffer of a SiP call, which are never mapped at the same time
+ */
+#define MAX_XLAT_TABLES			5
+#define MAX_MMAP_REGIONS		9
+#else
 #define MAX_XLAT_TABLES			3
 #define MAX_MMAP_REGIONS		8
+#endif
 
 /*******************************************************************************
  * Some data must be aligned on the biggest cache line size in the platform.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -60,6 +60,7 @@ int plat_lock_cpu_vectors(void);
 
 /* Declarations for tegra_gic.c */
 void tegra_gic_setup(void);
+void tegra_gic_pcpu_setup(void);
 void tegra_gic_cpuif_deactivate(void);
 
 /* Declarations for tegra_security.c */
@@ -79,7 +80,4 @@ int tegra_prepare_cpu_on_finish(unsigned long mpidr);
 plat_params_from_bl2_t *bl31_get_plat_params(void);
 int bl31_check_ns_address(uint64_t base, uint64_t size_in_bytes);
 
-/* Declarations for tegra_delay_timer.c */
-void tegra_delay_timer_init(void);
-
 #endif /* __TEGRA_PRIVATE_H__ */
@@ -36,6 +36,7 @@
 #include <delay_timer.h>
 #include <flowctrl.h>
 #include <mmio.h>
+#include <platform.h>
 #include <platform_def.h>
 #include <pmc.h>
 #include <psci.h>
@@ -75,7 +76,11 @@ int32_t tegra_soc_validate_power_state(unsigned int power_state,
 		if (pwr_lvl != MPIDR_AFFLVL0)
 			return PSCI_E_INVALID_PARAMS;
 
-		/* power domain in standby state */
+		/*
+		 * power domain in standby state. The core keeps its state,
+		 * so the DCO is neither quiesced on entry nor enabled again
+		 * on exit.
+		 */
 		req_state->pwr_domain_state[pwr_lvl] = PLAT_MAX_RET_STATE;
 
 		return PSCI_E_SUCCESS;
@@ -134,6 +139,21 @@ int tegra_soc_pwr_domain_off(const psci_power_state_t *target_state)
 	return PSCI_E_SUCCESS;
 }
 
+#if DENVER_DCO_STATS
+int tegra_soc_pwr_domain_on_finish(const psci_power_state_t *target_state)
+{
+	unsigned int cpu = plat_my_core_pos();
+
+	VERBOSE("CPU%u: DCO quiesce %llu ticks, enable %llu ticks\n", cpu,
+		(unsigned long long)denver_get_dco_ticks(cpu,
+					DENVER_DCO_STATS_QUIESCE),
+		(unsigned long long)denver_get_dco_ticks(cpu,
+					DENVER_DCO_STATS_ENABLE));
+
+	return PSCI_E_SUCCESS;
+}
+#endif
+
 int tegra_soc_pwr_domain_suspend(const psci_power_state_t *target_state)
 {
 #if DEBUG
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -135,6 +135,21 @@ error:
 	return PSCI_E_INVALID_PARAMS;
 }
 
+void tegra_soc_cpu_standby(plat_local_state_t cpu_state)
+{
+	int cpu = read_mpidr() & MPIDR_CPU_MASK;
+
+	/*
+	 * Let the flow controller clock gate the CPU (CC4) while it waits
+	 * for an interrupt, and disable CC4 again on wake up so that it
+	 * does not affect the power down paths.
+	 */
+	tegra_fc_cc4_ctrl(cpu, FLOWCTRL_CC4_ENABLE);
+	dsb();
+	wfi();
+	tegra_fc_cc4_ctrl(cpu, 0);
+}
+
 int tegra_soc_pwr_domain_suspend(const psci_power_state_t *target_state)
 {
 	u_register_t mpidr = read_mpidr();
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cpu_data.h>
+#include <debug.h>
+#include <errno.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <sip_svc.h>
+
+#if SIP_SVC_STATS
+/*
+ * Maximum number of SiP calls of a platform whose invocations are counted. A
+ * platform may raise it by defining PLAT_SIP_SVC_MAX_CALLS in its
+ * platform_def.h.
+ */
+#ifdef PLAT_SIP_SVC_MAX_CALLS
+#define SIP_SVC_MAX_CALLS	PLAT_SIP_SVC_MAX_CALLS
+#else
+#define SIP_SVC_MAX_CALLS	32
+#endif
+
+/*
+ * Per-cpu invocation counters, indexed by the position of the call in the
+ * array of the platform. Each CPU only increments its own counters.
+ */
+typedef struct sip_svc_stats {
+	uint64_t count[SIP_SVC_MAX_CALLS];
+} sip_svc_stats_t;
+
+static DEFINE_PERCPU(sip_svc_stats_t, sip_svc_stats);
+#endif
+
+/*******************************************************************************
+ * This function checks the array of SiP calls of the platform when the runtime
+ * services are initialised. The function IDs must be fast SiP SMCs outside of
+ * the range reserved for the general queries, in strictly ascending order.
+ ******************************************************************************/
+int32_t sip_svc_setup(const sip_svc_desc_t *svc)
+{
+	const sip_call_t *call;
+	unsigned int i;
+
+#if SIP_SVC_STATS
+	if (svc->num_calls > SIP_SVC_MAX_CALLS) {
+		ERROR("Too many SiP calls to count (%u)\n", svc->num_calls);
+		return -EINVAL;
+	}
+#endif
+
+	for (i = 0; i < svc->num_calls; i++) {
+		call = &svc->calls[i];
+
+		if ((call->handle == NULL) ||
+		    (GET_SMC_TYPE(call->smc_fid) != SMC_TYPE_FAST) ||
+		    (((call->smc_fid >> FUNCID_OEN_SHIFT) & FUNCID_OEN_MASK) !=
+		     OEN_SIP_START) ||
+		    ((call->smc_fid & FUNCID_NUM_MASK) >=
+		     SIP_SVC_FNUM_RESERVED) ||
+		    ((i > 0) && (call->smc_fid <= svc->calls[i - 1].smc_fid))) {
+			ERROR("Invalid SiP call 0x%x\n", call->smc_fid);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*******************************************************************************
+ * This function returns the SiP call with the function ID 'smc_fid', or NULL if
+ * the platform does not implement it. The array is sorted, so it is searched
+ * by bisection.
+ ******************************************************************************/
+static const sip_call_t *sip_svc_find(const sip_svc_desc_t *svc,
+				      uint32_t smc_fid)
+{
+	unsigned int lo = 0, hi = svc->num_calls, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (svc->calls[mid].smc_fid < smc_fid)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if ((lo < svc->num_calls) && (svc->calls[lo].smc_fid == smc_fid))
+		return &svc->calls[lo];
+
+	return NULL;
+}
+
+#if SIP_SVC_STATS
+/*******************************************************************************
+ * This function returns the number of times the SiP call 'call' has been
+ * invoked on all the CPUs. The counters of the other CPUs may be incremented
+ * concurrently, so the sum is only a snapshot.
+ ******************************************************************************/
+static uint64_t sip_svc_call_count(const sip_svc_desc_t *svc,
+				   const sip_call_t *call)
+{
+	unsigned int idx = call - svc->calls, cpu;
+	uint64_t count = 0;
+
+	for (cpu = 0; cpu < PLATFORM_CORE_COUNT; cpu++)
+		count += percpu_ptr_by_index(cpu, sip_svc_stats)->count[idx];
+
+	return count;
+}
+#endif
+
+/*******************************************************************************
+ * This function is the handler of the SiP runtime service of the platform. It
+ * answers the general queries of the service, and dispatches the other SMCs to
+ * the handler of their call once its checks have passed.
+ ******************************************************************************/
+uint64_t sip_svc_dispatch(const sip_svc_desc_t *svc,
+			  uint32_t smc_fid,
+			  uint64_t x1,
+			  uint64_t x2,
+			  uint64_t x3,
+			  uint64_t x4,
+			  void *cookie,
+			  void *handle,
+			  uint64_t flags)
+{
+	const sip_call_t *call;
+	uint64_t rc;
+
+	call = sip_svc_find(svc, smc_fid);
+	if (call == NULL) {
+		switch (smc_fid) {
+		case SIP_SVC_CALL_COUNT:
+			SMC_RET1(handle, svc->num_calls);
+
+		case SIP_SVC_UID:
+			if (svc->uuid == NULL)
+				break;
+
+			SMC_UUID_RET(handle, *svc->uuid);
+
+		case SIP_SVC_VERSION:
+			SMC_RET2(handle, svc->version_major,
+				 svc->version_minor);
+
+#if SIP_SVC_STATS
+		case SIP_SVC_CALL_STATS:
+			call = sip_svc_find(svc, x1);
+			if (call == NULL)
+				SMC_RET1(handle, SMC_UNK);
+
+			SMC_RET2(handle, 0, sip_svc_call_count(svc, call));
+#endif
+
+		default:
+			break;
+		}
+
+		WARN("Unimplemented SiP Service Call: 0x%x\n", smc_fid);
+		SMC_RET1(handle, SMC_UNK);
+	}
+
+	if ((call->flags & SIP_CALL_NS_ONLY) && is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	if (call->check) {
+		rc = call->check(x1, x2, x3, x4);
+		if (rc)
+			SMC_RET1(handle, rc);
+	}
+
+#if SIP_SVC_STATS
+	this_cpu_ptr(sip_svc_stats)->count[call - svc->calls]++;
+#endif
+
+	return call->handle(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
+}
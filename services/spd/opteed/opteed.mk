@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
 #
 # Redistribution and use in source and binary forms, with or without
 # modification, are permitted provided that the following conditions are met:
@@ -37,3 +37,21 @@ SPD_SOURCES		:=	services/spd/opteed/opteed_common.c	\
 				services/spd/opteed/opteed_pm.c
 
 NEED_BL32		:=	yes
+
+# Let the normal world post requests into a per-cpu ring drained by OP-TEE
+OPTEED_REQ_RING		:=	0
+
+$(eval $(call assert_boolean,OPTEED_REQ_RING))
+$(eval $(call add_define,OPTEED_REQ_RING))
+
+# Handle OP-TEE as a UP Trusted OS the normal world can migrate between cpus
+OPTEED_UP_MIGRATE	:=	0
+
+$(eval $(call assert_boolean,OPTEED_UP_MIGRATE))
+$(eval $(call add_define,OPTEED_UP_MIGRATE))
+
+# Maximum time in microseconds that OP-TEE may run a standard call for before
+# the normal world regains control. 0 lets OP-TEE run it to completion.
+OPTEED_STD_BUDGET_US	:=	0
+
+$(eval $(call add_define,OPTEED_STD_BUDGET_US))
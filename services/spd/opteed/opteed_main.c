@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -47,7 +47,9 @@
 #include <errno.h>
 #include <platform.h>
 #include <runtime_svc.h>
+#include <spd_trace.h>
 #include <stddef.h>
+#include <string.h>
 #include <uuid.h>
 #include "opteed_private.h"
 #include "teesmc_opteed_macros.h"
@@ -60,15 +62,150 @@
 optee_vectors_t *optee_vectors;
 
 /*******************************************************************************
- * Array to keep track of per-cpu OPTEE state
+ * Per-cpu variable to keep track of the OPTEE state
  ******************************************************************************/
-optee_context_t opteed_sp_context[OPTEED_CORE_COUNT];
+DEFINE_PERCPU(optee_context_t, opteed_sp_context);
 uint32_t opteed_rw;
 
+/*******************************************************************************
+ * Lowest power level of the suspends OPTEE is notified of, as set by OPTEE
+ * with TEESMC_OPTEED_PM_NOTIFY. All the power downs are notified by default.
+ ******************************************************************************/
+uint32_t opteed_pm_notify_lvl;
+
+#if OPTEED_UP_MIGRATE
+/*******************************************************************************
+ * MPIDR of the cpu a UP migratable OPTEE is resident on. It is the primary
+ * cpu until the normal world migrates OPTEE with PSCI MIGRATE.
+ ******************************************************************************/
+volatile uint64_t opteed_resident_mpidr;
+#endif
+
 
 
 static int32_t opteed_init(void);
 
+#if OPTEED_REQ_RING
+/*******************************************************************************
+ * Handle the normal world calls managing the request ring of this cpu. The
+ * TEESMC_OPTEED_RING_KICK call is only handled here when OPTEE is already
+ * draining the ring. Otherwise 0 is returned and the call is passed on to
+ * OPTEE with the ring details in x1 and x2.
+ ******************************************************************************/
+static uint64_t opteed_ring_smc(uint32_t smc_fid, uint64_t x1, uint64_t x2,
+				optee_context_t *optee_ctx, void *handle)
+{
+	if (smc_fid == TEESMC_OPTEED_RING_REGISTER) {
+		if (optee_ctx->ring_state & OPTEE_RING_DRAINING)
+			SMC_RET1(handle, TEESMC_OPTEED_RING_E_BUSY);
+
+		if ((x1 != 0) && (((x1 & 0x7) != 0) || (x2 == 0) ||
+				  (x2 > UINT32_MAX)))
+			SMC_RET1(handle, TEESMC_OPTEED_RING_E_INVALID);
+
+		optee_ctx->ring_base = x1;
+		optee_ctx->ring_size = x1 ? x2 : 0;
+		SMC_RET1(handle, 0);
+	}
+
+	if (optee_ctx->ring_base == 0)
+		SMC_RET1(handle, TEESMC_OPTEED_RING_E_INVALID);
+
+	/*
+	 * OPTEE has been preempted while draining the ring. Make it look at
+	 * the ring again before it reports the drain as complete.
+	 */
+	if (optee_ctx->ring_state & OPTEE_RING_DRAINING) {
+		optee_ctx->ring_state |= OPTEE_RING_KICKED;
+		SMC_RET2(handle, 0, 0);
+	}
+
+	optee_ctx->ring_state = OPTEE_RING_DRAINING;
+	optee_ctx->ring_done = 0;
+
+	return 0;
+}
+#endif
+
+#if OPTEED_STD_BUDGET_US
+/*******************************************************************************
+ * Arm the budget of the standard call OPTEE is entered for on this cpu. The
+ * secure physical timer fires once it is exhausted, and S-EL1 interrupts
+ * taken in the secure state are routed to EL3 so that the OPTEED sees it.
+ ******************************************************************************/
+static void opteed_budget_arm(void)
+{
+	write_cntps_tval_el1(((uint64_t)read_cntfrq_el0() *
+			      OPTEED_STD_BUDGET_US) / 1000000);
+	write_cntps_ctl_el1(1 << CNTP_CTL_ENABLE_SHIFT);
+	enable_intr_rm_local(INTR_TYPE_S_EL1, SECURE);
+}
+
+static void opteed_budget_disarm(void)
+{
+	write_cntps_ctl_el1(0);
+	disable_intr_rm_local(INTR_TYPE_S_EL1, SECURE);
+}
+
+/*******************************************************************************
+ * Handle a S-EL1 interrupt taken while OPTEE was running a standard call. If
+ * the budget of the call is exhausted, OPTEE is preempted and the normal world
+ * gets a token to resume the call with. Otherwise the interrupt is one of
+ * OPTEE's, which it handles itself once it is returned to. The budget is then
+ * lost for the rest of the call, as the interrupt can no longer be routed to
+ * EL3.
+ ******************************************************************************/
+static uint64_t opteed_budget_interrupt(optee_context_t *optee_ctx,
+					void *handle)
+{
+	cpu_context_t *ns_cpu_context;
+	uint32_t ctl = read_cntps_ctl_el1();
+
+	assert(handle == cm_get_context(SECURE));
+
+	opteed_budget_disarm();
+
+	if (!get_cntp_ctl_enable(ctl) || !get_cntp_ctl_istatus(ctl))
+		SMC_RET0(handle);
+
+	set_std_preempted_flag(optee_ctx->state);
+	optee_ctx->preempt_token++;
+
+	/* Get a reference to the non-secure context */
+	ns_cpu_context = cm_get_context(NON_SECURE);
+	assert(ns_cpu_context);
+
+	/* Switch from the secure to the non-secure state */
+	cm_el1_sysregs_context_switch(SECURE);
+
+	spd_trace_exit();
+	SMC_RET2(ns_cpu_context, TEESMC_OPTEED_STD_PREEMPTED,
+		 optee_ctx->preempt_token);
+}
+
+/*******************************************************************************
+ * Handle a call from the normal world while a standard call preempted by the
+ * OPTEED is waiting to be resumed on this cpu. Only the resumption of the call
+ * is accepted, which gets a new budget.
+ ******************************************************************************/
+static uint64_t opteed_budget_resume(uint32_t smc_fid, uint64_t x1,
+				     optee_context_t *optee_ctx, void *handle)
+{
+	if ((smc_fid != TEESMC_OPTEED_STD_RESUME) ||
+	    (x1 != optee_ctx->preempt_token))
+		SMC_RET1(handle, SMC_UNK);
+
+	clr_std_preempted_flag(optee_ctx->state);
+
+	/* Switch from the non-secure state and resume OPTEE */
+	cm_el1_sysregs_context_switch(NON_SECURE);
+	opteed_budget_arm();
+
+	spd_trace_enter(SPD_TRACE_STD_RESUME, smc_fid);
+	SMC_RET0(&optee_ctx->cpu_ctx);
+}
+#endif
+
 /*******************************************************************************
  * This function is the handler registered for S-EL1 interrupts by the
  * OPTEED. It validates the interrupt and upon success arranges entry into
@@ -79,12 +216,20 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 					    void *handle,
 					    void *cookie)
 {
-	uint32_t linear_id;
 	optee_context_t *optee_ctx;
 
+#if OPTEED_STD_BUDGET_US
+	if (get_interrupt_src_ss(flags) == SECURE)
+		return opteed_budget_interrupt(
+			this_cpu_ptr(opteed_sp_context), handle);
+#endif
+
 	/* Check the security state when the exception was generated */
 	assert(get_interrupt_src_ss(flags) == NON_SECURE);
 
+	/* The interrupts of a UP OPTEE target the cpu it resides on */
+	assert(opteed_runs_on(read_mpidr_el1()));
+
 	/* Sanity check the pointer to this cpu's context */
 	assert(handle == cm_get_context(NON_SECURE));
 
@@ -92,10 +237,25 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	cm_el1_sysregs_context_save(NON_SECURE);
 
 	/* Get a reference to this cpu's OPTEE context */
-	linear_id = plat_my_core_pos();
-	optee_ctx = &opteed_sp_context[linear_id];
+	optee_ctx = this_cpu_ptr(opteed_sp_context);
 	assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
 
+#if OPTEED_STD_BUDGET_US
+	/*
+	 * Keep the state of the preempted standard call aside while OPTEE
+	 * handles the interrupt. It is restored once OPTEE is done.
+	 */
+	if (get_std_preempted_flag(optee_ctx->state)) {
+		memcpy(&optee_ctx->preempt_gpregs,
+		       get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		       sizeof(optee_ctx->preempt_gpregs));
+		optee_ctx->preempt_elr_el3 = SMC_GET_EL3(&optee_ctx->cpu_ctx,
+							 CTX_ELR_EL3);
+		optee_ctx->preempt_spsr_el3 = SMC_GET_EL3(&optee_ctx->cpu_ctx,
+							  CTX_SPSR_EL3);
+	}
+#endif
+
 	cm_set_elr_el3(SECURE, (uint64_t)&optee_vectors->fiq_entry);
 	cm_el1_sysregs_context_restore(SECURE);
 	cm_set_next_eret_context(SECURE);
@@ -107,6 +267,7 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 	 * retrieve this address from ELR_EL3 as the secure context will
 	 * not take effect until el3_exit().
 	 */
+	spd_trace_enter(SPD_TRACE_SEL1_INTR, 0);
 	SMC_RET1(&optee_ctx->cpu_ctx, read_elr_el3());
 }
 
@@ -118,9 +279,6 @@ static uint64_t opteed_sel1_interrupt_handler(uint32_t id,
 int32_t opteed_setup(void)
 {
 	entry_point_info_t *optee_ep_info;
-	uint32_t linear_id;
-
-	linear_id = plat_my_core_pos();
 
 	/*
 	 * Get information about the Secure Payload (BL32) image. Its
@@ -149,10 +307,13 @@ int32_t opteed_setup(void)
 	 * for the time being.
 	 */
 	opteed_rw = OPTEE_AARCH32;
+#if OPTEED_UP_MIGRATE
+	opteed_resident_mpidr = read_mpidr_el1();
+#endif
 	opteed_init_optee_ep_state(optee_ep_info,
 				opteed_rw,
 				optee_ep_info->pc,
-				&opteed_sp_context[linear_id]);
+				this_cpu_ptr(opteed_sp_context));
 
 	/*
 	 * All OPTEED initialization done. Now register our init function with
@@ -174,8 +335,7 @@ int32_t opteed_setup(void)
  ******************************************************************************/
 static int32_t opteed_init(void)
 {
-	uint32_t linear_id = plat_my_core_pos();
-	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+	optee_context_t *optee_ctx = this_cpu_ptr(opteed_sp_context);
 	entry_point_info_t *optee_entry_point;
 	uint64_t rc;
 
@@ -217,8 +377,7 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 			 uint64_t flags)
 {
 	cpu_context_t *ns_cpu_context;
-	uint32_t linear_id = plat_my_core_pos();
-	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+	optee_context_t *optee_ctx = this_cpu_ptr(opteed_sp_context);
 	uint64_t rc;
 
 	/*
@@ -234,13 +393,6 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
-		cm_el1_sysregs_context_save(NON_SECURE);
-
-		/*
-		 * We are done stashing the non-secure context. Ask the
-		 * OPTEE to do the work now.
-		 */
-
 		/*
 		 * Verify if there is a valid context to use, copy the
 		 * operation type and parameters to the secure context
@@ -250,6 +402,31 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
 
+		/* A UP OPTEE can only be called on the cpu it resides on */
+		if (!opteed_runs_on(read_mpidr_el1()))
+			SMC_RET1(handle, SMC_UNK);
+
+#if OPTEED_STD_BUDGET_US
+		if (get_std_preempted_flag(optee_ctx->state) ||
+		    (smc_fid == TEESMC_OPTEED_STD_RESUME))
+			return opteed_budget_resume(smc_fid, x1, optee_ctx,
+						    handle);
+#endif
+
+#if OPTEED_REQ_RING
+		if ((smc_fid == TEESMC_OPTEED_RING_REGISTER) ||
+		    (smc_fid == TEESMC_OPTEED_RING_KICK)) {
+			rc = opteed_ring_smc(smc_fid, x1, x2, optee_ctx,
+					     handle);
+			if (rc != 0)
+				return rc;
+
+			x1 = optee_ctx->ring_base;
+			x2 = optee_ctx->ring_size;
+			x3 = 0;
+		}
+#endif
+
 		/* Set appropriate entry for SMC.
 		 * We expect OPTEE to manage the PSTATE.I and PSTATE.F
 		 * flags as appropriate.
@@ -260,10 +437,16 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		} else {
 			cm_set_elr_el3(SECURE, (uint64_t)
 					&optee_vectors->std_smc_entry);
+#if OPTEED_STD_BUDGET_US
+			opteed_budget_arm();
+#endif
 		}
 
-		cm_el1_sysregs_context_restore(SECURE);
-		cm_set_next_eret_context(SECURE);
+		/*
+		 * Switch from the non-secure state and ask OPTEE to do the
+		 * work now.
+		 */
+		cm_el1_sysregs_context_switch(NON_SECURE);
 
 		/* Propagate hypervisor client ID */
 		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
@@ -271,6 +454,9 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 			      read_ctx_reg(get_gpregs_ctx(handle),
 					   CTX_GPREG_X7));
 
+		spd_trace_enter(GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST ?
+				SPD_TRACE_FAST_SMC : SPD_TRACE_STD_SMC,
+				smc_fid);
 		SMC_RET4(&optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
 	}
 
@@ -306,11 +492,21 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 			 */
 			flags = 0;
 			set_interrupt_rm_flag(flags, NON_SECURE);
+#if OPTEED_STD_BUDGET_US
+			/*
+			 * S-EL1 interrupts taken in the secure state are only
+			 * routed to EL3 while a standard call has a budget.
+			 */
+			set_interrupt_rm_flag(flags, SECURE);
+#endif
 			rc = register_interrupt_type_handler(INTR_TYPE_S_EL1,
 						opteed_sel1_interrupt_handler,
 						flags);
 			if (rc)
 				panic();
+#if OPTEED_STD_BUDGET_US
+			disable_intr_rm_local(INTR_TYPE_S_EL1, SECURE);
+#endif
 		}
 
 		/*
@@ -366,23 +562,88 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		 * and return to the non-secure state.
 		 */
 		assert(handle == cm_get_context(SECURE));
-		cm_el1_sysregs_context_save(SECURE);
+
+#if OPTEED_STD_BUDGET_US
+		opteed_budget_disarm();
+#endif
 
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
 
-		/* Restore non-secure state */
-		cm_el1_sysregs_context_restore(NON_SECURE);
-		cm_set_next_eret_context(NON_SECURE);
+		/* Switch from the secure to the non-secure state */
+		cm_el1_sysregs_context_switch(SECURE);
 
+		spd_trace_exit();
 		SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
 
+#if OPTEED_REQ_RING
+	/*
+	 * OPTEE has found the request ring of this cpu empty.
+	 */
+	case TEESMC_OPTEED_RETURN_RING_DONE:
+		assert(handle == cm_get_context(SECURE));
+		assert(optee_ctx->ring_state & OPTEE_RING_DRAINING);
+
+		optee_ctx->ring_done += x1;
+
+		/*
+		 * Requests have been posted while OPTEE was preempted, after
+		 * it may have looked at the ring for the last time. Drain the
+		 * ring again without going through the normal world.
+		 */
+		if (optee_ctx->ring_state & OPTEE_RING_KICKED) {
+			optee_ctx->ring_state &= ~OPTEE_RING_KICKED;
+			cm_set_elr_el3(SECURE, (uint64_t)
+					&optee_vectors->std_smc_entry);
+			SMC_RET3(&optee_ctx->cpu_ctx, TEESMC_OPTEED_RING_KICK,
+				 optee_ctx->ring_base, optee_ctx->ring_size);
+		}
+
+		optee_ctx->ring_state = 0;
+#if OPTEED_STD_BUDGET_US
+		opteed_budget_disarm();
+#endif
+
+		/* Get a reference to the non-secure context */
+		ns_cpu_context = cm_get_context(NON_SECURE);
+		assert(ns_cpu_context);
+
+		/* Switch from the secure to the non-secure state */
+		cm_el1_sysregs_context_switch(SECURE);
+
+		spd_trace_exit();
+		SMC_RET2(ns_cpu_context, 0, optee_ctx->ring_done);
+#endif
+
+	/*
+	 * OPTEE selects the suspends it is notified of. This is a request
+	 * for the OPTEED, which returns to OPTEE straight away.
+	 */
+	case TEESMC_OPTEED_PM_NOTIFY:
+		if (x1 > PLAT_MAX_PWR_LVL + 1)
+			SMC_RET1(handle, TEESMC_OPTEED_PM_NOTIFY_E_INVALID);
+
+		opteed_pm_notify_lvl = x1;
+		SMC_RET1(handle, 0);
+
 	/*
 	 * OPTEE has finished handling a S-EL1 FIQ interrupt. Execution
 	 * should resume in the normal world.
 	 */
 	case TEESMC_OPTEED_RETURN_FIQ_DONE:
+#if OPTEED_STD_BUDGET_US
+		if (get_std_preempted_flag(optee_ctx->state)) {
+			memcpy(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+			       &optee_ctx->preempt_gpregs,
+			       sizeof(optee_ctx->preempt_gpregs));
+			SMC_SET_EL3(&optee_ctx->cpu_ctx, CTX_ELR_EL3,
+				    optee_ctx->preempt_elr_el3);
+			SMC_SET_EL3(&optee_ctx->cpu_ctx, CTX_SPSR_EL3,
+				    optee_ctx->preempt_spsr_el3);
+		}
+#endif
+
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
@@ -395,6 +656,7 @@ uint64_t opteed_smc_handler(uint32_t smc_fid,
 		cm_el1_sysregs_context_restore(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
 
+		spd_trace_exit();
 		SMC_RET0((uint64_t) ns_cpu_context);
 
 	default:
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -34,8 +34,19 @@
 #include <context_mgmt.h>
 #include <debug.h>
 #include <platform.h>
+#include <psci.h>
+#include <spinlock.h>
+#include <string.h>
 #include "opteed_private.h"
 
+#if OPTEED_UP_MIGRATE
+/*******************************************************************************
+ * Lock serialising the migration of OPTEE with the power state changes of the
+ * cpus it does not reside on
+ ******************************************************************************/
+static spinlock_t opteed_migrate_lock;
+#endif
+
 /*******************************************************************************
  * The target cpu is being turned on. Allow the OPTEED/OPTEE to perform any
  * actions needed. Nothing at the moment.
@@ -51,12 +62,25 @@ static void opteed_cpu_on_handler(uint64_t target_cpu)
 static int32_t opteed_cpu_off_handler(uint64_t unused)
 {
 	int32_t rc = 0;
-	uint32_t linear_id = plat_my_core_pos();
-	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+	optee_context_t *optee_ctx = this_cpu_ptr(opteed_sp_context);
 
 	assert(optee_vectors);
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
+#if OPTEED_UP_MIGRATE
+	/*
+	 * The cpu a UP OPTEE resides on cannot be turned off before OPTEE is
+	 * migrated. There is nothing to do on the other cpus.
+	 */
+	if (opteed_runs_on(read_mpidr_el1()))
+		return PSCI_E_DENIED;
+
+	spin_lock(&opteed_migrate_lock);
+	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_OFF);
+	spin_unlock(&opteed_migrate_lock);
+	return 0;
+#endif
+
 	/* Program the entry point and enter OPTEE */
 	cm_set_elr_el3(SECURE, (uint64_t) &optee_vectors->cpu_off_entry);
 	rc = opteed_synchronous_sp_entry(optee_ctx);
@@ -73,6 +97,15 @@ static int32_t opteed_cpu_off_handler(uint64_t unused)
 	 * subsequently.
 	 */
 	set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_OFF);
+#if OPTEED_REQ_RING
+	/* The normal world registers the ring again once the cpu is on */
+	optee_ctx->ring_base = 0;
+	optee_ctx->ring_size = 0;
+#endif
+#if OPTEED_STD_BUDGET_US
+	/* A standard call which has not been resumed is abandoned */
+	clr_std_preempted_flag(optee_ctx->state);
+#endif
 
 	 return 0;
 }
@@ -84,12 +117,31 @@ static int32_t opteed_cpu_off_handler(uint64_t unused)
 static void opteed_cpu_suspend_handler(uint64_t max_off_pwrlvl)
 {
 	int32_t rc = 0;
-	uint32_t linear_id = plat_my_core_pos();
-	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+	optee_context_t *optee_ctx = this_cpu_ptr(opteed_sp_context);
 
 	assert(optee_vectors);
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
+#if OPTEED_UP_MIGRATE
+	/* Only the cpu a UP OPTEE resides on enters it */
+	if (!opteed_runs_on(read_mpidr_el1())) {
+		spin_lock(&opteed_migrate_lock);
+		set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_SUSPEND);
+		spin_unlock(&opteed_migrate_lock);
+		return;
+	}
+#endif
+
+	/*
+	 * Skip the world switch for the suspends OPTEE has not asked to be
+	 * notified of. Its S-EL1 context is saved by the OPTEED anyway.
+	 */
+	if (max_off_pwrlvl < opteed_pm_notify_lvl) {
+		set_pm_silent_flag(optee_ctx->state);
+		set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_SUSPEND);
+		return;
+	}
+
 	/* Program the entry point and enter OPTEE */
 	cm_set_elr_el3(SECURE, (uint64_t) &optee_vectors->cpu_suspend_entry);
 	rc = opteed_synchronous_sp_entry(optee_ctx);
@@ -114,8 +166,7 @@ static void opteed_cpu_suspend_handler(uint64_t max_off_pwrlvl)
 static void opteed_cpu_on_finish_handler(uint64_t unused)
 {
 	int32_t rc = 0;
-	uint32_t linear_id = plat_my_core_pos();
-	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+	optee_context_t *optee_ctx = this_cpu_ptr(opteed_sp_context);
 	entry_point_info_t optee_on_entrypoint;
 
 	assert(optee_vectors);
@@ -125,6 +176,19 @@ static void opteed_cpu_on_finish_handler(uint64_t unused)
 				(uint64_t)&optee_vectors->cpu_on_entry,
 				optee_ctx);
 
+#if OPTEED_UP_MIGRATE
+	/*
+	 * A UP OPTEE is not entered on the cpus it does not reside on, their
+	 * context is only set up to receive OPTEE if it is migrated to them.
+	 */
+	if (!opteed_runs_on(read_mpidr_el1())) {
+		spin_lock(&opteed_migrate_lock);
+		set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON);
+		spin_unlock(&opteed_migrate_lock);
+		return;
+	}
+#endif
+
 	/* Initialise this cpu's secure context */
 	cm_init_my_context(&optee_on_entrypoint);
 
@@ -150,12 +214,27 @@ static void opteed_cpu_on_finish_handler(uint64_t unused)
 static void opteed_cpu_suspend_finish_handler(uint64_t max_off_pwrlvl)
 {
 	int32_t rc = 0;
-	uint32_t linear_id = plat_my_core_pos();
-	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+	optee_context_t *optee_ctx = this_cpu_ptr(opteed_sp_context);
 
 	assert(optee_vectors);
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_SUSPEND);
 
+#if OPTEED_UP_MIGRATE
+	if (!opteed_runs_on(read_mpidr_el1())) {
+		spin_lock(&opteed_migrate_lock);
+		set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON);
+		spin_unlock(&opteed_migrate_lock);
+		return;
+	}
+#endif
+
+	/* OPTEE is not told of a resume if it was not told of the suspend */
+	if (get_pm_silent_flag(optee_ctx->state)) {
+		clr_pm_silent_flag(optee_ctx->state);
+		set_optee_pstate(optee_ctx->state, OPTEE_PSTATE_ON);
+		return;
+	}
+
 	/* Program the entry point, max_off_pwrlvl and enter the SP */
 	write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
 		      CTX_GPREG_X0,
@@ -180,21 +259,78 @@ static void opteed_cpu_suspend_finish_handler(uint64_t max_off_pwrlvl)
  ******************************************************************************/
 static int32_t opteed_cpu_migrate_info(uint64_t *resident_cpu)
 {
+#if OPTEED_UP_MIGRATE
+	*resident_cpu = opteed_resident_mpidr;
+#endif
 	return OPTEE_MIGRATE_INFO;
 }
 
+#if OPTEED_UP_MIGRATE
+/*******************************************************************************
+ * Migrate a UP OPTEE from this cpu, where it resides, to 'to_cpu'. OPTEE is
+ * not running, so its whole state is in the context the OPTEED saved on this
+ * cpu, which is moved to the context of the target cpu. OPTEE is responsible
+ * for the state it keeps in the hardware of the cpu it resides on, such as
+ * the target of its interrupts.
+ ******************************************************************************/
+static int32_t opteed_cpu_migrate(uint64_t from_cpu, uint64_t to_cpu)
+{
+	int to_idx = plat_core_pos_by_mpidr(to_cpu);
+	optee_context_t *from_ctx = this_cpu_ptr(opteed_sp_context);
+	optee_context_t *to_ctx;
+	int32_t rc = PSCI_E_INTERN_FAIL;
+
+	assert(from_cpu == opteed_resident_mpidr);
+
+	if (to_idx < 0)
+		return PSCI_E_INTERN_FAIL;
+
+	if (to_cpu == from_cpu)
+		return PSCI_E_SUCCESS;
+
+	to_ctx = percpu_ptr_by_index(to_idx, opteed_sp_context);
+
+	spin_lock(&opteed_migrate_lock);
+
+	/*
+	 * The target cpu must be on, and OPTEE must not have a standard call
+	 * preempted by the OPTEED waiting on this cpu.
+	 */
+	if (get_optee_pstate(to_ctx->state) != OPTEE_PSTATE_ON)
+		goto exit;
+#if OPTEED_STD_BUDGET_US
+	if (get_std_preempted_flag(from_ctx->state))
+		goto exit;
+#endif
+
+	memcpy(&to_ctx->cpu_ctx, &from_ctx->cpu_ctx, sizeof(to_ctx->cpu_ctx));
+
+	/* Make the context visible before OPTEE can be called on the target */
+	dmbish();
+	opteed_resident_mpidr = to_cpu;
+	rc = PSCI_E_SUCCESS;
+
+exit:
+	spin_unlock(&opteed_migrate_lock);
+	return rc;
+}
+#endif
+
 /*******************************************************************************
  * System is about to be switched off. Allow the OPTEED/OPTEE to perform
  * any actions needed.
  ******************************************************************************/
 static void opteed_system_off(void)
 {
-	uint32_t linear_id = plat_my_core_pos();
-	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+	optee_context_t *optee_ctx = this_cpu_ptr(opteed_sp_context);
 
 	assert(optee_vectors);
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
+	/* A UP OPTEE cannot be entered on another cpu than its own */
+	if (!opteed_runs_on(read_mpidr_el1()))
+		return;
+
 	/* Program the entry point */
 	cm_set_elr_el3(SECURE, (uint64_t) &optee_vectors->system_off_entry);
 
@@ -209,12 +345,15 @@ static void opteed_system_off(void)
  ******************************************************************************/
 static void opteed_system_reset(void)
 {
-	uint32_t linear_id = plat_my_core_pos();
-	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+	optee_context_t *optee_ctx = this_cpu_ptr(opteed_sp_context);
 
 	assert(optee_vectors);
 	assert(get_optee_pstate(optee_ctx->state) == OPTEE_PSTATE_ON);
 
+	/* A UP OPTEE cannot be entered on another cpu than its own */
+	if (!opteed_runs_on(read_mpidr_el1()))
+		return;
+
 	/* Program the entry point */
 	cm_set_elr_el3(SECURE, (uint64_t) &optee_vectors->system_reset_entry);
 
@@ -235,7 +374,11 @@ const spd_pm_ops_t opteed_pm = {
 	.svc_suspend = opteed_cpu_suspend_handler,
 	.svc_on_finish = opteed_cpu_on_finish_handler,
 	.svc_suspend_finish = opteed_cpu_suspend_finish_handler,
+#if OPTEED_UP_MIGRATE
+	.svc_migrate = opteed_cpu_migrate,
+#else
 	.svc_migrate = NULL,
+#endif
 	.svc_migrate_info = opteed_cpu_migrate_info,
 	.svc_system_off = opteed_system_off,
 	.svc_system_reset = opteed_system_reset,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -57,6 +57,39 @@
 				} while (0)
 
 
+/*******************************************************************************
+ * Flag in the per-cpu 'state' set while a standard call preempted by the
+ * OPTEED, because it has exhausted its budget, waits to be resumed
+ ******************************************************************************/
+#define STD_PREEMPTED_FLAG_SHIFT	2
+#define STD_PREEMPTED_FLAG_MASK		1
+#define get_std_preempted_flag(state)	((state >> STD_PREEMPTED_FLAG_SHIFT) \
+					 & STD_PREEMPTED_FLAG_MASK)
+#define set_std_preempted_flag(state)	(state |=			     \
+					 1 << STD_PREEMPTED_FLAG_SHIFT)
+#define clr_std_preempted_flag(state)	(state &=			     \
+					 ~(STD_PREEMPTED_FLAG_MASK	     \
+					   << STD_PREEMPTED_FLAG_SHIFT))
+
+/*******************************************************************************
+ * Flag in the per-cpu 'state' set while the cpu is suspended without OPTEE
+ * having been notified, see TEESMC_OPTEED_PM_NOTIFY
+ ******************************************************************************/
+#define PM_SILENT_FLAG_SHIFT		3
+#define PM_SILENT_FLAG_MASK		1
+#define get_pm_silent_flag(state)	((state >> PM_SILENT_FLAG_SHIFT)     \
+					 & PM_SILENT_FLAG_MASK)
+#define set_pm_silent_flag(state)	(state |=			     \
+					 1 << PM_SILENT_FLAG_SHIFT)
+#define clr_pm_silent_flag(state)	(state &=			     \
+					 ~(PM_SILENT_FLAG_MASK		     \
+					   << PM_SILENT_FLAG_SHIFT))
+/*******************************************************************************
+ * State of the request ring of a cpu, in the per-cpu 'ring_state' flags
+ ******************************************************************************/
+#define OPTEE_RING_DRAINING		(1 << 0)
+#define OPTEE_RING_KICKED		(1 << 1)
+
 /*******************************************************************************
  * OPTEE execution state information i.e. aarch32 or aarch64
  ******************************************************************************/
@@ -71,10 +104,25 @@
 #define OPTEE_TYPE_MP		PSCI_TOS_NOT_PRESENT_MP
 
 /*******************************************************************************
- * OPTEE migrate type information as known to the OPTEED. We assume that
- * the OPTEED is dealing with an MP Secure Payload.
+ * OPTEE migrate type information as known to the OPTEED. Unless
+ * OPTEED_UP_MIGRATE is set, we assume that the OPTEED is dealing with an MP
+ * Secure Payload.
  ******************************************************************************/
+#if OPTEED_UP_MIGRATE
+#define OPTEE_MIGRATE_INFO		OPTEE_TYPE_UPM
+#else
 #define OPTEE_MIGRATE_INFO		OPTEE_TYPE_MP
+#endif
+
+/*******************************************************************************
+ * Whether OPTEE runs on the cpu 'mpidr'. A UP migratable OPTEE only runs on
+ * the cpu it is resident on.
+ ******************************************************************************/
+#if OPTEED_UP_MIGRATE
+#define opteed_runs_on(mpidr)		((mpidr) == opteed_resident_mpidr)
+#else
+#define opteed_runs_on(mpidr)		1
+#endif
 
 /*******************************************************************************
  * Number of cpus that the present on this platform. TODO: Rely on a topology
@@ -105,6 +153,7 @@
 #ifndef __ASSEMBLY__
 
 #include <cassert.h>
+#include <cpu_data.h>
 #include <stdint.h>
 
 typedef uint32_t optee_vector_isn_t;
@@ -145,12 +194,33 @@ CASSERT(OPTEED_C_RT_CTX_SIZE == sizeof(c_rt_regs_t),	\
  * 'c_rt_ctx'       - stack address to restore C runtime context from after
  *                    returning from a synchronous entry into OPTEE.
  * 'cpu_ctx'        - space to maintain OPTEE architectural state
+ * 'ring_base'      - address of the request ring registered by the normal
+ *                    world on this cpu, 0 if none
+ * 'ring_size'      - size of the request ring in bytes
+ * 'ring_state'     - OPTEE_RING_* flags tracking the draining of the ring
+ * 'ring_done'      - number of requests completed by the current drain
+ * 'preempt_token'  - token to resume the standard call preempted by the
+ *                    OPTEED with, incremented on each preemption
+ * 'preempt_*'      - copy of the state of the preempted standard call, kept
+ *                    while OPTEE handles a S-EL1 interrupt
  ******************************************************************************/
 typedef struct optee_context {
 	uint32_t state;
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
 	cpu_context_t cpu_ctx;
+#if OPTEED_REQ_RING
+	uint64_t ring_base;
+	uint32_t ring_size;
+	uint32_t ring_state;
+	uint64_t ring_done;
+#endif
+#if OPTEED_STD_BUDGET_US
+	uint32_t preempt_token;
+	gp_regs_t preempt_gpregs;
+	uint64_t preempt_elr_el3;
+	uint32_t preempt_spsr_el3;
+#endif
 } optee_context_t;
 
 /* OPTEED power management handlers */
@@ -173,8 +243,12 @@ void opteed_init_optee_ep_state(struct entry_point_info *optee_ep,
 				uint64_t pc,
 				optee_context_t *optee_ctx);
 
-extern optee_context_t opteed_sp_context[OPTEED_CORE_COUNT];
+DECLARE_PERCPU(optee_context_t, opteed_sp_context);
 extern uint32_t opteed_rw;
+extern uint32_t opteed_pm_notify_lvl;
+#if OPTEED_UP_MIGRATE
+extern volatile uint64_t opteed_resident_mpidr;
+#endif
 extern struct optee_vectors *optee_vectors;
 #endif /*__ASSEMBLY__*/
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -144,4 +144,112 @@
 #define TEESMC_OPTEED_RETURN_SYSTEM_RESET_DONE \
 	TEESMC_OPTEED_RV(TEESMC_OPTEED_FUNCID_RETURN_SYSTEM_RESET_DONE)
 
+/*
+ * Issued when returning from a TEESMC_OPTEED_RING_KICK call, once the request
+ * ring of the cpu has been found empty
+ *
+ * Register usage:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_RETURN_RING_DONE
+ * r1/x1	Number of requests completed since the call was issued
+ */
+#define TEESMC_OPTEED_FUNCID_RETURN_RING_DONE		9
+#define TEESMC_OPTEED_RETURN_RING_DONE \
+	TEESMC_OPTEED_RV(TEESMC_OPTEED_FUNCID_RETURN_RING_DONE)
+
+/*
+ * Issued by OP-TEE, at any time, to select the cpu power downs it is notified
+ * of. OP-TEE is only entered through the "cpu_suspend" and "cpu_resume"
+ * vectors when the highest power level turned off by a suspend is at least
+ * the one given. The default is 0, i.e. all the suspends which power the cpu
+ * down. A value above the highest power level of the platform skips all of
+ * them. The "cpu_off" and "cpu_on" vectors are always entered.
+ *
+ * Register usage:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_PM_NOTIFY
+ * r1/x1	Lowest power level of the suspends to notify
+ * Returns r0/x0 = 0, or TEESMC_OPTEED_PM_NOTIFY_E_INVALID if the power
+ * level is out of range.
+ */
+#define TEESMC_OPTEED_FUNCID_PM_NOTIFY			10
+#define TEESMC_OPTEED_PM_NOTIFY \
+	TEESMC_OPTEED_RV(TEESMC_OPTEED_FUNCID_PM_NOTIFY)
+
+#define TEESMC_OPTEED_PM_NOTIFY_E_INVALID		-1
+
+/*
+ * The following function IDs are issued by the normal world when
+ * OPTEED_REQ_RING is set. The normal world posts requests into a ring in
+ * shared memory, one ring per cpu, whose layout is agreed between the normal
+ * world and OP-TEE. A single world switch lets OP-TEE complete all the
+ * requests posted so far.
+ */
+
+/*
+ * Register the request ring of the calling cpu. Handled by the OPTEED.
+ *
+ * Register usage:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_RING_REGISTER
+ * r1/x1	Address of the ring, 8-byte aligned, or 0 to unregister it
+ * r2/x2	Size of the ring in bytes
+ * Returns r0/x0 = 0 on success or a TEESMC_OPTEED_RING_E_* error code
+ */
+#define TEESMC_OPTEED_RING_REGISTER \
+		((SMC_TYPE_FAST << FUNCID_TYPE_SHIFT) | \
+		 ((SMC_32) << FUNCID_CC_SHIFT) | \
+		 (62 << FUNCID_OEN_SHIFT) | 0xff10)
+
+/*
+ * Ask OP-TEE to drain the request ring of the calling cpu. The normal world
+ * only needs to issue it when it posts a request into an empty ring. If OP-TEE
+ * is already draining the ring, i.e. it has been preempted and the drain is
+ * pending, the call returns at once and the OPTEED makes OP-TEE look at the
+ * ring again before the pending drain completes.
+ *
+ * OP-TEE is entered through the "std_smc" vector with:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_RING_KICK
+ * r1/x1	Address of the ring
+ * r2/x2	Size of the ring in bytes
+ * and returns with TEESMC_OPTEED_RETURN_RING_DONE, or with
+ * TEESMC_OPTEED_RETURN_CALL_DONE if it needs to be resumed like any other
+ * standard call.
+ *
+ * Returns r0/x0 = 0 and r1/x1 = number of requests completed, 0 if the drain
+ * was pending. Returns a TEESMC_OPTEED_RING_E_* error code in r0/x0 when no
+ * ring is registered.
+ */
+#define TEESMC_OPTEED_RING_KICK \
+		((SMC_TYPE_STD << FUNCID_TYPE_SHIFT) | \
+		 ((SMC_32) << FUNCID_CC_SHIFT) | \
+		 (62 << FUNCID_OEN_SHIFT) | 0xff11)
+
+/* Error codes returned to the normal world for the request ring calls */
+#define TEESMC_OPTEED_RING_E_BUSY			-1
+#define TEESMC_OPTEED_RING_E_INVALID			-2
+
+/*
+ * The following IDs are used when OPTEED_STD_BUDGET_US is not 0, to bound the
+ * time spent by OP-TEE in a standard call before the normal world regains
+ * control. Once the budget is exhausted, the OPTEED preempts OP-TEE and
+ * returns to the normal world with:
+ * r0/x0	TEESMC_OPTEED_STD_PREEMPTED
+ * r1/x1	Resume token
+ * The normal world has to resume the call on the same cpu before it issues
+ * any other call to OP-TEE on it, which returns SMC_UNK meanwhile.
+ */
+#define TEESMC_OPTEED_STD_PREEMPTED			0xfffe0000
+
+/*
+ * Resume a standard call preempted by the OPTEED. Handled by the OPTEED,
+ * which returns to OP-TEE where it was preempted.
+ * Register usage:
+ * r0/x0	SMC Function ID, TEESMC_OPTEED_STD_RESUME
+ * r1/x1	Resume token returned when the call was preempted
+ * Returns the results of the call, or SMC_UNK if the token does not match
+ * the call preempted on this cpu.
+ */
+#define TEESMC_OPTEED_STD_RESUME \
+		((SMC_TYPE_STD << FUNCID_TYPE_SHIFT) | \
+		 ((SMC_32) << FUNCID_CC_SHIFT) | \
+		 (62 << FUNCID_OEN_SHIFT) | 0xff12)
+
 #endif /*TEESMC_OPTEED_H*/
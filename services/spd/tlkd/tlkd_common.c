@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -37,13 +37,16 @@
 
 #define AT_MASK		3
 
+/* PAR_EL1 fields */
+#define PAR_F_MASK	1
+#define PAR_ADDR_MASK	(0xfffffffffull << PAGE_SIZE_SHIFT)
+
 /*******************************************************************************
- * This function helps the SP to translate NS/S virtual addresses.
+ * Switch to the translation regime of the requested security state before
+ * using the AT instructions, and back to the secure state afterwards.
  ******************************************************************************/
-uint64_t tlkd_va_translate(uintptr_t va, int type)
+static void tlkd_at_enter(int type)
 {
-	uint64_t pa;
-
 	if (type & TLK_TRANSLATE_NS_VADDR) {
 
 		/* save secure context */
@@ -56,7 +59,28 @@ uint64_t tlkd_va_translate(uintptr_t va, int type)
 		write_scr(cm_get_scr_el3(NON_SECURE));
 		isb();
 	}
+}
+
+static void tlkd_at_exit(int type)
+{
+	/* Restore secure state */
+	if (type & TLK_TRANSLATE_NS_VADDR) {
+
+		/* restore secure context */
+		cm_el1_sysregs_context_restore(SECURE);
 
+		/* switch NS bit to start using 32-bit, secure mappings */
+		write_scr(cm_get_scr_el3(SECURE));
+		isb();
+	}
+}
+
+/*******************************************************************************
+ * Translate a single address in the current translation regime and return the
+ * contents of PAR_EL1.
+ ******************************************************************************/
+static uint64_t tlkd_at(uintptr_t va, int type)
+{
 	int at = type & AT_MASK;
 	switch (at) {
 	case 0:
@@ -77,20 +101,68 @@ uint64_t tlkd_va_translate(uintptr_t va, int type)
 
 	/* get the (NS/S) physical address */
 	isb();
-	pa = read_par_el1();
+	return read_par_el1();
+}
 
-	/* Restore secure state */
-	if (type & TLK_TRANSLATE_NS_VADDR) {
+/*******************************************************************************
+ * This function helps the SP to translate NS/S virtual addresses.
+ ******************************************************************************/
+uint64_t tlkd_va_translate(uintptr_t va, int type)
+{
+	uint64_t pa;
 
-		/* restore secure context */
-		cm_el1_sysregs_context_restore(SECURE);
+	tlkd_at_enter(type);
+	pa = tlkd_at(va, type);
+	tlkd_at_exit(type);
 
-		/* switch NS bit to start using 32-bit, secure mappings */
-		write_scr(cm_get_scr_el3(SECURE));
-		isb();
+	return pa;
+}
+
+/*******************************************************************************
+ * This function helps the SP to translate a range of NS/S virtual addresses.
+ * It translates 'va' and returns the contents of PAR_EL1 for it, like
+ * tlkd_va_translate(). It also returns in '*contig_len' the number of bytes
+ * from 'va', up to 'len' bytes and TLK_TRANSLATE_RANGE_MAX_PAGES pages, that
+ * are mapped to physically contiguous memory with the same attributes. The
+ * length is 0 if 'va' cannot be translated.
+ ******************************************************************************/
+uint64_t tlkd_va_translate_range(uintptr_t va, size_t len, int type,
+				 size_t *contig_len)
+{
+	uint64_t par, next_par, pa;
+	uintptr_t next_va;
+	size_t size;
+	unsigned int pages;
+
+	assert(contig_len != NULL);
+
+	tlkd_at_enter(type);
+
+	par = tlkd_at(va, type);
+	if (par & PAR_F_MASK) {
+		tlkd_at_exit(type);
+		*contig_len = 0;
+		return par;
 	}
 
-	return pa;
+	/* Extend the extent one page at a time */
+	pa = par & PAR_ADDR_MASK;
+	next_va = (va & ~(PAGE_SIZE - 1)) + PAGE_SIZE;
+	size = next_va - va;
+	for (pages = 1; (size < len) && (pages < TLK_TRANSLATE_RANGE_MAX_PAGES);
+	     pages++) {
+		next_par = tlkd_at(next_va, type);
+		if (next_par != (par & ~PAR_ADDR_MASK) + pa + pages * PAGE_SIZE)
+			break;
+
+		next_va += PAGE_SIZE;
+		size += PAGE_SIZE;
+	}
+
+	tlkd_at_exit(type);
+
+	*contig_len = (size < len) ? size : len;
+	return par;
 }
 
 /*******************************************************************************
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -46,6 +46,7 @@
 #include <errno.h>
 #include <platform.h>
 #include <runtime_svc.h>
+#include <spd_trace.h>
 #include <stddef.h>
 #include <tlk.h>
 #include <uuid.h>
@@ -159,6 +160,7 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 	gp_regs_t *gp_regs;
 	uint32_t ns;
 	uint64_t par;
+	size_t len;
 
 	/* Passing a NULL context is a critical programming error */
 	assert(handle);
@@ -196,6 +198,7 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		cm_el1_sysregs_context_restore(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
 
+		spd_trace_exit();
 		SMC_RET1(ns_cpu_context, x1);
 
 	/*
@@ -207,7 +210,8 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 	 *    required for maintaining sessions with the Trusted
 	 *    Applications.
 	 * c. open/close sessions
-	 * d. issue commands to the Trusted Apps
+	 * d. issue commands to the Trusted Apps, one at a time or as a
+	 *    batch queued in the request buffer
 	 * e. resume the preempted standard SMC call.
 	 */
 	case TLK_REGISTER_LOGBUF:
@@ -216,11 +220,16 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 	case TLK_CLOSE_TA_SESSION:
 	case TLK_TA_LAUNCH_OP:
 	case TLK_TA_SEND_EVENT:
+	case TLK_TA_LAUNCH_BATCH:
 	case TLK_RESUME_FID:
 
 		if (!ns)
 			SMC_RET1(handle, SMC_UNK);
 
+		/* A batch must contain at least one request */
+		if ((smc_fid == TLK_TA_LAUNCH_BATCH) && ((uint32_t)x1 == 0))
+			SMC_RET1(handle, SMC_UNK);
+
 		/*
 		 * This is a fresh request from the non-secure client.
 		 * The parameters are in x1 and x2. Figure out which
@@ -274,6 +283,9 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		write_ctx_reg(gp_regs, CTX_GPREG_X5, (uint32_t)(x2 >> 32));
 		write_ctx_reg(gp_regs, CTX_GPREG_X6, (uint32_t)x3);
 		write_ctx_reg(gp_regs, CTX_GPREG_X7, (uint32_t)(x3 >> 32));
+		spd_trace_enter(smc_fid == TLK_RESUME_FID ?
+				SPD_TRACE_STD_RESUME : SPD_TRACE_STD_SMC,
+				smc_fid);
 		SMC_RET4(&tlk_ctx.cpu_ctx, smc_fid, 0, (uint32_t)x1,
 			(uint32_t)(x1 >> 32));
 
@@ -309,9 +321,41 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		/* return physical address in r0-r1 */
 		SMC_RET4(handle, (uint32_t)par, (uint32_t)(par >> 32), 0, 0);
 
+	/*
+	 * Translate a range of NS/EL1-S virtual addresses, e.g. a
+	 * scatter-gather buffer, one physically contiguous extent at a
+	 * time.
+	 *
+	 * x1 = virtual address
+	 * x3 = type (NS/S)
+	 * x4 = length of the range
+	 *
+	 * Returns PA:lo in r0, PA:hi in r1 and the length of the extent
+	 * starting at the virtual address in r2, 0 if the translation
+	 * failed.
+	 */
+	case TLK_VA_TRANSLATE_RANGE:
+
+		/* Should be invoked only by secure world */
+		if (ns)
+			SMC_RET1(handle, SMC_UNK);
+
+		/* NS virtual addresses are 64-bit long */
+		if (x3 & TLK_TRANSLATE_NS_VADDR)
+			x1 = (uint32_t)x1 | (x2 << 32);
+
+		if (!x1 || !x4)
+			SMC_RET1(handle, SMC_UNK);
+
+		par = tlkd_va_translate_range(x1, x4, x3, &len);
+
+		/* return physical address in r0-r1, extent length in r2 */
+		SMC_RET4(handle, (uint32_t)par, (uint32_t)(par >> 32), len, 0);
+
 	/*
 	 * This is a request from the SP to mark completion of
-	 * a standard function ID.
+	 * a standard function ID. The result is in x1 and, for a
+	 * batch of requests, the number of requests completed in x2.
 	 */
 	case TLK_REQUEST_DONE:
 		if (ns)
@@ -338,7 +382,8 @@ uint64_t tlkd_smc_handler(uint32_t smc_fid,
 		 */
 		cm_el1_sysregs_context_restore(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
-		SMC_RET1(ns_cpu_context, x1);
+		spd_trace_exit();
+		SMC_RET2(ns_cpu_context, x1, x2);
 
 	/*
 	 * This function ID is used only by the SP to indicate it has
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -61,6 +61,9 @@
  ******************************************************************************/
 #define TLK_TRANSLATE_NS_VADDR		4
 
+/* Maximum number of pages looked up by one TLK_VA_TRANSLATE_RANGE call */
+#define TLK_TRANSLATE_RANGE_MAX_PAGES	256
+
 /*******************************************************************************
  * Secure Payload execution state information i.e. aarch32 or aarch64
  ******************************************************************************/
@@ -96,6 +99,7 @@
 #ifndef __ASSEMBLY__
 
 #include <cassert.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /* AArch64 callee saved general purpose register context structure. */
@@ -130,6 +134,8 @@ typedef struct tlk_context {
  * Function & Data prototypes
  ******************************************************************************/
 uint64_t tlkd_va_translate(uintptr_t va, int type);
+uint64_t tlkd_va_translate_range(uintptr_t va, size_t len, int type,
+				 size_t *contig_len);
 uint64_t tlkd_enter_sp(uint64_t *c_rt_ctx);
 void __dead2 tlkd_exit_sp(uint64_t c_rt_ctx, uint64_t ret);
 uint64_t tlkd_synchronous_sp_entry(tlk_context_t *tlk_ctx);
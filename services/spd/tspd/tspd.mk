@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
 #
 # Redistribution and use in source and binary forms, with or without
 # modification, are permitted provided that the following conditions are met:
@@ -69,3 +69,17 @@ endif
 
 $(eval $(call assert_boolean,TSP_NS_INTR_ASYNC_PREEMPT))
 $(eval $(call add_define,TSP_NS_INTR_ASYNC_PREEMPT))
+
+# Flag used to only save the EL1 system registers that the TSP changes at run
+# time when it is preempted.
+TSPD_PREEMPT_PARTIAL_SAVE	:=	0
+
+$(eval $(call assert_boolean,TSPD_PREEMPT_PARTIAL_SAVE))
+$(eval $(call add_define,TSPD_PREEMPT_PARTIAL_SAVE))
+
+# Flag used to let the TSP handle pending S-EL1 interrupts back to back without
+# returning to the normal world in between.
+TSPD_SEL1_INTR_COALESCE	:=	0
+
+$(eval $(call assert_boolean,TSPD_SEL1_INTR_COALESCE))
+$(eval $(call add_define,TSPD_SEL1_INTR_COALESCE))
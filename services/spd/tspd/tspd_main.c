@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -47,6 +47,7 @@
 #include <errno.h>
 #include <platform.h>
 #include <runtime_svc.h>
+#include <spd_trace.h>
 #include <stddef.h>
 #include <string.h>
 #include <tsp.h>
@@ -60,9 +61,15 @@
 tsp_vectors_t *tsp_vectors;
 
 /*******************************************************************************
- * Array to keep track of per-cpu Secure Payload state
+ * Per-cpu variable to keep track of the Secure Payload state
  ******************************************************************************/
-tsp_context_t tspd_sp_context[TSPD_CORE_COUNT];
+DEFINE_PERCPU(tsp_context_t, tspd_sp_context);
+
+/*******************************************************************************
+ * Lowest power level of the suspends the Secure Payload is notified of, as set
+ * with TSP_PM_NOTIFY. All the power downs are notified by default.
+ ******************************************************************************/
+uint32_t tspd_pm_notify_lvl;
 
 
 /* TSP UID */
@@ -83,7 +90,18 @@ uint64_t tspd_handle_sp_preemption(void *handle)
 	cpu_context_t *ns_cpu_context;
 
 	assert(handle == cm_get_context(SECURE));
+	this_cpu_ptr(tspd_sp_context)->preempt_count++;
+
+#if TSPD_PREEMPT_PARTIAL_SAVE
+	/*
+	 * Only save the EL1 system registers which the TSP may have changed
+	 * since it has been entered, the others are still in the context.
+	 */
+	cm_el1_sysregs_context_save_partial(SECURE,
+					    TSPD_EL1_SYSREGS_PREEMPT_MASK);
+#else
 	cm_el1_sysregs_context_save(SECURE);
+#endif
 	/* Get a reference to the non-secure context */
 	ns_cpu_context = cm_get_context(NON_SECURE);
 	assert(ns_cpu_context);
@@ -106,9 +124,52 @@ uint64_t tspd_handle_sp_preemption(void *handle)
 	 * Return back to the normal world with SMC_PREEMPTED as error
 	 * code in x0.
 	 */
+	spd_trace_exit();
 	SMC_RET1(ns_cpu_context, SMC_PREEMPTED);
 }
 
+#if TSP_INTR_LATENCY_BENCH
+/*******************************************************************************
+ * This function adds the latency between the generation of the S-EL1 interrupt
+ * being handled on this cpu and the system counter value 'ts' to the histogram
+ * of this cpu for the given 'stage'. Nothing is recorded if the time at which
+ * the interrupt was generated is not known.
+ ******************************************************************************/
+static void tspd_record_intr_latency(tsp_context_t *tsp_ctx,
+				     unsigned int stage,
+				     uint64_t ts)
+{
+	uint64_t delta;
+	unsigned int bucket;
+
+	if (!tsp_ctx->intr_gen_ts || ts < tsp_ctx->intr_gen_ts)
+		return;
+
+	delta = ts - tsp_ctx->intr_gen_ts;
+	bucket = delta ? 64 - __builtin_clzll(delta) : 0;
+	if (bucket >= TSPD_INTR_LAT_BUCKETS)
+		bucket = TSPD_INTR_LAT_BUCKETS - 1;
+
+	tsp_ctx->intr_lat_hist[stage][bucket]++;
+}
+
+/*******************************************************************************
+ * This function returns the number of S-EL1 interrupts whose latency at the
+ * given 'stage' fell in 'bucket', summed over all the cpus.
+ ******************************************************************************/
+static uint64_t tspd_intr_lat_count(unsigned int stage, unsigned int bucket)
+{
+	uint64_t count = 0;
+	unsigned int i;
+
+	for (i = 0; i < TSPD_CORE_COUNT; i++)
+		count += percpu_ptr_by_index(i, tspd_sp_context)->
+				intr_lat_hist[stage][bucket];
+
+	return count;
+}
+#endif
+
 /*******************************************************************************
  * This function is the handler registered for S-EL1 interrupts by the TSPD. It
  * validates the interrupt and upon success arranges entry into the TSP at
@@ -119,8 +180,11 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 					    void *handle,
 					    void *cookie)
 {
-	uint32_t linear_id;
 	tsp_context_t *tsp_ctx;
+#if TSP_INTR_LATENCY_BENCH
+	uint64_t el3_entry_ts = read_cntpct_el0();
+	uint32_t timer_ctl;
+#endif
 
 	/* Check the security state when the exception was generated */
 	assert(get_interrupt_src_ss(flags) == NON_SECURE);
@@ -132,10 +196,26 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 	cm_el1_sysregs_context_save(NON_SECURE);
 
 	/* Get a reference to this cpu's TSP context */
-	linear_id = plat_my_core_pos();
-	tsp_ctx = &tspd_sp_context[linear_id];
+	tsp_ctx = this_cpu_ptr(tspd_sp_context);
 	assert(&tsp_ctx->cpu_ctx == cm_get_context(SECURE));
 
+#if TSP_INTR_LATENCY_BENCH
+	/*
+	 * The secure physical timer is the only S-EL1 interrupt the TSP
+	 * expects and it fires when the counter reaches its compare value.
+	 * Use that value as the time of generation while the timer is enabled
+	 * and asserting its interrupt, and measure nothing otherwise.
+	 */
+	timer_ctl = read_cntps_ctl_el1();
+	if (get_cntp_ctl_enable(timer_ctl) && get_cntp_ctl_istatus(timer_ctl))
+		tsp_ctx->intr_gen_ts = read_cntps_cval_el1();
+	else
+		tsp_ctx->intr_gen_ts = 0;
+
+	tspd_record_intr_latency(tsp_ctx, TSPD_INTR_LAT_EL3_ENTRY,
+				 el3_entry_ts);
+#endif
+
 	/*
 	 * Determine if the TSP was previously preempted. Its last known
 	 * context has to be preserved in this case.
@@ -157,6 +237,10 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 #endif
 	}
 
+#if TSPD_SEL1_INTR_COALESCE
+	tsp_ctx->intr_burst = 1;
+#endif
+
 	cm_el1_sysregs_context_restore(SECURE);
 	cm_set_elr_spsr_el3(SECURE, (uint64_t) &tsp_vectors->sel1_intr_entry,
 		    SPSR_64(MODE_EL1, MODE_SP_ELX, DISABLE_ALL_EXCEPTIONS));
@@ -170,6 +254,7 @@ static uint64_t tspd_sel1_interrupt_handler(uint32_t id,
 	 * this address from ELR_EL3 as the secure context will not take effect
 	 * until el3_exit().
 	 */
+	spd_trace_enter(SPD_TRACE_SEL1_INTR, 0);
 	SMC_RET2(&tsp_ctx->cpu_ctx, TSP_HANDLE_SEL1_INTR_AND_RETURN, read_elr_el3());
 }
 
@@ -205,9 +290,6 @@ static uint64_t tspd_ns_interrupt_handler(uint32_t id,
 int32_t tspd_setup(void)
 {
 	entry_point_info_t *tsp_ep_info;
-	uint32_t linear_id;
-
-	linear_id = plat_my_core_pos();
 
 	/*
 	 * Get information about the Secure Payload (BL32) image. Its
@@ -238,7 +320,7 @@ int32_t tspd_setup(void)
 	tspd_init_tsp_ep_state(tsp_ep_info,
 				TSP_AARCH64,
 				tsp_ep_info->pc,
-				&tspd_sp_context[linear_id]);
+				this_cpu_ptr(tspd_sp_context));
 
 #if TSP_INIT_ASYNC
 	bl31_set_next_image_type(SECURE);
@@ -263,8 +345,7 @@ int32_t tspd_setup(void)
  ******************************************************************************/
 int32_t tspd_init(void)
 {
-	uint32_t linear_id = plat_my_core_pos();
-	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	tsp_context_t *tsp_ctx = this_cpu_ptr(tspd_sp_context);
 	entry_point_info_t *tsp_entry_point;
 	uint64_t rc;
 
@@ -276,6 +357,7 @@ int32_t tspd_init(void)
 	assert(tsp_entry_point);
 
 	cm_init_my_context(tsp_entry_point);
+	cm_set_el1_sysregs_mask(SECURE, TSPD_EL1_SYSREGS_MASK);
 
 	/*
 	 * Arrange for an entry into the test secure payload. It will be
@@ -306,8 +388,11 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			 uint64_t flags)
 {
 	cpu_context_t *ns_cpu_context;
-	uint32_t linear_id = plat_my_core_pos(), ns;
-	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	uint32_t ns;
+#if TSPD_SEL1_INTR_COALESCE
+	uint64_t ns_elr_el3;
+#endif
+	tsp_context_t *tsp_ctx = this_cpu_ptr(tspd_sp_context);
 	uint64_t rc;
 #if TSP_INIT_ASYNC
 	entry_point_info_t *next_image_info;
@@ -341,6 +426,43 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 
 		assert(handle == cm_get_context(SECURE));
 
+#if TSPD_SEL1_INTR_COALESCE
+		/*
+		 * If another S-EL1 interrupt became pending while the TSP was
+		 * handling the last one, enter the TSP at its S-EL1 interrupt
+		 * entry point again. The non-secure context saved on the first
+		 * interrupt of the burst and the EL3 state of a preempted
+		 * standard SMC are left as they are until the burst ends.
+		 */
+		if (tsp_ctx->intr_burst < TSPD_SEL1_INTR_COALESCE_MAX &&
+		    plat_ic_get_pending_interrupt_type() == INTR_TYPE_S_EL1) {
+			tsp_ctx->intr_burst++;
+			tsp_ctx->intr_coalesce_count++;
+#if TSP_INTR_LATENCY_BENCH
+			tspd_record_intr_latency(tsp_ctx,
+						 TSPD_INTR_LAT_SEL1_ENTRY, x1);
+			tsp_ctx->intr_gen_ts = 0;
+#endif
+			spd_trace_exit();
+
+			cm_set_elr_spsr_el3(SECURE,
+				(uint64_t) &tsp_vectors->sel1_intr_entry,
+				SPSR_64(MODE_EL1, MODE_SP_ELX,
+					DISABLE_ALL_EXCEPTIONS));
+
+			/*
+			 * Pass the normal world address of the first interrupt
+			 * of the burst to the TSP as for any S-EL1 interrupt.
+			 */
+			ns_cpu_context = cm_get_context(NON_SECURE);
+			assert(ns_cpu_context);
+			ns_elr_el3 = SMC_GET_EL3(ns_cpu_context, CTX_ELR_EL3);
+			spd_trace_enter(SPD_TRACE_SEL1_INTR, 0);
+			SMC_RET2(&tsp_ctx->cpu_ctx,
+				 TSP_HANDLE_SEL1_INTR_AND_RETURN, ns_elr_el3);
+		}
+#endif
+
 		/*
 		 * Restore the relevant EL3 state which saved to service
 		 * this SMC.
@@ -374,8 +496,54 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		cm_el1_sysregs_context_restore(NON_SECURE);
 		cm_set_next_eret_context(NON_SECURE);
 
+#if TSP_INTR_LATENCY_BENCH
+		/* The TSP passes the time it was entered in x1 */
+		tspd_record_intr_latency(tsp_ctx, TSPD_INTR_LAT_SEL1_ENTRY, x1);
+		tspd_record_intr_latency(tsp_ctx, TSPD_INTR_LAT_NS_RETURN,
+					 read_cntpct_el0());
+		tsp_ctx->intr_gen_ts = 0;
+#endif
+
+		spd_trace_exit();
 		SMC_RET0((uint64_t) ns_cpu_context);
 
+#if TSP_INTR_LATENCY_BENCH
+	/*
+	 * Request from the non-secure client to read the S-EL1 interrupt
+	 * latency histograms. x1 contains the index of the bucket to read.
+	 * The number of interrupts in this bucket for the latencies to the
+	 * entry into EL3, the entry into the TSP and the return to the normal
+	 * world are returned in x1, x2 and x3 respectively.
+	 */
+	case TSP_FAST_FID(TSP_INTR_LATENCY):
+		if (!ns || x1 >= TSPD_INTR_LAT_BUCKETS)
+			SMC_RET1(handle, SMC_UNK);
+
+		SMC_RET4(handle, 0,
+			 tspd_intr_lat_count(TSPD_INTR_LAT_EL3_ENTRY, x1),
+			 tspd_intr_lat_count(TSPD_INTR_LAT_SEL1_ENTRY, x1),
+			 tspd_intr_lat_count(TSPD_INTR_LAT_NS_RETURN, x1));
+#endif
+
+	/*
+	 * Request from the non-secure world to read the number of times the
+	 * standard SMCs have been preempted on the cpu whose linear index is
+	 * in x1. The count is returned in x1.
+	 */
+	case TSP_FAST_FID(TSP_PREEMPT_STATS):
+		if (!ns || x1 >= TSPD_CORE_COUNT)
+			SMC_RET1(handle, SMC_UNK);
+
+#if TSPD_SEL1_INTR_COALESCE
+		SMC_RET3(handle, 0,
+			 percpu_ptr_by_index(x1, tspd_sp_context)->preempt_count,
+			 percpu_ptr_by_index(x1, tspd_sp_context)->
+				intr_coalesce_count);
+#else
+		SMC_RET2(handle, 0,
+			 percpu_ptr_by_index(x1, tspd_sp_context)->preempt_count);
+#endif
+
 	/*
 	 * This function ID is used only by the SP to indicate it has
 	 * finished initialising itself after a cold boot
@@ -503,6 +671,16 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 	case TSP_FAST_FID(TSP_SUB):
 	case TSP_FAST_FID(TSP_MUL):
 	case TSP_FAST_FID(TSP_DIV):
+	case TSP_FAST_FID(TSP_MBOX_REGISTER):
+	case TSP_FAST_FID(TSP_MBOX_CALL):
+#if TSP_WORK_STEALING
+	case TSP_FAST_FID(TSP_WORK_STEAL):
+	case TSP_FAST_FID(TSP_WORK_DEPTH):
+	case TSP_STD_FID(TSP_WORK_PUSH):
+#endif
+#if TSP_BENCH
+	case TSP_FAST_FID(TSP_BENCH_RUN):
+#endif
 
 	case TSP_STD_FID(TSP_ADD):
 	case TSP_STD_FID(TSP_SUB):
@@ -521,16 +699,9 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			if (get_std_smc_active_flag(tsp_ctx->state))
 				SMC_RET1(handle, SMC_UNK);
 
-			cm_el1_sysregs_context_save(NON_SECURE);
-
 			/* Save x1 and x2 for use by TSP_GET_ARGS call below */
 			store_tsp_args(tsp_ctx, x1, x2);
 
-			/*
-			 * We are done stashing the non-secure context. Ask the
-			 * secure payload to do the work now.
-			 */
-
 			/*
 			 * Verify if there is a valid context to use, copy the
 			 * operation type and parameters to the secure context
@@ -560,8 +731,14 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 #endif
 			}
 
-			cm_el1_sysregs_context_restore(SECURE);
-			cm_set_next_eret_context(SECURE);
+			/*
+			 * Stash the non-secure context and ask the secure
+			 * payload to do the work now.
+			 */
+			cm_el1_sysregs_context_switch(NON_SECURE);
+			spd_trace_enter(GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST ?
+					SPD_TRACE_FAST_SMC : SPD_TRACE_STD_SMC,
+					smc_fid);
 			SMC_RET3(&tsp_ctx->cpu_ctx, smc_fid, x1, x2);
 		} else {
 			/*
@@ -571,15 +748,13 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 			 * and return to the non-secure state.
 			 */
 			assert(handle == cm_get_context(SECURE));
-			cm_el1_sysregs_context_save(SECURE);
 
 			/* Get a reference to the non-secure context */
 			ns_cpu_context = cm_get_context(NON_SECURE);
 			assert(ns_cpu_context);
 
-			/* Restore non-secure state */
-			cm_el1_sysregs_context_restore(NON_SECURE);
-			cm_set_next_eret_context(NON_SECURE);
+			/* Switch from the secure to the non-secure state */
+			cm_el1_sysregs_context_switch(SECURE);
 			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_STD) {
 				clr_std_smc_active_flag(tsp_ctx->state);
 #if TSP_NS_INTR_ASYNC_PREEMPT
@@ -592,6 +767,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 #endif
 			}
 
+			spd_trace_exit();
 			SMC_RET3(ns_cpu_context, x1, x2, x3);
 		}
 
@@ -640,6 +816,7 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		 */
 		cm_el1_sysregs_context_restore(SECURE);
 		cm_set_next_eret_context(SECURE);
+		spd_trace_enter(SPD_TRACE_STD_RESUME, smc_fid);
 		SMC_RET0(&tsp_ctx->cpu_ctx);
 
 		/*
@@ -655,6 +832,36 @@ uint64_t tspd_smc_handler(uint32_t smc_fid,
 		get_tsp_args(tsp_ctx, x1, x2);
 		SMC_RET2(handle, x1, x2);
 
+	/* Request from the secure payload selecting the suspends to notify */
+	case TSP_PM_NOTIFY:
+		if (ns)
+			SMC_RET1(handle, SMC_UNK);
+
+		if (x1 > PLAT_MAX_PWR_LVL + 1)
+			SMC_RET1(handle, TSP_PM_NOTIFY_ERROR);
+
+		tspd_pm_notify_lvl = x1;
+		SMC_RET1(handle, 0);
+
+#if TSP_BENCH
+		/*
+		 * Requests from the secure payload measuring the cost of the
+		 * calls into the secure monitor. The world switch is emulated
+		 * by switching the EL1 context to the normal world and back.
+		 */
+	case TSP_BENCH_NOP:
+	case TSP_BENCH_SWITCH:
+		if (ns)
+			SMC_RET1(handle, SMC_UNK);
+
+		if (smc_fid == TSP_BENCH_SWITCH) {
+			cm_el1_sysregs_context_switch(SECURE);
+			cm_el1_sysregs_context_switch(NON_SECURE);
+		}
+
+		SMC_RET1(handle, 0);
+#endif
+
 	case TOS_CALL_COUNT:
 		/*
 		 * Return the number of service function IDs implemented to
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -52,8 +52,7 @@ static void tspd_cpu_on_handler(uint64_t target_cpu)
 static int32_t tspd_cpu_off_handler(uint64_t unused)
 {
 	int32_t rc = 0;
-	uint32_t linear_id = plat_my_core_pos();
-	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	tsp_context_t *tsp_ctx = this_cpu_ptr(tspd_sp_context);
 
 	assert(tsp_vectors);
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON);
@@ -85,12 +84,21 @@ static int32_t tspd_cpu_off_handler(uint64_t unused)
 static void tspd_cpu_suspend_handler(uint64_t max_off_pwrlvl)
 {
 	int32_t rc = 0;
-	uint32_t linear_id = plat_my_core_pos();
-	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	tsp_context_t *tsp_ctx = this_cpu_ptr(tspd_sp_context);
 
 	assert(tsp_vectors);
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON);
 
+	/*
+	 * Skip the world switch for the suspends the TSP has not asked to be
+	 * notified of. Its S-EL1 context is saved by the TSPD anyway.
+	 */
+	if (max_off_pwrlvl < tspd_pm_notify_lvl) {
+		set_pm_silent_flag(tsp_ctx->state);
+		set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_SUSPEND);
+		return;
+	}
+
 	/* Program the entry point and enter the TSP */
 	cm_set_elr_el3(SECURE, (uint64_t) &tsp_vectors->cpu_suspend_entry);
 	rc = tspd_synchronous_sp_entry(tsp_ctx);
@@ -115,8 +123,7 @@ static void tspd_cpu_suspend_handler(uint64_t max_off_pwrlvl)
 static void tspd_cpu_on_finish_handler(uint64_t unused)
 {
 	int32_t rc = 0;
-	uint32_t linear_id = plat_my_core_pos();
-	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	tsp_context_t *tsp_ctx = this_cpu_ptr(tspd_sp_context);
 	entry_point_info_t tsp_on_entrypoint;
 
 	assert(tsp_vectors);
@@ -129,6 +136,7 @@ static void tspd_cpu_on_finish_handler(uint64_t unused)
 
 	/* Initialise this cpu's secure context */
 	cm_init_my_context(&tsp_on_entrypoint);
+	cm_set_el1_sysregs_mask(SECURE, TSPD_EL1_SYSREGS_MASK);
 
 #if TSP_NS_INTR_ASYNC_PREEMPT
 	/*
@@ -160,12 +168,18 @@ static void tspd_cpu_on_finish_handler(uint64_t unused)
 static void tspd_cpu_suspend_finish_handler(uint64_t max_off_pwrlvl)
 {
 	int32_t rc = 0;
-	uint32_t linear_id = plat_my_core_pos();
-	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	tsp_context_t *tsp_ctx = this_cpu_ptr(tspd_sp_context);
 
 	assert(tsp_vectors);
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_SUSPEND);
 
+	/* The TSP is not told of a resume if it was not told of the suspend */
+	if (get_pm_silent_flag(tsp_ctx->state)) {
+		clr_pm_silent_flag(tsp_ctx->state);
+		set_tsp_pstate(tsp_ctx->state, TSP_PSTATE_ON);
+		return;
+	}
+
 	/* Program the entry point, max_off_pwrlvl and enter the SP */
 	write_ctx_reg(get_gpregs_ctx(&tsp_ctx->cpu_ctx),
 		      CTX_GPREG_X0,
@@ -199,8 +213,7 @@ static int32_t tspd_cpu_migrate_info(uint64_t *resident_cpu)
  ******************************************************************************/
 static void tspd_system_off(void)
 {
-	uint32_t linear_id = plat_my_core_pos();
-	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	tsp_context_t *tsp_ctx = this_cpu_ptr(tspd_sp_context);
 
 	assert(tsp_vectors);
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON);
@@ -219,8 +232,7 @@ static void tspd_system_off(void)
  ******************************************************************************/
 static void tspd_system_reset(void)
 {
-	uint32_t linear_id = plat_my_core_pos();
-	tsp_context_t *tsp_ctx = &tspd_sp_context[linear_id];
+	tsp_context_t *tsp_ctx = this_cpu_ptr(tspd_sp_context);
 
 	assert(tsp_vectors);
 	assert(get_tsp_pstate(tsp_ctx->state) == TSP_PSTATE_ON);
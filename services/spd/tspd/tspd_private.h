@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -75,12 +75,49 @@
 					 ~(STD_SMC_ACTIVE_FLAG_MASK           \
 					   << STD_SMC_ACTIVE_FLAG_SHIFT))
 
+/*
+ * Flag in the per-cpu 'state' set while the cpu is suspended without the TSP
+ * having been notified, see TSP_PM_NOTIFY.
+ */
+#define PM_SILENT_FLAG_SHIFT		3
+#define PM_SILENT_FLAG_MASK		1
+#define get_pm_silent_flag(state)	((state >> PM_SILENT_FLAG_SHIFT)      \
+					 & PM_SILENT_FLAG_MASK)
+#define set_pm_silent_flag(state)	(state |=                             \
+					 1 << PM_SILENT_FLAG_SHIFT)
+#define clr_pm_silent_flag(state)	(state &=                             \
+					 ~(PM_SILENT_FLAG_MASK                \
+					   << PM_SILENT_FLAG_SHIFT))
+
 /*******************************************************************************
  * Secure Payload execution state information i.e. aarch32 or aarch64
  ******************************************************************************/
 #define TSP_AARCH32		MODE_RW_32
 #define TSP_AARCH64		MODE_RW_64
 
+/*******************************************************************************
+ * Groups of EL1 system registers used by the TSP. It runs in AArch64 state and
+ * does not use the thread ID registers, so these groups are shared with the
+ * normal world instead of being switched on every entry and exit.
+ ******************************************************************************/
+#define TSPD_EL1_SYSREGS_MASK	(CTX_EL1_SYSREGS_EXC |			\
+				 CTX_EL1_SYSREGS_MMU |			\
+				 CTX_EL1_SYSREGS_TIMER)
+
+/*
+ * Groups of EL1 system registers which the TSP changes after it has been
+ * entered. The others are set up when the TSP is initialised and still hold
+ * the values in the secure context when the TSP is preempted.
+ */
+#define TSPD_EL1_SYSREGS_PREEMPT_MASK	CTX_EL1_SYSREGS_EXC
+
+/*
+ * Maximum number of pending S-EL1 interrupts the TSP handles back to back
+ * before the normal world is resumed, so that a secure interrupt storm cannot
+ * lock the normal world out of the cpu.
+ */
+#define TSPD_SEL1_INTR_COALESCE_MAX	8
+
 /*******************************************************************************
  * The SPD should know the type of Secure Payload.
  ******************************************************************************/
@@ -151,6 +188,7 @@
 #ifndef __ASSEMBLY__
 
 #include <cassert.h>
+#include <cpu_data.h>
 #include <stdint.h>
 
 /*
@@ -199,6 +237,21 @@ CASSERT(TSPD_SP_CTX_SIZE == sizeof(sp_ctx_regs_t),	\
  *                    routed NS interrupt and when a Secure Interrupt is taken
  *                    to SP.
  ******************************************************************************/
+#if TSP_INTR_LATENCY_BENCH
+/*
+ * Number of buckets of the S-EL1 interrupt latency histograms. Bucket 'n'
+ * counts the latencies of 2^(n - 1) to 2^n - 1 system counter ticks and the
+ * last bucket all the longer ones.
+ */
+#define TSPD_INTR_LAT_BUCKETS		16
+
+/* Points of the handling of a S-EL1 interrupt whose latency is measured */
+#define TSPD_INTR_LAT_EL3_ENTRY		0
+#define TSPD_INTR_LAT_SEL1_ENTRY	1
+#define TSPD_INTR_LAT_NS_RETURN		2
+#define TSPD_INTR_LAT_STAGES		3
+#endif
+
 typedef struct tsp_context {
 	uint64_t saved_elr_el3;
 	uint32_t saved_spsr_el3;
@@ -207,9 +260,22 @@ typedef struct tsp_context {
 	uint64_t c_rt_ctx;
 	cpu_context_t cpu_ctx;
 	uint64_t saved_tsp_args[TSP_NUM_ARGS];
+	/* Number of times a standard SMC has been preempted on this cpu */
+	uint32_t preempt_count;
+#if TSPD_SEL1_INTR_COALESCE
+	/* S-EL1 interrupts handled so far in the current burst */
+	uint32_t intr_burst;
+	/* S-EL1 interrupts handled without returning to the normal world */
+	uint32_t intr_coalesce_count;
+#endif
 #if TSP_NS_INTR_ASYNC_PREEMPT
 	sp_ctx_regs_t sp_ctx;
 #endif
+#if TSP_INTR_LATENCY_BENCH
+	/* Counter value at which the S-EL1 interrupt being handled fired */
+	uint64_t intr_gen_ts;
+	uint32_t intr_lat_hist[TSPD_INTR_LAT_STAGES][TSPD_INTR_LAT_BUCKETS];
+#endif
 } tsp_context_t;
 
 /* Helper macros to store and retrieve tsp args from tsp_context */
@@ -243,8 +309,9 @@ void tspd_init_tsp_ep_state(struct entry_point_info *tsp_ep,
 				uint64_t pc,
 				tsp_context_t *tsp_ctx);
 
-extern tsp_context_t tspd_sp_context[TSPD_CORE_COUNT];
+DECLARE_PERCPU(tsp_context_t, tspd_sp_context);
 extern struct tsp_vectors *tsp_vectors;
+extern uint32_t tspd_pm_notify_lvl;
 #endif /*__ASSEMBLY__*/
 
 #endif /* __TSPD_PRIVATE_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -35,6 +35,7 @@
 #include <context.h>
 #include <context_mgmt.h>
 #include <debug.h>
+#include <errata_report.h>
 #include <platform.h>
 #include <string.h>
 #include "psci_private.h"
@@ -46,39 +47,38 @@
 const spd_pm_ops_t *psci_spd_pm;
 
 /*
- * PSCI requested local power state map. This array is used to store the local
- * power states requested by a CPU for power levels from level 1 to
- * PLAT_MAX_PWR_LVL. It does not store the requested local power state for power
- * level 0 (PSCI_CPU_PWR_LVL) as the requested and the target power state for a
- * CPU are the same.
+ * The local power states requested by a CPU for power levels from level 1 to
+ * PLAT_MAX_PWR_LVL are stored in its per-cpu data, so that CPUs suspending at
+ * the same time do not write to the same cache lines. The requested local
+ * power state for power level 0 (PSCI_CPU_PWR_LVL) is not stored as the
+ * requested and the target power state for a CPU are the same.
  *
  * During state coordination, the platform is passed an array containing the
  * local states requested for a particular non cpu power domain by each cpu
- * within the domain.
- *
- * TODO: Dense packing of the requested states will cause cache thrashing
- * when multiple power domains write to it. If we allocate the requested
- * states at each power level in a cache-line aligned per-domain memory,
- * the cache thrashing can be avoided.
+ * within the domain, which is gathered from the per-cpu data.
  */
-static plat_local_state_t
-	psci_req_local_pwr_states[PLAT_MAX_PWR_LVL][PLATFORM_CORE_COUNT];
-
 
 /*******************************************************************************
  * Arrays that hold the platform's power domain tree information for state
  * management of power domains.
  * Each node in the array 'psci_non_cpu_pd_nodes' corresponds to a power domain
- * which is an ancestor of a CPU power domain.
+ * which is an ancestor of a CPU power domain. Its local power state is held at
+ * the same index in 'psci_non_cpu_pd_states'.
  * Each node in the array 'psci_cpu_pd_nodes' corresponds to a cpu power domain
  ******************************************************************************/
-non_cpu_pd_node_t psci_non_cpu_pd_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS]
+non_cpu_pd_node_t psci_non_cpu_pd_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+
+non_cpu_pd_state_t psci_non_cpu_pd_states[PSCI_NUM_NON_CPU_PWR_DOMAINS]
 #if USE_COHERENT_MEM
 __section("tzfw_coherent_mem")
 #endif
 ;
 
+#if HW_ASSISTED_COHERENCY
+psci_ticket_lock_t psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+#else
 DEFINE_BAKERY_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
+#endif
 
 cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
 
@@ -87,6 +87,24 @@ cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
  ******************************************************************************/
 const plat_psci_ops_t *psci_plat_pm_ops;
 
+#if PSCI_OS_INIT_MODE
+/*******************************************************************************
+ * Suspend mode selected through PSCI_SET_SUSPEND_MODE. Power domain states are
+ * coordinated by the platform until the OS selects OS-initiated mode.
+ ******************************************************************************/
+unsigned int psci_suspend_mode = PSCI_MODE_PC;
+#endif
+
+/*******************************************************************************
+ * Number of cpus whose affinity info state is not OFF, plus the parked cpus
+ * which are OFF for PSCI but still executing. It is updated atomically by the
+ * cpu which changes the affinity info state of a cpu from or to OFF, while its
+ * data cache is enabled. A cpu turning itself off is therefore no longer
+ * counted once it can no longer fail to power down, but before it updates its
+ * affinity info state with the data cache disabled.
+ ******************************************************************************/
+volatile uint32_t psci_cpus_on_count;
+
 /******************************************************************************
  * Check that the maximum power level supported by the platform makes sense
  *****************************************************************************/
@@ -171,19 +189,10 @@ void psci_query_sys_suspend_pwrstate(psci_power_state_t *state_info)
  ******************************************************************************/
 unsigned int psci_is_last_on_cpu(void)
 {
-	unsigned int cpu_idx, my_idx = plat_my_core_pos();
-
-	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
-		if (cpu_idx == my_idx) {
-			assert(psci_get_aff_info_state() == AFF_STATE_ON);
-			continue;
-		}
+	assert(psci_get_aff_info_state() == AFF_STATE_ON);
+	assert(psci_cpus_on_count != 0);
 
-		if (psci_get_aff_info_state_by_idx(cpu_idx) != AFF_STATE_OFF)
-			return 0;
-	}
-
-	return 1;
+	return psci_cpus_on_count == 1;
 }
 
 /*******************************************************************************
@@ -217,33 +226,38 @@ static void psci_set_req_local_pwr_state(unsigned int pwrlvl,
 					 plat_local_state_t req_pwr_state)
 {
 	assert(pwrlvl > PSCI_CPU_PWR_LVL);
-	psci_req_local_pwr_states[pwrlvl - 1][cpu_idx] = req_pwr_state;
+	set_cpu_data_by_index(cpu_idx,
+			      psci_svc_cpu_data.req_local_state[pwrlvl - 1],
+			      req_pwr_state);
 }
 
 /******************************************************************************
- * This function initializes the psci_req_local_pwr_states.
+ * This function initializes the requested local power states of all CPUs.
  *****************************************************************************/
 void psci_init_req_local_pwr_states(void)
 {
+	unsigned int cpu_idx, lvl;
+
 	/* Initialize the requested state of all non CPU power domains as OFF */
-	memset(&psci_req_local_pwr_states, PLAT_MAX_OFF_STATE,
-			sizeof(psci_req_local_pwr_states));
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= PLAT_MAX_PWR_LVL; lvl++)
+			psci_set_req_local_pwr_state(lvl, cpu_idx,
+						     PLAT_MAX_OFF_STATE);
+	}
 }
 
 /******************************************************************************
- * Helper function to return a reference to an array containing the local power
- * states requested by each cpu for a power domain at 'pwrlvl'. The size of the
- * array will be the number of cpu power domains of which this power domain is
- * an ancestor. These requested states will be used to determine a suitable
- * target state for this power domain during psci state coordination. An
- * assertion is added to prevent us from accessing the CPU power level.
+ * Helper function to return the local power state requested by the cpu at
+ * 'cpu_idx' for its ancestor power domain at 'pwrlvl'. An assertion is added
+ * to prevent us from accessing the CPU power level.
  *****************************************************************************/
-static plat_local_state_t *psci_get_req_local_pwr_states(unsigned int pwrlvl,
-							 unsigned int cpu_idx)
+static plat_local_state_t psci_get_req_local_pwr_state(unsigned int pwrlvl,
+						       unsigned int cpu_idx)
 {
 	assert(pwrlvl > PSCI_CPU_PWR_LVL);
 
-	return &psci_req_local_pwr_states[pwrlvl - 1][cpu_idx];
+	return get_cpu_data_by_index(cpu_idx,
+			psci_svc_cpu_data.req_local_state[pwrlvl - 1]);
 }
 
 /******************************************************************************
@@ -259,23 +273,23 @@ static void psci_get_target_local_pwr_states(unsigned int end_pwrlvl,
 	plat_local_state_t *pd_state = target_state->pwr_domain_state;
 
 	pd_state[PSCI_CPU_PWR_LVL] = psci_get_cpu_local_state();
-	parent_idx = psci_cpu_pd_nodes[plat_my_core_pos()].parent_node;
+	parent_idx = psci_cpu_parent_node(plat_my_core_pos());
 
 	/* Copy the local power state from node to state_info */
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
 #if !USE_COHERENT_MEM
 		/*
-		 * If using normal memory for psci_non_cpu_pd_nodes, we need
+		 * If using normal memory for psci_non_cpu_pd_states, we need
 		 * to flush before reading the local power state as another
 		 * cpu in the same power domain could have updated it and this
 		 * code runs before caches are enabled.
 		 */
 		flush_dcache_range(
-				(uintptr_t) &psci_non_cpu_pd_nodes[parent_idx],
-				sizeof(psci_non_cpu_pd_nodes[parent_idx]));
+				(uintptr_t) &psci_non_cpu_pd_states[parent_idx],
+				sizeof(psci_non_cpu_pd_states[parent_idx]));
 #endif
-		pd_state[lvl] =	psci_non_cpu_pd_nodes[parent_idx].local_state;
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		pd_state[lvl] =	psci_non_cpu_pd_states[parent_idx].local_state;
+		parent_idx = psci_node_parent_node(parent_idx);
 	}
 
 	/* Set the the higher levels to RUN */
@@ -301,20 +315,22 @@ static void psci_set_target_local_pwr_states(unsigned int end_pwrlvl,
 	 * Need to flush as local_state will be accessed with Data Cache
 	 * disabled during power on
 	 */
-	flush_cpu_data(psci_svc_cpu_data.local_state);
+	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
 
-	parent_idx = psci_cpu_pd_nodes[plat_my_core_pos()].parent_node;
+	parent_idx = psci_cpu_parent_node(plat_my_core_pos());
 
 	/* Copy the local_state from state_info */
 	for (lvl = 1; lvl <= end_pwrlvl; lvl++) {
-		psci_non_cpu_pd_nodes[parent_idx].local_state =	pd_state[lvl];
+		psci_non_cpu_pd_states[parent_idx].local_state = pd_state[lvl];
 #if !USE_COHERENT_MEM
 		flush_dcache_range(
-				(uintptr_t)&psci_non_cpu_pd_nodes[parent_idx],
-				sizeof(psci_non_cpu_pd_nodes[parent_idx]));
+				(uintptr_t)&psci_non_cpu_pd_states[parent_idx],
+				sizeof(psci_non_cpu_pd_states[parent_idx]));
 #endif
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		parent_idx = psci_node_parent_node(parent_idx);
 	}
+
+	psci_export_states(end_pwrlvl);
 }
 
 
@@ -325,12 +341,12 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int end_lvl,
 				      unsigned int node_index[])
 {
-	unsigned int parent_node = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	unsigned int parent_node = psci_cpu_parent_node(cpu_idx);
 	int i;
 
 	for (i = PSCI_CPU_PWR_LVL + 1; i <= end_lvl; i++) {
 		*node_index++ = parent_node;
-		parent_node = psci_non_cpu_pd_nodes[parent_node].parent_node;
+		parent_node = psci_node_parent_node(parent_node);
 	}
 }
 
@@ -342,28 +358,42 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
 {
 	unsigned int parent_idx, cpu_idx = plat_my_core_pos(), lvl;
-	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	parent_idx = psci_cpu_parent_node(cpu_idx);
 
 	/* Reset the local_state to RUN for the non cpu power domains. */
 	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
-		psci_non_cpu_pd_nodes[parent_idx].local_state =
+		psci_non_cpu_pd_states[parent_idx].local_state =
 				PSCI_LOCAL_STATE_RUN;
 #if !USE_COHERENT_MEM
 		flush_dcache_range(
-				(uintptr_t) &psci_non_cpu_pd_nodes[parent_idx],
-				sizeof(psci_non_cpu_pd_nodes[parent_idx]));
+				(uintptr_t) &psci_non_cpu_pd_states[parent_idx],
+				sizeof(psci_non_cpu_pd_states[parent_idx]));
 #endif
 		psci_set_req_local_pwr_state(lvl,
 					     cpu_idx,
 					     PSCI_LOCAL_STATE_RUN);
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		parent_idx = psci_node_parent_node(parent_idx);
 	}
 
-	/* Set the affinity info state to ON */
-	psci_set_aff_info_state(AFF_STATE_ON);
+	/*
+	 * Set the affinity info state to ON. It is read with the data cache
+	 * disabled on the next power up, so it is flushed when it changes,
+	 * i.e. after a CPU_ON. It is already ON in memory on resume from
+	 * suspend.
+	 */
+	if (psci_get_aff_info_state() != AFF_STATE_ON) {
+		psci_set_aff_info_state(AFF_STATE_ON);
+		psci_flush_cpu_data(psci_svc_cpu_data.aff_info_state);
+	}
 
+	/*
+	 * The local state is flushed by psci_set_target_local_pwr_states()
+	 * before this cpu powers down again, which is the next time it is
+	 * read with the data cache disabled.
+	 */
 	psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
-	flush_cpu_data(psci_svc_cpu_data);
+
+	psci_export_states(end_pwrlvl);
 }
 
 /******************************************************************************
@@ -390,11 +420,11 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info)
 {
 	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
-	unsigned int start_idx, ncpus;
-	plat_local_state_t target_state, *req_states;
+	unsigned int i, start_idx, ncpus;
+	plat_local_state_t target_state, req_states[PLATFORM_CORE_COUNT];
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
-	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	parent_idx = psci_cpu_parent_node(cpu_idx);
 
 	/* For level 0, the requested state will be equivalent
 	   to target state */
@@ -405,14 +435,16 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 					     state_info->pwr_domain_state[lvl]);
 
 		/* Get the requested power states for this power level */
-		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
-		req_states = psci_get_req_local_pwr_states(lvl, start_idx);
+		start_idx = psci_node_cpu_start_idx(parent_idx);
+		ncpus = psci_node_ncpus(parent_idx);
+		for (i = 0; i < ncpus; i++)
+			req_states[i] = psci_get_req_local_pwr_state(lvl,
+							start_idx + i);
 
 		/*
 		 * Let the platform coordinate amongst the requested states at
 		 * this power level and return the target local power state.
 		 */
-		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
 		target_state = plat_get_target_pwr_state(lvl,
 							 req_states,
 							 ncpus);
@@ -423,7 +455,7 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 		if (is_local_state_run(state_info->pwr_domain_state[lvl]))
 			break;
 
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		parent_idx = psci_node_parent_node(parent_idx);
 	}
 
 	/*
@@ -443,6 +475,163 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
 }
 
+#if PSCI_RESIDENCY_PREDICTOR
+/******************************************************************************
+ * This function records in the per-cpu data of the calling cpu the system
+ * counter value at which the earliest enabled and unmasked EL1 timer of the
+ * normal world fires, or ~0 if there is none. These timers are still those of
+ * the normal world on entry to CPU_SUSPEND.
+ *****************************************************************************/
+void psci_record_next_wakeup(void)
+{
+	uint64_t ctl, cval, next_wakeup = ~0ULL;
+
+	ctl = read_cntp_ctl_el0();
+	if (get_cntp_ctl_enable(ctl) && !get_cntp_ctl_imask(ctl))
+		next_wakeup = read_cntp_cval_el0();
+
+	/* The virtual counter is the physical one minus the virtual offset */
+	ctl = read_cntv_ctl_el0();
+	if (get_cntp_ctl_enable(ctl) && !get_cntp_ctl_imask(ctl)) {
+		cval = read_cntv_cval_el0() + read_cntvoff_el2();
+		if (cval < next_wakeup)
+			next_wakeup = cval;
+	}
+
+	set_cpu_data(psci_svc_cpu_data.next_wakeup, next_wakeup);
+}
+
+/******************************************************************************
+ * This function returns the time in microseconds until the earliest timer event
+ * recorded by the cpus of the non cpu power domain 'parent_idx' which are not
+ * OFF, or ~0 if there is none.
+ *****************************************************************************/
+static uint64_t psci_predict_residency(unsigned int parent_idx, uint64_t now)
+{
+	unsigned int i, start_idx, ncpus;
+	uint64_t wakeup, next_wakeup = ~0ULL, ticks, freq;
+
+	start_idx = psci_node_cpu_start_idx(parent_idx);
+	ncpus = psci_node_ncpus(parent_idx);
+	for (i = start_idx; i < start_idx + ncpus; i++) {
+		if (psci_get_aff_info_state_by_idx(i) == AFF_STATE_OFF)
+			continue;
+
+		wakeup = get_cpu_data_by_index(i, psci_svc_cpu_data.next_wakeup);
+		if (wakeup < next_wakeup)
+			next_wakeup = wakeup;
+	}
+
+	if (next_wakeup == ~0ULL)
+		return ~0ULL;
+
+	if (next_wakeup <= now)
+		return 0;
+
+	/* Convert the ticks to microseconds without overflowing */
+	ticks = next_wakeup - now;
+	freq = read_cntfrq_el0();
+	return (ticks / freq) * 1000000 + ((ticks % freq) * 1000000) / freq;
+}
+
+/******************************************************************************
+ * This function lets the platform reconsider the coordinated target states in
+ * 'state_info' of the power domains from level 1 up to 'end_pwrlvl' according
+ * to their predicted residency, see plat_get_predicted_pwr_state(). A power
+ * domain is never left in a deeper state than its child in the path of the
+ * calling cpu, so the power domains above a demoted one are demoted as well.
+ * It must be called after psci_do_state_coordination(), with the locks of
+ * these power domains held.
+ *****************************************************************************/
+void psci_predict_pwr_states(unsigned int end_pwrlvl,
+			     psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, demoted = 0;
+	plat_local_state_t target_state, child_state;
+	uint64_t now = read_cntpct_el0();
+
+	parent_idx = psci_cpu_parent_node(plat_my_core_pos());
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
+		target_state = state_info->pwr_domain_state[lvl];
+		if (is_local_state_run(target_state))
+			break;
+
+		child_state = state_info->pwr_domain_state[lvl - 1];
+		if (target_state > child_state)
+			target_state = child_state;
+
+		if (is_local_state_off(target_state))
+			target_state = plat_get_predicted_pwr_state(lvl,
+					target_state,
+					psci_predict_residency(parent_idx, now));
+
+		if (target_state != state_info->pwr_domain_state[lvl]) {
+			state_info->pwr_domain_state[lvl] = target_state;
+			demoted = 1;
+		}
+
+		parent_idx = psci_node_parent_node(parent_idx);
+	}
+
+	/* Update the target state in the power domain nodes */
+	if (demoted)
+		psci_set_target_local_pwr_states(end_pwrlvl, state_info);
+}
+#endif
+
+#if PSCI_OS_INIT_MODE
+/******************************************************************************
+ * In OS-initiated mode, the states requested by a CPU for its ancestor power
+ * domains up to 'end_pwrlvl' are their target states, as the OS only requests
+ * a low power state for a power domain from the last CPU of the power domain to
+ * suspend. This function verifies that no other CPU of these power domains is
+ * running, in which case it returns PSCI_E_DENIED. Otherwise, it records the
+ * requested states as the target states of the power domains without calling
+ * the platform coordination.
+ *
+ * This function will only be invoked with the locks of the power domains up
+ * to 'end_pwrlvl' held, with data cache enabled and while powering down a core.
+ *****************************************************************************/
+int psci_do_os_init_coordination(unsigned int end_pwrlvl,
+				 const psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	unsigned int i, start_idx, ncpus;
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+	parent_idx = psci_cpu_parent_node(cpu_idx);
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
+		if (is_local_state_run(state_info->pwr_domain_state[lvl]))
+			break;
+
+		start_idx = psci_node_cpu_start_idx(parent_idx);
+		ncpus = psci_node_ncpus(parent_idx);
+
+		for (i = start_idx; i < start_idx + ncpus; i++) {
+			if (i != cpu_idx && is_local_state_run(
+					psci_get_cpu_local_state_by_idx(i)))
+				return PSCI_E_DENIED;
+		}
+
+		parent_idx = psci_node_parent_node(parent_idx);
+	}
+
+	/*
+	 * Keep the requested states up to date so that platform coordination
+	 * finds them consistent if the OS switches back to it.
+	 */
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++)
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     state_info->pwr_domain_state[lvl]);
+
+	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
+
+	return PSCI_E_SUCCESS;
+}
+#endif
+
 /******************************************************************************
  * This function validates a suspend request by making sure that if a standby
  * state is requested then no power level is turned off and the highest power
@@ -522,6 +711,28 @@ unsigned int psci_find_max_off_lvl(const psci_power_state_t *state_info)
 	return PSCI_INVALID_PWR_LVL;
 }
 
+/******************************************************************************
+ * This function finds the power level passed to
+ * psci_do_pwrdown_cache_maintenance() for the power down to the state
+ * specified in the 'state_info' structure. It is the highest power level which
+ * will be powered down, unless the platform reports that the caches of some of
+ * the levels being powered down are retained, e.g. a cluster which keeps its
+ * L2 cache in retention while the cluster logic is off.
+ *****************************************************************************/
+unsigned int psci_find_pwr_down_cache_lvl(const psci_power_state_t *state_info)
+{
+	unsigned int max_off_lvl = psci_find_max_off_lvl(state_info);
+	unsigned int cache_lvl;
+
+	if (!psci_plat_pm_ops->get_pwr_down_cache_lvl)
+		return max_off_lvl;
+
+	cache_lvl = psci_plat_pm_ops->get_pwr_down_cache_lvl(state_info);
+	assert(cache_lvl <= max_off_lvl);
+
+	return cache_lvl;
+}
+
 /******************************************************************************
  * This functions finds the level of the highest power domain which will be
  * placed in a low power state during a suspend operation.
@@ -546,13 +757,13 @@ unsigned int psci_find_target_suspend_lvl(const psci_power_state_t *state_info)
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 				   unsigned int cpu_idx)
 {
-	unsigned int parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	unsigned int parent_idx = psci_cpu_parent_node(cpu_idx);
 	unsigned int level;
 
 	/* No locking required for level 0. Hence start locking from level 1 */
 	for (level = PSCI_CPU_PWR_LVL + 1; level <= end_pwrlvl; level++) {
 		psci_lock_get(&psci_non_cpu_pd_nodes[parent_idx]);
-		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+		parent_idx = psci_node_parent_node(parent_idx);
 	}
 }
 
@@ -688,6 +899,16 @@ void psci_power_up_finish(void)
 	unsigned int end_pwrlvl, cpu_idx = plat_my_core_pos();
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
 
+#if SMC_LATENCY_STATS
+	/* Do not account the time this CPU has spent powered down */
+	smc_stats_discard();
+#endif
+
+#if PSCI_PARK_SECONDARIES
+	/* Wait for a CPU_ON if we have been powered on at cold boot */
+	psci_park_wait();
+#endif
+
 	/*
 	 * Verify that we have been explicitly turned ON or resumed from
 	 * suspend.
@@ -730,6 +951,15 @@ void psci_power_up_finish(void)
 	else
 		psci_cpu_suspend_finish(cpu_idx, &state_info);
 
+	/* The data cache has been enabled by the finishers above */
+#if REPORT_ERRATA
+	errata_report_record();
+#endif
+#if ENABLE_PSCI_STAT
+	psci_stats_update_pwr_up(end_pwrlvl, &state_info);
+#endif
+	psci_trace(PSCI_TRACE_WAKEUP, psci_trace_states(&state_info));
+
 	/*
 	 * Set the requested and target state of this CPU and all the higher
 	 * power domains which are ancestors of this CPU to run.
@@ -744,6 +974,27 @@ void psci_power_up_finish(void)
 				      cpu_idx);
 }
 
+#if EL3_HANG_DETECT
+/*******************************************************************************
+ * This function marks the calling CPU as no longer executing in EL3 just before
+ * it enters the final wfi of a power down, so that the time spent powered down
+ * is not taken for a hang. Its data cache is disabled by then, so the progress
+ * record is written to main memory with the same cache maintenance as the
+ * affinity info state in psci_do_cpu_off().
+ ******************************************************************************/
+void psci_progress_pwrdown(void)
+{
+#if HW_ASSISTED_COHERENCY
+	el3_progress(EL3_PROGRESS_IDLE, 0);
+#else
+	flush_cpu_data(el3_progress);
+	el3_progress(EL3_PROGRESS_IDLE, 0);
+	dsbish();
+	inv_cpu_data(el3_progress);
+#endif
+}
+#endif
+
 /*******************************************************************************
  * This function initializes the set of hooks that PSCI invokes as part of power
  * management operation. The power management hooks are expected to be provided
@@ -807,13 +1058,13 @@ void psci_print_power_domain_map(void)
 	for (idx = 0; idx < (PSCI_NUM_PWR_DOMAINS - PLATFORM_CORE_COUNT);
 							idx++) {
 		state_type = find_local_state_type(
-				psci_non_cpu_pd_nodes[idx].local_state);
+				psci_non_cpu_pd_states[idx].local_state);
 		INFO("  Domain Node : Level %u, parent_node %d,"
 				" State %s (0x%x)\n",
 				psci_non_cpu_pd_nodes[idx].level,
 				psci_non_cpu_pd_nodes[idx].parent_node,
 				psci_state_type_str[state_type],
-				psci_non_cpu_pd_nodes[idx].local_state);
+				psci_non_cpu_pd_states[idx].local_state);
 	}
 
 	for (idx = 0; idx < PLATFORM_CORE_COUNT; idx++) {
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci_export.h>
+#include <runtime_svc.h>
+#include <spinlock.h>
+#include <xlat_tables.h>
+#include "psci_private.h"
+
+/* Size of the exported page contents */
+#define PSCI_EXPORT_SIZE	(sizeof(psci_export_hdr_t) +		\
+				 PLATFORM_CORE_COUNT *			\
+				 sizeof(psci_export_cpu_t) +		\
+				 PSCI_NUM_NON_CPU_PWR_DOMAINS *		\
+				 sizeof(psci_export_node_t))
+
+/* Page registered by the normal world, mapped flat, NULL if none */
+static psci_export_hdr_t *psci_export_page;
+static uint64_t psci_export_page_size;
+
+/*
+ * Sequence number of the page. It is kept in secure memory as the normal world
+ * may change the copy in the page.
+ */
+static uint64_t psci_export_seq;
+
+/*
+ * Lock serialising the updates of the page, and of the translation tables on
+ * registration.
+ */
+static spinlock_t psci_export_lock;
+
+static inline psci_export_cpu_t *psci_export_cpus(psci_export_hdr_t *hdr)
+{
+	return (psci_export_cpu_t *)(hdr + 1);
+}
+
+static inline psci_export_node_t *psci_export_nodes(psci_export_hdr_t *hdr)
+{
+	return (psci_export_node_t *)(psci_export_cpus(hdr) +
+				      PLATFORM_CORE_COUNT);
+}
+
+/*
+ * Open and close a seqlock write section of the page. They must be called
+ * with psci_export_lock held.
+ */
+static void psci_export_write_begin(psci_export_hdr_t *hdr)
+{
+	hdr->seq = ++psci_export_seq;
+	dmbst();
+}
+
+static void psci_export_write_end(psci_export_hdr_t *hdr)
+{
+	dmbst();
+	hdr->seq = ++psci_export_seq;
+}
+
+/*******************************************************************************
+ * This function publishes the local states of the calling CPU and of its
+ * ancestors up to 'end_pwrlvl' to the page registered by the normal world, if
+ * any. It must be called with the data cache enabled, after the states have
+ * been updated, and with the locks of the power levels up to 'end_pwrlvl' held
+ * so that the updates of a power domain are published in order.
+ ******************************************************************************/
+void psci_export_states(unsigned int end_pwrlvl)
+{
+	unsigned int cpu_idx = plat_my_core_pos(), parent_idx, lvl;
+	psci_export_hdr_t *hdr;
+	psci_export_node_t *nodes;
+
+	/*
+	 * Order the updates of the states before the read of the page pointer,
+	 * as psci_export_register() sets the latter before it reads the former.
+	 */
+	dmbish();
+	if (psci_export_page == NULL)
+		return;
+
+	spin_lock(&psci_export_lock);
+
+	hdr = psci_export_page;
+	if (hdr) {
+		nodes = psci_export_nodes(hdr);
+		parent_idx = psci_cpu_parent_node(cpu_idx);
+
+		psci_export_write_begin(hdr);
+
+		psci_export_cpus(hdr)[cpu_idx].local_state =
+			psci_get_cpu_local_state();
+
+		for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
+			nodes[parent_idx].local_state =
+				psci_non_cpu_pd_states[parent_idx].local_state;
+			parent_idx = psci_node_parent_node(parent_idx);
+		}
+
+		psci_export_write_end(hdr);
+	}
+
+	spin_unlock(&psci_export_lock);
+}
+
+/*******************************************************************************
+ * This function writes the topology and the current local states of all the
+ * power domains to the page. It must be called with psci_export_lock held.
+ ******************************************************************************/
+static void psci_export_fill(psci_export_hdr_t *hdr)
+{
+	psci_export_cpu_t *cpus = psci_export_cpus(hdr);
+	psci_export_node_t *nodes = psci_export_nodes(hdr);
+	unsigned int i;
+
+	psci_export_write_begin(hdr);
+
+	hdr->num_cpus = PLATFORM_CORE_COUNT;
+	hdr->num_nodes = PSCI_NUM_NON_CPU_PWR_DOMAINS;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		cpus[i].mpidr = psci_cpu_pd_nodes[i].mpidr;
+		cpus[i].parent_node = psci_cpu_parent_node(i);
+		cpus[i].local_state = psci_get_cpu_local_state_by_idx(i);
+		cpus[i].reserved[0] = 0;
+		cpus[i].reserved[1] = 0;
+		cpus[i].reserved[2] = 0;
+	}
+
+	for (i = 0; i < PSCI_NUM_NON_CPU_PWR_DOMAINS; i++) {
+		nodes[i].parent_node = psci_node_parent_node(i);
+		nodes[i].level = psci_non_cpu_pd_nodes[i].level;
+		nodes[i].local_state = psci_non_cpu_pd_states[i].local_state;
+		nodes[i].reserved = 0;
+	}
+
+	psci_export_write_end(hdr);
+}
+
+/*******************************************************************************
+ * Register the page at 'pa' of 'size' bytes, replacing the page registered
+ * previously if any. A 'pa' of 0 only unregisters the latter. The page is
+ * mapped as Non-secure memory so the normal world cannot make EL3 write to
+ * secure memory through it.
+ ******************************************************************************/
+static int psci_export_register(uint64_t pa, uint64_t size)
+{
+	int rc = 0;
+
+	if (pa && ((pa & PAGE_SIZE_MASK) || (size & PAGE_SIZE_MASK) ||
+		   (size < PSCI_EXPORT_SIZE) || (pa + size < pa)))
+		return PSCI_EXPORT_E_INVALID;
+
+	spin_lock(&psci_export_lock);
+
+	if (psci_export_page) {
+		rc = mmap_remove_dynamic_region((uintptr_t)psci_export_page,
+						psci_export_page_size);
+		assert(rc == 0);
+		psci_export_page = NULL;
+		psci_export_page_size = 0;
+	}
+
+	if (pa) {
+		rc = mmap_add_dynamic_region(pa, pa, size,
+					     MT_MEMORY | MT_RW | MT_NS);
+		if (rc == 0) {
+			psci_export_page = (psci_export_hdr_t *)pa;
+			psci_export_page_size = size;
+
+			/*
+			 * Order the setting of the page pointer before the
+			 * reads of the states. See psci_export_states().
+			 */
+			dmbish();
+			psci_export_fill(psci_export_page);
+		}
+	}
+
+	spin_unlock(&psci_export_lock);
+
+	return rc ? PSCI_EXPORT_E_INVALID : 0;
+}
+
+/*******************************************************************************
+ * SiP handler of the PSCI_EXPORT_REGISTER call.
+ ******************************************************************************/
+uint64_t psci_export_smc_handler(uint32_t smc_fid,
+				 uint64_t x1,
+				 uint64_t x2,
+				 uint64_t x3,
+				 uint64_t x4,
+				 void *cookie,
+				 void *handle,
+				 uint64_t flags)
+{
+	if ((smc_fid != PSCI_EXPORT_REGISTER) || is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	SMC_RET4(handle, psci_export_register(x1, x2), PLATFORM_CORE_COUNT,
+		 PSCI_NUM_NON_CPU_PWR_DOMAINS, PSCI_EXPORT_SIZE);
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci_latency.h>
+#include <runtime_svc.h>
+#include "psci_private.h"
+
+/* Latencies measured for a local state, in system counter ticks */
+typedef struct psci_latency_stat {
+	uint32_t entry_max;
+	uint32_t exit_max;
+	uint32_t count;
+} psci_latency_stat_t;
+
+/*
+ * The measurements of each CPU are indexed by the deepest power level which is
+ * not RUN and by 'local state - 1'. They are only written by their CPU, with
+ * the data cache enabled.
+ */
+typedef struct psci_latency_cpu {
+	/* Time at which the current CPU_SUSPEND call started */
+	uint64_t suspend_ts;
+	psci_latency_stat_t stats[PLAT_MAX_PWR_LVL + 1][PLAT_MAX_OFF_STATE];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_latency_cpu_t;
+
+static psci_latency_cpu_t psci_latency_cpus[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * This function returns the measurements of the calling CPU for the states in
+ * 'state_info'.
+ ******************************************************************************/
+static psci_latency_stat_t *psci_latency_get_stat(
+				const psci_power_state_t *state_info)
+{
+	unsigned int lvl = PLAT_MAX_PWR_LVL;
+	plat_local_state_t state;
+
+	while (lvl > PSCI_CPU_PWR_LVL &&
+	       is_local_state_run(state_info->pwr_domain_state[lvl]))
+		lvl--;
+
+	state = state_info->pwr_domain_state[lvl];
+	assert(state > PSCI_LOCAL_STATE_RUN && state <= PLAT_MAX_OFF_STATE);
+
+	return &psci_latency_cpus[plat_my_core_pos()].stats[lvl][state - 1];
+}
+
+static uint32_t psci_latency_ticks(uint64_t ticks)
+{
+	return (ticks > UINT32_MAX) ? UINT32_MAX : ticks;
+}
+
+static uint32_t psci_latency_ticks_to_us(uint32_t ticks)
+{
+	return ((uint64_t)ticks * 1000000) / read_cntfrq_el0();
+}
+
+/*******************************************************************************
+ * This function records the start of a CPU_SUSPEND call on the calling CPU.
+ ******************************************************************************/
+void psci_latency_suspend_start(void)
+{
+	psci_latency_cpus[plat_my_core_pos()].suspend_ts = read_cntpct_el0();
+}
+
+/*******************************************************************************
+ * This function records the entry latency of the states in 'state_info' once
+ * the calling CPU is ready to enter them. It must be called with the data
+ * cache enabled, i.e. before the caches are flushed for a power down state.
+ ******************************************************************************/
+void psci_latency_record_entry(const psci_power_state_t *state_info)
+{
+	psci_latency_cpu_t *cpu = &psci_latency_cpus[plat_my_core_pos()];
+	psci_latency_stat_t *stat = psci_latency_get_stat(state_info);
+	uint32_t ticks;
+
+	ticks = psci_latency_ticks(read_cntpct_el0() - cpu->suspend_ts);
+	if (ticks > stat->entry_max)
+		stat->entry_max = ticks;
+	stat->count++;
+}
+
+/*******************************************************************************
+ * This function records the exit latency of the states in 'state_info' which
+ * the calling CPU has woken up from, if the wakeup is due to the timer event
+ * recorded by psci_record_next_wakeup(). It must be called with the data cache
+ * enabled.
+ ******************************************************************************/
+void psci_latency_record_exit(const psci_power_state_t *state_info)
+{
+	psci_latency_stat_t *stat;
+	uint64_t now = read_cntpct_el0(), next_wakeup;
+	uint32_t ticks;
+
+	/* An earlier wakeup was not caused by the timer */
+	next_wakeup = get_cpu_data(psci_svc_cpu_data.next_wakeup);
+	if (next_wakeup == ~0ULL || now < next_wakeup)
+		return;
+
+	stat = psci_latency_get_stat(state_info);
+	ticks = psci_latency_ticks(now - next_wakeup);
+	if (ticks > stat->exit_max)
+		stat->exit_max = ticks;
+}
+
+/*******************************************************************************
+ * SiP handler of the PSCI_LATENCY_READ call.
+ ******************************************************************************/
+uint64_t psci_latency_smc_handler(uint32_t smc_fid,
+				  uint64_t x1,
+				  uint64_t x2,
+				  uint64_t x3,
+				  uint64_t x4,
+				  void *cookie,
+				  void *handle,
+				  uint64_t flags)
+{
+	const plat_state_latency_t *lat;
+	const psci_latency_stat_t *stat;
+	uint64_t declared = 0, residency = 0;
+
+	if ((smc_fid != PSCI_LATENCY_READ) || is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	if ((x1 >= PLATFORM_CORE_COUNT) || (x2 > PLAT_MAX_PWR_LVL) ||
+	    (x3 == PSCI_LOCAL_STATE_RUN) || (x3 > PLAT_MAX_OFF_STATE))
+		SMC_RET1(handle, PSCI_LATENCY_E_INVALID);
+
+	lat = plat_get_state_latency(x2, x3);
+	if (lat) {
+		declared = ((uint64_t)lat->exit_us << 32) | lat->entry_us;
+		residency = lat->min_residency_us;
+	}
+
+	stat = &psci_latency_cpus[x1].stats[x2][x3 - 1];
+
+	SMC_RET4(handle, 0, declared,
+		 ((uint64_t)stat->count << 32) | residency,
+		 ((uint64_t)psci_latency_ticks_to_us(stat->exit_max) << 32) |
+		 psci_latency_ticks_to_us(stat->entry_max));
+}
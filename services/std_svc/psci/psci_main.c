@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -71,6 +71,33 @@ int psci_cpu_on(u_register_t target_cpu,
 	return rc;
 }
 
+/*******************************************************************************
+ * Non-standard api to turn on several cpus in one call, for use by the SiP
+ * service of the platform. See psci_cpu_on_batch_start() for the meaning of
+ * 'on_mask' and of the return value.
+ ******************************************************************************/
+int psci_cpu_on_batch(const u_register_t *target_cpus,
+		      unsigned int num_cpus,
+		      uintptr_t entrypoint,
+		      u_register_t context_id,
+		      uint64_t *on_mask)
+{
+	int rc;
+	entry_point_info_t ep;
+
+	*on_mask = 0;
+
+	if (num_cpus == 0 || num_cpus > PSCI_CPU_ON_BATCH_MAX)
+		return PSCI_E_INVALID_PARAMS;
+
+	/* Validate the entry point and get the entry_point_info */
+	rc = psci_validate_entry_point(&ep, entrypoint, context_id);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	return psci_cpu_on_batch_start(target_cpus, num_cpus, &ep, on_mask);
+}
+
 unsigned int psci_version(void)
 {
 	return PSCI_MAJOR_VER | PSCI_MINOR_VER;
@@ -104,7 +131,13 @@ int psci_cpu_suspend(unsigned int power_state,
 
 	target_pwrlvl = psci_find_target_suspend_lvl(&state_info);
 
-	/* Fast path for CPU standby.*/
+	/*
+	 * Fast path for CPU standby. Only this CPU's power domain is affected,
+	 * so neither the power domain tree nor any lock is touched and the
+	 * CPU is never powered down. This means that the state coordination
+	 * and the context management done by psci_cpu_suspend_start() are
+	 * not needed.
+	 */
 	if (is_cpu_standby_req(is_power_down_state, target_pwrlvl)) {
 		if  (!psci_plat_pm_ops->cpu_standby)
 			return PSCI_E_INVALID_PARAMS;
@@ -115,10 +148,20 @@ int psci_cpu_suspend(unsigned int power_state,
 		 */
 		cpu_pd_state = state_info.pwr_domain_state[PSCI_CPU_PWR_LVL];
 		psci_set_cpu_local_state(cpu_pd_state);
+		psci_export_states(PSCI_CPU_PWR_LVL);
+#if ENABLE_PSCI_STAT
+		psci_stats_update_pwr_down(PSCI_CPU_PWR_LVL, &state_info);
+#endif
+		el3_progress(EL3_PROGRESS_IDLE, 0);
 		psci_plat_pm_ops->cpu_standby(cpu_pd_state);
+		el3_progress(EL3_PROGRESS_PSCI, PSCI_TRACE_WAKEUP);
 
+#if ENABLE_PSCI_STAT
+		psci_stats_update_pwr_up(PSCI_CPU_PWR_LVL, &state_info);
+#endif
 		/* Upon exit from standby, set the state back to RUN. */
 		psci_set_cpu_local_state(PSCI_LOCAL_STATE_RUN);
+		psci_export_states(PSCI_CPU_PWR_LVL);
 
 		return PSCI_E_SUCCESS;
 	}
@@ -139,12 +182,10 @@ int psci_cpu_suspend(unsigned int power_state,
 	 * might return if the power down was abandoned for any reason, e.g.
 	 * arrival of an interrupt
 	 */
-	psci_cpu_suspend_start(&ep,
-			    target_pwrlvl,
-			    &state_info,
-			    is_power_down_state);
-
-	return PSCI_E_SUCCESS;
+	return psci_cpu_suspend_start(&ep,
+				      target_pwrlvl,
+				      &state_info,
+				      is_power_down_state);
 }
 
 
@@ -177,12 +218,10 @@ int psci_system_suspend(uintptr_t entrypoint, u_register_t context_id)
 	 * might return if the power down was abandoned for any reason, e.g.
 	 * arrival of an interrupt
 	 */
-	psci_cpu_suspend_start(&ep,
-			    PLAT_MAX_PWR_LVL,
-			    &state_info,
-			    PSTATE_TYPE_POWERDOWN);
-
-	return PSCI_E_SUCCESS;
+	return psci_cpu_suspend_start(&ep,
+				      PLAT_MAX_PWR_LVL,
+				      &state_info,
+				      PSTATE_TYPE_POWERDOWN);
 }
 
 int psci_cpu_off(void)
@@ -206,6 +245,60 @@ int psci_cpu_off(void)
 	return rc;
 }
 
+/*******************************************************************************
+ * CPU_FREEZE places the calling cpu in the shallowest state in which it is not
+ * coherent: the cpu alone is powered down exactly as for CPU_OFF, while its
+ * parent power domains are left running. As for CPU_OFF, no context is kept
+ * and the cpu can only be brought back by a CPU_ON call.
+ ******************************************************************************/
+int psci_cpu_freeze(void)
+{
+	int rc;
+
+	rc = psci_do_cpu_off(PSCI_CPU_PWR_LVL);
+
+	/* As for cpu_off, the only error that can be returned is E_DENIED */
+	assert(rc == PSCI_E_DENIED);
+
+	return rc;
+}
+
+/*******************************************************************************
+ * CPU_DEFAULT_SUSPEND requests the deepest power down state supported by the
+ * platform, i.e. the state used for system suspend, and lets the state
+ * coordination pick the states the power domains can actually enter. In OS
+ * initiated mode the caller is not asserting that it is the last cpu at any
+ * level, so only the cpu power domain is powered down.
+ ******************************************************************************/
+int psci_cpu_default_suspend(uintptr_t entrypoint, u_register_t context_id)
+{
+	int rc;
+	unsigned int lvl;
+	psci_power_state_t state_info;
+	entry_point_info_t ep;
+
+	/* Validate the entry point and get the entry_point_info */
+	rc = psci_validate_entry_point(&ep, entrypoint, context_id);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	/* Query the platform for its deepest power down state */
+	psci_query_sys_suspend_pwrstate(&state_info);
+
+	if (psci_is_os_init_mode()) {
+		for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= PLAT_MAX_PWR_LVL; lvl++)
+			state_info.pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
+	}
+
+	assert(psci_validate_suspend_req(&state_info, PSTATE_TYPE_POWERDOWN)
+						== PSCI_E_SUCCESS);
+
+	return psci_cpu_suspend_start(&ep,
+				      psci_find_target_suspend_lvl(&state_info),
+				      &state_info,
+				      PSTATE_TYPE_POWERDOWN);
+}
+
 int psci_affinity_info(u_register_t target_affinity,
 		       unsigned int lowest_affinity_level)
 {
@@ -297,17 +390,52 @@ int psci_features(unsigned int psci_fid)
 	/* Format the feature flags */
 	if (psci_fid == PSCI_CPU_SUSPEND_AARCH32 ||
 			psci_fid == PSCI_CPU_SUSPEND_AARCH64) {
+#if PSCI_OS_INIT_MODE
+		return (FF_PSTATE << FF_PSTATE_SHIFT) |
+			(FF_SUPPORTS_OS_INIT_MODE << FF_MODE_SUPPORT_SHIFT);
+#else
 		/*
 		 * The trusted firmware does not support OS Initiated Mode.
 		 */
 		return (FF_PSTATE << FF_PSTATE_SHIFT) |
 			((!FF_SUPPORTS_OS_INIT_MODE) << FF_MODE_SUPPORT_SHIFT);
+#endif
 	}
 
 	/* Return 0 for all other fid's */
 	return PSCI_E_SUCCESS;
 }
 
+#if PSCI_OS_INIT_MODE
+int psci_set_suspend_mode(unsigned int mode)
+{
+	unsigned int cpu_idx, my_idx = plat_my_core_pos();
+
+	if (mode == psci_suspend_mode)
+		return PSCI_E_SUCCESS;
+
+	if (mode != PSCI_MODE_PC && mode != PSCI_MODE_OSI)
+		return PSCI_E_INVALID_PARAMS;
+
+	/*
+	 * The power domain states have been coordinated according to the
+	 * current mode. Only allow a change while no other CPU is suspended.
+	 */
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		if (cpu_idx == my_idx)
+			continue;
+
+		if (psci_get_aff_info_state_by_idx(cpu_idx) == AFF_STATE_ON &&
+		    !is_local_state_run(psci_get_cpu_local_state_by_idx(cpu_idx)))
+			return PSCI_E_DENIED;
+	}
+
+	psci_suspend_mode = mode;
+
+	return PSCI_E_SUCCESS;
+}
+#endif
+
 /*******************************************************************************
  * PSCI top level handler for servicing SMCs.
  ******************************************************************************/
@@ -341,6 +469,12 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 		case PSCI_CPU_OFF:
 			SMC_RET1(handle, psci_cpu_off());
 
+		case PSCI_CPU_FREEZE:
+			SMC_RET1(handle, psci_cpu_freeze());
+
+		case PSCI_CPU_DEFAULT_SUSPEND_AARCH32:
+			SMC_RET1(handle, psci_cpu_default_suspend(x1, x2));
+
 		case PSCI_CPU_SUSPEND_AARCH32:
 			SMC_RET1(handle, psci_cpu_suspend(x1, x2, x3));
 
@@ -373,6 +507,19 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 		case PSCI_FEATURES:
 			SMC_RET1(handle, psci_features(x1));
 
+#if PSCI_OS_INIT_MODE
+		case PSCI_SET_SUSPEND_MODE:
+			SMC_RET1(handle, psci_set_suspend_mode(x1));
+#endif
+
+#if ENABLE_PSCI_STAT
+		case PSCI_STAT_RESIDENCY_AARCH32:
+			SMC_RET1(handle, psci_stat_residency(x1, x2));
+
+		case PSCI_STAT_COUNT_AARCH32:
+			SMC_RET1(handle, psci_stat_count(x1, x2));
+#endif
+
 		default:
 			break;
 		}
@@ -386,6 +533,9 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 		case PSCI_CPU_ON_AARCH64:
 			SMC_RET1(handle, psci_cpu_on(x1, x2, x3));
 
+		case PSCI_CPU_DEFAULT_SUSPEND_AARCH64:
+			SMC_RET1(handle, psci_cpu_default_suspend(x1, x2));
+
 		case PSCI_AFFINITY_INFO_AARCH64:
 			SMC_RET1(handle, psci_affinity_info(x1, x2));
 
@@ -398,6 +548,14 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 		case PSCI_SYSTEM_SUSPEND_AARCH64:
 			SMC_RET1(handle, psci_system_suspend(x1, x2));
 
+#if ENABLE_PSCI_STAT
+		case PSCI_STAT_RESIDENCY_AARCH64:
+			SMC_RET1(handle, psci_stat_residency(x1, x2));
+
+		case PSCI_STAT_COUNT_AARCH64:
+			SMC_RET1(handle, psci_stat_count(x1, x2));
+#endif
+
 		default:
 			break;
 		}
@@ -406,3 +564,39 @@ uint64_t psci_smc_handler(uint32_t smc_fid,
 	WARN("Unimplemented PSCI Call: 0x%x \n", smc_fid);
 	SMC_RET1(handle, SMC_UNK);
 }
+
+/*******************************************************************************
+ * PSCI handler for CPU_SUSPEND, registered as a runtime service function so
+ * that the calls made by the idle code of the normal world do not have to go
+ * through the Standard Service and PSCI top level handlers.
+ ******************************************************************************/
+static uint64_t psci_cpu_suspend_smc_handler(uint32_t smc_fid,
+					     uint64_t x1,
+					     uint64_t x2,
+					     uint64_t x3,
+					     uint64_t x4,
+					     void *cookie,
+					     void *handle,
+					     uint64_t flags)
+{
+	if (is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	/* Check the fid against the capabilities */
+	if (!(psci_caps & define_psci_cap(smc_fid)))
+		SMC_RET1(handle, SMC_UNK);
+
+	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
+		/* 32-bit PSCI function, clear top parameter bits */
+		x1 = (uint32_t)x1;
+		x2 = (uint32_t)x2;
+		x3 = (uint32_t)x3;
+	}
+
+	SMC_RET1(handle, psci_cpu_suspend(x1, x2, x3));
+}
+
+DECLARE_RT_SVC_FUNC(psci_cpu_suspend_aarch32, PSCI_CPU_SUSPEND_AARCH32,
+		    psci_cpu_suspend_smc_handler);
+DECLARE_RT_SVC_FUNC(psci_cpu_suspend_aarch64, PSCI_CPU_SUSPEND_AARCH64,
+		    psci_cpu_suspend_smc_handler);
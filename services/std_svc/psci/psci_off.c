@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -31,6 +31,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
+#include <context_mgmt.h>
 #include <debug.h>
 #include <platform.h>
 #include <string.h>
@@ -90,6 +91,11 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 			goto exit;
 	}
 
+#if CTX_LAZY_FPREGS
+	/* The FP registers may hold the only copy of the FP state of a world */
+	cm_fpregs_context_save_live();
+#endif
+
 	/* Construct the psci_power_state for CPU_OFF */
 	psci_set_power_off_state(&state_info);
 
@@ -100,11 +106,24 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 	 */
 	psci_do_state_coordination(end_pwrlvl, &state_info);
 
+	/*
+	 * This cpu can no longer fail to power down. Stop counting it as ON
+	 * while its data cache is still enabled.
+	 */
+	psci_dec_cpus_on();
+
+	/*
+	 * The suspend level of this cpu, invalidated when it last resumed from
+	 * suspend, is read with the data cache disabled on the next power up.
+	 */
+	psci_flush_cpu_data(psci_svc_cpu_data.target_pwrlvl);
+
 	/*
 	 * Arch. management. Perform the necessary steps to flush all
 	 * cpu caches.
 	 */
-	psci_do_pwrdown_cache_maintenance(psci_find_max_off_lvl(&state_info));
+	psci_do_pwrdown_cache_maintenance(
+				psci_find_pwr_down_cache_lvl(&state_info));
 
 	/*
 	 * Plat. management: Perform platform specific actions to turn this
@@ -131,12 +150,18 @@ exit:
 		 * required to ensure that later cached reads of aff_info_state
 		 * return AFF_STATE_OFF.  A dsbish() ensures ordering of the
 		 * update to the affinity info state prior to cache line
-		 * invalidation.
+		 * invalidation. With hardware assisted coherency, the data
+		 * cache is still enabled and no maintenance is needed.
 		 */
+#if HW_ASSISTED_COHERENCY
+		psci_set_aff_info_state(AFF_STATE_OFF);
+#else
 		flush_cpu_data(psci_svc_cpu_data.aff_info_state);
 		psci_set_aff_info_state(AFF_STATE_OFF);
 		dsbish();
 		inv_cpu_data(psci_svc_cpu_data.aff_info_state);
+#endif
+		psci_progress_pwrdown();
 
 		/*
 		 * Enter a wfi loop which will allow the power controller to
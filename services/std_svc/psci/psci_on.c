@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -34,6 +34,7 @@
 #include <bl_common.h>
 #include <bl31.h>
 #include <debug.h>
+#include <el3_timer.h>
 #include <context_mgmt.h>
 #include <platform.h>
 #include <runtime_svc.h>
@@ -56,41 +57,110 @@ static int cpu_on_validate_state(aff_info_state_t aff_state)
 	return PSCI_E_SUCCESS;
 }
 
+#if HW_ASSISTED_COHERENCY
+CASSERT(sizeof(aff_info_state_t) == sizeof(uint32_t),
+	assert_aff_info_state_size_mismatch);
+
 /*******************************************************************************
- * Generic handler which is called to physically power on a cpu identified by
- * its mpidr. It performs the generic, architectural, platform setup and state
- * management to power on the target cpu e.g. it will ensure that
- * enough information is stashed for it to resume execution in the non-secure
- * security state.
- *
- * The state of all the relevant power domains are changed after calling the
- * platform handler as it can return error.
+ * This function sets the affinity info state of the cpu with linear index
+ * 'target_idx' to ON_PENDING if it is OFF, and returns the state it had. The
+ * state is only accessed with the data cache enabled, so a compare-and-swap
+ * ensures that a single cpu turns on the target without holding a lock while
+ * the platform powers it on.
  ******************************************************************************/
-int psci_cpu_on_start(u_register_t target_cpu,
-		      entry_point_info_t *ep,
-		      unsigned int end_pwrlvl)
+static aff_info_state_t psci_cpu_on_claim(unsigned int target_idx)
+{
+	psci_cpu_data_t *svc_cpu_data;
+
+	svc_cpu_data = &_cpu_data_by_index(target_idx)->psci_svc_cpu_data;
+
+	return atomic_cmpxchg_32(
+			(volatile uint32_t *)&svc_cpu_data->aff_info_state,
+			AFF_STATE_OFF, AFF_STATE_ON_PENDING);
+}
+
+static void psci_cpu_on_release(unsigned int target_idx)
+{
+}
+#else
+/*******************************************************************************
+ * This function sets the affinity info state of the cpu with linear index
+ * 'target_idx' to ON_PENDING if it is OFF, and returns the state it had. The
+ * target writes OFF with its data cache disabled and then invalidates the
+ * cache line, which can discard a concurrent update. The cpu lock of the target
+ * is taken to protect against multiple cpus trying to turn it on, and held
+ * until psci_cpu_on_release() if the target was OFF.
+ ******************************************************************************/
+static aff_info_state_t psci_cpu_on_claim(unsigned int target_idx)
 {
-	int rc;
-	unsigned int target_idx = plat_core_pos_by_mpidr(target_cpu);
 	aff_info_state_t target_aff_state;
 
+	psci_spin_lock_cpu(target_idx);
+
+	target_aff_state = psci_get_aff_info_state_by_idx(target_idx);
+	if (target_aff_state != AFF_STATE_OFF) {
+		psci_spin_unlock_cpu(target_idx);
+		return target_aff_state;
+	}
+
 	/*
-	 * This function must only be called on platforms where the
-	 * CPU_ON platform hooks have been implemented.
+	 * Set the Affinity info state of the target cpu to ON_PENDING.
+	 * Flush aff_info_state as it will be accessed with caches
+	 * turned OFF.
 	 */
-	assert(psci_plat_pm_ops->pwr_domain_on &&
-			psci_plat_pm_ops->pwr_domain_on_finish);
+	psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_ON_PENDING);
+	psci_flush_cpu_data_by_index(target_idx,
+				     psci_svc_cpu_data.aff_info_state);
 
-	/* Protect against multiple CPUs trying to turn ON the same target CPU */
-	psci_spin_lock_cpu(target_idx);
+	/*
+	 * The cache line invalidation by the target CPU after setting the
+	 * state to OFF (see psci_do_cpu_off()), could cause the update to
+	 * aff_info_state to be invalidated. Retry the update if the target
+	 * CPU aff_info_state is not ON_PENDING.
+	 */
+	target_aff_state = psci_get_aff_info_state_by_idx(target_idx);
+	if (target_aff_state != AFF_STATE_ON_PENDING) {
+		assert(target_aff_state == AFF_STATE_OFF);
+		psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_ON_PENDING);
+		psci_flush_cpu_data_by_index(target_idx,
+				     psci_svc_cpu_data.aff_info_state);
+
+		assert(psci_get_aff_info_state_by_idx(target_idx) == AFF_STATE_ON_PENDING);
+	}
+
+	return AFF_STATE_OFF;
+}
+
+static void psci_cpu_on_release(unsigned int target_idx)
+{
+	psci_spin_unlock_cpu(target_idx);
+}
+#endif
+
+/*******************************************************************************
+ * This function performs the generic state management needed before the
+ * platform is asked to power on the cpu identified by 'target_cpu' and its
+ * linear index 'target_idx'. On success, the affinity info state of the target
+ * is ON_PENDING, its context is initialised from 'ep' and, without hardware
+ * assisted coherency, its cpu lock is held until psci_cpu_on_complete().
+ ******************************************************************************/
+static int psci_cpu_on_prepare(u_register_t target_cpu,
+			       unsigned int target_idx,
+			       entry_point_info_t *ep)
+{
+	int rc;
+
+	psci_trace(PSCI_TRACE_CPU_ON, target_idx);
 
 	/*
 	 * Generic management: Ensure that the cpu is off to be
 	 * turned on.
 	 */
-	rc = cpu_on_validate_state(psci_get_aff_info_state_by_idx(target_idx));
+	rc = cpu_on_validate_state(psci_cpu_on_claim(target_idx));
 	if (rc != PSCI_E_SUCCESS)
-		goto exit;
+		return rc;
+
+	psci_inc_cpus_on();
 
 	/*
 	 * Call the cpu on handler registered by the Secure Payload Dispatcher
@@ -101,27 +171,64 @@ int psci_cpu_on_start(u_register_t target_cpu,
 		psci_spd_pm->svc_on(target_cpu);
 
 	/*
-	 * Set the Affinity info state of the target cpu to ON_PENDING.
-	 * Flush aff_info_state as it will be accessed with caches
-	 * turned OFF.
+	 * Store the re-entry information for the non-secure world. With
+	 * hardware assisted coherency, no lock makes the target wait for it in
+	 * psci_cpu_on_finish(), so it must be visible before the platform is
+	 * asked to power on the target.
 	 */
-	psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_ON_PENDING);
-	flush_cpu_data_by_index(target_idx, psci_svc_cpu_data.aff_info_state);
+	cm_init_context_by_index(target_idx, ep);
+	dsbish();
+
+	return PSCI_E_SUCCESS;
+}
+
+/*******************************************************************************
+ * This function completes a power on request of the cpu with linear index
+ * 'target_idx' prepared by psci_cpu_on_prepare(), once the platform has
+ * returned 'rc' for it.
+ ******************************************************************************/
+static void psci_cpu_on_complete(unsigned int target_idx, int rc)
+{
+	assert(rc == PSCI_E_SUCCESS || rc == PSCI_E_INTERN_FAIL);
+
+	if (rc != PSCI_E_SUCCESS) {
+		/* Restore the state on error. */
+		psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_OFF);
+		psci_flush_cpu_data_by_index(target_idx,
+				     psci_svc_cpu_data.aff_info_state);
+		psci_dec_cpus_on();
+	}
+
+	psci_cpu_on_release(target_idx);
+}
+
+/*******************************************************************************
+ * Generic handler which is called to physically power on a cpu identified by
+ * its mpidr. It performs the generic, architectural, platform setup and state
+ * management to power on the target cpu e.g. it will ensure that
+ * enough information is stashed for it to resume execution in the non-secure
+ * security state.
+ *
+ * The state of all the relevant power domains are changed after calling the
+ * platform handler as it can return error.
+ ******************************************************************************/
+int psci_cpu_on_start(u_register_t target_cpu,
+		      entry_point_info_t *ep,
+		      unsigned int end_pwrlvl)
+{
+	int rc;
+	unsigned int target_idx = plat_core_pos_by_mpidr(target_cpu);
 
 	/*
-	 * The cache line invalidation by the target CPU after setting the
-	 * state to OFF (see psci_do_cpu_off()), could cause the update to
-	 * aff_info_state to be invalidated. Retry the update if the target
-	 * CPU aff_info_state is not ON_PENDING.
+	 * This function must only be called on platforms where the
+	 * CPU_ON platform hooks have been implemented.
 	 */
-	target_aff_state = psci_get_aff_info_state_by_idx(target_idx);
-	if (target_aff_state != AFF_STATE_ON_PENDING) {
-		assert(target_aff_state == AFF_STATE_OFF);
-		psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_ON_PENDING);
-		flush_cpu_data_by_index(target_idx, psci_svc_cpu_data.aff_info_state);
+	assert(psci_plat_pm_ops->pwr_domain_on &&
+			psci_plat_pm_ops->pwr_domain_on_finish);
 
-		assert(psci_get_aff_info_state_by_idx(target_idx) == AFF_STATE_ON_PENDING);
-	}
+	rc = psci_cpu_on_prepare(target_cpu, target_idx, ep);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
 
 	/*
 	 * Perform generic, architecture and platform specific handling.
@@ -131,21 +238,114 @@ int psci_cpu_on_start(u_register_t target_cpu,
 	 * of the target cpu to allow it to perform the necessary
 	 * steps to power on.
 	 */
-	rc = psci_plat_pm_ops->pwr_domain_on(target_cpu);
-	assert(rc == PSCI_E_SUCCESS || rc == PSCI_E_INTERN_FAIL);
+	psci_trace(PSCI_TRACE_CPU_ON_PLAT_START, target_idx);
+	if (psci_release_parked_cpu(target_idx))
+		rc = PSCI_E_SUCCESS;
+	else
+		rc = psci_plat_pm_ops->pwr_domain_on(target_cpu);
+	psci_trace(PSCI_TRACE_CPU_ON_PLAT_END, rc);
 
-	if (rc == PSCI_E_SUCCESS)
-		/* Store the re-entry information for the non-secure world. */
-		cm_init_context_by_index(target_idx, ep);
-	else {
-		/* Restore the state on error. */
-		psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_OFF);
-		flush_cpu_data_by_index(target_idx, psci_svc_cpu_data.aff_info_state);
+	psci_cpu_on_complete(target_idx, rc);
+	return rc;
+}
+
+/*******************************************************************************
+ * Generic handler which is called to power on the 'num_cpus' cpus identified by
+ * the mpidrs in 'target_cpus' in one go. Each cpu goes through the same state
+ * management as in psci_cpu_on_start(), but the platform is given all the cpus
+ * which can be turned on in a single pwr_domain_on_batch() call, if it
+ * implements it, so that it can issue the power on requests back-to-back.
+ *
+ * Bit 'n' of 'on_mask' is set on return if 'target_cpus[n]' is being turned
+ * on. The return value is PSCI_E_SUCCESS if all the cpus are being turned on,
+ * or otherwise the error returned for one of the cpus which could not be.
+ ******************************************************************************/
+int psci_cpu_on_batch_start(const u_register_t *target_cpus,
+			    unsigned int num_cpus,
+			    entry_point_info_t *ep,
+			    uint64_t *on_mask)
+{
+	int rc, ret = PSCI_E_SUCCESS;
+	unsigned int i, j, target_idx, num_on = 0;
+	u_register_t on_cpus[PSCI_CPU_ON_BATCH_MAX];
+	unsigned int on_idx[PSCI_CPU_ON_BATCH_MAX];
+	unsigned int on_pos[PSCI_CPU_ON_BATCH_MAX];
+
+	assert(psci_plat_pm_ops->pwr_domain_on &&
+			psci_plat_pm_ops->pwr_domain_on_finish);
+	assert(num_cpus <= PSCI_CPU_ON_BATCH_MAX);
+	assert(on_mask);
+
+	*on_mask = 0;
+
+	for (i = 0; i < num_cpus; i++) {
+		if (psci_validate_mpidr(target_cpus[i]) != PSCI_E_SUCCESS) {
+			rc = PSCI_E_INVALID_PARAMS;
+		} else {
+			target_idx = plat_core_pos_by_mpidr(target_cpus[i]);
+
+			/* The cpu lock of a cpu listed twice is already held */
+			for (j = 0; j < num_on; j++)
+				if (on_idx[j] == target_idx)
+					break;
+
+			rc = (j < num_on) ? PSCI_E_ON_PENDING :
+				psci_cpu_on_prepare(target_cpus[i], target_idx,
+						    ep);
+		}
+
+		if (rc != PSCI_E_SUCCESS) {
+			if (ret == PSCI_E_SUCCESS)
+				ret = rc;
+			continue;
+		}
+
+		/* A parked cpu only needs to be released */
+		if (psci_release_parked_cpu(target_idx)) {
+			psci_cpu_on_complete(target_idx, PSCI_E_SUCCESS);
+			*on_mask |= 1ULL << i;
+			continue;
+		}
+
+		on_cpus[num_on] = target_cpus[i];
+		on_idx[num_on] = target_idx;
+		on_pos[num_on] = i;
+		num_on++;
+		*on_mask |= 1ULL << i;
 	}
 
-exit:
-	psci_spin_unlock_cpu(target_idx);
-	return rc;
+	if (num_on == 0)
+		return ret;
+
+	/*
+	 * Plat. management: Let the platform power on all the target cpus at
+	 * once if it can, or one after the other otherwise.
+	 */
+	rc = PSCI_E_SUCCESS;
+	if (psci_plat_pm_ops->pwr_domain_on_batch) {
+		psci_trace(PSCI_TRACE_CPU_ON_PLAT_START,
+			   PSCI_TRACE_ARG_BATCH | num_on);
+		rc = psci_plat_pm_ops->pwr_domain_on_batch(on_cpus, num_on);
+		psci_trace(PSCI_TRACE_CPU_ON_PLAT_END, rc);
+	}
+
+	for (i = 0; i < num_on; i++) {
+		if (!psci_plat_pm_ops->pwr_domain_on_batch) {
+			psci_trace(PSCI_TRACE_CPU_ON_PLAT_START, on_idx[i]);
+			rc = psci_plat_pm_ops->pwr_domain_on(on_cpus[i]);
+			psci_trace(PSCI_TRACE_CPU_ON_PLAT_END, rc);
+		}
+
+		psci_cpu_on_complete(on_idx[i], rc);
+
+		if (rc != PSCI_E_SUCCESS) {
+			*on_mask &= ~(1ULL << on_pos[i]);
+			if (ret == PSCI_E_SUCCESS)
+				ret = rc;
+		}
+	}
+
+	return ret;
 }
 
 /*******************************************************************************
@@ -169,6 +369,9 @@ void psci_cpu_on_finish(unsigned int cpu_idx,
 	 */
 	psci_do_pwrup_cache_maintenance();
 
+	/* The secure physical timer has lost its state */
+	el3_timer_restore();
+
 	/*
 	 * All the platform specific actions for turning this cpu
 	 * on have completed. Perform enough arch.initialization
@@ -176,6 +379,7 @@ void psci_cpu_on_finish(unsigned int cpu_idx,
 	 */
 	bl31_arch_setup();
 
+#if !HW_ASSISTED_COHERENCY
 	/*
 	 * Lock the CPU spin lock to make sure that the context initialization
 	 * is done. Since the lock is only used in this function to create
@@ -184,6 +388,7 @@ void psci_cpu_on_finish(unsigned int cpu_idx,
 	 */
 	psci_spin_lock_cpu(cpu_idx);
 	psci_spin_unlock_cpu(cpu_idx);
+#endif
 
 	/* Ensure we have been explicitly woken up by another cpu */
 	assert(psci_get_aff_info_state() == AFF_STATE_ON_PENDING);
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include "psci_private.h"
+
+/*******************************************************************************
+ * This function sets the local power state requested by the cpu at 'cpu_idx'
+ * for all its ancestor power domains. A parked cpu requests them to stay at
+ * RUN, so that the state coordination never powers down a power domain in
+ * which it is still executing.
+ ******************************************************************************/
+static void psci_set_parked_req_states(unsigned int cpu_idx,
+				       plat_local_state_t req_pwr_state)
+{
+	unsigned int lvl;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= PLAT_MAX_PWR_LVL; lvl++)
+		set_cpu_data_by_index(cpu_idx,
+				psci_svc_cpu_data.req_local_state[lvl - 1],
+				req_pwr_state);
+}
+
+/*******************************************************************************
+ * This function marks the cpu at 'cpu_idx' as parked or not and makes the
+ * update visible to it while it runs with the data cache disabled.
+ ******************************************************************************/
+static void psci_set_parked(unsigned int cpu_idx, unsigned int parked)
+{
+	psci_set_parked_by_idx(cpu_idx, parked);
+	if (parked)
+		psci_inc_cpus_on();
+	else
+		psci_dec_cpus_on();
+	psci_set_parked_req_states(cpu_idx, parked ? PSCI_LOCAL_STATE_RUN :
+						     PLAT_MAX_OFF_STATE);
+	flush_cpu_data_by_index(cpu_idx, psci_svc_cpu_data);
+}
+
+/*******************************************************************************
+ * This function is called by the primary cpu at the end of the cold boot,
+ * once the BL31 data has been cleaned to memory. It powers on every other
+ * cpu through the platform so that they all run their reset handler, EL3
+ * architectural setup and MMU setup at the same time, through the usual warm
+ * boot path. Each of them then waits in psci_park_wait() until a CPU_ON
+ * targets it, which only has to release it.
+ *
+ * The generic code has no way to enumerate the MPIDRs of the platform, so the
+ * cpus are looked up through plat_core_pos_by_mpidr() among the MPIDRs whose
+ * affinity levels 0 and 1 are below PLATFORM_CORE_COUNT. A cpu outside this
+ * range is simply not parked, and is powered on as usual by CPU_ON.
+ ******************************************************************************/
+void psci_park_secondaries(void)
+{
+	u_register_t mpidr, cpus[PLATFORM_CORE_COUNT];
+	unsigned int cpu_idx[PLATFORM_CORE_COUNT];
+	unsigned int aff0, aff1, i, num_cpus = 0, num_parked = 0;
+	unsigned int my_idx = plat_my_core_pos();
+	int idx, rc = PSCI_E_SUCCESS;
+
+	for (aff1 = 0; aff1 < PLATFORM_CORE_COUNT; aff1++) {
+		for (aff0 = 0; aff0 < PLATFORM_CORE_COUNT; aff0++) {
+			mpidr = ((u_register_t) aff1 << MPIDR_AFF1_SHIFT) |
+				((u_register_t) aff0 << MPIDR_AFF0_SHIFT);
+			idx = plat_core_pos_by_mpidr(mpidr);
+			if (idx < 0 || (unsigned int) idx == my_idx)
+				continue;
+
+			assert(num_cpus < PLATFORM_CORE_COUNT);
+			if (psci_get_aff_info_state_by_idx(idx) != AFF_STATE_OFF)
+				continue;
+
+			/* Mark the cpu before it can reach psci_park_wait() */
+			psci_set_parked(idx, 1);
+			cpus[num_cpus] = mpidr;
+			cpu_idx[num_cpus] = idx;
+			num_cpus++;
+		}
+	}
+
+	if (num_cpus == 0)
+		return;
+
+	if (psci_plat_pm_ops->pwr_domain_on_batch)
+		rc = psci_plat_pm_ops->pwr_domain_on_batch(cpus, num_cpus);
+
+	for (i = 0; i < num_cpus; i++) {
+		if (!psci_plat_pm_ops->pwr_domain_on_batch)
+			rc = psci_plat_pm_ops->pwr_domain_on(cpus[i]);
+
+		if (rc == PSCI_E_SUCCESS)
+			num_parked++;
+		else
+			psci_set_parked(cpu_idx[i], 0);
+	}
+
+	INFO("BL31: Parked %u secondary cpus\n", num_parked);
+}
+
+/*******************************************************************************
+ * This function is called by a cpu at the start of its warm boot, with the data
+ * cache disabled. If it has been powered on by psci_park_secondaries(), it
+ * waits here until psci_release_parked_cpu() is called for it by a CPU_ON, and
+ * then carries on with the power on as if it had just been powered up.
+ ******************************************************************************/
+void psci_park_wait(void)
+{
+	volatile unsigned char *parked =
+			&get_cpu_data(psci_svc_cpu_data.parked);
+
+	while (*parked)
+		wfe();
+}
+
+/*******************************************************************************
+ * This function returns whether the cpu at 'cpu_idx' is parked.
+ ******************************************************************************/
+unsigned int psci_is_cpu_parked(unsigned int cpu_idx)
+{
+	return psci_get_parked_by_idx(cpu_idx);
+}
+
+/*******************************************************************************
+ * This function releases the cpu at 'cpu_idx' if it is parked, and returns 1
+ * in that case or 0 otherwise. It must be called with the cpu lock of the
+ * target held and its affinity info state set to ON_PENDING, in place of the
+ * platform pwr_domain_on() handler. The released cpu synchronises with the
+ * initialisation of its context through the cpu lock in psci_cpu_on_finish().
+ ******************************************************************************/
+int psci_release_parked_cpu(unsigned int cpu_idx)
+{
+	if (!psci_get_parked_by_idx(cpu_idx))
+		return 0;
+
+	assert(psci_get_aff_info_state_by_idx(cpu_idx) == AFF_STATE_ON_PENDING);
+
+	/*
+	 * The requested states of the ancestors are left at RUN, they are set
+	 * again by the cpu itself once it has finished powering on.
+	 */
+	psci_set_parked_by_idx(cpu_idx, 0);
+	flush_cpu_data_by_index(cpu_idx, psci_svc_cpu_data.parked);
+	sev();
+
+	/* The cpu is now counted through its ON_PENDING affinity info state */
+	psci_dec_cpus_on();
+
+	return 1;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -32,22 +32,36 @@
 #define __PSCI_PRIVATE_H__
 
 #include <arch.h>
+#include <atomic.h>
 #include <bakery_lock.h>
 #include <bl_common.h>
+#include <cassert.h>
 #include <cpu_data.h>
 #include <psci.h>
+#include <psci_trace.h>
 #include <spinlock.h>
+#include <ticket_lock.h>
 
 /*
- * The following helper macros abstract the interface to the Bakery
- * Lock API.
+ * The following helper macros abstract the interface to the locks of the non
+ * cpu power domains. These are taken with the data cache disabled on the warm
+ * boot path and released with the data cache disabled on the power down path,
+ * which requires bakery locks unless the data cache stays enabled and coherent
+ * throughout, in which case ticket locks are used instead.
  */
 #define psci_lock_init(non_cpu_pd_node, idx)			\
 	((non_cpu_pd_node)[(idx)].lock_index = (idx))
+#if HW_ASSISTED_COHERENCY
+#define psci_lock_get(non_cpu_pd_node)				\
+	ticket_lock_get(&psci_locks[(non_cpu_pd_node)->lock_index].lock)
+#define psci_lock_release(non_cpu_pd_node)			\
+	ticket_lock_release(&psci_locks[(non_cpu_pd_node)->lock_index].lock)
+#else
 #define psci_lock_get(non_cpu_pd_node)				\
 	bakery_lock_get(&psci_locks[(non_cpu_pd_node)->lock_index])
 #define psci_lock_release(non_cpu_pd_node)			\
 	bakery_lock_release(&psci_locks[(non_cpu_pd_node)->lock_index])
+#endif
 
 /*
  * The PSCI capability which are provided by the generic code but does not
@@ -67,7 +81,10 @@
 			define_psci_cap(PSCI_AFFINITY_INFO_AARCH64) |	\
 			define_psci_cap(PSCI_MIG_AARCH64) |		\
 			define_psci_cap(PSCI_MIG_INFO_UP_CPU_AARCH64) |	\
-			define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64))
+			define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64) |	\
+			define_psci_cap(PSCI_CPU_DEFAULT_SUSPEND_AARCH64) | \
+			define_psci_cap(PSCI_STAT_RESIDENCY_AARCH64) |	\
+			define_psci_cap(PSCI_STAT_COUNT_AARCH64))
 
 /*
  * Helper macros to get/set the fields of PSCI per-cpu data.
@@ -92,11 +109,49 @@
 #define psci_get_cpu_local_state_by_idx(idx) \
 		get_cpu_data_by_index(idx, psci_svc_cpu_data.local_state)
 
+/*
+ * Helper macros to publish the fields of the PSCI per-cpu data which a cpu
+ * reads with its data cache disabled while it powers up: aff_info_state,
+ * target_pwrlvl and local_state. With hardware assisted coherency, the data
+ * cache is enabled along with the MMU at the warm boot entry point, so these
+ * fields are never read from memory behind the caches.
+ */
+#if HW_ASSISTED_COHERENCY
+#define psci_flush_cpu_data(member)			((void)0)
+#define psci_flush_cpu_data_by_index(idx, member)	((void)0)
+#else
+#define psci_flush_cpu_data(member)	flush_cpu_data(member)
+#define psci_flush_cpu_data_by_index(idx, member) \
+		flush_cpu_data_by_index(idx, member)
+#endif
+
+/*
+ * Helper macros to update the number of cpus which are not OFF. They must be
+ * called with the data cache enabled.
+ */
+#define psci_inc_cpus_on()	atomic_fetch_add_32(&psci_cpus_on_count, 1)
+#define psci_dec_cpus_on()	atomic_fetch_add_32(&psci_cpus_on_count, -1)
+
+#if PSCI_PARK_SECONDARIES
+#define psci_get_parked_by_idx(idx) \
+		get_cpu_data_by_index(idx, psci_svc_cpu_data.parked)
+#define psci_set_parked_by_idx(idx, is_parked) \
+		set_cpu_data_by_index(idx, psci_svc_cpu_data.parked, is_parked)
+#endif
+
+#if PSCI_OS_INIT_MODE
+#define psci_is_os_init_mode()	(psci_suspend_mode == PSCI_MODE_OSI)
+#else
+#define psci_is_os_init_mode()	0
+#endif
+
 /*
  * Helper macros for the CPU level spinlocks
  */
+#if !HW_ASSISTED_COHERENCY
 #define psci_spin_lock_cpu(idx)	spin_lock(&psci_cpu_pd_nodes[idx].cpu_lock)
 #define psci_spin_unlock_cpu(idx) spin_unlock(&psci_cpu_pd_nodes[idx].cpu_lock)
+#endif
 
 /* Helper macro to identify a CPU standby request in PSCI Suspend call */
 #define is_cpu_standby_req(is_power_down_state, retn_lvl) \
@@ -129,14 +184,27 @@ typedef struct non_cpu_pwr_domain_node {
 	 */
 	unsigned int parent_node;
 
-	plat_local_state_t local_state;
-
 	unsigned char level;
 
 	/* For indexing the psci_lock array*/
 	unsigned char lock_index;
 } non_cpu_pd_node_t;
 
+/*
+ * The local power state of a non cpu power domain is written by the CPUs of
+ * the power domain as they power down and up, and read with the data cache
+ * disabled during power up. It is kept apart from the read-mostly topology
+ * above: in coherent memory if it is used, in a cache line of its own
+ * otherwise so that the cache maintenance only affects this power domain.
+ */
+typedef struct non_cpu_pwr_domain_state {
+	plat_local_state_t local_state;
+#if USE_COHERENT_MEM
+} non_cpu_pd_state_t;
+#else
+} __aligned(CACHE_WRITEBACK_GRANULE) non_cpu_pd_state_t;
+#endif
+
 typedef struct cpu_pwr_domain_node {
 	u_register_t mpidr;
 
@@ -146,13 +214,17 @@ typedef struct cpu_pwr_domain_node {
 	 */
 	unsigned int parent_node;
 
+#if !HW_ASSISTED_COHERENCY
 	/*
 	 * A CPU power domain does not require state coordination like its
 	 * parent power domains. Hence this node does not include a bakery
 	 * lock. A spinlock is required by the CPU_ON handler to prevent a race
-	 * when multiple CPUs try to turn ON the same target CPU.
+	 * when multiple CPUs try to turn ON the same target CPU. With hardware
+	 * assisted coherency, the affinity info state of the target is updated
+	 * with a compare-and-swap instead.
 	 */
 	spinlock_t cpu_lock;
+#endif
 } cpu_pd_node_t;
 
 /*******************************************************************************
@@ -160,11 +232,58 @@ typedef struct cpu_pwr_domain_node {
  ******************************************************************************/
 extern const plat_psci_ops_t *psci_plat_pm_ops;
 extern non_cpu_pd_node_t psci_non_cpu_pd_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+extern non_cpu_pd_state_t psci_non_cpu_pd_states[PSCI_NUM_NON_CPU_PWR_DOMAINS];
 extern cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
 extern unsigned int psci_caps;
+#if PSCI_OS_INIT_MODE
+extern unsigned int psci_suspend_mode;
+#endif
+extern volatile uint32_t psci_cpus_on_count;
+
+/*
+ * Accessors of the power domain tree. With PSCI_FIXED_TOPOLOGY, the platform
+ * is made of clusters of PLAT_PSCI_CPUS_PER_CLUSTER cpus which are the root
+ * power domains, so the tree can be derived from the cpu index at compile time
+ * instead of being walked in memory. psci_setup() checks that the tree
+ * described by the platform matches.
+ */
+#if PSCI_FIXED_TOPOLOGY
+CASSERT(PLAT_MAX_PWR_LVL == PSCI_CPU_PWR_LVL + 1,
+	assert_psci_fixed_topology_pwr_lvl);
+CASSERT(PSCI_NUM_NON_CPU_PWR_DOMAINS * PLAT_PSCI_CPUS_PER_CLUSTER ==
+	PLATFORM_CORE_COUNT, assert_psci_fixed_topology_core_count);
+
+#define psci_cpu_parent_node(cpu_idx)	\
+		((unsigned int)(cpu_idx) / PLAT_PSCI_CPUS_PER_CLUSTER)
+#define psci_node_parent_node(node_idx)	((unsigned int)-1)
+#define psci_node_cpu_start_idx(node_idx)	\
+		((unsigned int)(node_idx) * PLAT_PSCI_CPUS_PER_CLUSTER)
+#define psci_node_ncpus(node_idx)	PLAT_PSCI_CPUS_PER_CLUSTER
+#else
+#define psci_cpu_parent_node(cpu_idx)	\
+		(psci_cpu_pd_nodes[cpu_idx].parent_node)
+#define psci_node_parent_node(node_idx)	\
+		(psci_non_cpu_pd_nodes[node_idx].parent_node)
+#define psci_node_cpu_start_idx(node_idx)	\
+		(psci_non_cpu_pd_nodes[node_idx].cpu_start_idx)
+#define psci_node_ncpus(node_idx)	\
+		(psci_non_cpu_pd_nodes[node_idx].ncpus)
+#endif
 
+#if HW_ASSISTED_COHERENCY
+/*
+ * One ticket lock is required for each non-cpu power domain. Each lock has a
+ * cache line of its own as all the contenders spin on it.
+ */
+typedef struct psci_ticket_lock {
+	ticket_lock_t lock;
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_ticket_lock_t;
+
+extern psci_ticket_lock_t psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+#else
 /* One bakery lock is required for each non-cpu power domain */
 DECLARE_BAKERY_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
+#endif
 
 /*******************************************************************************
  * SPD's power management hooks registered with PSCI
@@ -188,6 +307,15 @@ void psci_get_parent_pwr_domain_nodes(unsigned int cpu_idx,
 				      unsigned int node_index[]);
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info);
+#if PSCI_RESIDENCY_PREDICTOR
+void psci_record_next_wakeup(void);
+void psci_predict_pwr_states(unsigned int end_pwrlvl,
+			     psci_power_state_t *state_info);
+#endif
+#if PSCI_OS_INIT_MODE
+int psci_do_os_init_coordination(unsigned int end_pwrlvl,
+				 const psci_power_state_t *state_info);
+#endif
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl,
 				   unsigned int cpu_idx);
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
@@ -195,6 +323,8 @@ void psci_release_pwr_domain_locks(unsigned int end_pwrlvl,
 int psci_validate_suspend_req(const psci_power_state_t *state_info,
 			      unsigned int is_power_down_state_req);
 unsigned int psci_find_max_off_lvl(const psci_power_state_t *state_info);
+unsigned int psci_find_pwr_down_cache_lvl(
+				const psci_power_state_t *state_info);
 unsigned int psci_find_target_suspend_lvl(const psci_power_state_t *state_info);
 void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl);
 void psci_print_power_domain_map(void);
@@ -205,6 +335,10 @@ int psci_spd_migrate_info(u_register_t *mpidr);
 int psci_cpu_on_start(unsigned long target_cpu,
 		      entry_point_info_t *ep,
 		      unsigned int end_pwrlvl);
+int psci_cpu_on_batch_start(const u_register_t *target_cpus,
+			    unsigned int num_cpus,
+			    entry_point_info_t *ep,
+			    uint64_t *on_mask);
 
 void psci_cpu_on_finish(unsigned int cpu_idx,
 			psci_power_state_t *state_info);
@@ -213,7 +347,7 @@ void psci_cpu_on_finish(unsigned int cpu_idx,
 int psci_do_cpu_off(unsigned int end_pwrlvl);
 
 /* Private exported functions from psci_suspend.c */
-void psci_cpu_suspend_start(entry_point_info_t *ep,
+int psci_cpu_suspend_start(entry_point_info_t *ep,
 			unsigned int end_pwrlvl,
 			psci_power_state_t *state_info,
 			unsigned int is_power_down_state_req);
@@ -221,6 +355,72 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 void psci_cpu_suspend_finish(unsigned int cpu_idx,
 			psci_power_state_t *state_info);
 
+#if ENABLE_PSCI_STAT
+/* Private exported functions from psci_stat.c */
+void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
+				const psci_power_state_t *state_info);
+void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
+			      const psci_power_state_t *state_info);
+#endif
+
+/*
+ * Each traced event is also a progress point of the CPU for the EL3 hang
+ * detection, whether or not the event is recorded.
+ */
+#if ENABLE_PSCI_TRACE
+/* Private exported functions from psci_trace.c */
+void psci_trace_event(unsigned int event, unsigned int arg);
+unsigned int psci_trace_states(const psci_power_state_t *state_info);
+
+#define psci_trace(_event, _arg)	do {				\
+		psci_trace_event(_event, _arg);				\
+		el3_progress(EL3_PROGRESS_PSCI, _event);		\
+	} while (0)
+#else
+#define psci_trace(_event, _arg)	el3_progress(EL3_PROGRESS_PSCI, _event)
+#endif
+
+#if EL3_HANG_DETECT
+/* Private exported functions from psci_common.c */
+void psci_progress_pwrdown(void);
+#else
+#define psci_progress_pwrdown()
+#endif
+
+#if PSCI_STATE_LATENCY
+/* Private exported functions from psci_latency.c */
+void psci_latency_suspend_start(void);
+void psci_latency_record_entry(const psci_power_state_t *state_info);
+void psci_latency_record_exit(const psci_power_state_t *state_info);
+#else
+#define psci_latency_suspend_start()
+#define psci_latency_record_entry(_state_info)
+#define psci_latency_record_exit(_state_info)
+#endif
+
+#if PSCI_STATE_EXPORT
+/* Private exported functions from psci_export.c */
+void psci_export_states(unsigned int end_pwrlvl);
+#else
+#define psci_export_states(_end_pwrlvl)
+#endif
+
+#if PSCI_PARK_SECONDARIES
+/* Private exported functions from psci_park.c */
+void psci_park_wait(void);
+int psci_release_parked_cpu(unsigned int cpu_idx);
+unsigned int psci_is_cpu_parked(unsigned int cpu_idx);
+#else
+#define psci_release_parked_cpu(_cpu_idx)	0
+#endif
+
+#if PSCI_SYS_SUSPEND_OPS
+/* Private exported functions from psci_sys_suspend.c */
+void psci_sys_suspend_init(void);
+void psci_sys_suspend_save(void);
+void psci_sys_suspend_restore(void);
+#endif
+
 /* Private exported functions from psci_helpers.S */
 void psci_do_pwrdown_cache_maintenance(unsigned int pwr_level);
 void psci_do_pwrup_cache_maintenance(void);
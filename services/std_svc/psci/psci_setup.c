@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -55,7 +55,7 @@ unsigned int psci_caps;
  * Function which initializes the 'psci_non_cpu_pd_nodes' or the
  * 'psci_cpu_pd_nodes' corresponding to the power level.
  ******************************************************************************/
-static void psci_init_pwr_domain_node(unsigned int node_idx,
+static void __init psci_init_pwr_domain_node(unsigned int node_idx,
 					unsigned int parent_idx,
 					unsigned int level)
 {
@@ -63,7 +63,7 @@ static void psci_init_pwr_domain_node(unsigned int node_idx,
 		psci_non_cpu_pd_nodes[node_idx].level = level;
 		psci_lock_init(psci_non_cpu_pd_nodes, node_idx);
 		psci_non_cpu_pd_nodes[node_idx].parent_node = parent_idx;
-		psci_non_cpu_pd_nodes[node_idx].local_state =
+		psci_non_cpu_pd_states[node_idx].local_state =
 							 PLAT_MAX_OFF_STATE;
 	} else {
 		psci_cpu_data_t *svc_cpu_data;
@@ -103,7 +103,7 @@ static void psci_init_pwr_domain_node(unsigned int node_idx,
  * mapping of the CPUs to indices via plat_core_pos_by_mpidr() and
  * plat_my_core_pos() APIs.
  *******************************************************************************/
-static void psci_update_pwrlvl_limits(void)
+static void __init psci_update_pwrlvl_limits(void)
 {
 	int j;
 	unsigned int nodes_idx[PLAT_MAX_PWR_LVL] = {0};
@@ -130,7 +130,7 @@ static void psci_update_pwrlvl_limits(void)
  * informs the number of root power domains. The parent nodes of the root nodes
  * will point to an invalid entry(-1).
  ******************************************************************************/
-static void populate_power_domain_tree(const unsigned char *topology)
+static void __init populate_power_domain_tree(const unsigned char *topology)
 {
 	unsigned int i, j = 0, num_nodes_at_lvl = 1, num_nodes_at_next_lvl;
 	unsigned int node_index = 0, parent_node_index = 0, num_children;
@@ -183,6 +183,30 @@ static void populate_power_domain_tree(const unsigned char *topology)
 	assert(j == PLATFORM_CORE_COUNT);
 }
 
+#if PSCI_FIXED_TOPOLOGY
+/*******************************************************************************
+ * This function checks that the power domain tree populated from the platform
+ * topology map is the one PSCI_FIXED_TOPOLOGY derives from the cpu indices.
+ ******************************************************************************/
+static void __init psci_check_fixed_topology(void)
+{
+	unsigned int idx;
+
+	for (idx = 0; idx < PLATFORM_CORE_COUNT; idx++)
+		assert(psci_cpu_pd_nodes[idx].parent_node ==
+		       psci_cpu_parent_node(idx));
+
+	for (idx = 0; idx < PSCI_NUM_NON_CPU_PWR_DOMAINS; idx++) {
+		assert(psci_non_cpu_pd_nodes[idx].parent_node ==
+		       psci_node_parent_node(idx));
+		assert(psci_non_cpu_pd_nodes[idx].cpu_start_idx ==
+		       psci_node_cpu_start_idx(idx));
+		assert(psci_non_cpu_pd_nodes[idx].ncpus ==
+		       psci_node_ncpus(idx));
+	}
+}
+#endif
+
 /*******************************************************************************
  * This function initializes the power domain topology tree by querying the
  * platform. The power domain nodes higher than the CPU are populated in the
@@ -204,7 +228,7 @@ static void populate_power_domain_tree(const unsigned char *topology)
  * |   CPU 0   |   CPU 1   |   CPU 2   |   CPU 3  |
  * ------------------------------------------------
  ******************************************************************************/
-int psci_setup(void)
+int __init psci_setup(void)
 {
 	const unsigned char *topology_tree;
 
@@ -217,10 +241,23 @@ int psci_setup(void)
 	/* Update the CPU limits for each node in psci_non_cpu_pd_nodes */
 	psci_update_pwrlvl_limits();
 
+#if PSCI_FIXED_TOPOLOGY
+	psci_check_fixed_topology();
+#endif
+
 	/* Populate the mpidr field of cpu node for this CPU */
 	psci_cpu_pd_nodes[plat_my_core_pos()].mpidr =
 		read_mpidr() & MPIDR_AFFINITY_MASK;
 
+	/*
+	 * The topology is read-mostly and is read with the data cache disabled
+	 * during power up, so make it visible in memory once populated.
+	 */
+	flush_dcache_range((uintptr_t) psci_non_cpu_pd_nodes,
+			   sizeof(psci_non_cpu_pd_nodes));
+	flush_dcache_range((uintptr_t) psci_cpu_pd_nodes,
+			   sizeof(psci_cpu_pd_nodes));
+
 	psci_init_req_local_pwr_states();
 
 	/*
@@ -228,6 +265,11 @@ int psci_setup(void)
 	 * power domain levels for this CPU to run.
 	 */
 	psci_set_pwr_domains_to_run(PLAT_MAX_PWR_LVL);
+	psci_cpus_on_count = 1;
+
+#if PSCI_SYS_SUSPEND_OPS
+	psci_sys_suspend_init();
+#endif
 
 	plat_setup_psci_ops((uintptr_t)psci_entrypoint,
 					&psci_plat_pm_ops);
@@ -236,16 +278,28 @@ int psci_setup(void)
 	/* Initialize the psci capability */
 	psci_caps = PSCI_GENERIC_CAP;
 
-	if (psci_plat_pm_ops->pwr_domain_off)
+	if (psci_plat_pm_ops->pwr_domain_off) {
 		psci_caps |=  define_psci_cap(PSCI_CPU_OFF);
+		psci_caps |=  define_psci_cap(PSCI_CPU_FREEZE);
+	}
 	if (psci_plat_pm_ops->pwr_domain_on &&
 			psci_plat_pm_ops->pwr_domain_on_finish)
 		psci_caps |=  define_psci_cap(PSCI_CPU_ON_AARCH64);
 	if (psci_plat_pm_ops->pwr_domain_suspend &&
 			psci_plat_pm_ops->pwr_domain_suspend_finish) {
 		psci_caps |=  define_psci_cap(PSCI_CPU_SUSPEND_AARCH64);
-		if (psci_plat_pm_ops->get_sys_suspend_power_state)
+#if PSCI_OS_INIT_MODE
+		psci_caps |=  define_psci_cap(PSCI_SET_SUSPEND_MODE);
+#endif
+		if (psci_plat_pm_ops->get_sys_suspend_power_state) {
 			psci_caps |=  define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64);
+			psci_caps |=  define_psci_cap(
+					PSCI_CPU_DEFAULT_SUSPEND_AARCH64);
+		}
+#if ENABLE_PSCI_STAT
+		psci_caps |=  define_psci_cap(PSCI_STAT_RESIDENCY_AARCH64);
+		psci_caps |=  define_psci_cap(PSCI_STAT_COUNT_AARCH64);
+#endif
 	}
 	if (psci_plat_pm_ops->system_off)
 		psci_caps |=  define_psci_cap(PSCI_SYSTEM_OFF);
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl31.h>
+#include <platform.h>
+#include "psci_private.h"
+
+/* Residency in system counter ticks and entry count of a local power state */
+typedef struct psci_stat {
+	uint64_t residency;
+	uint64_t count;
+} psci_stat_t;
+
+/*
+ * The statistics of each power domain are indexed by 'local state - 1' as the
+ * RUN state is not accounted for.
+ */
+static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT][PLAT_MAX_OFF_STATE];
+static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
+				    [PLAT_MAX_OFF_STATE];
+
+/*
+ * Time at which each power domain started entering a low power state through
+ * CPU_SUSPEND. It is 0 while no such entry is pending accounting.
+ */
+static uint64_t psci_cpu_stat_ts[PLATFORM_CORE_COUNT];
+static uint64_t psci_non_cpu_stat_ts[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+
+static void psci_stat_account(psci_stat_t *psci_stat,
+			      plat_local_state_t local_state,
+			      uint64_t *entry_ts,
+			      uint64_t now)
+{
+	if (*entry_ts == 0)
+		return;
+
+	assert(local_state > PSCI_LOCAL_STATE_RUN &&
+	       local_state <= PLAT_MAX_OFF_STATE);
+
+	psci_stat[local_state - 1].residency += now - *entry_ts;
+	psci_stat[local_state - 1].count++;
+	*entry_ts = 0;
+}
+
+/*******************************************************************************
+ * This function records the time at which the current CPU, and each of its
+ * ancestor power domains up to 'end_pwrlvl' for which it is the last CPU to
+ * suspend, start entering the target states in 'state_info'. It must be called
+ * after state coordination, with the locks of these power domains held. No lock
+ * is needed when 'end_pwrlvl' is the CPU power level.
+ ******************************************************************************/
+void psci_stats_update_pwr_down(unsigned int end_pwrlvl,
+				const psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	uint64_t now = read_cntpct_el0();
+
+	psci_cpu_stat_ts[cpu_idx] = now;
+
+	parent_idx = psci_cpu_parent_node(cpu_idx);
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
+		if (is_local_state_run(state_info->pwr_domain_state[lvl]))
+			break;
+
+		psci_non_cpu_stat_ts[parent_idx] = now;
+		parent_idx = psci_node_parent_node(parent_idx);
+	}
+}
+
+/*******************************************************************************
+ * This function accounts the time spent by the current CPU in the local state
+ * 'state_info' holds for it, and by each of its ancestor power domains up to
+ * 'end_pwrlvl' for which it is the first CPU to wake up, i.e. whose node is not
+ * yet back to RUN. It must be called with the locks of these power domains
+ * held, before psci_set_pwr_domains_to_run(). No lock is needed when
+ * 'end_pwrlvl' is the CPU power level.
+ ******************************************************************************/
+void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
+			      const psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	plat_local_state_t local_state;
+	uint64_t now = read_cntpct_el0();
+
+	psci_stat_account(psci_cpu_stat[cpu_idx],
+			  state_info->pwr_domain_state[PSCI_CPU_PWR_LVL],
+			  &psci_cpu_stat_ts[cpu_idx], now);
+
+	parent_idx = psci_cpu_parent_node(cpu_idx);
+	for (lvl = PSCI_CPU_PWR_LVL + 1; lvl <= end_pwrlvl; lvl++) {
+		local_state = psci_non_cpu_pd_states[parent_idx].local_state;
+		if (is_local_state_run(local_state))
+			break;
+
+		psci_stat_account(psci_non_cpu_stat[parent_idx], local_state,
+				  &psci_non_cpu_stat_ts[parent_idx], now);
+		parent_idx = psci_node_parent_node(parent_idx);
+	}
+}
+
+/*******************************************************************************
+ * This function returns the statistics of the local state that the power
+ * domain of 'target_cpu' at the level targeted by 'power_state' enters for
+ * this 'power_state'.
+ ******************************************************************************/
+static int psci_get_stat(u_register_t target_cpu,
+			 unsigned int power_state,
+			 psci_stat_t *psci_stat)
+{
+	int rc;
+	unsigned int pwrlvl, lvl, parent_idx, target_idx;
+	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
+	plat_local_state_t local_state;
+
+	if (psci_validate_mpidr(target_cpu) != PSCI_E_SUCCESS)
+		return PSCI_E_INVALID_PARAMS;
+
+	rc = psci_validate_power_state(power_state, &state_info);
+	if (rc != PSCI_E_SUCCESS)
+		return PSCI_E_INVALID_PARAMS;
+
+	pwrlvl = psci_find_target_suspend_lvl(&state_info);
+	if (pwrlvl == PSCI_INVALID_PWR_LVL)
+		return PSCI_E_INVALID_PARAMS;
+
+	local_state = state_info.pwr_domain_state[pwrlvl];
+	assert(local_state > PSCI_LOCAL_STATE_RUN &&
+	       local_state <= PLAT_MAX_OFF_STATE);
+
+	target_idx = plat_core_pos_by_mpidr(target_cpu);
+	if (pwrlvl == PSCI_CPU_PWR_LVL) {
+		*psci_stat = psci_cpu_stat[target_idx][local_state - 1];
+		return PSCI_E_SUCCESS;
+	}
+
+	parent_idx = psci_cpu_parent_node(target_idx);
+	for (lvl = PSCI_CPU_PWR_LVL + 2; lvl <= pwrlvl; lvl++)
+		parent_idx = psci_node_parent_node(parent_idx);
+
+	*psci_stat = psci_non_cpu_stat[parent_idx][local_state - 1];
+	return PSCI_E_SUCCESS;
+}
+
+/*******************************************************************************
+ * PSCI_STAT_RESIDENCY: returns the time in microseconds spent in the state
+ * described by 'power_state' by the power domain of 'target_cpu' at the target
+ * level of 'power_state', or 0 if the parameters are invalid.
+ ******************************************************************************/
+u_register_t psci_stat_residency(u_register_t target_cpu,
+				 unsigned int power_state)
+{
+	psci_stat_t psci_stat;
+	uint64_t freq;
+
+	if (psci_get_stat(target_cpu, power_state, &psci_stat) !=
+							PSCI_E_SUCCESS)
+		return 0;
+
+	freq = bl31_get_syscnt_freq();
+	assert(freq);
+
+	/* Convert the ticks without overflowing for long residencies */
+	return (psci_stat.residency / freq) * 1000000 +
+		((psci_stat.residency % freq) * 1000000) / freq;
+}
+
+/*******************************************************************************
+ * PSCI_STAT_COUNT: returns the number of times the power domain of
+ * 'target_cpu' at the target level of 'power_state' has entered the state
+ * described by 'power_state', or 0 if the parameters are invalid.
+ ******************************************************************************/
+u_register_t psci_stat_count(u_register_t target_cpu,
+			     unsigned int power_state)
+{
+	psci_stat_t psci_stat;
+
+	if (psci_get_stat(target_cpu, power_state, &psci_stat) !=
+							PSCI_E_SUCCESS)
+		return 0;
+
+	return psci_stat.count;
+}
+
+/*******************************************************************************
+ * This function returns the power level of power domain 'node' and the
+ * statistics of its local state 'local_state', for the EL3 telemetry. 'node'
+ * is a CPU linear index below PLATFORM_CORE_COUNT and PLATFORM_CORE_COUNT plus
+ * a non-CPU power domain index above. It returns -1 if either argument is out
+ * of range.
+ ******************************************************************************/
+int psci_stat_read(unsigned int node,
+		   unsigned int local_state,
+		   unsigned int *pwrlvl,
+		   uint64_t *residency,
+		   uint64_t *count)
+{
+	psci_stat_t *psci_stat;
+
+	if (local_state <= PSCI_LOCAL_STATE_RUN ||
+	    local_state > PLAT_MAX_OFF_STATE)
+		return -1;
+
+	if (node < PLATFORM_CORE_COUNT) {
+		*pwrlvl = PSCI_CPU_PWR_LVL;
+		psci_stat = &psci_cpu_stat[node][local_state - 1];
+	} else if (node < PLATFORM_CORE_COUNT + PSCI_NUM_NON_CPU_PWR_DOMAINS) {
+		node -= PLATFORM_CORE_COUNT;
+		*pwrlvl = psci_non_cpu_pd_nodes[node].level;
+		psci_stat = &psci_non_cpu_stat[node][local_state - 1];
+	} else {
+		return -1;
+	}
+
+	*residency = psci_stat->residency;
+	*count = psci_stat->count;
+
+	return 0;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
  * modification, are permitted provided that the following conditions are met:
@@ -30,12 +30,14 @@
 
 #include <assert.h>
 #include <bl_common.h>
+#include <bl31.h>
 #include <arch.h>
 #include <arch_helpers.h>
 #include <context.h>
 #include <context_mgmt.h>
 #include <cpu_data.h>
 #include <debug.h>
+#include <el3_timer.h>
 #include <platform.h>
 #include <runtime_svc.h>
 #include <stddef.h>
@@ -52,11 +54,17 @@ static void psci_suspend_to_standby_finisher(unsigned int cpu_idx,
 	psci_acquire_pwr_domain_locks(end_pwrlvl,
 				cpu_idx);
 
+#if ENABLE_PSCI_STAT
+	psci_stats_update_pwr_up(end_pwrlvl, state_info);
+#endif
+	psci_trace(PSCI_TRACE_WAKEUP, psci_trace_states(state_info));
+
 	/*
 	 * Plat. management: Allow the platform to do operations
 	 * on waking up from retention.
 	 */
 	psci_plat_pm_ops->pwr_domain_suspend_finish(state_info);
+	psci_latency_record_exit(state_info);
 
 	/*
 	 * Set the requested and target state of this CPU and all the higher
@@ -85,7 +93,7 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
 	 * Flush the target power level as it will be accessed on power up with
 	 * Data cache disabled.
 	 */
-	flush_cpu_data(psci_svc_cpu_data.target_pwrlvl);
+	psci_flush_cpu_data(psci_svc_cpu_data.target_pwrlvl);
 
 	/*
 	 * Call the cpu suspend handler registered by the Secure Payload
@@ -95,19 +103,33 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
 	if (psci_spd_pm && psci_spd_pm->svc_suspend)
 		psci_spd_pm->svc_suspend(max_off_lvl);
 
+#if CTX_LAZY_FPREGS
+	/* The FP registers may hold the only copy of the FP state of a world */
+	cm_fpregs_context_save_live();
+#endif
+
 	/*
 	 * Store the re-entry information for the non-secure world.
 	 */
 	cm_init_my_context(ep);
 
+#if PSCI_SYS_SUSPEND_OPS
+	/* Save the state which the system components lose when powered down */
+	if (max_off_lvl == PLAT_MAX_PWR_LVL)
+		psci_sys_suspend_save();
+#endif
+
+	/* The data cache is disabled from here on */
+	psci_latency_record_entry(state_info);
+
 	/*
 	 * Arch. management. Perform the necessary steps to flush all
-	 * cpu caches. Currently we assume that the power level correspond
-	 * the cache level.
-	 * TODO : Introduce a mechanism to query the cache level to flush
-	 * and the cpu-ops power down to perform from the platform.
+	 * cpu caches. The power level corresponds to the cache level, unless
+	 * the platform reports that the caches of a level being powered down
+	 * are retained.
 	 */
-	psci_do_pwrdown_cache_maintenance(max_off_lvl);
+	psci_do_pwrdown_cache_maintenance(
+				psci_find_pwr_down_cache_lvl(state_info));
 }
 
 /*******************************************************************************
@@ -126,14 +148,16 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
  *
  * All the required parameter checks are performed at the beginning and after
  * the state transition has been done, no further error is expected and it is
- * not possible to undo any of the actions taken beyond that point.
+ * not possible to undo any of the actions taken beyond that point. The only
+ * error returned is PSCI_E_DENIED, in OS-initiated mode, when the CPU requests
+ * a low power state for a power domain in which another CPU is running.
  ******************************************************************************/
-void psci_cpu_suspend_start(entry_point_info_t *ep,
-			    unsigned int end_pwrlvl,
-			    psci_power_state_t *state_info,
-			    unsigned int is_power_down_state)
+int psci_cpu_suspend_start(entry_point_info_t *ep,
+			   unsigned int end_pwrlvl,
+			   psci_power_state_t *state_info,
+			   unsigned int is_power_down_state)
 {
-	int skip_wfi = 0;
+	int skip_wfi = 0, rc = PSCI_E_SUCCESS;
 	unsigned int idx = plat_my_core_pos();
 
 	/*
@@ -143,6 +167,14 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 	assert(psci_plat_pm_ops->pwr_domain_suspend &&
 			psci_plat_pm_ops->pwr_domain_suspend_finish);
 
+	psci_trace(PSCI_TRACE_SUSPEND, psci_trace_states(state_info));
+
+#if PSCI_RESIDENCY_PREDICTOR
+	/* Record the next wakeup before the requested states are published */
+	psci_record_next_wakeup();
+#endif
+	psci_latency_suspend_start();
+
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
@@ -150,6 +182,7 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 	 */
 	psci_acquire_pwr_domain_locks(end_pwrlvl,
 				      idx);
+	psci_trace(PSCI_TRACE_LOCKS_ACQUIRED, end_pwrlvl);
 
 	/*
 	 * We check if there are any pending interrupts after the delay
@@ -166,7 +199,43 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 	 * it returns the negotiated state info for each power level upto
 	 * the end level specified.
 	 */
+#if PSCI_OS_INIT_MODE
+	if (psci_is_os_init_mode()) {
+		/* The requested states are the target states */
+		rc = psci_do_os_init_coordination(end_pwrlvl, state_info);
+		if (rc != PSCI_E_SUCCESS) {
+			skip_wfi = 1;
+			goto exit;
+		}
+	} else {
+		psci_do_state_coordination(end_pwrlvl, state_info);
+	}
+#else
 	psci_do_state_coordination(end_pwrlvl, state_info);
+#endif
+
+#if PSCI_RESIDENCY_PREDICTOR
+	/*
+	 * Avoid powering down the power domains which are predicted to be
+	 * woken up too soon for it to be worth it. In OS-initiated mode, the
+	 * choice of the target states is left to the OS.
+	 */
+	if (!psci_is_os_init_mode())
+		psci_predict_pwr_states(end_pwrlvl, state_info);
+#endif
+
+	psci_trace(PSCI_TRACE_COORD_RESULT, psci_trace_states(state_info));
+
+#if ENABLE_PSCI_STAT
+	psci_stats_update_pwr_down(end_pwrlvl, state_info);
+#endif
+
+	/*
+	 * The data cache is disabled while preparing to power down, so the
+	 * platform handler can only be traced with the preparation, and its
+	 * end cannot be traced at all in this case.
+	 */
+	psci_trace(PSCI_TRACE_SUSPEND_PLAT_START, is_power_down_state);
 
 	if (is_power_down_state)
 		psci_suspend_to_pwrdown_start(end_pwrlvl, ep, state_info);
@@ -179,6 +248,9 @@ void psci_cpu_suspend_start(entry_point_info_t *ep,
 	 */
 	psci_plat_pm_ops->pwr_domain_suspend(state_info);
 
+	if (!is_power_down_state)
+		psci_trace(PSCI_TRACE_SUSPEND_PLAT_END, 0);
+
 exit:
 	/*
 	 * Release the locks corresponding to each power level in the
@@ -187,23 +259,30 @@ exit:
 	psci_release_pwr_domain_locks(end_pwrlvl,
 				  idx);
 	if (skip_wfi)
-		return;
+		return rc;
 
-	if (is_power_down_state)
+	if (is_power_down_state) {
+		psci_progress_pwrdown();
 		psci_power_down_wfi();
+	}
 
 	/*
 	 * We will reach here if only retention/standby states have been
 	 * requested at multiple power levels. This means that the cpu
 	 * context will be preserved.
 	 */
+	psci_latency_record_entry(state_info);
+	el3_progress(EL3_PROGRESS_IDLE, 0);
 	wfi();
+	el3_progress(EL3_PROGRESS_PSCI, PSCI_TRACE_WAKEUP);
 
 	/*
 	 * After we wake up from context retaining suspend, call the
 	 * context retaining suspend finisher.
 	 */
 	psci_suspend_to_standby_finisher(idx, state_info, end_pwrlvl);
+
+	return PSCI_E_SUCCESS;
 }
 
 /*******************************************************************************
@@ -221,6 +300,12 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx,
 	assert(psci_get_aff_info_state() == AFF_STATE_ON && is_local_state_off(\
 			state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]));
 
+#if PSCI_SYS_SUSPEND_OPS
+	/* Restore the system components first if they were powered down */
+	if (psci_find_max_off_lvl(state_info) == PLAT_MAX_PWR_LVL)
+		psci_sys_suspend_restore();
+#endif
+
 	/*
 	 * Plat. management: Perform the platform specific actions
 	 * before we change the state of the cpu e.g. enabling the
@@ -237,8 +322,11 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx,
 	 */
 	psci_do_pwrup_cache_maintenance();
 
+	/* The secure physical timer has lost its state */
+	el3_timer_restore();
+
 	/* Re-init the cntfrq_el0 register */
-	counter_freq = plat_get_syscnt_freq();
+	counter_freq = bl31_get_syscnt_freq();
 	write_cntfrq_el0(counter_freq);
 
 	/*
@@ -252,7 +340,10 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx,
 		psci_spd_pm->svc_suspend_finish(max_off_lvl);
 	}
 
-	/* Invalidate the suspend level for the cpu */
+	/*
+	 * Invalidate the suspend level for the cpu. It is published before the
+	 * next power down, either by the next suspend or by psci_do_cpu_off().
+	 */
 	psci_set_suspend_pwrlvl(PSCI_INVALID_PWR_LVL);
 
 	/*
@@ -261,4 +352,6 @@ void psci_cpu_suspend_finish(unsigned int cpu_idx,
 	 * call to set this cpu on its way.
 	 */
 	cm_prepare_el3_exit(NON_SECURE);
+
+	psci_latency_record_exit(state_info);
 }
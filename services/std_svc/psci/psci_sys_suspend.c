@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl_common.h>
+#include <context.h>
+#include <context_mgmt.h>
+#include <debug.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <stdint.h>
+#include "psci_private.h"
+
+/* The default size of the buffer holding the state of the system handlers */
+#ifndef PLAT_SYS_SUSPEND_STATE_SIZE
+#define PLAT_SYS_SUSPEND_STATE_SIZE	256
+#endif
+
+#if CTX_SUSPEND_PACK
+/*
+ * The contexts of all the CPUs are packed at the start of the system suspend
+ * state, so that the platform only needs to retain this buffer for them.
+ */
+#define PSCI_CTX_PACK_SIZE	CM_PACKED_CONTEXTS_SIZE(PLATFORM_CORE_COUNT)
+#else
+#define PSCI_CTX_PACK_SIZE	0
+#endif
+
+#define PSCI_MAX_SYS_SUSPEND_OPS	16
+
+#define SYS_SUSPEND_STATE_ALIGN		sizeof(uint64_t)
+
+extern const psci_sys_suspend_ops_t __PSCI_SYS_SUSPEND_OPS_START__[];
+extern const psci_sys_suspend_ops_t __PSCI_SYS_SUSPEND_OPS_END__[];
+
+/*
+ * The system suspend handlers sorted in increasing order, with the offset of
+ * their state in 'sys_suspend_state'. They are read with the data cache
+ * disabled when the system powers up.
+ */
+static const psci_sys_suspend_ops_t *sys_suspend_ops[PSCI_MAX_SYS_SUSPEND_OPS];
+static unsigned int sys_suspend_state_off[PSCI_MAX_SYS_SUSPEND_OPS];
+static unsigned int sys_suspend_ops_num;
+
+static uint64_t sys_suspend_state[(PLAT_SYS_SUSPEND_STATE_SIZE +
+				   PSCI_CTX_PACK_SIZE) / sizeof(uint64_t)];
+
+/*******************************************************************************
+ * This function sorts the system suspend handlers declared in the image and
+ * lays out their state in 'sys_suspend_state'. It is called once from
+ * psci_setup().
+ ******************************************************************************/
+void __init psci_sys_suspend_init(void)
+{
+	const psci_sys_suspend_ops_t *ops;
+	unsigned int i, n = 0, off = PSCI_CTX_PACK_SIZE;
+
+	if (__PSCI_SYS_SUSPEND_OPS_END__ - __PSCI_SYS_SUSPEND_OPS_START__ >
+						PSCI_MAX_SYS_SUSPEND_OPS) {
+		ERROR("PSCI: Too many system suspend handlers\n");
+		panic();
+	}
+
+	/* Insert each handler after those of lower or equal order */
+	for (ops = __PSCI_SYS_SUSPEND_OPS_START__;
+	     ops < __PSCI_SYS_SUSPEND_OPS_END__; ops++) {
+		for (i = n; i > 0 && sys_suspend_ops[i - 1]->order >
+								ops->order; i--)
+			sys_suspend_ops[i] = sys_suspend_ops[i - 1];
+		sys_suspend_ops[i] = ops;
+		n++;
+	}
+
+	for (i = 0; i < n; i++) {
+		sys_suspend_state_off[i] = off;
+		off += (sys_suspend_ops[i]->state_size +
+			SYS_SUSPEND_STATE_ALIGN - 1) &
+					~(SYS_SUSPEND_STATE_ALIGN - 1);
+	}
+
+	if (off > sizeof(sys_suspend_state)) {
+		ERROR("PSCI: System suspend handlers need %u bytes of state\n",
+		      (unsigned int)(off - PSCI_CTX_PACK_SIZE));
+		panic();
+	}
+
+	sys_suspend_ops_num = n;
+
+	flush_dcache_range((uintptr_t)sys_suspend_ops, sizeof(sys_suspend_ops));
+	flush_dcache_range((uintptr_t)sys_suspend_state_off,
+			   sizeof(sys_suspend_state_off));
+	flush_dcache_range((uintptr_t)&sys_suspend_ops_num,
+			   sizeof(sys_suspend_ops_num));
+
+	INFO("PSCI: %u system suspend handlers, %u bytes of state\n", n,
+	     (unsigned int)(off - PSCI_CTX_PACK_SIZE));
+}
+
+/*******************************************************************************
+ * This function saves the state of the system components in the reverse order
+ * of the handlers. It is called on the last CPU to power down before the
+ * system power domain is powered down, with the data cache enabled.
+ ******************************************************************************/
+void psci_sys_suspend_save(void)
+{
+	unsigned int i = sys_suspend_ops_num;
+	uintptr_t state = (uintptr_t)sys_suspend_state;
+
+	while (i--) {
+		if (sys_suspend_ops[i]->save)
+			sys_suspend_ops[i]->save(
+				(void *)(state + sys_suspend_state_off[i]));
+	}
+
+#if CTX_SUSPEND_PACK
+	/* The contexts are saved last as the handlers may still update them */
+	cm_pack_contexts(sys_suspend_state);
+#endif
+
+	/* The state is restored with the data cache disabled */
+	flush_dcache_range(state, sizeof(sys_suspend_state));
+}
+
+/*******************************************************************************
+ * This function restores the state of the system components in a single pass
+ * over the handlers. It is called on the first CPU to power up after the
+ * system power domain has been powered down, with the data cache disabled.
+ ******************************************************************************/
+void psci_sys_suspend_restore(void)
+{
+	unsigned int i;
+	uintptr_t state = (uintptr_t)sys_suspend_state;
+
+#if CTX_SUSPEND_PACK
+	cm_unpack_contexts(sys_suspend_state);
+#endif
+
+	for (i = 0; i < sys_suspend_ops_num; i++) {
+		if (sys_suspend_ops[i]->restore)
+			sys_suspend_ops[i]->restore(
+				(const void *)(state + sys_suspend_state_off[i]));
+	}
+}
+
+/*******************************************************************************
+ * This function returns the buffer holding the state saved by the system
+ * suspend handlers and, with CTX_SUSPEND_PACK, the packed CPU contexts. A
+ * platform which powers down most of its memory over a system suspend uses it
+ * to find the region to retain.
+ ******************************************************************************/
+const void *psci_get_sys_suspend_state(size_t *size)
+{
+	*size = sizeof(sys_suspend_state);
+	return sys_suspend_state;
+}
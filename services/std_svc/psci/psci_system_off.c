@@ -33,11 +33,30 @@
 #include <assert.h>
 #include <debug.h>
 #include <platform.h>
+#include <platform_def.h>
+#include <warm_reboot.h>
 #include "psci_private.h"
 
+#if MEASURE_STACK_USAGE
+/*******************************************************************************
+ * Print the deepest use of the stack of each cpu since cold boot
+ ******************************************************************************/
+static void psci_print_stack_usage(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		NOTICE("BL31: CPU %u stack usage: %u of %u bytes\n", i,
+		       plat_get_stack_usage(i), PLATFORM_STACK_SIZE);
+}
+#else
+#define psci_print_stack_usage()
+#endif
+
 void psci_system_off(void)
 {
 	psci_print_power_domain_map();
+	psci_print_stack_usage();
 
 	assert(psci_plat_pm_ops->system_off);
 
@@ -55,6 +74,7 @@ void psci_system_off(void)
 void psci_system_reset(void)
 {
 	psci_print_power_domain_map();
+	psci_print_stack_usage();
 
 	assert(psci_plat_pm_ops->system_reset);
 
@@ -63,6 +83,11 @@ void psci_system_reset(void)
 		psci_spd_pm->svc_system_reset();
 	}
 
+#if FAST_WARM_REBOOT
+	/* Let BL2 reuse the images still resident in memory on the next boot */
+	warm_reboot_arm();
+#endif
+
 	/* Call the platform specific hook */
 	psci_plat_pm_ops->system_reset();
 
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <crash_dump.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci_trace.h>
+#include "psci_private.h"
+
+typedef struct psci_trace_buf {
+	/* Sequence number of the next event to be recorded */
+	uint64_t next_seq;
+	psci_trace_entry_t entries[PSCI_TRACE_ENTRIES];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_trace_buf_t;
+
+/*
+ * Each ring buffer is only written by its CPU, and always with the data cache
+ * enabled.
+ */
+static psci_trace_buf_t psci_trace_bufs[PLATFORM_CORE_COUNT];
+
+#if CRASH_DUMP
+/* The ring buffer of the crashing CPU is saved in its crash dump */
+const crash_dump_region_t psci_trace_dump_region = {
+	(uintptr_t) psci_trace_bufs,
+	sizeof(psci_trace_buf_t),
+	sizeof(psci_trace_buf_t)
+};
+#endif
+
+/* Sequence number marking an entry being written */
+#define PSCI_TRACE_SEQ_BUSY		~0ULL
+
+/*******************************************************************************
+ * This function records 'event' and its argument 'arg' in the ring buffer of
+ * the calling CPU. It must only be called with the data cache enabled.
+ ******************************************************************************/
+void psci_trace_event(unsigned int event, unsigned int arg)
+{
+	psci_trace_buf_t *buf = &psci_trace_bufs[plat_my_core_pos()];
+	uint64_t seq = buf->next_seq;
+	psci_trace_entry_t *entry;
+
+	entry = &buf->entries[seq & (PSCI_TRACE_ENTRIES - 1)];
+
+	/*
+	 * Invalidate the entry while it is updated so that a concurrent reader
+	 * can detect a torn copy.
+	 */
+	entry->seq = PSCI_TRACE_SEQ_BUSY;
+	dmbst();
+
+	entry->timestamp = read_cntpct_el0();
+	entry->event = event;
+	entry->arg = arg;
+	dmbst();
+
+	entry->seq = seq;
+	buf->next_seq = seq + 1;
+}
+
+/*******************************************************************************
+ * This function packs the local states of the power levels in 'state_info' in
+ * the argument of an event, one byte per level.
+ ******************************************************************************/
+unsigned int psci_trace_states(const psci_power_state_t *state_info)
+{
+	unsigned int lvl, states = 0;
+
+	for (lvl = PSCI_CPU_PWR_LVL; lvl <= PLAT_MAX_PWR_LVL && lvl < 4; lvl++)
+		states |= state_info->pwr_domain_state[lvl] << (lvl * 8);
+
+	return states;
+}
+
+/*******************************************************************************
+ * This function copies the event with sequence number 'seq' of the CPU with
+ * linear index 'cpu_idx' to 'entry', and returns in 'next_seq' the sequence
+ * number of the next event that this CPU will record. The events still present
+ * in the ring buffer are the PSCI_TRACE_ENTRIES ones before 'next_seq'. It
+ * returns PSCI_TRACE_E_NOT_AVAIL if the requested event is not one of them or
+ * is overwritten during the copy.
+ ******************************************************************************/
+int psci_trace_read(unsigned int cpu_idx,
+		    uint64_t seq,
+		    psci_trace_entry_t *entry,
+		    uint64_t *next_seq)
+{
+	psci_trace_buf_t *buf;
+	psci_trace_entry_t *src;
+
+	assert(cpu_idx < PLATFORM_CORE_COUNT);
+	assert(entry && next_seq);
+
+	buf = &psci_trace_bufs[cpu_idx];
+	src = &buf->entries[seq & (PSCI_TRACE_ENTRIES - 1)];
+
+	entry->seq = src->seq;
+	dmbld();
+	entry->timestamp = src->timestamp;
+	entry->event = src->event;
+	entry->arg = src->arg;
+	dmbld();
+
+	*next_seq = buf->next_seq;
+
+	if (entry->seq != seq || src->seq != seq)
+		return PSCI_TRACE_E_NOT_AVAIL;
+
+	return 0;
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <arm_sip_svc.h>
+#include <console.h>
+#include <debug.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Boot time benchmark, run as BL33. It reads back the boot-path timestamps
+ * recorded by BL1, BL2 and BL31 (ARM_BOOT_TIMESTAMPS) and the loading
+ * statistics BL2 adds to them (LOAD_IMAGE_STATS), and prints one line per
+ * stage and per image. Each line starts with "BOOT_TS" followed by space
+ * separated key=value fields, all times being in microseconds:
+ *
+ *   BOOT_TS freq_hz=<system counter frequency>
+ *   BOOT_TS stage=<BL1|BL2|BL31> start_us=<time of entry> us=<duration>
+ *   BOOT_TS image=<image ID> load_us=<time> bytes=<n> io_us=<t> auth_us=<t>
+ *   BOOT_TS bl33_entry_us=<time> total_us=<time from BL1 entry>
+ *   BOOT_TS end status=<ok|error>
+ *
+ * The fields of an image line are those available: 'load_us' is the time from
+ * the previous marker to the one recorded once the image is loaded, the other
+ * fields need LOAD_IMAGE_STATS. The image IDs are defined in tbbr_img_def.h.
+ ******************************************************************************/
+
+/*
+ * Markers and records of arm_boot_ts.h, which cannot be included here as it
+ * depends on the platform ports of the firmware. Keep them in sync.
+ */
+#define ARM_BOOT_TS_BL1_ENTRY		0x01
+#define ARM_BOOT_TS_BL1_EXIT		0x03
+#define ARM_BOOT_TS_BL2_ENTRY		0x11
+#define ARM_BOOT_TS_IMAGE_LOADED	0x13
+#define ARM_BOOT_TS_BL2_EXIT		0x14
+#define ARM_BOOT_TS_BL31_ENTRY		0x21
+#define ARM_BOOT_TS_BL31_EXIT		0x22
+#define ARM_BOOT_TS_IMAGE_BYTES		0x31
+#define ARM_BOOT_TS_IMAGE_TICKS		0x32
+#define ARM_BOOT_TS_MAX_RECS		60
+
+/* Image IDs above this are not reported, as LOAD_STATS_MAX_IMAGES */
+#define BENCH_BOOT_MAX_IMAGES		32
+
+typedef struct bench_boot_rec {
+	uint32_t id;
+	uint32_t arg;
+	uint64_t timestamp;
+} bench_boot_rec_t;
+
+typedef struct bench_boot_smc_args {
+	uint64_t x0;
+	uint64_t x1;
+	uint64_t x2;
+	uint64_t x3;
+} bench_boot_smc_args_t;
+
+typedef struct bench_boot_image {
+	uint64_t load_ticks;
+	uint64_t bytes;
+	uint64_t io_ticks;
+	uint64_t auth_ticks;
+	unsigned int flags;
+} bench_boot_image_t;
+
+#define IMAGE_HAS_LOAD			(1 << 0)
+#define IMAGE_HAS_STATS			(1 << 1)
+
+/* Markers of the entry and of the exit of each stage */
+static const struct {
+	const char *name;
+	unsigned int entry;
+	unsigned int exit;
+} bench_boot_stages[] = {
+	{ "BL1", ARM_BOOT_TS_BL1_ENTRY, ARM_BOOT_TS_BL1_EXIT },
+	{ "BL2", ARM_BOOT_TS_BL2_ENTRY, ARM_BOOT_TS_BL2_EXIT },
+	{ "BL31", ARM_BOOT_TS_BL31_ENTRY, ARM_BOOT_TS_BL31_EXIT },
+};
+
+#define NUM_STAGES	(sizeof(bench_boot_stages) / \
+			 sizeof(bench_boot_stages[0]))
+
+static bench_boot_rec_t recs[ARM_BOOT_TS_MAX_RECS];
+static bench_boot_image_t images[BENCH_BOOT_MAX_IMAGES];
+static uint64_t freq;
+
+void bench_boot_smc(bench_boot_smc_args_t *args);
+void bench_boot_main(uint64_t bl33_entry) __dead2;
+
+static uint64_t ticks_to_us(uint64_t ticks)
+{
+	return ticks * 1000000 / freq;
+}
+
+/* Read the records through the SiP service, return their number */
+static unsigned int read_records(void)
+{
+	bench_boot_smc_args_t args;
+	unsigned int i;
+
+	for (i = 0; i < ARM_BOOT_TS_MAX_RECS; i++) {
+		args.x0 = ARM_SIP_BOOT_TS_READ;
+		args.x1 = i;
+		args.x2 = 0;
+		args.x3 = 0;
+		bench_boot_smc(&args);
+		if (args.x0)
+			break;
+
+		recs[i].id = args.x1 & 0xffffffff;
+		recs[i].arg = args.x1 >> 32;
+		recs[i].timestamp = args.x2;
+	}
+
+	return i;
+}
+
+/* Return the timestamp of the first marker 'id', 0 if there is none */
+static uint64_t find_marker(unsigned int num_recs, unsigned int id)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_recs; i++) {
+		if (recs[i].id == id)
+			return recs[i].timestamp;
+	}
+
+	return 0;
+}
+
+static void report_stages(unsigned int num_recs)
+{
+	uint64_t entry, exit;
+	unsigned int i;
+
+	for (i = 0; i < NUM_STAGES; i++) {
+		entry = find_marker(num_recs, bench_boot_stages[i].entry);
+		exit = find_marker(num_recs, bench_boot_stages[i].exit);
+		if (!entry || exit < entry)
+			continue;
+
+		tf_printf("BOOT_TS stage=%s start_us=%lu us=%lu\n",
+			  bench_boot_stages[i].name, ticks_to_us(entry),
+			  ticks_to_us(exit - entry));
+	}
+}
+
+static void report_images(unsigned int num_recs)
+{
+	bench_boot_image_t *image;
+	bench_boot_rec_t *rec;
+	uint64_t prev = 0;
+	unsigned int i;
+
+	for (i = 0; i < num_recs; i++) {
+		rec = &recs[i];
+		image = rec->arg < BENCH_BOOT_MAX_IMAGES ?
+			&images[rec->arg] : NULL;
+
+		switch (rec->id) {
+		case ARM_BOOT_TS_IMAGE_LOADED:
+			if (image) {
+				image->load_ticks = prev ?
+					rec->timestamp - prev : 0;
+				image->flags |= IMAGE_HAS_LOAD;
+			}
+			break;
+		case ARM_BOOT_TS_IMAGE_BYTES:
+			if (image) {
+				image->bytes = rec->timestamp;
+				image->flags |= IMAGE_HAS_STATS;
+			}
+			/* The statistics records hold no timestamp */
+			continue;
+		case ARM_BOOT_TS_IMAGE_TICKS:
+			if (image) {
+				image->io_ticks = rec->timestamp & 0xffffffff;
+				image->auth_ticks = rec->timestamp >> 32;
+			}
+			continue;
+		default:
+			break;
+		}
+
+		prev = rec->timestamp;
+	}
+
+	for (i = 0; i < BENCH_BOOT_MAX_IMAGES; i++) {
+		image = &images[i];
+		if (!image->flags)
+			continue;
+
+		tf_printf("BOOT_TS image=%u", i);
+		if (image->flags & IMAGE_HAS_LOAD)
+			tf_printf(" load_us=%lu",
+				  ticks_to_us(image->load_ticks));
+		if (image->flags & IMAGE_HAS_STATS)
+			tf_printf(" bytes=%lu io_us=%lu auth_us=%lu",
+				  image->bytes, ticks_to_us(image->io_ticks),
+				  ticks_to_us(image->auth_ticks));
+		tf_printf("\n");
+	}
+}
+
+void __dead2 bench_boot_main(uint64_t bl33_entry)
+{
+	unsigned int num_recs;
+	uint64_t bl1_entry;
+
+	console_init(BENCH_UART_BASE, BENCH_UART_CLK_IN_HZ,
+		     BENCH_UART_BAUDRATE);
+	freq = read_cntfrq_el0();
+
+	num_recs = read_records();
+	if (!num_recs || !freq) {
+		tf_printf("BOOT_TS end status=error\n");
+	} else {
+		tf_printf("BOOT_TS freq_hz=%lu\n", freq);
+		report_stages(num_recs);
+		report_images(num_recs);
+
+		bl1_entry = find_marker(num_recs, ARM_BOOT_TS_BL1_ENTRY);
+		tf_printf("BOOT_TS bl33_entry_us=%lu total_us=%lu\n",
+			  ticks_to_us(bl33_entry),
+			  ticks_to_us(bl33_entry - bl1_entry));
+		tf_printf("BOOT_TS end status=ok\n");
+	}
+
+#if BENCH_SYSTEM_OFF
+	{
+		bench_boot_smc_args_t args = { PSCI_SYSTEM_OFF, 0, 0, 0 };
+
+		bench_boot_smc(&args);
+	}
+#endif
+	for (;;)
+		wfi();
+}
@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host simulation of the image loading done by BL2. The IO, FIP and
+ * authentication modules of the firmware are built for the host and run the
+ * BL2 load-and-verify sequence against a FIP file, so that its cost can be
+ * profiled and checked for regressions without a target.
+ */
+
+#include <auth_mod.h>
+#include <bl_common.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <firmware_image_package.h>
+#include <getopt.h>
+#include <io_storage.h>
+#include <load_stats.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "boot_sim.h"
+
+#define MAX_RUNS			100000
+
+/* Images loaded by BL2, in the order it loads them */
+typedef struct sim_image {
+	unsigned int image_id;
+	const char *name;
+	int required;
+	/* Results */
+	int present;
+	size_t size;
+	uint64_t min_ns;
+	uint64_t max_ns;
+	uint64_t total_ns;
+} sim_image_t;
+
+static sim_image_t images[] = {
+	{ SCP_BL2_IMAGE_ID, "SCP_BL2", 0 },
+	{ BL31_IMAGE_ID, "BL31", 1 },
+	{ BL32_IMAGE_ID, "BL32", 0 },
+	{ BL33_IMAGE_ID, "BL33", 1 },
+};
+
+static uint64_t run_min_ns = UINT64_MAX, run_max_ns, run_total_ns;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void print_usage(void)
+{
+	printf("Usage: boot_sim [options] FIP_FILENAME\n\n");
+	printf("Load and authenticate the images of a FIP like BL2 does.\n\n");
+	printf("Options:\n");
+	printf("\t--help: Print this help message and exit\n");
+	printf("\t--runs N: Repeat the boot flow N times (default: 1)\n");
+	printf("\t--mem-size BYTES: Size of the memory the images are loaded"
+	       " into (default: 0x%X)\n", SIM_DEFAULT_MEM_SIZE);
+#if TRUSTED_BOARD_BOOT
+	printf("\t--rotpk-hash FILE: File holding the SHA-256 of the ROTPK"
+	       " (default: ARM development key)\n");
+#endif
+	printf("\n");
+}
+
+#if TRUSTED_BOARD_BOOT
+static int read_rotpk_hash(const char *filename)
+{
+	FILE *fp;
+	size_t len;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL) {
+		printf("ERROR: Cannot open %s: %s\n", filename,
+		       strerror(errno));
+		return errno;
+	}
+
+	len = fread(sim_rotpk_hash, 1, SIM_ROTPK_HASH_LEN, fp);
+	fclose(fp);
+	if (len != SIM_ROTPK_HASH_LEN) {
+		printf("ERROR: %s does not hold a SHA-256 hash\n", filename);
+		return EINVAL;
+	}
+
+	return 0;
+}
+#endif
+
+/*
+ * The firmware trusts the ToC read from the flash. Check that the FIP file is
+ * well formed first, so that a truncated or corrupt file is reported rather
+ * than read out of bounds.
+ */
+static int check_fip(const uint8_t *fip, size_t fip_size)
+{
+	const fip_toc_header_t *toc_header = (const fip_toc_header_t *)fip;
+	const fip_toc_entry_t *toc_entry;
+	const uuid_t uuid_null = {0};
+
+	if ((fip_size < sizeof(*toc_header)) ||
+	    (toc_header->name != TOC_HEADER_NAME)) {
+		printf("ERROR: Not a FIP\n");
+		return EINVAL;
+	}
+
+	for (toc_entry = (const fip_toc_entry_t *)(toc_header + 1); ;
+	     toc_entry++) {
+		if ((const uint8_t *)(toc_entry + 1) > fip + fip_size) {
+			printf("ERROR: FIP does not have an end ToC entry\n");
+			return EINVAL;
+		}
+		if (memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) == 0)
+			return 0;
+		if ((toc_entry->offset_address > fip_size) ||
+		    (toc_entry->size > fip_size - toc_entry->offset_address)) {
+			printf("ERROR: FIP has an entry out of bounds\n");
+			return EINVAL;
+		}
+	}
+}
+
+/* Check which of the images are in the FIP, and their size */
+static int find_images(void)
+{
+	uintptr_t dev_handle, image_spec, image_handle;
+	sim_image_t *image;
+	unsigned int i;
+	int result;
+
+	for (i = 0; i < ARRAY_SIZE(images); i++) {
+		image = &images[i];
+		result = plat_get_image_source(image->image_id, &dev_handle,
+					       &image_spec);
+		if (result == 0) {
+			result = io_open(dev_handle, image_spec,
+					 &image_handle);
+			if (result == 0) {
+				result = io_size(image_handle, &image->size);
+				io_close(image_handle);
+			}
+			io_dev_close(dev_handle);
+		}
+
+		if (result == 0) {
+			image->present = 1;
+		} else if (image->required) {
+			printf("ERROR: %s is not in the FIP\n", image->name);
+			return result;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Load all the images, one after the other in a memory area of 'mem_size'
+ * bytes, like BL2 loads them in its memory layout.
+ */
+static int boot(uintptr_t mem_base, size_t mem_size)
+{
+	meminfo_t mem_layout;
+	image_info_t image_info;
+	entry_point_info_t ep_info;
+	uintptr_t image_base = mem_base;
+	uint64_t start, run_start, ns;
+	sim_image_t *image;
+	unsigned int i;
+	int result;
+
+	mem_layout.total_base = mem_base;
+	mem_layout.total_size = mem_size;
+	mem_layout.free_base = mem_base;
+	mem_layout.free_size = mem_size;
+
+	run_start = now_ns();
+	for (i = 0; i < ARRAY_SIZE(images); i++) {
+		image = &images[i];
+		if (!image->present)
+			continue;
+
+		memset(&image_info, 0, sizeof(image_info));
+		SET_PARAM_HEAD(&image_info, PARAM_IMAGE_BINARY, VERSION_1, 0);
+		memset(&ep_info, 0, sizeof(ep_info));
+		SET_PARAM_HEAD(&ep_info, PARAM_EP, VERSION_1, 0);
+
+		start = now_ns();
+		result = load_auth_image(&mem_layout, image->image_id,
+					 image_base, &image_info, &ep_info);
+		ns = now_ns() - start;
+		if (result != 0) {
+			printf("ERROR: Failed to load %s (%i)\n", image->name,
+			       result);
+			return result;
+		}
+
+		if (ns < image->min_ns || image->total_ns == 0)
+			image->min_ns = ns;
+		if (ns > image->max_ns)
+			image->max_ns = ns;
+		image->total_ns += ns;
+
+		/*
+		 * The next image is loaded at the next page. An image used in
+		 * place does not take any memory.
+		 */
+		if (!(image_info.h.attr & IMAGE_ATTR_IN_PLACE)) {
+			image_base = page_align(image_base +
+						image_info.image_size, UP);
+		}
+	}
+
+	ns = now_ns() - run_start;
+	if (ns < run_min_ns)
+		run_min_ns = ns;
+	if (ns > run_max_ns)
+		run_max_ns = ns;
+	run_total_ns += ns;
+
+	return 0;
+}
+
+static void print_results(unsigned int runs)
+{
+	const sim_image_t *image;
+	unsigned int i;
+
+	printf("%-10s %12s %12s %12s %12s\n", "Image", "Size",
+	       "Min (us)", "Avg (us)", "Max (us)");
+	for (i = 0; i < ARRAY_SIZE(images); i++) {
+		image = &images[i];
+		if (!image->present)
+			continue;
+		printf("%-10s %12zu %12.1f %12.1f %12.1f\n", image->name,
+		       image->size, image->min_ns / 1000.0,
+		       image->total_ns / 1000.0 / runs,
+		       image->max_ns / 1000.0);
+	}
+	printf("%-10s %12s %12.1f %12.1f %12.1f\n", "Total", "",
+	       run_min_ns / 1000.0, run_total_ns / 1000.0 / runs,
+	       run_max_ns / 1000.0);
+
+	/* Time per phase, accumulated over all the runs */
+	load_stats_print();
+}
+
+int main(int argc, char *argv[])
+{
+	static const struct option long_options[] = {
+		{ "runs", required_argument, NULL, 'r' },
+		{ "mem-size", required_argument, NULL, 'm' },
+#if TRUSTED_BOARD_BOOT
+		{ "rotpk-hash", required_argument, NULL, 'k' },
+#endif
+		{ "help", no_argument, NULL, 'h' },
+		{ NULL, 0, NULL, 0 }
+	};
+	unsigned long runs = 1, run;
+	unsigned long long mem_size = SIM_DEFAULT_MEM_SIZE;
+	const char *fip_filename;
+	struct stat st;
+	void *fip_base, *mem_base;
+	char *end;
+	int fd, opt, result;
+
+	while ((opt = getopt_long(argc, argv, "r:m:k:h", long_options,
+				  NULL)) != -1) {
+		switch (opt) {
+		case 'r':
+			runs = strtoul(optarg, &end, 0);
+			if ((*end != '\0') || (runs == 0) ||
+			    (runs > MAX_RUNS)) {
+				printf("ERROR: Invalid number of runs \"%s\"\n",
+				       optarg);
+				return EINVAL;
+			}
+			break;
+		case 'm':
+			mem_size = strtoull(optarg, &end, 0);
+			if ((*end != '\0') || (mem_size == 0) ||
+			    (mem_size > SIZE_MAX)) {
+				printf("ERROR: Invalid memory size \"%s\"\n",
+				       optarg);
+				return EINVAL;
+			}
+			break;
+#if TRUSTED_BOARD_BOOT
+		case 'k':
+			result = read_rotpk_hash(optarg);
+			if (result != 0)
+				return result;
+			break;
+#endif
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return EINVAL;
+		}
+	}
+
+	if (optind != argc - 1) {
+		print_usage();
+		return EINVAL;
+	}
+	fip_filename = argv[optind];
+
+	/* The FIP is mapped like a flash device the firmware can read */
+	fd = open(fip_filename, O_RDONLY);
+	if ((fd < 0) || (fstat(fd, &st) != 0)) {
+		printf("ERROR: Cannot open %s: %s\n", fip_filename,
+		       strerror(errno));
+		return errno;
+	}
+	fip_base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (fip_base == MAP_FAILED) {
+		printf("ERROR: Cannot map %s: %s\n", fip_filename,
+		       strerror(errno));
+		return errno;
+	}
+
+	mem_base = mmap(NULL, mem_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mem_base == MAP_FAILED) {
+		printf("ERROR: Cannot allocate the memory: %s\n",
+		       strerror(errno));
+		return errno;
+	}
+
+	if (check_fip(fip_base, st.st_size) != 0)
+		return EXIT_FAILURE;
+
+	sim_io_setup((uintptr_t)fip_base, st.st_size);
+
+	result = find_images();
+	if (result != 0)
+		return EXIT_FAILURE;
+
+#if TRUSTED_BOARD_BOOT
+	auth_mod_init();
+#endif
+
+	for (run = 0; run < runs; run++) {
+		result = boot((uintptr_t)mem_base, mem_size);
+		if (result != 0)
+			return EXIT_FAILURE;
+	}
+
+	printf("%s: %lu run(s)\n", fip_filename, runs);
+	print_results(runs);
+
+	return 0;
+}
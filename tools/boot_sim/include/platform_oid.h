@@ -0,0 +1 @@
+../../../include/plat/arm/board/common/board_arm_oid.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../include/stdlib/sys/uuid.h
\ No newline at end of file
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Platform port of boot_sim. The FIP is mapped in memory and accessed through
+ * the memmap and FIP drivers, as on the ARM standard platforms. The console is
+ * the standard output of the host.
+ */
+
+#include <assert.h>
+#include <bl_common.h>
+#include <debug.h>
+#include <errno.h>
+#include <firmware_image_package.h>
+#include <io_driver.h>
+#include <io_fip.h>
+#include <io_memmap.h>
+#include <io_storage.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "boot_sim.h"
+
+/* ARM development ROTPK hash (plat/arm/board/common/rotpk) */
+uint8_t sim_rotpk_hash[SIM_ROTPK_HASH_LEN] = {
+	0xB0, 0xF3, 0x82, 0x09, 0x12, 0x97, 0xD8, 0x3A,
+	0x37, 0x7A, 0x72, 0x47, 0x1B, 0xEC, 0x32, 0x73,
+	0xE9, 0x92, 0x32, 0xE2, 0x49, 0x59, 0xF6, 0x5E,
+	0x8B, 0x4A, 0x4A, 0x46, 0xD8, 0x22, 0x9A, 0xDA,
+};
+
+/* IO devices */
+static const io_dev_connector_t *fip_dev_con;
+static uintptr_t fip_dev_handle;
+static const io_dev_connector_t *memmap_dev_con;
+static uintptr_t memmap_dev_handle;
+
+static io_block_spec_t fip_block_spec;
+
+static const io_uuid_spec_t scp_bl2_uuid_spec = {
+	.uuid = UUID_SCP_FIRMWARE_SCP_BL2,
+};
+
+static const io_uuid_spec_t bl31_uuid_spec = {
+	.uuid = UUID_EL3_RUNTIME_FIRMWARE_BL31,
+};
+
+static const io_uuid_spec_t bl32_uuid_spec = {
+	.uuid = UUID_SECURE_PAYLOAD_BL32,
+};
+
+static const io_uuid_spec_t bl33_uuid_spec = {
+	.uuid = UUID_NON_TRUSTED_FIRMWARE_BL33,
+};
+
+#if TRUSTED_BOARD_BOOT
+static const io_uuid_spec_t trusted_key_cert_uuid_spec = {
+	.uuid = UUID_TRUSTED_KEY_CERT,
+};
+
+static const io_uuid_spec_t scp_fw_key_cert_uuid_spec = {
+	.uuid = UUID_SCP_FW_KEY_CERT,
+};
+
+static const io_uuid_spec_t soc_fw_key_cert_uuid_spec = {
+	.uuid = UUID_SOC_FW_KEY_CERT,
+};
+
+static const io_uuid_spec_t tos_fw_key_cert_uuid_spec = {
+	.uuid = UUID_TRUSTED_OS_FW_KEY_CERT,
+};
+
+static const io_uuid_spec_t nt_fw_key_cert_uuid_spec = {
+	.uuid = UUID_NON_TRUSTED_FW_KEY_CERT,
+};
+
+static const io_uuid_spec_t scp_fw_cert_uuid_spec = {
+	.uuid = UUID_SCP_FW_CONTENT_CERT,
+};
+
+static const io_uuid_spec_t soc_fw_cert_uuid_spec = {
+	.uuid = UUID_SOC_FW_CONTENT_CERT,
+};
+
+static const io_uuid_spec_t tos_fw_cert_uuid_spec = {
+	.uuid = UUID_TRUSTED_OS_FW_CONTENT_CERT,
+};
+
+static const io_uuid_spec_t nt_fw_cert_uuid_spec = {
+	.uuid = UUID_NON_TRUSTED_FW_CONTENT_CERT,
+};
+#endif /* TRUSTED_BOARD_BOOT */
+
+/* Images loaded by BL2 and the certificates they are authenticated with */
+static const uintptr_t image_specs[] = {
+	[FIP_IMAGE_ID] = (uintptr_t)&fip_block_spec,
+	[SCP_BL2_IMAGE_ID] = (uintptr_t)&scp_bl2_uuid_spec,
+	[BL31_IMAGE_ID] = (uintptr_t)&bl31_uuid_spec,
+	[BL32_IMAGE_ID] = (uintptr_t)&bl32_uuid_spec,
+	[BL33_IMAGE_ID] = (uintptr_t)&bl33_uuid_spec,
+#if TRUSTED_BOARD_BOOT
+	[TRUSTED_KEY_CERT_ID] = (uintptr_t)&trusted_key_cert_uuid_spec,
+	[SCP_FW_KEY_CERT_ID] = (uintptr_t)&scp_fw_key_cert_uuid_spec,
+	[SOC_FW_KEY_CERT_ID] = (uintptr_t)&soc_fw_key_cert_uuid_spec,
+	[TRUSTED_OS_FW_KEY_CERT_ID] = (uintptr_t)&tos_fw_key_cert_uuid_spec,
+	[NON_TRUSTED_FW_KEY_CERT_ID] = (uintptr_t)&nt_fw_key_cert_uuid_spec,
+	[SCP_FW_CONTENT_CERT_ID] = (uintptr_t)&scp_fw_cert_uuid_spec,
+	[SOC_FW_CONTENT_CERT_ID] = (uintptr_t)&soc_fw_cert_uuid_spec,
+	[TRUSTED_OS_FW_CONTENT_CERT_ID] = (uintptr_t)&tos_fw_cert_uuid_spec,
+	[NON_TRUSTED_FW_CONTENT_CERT_ID] = (uintptr_t)&nt_fw_cert_uuid_spec,
+#endif /* TRUSTED_BOARD_BOOT */
+};
+
+void sim_io_setup(uintptr_t fip_base, size_t fip_size)
+{
+	int io_result;
+
+	fip_block_spec.offset = fip_base;
+	fip_block_spec.length = fip_size;
+
+	io_result = register_io_dev_fip(&fip_dev_con);
+	assert(io_result == 0);
+
+	io_result = register_io_dev_memmap(&memmap_dev_con);
+	assert(io_result == 0);
+
+	/* Open connections to devices and cache the handles */
+	io_result = io_dev_open(fip_dev_con, (uintptr_t)NULL,
+				&fip_dev_handle);
+	assert(io_result == 0);
+
+	io_result = io_dev_open(memmap_dev_con, (uintptr_t)NULL,
+				&memmap_dev_handle);
+	assert(io_result == 0);
+
+	/* Ignore improbable errors in release builds */
+	(void)io_result;
+}
+
+/* Return an IO device handle and specification which can be used to access
+ * an image. All the images come from the FIP, the FIP from the memmap device */
+int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+			  uintptr_t *image_spec)
+{
+	uintptr_t local_image_handle;
+	int result;
+
+	if ((image_id >= ARRAY_SIZE(image_specs)) ||
+	    (image_specs[image_id] == (uintptr_t)NULL))
+		return -ENOENT;
+
+	if (image_id == FIP_IMAGE_ID) {
+		*dev_handle = memmap_dev_handle;
+		result = io_dev_init(memmap_dev_handle, (uintptr_t)NULL);
+	} else {
+		*dev_handle = fip_dev_handle;
+		result = io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID);
+	}
+
+	/* Check that the image can be opened, like the ARM platforms do */
+	if (result == 0) {
+		result = io_open(*dev_handle, image_specs[image_id],
+				 &local_image_handle);
+		if (result == 0)
+			io_close(local_image_handle);
+	}
+
+	*image_spec = image_specs[image_id];
+	return result;
+}
+
+/* The system counter is modelled by the monotonic clock, in nanoseconds */
+uint64_t plat_get_syscnt_freq(void)
+{
+	return 1000000000;
+}
+
+/* The images are written by the host, they have nothing to clean */
+void bl2_plat_image_chunk_loaded(unsigned int image_id, uintptr_t buffer,
+				 size_t length)
+{
+}
+
+/*
+ * The FIP is mapped like a NOR flash the CPUs can execute from, so with
+ * LOAD_IMAGE_IN_PLACE the images are all used in place.
+ */
+int bl2_plat_image_in_place(unsigned int image_id, uintptr_t address,
+			    size_t size)
+{
+	return 1;
+}
+
+#if TRUSTED_BOARD_BOOT
+static const unsigned char rotpk_hash_hdr[] =		\
+		"\x30\x31\x30\x0D\x06\x09\x60\x86\x48"	\
+		"\x01\x65\x03\x04\x02\x01\x05\x00\x04\x20";
+static const unsigned int rotpk_hash_hdr_len = sizeof(rotpk_hash_hdr) - 1;
+static unsigned char rotpk_hash_der[sizeof(rotpk_hash_hdr) - 1 +
+				    SIM_ROTPK_HASH_LEN];
+
+/* Return the ROTPK hash as a DER encoded DigestInfo */
+int plat_get_rotpk_info(void *cookie, void **key_ptr, unsigned int *key_len,
+			unsigned int *flags)
+{
+	memcpy(rotpk_hash_der, rotpk_hash_hdr, rotpk_hash_hdr_len);
+	memcpy(&rotpk_hash_der[rotpk_hash_hdr_len], sim_rotpk_hash,
+	       SIM_ROTPK_HASH_LEN);
+
+	*key_ptr = (void *)rotpk_hash_der;
+	*key_len = (unsigned int)sizeof(rotpk_hash_der);
+	*flags = ROTPK_IS_HASH;
+
+	return 0;
+}
+#endif /* TRUSTED_BOARD_BOOT */
+
+void tf_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+void do_panic(void)
+{
+	fflush(stdout);
+	fprintf(stderr, "PANIC\n");
+	abort();
+}
@@ -66,6 +66,7 @@ struct cert_s {
 	int num_ext;		/* Number of extensions in the certificate */
 
 	X509 *x;		/* X509 certificate container */
+	int reused;		/* The existing certificate file is kept */
 };
 
 /* Exported API */
@@ -73,6 +74,7 @@ int cert_init(void);
 cert_t *cert_get_by_opt(const char *opt);
 int cert_add_ext(X509 *issuer, X509 *subject, int nid, char *value);
 int cert_new(cert_t *cert, int days, int ca, STACK_OF(X509_EXTENSION) * sk);
+int cert_reuse(cert_t *cert, int ca, STACK_OF(X509_EXTENSION) * sk);
 
 /* Macro to register the certificates used in the CoT */
 #define REGISTER_COT(_certs) \
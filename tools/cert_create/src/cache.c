@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200809L	/* st_mtim */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <openssl/sha.h>
+
+#include "cache.h"
+#include "debug.h"
+
+/*
+ * Cache of the hashes of the images, kept in a file between runs. An image is
+ * identified by its path, and its hash is reused as long as the size and the
+ * modification time of the file have not changed. Each line of the file holds
+ * the hash in hexadecimal, the size, the modification time (seconds and
+ * nanoseconds) and the path of an image, which may contain spaces.
+ */
+#define CACHE_MAX_LINE		4096
+
+typedef struct cache_entry_s cache_entry_t;
+struct cache_entry_s {
+	char *path;
+	long long size;
+	long long mtime_sec;
+	long mtime_nsec;
+	unsigned char md[SHA256_DIGEST_LENGTH];
+	cache_entry_t *next;
+};
+
+static cache_entry_t *cache_entries;
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static cache_entry_t *cache_find(const char *path)
+{
+	cache_entry_t *entry;
+
+	for (entry = cache_entries; entry != NULL; entry = entry->next) {
+		if (strcmp(entry->path, path) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static cache_entry_t *cache_add(const char *path)
+{
+	cache_entry_t *entry;
+
+	entry = calloc(1, sizeof(*entry));
+	if (entry == NULL) {
+		return NULL;
+	}
+	entry->path = malloc(strlen(path) + 1);
+	if (entry->path == NULL) {
+		free(entry);
+		return NULL;
+	}
+	strcpy(entry->path, path);
+	entry->next = cache_entries;
+	cache_entries = entry;
+
+	return entry;
+}
+
+/* Load the cache file. A missing file or an invalid line is not an error. */
+int cache_load(const char *fn)
+{
+	FILE *file;
+	char line[CACHE_MAX_LINE];
+	char hex[2 * SHA256_DIGEST_LENGTH + 1];
+	cache_entry_t entry, *new;
+	unsigned int byte;
+	int path_pos, i, len;
+
+	file = fopen(fn, "r");
+	if (file == NULL) {
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		len = strlen(line);
+		if ((len == 0) || (line[len - 1] != '\n')) {
+			continue;
+		}
+		line[len - 1] = '\0';
+
+		if (sscanf(line, "%64s %lld %lld %ld %n", hex, &entry.size,
+			   &entry.mtime_sec, &entry.mtime_nsec,
+			   &path_pos) != 4) {
+			continue;
+		}
+		if (strlen(hex) != 2 * SHA256_DIGEST_LENGTH) {
+			continue;
+		}
+		for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+			if (sscanf(&hex[2 * i], "%2x", &byte) != 1) {
+				break;
+			}
+			entry.md[i] = byte;
+		}
+		if ((i != SHA256_DIGEST_LENGTH) || (line[path_pos] == '\0')) {
+			continue;
+		}
+
+		new = cache_find(&line[path_pos]);
+		if (new == NULL) {
+			new = cache_add(&line[path_pos]);
+		}
+		if (new == NULL) {
+			fclose(file);
+			return 0;
+		}
+		new->size = entry.size;
+		new->mtime_sec = entry.mtime_sec;
+		new->mtime_nsec = entry.mtime_nsec;
+		memcpy(new->md, entry.md, SHA256_DIGEST_LENGTH);
+	}
+
+	fclose(file);
+	return 1;
+}
+
+/* Write the cache back to its file */
+int cache_save(const char *fn)
+{
+	FILE *file;
+	cache_entry_t *entry;
+	int i;
+
+	file = fopen(fn, "w");
+	if (file == NULL) {
+		return 0;
+	}
+
+	for (entry = cache_entries; entry != NULL; entry = entry->next) {
+		for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+			fprintf(file, "%02x", entry->md[i]);
+		}
+		fprintf(file, " %lld %lld %ld %s\n", entry->size,
+			entry->mtime_sec, entry->mtime_nsec, entry->path);
+	}
+
+	return fclose(file) == 0;
+}
+
+/*
+ * Return 1 and copy the cached hash of 'path' to 'md' if the file described by
+ * 'st' has not changed since it was hashed, 0 otherwise.
+ */
+int cache_lookup(const char *path, const struct stat *st, unsigned char *md)
+{
+	cache_entry_t *entry;
+	int found = 0;
+
+	pthread_mutex_lock(&cache_lock);
+	entry = cache_find(path);
+	if ((entry != NULL) && (entry->size == st->st_size) &&
+	    (entry->mtime_sec == st->st_mtim.tv_sec) &&
+	    (entry->mtime_nsec == st->st_mtim.tv_nsec)) {
+		memcpy(md, entry->md, SHA256_DIGEST_LENGTH);
+		found = 1;
+	}
+	pthread_mutex_unlock(&cache_lock);
+
+	return found;
+}
+
+/* Record the hash of the file 'path' described by 'st' */
+void cache_update(const char *path, const struct stat *st,
+		  const unsigned char *md)
+{
+	cache_entry_t *entry;
+
+	pthread_mutex_lock(&cache_lock);
+	entry = cache_find(path);
+	if (entry == NULL) {
+		entry = cache_add(path);
+	}
+	if (entry != NULL) {
+		entry->size = st->st_size;
+		entry->mtime_sec = st->st_mtim.tv_sec;
+		entry->mtime_nsec = st->st_mtim.tv_nsec;
+		memcpy(entry->md, md, SHA256_DIGEST_LENGTH);
+	} else {
+		WARN("Cannot cache the hash of %s\n", path);
+	}
+	pthread_mutex_unlock(&cache_lock);
+}
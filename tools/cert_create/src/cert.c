@@ -47,6 +47,10 @@
 
 #define SERIAL_RAND_BITS	64
 
+/* Extensions added by cert_new() to every certificate, besides 'sk' */
+#define CERT_NUM_STD_EXT	3
+#define CERT_NUM_CA_EXT		1
+
 int rand_serial(BIGNUM *b, ASN1_INTEGER *ai)
 {
 	BIGNUM *btmp;
@@ -181,6 +185,75 @@ int cert_new(cert_t *cert, int days, int ca, STACK_OF(X509_EXTENSION) * sk)
 	return 1;
 }
 
+/*
+ * Check whether the certificate file of 'cert' left by a previous run can be
+ * kept: it must have been signed by the current issuer key for the current
+ * subject key, and hold the same extensions as the ones in 'sk'. If so, the
+ * existing certificate is loaded in 'cert' instead of creating a new one.
+ */
+int cert_reuse(cert_t *cert, int ca, STACK_OF(X509_EXTENSION) * sk)
+{
+	EVP_PKEY *pkey = keys[cert->key].key;
+	EVP_PKEY *ikey = keys[certs[cert->issuer].key].key;
+	EVP_PKEY *old_pkey;
+	X509 *x;
+	X509_EXTENSION *ex, *old_ex;
+	FILE *file;
+	int i, num, loc, same;
+
+	if (cert->fn == NULL) {
+		return 0;
+	}
+
+	file = fopen(cert->fn, "rb");
+	if (file == NULL) {
+		return 0;
+	}
+	x = d2i_X509_fp(file, NULL);
+	fclose(file);
+	if (x == NULL) {
+		return 0;
+	}
+
+	if (!pkey) {
+		pkey = ikey;
+	}
+
+	/* The keys must not have changed */
+	same = (X509_verify(x, ikey) == 1);
+	if (same) {
+		old_pkey = X509_get_pubkey(x);
+		same = (old_pkey != NULL) && (EVP_PKEY_cmp(old_pkey, pkey) == 1);
+		EVP_PKEY_free(old_pkey);
+	}
+
+	/* Neither must the extensions */
+	num = (sk != NULL) ? sk_X509_EXTENSION_num(sk) : 0;
+	if (same && (X509_get_ext_count(x) != CERT_NUM_STD_EXT +
+		     (ca ? CERT_NUM_CA_EXT : 0) + num)) {
+		same = 0;
+	}
+	for (i = 0; same && (i < num); i++) {
+		ex = sk_X509_EXTENSION_value(sk, i);
+		loc = X509_get_ext_by_OBJ(x, X509_EXTENSION_get_object(ex), -1);
+		old_ex = (loc >= 0) ? X509_get_ext(x, loc) : NULL;
+		same = (old_ex != NULL) &&
+		       (X509_EXTENSION_get_critical(old_ex) ==
+			X509_EXTENSION_get_critical(ex)) &&
+		       (ASN1_OCTET_STRING_cmp(X509_EXTENSION_get_data(old_ex),
+					      X509_EXTENSION_get_data(ex)) == 0);
+	}
+
+	if (!same) {
+		X509_free(x);
+		return 0;
+	}
+
+	cert->x = x;
+	cert->reused = 1;
+	return 1;
+}
+
 int cert_init(void)
 {
 	cmd_opt_t cmd_opt;
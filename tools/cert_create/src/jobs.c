@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200112L	/* sysconf() */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <openssl/crypto.h>
+
+#include "debug.h"
+#include "jobs.h"
+
+/*
+ * Minimal thread pool: jobs_run() starts up to 'jobs_num_threads' threads
+ * which pick the jobs by index until all of them have been run, and returns
+ * once they are all complete. The jobs must not depend on each other.
+ */
+static unsigned int jobs_num_threads = 1;
+
+typedef struct job_queue_s {
+	pthread_mutex_t lock;
+	unsigned int next;	/* Index of the next job to run */
+	unsigned int num_jobs;
+	job_fn_t fn;
+	void *arg;
+} job_queue_t;
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+/*
+ * OpenSSL versions before 1.1.0 are only thread safe once the application has
+ * provided the locks protecting their shared data.
+ */
+static pthread_mutex_t *crypto_locks;
+
+static void crypto_lock_cb(int mode, int n, const char *file, int line)
+{
+	if (mode & CRYPTO_LOCK) {
+		pthread_mutex_lock(&crypto_locks[n]);
+	} else {
+		pthread_mutex_unlock(&crypto_locks[n]);
+	}
+}
+
+static unsigned long crypto_thread_id_cb(void)
+{
+	return (unsigned long)pthread_self();
+}
+
+static void crypto_locks_init(void)
+{
+	int i;
+
+	crypto_locks = malloc(CRYPTO_num_locks() * sizeof(pthread_mutex_t));
+	if (crypto_locks == NULL) {
+		ERROR("Cannot allocate the OpenSSL locks\n");
+		exit(1);
+	}
+	for (i = 0; i < CRYPTO_num_locks(); i++) {
+		pthread_mutex_init(&crypto_locks[i], NULL);
+	}
+	CRYPTO_set_id_callback(crypto_thread_id_cb);
+	CRYPTO_set_locking_callback(crypto_lock_cb);
+}
+#endif /* OPENSSL_VERSION_NUMBER < 0x10100000L */
+
+/* Number of online CPUs, used when the number of threads is not specified */
+unsigned int jobs_default_threads(void)
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (n > 0) ? (unsigned int)n : 1;
+}
+
+/* Set the number of threads used to run the jobs */
+void jobs_init(unsigned int num_threads)
+{
+	jobs_num_threads = (num_threads != 0) ? num_threads : 1;
+
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+	if (jobs_num_threads > 1) {
+		crypto_locks_init();
+	}
+#endif
+}
+
+static void *jobs_worker(void *data)
+{
+	job_queue_t *queue = data;
+	unsigned int idx;
+
+	for (;;) {
+		pthread_mutex_lock(&queue->lock);
+		idx = queue->next;
+		if (idx < queue->num_jobs) {
+			queue->next++;
+		}
+		pthread_mutex_unlock(&queue->lock);
+
+		if (idx >= queue->num_jobs) {
+			break;
+		}
+		queue->fn(idx, queue->arg);
+	}
+
+	return NULL;
+}
+
+/* Run 'fn' for each index in [0, num_jobs) and wait for all of them */
+void jobs_run(unsigned int num_jobs, job_fn_t fn, void *arg)
+{
+	job_queue_t queue;
+	pthread_t *threads;
+	unsigned int num_threads, i;
+
+	queue.next = 0;
+	queue.num_jobs = num_jobs;
+	queue.fn = fn;
+	queue.arg = arg;
+	pthread_mutex_init(&queue.lock, NULL);
+
+	num_threads = (num_jobs < jobs_num_threads) ? num_jobs :
+		      jobs_num_threads;
+
+	/* No need for extra threads: run the jobs in the calling thread */
+	if (num_threads <= 1) {
+		jobs_worker(&queue);
+		pthread_mutex_destroy(&queue.lock);
+		return;
+	}
+
+	threads = malloc(num_threads * sizeof(pthread_t));
+	if (threads == NULL) {
+		ERROR("Cannot allocate the job threads\n");
+		exit(1);
+	}
+
+	for (i = 0; i < num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, jobs_worker, &queue)) {
+			ERROR("Cannot create job thread\n");
+			exit(1);
+		}
+	}
+	for (i = 0; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+	pthread_mutex_destroy(&queue.lock);
+}
@@ -34,6 +34,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include <openssl/conf.h>
 #include <openssl/engine.h>
@@ -42,10 +43,12 @@
 #include <openssl/sha.h>
 #include <openssl/x509v3.h>
 
+#include "cache.h"
 #include "cert.h"
 #include "cmd_opt.h"
 #include "debug.h"
 #include "ext.h"
+#include "jobs.h"
 #include "key.h"
 #include "platform_oid.h"
 #include "sha.h"
@@ -90,6 +93,11 @@ static int key_alg;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int num_threads;
+static const char *cache_fn;
+
+/* Hash of the image of each extension of type EXT_TYPE_HASH */
+static unsigned char (*ext_md)[SHA256_DIGEST_LENGTH];
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -248,30 +256,234 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "cache", required_argument, NULL, 'c' },
+		"Cache the image hashes in the given file and keep the existing "
+		"certificates whose contents have not changed"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads used to create the keys, hash the images and "
+		"create the certificates (default: number of online CPUs)"
 	}
 };
 
-int main(int argc, char *argv[])
+/* Create the key 'idx' if it has been marked for creation in 'arg' */
+static void create_key_job(unsigned int idx, void *arg)
+{
+	const char *create = arg;
+
+	if (!create[idx]) {
+		return;
+	}
+
+	NOTICE("Creating new key for '%s'\n", keys[idx].desc);
+	if (!key_create(&keys[idx], key_alg)) {
+		ERROR("Error creating key '%s'\n", keys[idx].desc);
+		exit(1);
+	}
+}
+
+/*
+ * Calculate the hash of the image of extension 'idx', if any. With a cache,
+ * the hash is only calculated if the image has changed since the last run.
+ */
+static void hash_image_job(unsigned int idx, void *arg)
+{
+	ext_t *ext = &extensions[idx];
+	struct stat st;
+	int cached;
+
+	if ((ext->type != EXT_TYPE_HASH) || (ext->data.fn == NULL)) {
+		return;
+	}
+
+	cached = (cache_fn != NULL) && (stat(ext->data.fn, &st) == 0);
+	if (cached && cache_lookup(ext->data.fn, &st, ext_md[idx])) {
+		return;
+	}
+
+	if (!sha_file(ext->data.fn, ext_md[idx])) {
+		ERROR("Cannot calculate hash of %s\n", ext->data.fn);
+		exit(1);
+	}
+
+	if (cached) {
+		cache_update(ext->data.fn, &st, ext_md[idx]);
+	}
+}
+
+/* Create the certificate whose index in certs[] is held in 'arg'[idx] */
+static void create_cert_job(unsigned int idx, void *arg)
 {
 	STACK_OF(X509_EXTENSION) * sk = NULL;
 	X509_EXTENSION *cert_ext = NULL;
+	unsigned char zero_md[SHA256_DIGEST_LENGTH];
+	const EVP_MD *md_info;
+	cert_t *cert;
+	ext_t *ext;
+	int j, ext_nid, ext_idx;
+
+	cert = &certs[((const unsigned int *)arg)[idx]];
+
+	/* Indicate SHA256 as image hash algorithm in the certificate
+	 * extension */
+	md_info = EVP_sha256();
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext_idx = cert->ext[j];
+		ext = &extensions[ext_idx];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, ext->data.nvcounter));
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->data.fn == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(zero_md, 0x0, SHA256_DIGEST_LENGTH);
+					CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+							EXT_CRIT, md_info, zero_md,
+							SHA256_DIGEST_LENGTH));
+				} else {
+					/* Do not include this hash in the certificate */
+					continue;
+				}
+			} else {
+				/* The hash has been calculated by hash_image_job() */
+				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+						EXT_CRIT, md_info, ext_md[ext_idx],
+						SHA256_DIGEST_LENGTH));
+			}
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->data.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type in %s\n",
+					cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/*
+	 * Keep the existing certificate if its contents have not changed. A
+	 * certificate is always created again if its issuer has been.
+	 */
+	if ((cache_fn != NULL) &&
+	    ((cert->issuer == cert->id) || (certs[cert->issuer].fn == NULL) ||
+	     certs[cert->issuer].reused) &&
+	    cert_reuse(cert, 0, sk)) {
+		NOTICE("Keeping '%s'\n", cert->fn);
+		sk_X509_EXTENSION_free(sk);
+		return;
+	}
+
+	/* Create certificate. Signed with ROT key */
+	if (!cert_new(cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		exit(1);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+}
+
+/*
+ * Create the requested certificates. A certificate is signed once the
+ * certificate of its issuer (if requested) has been created, so they are
+ * created in waves of certificates whose issuers are ready, in parallel.
+ */
+static void create_certs(void)
+{
+	unsigned int *ready;
+	char *done;
+	unsigned int num_ready, num_left, i;
+	cert_t *cert;
+
+	ready = malloc(num_certs * sizeof(*ready));
+	done = calloc(num_certs, sizeof(*done));
+	if ((ready == NULL) || (done == NULL)) {
+		ERROR("Malloc error while creating the certificates\n");
+		exit(1);
+	}
+
+	/* Certificates which are not requested are not created */
+	num_left = 0;
+	for (i = 0; i < num_certs; i++) {
+		if (certs[i].fn == NULL) {
+			done[i] = 1;
+		} else {
+			num_left++;
+		}
+	}
+
+	while (num_left != 0) {
+		num_ready = 0;
+		for (i = 0; i < num_certs; i++) {
+			cert = &certs[i];
+			if (!done[i] && ((cert->issuer == i) ||
+					 done[cert->issuer])) {
+				ready[num_ready++] = i;
+			}
+		}
+
+		if (num_ready == 0) {
+			ERROR("Circular dependency between certificates\n");
+			exit(1);
+		}
+
+		jobs_run(num_ready, create_cert_job, ready);
+
+		for (i = 0; i < num_ready; i++) {
+			done[ready[i]] = 1;
+		}
+		num_left -= num_ready;
+	}
+
+	free(done);
+	free(ready);
+}
+
+int main(int argc, char *argv[])
+{
 	ext_t *ext = NULL;
 	key_t *key = NULL;
 	cert_t *cert = NULL;
 	FILE *file = NULL;
-	int i, j, ext_nid;
+	int i;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
 	unsigned int err_code;
-	unsigned char md[SHA256_DIGEST_LENGTH];
-	const EVP_MD *md_info;
+	char *key_to_create;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
 
 	/* Set default options */
 	key_alg = KEY_ALG_RSA;
+	num_threads = jobs_default_threads();
 
 	/* Add common command line options */
 	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
@@ -301,7 +513,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:hknp", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:c:hj:knp", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -316,9 +528,19 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'c':
+			cache_fn = strdup(optarg);
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			break;
+		case 'j':
+			num_threads = atoi(optarg);
+			if (num_threads <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -353,11 +575,16 @@ int main(int argc, char *argv[])
 	/* Check command line arguments */
 	check_cmd_params();
 
-	/* Indicate SHA256 as image hash algorithm in the certificate
-	 * extension */
-	md_info = EVP_sha256();
+	jobs_init(num_threads);
+
+	key_to_create = calloc(num_keys, sizeof(*key_to_create));
+	ext_md = calloc(num_extensions, sizeof(*ext_md));
+	if ((key_to_create == NULL) || (ext_md == NULL)) {
+		ERROR("Malloc error\n");
+		exit(1);
+	}
 
-	/* Load private keys from files (or generate new ones) */
+	/* Load private keys from files (or mark them to be generated) */
 	for (i = 0 ; i < num_keys ; i++) {
 		/* First try to load the key from disk */
 		if (key_load(&keys[i], &err_code)) {
@@ -380,12 +607,8 @@ int main(int argc, char *argv[])
 		/* File does not exist, could not be opened or no filename was
 		 * given */
 		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
+			/* Create a new key below */
+			key_to_create[i] = 1;
 		} else {
 			if (err_code == KEY_ERR_OPEN) {
 				ERROR("Error opening '%s'\n", keys[i].fn);
@@ -396,77 +619,21 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
-
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, ext->data.nvcounter));
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->data.fn == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA256_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						break;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(ext->data.fn, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->data.fn);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						SHA256_DIGEST_LENGTH));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->data.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type in %s\n",
-						cert->cn);
-				exit(1);
-			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
-		}
-
-		/* Create certificate. Signed with ROT key */
-		if (cert->fn && !cert_new(cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
-		}
-
-		sk_X509_EXTENSION_free(sk);
+	/* Generate the new keys and hash the images in parallel */
+	if ((cache_fn != NULL) && !cache_load(cache_fn)) {
+		ERROR("Cannot load cache %s\n", cache_fn);
+		exit(1);
+	}
+	jobs_run(num_keys, create_key_job, key_to_create);
+	jobs_run(num_extensions, hash_image_job, NULL);
+	free(key_to_create);
+	if ((cache_fn != NULL) && !cache_save(cache_fn)) {
+		ERROR("Cannot save cache %s\n", cache_fn);
 	}
 
+	/* Create the certificates */
+	create_certs();
+
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -481,7 +648,7 @@ int main(int argc, char *argv[])
 
 	/* Save created certificates to files */
 	for (i = 0 ; i < num_certs ; i++) {
-		if (certs[i].x && certs[i].fn) {
+		if (certs[i].x && certs[i].fn && !certs[i].reused) {
 			file = fopen(certs[i].fn, "w");
 			if (file != NULL) {
 				i2d_X509_fp(file, certs[i].x);
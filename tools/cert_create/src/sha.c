@@ -28,37 +28,67 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#define _POSIX_C_SOURCE 200112L	/* open(), mmap() */
+
+#include <fcntl.h>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <openssl/sha.h>
 
 #include "debug.h"
 
-#define BUFFER_SIZE	256
+#define BUFFER_SIZE	(64 * 1024)
 
+/*
+ * Calculate the SHA-256 hash of a file. Regular files are mapped into memory
+ * and hashed in one go; anything else (e.g. an empty file or a pipe) is read
+ * through a buffer.
+ */
 int sha_file(const char *filename, unsigned char *md)
 {
-	FILE *inFile;
+	int fd;
+	struct stat st;
 	SHA256_CTX shaContext;
-	int bytes;
-	unsigned char data[BUFFER_SIZE];
+	ssize_t bytes;
+	void *data;
+	unsigned char buffer[BUFFER_SIZE];
 
 	if ((filename == NULL) || (md == NULL)) {
 		ERROR("%s(): NULL argument\n", __FUNCTION__);
 		return 0;
 	}
 
-	inFile = fopen(filename, "rb");
-	if (inFile == NULL) {
+	fd = open(filename, O_RDONLY);
+	if (fd < 0) {
 		ERROR("Cannot read %s\n", filename);
 		return 0;
 	}
 
 	SHA256_Init(&shaContext);
-	while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
-		SHA256_Update(&shaContext, data, bytes);
+
+	if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+		data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			SHA256_Update(&shaContext, data, st.st_size);
+			munmap(data, st.st_size);
+			goto done;
+		}
+	}
+
+	while ((bytes = read(fd, buffer, BUFFER_SIZE)) > 0) {
+		SHA256_Update(&shaContext, buffer, bytes);
 	}
+	if (bytes < 0) {
+		ERROR("Cannot read %s\n", filename);
+		close(fd);
+		return 0;
+	}
+
+done:
 	SHA256_Final(md, &shaContext);
 
-	fclose(inFile);
+	close(fd);
 	return 1;
 }
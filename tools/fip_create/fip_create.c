@@ -28,25 +28,79 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#define _POSIX_C_SOURCE 200112L	/* open(), mmap() */
+
 #include <errno.h>
+#include <fcntl.h>
 #include <getopt.h> /* getopt_long() is a GNU extention */
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 #include "fip_create.h"
 #include "firmware_image_package.h"
+#include "lz4_stream.h"
+#include "sha256.h"
 
 /* Values returned by getopt() as part of the command line parsing */
 #define OPT_TOC_ENTRY 0
 #define OPT_DUMP 1
 #define OPT_HELP 2
+#define OPT_ALIGN 3
+#define OPT_COMPRESS 4
+#define OPT_VERIFY 5
+#define OPT_HASH 6
+#define OPT_STATS 7
+
+/* Largest alignment accepted by --align */
+#define MAX_ALIGN	(1 << 24)
 
 file_info_t files[MAX_FILES];
 unsigned file_info_count = 0;
 uuid_t uuid_null = {0};
 
+/*
+ * Alignment of the images in the package being written, and in the existing
+ * package. Both are 1 when the images are not aligned.
+ */
+static unsigned int fip_align = 1;
+static unsigned int fip_align_in_package = 1;
+
+/* Actions requested in addition to the update of the package */
+static int do_verify;
+static int do_hash;
+static int do_stats;
+
+/* Phases of the tool timed by --stats */
+enum {
+	PHASE_PARSE,
+	PHASE_COMPRESS,
+	PHASE_PACK,
+	PHASE_VERIFY,
+	PHASE_NUM
+};
+
+static const char *const phase_names[PHASE_NUM] = {
+	[PHASE_PARSE] = "parse",
+	[PHASE_COMPRESS] = "compress",
+	[PHASE_PACK] = "pack",
+	[PHASE_VERIFY] = "verify",
+};
+
+/* Measurements reported by --stats */
+static struct {
+	double phase_time[PHASE_NUM];
+	unsigned long long bytes_read;		/* From the image files */
+	unsigned long long bytes_written;	/* To the package */
+	unsigned long long padding_written;	/* Alignment padding */
+	unsigned long long bytes_verified;
+	unsigned long long padding_verified;
+} stats;
+
 /*
  * TODO: Add ability to specify and flag different file types.
  * Add flags to the toc_entry?
@@ -114,6 +168,35 @@ static inline void copy_uuid(uuid_t *to_uuid, const uuid_t *from_uuid)
 }
 
 
+/* Round up the offset of an image to the alignment of the package */
+static inline unsigned int align_offset(unsigned int offset)
+{
+	return (offset + fip_align - 1) & ~(fip_align - 1);
+}
+
+
+/* Return the log2 of a power of 2 */
+static unsigned int log2_align(unsigned int align)
+{
+	unsigned int shift = 0;
+
+	while ((1U << shift) < align)
+		shift++;
+
+	return shift;
+}
+
+
+/* Monotonic time in seconds, used to time the phases */
+static double get_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
 static void print_usage(void)
 {
 	entry_lookup_list_t *entry = toc_entry_lookup_list;
@@ -122,7 +205,15 @@ static void print_usage(void)
 	printf("\tThis tool is used to create a Firmware Image Package.\n\n");
 	printf("Options:\n");
 	printf("\t--help: Print this help message and exit\n");
-	printf("\t--dump: Print contents of FIP\n\n");
+	printf("\t--dump: Print contents of FIP\n");
+	printf("\t--align BYTES: Align the images in the FIP to a power of 2"
+	       " (default: kept from the existing FIP, else 1)\n");
+	printf("\t--compress COMPONENT: Store the given component compressed"
+	       " with LZ4, e.g. --compress nt-fw\n");
+	printf("\t--verify: Check the ToC and the images of the FIP\n");
+	printf("\t--hash: Verify the FIP and print the SHA-256 of each image\n");
+	printf("\t--stats: Print the time spent in each phase and the"
+	       " number of bytes processed\n\n");
 	printf("\tComponents that can be added/updated:\n");
 	for (; entry->command_line_name != NULL; entry++) {
 		printf("\t--%s%s\t\t%s",
@@ -195,6 +286,8 @@ static int add_file_info_entry(entry_lookup_list_t *lookup_entry, char *filename
 	file_info_entry->filename = filename;
 	file_info_entry->size = (unsigned int)file_status.st_size;
 	file_info_entry->entry = lookup_entry;
+	/* The new image is not compressed until pack_images() */
+	file_info_entry->flags = 0;
 
 	/* Increment the file_info counter on success if it is new file entry */
 	if (is_new_entry) {
@@ -211,30 +304,18 @@ static int add_file_info_entry(entry_lookup_list_t *lookup_entry, char *filename
 }
 
 
-static int write_memory_to_file(const uint8_t *start, const char *filename,
-		unsigned int size)
+/* Size of the buffer used to copy the images into the package */
+#define COPY_BUFFER_SIZE	(64 * 1024)
+
+
+/* Write 'size' bytes from memory to the stream */
+static int write_memory_to_stream(const void *start, unsigned int size,
+				  FILE *stream, const char *filename)
 {
-	FILE *stream;
 	unsigned int bytes_written;
 
-	/* Write the packed file out to the filesystem */
-	stream = fopen(filename, "r+");
-	if (stream == NULL) {
-		stream = fopen(filename, "w");
-		if (stream == NULL) {
-			printf("Error: Cannot create output file \"%s\": %s\n",
-			       filename, strerror(errno));
-			return errno;
-		} else {
-			printf("Creating \"%s\"\n", filename);
-		}
-	} else {
-		printf("Updating \"%s\"\n", filename);
-	}
-
 	bytes_written = fwrite(start, sizeof(uint8_t), size, stream);
-	fclose(stream);
-
+	stats.bytes_written += bytes_written;
 	if (bytes_written != size) {
 		printf("Error: Incorrect write for file \"%s\": Size=%u,"
 			"Written=%u bytes.\n", filename, size, bytes_written);
@@ -245,111 +326,418 @@ static int write_memory_to_file(const uint8_t *start, const char *filename,
 }
 
 
-static int read_file_to_memory(void *memory, const file_info_t *info)
+/* Write 'size' zero bytes to the stream */
+static int write_padding_to_stream(unsigned int size, FILE *stream,
+				   const char *filename)
+{
+	static const uint8_t zeros[256];
+	unsigned int chunk;
+	int status;
+
+	stats.padding_written += size;
+	for (; size != 0; size -= chunk) {
+		chunk = (size < sizeof(zeros)) ? size : sizeof(zeros);
+		status = write_memory_to_stream(zeros, chunk, stream, filename);
+		if (status != 0)
+			return status;
+	}
+
+	return 0;
+}
+
+
+/*
+ * Copy an image into the package stream. Images given on the command line are
+ * streamed from the filesystem through a fixed size buffer, images kept from
+ * the existing package are written straight from its mapping.
+ */
+static int copy_image_to_stream(const file_info_t *info, FILE *out,
+				const char *fip_filename)
 {
+	static uint8_t buffer[COPY_BUFFER_SIZE];
 	FILE *stream;
-	unsigned int bytes_read;
-
-	/* If the file_info is defined by its filename we need to load it */
-	if (info->filename) {
-		/* Read image from filesystem */
-		stream = fopen(info->filename, "r");
-		if (stream == NULL) {
-			printf("Error: Cannot open file \"%s\": %s\n",
-				info->filename, strerror(errno));
-			return errno;
+	unsigned int chunk, left;
+	int status;
+
+	if (info->compressed_buffer != NULL) {
+		return write_memory_to_stream(info->compressed_buffer,
+					      info->size, out, fip_filename);
+	}
+
+	if (info->filename == NULL) {
+		if (info->image_buffer == NULL) {
+			printf("ERROR: info->image_buffer = NULL\n");
+			return EIO;
 		}
+		return write_memory_to_stream(info->image_buffer, info->size,
+					      out, fip_filename);
+	}
+
+	/* Read image from filesystem */
+	stream = fopen(info->filename, "r");
+	if (stream == NULL) {
+		printf("Error: Cannot open file \"%s\": %s\n",
+			info->filename, strerror(errno));
+		return errno;
+	}
 
-		bytes_read = (unsigned int)fread(memory, sizeof(uint8_t),
-						 info->size, stream);
-		fclose(stream);
-		if (bytes_read != info->size) {
+	for (left = info->size; left != 0; left -= chunk) {
+		chunk = (left < COPY_BUFFER_SIZE) ? left : COPY_BUFFER_SIZE;
+		if (fread(buffer, sizeof(uint8_t), chunk, stream) != chunk) {
 			printf("Error: Incomplete read for file \"%s\":"
 				"Size=%u, Read=%u bytes.\n", info->filename,
-				info->size, bytes_read);
+				info->size, info->size - left);
+			fclose(stream);
 			return EIO;
 		}
+		stats.bytes_read += chunk;
+
+		status = write_memory_to_stream(buffer, chunk, out,
+						fip_filename);
+		if (status != 0) {
+			fclose(stream);
+			return status;
+		}
+	}
+
+	fclose(stream);
+	return 0;
+}
+
+
+/*
+ * LZ4 block compressor. Matches of at least LZ4_MIN_MATCH bytes are found
+ * through a hash table of the last position of each 4-byte sequence, and the
+ * first match found is used. As required by the format, the last
+ * LZ4_LAST_LITERALS bytes are always literals and no match starts within the
+ * last LZ4_MATCH_LIMIT bytes.
+ */
+#define LZ4_MIN_MATCH		4
+#define LZ4_LAST_LITERALS	5
+#define LZ4_MATCH_LIMIT		12
+#define LZ4_MAX_OFFSET		0xffff
+#define LZ4_RUN_MASK		0xf
+#define LZ4_HASH_BITS		16
+
+/* Worst case size of the compressed data: incompressible input */
+#define LZ4_COMPRESS_BOUND(size)	((size) + ((size) / 255) + 16)
+
+
+static inline uint32_t lz4_read32(const uint8_t *p)
+{
+	uint32_t value;
+
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+
+static inline unsigned int lz4_hash(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+
+/* Write the extra bytes of a length which does not fit in a token field */
+static uint8_t *lz4_write_length(uint8_t *out, unsigned int length)
+{
+	for (; length >= 255; length -= 255)
+		*out++ = 255;
+	*out++ = length;
+
+	return out;
+}
+
+
+/* Write a sequence made of 'literal_len' literals and an optional match */
+static uint8_t *lz4_write_sequence(uint8_t *out, const uint8_t *literals,
+				   unsigned int literal_len,
+				   unsigned int offset, unsigned int match_len)
+{
+	uint8_t *token = out++;
+
+	*token = ((literal_len < LZ4_RUN_MASK) ? literal_len : LZ4_RUN_MASK)
+		 << 4;
+	if (literal_len >= LZ4_RUN_MASK)
+		out = lz4_write_length(out, literal_len - LZ4_RUN_MASK);
+	memcpy(out, literals, literal_len);
+	out += literal_len;
+
+	if (match_len == 0)
+		return out;
+
+	*out++ = offset & 0xff;
+	*out++ = offset >> 8;
+	match_len -= LZ4_MIN_MATCH;
+	*token |= (match_len < LZ4_RUN_MASK) ? match_len : LZ4_RUN_MASK;
+	if (match_len >= LZ4_RUN_MASK)
+		out = lz4_write_length(out, match_len - LZ4_RUN_MASK);
+
+	return out;
+}
+
+
+/*
+ * Compress 'size' bytes from 'in' into 'out', which must be able to hold
+ * LZ4_COMPRESS_BOUND(size) bytes. Return the size of the compressed data.
+ */
+static unsigned int lz4_compress(const uint8_t *in, unsigned int size,
+				 uint8_t *out)
+{
+	static unsigned int hash_table[1 << LZ4_HASH_BITS];
+	const uint8_t *anchor = in;
+	const uint8_t *ip = in;
+	const uint8_t *match_end = in + size - LZ4_LAST_LITERALS;
+	const uint8_t *match;
+	uint8_t *op = out;
+	unsigned int len;
+	unsigned int h;
+
+	/* Positions are stored plus one, so that 0 means no position */
+	memset(hash_table, 0, sizeof(hash_table));
+
+	while ((size > LZ4_MATCH_LIMIT) &&
+	       (ip < in + size - LZ4_MATCH_LIMIT)) {
+		h = lz4_hash(lz4_read32(ip));
+		match = in + hash_table[h] - 1;
+		hash_table[h] = ip - in + 1;
+
+		if ((match < in) || (ip - match > LZ4_MAX_OFFSET) ||
+		    (lz4_read32(match) != lz4_read32(ip))) {
+			ip++;
+			continue;
+		}
+
+		len = LZ4_MIN_MATCH;
+		while ((ip + len < match_end) && (match[len] == ip[len]))
+			len++;
+
+		op = lz4_write_sequence(op, anchor, ip - anchor, ip - match,
+					len);
+		ip += len;
+		anchor = ip;
+	}
+
+	/* The last sequence only has literals */
+	op = lz4_write_sequence(op, anchor, in + size - anchor, 0, 0);
+
+	return op - out;
+}
+
+
+/* Read a whole image given on the command line into memory */
+static uint8_t *read_image(const file_info_t *info)
+{
+	uint8_t *buffer;
+	FILE *stream;
+
+	buffer = malloc(info->size ? info->size : 1);
+	if (buffer == NULL)
+		return NULL;
+
+	stream = fopen(info->filename, "r");
+	if (stream == NULL) {
+		printf("Error: Cannot open file \"%s\": %s\n",
+			info->filename, strerror(errno));
+		free(buffer);
+		return NULL;
+	}
+
+	if (fread(buffer, sizeof(uint8_t), info->size, stream) != info->size) {
+		printf("Error: Incomplete read for file \"%s\"\n",
+		       info->filename);
+		free(buffer);
+		buffer = NULL;
 	} else {
-		if (info->image_buffer == NULL) {
-			printf("ERROR: info->image_buffer = NULL\n");
+		stats.bytes_read += info->size;
+	}
+
+	fclose(stream);
+	return buffer;
+}
+
+
+/*
+ * Compress an image if --compress asked for it and it is not compressed yet.
+ * The image is kept uncompressed if compression does not make it smaller.
+ */
+static int compress_image(file_info_t *info)
+{
+	const uint8_t *image;
+	uint8_t *file_image = NULL;
+	uint8_t *compressed;
+	unsigned int compressed_size;
+
+	if ((info->entry == NULL) || !(info->entry->flags & FLAG_COMPRESS) ||
+	    (((info->flags >> TOC_ENTRY_FLAGS_COMPRESSION_SHIFT) &
+	      TOC_ENTRY_FLAGS_COMPRESSION_MASK) != TOC_ENTRY_COMPRESSION_NONE))
+		return 0;
+
+	if (info->filename != NULL) {
+		file_image = read_image(info);
+		if (file_image == NULL)
 			return EIO;
-		}
-		/* Copy the file_info buffer (extracted from the existing
-		 * image package) into the new buffer.
-		 */
-		memcpy(memory, info->image_buffer, info->size);
+		image = file_image;
+	} else {
+		image = info->image_buffer;
 	}
 
+	compressed = malloc(LZ4_COMPRESS_BOUND(info->size));
+	if (compressed == NULL) {
+		free(file_image);
+		return ENOMEM;
+	}
+
+	compressed_size = lz4_compress(image, info->size, compressed);
+	free(file_image);
+
+	if (compressed_size >= info->size) {
+		free(compressed);
+		return 0;
+	}
+
+	info->flags = ((uint64_t)TOC_ENTRY_COMPRESSION_LZ4 <<
+		       TOC_ENTRY_FLAGS_COMPRESSION_SHIFT) |
+		      ((uint64_t)info->size << TOC_ENTRY_FLAGS_SIZE_SHIFT);
+	info->compressed_buffer = compressed;
+	info->size = compressed_size;
+
 	return 0;
 }
 
 
-/* Create the image package file */
+/*
+ * Check whether the package can be updated in place: it must already exist
+ * with the same alignment, every entry must still be at the same place in the
+ * ToC and every replaced
+ * image must have the same size as the one it replaces. Only the replaced
+ * images then need to be written.
+ */
+static bool can_update_in_place(unsigned int toc_size)
+{
+	unsigned int entry_index;
+	unsigned int entry_offset_address = toc_size;
+
+	if (fip_align != fip_align_in_package)
+		return false;
+
+	for (entry_index = 0; entry_index < file_info_count; entry_index++) {
+		entry_offset_address = align_offset(entry_offset_address);
+		if ((files[entry_index].fip_offset != entry_offset_address) ||
+		    (files[entry_index].fip_size != files[entry_index].size) ||
+		    (files[entry_index].fip_flags != files[entry_index].flags))
+			return false;
+		entry_offset_address += files[entry_index].size;
+	}
+
+	return true;
+}
+
+
+/* Write the replaced images over the existing ones in the package */
+static int update_images(const char *fip_filename)
+{
+	FILE *fip;
+	unsigned int entry_index;
+	int status = 0;
+
+	fip = fopen(fip_filename, "r+");
+	if (fip == NULL) {
+		printf("Error: Cannot open file \"%s\": %s\n",
+		       fip_filename, strerror(errno));
+		return errno;
+	}
+
+	printf("Updating \"%s\"\n", fip_filename);
+
+	for (entry_index = 0; entry_index < file_info_count; entry_index++) {
+		if (files[entry_index].filename == NULL)
+			continue;
+
+		if (fseek(fip, files[entry_index].fip_offset, SEEK_SET) != 0) {
+			status = errno;
+			break;
+		}
+
+		status = copy_image_to_stream(&files[entry_index], fip,
+					      fip_filename);
+		if (status != 0) {
+			printf("Error: While reading \"%s\" from filesystem.\n",
+				files[entry_index].filename);
+			break;
+		}
+	}
+
+	if ((fclose(fip) != 0) && (status == 0)) {
+		status = EIO;
+	}
+
+	return status;
+}
+
+
+/*
+ * Create the image package file. The ToC is built in memory and the images are
+ * streamed after it into a temporary file, which then replaces the package.
+ * The existing package is still mapped at this point, so it cannot be
+ * overwritten while it is being written out.
+ */
 static int pack_images(const char *fip_filename)
 {
 	int status;
-	uint8_t *fip_base_address;
-	void *entry_address;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
+	uint8_t *toc_base_address;
 	unsigned int entry_index;
 	unsigned int toc_size;
-	unsigned int fip_size;
 	unsigned int entry_offset_address;
-	unsigned int payload_size = 0;
+	char *tmp_filename;
+	FILE *stream;
+	struct stat st;
+	bool fip_exists;
 
 	/* Validate filename */
 	if ((fip_filename == NULL) || (strcmp(fip_filename, "") == 0)) {
 		return EINVAL;
 	}
 
-	/* Payload size calculation */
-	for (entry_index = 0; entry_index < file_info_count; entry_index++) {
-		payload_size += files[entry_index].size;
-	}
-
-	/* Allocate memory for entire package, including the final null entry */
+	/* Size of the ToC, including the final null entry */
 	toc_size = (sizeof(fip_toc_header_t) +
 		    (sizeof(fip_toc_entry_t) * (file_info_count + 1)));
-	fip_size = toc_size + payload_size;
-	fip_base_address = malloc(fip_size);
-	if (fip_base_address == NULL) {
+
+	fip_exists = (stat(fip_filename, &st) == 0);
+	if (fip_exists && can_update_in_place(toc_size)) {
+		return update_images(fip_filename);
+	}
+
+	toc_base_address = calloc(1, toc_size);
+	if (toc_base_address == NULL) {
 		printf("Error: Can't allocate enough memory to create package."
 		       "Process aborted.\n");
 		return ENOMEM;
 	}
-	memset(fip_base_address, 0, fip_size);
 
 	/* Create ToC Header */
-	toc_header = (fip_toc_header_t *)fip_base_address;
+	toc_header = (fip_toc_header_t *)toc_base_address;
 	toc_header->name = TOC_HEADER_NAME;
 	toc_header->serial_number = TOC_HEADER_SERIAL_NUMBER;
-	toc_header->flags = 0;
+	toc_header->flags = (uint64_t)log2_align(fip_align) <<
+			    TOC_HEADER_FLAGS_ALIGN_SHIFT;
 
-	toc_entry = (fip_toc_entry_t *)(fip_base_address +
+	toc_entry = (fip_toc_entry_t *)(toc_base_address +
 				      sizeof(fip_toc_header_t));
 
 	/* Calculate the starting address of the first image, right after the
 	 * toc header.
 	 */
 	entry_offset_address = toc_size;
-	entry_index = 0;
 
-	/* Create the package in memory. */
 	for (entry_index = 0; entry_index < file_info_count; entry_index++) {
-		entry_address = (fip_base_address + entry_offset_address);
-		status = read_file_to_memory(entry_address,
-					     &files[entry_index]);
-		if (status != 0) {
-			printf("Error: While reading \"%s\" from filesystem.\n",
-				files[entry_index].filename);
-			return status;
-		}
-
+		entry_offset_address = align_offset(entry_offset_address);
 		copy_uuid(&toc_entry->uuid, &files[entry_index].name_uuid);
 		toc_entry->offset_address = entry_offset_address;
 		toc_entry->size = files[entry_index].size;
-		toc_entry->flags = 0;
+		toc_entry->flags = files[entry_index].flags;
 		entry_offset_address += toc_entry->size;
 		toc_entry++;
 	}
@@ -360,14 +748,68 @@ static int pack_images(const char *fip_filename)
 	toc_entry->size = 0;
 	toc_entry->flags = 0;
 
-	/* Save the package to file */
-	status = write_memory_to_file(fip_base_address, fip_filename, fip_size);
+	tmp_filename = malloc(strlen(fip_filename) + sizeof(".tmp"));
+	if (tmp_filename == NULL) {
+		free(toc_base_address);
+		return ENOMEM;
+	}
+	sprintf(tmp_filename, "%s.tmp", fip_filename);
+
+	stream = fopen(tmp_filename, "w");
+	if (stream == NULL) {
+		printf("Error: Cannot create output file \"%s\": %s\n",
+		       tmp_filename, strerror(errno));
+		status = errno;
+		free(tmp_filename);
+		free(toc_base_address);
+		return status;
+	}
+
+	printf("%s \"%s\"\n", fip_exists ? "Updating" : "Creating",
+	       fip_filename);
+
+	/* Write the ToC, then stream the images after it */
+	status = write_memory_to_stream(toc_base_address, toc_size, stream,
+					tmp_filename);
+	toc_entry = (fip_toc_entry_t *)(toc_base_address +
+				      sizeof(fip_toc_header_t));
+	entry_offset_address = toc_size;
+	for (entry_index = 0; (status == 0) && (entry_index < file_info_count);
+	     entry_index++, toc_entry++) {
+		/* Pad up to the aligned offset of the image */
+		status = write_padding_to_stream(toc_entry->offset_address -
+						 entry_offset_address, stream,
+						 tmp_filename);
+		if (status != 0)
+			break;
+
+		status = copy_image_to_stream(&files[entry_index], stream,
+					      tmp_filename);
+		entry_offset_address = toc_entry->offset_address +
+				       toc_entry->size;
+		if (status != 0) {
+			printf("Error: While reading \"%s\" from filesystem.\n",
+				files[entry_index].filename);
+		}
+	}
+
+	if ((fclose(stream) != 0) && (status == 0)) {
+		status = EIO;
+	}
+
+	if ((status == 0) && (rename(tmp_filename, fip_filename) != 0)) {
+		status = errno;
+	}
+
 	if (status != 0) {
 		printf("Error: Failed while writing package to file \"%s\" "
 			"with status=%d.\n", fip_filename, status);
-		return status;
+		remove(tmp_filename);
 	}
-	return 0;
+
+	free(tmp_filename);
+	free(toc_base_address);
+	return status;
 }
 
 
@@ -382,6 +824,9 @@ static void dump_toc(void)
 
 	printf("Firmware Image Package ToC:\n");
 	printf("---------------------------\n");
+	if (fip_align != 1) {
+		printf("Images aligned to 0x%X bytes\n", fip_align);
+	}
 	for (index = 0; index < file_info_count; index++) {
 		if (files[index].entry) {
 			printf("- %s: ", files[index].entry->name);
@@ -389,8 +834,17 @@ static void dump_toc(void)
 			printf("- Unknown entry: ");
 		}
 		image_size = files[index].size;
-
-		printf("offset=0x%X, size=0x%X\n", image_offset, image_size);
+		image_offset = align_offset(image_offset);
+
+		printf("offset=0x%X, size=0x%X", image_offset, image_size);
+		if (((files[index].flags >> TOC_ENTRY_FLAGS_COMPRESSION_SHIFT) &
+		     TOC_ENTRY_FLAGS_COMPRESSION_MASK) ==
+		    TOC_ENTRY_COMPRESSION_LZ4) {
+			printf(", LZ4 compressed from 0x%X",
+			       (unsigned int)(files[index].flags >>
+					      TOC_ENTRY_FLAGS_SIZE_SHIFT));
+		}
+		printf("\n");
 		image_offset += image_size;
 
 		if (files[index].filename) {
@@ -401,74 +855,86 @@ static void dump_toc(void)
 }
 
 
-/* Read and load existing package into memory. */
+/*
+ * Map the existing package into memory. The images it contains are not copied:
+ * their file_info entries point into the mapping, which stays in place until
+ * the program exits.
+ */
 static int parse_fip(const char *fip_filename)
 {
-	FILE *fip;
+	int fd;
 	char *fip_buffer;
 	char *fip_buffer_end;
-	int fip_size, read_fip_size;
+	size_t fip_size;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	bool found_last_toc_entry = false;
 	file_info_t *file_info_entry;
-	int status = -1;
 	struct stat st;
 
-	fip = fopen(fip_filename, "r");
-	if (fip == NULL) {
+	fd = open(fip_filename, O_RDONLY);
+	if (fd < 0) {
 		/* If the fip does not exist just return, it should not be
 		 * considered as an error. The package will be created later
 		 */
-		status = 0;
-		goto parse_fip_return;
-	}
-
-	if (stat(fip_filename, &st) != 0) {
-		status = errno;
-		goto parse_fip_fclose;
-	} else {
-		fip_size = (int)st.st_size;
-	}
-
-	/* Allocate a buffer to read the package */
-	fip_buffer = (char *)malloc(fip_size);
-	if (fip_buffer == NULL) {
-		printf("ERROR: Cannot allocate %d bytes.\n", fip_size);
-		status = errno;
-		goto parse_fip_fclose;
+		return 0;
 	}
-	fip_buffer_end = fip_buffer + fip_size;
 
-	/* Read the file */
-	read_fip_size = fread(fip_buffer, sizeof(char), fip_size, fip);
-	if (read_fip_size != fip_size) {
-		printf("ERROR: Cannot read the FIP.\n");
-		status = EIO;
-		goto parse_fip_free;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return errno;
 	}
-	fclose(fip);
-	fip = NULL;
+	fip_size = st.st_size;
 
 	/* The package must at least contain the ToC Header */
 	if (fip_size < sizeof(fip_toc_header_t)) {
 		printf("ERROR: Given FIP is smaller than the ToC header.\n");
-		status = EINVAL;
-		goto parse_fip_free;
+		close(fd);
+		return EINVAL;
+	}
+
+	fip_buffer = mmap(NULL, fip_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (fip_buffer == MAP_FAILED) {
+		printf("ERROR: Cannot map the FIP: %s\n", strerror(errno));
+		return errno;
 	}
+	fip_buffer_end = fip_buffer + fip_size;
+
 	/* Set the ToC Header at the base of the buffer */
 	toc_header = (fip_toc_header_t *)fip_buffer;
 	/* The first toc entry should be just after the ToC header */
 	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
 
+	/* Keep the alignment of the package unless told otherwise */
+	fip_align_in_package = 1U << ((toc_header->flags >>
+				       TOC_HEADER_FLAGS_ALIGN_SHIFT) &
+				      TOC_HEADER_FLAGS_ALIGN_MASK);
+	if (fip_align_in_package > MAX_ALIGN) {
+		printf("ERROR: Given FIP has an invalid alignment.\n");
+		munmap(fip_buffer, fip_size);
+		return EINVAL;
+	}
+	fip_align = fip_align_in_package;
+
 	/* While the ToC entry is contained into the buffer */
-	int cnt = 0;
 	while (((char *)toc_entry + sizeof(fip_toc_entry_t)) < fip_buffer_end) {
-		cnt++;
 		/* Check if the ToC Entry is the last one */
 		if (compare_uuids(&toc_entry->uuid, &uuid_null) == 0) {
 			found_last_toc_entry = true;
-			status = 0;
+			break;
+		}
+
+		/* The image must be contained into the buffer as well */
+		if ((toc_entry->offset_address > fip_size) ||
+		    (toc_entry->size > fip_size - toc_entry->offset_address)) {
+			printf("ERROR: Given FIP has an entry out of bounds.\n");
+			break;
+		}
+
+		/* Ensure we do not overflow */
+		if (file_info_count == MAX_FILES) {
+			printf("ERROR: Too many files in Package\n");
 			break;
 		}
 
@@ -483,6 +949,10 @@ static int parse_fip(const char *fip_filename)
 		file_info_entry->image_buffer = fip_buffer +
 		  toc_entry->offset_address;
 		file_info_entry->size = toc_entry->size;
+		file_info_entry->fip_offset = toc_entry->offset_address;
+		file_info_entry->fip_size = toc_entry->size;
+		file_info_entry->flags = toc_entry->flags;
+		file_info_entry->fip_flags = toc_entry->flags;
 
 		/* Check if there is a corresponding entry in lookup table */
 		file_info_entry->entry =
@@ -494,26 +964,242 @@ static int parse_fip(const char *fip_filename)
 
 	if (!found_last_toc_entry) {
 		printf("ERROR: Given FIP does not have an end ToC entry.\n");
-		status = EINVAL;
-		goto parse_fip_free;
-	} else {
-		/* All is well, we should not free any of the loaded images */
-		goto parse_fip_fclose;
+		munmap(fip_buffer, fip_size);
+		return EINVAL;
 	}
 
- parse_fip_free:
-	if (fip_buffer != NULL) {
-		free(fip_buffer);
-		fip_buffer = NULL;
+	return 0;
+}
+
+
+/* Name of an entry for the messages of verify_fip() */
+static const char *entry_name(const fip_toc_entry_t *toc_entry)
+{
+	entry_lookup_list_t *lookup_entry;
+
+	lookup_entry = get_entry_lookup_from_uuid(&toc_entry->uuid);
+	return (lookup_entry != NULL) ? lookup_entry->name : "Unknown entry";
+}
+
+
+/*
+ * Check the payload of a compressed entry: it must decompress to exactly the
+ * size recorded in the ToC entry, using all of the payload. The decompressed
+ * image is returned in 'image' (to be freed by the caller).
+ */
+static int verify_compressed(const fip_toc_entry_t *toc_entry,
+			     const uint8_t *payload, uint8_t **image,
+			     size_t *image_size)
+{
+	lz4_stream_t lz4;
+	size_t size, used;
+
+	size = (toc_entry->flags >> TOC_ENTRY_FLAGS_SIZE_SHIFT) &
+	       TOC_ENTRY_FLAGS_SIZE_MASK;
+	*image = malloc(size ? size : 1);
+	if (*image == NULL)
+		return ENOMEM;
+
+	lz4_stream_init(&lz4, (uintptr_t)*image, size);
+	if ((lz4_stream_decode(&lz4, payload, toc_entry->size, &used,
+			       size) != 0) ||
+	    (lz4.out_pos != size) || (used != toc_entry->size)) {
+		free(*image);
+		*image = NULL;
+		return EINVAL;
 	}
 
- parse_fip_fclose:
-	if (fip != NULL) {
-		fclose(fip);
+	*image_size = size;
+	return 0;
+}
+
+
+/*
+ * Check the package in a single pass over its mapping: the ToC header, the end
+ * of the ToC, and for each entry the bounds, alignment and uniqueness of its
+ * payload, as well as the decompression of compressed images. With --hash, the
+ * SHA-256 of each (decompressed) image is printed.
+ */
+static int verify_fip(const char *fip_filename)
+{
+	int fd;
+	uint8_t *fip_buffer;
+	size_t fip_size;
+	struct stat st;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry, *other;
+	unsigned int num_entries = 0, index, align, i;
+	unsigned long long toc_end, payload_bytes = 0;
+	uint8_t *image, *decompressed;
+	size_t image_size;
+	unsigned int compression;
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	sha256_ctx_t sha;
+	int errors = 0;
+
+	printf("Verifying \"%s\"\n", fip_filename);
+
+	fd = open(fip_filename, O_RDONLY);
+	if (fd < 0) {
+		printf("ERROR: Cannot open FIP: %s\n", strerror(errno));
+		return errno;
+	}
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return errno;
+	}
+	fip_size = st.st_size;
+	if (fip_size < sizeof(fip_toc_header_t)) {
+		printf("ERROR: FIP is smaller than the ToC header.\n");
+		close(fd);
+		return EINVAL;
 	}
 
- parse_fip_return:
-	return status;
+	fip_buffer = mmap(NULL, fip_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (fip_buffer == MAP_FAILED) {
+		printf("ERROR: Cannot map the FIP: %s\n", strerror(errno));
+		return errno;
+	}
+	stats.bytes_verified += fip_size;
+
+	toc_header = (fip_toc_header_t *)fip_buffer;
+	if ((toc_header->name != TOC_HEADER_NAME) ||
+	    (toc_header->serial_number == 0)) {
+		printf("ERROR: Invalid ToC header.\n");
+		munmap(fip_buffer, fip_size);
+		return EINVAL;
+	}
+
+	align = (toc_header->flags >> TOC_HEADER_FLAGS_ALIGN_SHIFT) &
+		TOC_HEADER_FLAGS_ALIGN_MASK;
+	if (align > log2_align(MAX_ALIGN)) {
+		printf("ERROR: Invalid image alignment in the ToC header.\n");
+		munmap(fip_buffer, fip_size);
+		return EINVAL;
+	}
+	align = 1U << align;
+
+	/* Find the end of the ToC */
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+	for (;;) {
+		if ((uint8_t *)(toc_entry + 1) > fip_buffer + fip_size) {
+			printf("ERROR: FIP does not have an end ToC entry.\n");
+			munmap(fip_buffer, fip_size);
+			return EINVAL;
+		}
+		if (compare_uuids(&toc_entry->uuid, &uuid_null) == 0)
+			break;
+		toc_entry++;
+		num_entries++;
+	}
+	toc_end = (uint8_t *)(toc_entry + 1) - fip_buffer;
+
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+	for (index = 0; index < num_entries; index++, toc_entry++) {
+		if ((toc_entry->offset_address < toc_end) ||
+		    (toc_entry->offset_address > fip_size) ||
+		    (toc_entry->size > fip_size - toc_entry->offset_address)) {
+			printf("ERROR: %s: payload out of bounds\n",
+			       entry_name(toc_entry));
+			errors++;
+			continue;
+		}
+		payload_bytes += toc_entry->size;
+
+		if (toc_entry->offset_address % align) {
+			printf("ERROR: %s: payload not aligned to 0x%X\n",
+			       entry_name(toc_entry), align);
+			errors++;
+		}
+
+		other = (fip_toc_entry_t *)(toc_header + 1);
+		for (i = 0; i < index; i++, other++) {
+			if (compare_uuids(&other->uuid, &toc_entry->uuid) == 0) {
+				printf("ERROR: %s: duplicate entry\n",
+				       entry_name(toc_entry));
+				errors++;
+			}
+			if ((toc_entry->size != 0) && (other->size != 0) &&
+			    (toc_entry->offset_address <
+			     other->offset_address + other->size) &&
+			    (other->offset_address <
+			     toc_entry->offset_address + toc_entry->size)) {
+				printf("ERROR: %s: payload overlaps %s\n",
+				       entry_name(toc_entry),
+				       entry_name(other));
+				errors++;
+			}
+		}
+
+		image = fip_buffer + toc_entry->offset_address;
+		image_size = toc_entry->size;
+		decompressed = NULL;
+		compression = (toc_entry->flags >>
+			       TOC_ENTRY_FLAGS_COMPRESSION_SHIFT) &
+			      TOC_ENTRY_FLAGS_COMPRESSION_MASK;
+		if (compression == TOC_ENTRY_COMPRESSION_LZ4) {
+			if (verify_compressed(toc_entry, image, &decompressed,
+					      &image_size) != 0) {
+				printf("ERROR: %s: invalid compressed payload\n",
+				       entry_name(toc_entry));
+				errors++;
+				continue;
+			}
+			image = decompressed;
+		} else if (compression != TOC_ENTRY_COMPRESSION_NONE) {
+			printf("ERROR: %s: unknown compression %u\n",
+			       entry_name(toc_entry), compression);
+			errors++;
+			continue;
+		}
+
+		if (do_hash) {
+			sha256_init(&sha);
+			sha256_update(&sha, image, image_size);
+			sha256_final(&sha, digest);
+			printf("- %s: sha256=", entry_name(toc_entry));
+			for (i = 0; i < SHA256_DIGEST_SIZE; i++)
+				printf("%02x", digest[i]);
+			printf("\n");
+		}
+		free(decompressed);
+	}
+
+	if (errors == 0) {
+		stats.padding_verified += fip_size - toc_end - payload_bytes;
+		printf("FIP OK: %u entries, 0x%llX bytes of images\n",
+		       num_entries, payload_bytes);
+	} else {
+		printf("FIP has %d error(s)\n", errors);
+	}
+
+	munmap(fip_buffer, fip_size);
+	return (errors == 0) ? 0 : EINVAL;
+}
+
+
+/* Print the measurements requested with --stats */
+static void print_stats(void)
+{
+	unsigned int phase;
+
+	printf("FIP statistics:\n");
+	printf("---------------------------\n");
+	for (phase = 0; phase < PHASE_NUM; phase++) {
+		printf("%-10s %10.6f s\n", phase_names[phase],
+		       stats.phase_time[phase]);
+	}
+	printf("Read from image files: %llu bytes\n", stats.bytes_read);
+	printf("Written to the FIP: %llu bytes, of which %llu bytes of"
+	       " alignment padding\n", stats.bytes_written,
+	       stats.padding_written);
+	if (do_verify) {
+		printf("Verified: %llu bytes, of which %llu bytes of"
+		       " padding\n", stats.bytes_verified,
+		       stats.padding_verified);
+	}
+	printf("---------------------------\n");
 }
 
 
@@ -557,6 +1243,10 @@ static int parse_cmdline(int argc, char **argv, struct option *options,
 	int option_index = 0;
 	entry_lookup_list_t *lookup_entry;
 	int do_dump = 0;
+	unsigned int index;
+	unsigned long align;
+	double start;
+	char *end;
 
 	/* restart parse to process all options. starts at 1. */
 	optind = 1;
@@ -588,6 +1278,51 @@ static int parse_cmdline(int argc, char **argv, struct option *options,
 			do_dump = 1;
 			continue;
 
+		case OPT_ALIGN:
+			align = strtoul(optarg, &end, 0);
+			if ((*optarg == '\0') || (*end != '\0') ||
+			    (align == 0) || (align > MAX_ALIGN) ||
+			    ((align & (align - 1)) != 0)) {
+				printf("ERROR: Invalid alignment \"%s\"\n",
+				       optarg);
+				return EINVAL;
+			}
+			fip_align = align;
+			if (fip_align != fip_align_in_package) {
+				/* Update package */
+				*do_pack = 1;
+			}
+			continue;
+
+		case OPT_COMPRESS:
+			for (lookup_entry = toc_entry_lookup_list;
+			     lookup_entry->command_line_name != NULL;
+			     lookup_entry++) {
+				if (strcmp(lookup_entry->command_line_name,
+					   optarg) == 0)
+					break;
+			}
+			if (lookup_entry->command_line_name == NULL) {
+				printf("ERROR: Unknown component \"%s\"\n",
+				       optarg);
+				return EINVAL;
+			}
+			lookup_entry->flags |= FLAG_COMPRESS;
+			/* Update package */
+			*do_pack = 1;
+			continue;
+
+		case OPT_HASH:
+			do_hash = 1;
+			/* Fall through */
+		case OPT_VERIFY:
+			do_verify = 1;
+			continue;
+
+		case OPT_STATS:
+			do_stats = 1;
+			continue;
+
 		case OPT_HELP:
 			print_usage();
 			exit(0);
@@ -599,6 +1334,17 @@ static int parse_cmdline(int argc, char **argv, struct option *options,
 	}
 
 
+	/* Compress the images before they are dumped or packed */
+	start = get_time();
+	for (index = 0; (status == 0) && (index < file_info_count); index++) {
+		status = compress_image(&files[index]);
+		if (status != 0) {
+			printf("Error: Failed to compress image (%d).\n",
+			       status);
+		}
+	}
+	stats.phase_time[PHASE_COMPRESS] = get_time() - start;
+
 	/* Do not dump toc if we have an error as it could hide the error */
 	if ((status == 0) && (do_dump)) {
 		dump_toc();
@@ -614,16 +1360,18 @@ int main(int argc, char **argv)
 	int status;
 	char *fip_filename;
 	int do_pack = 0;
+	double start;
 
 	/* Clear file list table. */
 	memset(files, 0, sizeof(files));
 
 	/* Initialise for getopt_long().
 	 * Use image table as defined at top of file to get options.
-	 * Add 'dump' option, 'help' option and end marker.
+	 * Add 'dump' option, 'align' option, 'compress' option, 'verify',
+	 * 'hash' and 'stats' options, 'help' option and end marker.
 	 */
 	static struct option long_options[(sizeof(toc_entry_lookup_list)/
-					   sizeof(entry_lookup_list_t)) + 2];
+					   sizeof(entry_lookup_list_t)) + 7];
 
 	for (i = 0;
 	     /* -1 because we dont want to process end marker in toc table */
@@ -642,6 +1390,36 @@ int main(int argc, char **argv)
 	long_options[i].flag = 0;
 	long_options[i].val = OPT_DUMP;
 
+	/* Add '--align' option */
+	long_options[++i].name = "align";
+	long_options[i].has_arg = 1;
+	long_options[i].flag = 0;
+	long_options[i].val = OPT_ALIGN;
+
+	/* Add '--compress' option */
+	long_options[++i].name = "compress";
+	long_options[i].has_arg = 1;
+	long_options[i].flag = 0;
+	long_options[i].val = OPT_COMPRESS;
+
+	/* Add '--verify' option */
+	long_options[++i].name = "verify";
+	long_options[i].has_arg = 0;
+	long_options[i].flag = 0;
+	long_options[i].val = OPT_VERIFY;
+
+	/* Add '--hash' option */
+	long_options[++i].name = "hash";
+	long_options[i].has_arg = 0;
+	long_options[i].flag = 0;
+	long_options[i].val = OPT_HASH;
+
+	/* Add '--stats' option */
+	long_options[++i].name = "stats";
+	long_options[i].has_arg = 0;
+	long_options[i].flag = 0;
+	long_options[i].val = OPT_STATS;
+
 	/* Add '--help' option */
 	long_options[++i].name = "help";
 	long_options[i].has_arg = 0;
@@ -670,7 +1448,9 @@ int main(int argc, char **argv)
 
 	/* Try to open the file and load it into memory */
 	if (fip_filename != NULL) {
+		start = get_time();
 		status = parse_fip(fip_filename);
+		stats.phase_time[PHASE_PARSE] = get_time() - start;
 		if (status != 0) {
 			return status;
 		}
@@ -692,12 +1472,25 @@ int main(int argc, char **argv)
 	 * required.
 	 */
 	if (do_pack) {
+		start = get_time();
 		status = pack_images(fip_filename);
+		stats.phase_time[PHASE_PACK] = get_time() - start;
 		if (status != 0) {
 			printf("Failed to create package (status = %d).\n",
 			       status);
 		}
 	}
 
+	/* Check the resulting package */
+	if ((status == 0) && do_verify) {
+		start = get_time();
+		status = verify_fip(fip_filename);
+		stats.phase_time[PHASE_VERIFY] = get_time() - start;
+	}
+
+	if (do_stats) {
+		print_stats();
+	}
+
 	return status;
 }
@@ -40,6 +40,8 @@
 #define TOC_HEADER_SERIAL_NUMBER	0x12345678
 
 #define FLAG_FILENAME			(1 << 0)
+/* Set by --compress for the images to store compressed */
+#define FLAG_COMPRESS			(1 << 1)
 
 typedef struct entry_lookup_list {
 	const char		*name;
@@ -49,12 +51,26 @@ typedef struct entry_lookup_list {
 	unsigned int		 flags;
 } entry_lookup_list_t;
 
+/*
+ * 'image_buffer' points into the mapping of the existing package for the
+ * entries read from it. 'fip_offset' and 'fip_size' keep the location of such
+ * an entry in the existing package, even when it is replaced by a file given
+ * on the command line ('filename' is then set). They are both 0 for entries
+ * which are not in the existing package. 'flags' are the flags of the ToC entry
+ * to write and 'fip_flags' those of the entry in the existing package. The
+ * payload of an image compressed by this tool is in 'compressed_buffer'.
+ */
 typedef struct file_info {
 	uuid_t			 name_uuid;
 	const char		*filename;
 	unsigned int		 size;
 	void			*image_buffer;
 	entry_lookup_list_t	*entry;
+	unsigned int		 fip_offset;
+	unsigned int		 fip_size;
+	uint64_t		 flags;
+	uint64_t		 fip_flags;
+	void			*compressed_buffer;
 } file_info_t;
 
 #endif /* __FIP_CREATE_H__ */
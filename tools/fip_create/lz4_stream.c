@@ -0,0 +1 @@
+../../lib/compress/lz4_stream.c
\ No newline at end of file
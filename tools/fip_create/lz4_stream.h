@@ -0,0 +1 @@
+../../include/lib/lz4_stream.h
\ No newline at end of file
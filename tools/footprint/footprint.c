@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host report of the memory footprint of a BL image. It reads the map file
+ * written by the linker, adds up the size of the input sections of each
+ * object file by kind of section and prints the result, largest module
+ * first. Budgets given on the command line are checked against the totals
+ * and the tool fails if any of them is exceeded.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LINE_MAX_LEN		1024
+#define MODULE_NAME_LEN		64
+#define MAX_MODULES		512
+
+/* Kinds of section the footprint is split into */
+enum {
+	KIND_TEXT = 0,
+	KIND_RODATA,
+	KIND_DATA,
+	KIND_BSS,
+	KIND_STACKS,
+	KIND_XLAT,
+	KIND_COHERENT,
+	NUM_KINDS
+};
+
+static const char *kind_names[NUM_KINDS] = {
+	"text", "rodata", "data", "bss", "stacks", "xlat", "coherent"
+};
+
+typedef struct module {
+	char name[MODULE_NAME_LEN];
+	unsigned long long size[NUM_KINDS];
+	unsigned long long total;
+} module_t;
+
+static module_t modules[MAX_MODULES];
+static unsigned int num_modules;
+
+/* Alignment padding inserted by the linker, by kind of section */
+static module_t fill = { "*fill*" };
+
+/* Extent of the image, from the lowest to the highest loaded address */
+static unsigned long long image_start = ~0ULL;
+static unsigned long long image_end;
+
+static void print_usage(void)
+{
+	printf("Usage: footprint <map file> [<budget> ...]\n\n");
+	printf("Prints the memory footprint of a BL image by module and kind "
+	       "of section.\n");
+	printf("A budget is <kind>=<bytes>, where <kind> is one of text, "
+	       "rodata, data,\n");
+	printf("bss, stacks, xlat, coherent or total (the extent of the "
+	       "image).\n");
+}
+
+/* Output sections which are not loaded in memory */
+static int is_debug_section(const char *name)
+{
+	return !strncmp(name, ".debug", 6) || !strncmp(name, ".comment", 8) ||
+	       !strncmp(name, ".stab", 5) || !strncmp(name, ".ARM.", 5) ||
+	       !strcmp(name, "/DISCARD/");
+}
+
+/*
+ * Return the kind of an input section from its name and the name of the
+ * output section it is placed in.
+ */
+static int section_kind(const char *out, const char *in)
+{
+	if (strstr(out, "coherent") != NULL)
+		return KIND_COHERENT;
+	if (!strncmp(in, ".text", 5) || !strcmp(in, ".vectors"))
+		return KIND_TEXT;
+	if (!strncmp(in, ".data", 5))
+		return KIND_DATA;
+	if (!strncmp(in, ".bss", 4) || !strcmp(in, "COMMON") ||
+	    !strcmp(in, "percpu") || !strcmp(in, "bakery_lock"))
+		return KIND_BSS;
+	if (!strcmp(in, "tzfw_normal_stacks"))
+		return KIND_STACKS;
+	if (!strcmp(in, "xlat_table") || !strcmp(in, "xlat_table_prebuilt"))
+		return KIND_XLAT;
+	if (!strcmp(in, "tzfw_coherent_mem"))
+		return KIND_COHERENT;
+
+	/* Read-only data, descriptors and any other loaded section */
+	return KIND_RODATA;
+}
+
+static module_t *find_module(const char *path)
+{
+	const char *name;
+	unsigned int i;
+	size_t len;
+
+	/* Keep the member name of objects taken from an archive */
+	name = strrchr(path, '/');
+	name = (name == NULL) ? path : name + 1;
+
+	for (i = 0; i < num_modules; i++)
+		if (!strncmp(modules[i].name, name, MODULE_NAME_LEN - 1))
+			return &modules[i];
+
+	if (num_modules == MAX_MODULES) {
+		fprintf(stderr, "Too many modules in the map file\n");
+		exit(EXIT_FAILURE);
+	}
+
+	len = strlen(name);
+	if (len >= MODULE_NAME_LEN)
+		len = MODULE_NAME_LEN - 1;
+	memcpy(modules[num_modules].name, name, len);
+	return &modules[num_modules++];
+}
+
+static void add_size(module_t *mod, int kind, unsigned long long size)
+{
+	mod->size[kind] += size;
+	mod->total += size;
+}
+
+/*
+ * Parse the "address size [file]" part of a line of the memory map. Return
+ * the number of fields found, or 0 if the line does not start with an
+ * address and a size.
+ */
+static int parse_placement(const char *str, unsigned long long *addr,
+			   unsigned long long *size, char *file)
+{
+	char a[32], s[32];
+	int n;
+
+	n = sscanf(str, " %31s %31s %255s", a, s, file);
+	if ((n < 2) || strncmp(a, "0x", 2) || strncmp(s, "0x", 2))
+		return 0;
+
+	*addr = strtoull(a, NULL, 16);
+	*size = strtoull(s, NULL, 16);
+	return n;
+}
+
+static int parse_map(FILE *fp)
+{
+	char line[LINE_MAX_LEN], next[LINE_MAX_LEN], file[256];
+	char out[LINE_MAX_LEN] = "", in[LINE_MAX_LEN];
+	unsigned long long addr, size;
+	int in_map = 0, skip = 1, kind = KIND_RODATA, n;
+	char *rest;
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		if (!in_map) {
+			in_map = !strncmp(line, "Linker script and memory map",
+					  28);
+			continue;
+		}
+
+		/* Output section: "name [address size]" at the first column */
+		if ((line[0] == '.') || ((line[0] >= 'a') && (line[0] <= 'z'))) {
+			if (sscanf(line, "%1023s", out) != 1)
+				continue;
+
+			rest = line + strlen(out);
+			if (parse_placement(rest, &addr, &size, file) == 0) {
+				/* Long names have their placement on the next line */
+				if (rest[strspn(rest, " \t\n")] != '\0')
+					continue;
+				if (fgets(next, sizeof(next), fp) == NULL)
+					break;
+				if (parse_placement(next, &addr, &size, file) == 0)
+					continue;
+			}
+
+			skip = is_debug_section(out) || (size == 0);
+			kind = section_kind(out, out);
+			if (!skip) {
+				if (addr < image_start)
+					image_start = addr;
+				if (addr + size > image_end)
+					image_end = addr + size;
+			}
+			continue;
+		}
+
+		/* Input sections start with a single space */
+		if (skip || (line[0] != ' ') || (line[1] == ' ') ||
+		    (line[1] == '\n'))
+			continue;
+
+		if (!strncmp(line, " *fill*", 7)) {
+			if (parse_placement(line + 7, &addr, &size, file) != 0)
+				add_size(&fill, kind, size);
+			continue;
+		}
+
+		/* Skip the input section patterns of the linker script */
+		if (line[1] == '*')
+			continue;
+
+		if (sscanf(line, " %1023s", in) != 1)
+			continue;
+
+		rest = line + 1 + strlen(in);
+		n = parse_placement(rest, &addr, &size, file);
+		if ((n == 0) && (rest[strspn(rest, " \t\n")] == '\0')) {
+			/* Long names have their placement on the next line */
+			if (fgets(next, sizeof(next), fp) == NULL)
+				break;
+			n = parse_placement(next, &addr, &size, file);
+		}
+		if ((n < 3) || (size == 0))
+			continue;
+
+		kind = section_kind(out, in);
+		add_size(find_module(file), kind, size);
+	}
+
+	if (!in_map) {
+		fprintf(stderr, "No memory map in the map file\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int compare_modules(const void *a, const void *b)
+{
+	const module_t *ma = a, *mb = b;
+
+	if (ma->total != mb->total)
+		return (ma->total < mb->total) ? 1 : -1;
+
+	return strcmp(ma->name, mb->name);
+}
+
+static void print_module(const module_t *mod)
+{
+	int k;
+
+	printf("%-32s", mod->name);
+	for (k = 0; k < NUM_KINDS; k++)
+		printf(" %8llu", mod->size[k]);
+	printf(" %8llu\n", mod->total);
+}
+
+static void print_report(module_t *total)
+{
+	unsigned int i;
+	int k;
+
+	qsort(modules, num_modules, sizeof(modules[0]), compare_modules);
+
+	printf("%-32s", "Module");
+	for (k = 0; k < NUM_KINDS; k++)
+		printf(" %8s", kind_names[k]);
+	printf(" %8s\n", "total");
+
+	for (i = 0; i < num_modules; i++) {
+		print_module(&modules[i]);
+		for (k = 0; k < NUM_KINDS; k++)
+			add_size(total, k, modules[i].size[k]);
+	}
+
+	if (fill.total != 0) {
+		print_module(&fill);
+		for (k = 0; k < NUM_KINDS; k++)
+			add_size(total, k, fill.size[k]);
+	}
+
+	print_module(total);
+
+	if (image_end > image_start)
+		printf("\nImage extent: 0x%llx - 0x%llx (%llu bytes)\n",
+		       image_start, image_end, image_end - image_start);
+}
+
+/*
+ * Check a budget of the form "<kind>=<bytes>". Return 1 if it is exceeded, 0
+ * if it is met and -1 if it is not valid.
+ */
+static int check_budget(const char *budget, const module_t *total)
+{
+	unsigned long long limit, used;
+	const char *eq;
+	char *end;
+	size_t len;
+	int k;
+
+	eq = strchr(budget, '=');
+	if (eq == NULL)
+		return -1;
+
+	len = eq - budget;
+	limit = strtoull(eq + 1, &end, 0);
+	if ((eq[1] == '\0') || (*end != '\0'))
+		return -1;
+
+	if ((len == 5) && !strncmp(budget, "total", 5)) {
+		used = (image_end > image_start) ? image_end - image_start : 0;
+	} else {
+		for (k = 0; k < NUM_KINDS; k++)
+			if ((strlen(kind_names[k]) == len) &&
+			    !strncmp(budget, kind_names[k], len))
+				break;
+		if (k == NUM_KINDS)
+			return -1;
+		used = total->size[k];
+	}
+
+	if (used <= limit)
+		return 0;
+
+	fprintf(stderr, "%.*s is %llu bytes, over its budget of %llu bytes\n",
+		(int)len, budget, used, limit);
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	module_t total = { "Total" };
+	int i, rc, over = 0;
+	FILE *fp;
+
+	if (argc < 2) {
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	fp = fopen(argv[1], "r");
+	if (fp == NULL) {
+		fprintf(stderr, "Cannot open %s: %s\n", argv[1], strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	rc = parse_map(fp);
+	fclose(fp);
+	if (rc != 0)
+		return EXIT_FAILURE;
+
+	print_report(&total);
+
+	for (i = 2; i < argc; i++) {
+		rc = check_budget(argv[i], &total);
+		if (rc < 0) {
+			fprintf(stderr, "Invalid budget: %s\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+		over |= rc;
+	}
+
+	return over ? EXIT_FAILURE : EXIT_SUCCESS;
+}
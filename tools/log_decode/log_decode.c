@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host decoder of the log records printed by BL31 when it is built with
+ * DEFERRED_LOG=1. It copies its input to its output, replacing each record
+ * with the message it stands for, formatted from the strings held by the ELF
+ * file of BL31.
+ */
+
+#include <elf.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Must match include/common/log_record.h */
+#define LOG_RECORD_MARKER	0x1e
+#define LOG_RECORD_MAX_ARGS	8
+
+#define LINE_MAX_LEN		1024
+
+static unsigned char *elf_data;
+static size_t elf_size;
+
+static void print_usage(void)
+{
+	printf("Usage: log_decode <BL31 ELF file> [log file]\n\n");
+	printf("Decodes the log records of a BL31 built with DEFERRED_LOG=1.\n");
+	printf("The log is read from the standard input if no file is given.\n");
+}
+
+static int load_elf(const char *name)
+{
+	Elf64_Ehdr *ehdr;
+	FILE *fp;
+	long size;
+
+	fp = fopen(name, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Cannot open %s: %s\n", name, strerror(errno));
+		return -1;
+	}
+
+	if (fseek(fp, 0, SEEK_END) || ((size = ftell(fp)) < 0) ||
+	    fseek(fp, 0, SEEK_SET)) {
+		fprintf(stderr, "Cannot get the size of %s\n", name);
+		fclose(fp);
+		return -1;
+	}
+
+	elf_size = size;
+	elf_data = malloc(elf_size);
+	if ((elf_data == NULL) ||
+	    (fread(elf_data, 1, elf_size, fp) != elf_size)) {
+		fprintf(stderr, "Cannot read %s\n", name);
+		fclose(fp);
+		return -1;
+	}
+	fclose(fp);
+
+	ehdr = (Elf64_Ehdr *)elf_data;
+	if ((elf_size < sizeof(*ehdr)) ||
+	    memcmp(ehdr->e_ident, ELFMAG, SELFMAG) ||
+	    (ehdr->e_ident[EI_CLASS] != ELFCLASS64) ||
+	    (ehdr->e_shentsize != sizeof(Elf64_Shdr)) ||
+	    (ehdr->e_shoff + (uint64_t)ehdr->e_shnum * sizeof(Elf64_Shdr) >
+	     elf_size)) {
+		fprintf(stderr, "%s is not a valid ELF64 file\n", name);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Return the string at address 'addr' of the image, or NULL if no section
+ * loaded by the image holds a NUL terminated string there.
+ */
+static const char *elf_string(uint64_t addr)
+{
+	Elf64_Ehdr *ehdr = (Elf64_Ehdr *)elf_data;
+	Elf64_Shdr *shdr = (Elf64_Shdr *)(elf_data + ehdr->e_shoff);
+	const char *str;
+	uint64_t off;
+	int i;
+
+	for (i = 0; i < ehdr->e_shnum; i++, shdr++) {
+		if (!(shdr->sh_flags & SHF_ALLOC) ||
+		    (shdr->sh_type != SHT_PROGBITS))
+			continue;
+
+		if ((addr < shdr->sh_addr) ||
+		    (addr >= shdr->sh_addr + shdr->sh_size) ||
+		    (shdr->sh_offset + shdr->sh_size > elf_size))
+			continue;
+
+		off = addr - shdr->sh_addr;
+		str = (const char *)elf_data + shdr->sh_offset + off;
+		if (memchr(str, '\0', shdr->sh_size - off) == NULL)
+			return NULL;
+
+		return str;
+	}
+
+	return NULL;
+}
+
+/*
+ * Format 'fmt' with the arguments of a record, the same way tf_printf() does.
+ */
+static void print_message(const char *fmt, unsigned int nargs,
+			  const uint64_t *args, FILE *out)
+{
+	unsigned int arg = 0;
+	const char *str;
+	uint64_t val;
+	int bit64;
+
+	for (; *fmt; fmt++) {
+		if (*fmt != '%') {
+			fputc(*fmt, out);
+			continue;
+		}
+
+		bit64 = 0;
+		while (*++fmt == 'l')
+			bit64 = 1;
+
+		if (*fmt == '\0')
+			return;
+
+		if (arg == nargs) {
+			fprintf(out, "<missing argument>");
+			return;
+		}
+		val = args[arg++];
+
+		switch (*fmt) {
+		case 'i':
+		case 'd':
+			if (bit64)
+				fprintf(out, "%lld", (long long)val);
+			else
+				fprintf(out, "%d", (int32_t)val);
+			break;
+		case 'u':
+			if (bit64)
+				fprintf(out, "%llu", (unsigned long long)val);
+			else
+				fprintf(out, "%u", (uint32_t)val);
+			break;
+		case 'x':
+			if (bit64)
+				fprintf(out, "%llx", (unsigned long long)val);
+			else
+				fprintf(out, "%x", (uint32_t)val);
+			break;
+		case 'p':
+			if (val)
+				fprintf(out, "0x%llx", (unsigned long long)val);
+			else
+				fputc('0', out);
+			break;
+		case 's':
+			str = elf_string(val);
+			if (str)
+				fputs(str, out);
+			else
+				fprintf(out, "<string at 0x%llx>",
+					(unsigned long long)val);
+			break;
+		default:
+			/* tf_printf() stops on any other format specifier */
+			return;
+		}
+	}
+}
+
+/*
+ * Decode the record in 'line', which starts after the marker. Returns 0 on
+ * success, -1 if the line is not a valid record.
+ */
+static int decode_record(const char *line, FILE *out)
+{
+	uint64_t vals[LOG_RECORD_MAX_ARGS + 1];
+	unsigned int n = 0;
+	const char *fmt;
+	char *end;
+
+	while (*line == ' ') {
+		if (n == LOG_RECORD_MAX_ARGS + 1)
+			return -1;
+
+		vals[n++] = strtoull(line + 1, &end, 16);
+		if (end == line + 1)
+			return -1;
+		line = end;
+	}
+
+	if ((n == 0) || ((*line != '\0') && (*line != '\r') && (*line != '\n')))
+		return -1;
+
+	fmt = elf_string(vals[0]);
+	if (fmt == NULL)
+		return -1;
+
+	print_message(fmt, n - 1, vals + 1, out);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	char line[LINE_MAX_LEN];
+	char *rec;
+	FILE *in = stdin;
+
+	if ((argc < 2) || (argc > 3)) {
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	if (load_elf(argv[1]))
+		return EXIT_FAILURE;
+
+	if (argc == 3) {
+		in = fopen(argv[2], "r");
+		if (in == NULL) {
+			fprintf(stderr, "Cannot open %s: %s\n", argv[2],
+				strerror(errno));
+			return EXIT_FAILURE;
+		}
+	}
+
+	while (fgets(line, sizeof(line), in)) {
+		/* Text printed before the record on the same line is kept */
+		rec = strchr(line, LOG_RECORD_MARKER);
+		if (rec == NULL) {
+			fputs(line, stdout);
+			continue;
+		}
+
+		fwrite(line, 1, rec - line, stdout);
+		if (decode_record(rec + 1, stdout))
+			fputs(rec, stdout);
+	}
+
+	if (in != stdin)
+		fclose(in);
+	free(elf_data);
+
+	return EXIT_SUCCESS;
+}
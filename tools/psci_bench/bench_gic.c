@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <mmio.h>
+#include "psci_bench.h"
+
+/*
+ * The CPUs are woken up from suspend states by the EL1 physical timer. Its
+ * interrupt is enabled in the GIC but never taken, as the exceptions stay
+ * masked: it only ends the wait for interrupt in BL31, and disappears once the
+ * timer is disabled.
+ */
+#define BENCH_TIMER_PPI			30
+#define BENCH_TIMER_PRIORITY		0x80
+
+/* Non-secure view of the registers */
+#define GICD_CTLR			0x0
+#define GICD_ISENABLER			0x100
+#define GICD_IPRIORITYR			0x400
+#define GICD_CTLR_ENABLE_GRP1		(1 << 0)
+
+#if BENCH_GICV3
+#define GICR_FRAME_SIZE			(1 << 17)
+#define GICR_TYPER			0x8
+#define GICR_TYPER_LAST			(1ull << 4)
+#define GICR_TYPER_AFF_SHIFT		32
+#define GICR_ISENABLER0			0x10100
+#define GICR_IPRIORITYR			0x10400
+
+DEFINE_RENAME_SYSREG_RW_FUNCS(icc_igrpen1_el1, S3_0_C12_C12_7)
+#else
+#define GICC_CTLR			0x0
+#define GICC_PMR			0x4
+#define GICC_CTLR_ENABLE_GRP1		(1 << 0)
+#endif
+
+/* Set up the distributor, once for all the CPUs */
+void bench_gic_init(void)
+{
+#if !BENCH_GICV3
+	/* BL31 owns the affinity routing enables of a GICv3 distributor */
+	mmio_setbits_32(BENCH_GICD_BASE + GICD_CTLR, GICD_CTLR_ENABLE_GRP1);
+#endif
+}
+
+#if BENCH_GICV3
+/* Return the base address of the redistributor of the calling CPU */
+static uintptr_t bench_gicr_base(void)
+{
+	uint64_t mpidr = read_mpidr_el1();
+	uint64_t aff = (mpidr & (MPIDR_AFFLVL_MASK << MPIDR_AFF0_SHIFT |
+				 MPIDR_AFFLVL_MASK << MPIDR_AFF1_SHIFT |
+				 MPIDR_AFFLVL_MASK << MPIDR_AFF2_SHIFT)) |
+		(((mpidr >> MPIDR_AFF3_SHIFT) & MPIDR_AFFLVL_MASK) << 24);
+	uintptr_t base = BENCH_GICR_BASE;
+	uint64_t typer;
+
+	for (;;) {
+		typer = mmio_read_64(base + GICR_TYPER);
+		if ((typer >> GICR_TYPER_AFF_SHIFT) == aff)
+			return base;
+		if (typer & GICR_TYPER_LAST)
+			break;
+		base += GICR_FRAME_SIZE;
+	}
+
+	bench_panic("no redistributor for the CPU");
+}
+#endif
+
+/* Set up the GIC interface of the calling CPU, after each power up */
+void bench_gic_cpu_init(void)
+{
+#if BENCH_GICV3
+	uintptr_t gicr_base = bench_gicr_base();
+
+	mmio_write_8(gicr_base + GICR_IPRIORITYR + BENCH_TIMER_PPI,
+		     BENCH_TIMER_PRIORITY);
+	mmio_write_32(gicr_base + GICR_ISENABLER0, 1 << BENCH_TIMER_PPI);
+	write_icc_pmr_el1(0xff);
+	write_icc_igrpen1_el1(1);
+#else
+	mmio_write_8(BENCH_GICD_BASE + GICD_IPRIORITYR + BENCH_TIMER_PPI,
+		     BENCH_TIMER_PRIORITY);
+	mmio_write_32(BENCH_GICD_BASE + GICD_ISENABLER,
+		      1 << BENCH_TIMER_PPI);
+	mmio_write_32(BENCH_GICC_BASE + GICC_PMR, 0xff);
+	mmio_setbits_32(BENCH_GICC_BASE + GICC_CTLR, GICC_CTLR_ENABLE_GRP1);
+#endif
+	isb();
+}
+
+/* Program the timer to fire at 'deadline', in system counter ticks */
+void bench_timer_arm(uint64_t deadline)
+{
+	write_cntp_cval_el0(deadline);
+	write_cntp_ctl_el0(1);
+	isb();
+}
+
+void bench_timer_disarm(void)
+{
+	write_cntp_ctl_el0(0);
+	isb();
+}
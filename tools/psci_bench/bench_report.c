@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arm_sip_svc.h>
+#include <debug.h>
+#include <psci.h>
+#include <psci_trace.h>
+#include <string.h>
+#include "psci_bench.h"
+
+/* Value returned in x0 by BL31 for an unknown SMC */
+#define BENCH_SMC_UNK			0xffffffff
+
+/* Number of distinct coordination outcomes which are counted */
+#define BENCH_COORD_OUTCOMES		16
+
+/* The requested states of a CPU are not known */
+#define BENCH_STATES_UNKNOWN		0xffffffff
+
+typedef struct bench_coord_outcome {
+	uint32_t requested;
+	uint32_t target;
+	uint64_t count;
+} bench_coord_outcome_t;
+
+static const char *const bench_lat_names[LAT_COUNT] = {
+	[LAT_CPU_ON_CALL] = "CPU_ON call",
+	[LAT_CPU_ON_ENTRY] = "CPU_ON to entry",
+	[LAT_CPU_OFF] = "CPU_OFF to off",
+	[LAT_AFF_INFO_CALL] = "AFFINITY_INFO call",
+	[LAT_STANDBY_EXIT] = "standby exit",
+	[LAT_CPU_PD_EXIT] = "CPU power down exit",
+	[LAT_CLUSTER_PD_EXIT] = "cluster power down exit",
+	[LAT_SYSTEM_SUSPEND_EXIT] = "system suspend exit",
+};
+
+/*
+ * State of the reading of the PSCI trace of BL31, by the controlling CPU. The
+ * trace is indexed by the linear index of the CPUs in BL31, all of which are
+ * found by the benchmark.
+ */
+static int trace_enabled;
+static uint64_t trace_next_seq[PLATFORM_CORE_COUNT];
+static uint32_t trace_requested[PLATFORM_CORE_COUNT];
+static uint64_t trace_lost;
+static uint64_t trace_aborted;
+static bench_coord_outcome_t coord_outcomes[BENCH_COORD_OUTCOMES];
+static unsigned int coord_outcome_count;
+static uint64_t coord_other;
+
+/* Samples of all the CPUs for one latency */
+static uint32_t lat_samples[PLATFORM_CORE_COUNT * BENCH_SAMPLES];
+
+void bench_lat_record(bench_lat_t *lat, uint64_t ticks)
+{
+	uint32_t t = ticks > UINT32_MAX ? UINT32_MAX : ticks;
+
+	lat->samples[lat->count % BENCH_SAMPLES] = t;
+	lat->count++;
+	lat->sum += t;
+	if (t > lat->max)
+		lat->max = t;
+}
+
+static uint64_t ticks_to_us(uint64_t ticks)
+{
+	return ticks * 1000000 / bench_ticks_per_sec;
+}
+
+/*******************************************************************************
+ * PSCI trace
+ ******************************************************************************/
+static void trace_event(unsigned int idx, uint32_t event, uint32_t arg)
+{
+	unsigned int i;
+
+	switch (event) {
+	case PSCI_TRACE_SUSPEND:
+		/* A previous request found a wakeup event pending */
+		if (trace_requested[idx] != BENCH_STATES_UNKNOWN)
+			trace_aborted++;
+		trace_requested[idx] = arg;
+		return;
+	case PSCI_TRACE_WAKEUP:
+		if (trace_requested[idx] != BENCH_STATES_UNKNOWN)
+			trace_aborted++;
+		trace_requested[idx] = BENCH_STATES_UNKNOWN;
+		return;
+	case PSCI_TRACE_COORD_RESULT:
+		break;
+	default:
+		return;
+	}
+
+	for (i = 0; i < coord_outcome_count; i++) {
+		if (coord_outcomes[i].requested == trace_requested[idx] &&
+		    coord_outcomes[i].target == arg)
+			break;
+	}
+
+	if (i < coord_outcome_count) {
+		coord_outcomes[i].count++;
+	} else if (i < BENCH_COORD_OUTCOMES) {
+		coord_outcomes[i].requested = trace_requested[idx];
+		coord_outcomes[i].target = arg;
+		coord_outcomes[i].count = 1;
+		coord_outcome_count++;
+	} else {
+		coord_other++;
+	}
+
+	trace_requested[idx] = BENCH_STATES_UNKNOWN;
+}
+
+/* Read the events recorded by a CPU since the last call */
+static void trace_poll_cpu(unsigned int idx)
+{
+	bench_smc_args_t args;
+
+	for (;;) {
+		args.x0 = ARM_SIP_PSCI_TRACE_READ;
+		args.x1 = idx;
+		args.x2 = trace_next_seq[idx];
+		args.x3 = 0;
+		bench_smc(&args);
+
+		if (args.x0) {
+			/* Skip the events overwritten before being read */
+			if (args.x3 <= trace_next_seq[idx] + PSCI_TRACE_ENTRIES)
+				return;
+
+			trace_lost += args.x3 - PSCI_TRACE_ENTRIES -
+				trace_next_seq[idx];
+			trace_next_seq[idx] = args.x3 - PSCI_TRACE_ENTRIES;
+			trace_requested[idx] = BENCH_STATES_UNKNOWN;
+			continue;
+		}
+
+		trace_event(idx, args.x2 & 0xffffffff, args.x2 >> 32);
+		trace_next_seq[idx]++;
+	}
+}
+
+void bench_trace_init(void)
+{
+	bench_smc_args_t args = { ARM_SIP_PSCI_TRACE_READ, 0, 0, 0 };
+	unsigned int idx;
+
+	bench_smc(&args);
+	if (args.x0 == BENCH_SMC_UNK) {
+		tf_printf("PSCI trace not available\n");
+		return;
+	}
+
+	/* Skip the events recorded before the benchmark */
+	for (idx = 0; idx < bench_cpu_count; idx++) {
+		args.x0 = ARM_SIP_PSCI_TRACE_READ;
+		args.x1 = idx;
+		args.x2 = 0;
+		args.x3 = 0;
+		bench_smc(&args);
+		trace_next_seq[idx] = args.x3;
+		trace_requested[idx] = BENCH_STATES_UNKNOWN;
+	}
+
+	trace_enabled = 1;
+}
+
+void bench_trace_poll(void)
+{
+	unsigned int idx;
+
+	if (!trace_enabled)
+		return;
+
+	for (idx = 0; idx < bench_cpu_count; idx++)
+		trace_poll_cpu(idx);
+}
+
+/*******************************************************************************
+ * Report
+ ******************************************************************************/
+static void sort_samples(uint32_t *samples, unsigned int n)
+{
+	unsigned int gap, i, j;
+	uint32_t v;
+
+	for (gap = n / 2; gap; gap /= 2) {
+		for (i = gap; i < n; i++) {
+			v = samples[i];
+			for (j = i; j >= gap && samples[j - gap] > v; j -= gap)
+				samples[j] = samples[j - gap];
+			samples[j] = v;
+		}
+	}
+}
+
+static uint64_t percentile_us(unsigned int n, unsigned int pct)
+{
+	return ticks_to_us(lat_samples[(n - 1) * pct / 100]);
+}
+
+static void report_ops(void)
+{
+	uint64_t count, early = 0;
+	unsigned int op, idx;
+
+	tf_printf("Operations:\n");
+	for (op = OP_NONE + 1; op < OP_COUNT; op++) {
+		count = 0;
+		for (idx = 0; idx < bench_cpu_count; idx++)
+			count += bench_cpus[idx].op_count[op];
+		tf_printf("  %s: %lu\n", bench_op_names[op], count);
+	}
+
+	for (idx = 0; idx < bench_cpu_count; idx++)
+		early += bench_cpus[idx].early_wakeups;
+	tf_printf("  wakeups before the timer: %lu\n", early);
+}
+
+static void report_latencies(void)
+{
+	bench_lat_t *lat;
+	uint64_t count, sum, max, kept;
+	unsigned int l, idx, n;
+
+	tf_printf("Latencies (us): count, mean, p50, p90, p99, max\n");
+	for (l = 0; l < LAT_COUNT; l++) {
+		count = sum = max = 0;
+		n = 0;
+		for (idx = 0; idx < bench_cpu_count; idx++) {
+			lat = &bench_cpus[idx].lat[l];
+			kept = lat->count < BENCH_SAMPLES ?
+				lat->count : BENCH_SAMPLES;
+			memcpy(&lat_samples[n], lat->samples,
+			       kept * sizeof(lat->samples[0]));
+			n += kept;
+			count += lat->count;
+			sum += lat->sum;
+			if (lat->max > max)
+				max = lat->max;
+		}
+
+		if (!count)
+			continue;
+
+		sort_samples(lat_samples, n);
+		tf_printf("  %s: %lu, %lu, %lu, %lu, %lu, %lu\n",
+			  bench_lat_names[l], count, ticks_to_us(sum / count),
+			  percentile_us(n, 50), percentile_us(n, 90),
+			  percentile_us(n, 99), ticks_to_us(max));
+	}
+}
+
+/* Report the residency statistics of BL31 for the states requested */
+static void report_residency(void)
+{
+	uint64_t mpidr, count, residency;
+	unsigned int op, idx;
+	int rc;
+
+	rc = bench_psci(PSCI_FEATURES, PSCI_STAT_COUNT_AARCH64, 0, 0);
+	if (rc != PSCI_E_SUCCESS) {
+		tf_printf("PSCI_STAT_COUNT not supported\n");
+		return;
+	}
+
+	tf_printf("Residency (entries, us):\n");
+	for (idx = 0; idx < bench_cpu_count; idx++) {
+		mpidr = bench_cpus[idx].mpidr;
+		tf_printf("  CPU 0x%lx:", mpidr);
+		for (op = OP_STANDBY; op <= OP_CLUSTER_PD; op++) {
+			count = bench_psci(PSCI_STAT_COUNT_AARCH64, mpidr,
+					   bench_pstates[op], 0);
+			residency = bench_psci(PSCI_STAT_RESIDENCY_AARCH64,
+					       mpidr, bench_pstates[op], 0);
+			tf_printf(" 0x%x: %lu, %lu;", bench_pstates[op],
+				  count, residency);
+		}
+		tf_printf("\n");
+	}
+}
+
+/* Report the outcomes of the coordination of the requested states */
+static void report_coordination(void)
+{
+	bench_coord_outcome_t *outcome;
+	unsigned int i;
+
+	if (!trace_enabled)
+		return;
+
+	tf_printf("Coordination (requested states -> target states):\n");
+	for (i = 0; i < coord_outcome_count; i++) {
+		outcome = &coord_outcomes[i];
+		if (outcome->requested == BENCH_STATES_UNKNOWN)
+			tf_printf("  unknown -> 0x%x: %lu\n", outcome->target,
+				  outcome->count);
+		else
+			tf_printf("  0x%x -> 0x%x: %lu%s\n", outcome->requested,
+				  outcome->target, outcome->count,
+				  outcome->target == outcome->requested ?
+				  "" : " (demoted)");
+	}
+
+	tf_printf("  other outcomes: %lu, aborted: %lu, events lost: %lu\n",
+		  coord_other, trace_aborted, trace_lost);
+}
+
+/* Print the report of the benchmark, return the number of errors */
+int bench_report(void)
+{
+	bench_cpu_t *cpu;
+	unsigned int idx;
+	int errors = 0;
+
+	bench_trace_poll();
+
+	report_ops();
+	report_latencies();
+	report_residency();
+	report_coordination();
+
+	for (idx = 0; idx < bench_cpu_count; idx++) {
+		cpu = &bench_cpus[idx];
+		if (!cpu->errors)
+			continue;
+
+		tf_printf("CPU 0x%lx: %lu errors, last %s returned %d\n",
+			  cpu->mpidr, cpu->errors,
+			  bench_op_names[cpu->last_err_op], cpu->last_err_rc);
+		errors += cpu->errors;
+	}
+
+	return errors;
+}
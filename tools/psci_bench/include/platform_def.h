@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __PLATFORM_DEF_H__
+#define __PLATFORM_DEF_H__
+
+/*
+ * Platform definitions of psci_bench: the view the normal world has of the
+ * ARM standard platforms, as the payload does not run on top of the platform
+ * ports of the firmware.
+ */
+
+#if BENCH_PLAT_FVP
+#define BENCH_UART_BASE			0x1c090000
+#define BENCH_UART_CLK_IN_HZ		24000000
+#define BENCH_GICD_BASE			0x2f000000
+#define BENCH_GICR_BASE			0x2f100000
+#define BENCH_GICC_BASE			0x2c000000
+#define BENCH_MAX_CLUSTERS		2
+#define BENCH_MAX_CPUS_PER_CLUSTER	4
+#elif BENCH_PLAT_JUNO
+#define BENCH_UART_BASE			0x7ff80000
+#define BENCH_UART_CLK_IN_HZ		7273800
+#define BENCH_GICD_BASE			0x2c010000
+#define BENCH_GICC_BASE			0x2c02f000
+#define BENCH_MAX_CLUSTERS		2
+#define BENCH_MAX_CPUS_PER_CLUSTER	4
+#else
+#error "Unsupported platform"
+#endif
+
+#define BENCH_UART_BAUDRATE		115200
+
+/*
+ * Power states requested through CPU_SUSPEND, in the format of the ARM
+ * standard platforms: retention of the CPU, power down of the CPU and power
+ * down of the CPU and its cluster.
+ */
+#if PSCI_EXTENDED_STATE_ID
+#define BENCH_PSTATE_STANDBY		0x00000001
+#define BENCH_PSTATE_CPU_PD		0x40000002
+#define BENCH_PSTATE_CLUSTER_PD		0x40000022
+#else
+#define BENCH_PSTATE_STANDBY		0x00000000
+#define BENCH_PSTATE_CPU_PD		0x00010000
+#define BENCH_PSTATE_CLUSTER_PD		0x01010000
+#endif
+
+/* Definitions needed by the firmware headers */
+#define PLATFORM_CORE_COUNT		(BENCH_MAX_CLUSTERS * \
+					 BENCH_MAX_CPUS_PER_CLUSTER)
+#define PLAT_NUM_PWR_DOMAINS		(PLATFORM_CORE_COUNT + \
+					 BENCH_MAX_CLUSTERS + 1)
+#define PLAT_MAX_PWR_LVL		2
+#define CACHE_WRITEBACK_GRANULE		64
+
+#endif /* __PLATFORM_DEF_H__ */
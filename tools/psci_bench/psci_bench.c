@@ -0,0 +1,538 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <console.h>
+#include <debug.h>
+#include <psci.h>
+#include "psci_bench.h"
+
+/*******************************************************************************
+ * PSCI stress and latency benchmark, run as BL33. The primary CPU is the
+ * controlling CPU: it turns the other CPUs on, finds them off again by polling
+ * AFFINITY_INFO, periodically turns them all off to suspend the system and
+ * reports the results at the end. The other CPUs are the workers: they perform
+ * random CPU_SUSPEND, CPU_OFF and AFFINITY_INFO calls, at the relative rates
+ * given at build time and separated by random delays.
+ ******************************************************************************/
+
+/* Phases of the benchmark, set by the controlling CPU */
+#define BENCH_RUN			0
+#define BENCH_QUIESCE			1	/* Before SYSTEM_SUSPEND */
+#define BENCH_STOP			2
+
+/* Time given to the workers to turn off at the end of a phase */
+#define BENCH_OFF_TIMEOUT_MS		1000
+
+bench_cpu_t bench_cpus[PLATFORM_CORE_COUNT];
+unsigned int bench_cpu_count;
+uint64_t bench_ticks_per_sec;
+
+const char *const bench_op_names[OP_COUNT] = {
+	[OP_NONE] = "none",
+	[OP_STANDBY] = "CPU_SUSPEND standby",
+	[OP_CPU_PD] = "CPU_SUSPEND CPU power down",
+	[OP_CLUSTER_PD] = "CPU_SUSPEND cluster power down",
+	[OP_CPU_OFF] = "CPU_OFF",
+	[OP_AFF_INFO] = "AFFINITY_INFO",
+	[OP_CPU_ON] = "CPU_ON",
+	[OP_SYSTEM_SUSPEND] = "SYSTEM_SUSPEND",
+};
+
+/* Power state requested by each CPU_SUSPEND operation */
+const unsigned int bench_pstates[OP_COUNT] = {
+	[OP_STANDBY] = BENCH_PSTATE_STANDBY,
+	[OP_CPU_PD] = BENCH_PSTATE_CPU_PD,
+	[OP_CLUSTER_PD] = BENCH_PSTATE_CLUSTER_PD,
+};
+
+/* Relative rates of the operations of the workers */
+static const unsigned int bench_op_rates[OP_COUNT] = {
+	[OP_STANDBY] = BENCH_RATE_STANDBY,
+	[OP_CPU_PD] = BENCH_RATE_CPU_PD,
+	[OP_CLUSTER_PD] = BENCH_RATE_CLUSTER_PD,
+	[OP_CPU_OFF] = BENCH_RATE_CPU_OFF,
+	[OP_AFF_INFO] = BENCH_RATE_AFF_INFO,
+};
+
+/* Exit latency of each suspend operation */
+static const unsigned int bench_exit_lats[OP_COUNT] = {
+	[OP_STANDBY] = LAT_STANDBY_EXIT,
+	[OP_CPU_PD] = LAT_CPU_PD_EXIT,
+	[OP_CLUSTER_PD] = LAT_CLUSTER_PD_EXIT,
+	[OP_SYSTEM_SUSPEND] = LAT_SYSTEM_SUSPEND_EXIT,
+};
+
+/* State of the controlling CPU, only written by it */
+static volatile unsigned int bench_phase;
+static uint64_t bench_start;
+static uint64_t bench_phase_deadline;
+static uint64_t bench_next_sys_suspend;
+/* Time each worker was last given to CPU_ON, read by the worker */
+static uint64_t bench_on_issued[PLATFORM_CORE_COUNT];
+/* Whether the controlling CPU has found each worker off */
+static unsigned int bench_off_seen[PLATFORM_CORE_COUNT];
+
+static uint64_t us_to_ticks(uint64_t us)
+{
+	return us * bench_ticks_per_sec / 1000000;
+}
+
+static void delay_us(uint64_t us)
+{
+	uint64_t end = read_cntpct_el0() + us_to_ticks(us);
+
+	while (read_cntpct_el0() < end)
+		;
+}
+
+/* Return a pseudo-random number from the xorshift generator of a CPU */
+static uint32_t bench_rand(bench_cpu_t *cpu)
+{
+	uint64_t x = cpu->rand;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	cpu->rand = x;
+
+	return x >> 32;
+}
+
+uint64_t bench_psci(uint64_t fid, uint64_t x1, uint64_t x2, uint64_t x3)
+{
+	bench_smc_args_t args = { fid, x1, x2, x3 };
+
+	bench_smc(&args);
+
+	return args.x0;
+}
+
+static void bench_error(bench_cpu_t *cpu, unsigned int op, int rc)
+{
+	cpu->errors++;
+	cpu->last_err_op = op;
+	cpu->last_err_rc = rc;
+}
+
+/*******************************************************************************
+ * Record the end of a suspend operation of the calling CPU, woken up at time
+ * 'now'. 'rc' is the value returned by the suspend call.
+ ******************************************************************************/
+static void suspend_done(bench_cpu_t *cpu, int rc, uint64_t now)
+{
+	bench_timer_disarm();
+
+	if (rc != PSCI_E_SUCCESS)
+		bench_error(cpu, cpu->op, rc);
+	else if (now < cpu->deadline)
+		cpu->early_wakeups++;
+	else
+		bench_lat_record(&cpu->lat[bench_exit_lats[cpu->op]],
+				 now - cpu->deadline);
+
+	cpu->op = OP_NONE;
+}
+
+/*******************************************************************************
+ * Worker operations
+ ******************************************************************************/
+static void do_suspend(unsigned int idx, bench_cpu_t *cpu, unsigned int op)
+{
+	uint64_t sleep_us;
+	int rc;
+
+	/* Sleep long enough for the suspend state to be entered */
+	sleep_us = BENCH_SLEEP_US / 2 +
+		bench_rand(cpu) % (BENCH_SLEEP_US / 2 + 1);
+
+	cpu->op = op;
+	cpu->op_count[op]++;
+	cpu->op_start = read_cntpct_el0();
+	cpu->deadline = cpu->op_start + us_to_ticks(sleep_us);
+	bench_timer_arm(cpu->deadline);
+
+	rc = bench_psci(PSCI_CPU_SUSPEND_AARCH64, bench_pstates[op],
+			(uintptr_t)bench_warm_entrypoint, idx);
+
+	/* Standby, or a power down state which was not entered */
+	suspend_done(cpu, rc, read_cntpct_el0());
+}
+
+static void do_cpu_off(bench_cpu_t *cpu)
+{
+	int rc;
+
+	cpu->op = OP_CPU_OFF;
+	cpu->op_count[OP_CPU_OFF]++;
+	cpu->op_start = read_cntpct_el0();
+
+	rc = bench_psci(PSCI_CPU_OFF, 0, 0, 0);
+
+	/* CPU_OFF only returns on failure */
+	bench_error(cpu, OP_CPU_OFF, rc);
+	cpu->op = OP_NONE;
+}
+
+static void do_aff_info(bench_cpu_t *cpu)
+{
+	uint64_t target = bench_cpus[bench_rand(cpu) % bench_cpu_count].mpidr;
+	uint64_t start;
+	int rc;
+
+	cpu->op_count[OP_AFF_INFO]++;
+	start = read_cntpct_el0();
+	rc = bench_psci(PSCI_AFFINITY_INFO_AARCH64, target, 0, 0);
+	bench_lat_record(&cpu->lat[LAT_AFF_INFO_CALL],
+			 read_cntpct_el0() - start);
+
+	if (rc < AFF_STATE_ON || rc > AFF_STATE_ON_PENDING)
+		bench_error(cpu, OP_AFF_INFO, rc);
+}
+
+/* Pick the next operation of a worker according to the rates */
+static unsigned int pick_op(bench_cpu_t *cpu)
+{
+	unsigned int op, total = 0, r;
+
+	for (op = 0; op < OP_COUNT; op++)
+		total += bench_op_rates[op];
+	if (!total)
+		return OP_NONE;
+
+	r = bench_rand(cpu) % total;
+	for (op = 0; r >= bench_op_rates[op]; op++)
+		r -= bench_op_rates[op];
+
+	return op;
+}
+
+static void __dead2 worker_loop(unsigned int idx)
+{
+	bench_cpu_t *cpu = &bench_cpus[idx];
+	unsigned int op;
+
+	for (;;) {
+		if (bench_phase != BENCH_RUN)
+			do_cpu_off(cpu);
+
+		delay_us(bench_rand(cpu) % (BENCH_DELAY_US + 1));
+
+		op = pick_op(cpu);
+		switch (op) {
+		case OP_STANDBY:
+		case OP_CPU_PD:
+		case OP_CLUSTER_PD:
+			do_suspend(idx, cpu, op);
+			break;
+		case OP_CPU_OFF:
+			do_cpu_off(cpu);
+			break;
+		case OP_AFF_INFO:
+			do_aff_info(cpu);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/*******************************************************************************
+ * Controlling CPU
+ ******************************************************************************/
+
+/*
+ * Check the state of a worker at time 'now' and turn it on again if it is off
+ * while the benchmark runs. Return 1 if the worker is off.
+ */
+static int poll_worker(unsigned int idx, uint64_t now)
+{
+	bench_cpu_t *ctl = &bench_cpus[0];
+	bench_cpu_t *cpu = &bench_cpus[idx];
+	int rc;
+
+	rc = bench_psci(PSCI_AFFINITY_INFO_AARCH64, cpu->mpidr, 0, 0);
+	if (rc != AFF_STATE_OFF) {
+		if (rc < AFF_STATE_ON || rc > AFF_STATE_ON_PENDING)
+			bench_error(ctl, OP_AFF_INFO, rc);
+		return 0;
+	}
+
+	if (!bench_off_seen[idx]) {
+		bench_off_seen[idx] = 1;
+		if (cpu->op == OP_CPU_OFF)
+			bench_lat_record(&ctl->lat[LAT_CPU_OFF],
+					 now - cpu->op_start);
+	}
+
+	if (bench_phase != BENCH_RUN)
+		return 1;
+
+	ctl->op_count[OP_CPU_ON]++;
+	bench_on_issued[idx] = read_cntpct_el0();
+	rc = bench_psci(PSCI_CPU_ON_AARCH64, cpu->mpidr,
+			(uintptr_t)bench_warm_entrypoint, idx);
+	bench_lat_record(&ctl->lat[LAT_CPU_ON_CALL],
+			 read_cntpct_el0() - bench_on_issued[idx]);
+
+	if (rc == PSCI_E_SUCCESS) {
+		bench_off_seen[idx] = 0;
+		return 0;
+	}
+
+	/* The worker may still be on its way to power down */
+	if (rc != PSCI_E_ALREADY_ON && rc != PSCI_E_ON_PENDING)
+		bench_error(ctl, OP_CPU_ON, rc);
+
+	return 1;
+}
+
+static void set_phase(unsigned int phase, uint64_t now)
+{
+	bench_phase = phase;
+	bench_phase_deadline = now + us_to_ticks(BENCH_OFF_TIMEOUT_MS * 1000);
+	dsb();
+}
+
+/* Schedule the next system suspend, if any */
+static void schedule_sys_suspend(uint64_t now)
+{
+	if (BENCH_SYS_SUSPEND_MS)
+		bench_next_sys_suspend = now +
+			us_to_ticks(BENCH_SYS_SUSPEND_MS * 1000);
+}
+
+/* Suspend the system once all the workers are off */
+static void do_system_suspend(void)
+{
+	bench_cpu_t *ctl = &bench_cpus[0];
+	int rc;
+
+	ctl->op = OP_SYSTEM_SUSPEND;
+	ctl->op_count[OP_SYSTEM_SUSPEND]++;
+	ctl->op_start = read_cntpct_el0();
+	ctl->deadline = ctl->op_start + us_to_ticks(BENCH_SLEEP_US);
+	bench_timer_arm(ctl->deadline);
+
+	rc = bench_psci(PSCI_SYSTEM_SUSPEND_AARCH64,
+			(uintptr_t)bench_warm_entrypoint, 0, 0);
+
+	/* SYSTEM_SUSPEND only returns on failure */
+	suspend_done(ctl, rc, read_cntpct_el0());
+	set_phase(BENCH_RUN, read_cntpct_el0());
+	schedule_sys_suspend(read_cntpct_el0());
+}
+
+/* Report the workers which did not turn off in time */
+static void report_stuck_workers(void)
+{
+	unsigned int idx;
+
+	for (idx = 1; idx < bench_cpu_count; idx++) {
+		if (bench_off_seen[idx])
+			continue;
+
+		tf_printf("CPU 0x%lx did not turn off, last operation: %s\n",
+			  bench_cpus[idx].mpidr,
+			  bench_op_names[bench_cpus[idx].op]);
+		bench_error(&bench_cpus[0], OP_CPU_OFF, PSCI_E_INTERN_FAIL);
+	}
+}
+
+static void __dead2 bench_finish(void)
+{
+	int failed;
+
+	failed = bench_report();
+	tf_printf("PSCI benchmark %s\n", failed ? "FAILED" : "PASSED");
+
+#if BENCH_SYSTEM_OFF
+	bench_psci(PSCI_SYSTEM_OFF, 0, 0, 0);
+#endif
+	for (;;)
+		wfi();
+}
+
+static void __dead2 controller_loop(void)
+{
+	uint64_t end = bench_start + us_to_ticks(BENCH_DURATION_MS * 1000ull);
+	uint64_t now;
+	unsigned int idx;
+	int all_off;
+
+	for (;;) {
+		now = read_cntpct_el0();
+
+		if (bench_phase != BENCH_STOP && now >= end)
+			set_phase(BENCH_STOP, now);
+		else if (bench_phase == BENCH_RUN && bench_next_sys_suspend &&
+			 now >= bench_next_sys_suspend)
+			set_phase(BENCH_QUIESCE, now);
+
+		all_off = 1;
+		for (idx = 1; idx < bench_cpu_count; idx++)
+			all_off &= poll_worker(idx, now);
+
+		bench_trace_poll();
+
+		if (bench_phase == BENCH_STOP) {
+			if (all_off)
+				break;
+			if (now >= bench_phase_deadline) {
+				report_stuck_workers();
+				break;
+			}
+		} else if (bench_phase == BENCH_QUIESCE) {
+			if (all_off) {
+				do_system_suspend();
+			} else if (now >= bench_phase_deadline) {
+				report_stuck_workers();
+				set_phase(BENCH_RUN, now);
+				schedule_sys_suspend(now);
+			}
+		}
+
+		delay_us(BENCH_POLL_US);
+	}
+
+	bench_finish();
+}
+
+/* Find the CPUs of the platform which PSCI knows about */
+static void discover_cpus(void)
+{
+	uint64_t self = read_mpidr_el1() & MPIDR_AFFINITY_MASK;
+	uint64_t mpidr;
+	unsigned int cluster, cpu;
+	int rc;
+
+	bench_cpus[0].mpidr = self;
+	bench_cpu_count = 1;
+
+	for (cluster = 0; cluster < BENCH_MAX_CLUSTERS; cluster++) {
+		for (cpu = 0; cpu < BENCH_MAX_CPUS_PER_CLUSTER; cpu++) {
+			mpidr = (cluster << MPIDR_AFF1_SHIFT) |
+				(cpu << MPIDR_AFF0_SHIFT);
+			if (mpidr == self)
+				continue;
+
+			rc = bench_psci(PSCI_AFFINITY_INFO_AARCH64, mpidr,
+					0, 0);
+			if (rc < AFF_STATE_ON || rc > AFF_STATE_ON_PENDING)
+				continue;
+
+			bench_cpus[bench_cpu_count++].mpidr = mpidr;
+		}
+	}
+}
+
+void __dead2 bench_main(void)
+{
+	unsigned int idx;
+	int rc;
+
+	console_init(BENCH_UART_BASE, BENCH_UART_CLK_IN_HZ,
+		     BENCH_UART_BAUDRATE);
+	bench_ticks_per_sec = read_cntfrq_el0();
+	bench_timer_disarm();
+	bench_gic_init();
+	bench_gic_cpu_init();
+
+	discover_cpus();
+	for (idx = 0; idx < bench_cpu_count; idx++)
+		bench_cpus[idx].rand = (BENCH_SEED + idx) *
+			0x9e3779b97f4a7c15ull | 1;
+
+	tf_printf("PSCI benchmark: %u CPUs, %u ms, seed 0x%x\n",
+		  bench_cpu_count, BENCH_DURATION_MS, BENCH_SEED);
+
+	rc = bench_psci(PSCI_FEATURES, PSCI_SYSTEM_SUSPEND_AARCH64, 0, 0);
+	if (rc == PSCI_E_SUCCESS)
+		schedule_sys_suspend(read_cntpct_el0());
+	else if (BENCH_SYS_SUSPEND_MS)
+		tf_printf("SYSTEM_SUSPEND not supported, not tested\n");
+
+	bench_trace_init();
+
+	bench_start = read_cntpct_el0();
+	controller_loop();
+}
+
+void __dead2 bench_warm_main(unsigned int idx)
+{
+	uint64_t now = read_cntpct_el0();
+	bench_cpu_t *cpu = &bench_cpus[idx];
+
+	/* The timer state is lost when the CPU powers down */
+	bench_timer_disarm();
+
+	if (idx == 0) {
+		/* The controlling CPU resumes from SYSTEM_SUSPEND */
+		console_init(BENCH_UART_BASE, BENCH_UART_CLK_IN_HZ,
+			     BENCH_UART_BAUDRATE);
+		bench_gic_init();
+		bench_gic_cpu_init();
+		suspend_done(cpu, PSCI_E_SUCCESS, now);
+		set_phase(BENCH_RUN, now);
+		schedule_sys_suspend(now);
+		controller_loop();
+	}
+
+	bench_gic_cpu_init();
+
+	switch (cpu->op) {
+	case OP_CPU_PD:
+	case OP_CLUSTER_PD:
+		suspend_done(cpu, PSCI_E_SUCCESS, now);
+		break;
+	default:
+		/* Turned on by the controlling CPU */
+		bench_lat_record(&cpu->lat[LAT_CPU_ON_ENTRY],
+				 now - bench_on_issued[idx]);
+		cpu->op = OP_NONE;
+		break;
+	}
+
+	worker_loop(idx);
+}
+
+void __dead2 bench_panic(const char *msg)
+{
+	tf_printf("PSCI benchmark panic: %s\n", msg);
+	for (;;)
+		wfi();
+}
+
+void __dead2 bench_exception(uint64_t esr, uint64_t elr)
+{
+	tf_printf("Unexpected exception: ESR 0x%lx, ELR 0x%lx\n", esr, elr);
+	bench_panic("exception");
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __PSCI_BENCH_H__
+#define __PSCI_BENCH_H__
+
+#include <platform_def.h>
+
+/* Size of the stack of each CPU */
+#define BENCH_STACK_SIZE		0x1000
+
+#ifndef __ASSEMBLY__
+
+#include <cdefs.h>
+#include <stdint.h>
+
+/*
+ * Operations performed by the benchmark. The worker CPUs perform the first
+ * ones, the controlling CPU turns them on and suspends the system.
+ */
+#define OP_NONE				0
+#define OP_STANDBY			1
+#define OP_CPU_PD			2
+#define OP_CLUSTER_PD			3
+#define OP_CPU_OFF			4
+#define OP_AFF_INFO			5
+#define OP_CPU_ON			6
+#define OP_SYSTEM_SUSPEND		7
+#define OP_COUNT			8
+
+/*
+ * Latencies measured by the benchmark. The exit latency of a suspend state is
+ * measured from the timer event which wakes the CPU up to the return from
+ * CPU_SUSPEND, or to the warm entry point for a power down state. The latency
+ * of CPU_OFF is measured from the call to the point where the controlling CPU
+ * finds the CPU off, with the resolution of its polling period.
+ */
+#define LAT_CPU_ON_CALL			0
+#define LAT_CPU_ON_ENTRY		1
+#define LAT_CPU_OFF			2
+#define LAT_AFF_INFO_CALL		3
+#define LAT_STANDBY_EXIT		4
+#define LAT_CPU_PD_EXIT			5
+#define LAT_CLUSTER_PD_EXIT		6
+#define LAT_SYSTEM_SUSPEND_EXIT		7
+#define LAT_COUNT			8
+
+/*
+ * Samples of a latency, in system counter ticks. The last BENCH_SAMPLES ones
+ * are kept to compute the percentiles.
+ */
+typedef struct bench_lat {
+	uint64_t count;
+	uint64_t sum;
+	uint32_t max;
+	uint32_t samples[BENCH_SAMPLES];
+} bench_lat_t;
+
+/*
+ * State of a CPU of the benchmark. The MMU and the caches are kept off, so
+ * that the state survives power down without cache maintenance. As exclusive
+ * accesses are not available either, each structure is only written by the
+ * CPU it describes.
+ */
+typedef struct bench_cpu {
+	uint64_t mpidr;
+	/* State of the xorshift generator of the CPU */
+	uint64_t rand;
+	/* Operation in progress, its start time and timer deadline */
+	unsigned int op;
+	uint64_t op_start;
+	uint64_t deadline;
+	uint64_t op_count[OP_COUNT];
+	/* Wakeups from a suspend state before the deadline */
+	uint64_t early_wakeups;
+	uint64_t errors;
+	unsigned int last_err_op;
+	int last_err_rc;
+	bench_lat_t lat[LAT_COUNT];
+} bench_cpu_t;
+
+typedef struct bench_smc_args {
+	uint64_t x0;
+	uint64_t x1;
+	uint64_t x2;
+	uint64_t x3;
+} bench_smc_args_t;
+
+extern bench_cpu_t bench_cpus[PLATFORM_CORE_COUNT];
+extern unsigned int bench_cpu_count;
+extern uint64_t bench_ticks_per_sec;
+extern const char *const bench_op_names[OP_COUNT];
+extern const unsigned int bench_pstates[OP_COUNT];
+
+/* entry.S */
+void bench_warm_entrypoint(void);
+void bench_smc(bench_smc_args_t *args);
+
+/* bench_gic.c */
+void bench_gic_init(void);
+void bench_gic_cpu_init(void);
+void bench_timer_arm(uint64_t deadline);
+void bench_timer_disarm(void);
+
+/* bench_report.c */
+void bench_lat_record(bench_lat_t *lat, uint64_t ticks);
+void bench_trace_init(void);
+void bench_trace_poll(void);
+int bench_report(void);
+
+/* psci_bench.c */
+uint64_t bench_psci(uint64_t fid, uint64_t x1, uint64_t x2, uint64_t x3);
+void bench_main(void) __dead2;
+void bench_warm_main(unsigned int idx) __dead2;
+void bench_exception(uint64_t esr, uint64_t elr) __dead2;
+void bench_panic(const char *msg) __dead2;
+
+#endif /* __ASSEMBLY__ */
+#endif /* __PSCI_BENCH_H__ */
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host decoder of the EL3 telemetry snapshots taken by BL31 when it is built
+ * with EL3_TELEMETRY=1. It prints a report of the statistics and traces held
+ * by the snapshot, with the times converted to microseconds.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <el3_telemetry.h>
+#include <psci_trace.h>
+
+static unsigned char *snap;
+static size_t snap_size;
+static double ticks_per_us;
+
+static void print_usage(void)
+{
+	printf("Usage: telemetry_decode [snapshot file]\n\n");
+	printf("Prints the EL3 telemetry snapshot of a BL31 built with ");
+	printf("EL3_TELEMETRY=1.\n");
+	printf("The snapshot is read from the standard input if no file is ");
+	printf("given.\n");
+}
+
+static int load_snapshot(FILE *in)
+{
+	unsigned char *data;
+	size_t n, alloc_size = 0;
+
+	for (;;) {
+		if (snap_size == alloc_size) {
+			alloc_size = alloc_size ? alloc_size * 2 : 0x10000;
+			data = realloc(snap, alloc_size);
+			if (data == NULL) {
+				fprintf(stderr, "Not enough memory\n");
+				return -1;
+			}
+			snap = data;
+		}
+
+		n = fread(snap + snap_size, 1, alloc_size - snap_size, in);
+		snap_size += n;
+		if (n == 0)
+			break;
+	}
+
+	if (ferror(in)) {
+		fprintf(stderr, "Cannot read the snapshot: %s\n",
+			strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static double ticks_to_us(uint64_t ticks)
+{
+	return ticks / ticks_per_us;
+}
+
+/*
+ * Copy a record into 'rec', which is 'size' bytes. The fields the snapshot
+ * does not have, if it has been taken by an older BL31, are left to 0 and the
+ * fields the decoder does not know are ignored.
+ */
+static void read_rec(void *rec, size_t size, const unsigned char *src,
+		     size_t rec_size)
+{
+	memset(rec, 0, size);
+	memcpy(rec, src, (rec_size < size) ? rec_size : size);
+}
+
+static void print_smc_stats(const el3_telemetry_sect_t *sect,
+			    const unsigned char *recs)
+{
+	el3_telemetry_smc_rec_t rec;
+	unsigned int i, j;
+
+	printf("SMC latency statistics (us)\n");
+	printf("CPU  Function ID       Count        Mean         Min");
+	printf("         Max  Histogram (4^n ticks)\n");
+
+	for (i = 0; i < sect->num_recs; i++) {
+		read_rec(&rec, sizeof(rec), recs + i * sect->rec_size,
+			 sect->rec_size);
+		if ((rec.smc_fid == 0) || (rec.count == 0))
+			continue;
+
+		printf("%3u  0x%08" PRIx32 "  %10" PRIu32 "  %10.3f  %10.3f"
+		       "  %10.3f ", rec.cpu, rec.smc_fid, rec.count,
+		       ticks_to_us(rec.total) / rec.count,
+		       ticks_to_us(rec.min), ticks_to_us(rec.max));
+		for (j = 0; j < EL3_TELEMETRY_HIST_BUCKETS; j++)
+			printf(" %" PRIu32, rec.hist[j]);
+		printf("\n");
+	}
+	printf("\n");
+}
+
+static void print_psci_stat(const el3_telemetry_sect_t *sect,
+			    const unsigned char *recs)
+{
+	el3_telemetry_psci_stat_rec_t rec;
+	unsigned int i;
+
+	printf("PSCI residency statistics\n");
+	printf("Node  Level  State       Count  Residency (us)\n");
+
+	for (i = 0; i < sect->num_recs; i++) {
+		read_rec(&rec, sizeof(rec), recs + i * sect->rec_size,
+			 sect->rec_size);
+		if (rec.count == 0)
+			continue;
+
+		printf("%4" PRIu32 "  %5u  %5u  %10" PRIu64 "  %14.3f\n",
+		       rec.node, rec.pwrlvl, rec.local_state, rec.count,
+		       ticks_to_us(rec.residency));
+	}
+	printf("\n");
+}
+
+static void print_lock_profile(const el3_telemetry_sect_t *sect,
+			       const unsigned char *recs)
+{
+	el3_telemetry_lock_rec_t rec;
+	unsigned int i;
+
+	printf("Lock contention profiles (us)\n");
+	printf("Lock                Acquisitions   Contended   Mean wait");
+	printf("    Max wait\n");
+
+	for (i = 0; i < sect->num_recs; i++) {
+		read_rec(&rec, sizeof(rec), recs + i * sect->rec_size,
+			 sect->rec_size);
+		if (rec.acquire_count == 0)
+			continue;
+
+		printf("0x%016" PRIx64 "  %12" PRIu64 "  %10" PRIu64
+		       "  %10.3f  %10.3f\n", rec.lock, rec.acquire_count,
+		       rec.contended_count,
+		       ticks_to_us(rec.wait_ticks) / rec.acquire_count,
+		       ticks_to_us(rec.max_wait_ticks));
+	}
+	printf("\n");
+}
+
+static const char *trace_event_name(uint32_t event)
+{
+	switch (event) {
+	case PSCI_TRACE_CPU_ON:
+		return "CPU_ON";
+	case PSCI_TRACE_CPU_ON_PLAT_START:
+		return "CPU_ON_PLAT_START";
+	case PSCI_TRACE_CPU_ON_PLAT_END:
+		return "CPU_ON_PLAT_END";
+	case PSCI_TRACE_SUSPEND:
+		return "SUSPEND";
+	case PSCI_TRACE_LOCKS_ACQUIRED:
+		return "LOCKS_ACQUIRED";
+	case PSCI_TRACE_COORD_RESULT:
+		return "COORD_RESULT";
+	case PSCI_TRACE_SUSPEND_PLAT_START:
+		return "SUSPEND_PLAT_START";
+	case PSCI_TRACE_SUSPEND_PLAT_END:
+		return "SUSPEND_PLAT_END";
+	case PSCI_TRACE_WAKEUP:
+		return "WAKEUP";
+	default:
+		return "?";
+	}
+}
+
+static void print_psci_trace(const el3_telemetry_sect_t *sect,
+			     const unsigned char *recs)
+{
+	el3_telemetry_trace_rec_t rec;
+	unsigned int i;
+
+	printf("PSCI traces\n");
+	printf("CPU         Seq     Time (us)  Event               Arg\n");
+
+	for (i = 0; i < sect->num_recs; i++) {
+		read_rec(&rec, sizeof(rec), recs + i * sect->rec_size,
+			 sect->rec_size);
+		if (rec.event == 0)
+			continue;
+
+		printf("%3" PRIu32 "  %10" PRIu64 "  %12.3f  %-18s  0x%" PRIx32
+		       "\n", rec.cpu, rec.seq, ticks_to_us(rec.timestamp),
+		       trace_event_name(rec.event), rec.arg);
+	}
+	printf("\n");
+}
+
+static int print_snapshot(void)
+{
+	el3_telemetry_hdr_t hdr;
+	el3_telemetry_sect_t sect;
+	size_t pos, recs_size;
+	unsigned int i;
+
+	if (snap_size < sizeof(hdr)) {
+		fprintf(stderr, "The snapshot is truncated\n");
+		return -1;
+	}
+
+	memcpy(&hdr, snap, sizeof(hdr));
+	if (hdr.magic != EL3_TELEMETRY_MAGIC) {
+		fprintf(stderr, "This is not an EL3 telemetry snapshot\n");
+		return -1;
+	}
+
+	if (hdr.version_major != EL3_TELEMETRY_VERSION_MAJOR) {
+		fprintf(stderr, "Unsupported snapshot version %u.%u\n",
+			hdr.version_major, hdr.version_minor);
+		return -1;
+	}
+
+	if ((hdr.size > snap_size) || (hdr.cntfrq == 0)) {
+		fprintf(stderr, "The snapshot is truncated or corrupted\n");
+		return -1;
+	}
+
+	ticks_per_us = hdr.cntfrq / 1000000.0;
+
+	printf("EL3 telemetry snapshot %u.%u, %" PRIu32 " CPUs, taken at %.3f"
+	       " us (system counter at %" PRIu64 " Hz)\n\n",
+	       hdr.version_major, hdr.version_minor, hdr.num_cpus,
+	       ticks_to_us(hdr.timestamp), hdr.cntfrq);
+
+	pos = sizeof(hdr);
+	for (i = 0; i < hdr.num_sections; i++) {
+		if (hdr.size - pos < sizeof(sect)) {
+			fprintf(stderr, "Section %u is truncated\n", i);
+			return -1;
+		}
+
+		memcpy(&sect, snap + pos, sizeof(sect));
+		pos += sizeof(sect);
+
+		recs_size = (size_t)sect.num_recs * sect.rec_size;
+		if ((sect.rec_size && (recs_size / sect.rec_size !=
+				       sect.num_recs)) ||
+		    (hdr.size - pos < recs_size)) {
+			fprintf(stderr, "Section %u is truncated\n", i);
+			return -1;
+		}
+
+		switch (sect.type) {
+		case EL3_TELEMETRY_SECT_SMC_STATS:
+			print_smc_stats(&sect, snap + pos);
+			break;
+		case EL3_TELEMETRY_SECT_PSCI_STAT:
+			print_psci_stat(&sect, snap + pos);
+			break;
+		case EL3_TELEMETRY_SECT_LOCK_PROFILE:
+			print_lock_profile(&sect, snap + pos);
+			break;
+		case EL3_TELEMETRY_SECT_PSCI_TRACE:
+			print_psci_trace(&sect, snap + pos);
+			break;
+		default:
+			printf("Section of unknown type %" PRIu32
+			       " skipped\n\n", sect.type);
+			break;
+		}
+
+		pos += recs_size;
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *in = stdin;
+	int rc;
+
+	if (argc > 2) {
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	if (argc == 2) {
+		in = fopen(argv[1], "rb");
+		if (in == NULL) {
+			fprintf(stderr, "Cannot open %s: %s\n", argv[1],
+				strerror(errno));
+			return EXIT_FAILURE;
+		}
+	}
+
+	rc = load_snapshot(in);
+	if (in != stdin)
+		fclose(in);
+
+	if (rc == 0)
+		rc = print_snapshot();
+	free(snap);
+
+	return rc ? EXIT_FAILURE : EXIT_SUCCESS;
+}
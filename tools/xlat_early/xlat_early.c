@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host generator of the early translation tables of BL1 and BL2. It is built
+ * for each image with the preprocessed output of xlat_early_mmap.S, which
+ * gives the translation granule, the size of the virtual address space and
+ * the regions listed by the platform in PLAT_XLAT_EARLY_MMAP, and prints a C
+ * file defining the tables and the values of the MAIR, TCR and TTBR0 to
+ * install them with.
+ *
+ * The tables are built like the ones of the translation table library, from
+ * the base level down to level 3, using the largest blocks the regions allow.
+ * The memory regions are executable: the early tables only exist to run with
+ * the caches enabled until the image installs its own tables.
+ */
+
+#include <arch.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <xlat_tables.h>
+
+#define XLAT_EARLY_GRANULE_SHIFT(_shift)				\
+	static const unsigned int granule_shift = (_shift);
+#define XLAT_EARLY_ADDR_SPACE_SIZE(_size)				\
+	static const unsigned long long addr_space_size = (_size);
+#define XLAT_EARLY_MMAP(...)						\
+	static const mmap_region_t mmap[] = { __VA_ARGS__, {0} };
+
+#include XLAT_EARLY_INPUT
+
+#define MAX_TABLES		32
+
+static unsigned int entries_shift;
+static unsigned int base_level;
+static uint64_t *tables[MAX_TABLES];
+/* Index of the next level table of each table descriptor, 0 otherwise */
+static unsigned int *next_tables[MAX_TABLES];
+static unsigned int num_tables;
+
+static void fail(const char *msg, const mmap_region_t *mm)
+{
+	fprintf(stderr, "xlat_early: %s", msg);
+	if (mm != NULL)
+		fprintf(stderr, " (region VA 0x%lx size 0x%zx)", mm->base_va,
+			mm->size);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+static unsigned int addr_shift(unsigned int level)
+{
+	return granule_shift + (3 - level) * entries_shift;
+}
+
+static unsigned int new_table(void)
+{
+	if (num_tables == MAX_TABLES)
+		fail("too many translation tables", NULL);
+
+	tables[num_tables] = calloc(1u << entries_shift, sizeof(uint64_t));
+	next_tables[num_tables] = calloc(1u << entries_shift,
+					 sizeof(unsigned int));
+	if (tables[num_tables] == NULL || next_tables[num_tables] == NULL)
+		fail("out of memory", NULL);
+
+	return num_tables++;
+}
+
+/* Same attributes as mmap_desc(), except that memory is never XN */
+static uint64_t leaf_desc(const mmap_region_t *mm, unsigned long long pa,
+			  unsigned int level)
+{
+	uint64_t desc = pa;
+
+	desc |= level == 3 ? TABLE_DESC : BLOCK_DESC;
+	desc |= mm->attr & MT_NS ? LOWER_ATTRS(NS) : 0;
+	desc |= mm->attr & MT_RW ? LOWER_ATTRS(AP_RW) : LOWER_ATTRS(AP_RO);
+	desc |= LOWER_ATTRS(ACCESS_FLAG);
+
+	switch (MT_TYPE(mm->attr)) {
+	case MT_MEMORY:
+		desc |= LOWER_ATTRS(ATTR_IWBWA_OWBWA_NTR_INDEX | ISH);
+		break;
+	case MT_NON_CACHEABLE:
+		desc |= LOWER_ATTRS(ATTR_NON_CACHEABLE_INDEX | OSH);
+		break;
+	case MT_DEVICE:
+		desc |= LOWER_ATTRS(ATTR_DEVICE_INDEX | OSH);
+		desc |= UPPER_ATTRS(XN);
+		break;
+	default:
+		fail("invalid memory type", mm);
+	}
+
+	return desc;
+}
+
+/* Fill the table mapping the area from base_va at the given level */
+static void init_table(unsigned int idx, unsigned long long base_va,
+		       unsigned int level)
+{
+	unsigned long long entry_size = 1ull << addr_shift(level);
+	unsigned int num_entries = level == base_level ?
+		addr_space_size >> addr_shift(level) : 1u << entries_shift;
+	unsigned int i;
+
+	for (i = 0; i < num_entries; i++) {
+		unsigned long long va = base_va + i * entry_size;
+		const mmap_region_t *mm, *found = NULL;
+		int partial = 0;
+
+		for (mm = mmap; mm->size; mm++) {
+			if (mm->base_va >= va + entry_size ||
+			    mm->base_va + mm->size <= va)
+				continue;
+
+			if (mm->base_va > va ||
+			    mm->base_va + mm->size < va + entry_size ||
+			    ((mm->base_pa - mm->base_va) & (entry_size - 1)))
+				partial = 1;
+			found = mm;
+		}
+
+		if (found == NULL)
+			continue;
+
+		if (!partial && (level >= 2 || (level == 1 &&
+				granule_shift == FOUR_KB_SHIFT))) {
+			tables[idx][i] = leaf_desc(found,
+				found->base_pa + (va - found->base_va), level);
+		} else if (level < 3) {
+			unsigned int next = new_table();
+
+			tables[idx][i] = TABLE_DESC;
+			next_tables[idx][i] = next;
+			init_table(next, va, level + 1);
+		} else {
+			fail("region not aligned to the granule", found);
+		}
+	}
+}
+
+static unsigned long long tcr_ps_bits(void)
+{
+	unsigned long long max_pa = 0;
+	const mmap_region_t *mm;
+
+	for (mm = mmap; mm->size; mm++)
+		if (mm->base_pa + mm->size - 1 > max_pa)
+			max_pa = mm->base_pa + mm->size - 1;
+
+	if (max_pa & ADDR_MASK_48_TO_63)
+		fail("physical address beyond 48 bits", NULL);
+	if (max_pa & ADDR_MASK_44_TO_47)
+		return TCR_PS_BITS_256TB;
+	if (max_pa & ADDR_MASK_42_TO_43)
+		return TCR_PS_BITS_16TB;
+	if (max_pa & ADDR_MASK_40_TO_41)
+		return TCR_PS_BITS_4TB;
+	if (max_pa & ADDR_MASK_36_TO_39)
+		return TCR_PS_BITS_1TB;
+	if (max_pa & ADDR_MASK_32_TO_35)
+		return TCR_PS_BITS_64GB;
+	return TCR_PS_BITS_4GB;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long long tcr, mair;
+	unsigned int t, i, el;
+	const mmap_region_t *mm, *other;
+
+	if (argc != 3 || (strcmp(argv[2], "1") && strcmp(argv[2], "3"))) {
+		printf("Usage: xlat_early <image name> <1|3>\n\n");
+		printf("Prints the early translation tables of a BL image "
+		       "running at EL1 or EL3.\n");
+		return 1;
+	}
+	el = atoi(argv[2]);
+
+	if (granule_shift != FOUR_KB_SHIFT &&
+	    granule_shift != SIXTEEN_KB_SHIFT &&
+	    granule_shift != SIXTY_FOUR_KB_SHIFT)
+		fail("invalid translation granule", NULL);
+	entries_shift = granule_shift - 3;
+
+	if (addr_space_size < (1ull << 31) || addr_space_size > (1ull << 39) ||
+	    (addr_space_size & (addr_space_size - 1)))
+		fail("invalid virtual address space size", NULL);
+	base_level = addr_space_size <= (1ull << addr_shift(1)) ? 2 : 1;
+
+	for (mm = mmap; mm->size; mm++) {
+		if ((mm->base_va | mm->base_pa | mm->size) &
+		    ((1ull << granule_shift) - 1))
+			fail("region not aligned to the granule", mm);
+		if (mm->base_va + mm->size > addr_space_size ||
+		    mm->base_va + mm->size < mm->base_va)
+			fail("region outside the address space", mm);
+		for (other = mmap; other != mm; other++)
+			if (mm->base_va < other->base_va + other->size &&
+			    other->base_va < mm->base_va + mm->size)
+				fail("regions overlap", mm);
+	}
+
+	init_table(new_table(), 0, base_level);
+
+	mair = MAIR_ATTR_SET(ATTR_DEVICE, ATTR_DEVICE_INDEX);
+	mair |= MAIR_ATTR_SET(ATTR_IWBWA_OWBWA_NTR, ATTR_IWBWA_OWBWA_NTR_INDEX);
+	mair |= MAIR_ATTR_SET(ATTR_NON_CACHEABLE, ATTR_NON_CACHEABLE_INDEX);
+
+	tcr = TCR_SH_INNER_SHAREABLE | TCR_RGN_OUTER_WBA | TCR_RGN_INNER_WBA |
+		(64 - __builtin_ctzll(addr_space_size));
+	if (granule_shift == SIXTEEN_KB_SHIFT)
+		tcr |= TCR_TG0_16K;
+	else if (granule_shift == SIXTY_FOUR_KB_SHIFT)
+		tcr |= TCR_TG0_64K;
+	else
+		tcr |= TCR_TG0_4K;
+	if (el == 3)
+		tcr |= TCR_EL3_RES1 | (tcr_ps_bits() << TCR_EL3_PS_SHIFT);
+	else
+		tcr |= tcr_ps_bits() << TCR_EL1_IPS_SHIFT;
+
+	printf("/*\n * Early translation tables of %s, generated by "
+	       "tools/xlat_early.\n */\n\n", argv[1]);
+	printf("#include <stdint.h>\n\n");
+	printf("const uint64_t xlat_early_tables[%u][%u]\n", num_tables,
+	       1u << entries_shift);
+	printf("\t__attribute__((aligned(%u))) = {\n", 1u << granule_shift);
+	for (t = 0; t < num_tables; t++) {
+		printf("\t{\n");
+		for (i = 0; i < 1u << entries_shift; i++) {
+			uint64_t desc = tables[t][i];
+
+			if (desc == 0)
+				continue;
+			/* Table addresses are resolved when linking */
+			if (next_tables[t][i])
+				printf("\t\t[%u] = (uint64_t)xlat_early_tables"
+				       "[%u] + 0x%x,\n", i, next_tables[t][i],
+				       TABLE_DESC);
+			else
+				printf("\t\t[%u] = 0x%llxull,\n", i,
+				       (unsigned long long)desc);
+		}
+		printf("\t},\n");
+	}
+	printf("};\n\n");
+
+	printf("/* Values of TTBR0, TCR and MAIR */\n");
+	printf("const uint64_t xlat_early_regs[3] = {\n");
+	printf("\t(uint64_t)xlat_early_tables,\n");
+	printf("\t0x%llxull,\n", tcr);
+	printf("\t0x%llxull,\n", mair);
+	printf("};\n");
+
+	return 0;
+}
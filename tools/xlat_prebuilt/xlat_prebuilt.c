@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host generator of the translation tables of BL31. It is built for each image
+ * with the preprocessed output of xlat_prebuilt_mmap.S, which gives the
+ * translation granule, the size of the virtual address space, the size of the
+ * pools of the translation table library and the regions listed by the
+ * platform in PLAT_XLAT_PREBUILT_MMAP, and is run on the linked ELF image.
+ *
+ * The addresses of the linker symbols used by the regions through XLAT_SYM()
+ * are read from the image. The regions are sorted and coalesced, and the
+ * tables built, the same way as init_xlat_tables() does at runtime. The tables
+ * and the list of regions are then written into the image, in the variables
+ * of lib/aarch64/xlat_tables.c which init_xlat_tables() adopts them from.
+ */
+
+#include <arch.h>
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <xlat_tables.h>
+
+static unsigned long elf_symbol(const char *name, unsigned long *size);
+
+#define XLAT_SYM(_name)		elf_symbol(#_name, NULL)
+
+#define XLAT_PREBUILT_GRANULE_SHIFT(_shift)				\
+	granule_shift = (_shift);
+#define XLAT_PREBUILT_ADDR_SPACE_SIZE(_size)				\
+	addr_space_size = (_size);
+#define XLAT_PREBUILT_LIMITS(_tables, _regions)				\
+	set_limits((_tables), (_regions));
+#define XLAT_PREBUILT_MMAP(...)						\
+	const mmap_region_t regions[] = { __VA_ARGS__, {0} };		\
+	add_regions(regions);
+
+#define UNSET_DESC		~0ul
+
+static unsigned int granule_shift;
+static unsigned long long addr_space_size;
+static unsigned int max_tables;
+static unsigned int max_regions;
+
+static unsigned int entries_shift;
+static unsigned int base_level;
+
+static mmap_region_t *mmap;
+static unsigned int mmap_num;
+
+static uint64_t *base_table;
+static uint64_t *tables;
+static unsigned long tables_addr;
+static unsigned int next_table;
+
+static unsigned char *elf;
+static size_t elf_size;
+
+static void fail(const char *msg, const char *arg)
+{
+	fprintf(stderr, "xlat_prebuilt: %s%s%s\n", msg, arg ? ": " : "",
+		arg ? arg : "");
+	exit(1);
+}
+
+static void load_elf(const char *path)
+{
+	const Elf64_Ehdr *ehdr;
+	FILE *f;
+
+	f = fopen(path, "rb");
+	if (f == NULL)
+		fail("cannot open", path);
+	fseek(f, 0, SEEK_END);
+	elf_size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	elf = malloc(elf_size);
+	if (elf == NULL || fread(elf, 1, elf_size, f) != elf_size)
+		fail("cannot read", path);
+	fclose(f);
+
+	ehdr = (const Elf64_Ehdr *)elf;
+	if (elf_size < sizeof(*ehdr) || memcmp(ehdr->e_ident, ELFMAG, SELFMAG) ||
+	    ehdr->e_ident[EI_CLASS] != ELFCLASS64 ||
+	    ehdr->e_ident[EI_DATA] != ELFDATA2LSB ||
+	    ehdr->e_machine != EM_AARCH64)
+		fail("not a little-endian AArch64 ELF image", path);
+}
+
+static const Elf64_Shdr *elf_section(unsigned int idx)
+{
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)elf;
+
+	return (const Elf64_Shdr *)(elf + ehdr->e_shoff +
+				    idx * ehdr->e_shentsize);
+}
+
+static unsigned long elf_symbol(const char *name, unsigned long *size)
+{
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)elf;
+	unsigned int i, j;
+
+	for (i = 0; i < ehdr->e_shnum; i++) {
+		const Elf64_Shdr *shdr = elf_section(i);
+		const Elf64_Sym *sym = (const Elf64_Sym *)(elf + shdr->sh_offset);
+		const char *strtab;
+
+		if (shdr->sh_type != SHT_SYMTAB)
+			continue;
+
+		strtab = (const char *)elf + elf_section(shdr->sh_link)->sh_offset;
+		for (j = 0; j < shdr->sh_size / sizeof(*sym); j++) {
+			if (strcmp(strtab + sym[j].st_name, name))
+				continue;
+			if (size != NULL)
+				*size = sym[j].st_size;
+			return sym[j].st_value;
+		}
+	}
+
+	fail("symbol not found", name);
+	return 0;
+}
+
+/* Return the contents of a variable of the image, after checking its size */
+static void *elf_variable(const char *name, unsigned long size)
+{
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)elf;
+	unsigned long addr, sym_size;
+	unsigned int i;
+
+	addr = elf_symbol(name, &sym_size);
+	if (sym_size != size)
+		fail("unexpected size of variable", name);
+
+	for (i = 0; i < ehdr->e_shnum; i++) {
+		const Elf64_Shdr *shdr = elf_section(i);
+
+		if (shdr->sh_type == SHT_PROGBITS && addr >= shdr->sh_addr &&
+		    addr + size <= shdr->sh_addr + shdr->sh_size)
+			return elf + shdr->sh_offset + (addr - shdr->sh_addr);
+	}
+
+	fail("variable not in the loaded data of the image", name);
+	return NULL;
+}
+
+static void set_limits(unsigned int tables, unsigned int regions)
+{
+	max_tables = tables;
+	max_regions = regions;
+
+	mmap = elf_variable("xlat_prebuilt_mmap",
+			    (max_regions + 1) * sizeof(*mmap));
+	memset(mmap, 0, (max_regions + 1) * sizeof(*mmap));
+}
+
+static void add_regions(const mmap_region_t *mm)
+{
+	if (mmap == NULL)
+		fail("XLAT_PREBUILT_LIMITS missing from the input", NULL);
+
+	for (; mm->size; mm++) {
+		if (mmap_num == max_regions)
+			fail("too many regions", NULL);
+		if ((mm->base_pa | mm->base_va | mm->size) &
+		    ((1ul << granule_shift) - 1))
+			fail("region not aligned to the granule", NULL);
+		if (mm->base_va + mm->size - 1 >= addr_space_size ||
+		    mm->base_va + mm->size - 1 < mm->base_va)
+			fail("region outside the address space", NULL);
+		mmap[mmap_num++] = *mm;
+	}
+}
+
+static int mmap_region_before(const mmap_region_t *a, const mmap_region_t *b)
+{
+	return a->base_va < b->base_va ||
+		(a->base_va == b->base_va && a->size > b->size);
+}
+
+/* Same order and merges as mmap_sort() and mmap_coalesce() */
+static void sort_regions(void)
+{
+	mmap_region_t tmp;
+	unsigned int i, j;
+
+	for (i = 1; i < mmap_num; i++) {
+		tmp = mmap[i];
+		for (j = i; j > 0 && mmap_region_before(&tmp, &mmap[j - 1]); j--)
+			mmap[j] = mmap[j - 1];
+		mmap[j] = tmp;
+	}
+
+	for (i = 1, j = 0; i < mmap_num; i++) {
+		mmap_region_t *prev = &mmap[j];
+
+		if (prev->attr == mmap[i].attr &&
+		    prev->base_va + prev->size == mmap[i].base_va &&
+		    prev->base_pa + prev->size == mmap[i].base_pa)
+			prev->size += mmap[i].size;
+		else
+			mmap[++j] = mmap[i];
+	}
+
+	if (mmap_num)
+		mmap_num = j + 1;
+	memset(&mmap[mmap_num], 0,
+	       (max_regions + 1 - mmap_num) * sizeof(*mmap));
+}
+
+static unsigned int addr_shift(unsigned int level)
+{
+	return granule_shift + (3 - level) * entries_shift;
+}
+
+/* Same descriptors as mmap_desc() */
+static uint64_t mmap_desc(unsigned int attr, unsigned long addr_pa,
+			  unsigned int level)
+{
+	uint64_t desc = addr_pa;
+
+	desc |= level == 3 ? TABLE_DESC : BLOCK_DESC;
+	desc |= attr & MT_NS ? LOWER_ATTRS(NS) : 0;
+	desc |= attr & MT_RW ? LOWER_ATTRS(AP_RW) : LOWER_ATTRS(AP_RO);
+	desc |= LOWER_ATTRS(ACCESS_FLAG);
+
+	if (MT_TYPE(attr) == MT_MEMORY) {
+		desc |= LOWER_ATTRS(ATTR_IWBWA_OWBWA_NTR_INDEX | ISH);
+		if (attr & MT_RW)
+			desc |= UPPER_ATTRS(XN);
+	} else if (MT_TYPE(attr) == MT_NON_CACHEABLE) {
+		desc |= LOWER_ATTRS(ATTR_NON_CACHEABLE_INDEX | OSH);
+		if (attr & MT_RW)
+			desc |= UPPER_ATTRS(XN);
+	} else {
+		desc |= LOWER_ATTRS(ATTR_DEVICE_INDEX | OSH);
+		desc |= UPPER_ATTRS(XN);
+	}
+
+	return desc;
+}
+
+/* Same attributes as mmap_region_attr() */
+static int mmap_region_attr(const mmap_region_t *mm, unsigned long base_va,
+			    unsigned long size)
+{
+	int attr = mm->attr;
+	int old_mem_type, new_mem_type;
+
+	for (;;) {
+		++mm;
+
+		if (!mm->size || mm->base_va >= base_va + size)
+			return attr;
+
+		if (mm->base_va + mm->size <= base_va ||
+		    (mm->attr & attr) == attr)
+			continue;
+
+		old_mem_type = MT_TYPE(attr);
+		new_mem_type = MT_TYPE(mm->attr);
+		attr &= mm->attr;
+		if (new_mem_type < old_mem_type)
+			attr = (attr & ~MT_TYPE_MASK) | new_mem_type;
+
+		if (mm->base_va > base_va ||
+		    mm->base_va + mm->size < base_va + size)
+			return -1;
+	}
+}
+
+/* Same Contiguous bits as xlat_set_contiguous() */
+static void set_contiguous(uint64_t *table, unsigned int entries,
+			   unsigned int level)
+{
+	unsigned int shift = addr_shift(level);
+	unsigned int run = granule_shift == FOUR_KB_SHIFT ? 16 :
+		(granule_shift == SIXTEEN_KB_SHIFT && level == 3) ? 128 : 32;
+	uint64_t run_mask = ((uint64_t)run << shift) - 1;
+	unsigned int leaf = level == 3 ? TABLE_DESC : BLOCK_DESC;
+	unsigned int i, j;
+
+	for (i = 0; i + run <= entries; i += run) {
+		uint64_t desc = table[i];
+
+		if ((desc & DESC_MASK) != leaf ||
+		    (desc & TABLE_ADDR_MASK & run_mask))
+			continue;
+
+		for (j = 1; j < run; j++)
+			if (table[i + j] != desc + ((uint64_t)j << shift))
+				break;
+
+		if (j < run)
+			continue;
+
+		for (j = 0; j < run; j++)
+			table[i + j] |= UPPER_ATTRS(CONT_HINT);
+	}
+}
+
+/* Same tables as init_xlation_table() */
+static const mmap_region_t *init_table(const mmap_region_t *mm,
+				       unsigned long base_va, uint64_t *table,
+				       unsigned int level)
+{
+	unsigned long level_size = 1ul << addr_shift(level);
+	unsigned long level_index_mask =
+		((1ul << entries_shift) - 1) << addr_shift(level);
+	uint64_t *table_start = table;
+
+	do {
+		uint64_t desc = UNSET_DESC;
+
+		if (!mm->size) {
+			desc = INVALID_DESC;
+		} else if (mm->base_va + mm->size <= base_va) {
+			++mm;
+			continue;
+		}
+
+		if (mm->base_va >= base_va + level_size) {
+			desc = INVALID_DESC;
+		} else if ((level >= 2 || granule_shift == FOUR_KB_SHIFT) &&
+			   mm->base_va <= base_va &&
+			   mm->base_va + mm->size >= base_va + level_size) {
+			int attr = mmap_region_attr(mm, base_va, level_size);
+
+			if (attr >= 0)
+				desc = mmap_desc(attr,
+					base_va - mm->base_va + mm->base_pa,
+					level);
+		}
+
+		if (desc == UNSET_DESC) {
+			uint64_t *new_table;
+
+			if (level == 3)
+				fail("region not aligned to the granule", NULL);
+			if (next_table == max_tables)
+				fail("MAX_XLAT_TABLES is too small", NULL);
+
+			new_table = tables + ((unsigned long)next_table <<
+					      entries_shift);
+			desc = TABLE_DESC | (tables_addr +
+				((unsigned long)next_table << granule_shift));
+			next_table++;
+
+			mm = init_table(mm, base_va, new_table, level + 1);
+		}
+
+		*table++ = desc;
+		base_va += level_size;
+	} while ((base_va & level_index_mask) && base_va < addr_space_size);
+
+	set_contiguous(table_start, table - table_start, level);
+
+	return mm;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long num_base_entries;
+	unsigned int *num_tables;
+	FILE *f;
+
+	if (argc != 2) {
+		printf("Usage: xlat_prebuilt <ELF image>\n\n");
+		printf("Writes the translation tables of the regions in "
+		       "PLAT_XLAT_PREBUILT_MMAP\n");
+		printf("into a linked BL31 image.\n");
+		return 1;
+	}
+
+	load_elf(argv[1]);
+
+	{
+#include XLAT_PREBUILT_INPUT
+	}
+
+	if (granule_shift != FOUR_KB_SHIFT &&
+	    granule_shift != SIXTEEN_KB_SHIFT &&
+	    granule_shift != SIXTY_FOUR_KB_SHIFT)
+		fail("invalid translation granule", NULL);
+	entries_shift = granule_shift - 3;
+	base_level = addr_space_size <= (1ull << addr_shift(1)) ? 2 : 1;
+	num_base_entries = addr_space_size >> addr_shift(base_level);
+
+	sort_regions();
+
+	base_table = elf_variable("base_xlation_table",
+				  num_base_entries * sizeof(uint64_t));
+	tables = elf_variable("xlat_tables",
+			      (unsigned long)max_tables << granule_shift);
+	tables_addr = elf_symbol("xlat_tables", NULL);
+	num_tables = elf_variable("xlat_prebuilt_tables", sizeof(*num_tables));
+
+	init_table(mmap, 0, base_table, base_level);
+	*num_tables = next_table;
+
+	f = fopen(argv[1], "r+b");
+	if (f == NULL || fwrite(elf, 1, elf_size, f) != elf_size ||
+	    fclose(f))
+		fail("cannot write", argv[1]);
+
+	printf("%u regions, %u of %u translation tables\n", mmap_num,
+	       next_table, max_tables);
+
+	return 0;
+}